@@ -0,0 +1,62 @@
+# components/asset_store/asset_image.cmake
+#
+# Obraz oddílu `assets` (asset_store.h): PNG figurek, katalog otevření a
+# databáze úloh mimo aplikaci. `idf.py flash` ho nahraje spolu s firmwarem;
+# samotné assety `parttool.py write_partition --partition-name assets --input build/assets.bin`
+# nebo POST /api/assets. Další asset = další řádek (URI=soubor od kořene repa).
+
+set(ASSET_IMAGE_FILES
+    "/static/piece/PieceWhiteKing.png=components/web_server_task/web/piece_assets/PieceWhiteKing.png"
+    "/static/piece/PieceWhiteQueen.png=components/web_server_task/web/piece_assets/PieceWhiteQueen.png"
+    "/static/piece/PieceWhiteRook.png=components/web_server_task/web/piece_assets/PieceWhiteRook.png"
+    "/static/piece/PieceWhiteBishop.png=components/web_server_task/web/piece_assets/PieceWhiteBishop.png"
+    "/static/piece/PieceWhiteKnight.png=components/web_server_task/web/piece_assets/PieceWhiteKnight.png"
+    "/static/piece/PieceWhitePawn.png=components/web_server_task/web/piece_assets/PieceWhitePawn.png"
+    "/static/piece/PieceBlackKing.png=components/web_server_task/web/piece_assets/PieceBlackKing.png"
+    "/static/piece/PieceBlackQueen.png=components/web_server_task/web/piece_assets/PieceBlackQueen.png"
+    "/static/piece/PieceBlackRook.png=components/web_server_task/web/piece_assets/PieceBlackRook.png"
+    "/static/piece/PieceBlackBishop.png=components/web_server_task/web/piece_assets/PieceBlackBishop.png"
+    "/static/piece/PieceBlackKnight.png=components/web_server_task/web/piece_assets/PieceBlackKnight.png"
+    "/static/piece/PieceBlackPawn.png=components/web_server_task/web/piece_assets/PieceBlackPawn.png"
+    "/static/data/openings_catalog.json=components/web_server_task/web/data/openings_catalog.json"
+)
+
+idf_build_get_property(python PYTHON)
+
+# Databáze úloh (game_puzzle_db.h) se generuje z data/puzzles_master.json;
+# firmware ji čte přímo z mapovaného oddílu.
+set(ASSET_PUZZLE_DB "${CMAKE_BINARY_DIR}/puzzles.bin")
+add_custom_command(
+    OUTPUT "${ASSET_PUZZLE_DB}"
+    COMMAND ${python} "${CMAKE_SOURCE_DIR}/components/game_task/tools/build_puzzle_db.py"
+            "${CMAKE_SOURCE_DIR}/data/puzzles_master.json" --out "${ASSET_PUZZLE_DB}"
+    DEPENDS "${CMAKE_SOURCE_DIR}/components/game_task/tools/build_puzzle_db.py"
+            "${CMAKE_SOURCE_DIR}/components/game_task/tools/build_opening_book.py"
+            "${CMAKE_SOURCE_DIR}/data/puzzles_master.json"
+    COMMENT "Building puzzle database"
+    VERBATIM)
+
+partition_table_get_partition_info(ASSET_PART_SIZE "--partition-name assets" "size")
+set(ASSET_IMAGE "${CMAKE_BINARY_DIR}/assets.bin")
+set(ASSET_IMAGE_ARGS)
+set(ASSET_IMAGE_DEPS)
+foreach(pair ${ASSET_IMAGE_FILES})
+    string(REGEX REPLACE "^[^=]*=" "" rel "${pair}")
+    string(REGEX REPLACE "=.*$" "" uri "${pair}")
+    list(APPEND ASSET_IMAGE_ARGS "${uri}=${CMAKE_SOURCE_DIR}/${rel}")
+    list(APPEND ASSET_IMAGE_DEPS "${CMAKE_SOURCE_DIR}/${rel}")
+endforeach()
+list(APPEND ASSET_IMAGE_ARGS "/static/data/puzzles.bin=${ASSET_PUZZLE_DB}")
+list(APPEND ASSET_IMAGE_DEPS "${ASSET_PUZZLE_DB}")
+add_custom_command(
+    OUTPUT "${ASSET_IMAGE}"
+    COMMAND ${python} "${CMAKE_SOURCE_DIR}/components/asset_store/tools/build_asset_image.py"
+            --out "${ASSET_IMAGE}" --max-size ${ASSET_PART_SIZE} ${ASSET_IMAGE_ARGS}
+    DEPENDS "${CMAKE_SOURCE_DIR}/components/asset_store/tools/build_asset_image.py"
+            "${CMAKE_SOURCE_DIR}/components/web_server_task/tools/build_web_assets.py"
+            ${ASSET_IMAGE_DEPS}
+    COMMENT "Building assets partition image"
+    VERBATIM)
+add_custom_target(asset_image ALL DEPENDS "${ASSET_IMAGE}")
+esptool_py_flash_to_partition(flash assets "${ASSET_IMAGE}")
+add_dependencies(flash asset_image)
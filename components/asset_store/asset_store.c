@@ -0,0 +1,316 @@
+/**
+ * @file asset_store.c
+ * @brief Oddíl `assets`: jedno esp_partition_mmap celého oddílu při bootu.
+ *
+ * Mapuje se celý oddíl (ne jen obraz), takže nový obraz z
+ * asset_store_update_* se jen zapíše do flash a přepne `s_ready` — mapování
+ * se nemění a ukazatele rozdané čtenářům nikdy nemíří do odmapované paměti.
+ * Během zápisu je obraz nedostupný (čtenáři dostanou "nenalezeno").
+ */
+
+#include "asset_store.h"
+
+#include "esp_log.h"
+#include "esp_partition.h"
+#include "esp_rom_crc.h"
+
+#include <string.h>
+
+static const char *TAG = "ASSET_STORE";
+
+/** Velikost bufferu pro kontrolu CRC po nahrání (čte se po částech). */
+#define ASSET_STORE_VERIFY_CHUNK 512
+
+static const esp_partition_t *s_part;
+static esp_partition_mmap_handle_t s_map;
+static const uint8_t *s_base;
+static asset_store_header_t s_hdr;
+static volatile bool s_ready;
+
+static struct {
+  bool active;
+  size_t size;
+  size_t written;
+  uint8_t header[sizeof(asset_store_header_t)];
+} s_upd;
+
+static const char *asset_str(uint32_t off, const char *empty) {
+  return off != 0 ? (const char *)(s_base + off) : empty;
+}
+
+/** Řetězec musí ležet v adresáři a končit \0 uvnitř něj. */
+static bool asset_str_ok(const uint8_t *base, const asset_store_header_t *h,
+                         uint32_t off) {
+  uint32_t dir_end = sizeof(*h) + h->dir_size;
+  if (off == 0) {
+    return true;
+  }
+  if (off < sizeof(*h) + h->count * sizeof(asset_store_dir_entry_t) ||
+      off >= dir_end) {
+    return false;
+  }
+  return memchr(base + off, '\0', dir_end - off) != NULL;
+}
+
+/** Hlavička + adresář nad namapovaným obrazem (bez CRC dat). */
+static esp_err_t asset_validate(const uint8_t *base,
+                                const asset_store_header_t *h,
+                                size_t part_size) {
+  if (h->magic != ASSET_STORE_MAGIC) {
+    return ESP_ERR_NOT_FOUND;
+  }
+  if (h->version != ASSET_STORE_VERSION) {
+    return ESP_ERR_INVALID_VERSION;
+  }
+  if (h->image_size > part_size || h->dir_size > h->image_size - sizeof(*h) ||
+      (size_t)h->count * sizeof(asset_store_dir_entry_t) > h->dir_size) {
+    return ESP_ERR_INVALID_SIZE;
+  }
+  if (esp_rom_crc32_le(0, base + sizeof(*h), h->dir_size) != h->dir_crc) {
+    return ESP_ERR_INVALID_CRC;
+  }
+  const asset_store_dir_entry_t *dir =
+      (const asset_store_dir_entry_t *)(base + sizeof(*h));
+  for (uint16_t i = 0; i < h->count; i++) {
+    const asset_store_dir_entry_t *e = &dir[i];
+    if (e->name_off == 0 || !asset_str_ok(base, h, e->name_off) ||
+        !asset_str_ok(base, h, e->hashed_off) ||
+        !asset_str_ok(base, h, e->mime_off) ||
+        !asset_str_ok(base, h, e->encoding_off) ||
+        !asset_str_ok(base, h, e->etag_off) ||
+        e->data_off < sizeof(*h) + h->dir_size || e->data_off > h->image_size ||
+        e->data_len > h->image_size - e->data_off) {
+      return ESP_ERR_INVALID_SIZE;
+    }
+  }
+  return ESP_OK;
+}
+
+esp_err_t asset_store_init(void) {
+  if (s_base != NULL) {
+    return s_ready ? ESP_OK : ESP_ERR_NOT_FOUND;
+  }
+  s_part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA,
+                                    ESP_PARTITION_SUBTYPE_ANY,
+                                    ASSET_STORE_PARTITION_LABEL);
+  if (s_part == NULL) {
+    ESP_LOGW(TAG, "partition '%s' not found", ASSET_STORE_PARTITION_LABEL);
+    return ESP_ERR_NOT_FOUND;
+  }
+  const void *ptr = NULL;
+  esp_err_t ret = esp_partition_mmap(s_part, 0, s_part->size,
+                                     ESP_PARTITION_MMAP_DATA, &ptr, &s_map);
+  if (ret != ESP_OK) {
+    ESP_LOGE(TAG, "mmap failed: %s", esp_err_to_name(ret));
+    s_part = NULL;
+    return ret;
+  }
+  s_base = ptr;
+
+  asset_store_header_t h;
+  memcpy(&h, s_base, sizeof(h));
+  ret = asset_validate(s_base, &h, s_part->size);
+  if (ret != ESP_OK) {
+    ESP_LOGW(TAG, "no valid asset image (%s) — flash assets.bin",
+             esp_err_to_name(ret));
+    return ret;
+  }
+  s_hdr = h;
+  s_ready = true;
+  ESP_LOGI(TAG, "assets %08lx: %u entries, %lu / %lu B mapped",
+           (unsigned long)h.image_id, (unsigned)h.count,
+           (unsigned long)h.image_size, (unsigned long)s_part->size);
+  return ESP_OK;
+}
+
+bool asset_store_available(void) { return s_ready; }
+
+size_t asset_store_count(void) { return s_ready ? s_hdr.count : 0; }
+
+static void asset_fill(const asset_store_dir_entry_t *e,
+                       asset_store_entry_t *out) {
+  out->name = asset_str(e->name_off, "");
+  out->hashed_name = asset_str(e->hashed_off, NULL);
+  out->mime = asset_str(e->mime_off, "");
+  out->encoding = asset_str(e->encoding_off, "");
+  out->etag = asset_str(e->etag_off, "");
+  out->data = s_base + e->data_off;
+  out->len = e->data_len;
+}
+
+static const asset_store_dir_entry_t *asset_dir(void) {
+  return (const asset_store_dir_entry_t *)(s_base + sizeof(s_hdr));
+}
+
+bool asset_store_get(size_t index, asset_store_entry_t *out) {
+  if (!s_ready || out == NULL || index >= s_hdr.count) {
+    return false;
+  }
+  asset_fill(&asset_dir()[index], out);
+  return true;
+}
+
+static bool asset_name_eq(uint32_t off, const char *name, size_t n) {
+  if (off == 0) {
+    return false;
+  }
+  const char *s = (const char *)(s_base + off);
+  return strncmp(s, name, n) == 0 && s[n] == '\0';
+}
+
+bool asset_store_find(const char *name, asset_store_entry_t *out,
+                      bool *is_hashed) {
+  if (!s_ready || name == NULL || out == NULL) {
+    return false;
+  }
+  size_t n = strcspn(name, "?#");
+  const asset_store_dir_entry_t *dir = asset_dir();
+  for (uint16_t i = 0; i < s_hdr.count; i++) {
+    bool plain = asset_name_eq(dir[i].name_off, name, n);
+    if (plain || asset_name_eq(dir[i].hashed_off, name, n)) {
+      if (is_hashed != NULL) {
+        *is_hashed = !plain;
+      }
+      asset_fill(&dir[i], out);
+      return true;
+    }
+  }
+  return false;
+}
+
+void asset_store_info(uint32_t *image_id, uint32_t *image_size,
+                      uint32_t *partition_size) {
+  if (image_id != NULL) {
+    *image_id = s_ready ? s_hdr.image_id : 0;
+  }
+  if (image_size != NULL) {
+    *image_size = s_ready ? s_hdr.image_size : 0;
+  }
+  if (partition_size != NULL) {
+    *partition_size = s_part != NULL ? (uint32_t)s_part->size : 0;
+  }
+}
+
+esp_err_t asset_store_update_begin(size_t image_size) {
+  if (s_base == NULL) {
+    return ESP_ERR_NOT_FOUND;
+  }
+  if (s_upd.active) {
+    return ESP_ERR_INVALID_STATE;
+  }
+  if (image_size <= sizeof(asset_store_header_t) ||
+      image_size > s_part->size) {
+    return ESP_ERR_INVALID_SIZE;
+  }
+  s_ready = false;
+  size_t erase = (image_size + s_part->erase_size - 1) & ~(s_part->erase_size - 1);
+  esp_err_t ret = esp_partition_erase_range(s_part, 0, erase);
+  if (ret != ESP_OK) {
+    ESP_LOGE(TAG, "erase failed: %s", esp_err_to_name(ret));
+    return ret;
+  }
+  memset(&s_upd, 0, sizeof(s_upd));
+  s_upd.active = true;
+  s_upd.size = image_size;
+  ESP_LOGI(TAG, "update: %u B, erased %u B", (unsigned)image_size,
+           (unsigned)erase);
+  return ESP_OK;
+}
+
+esp_err_t asset_store_update_write(const void *data, size_t len) {
+  if (!s_upd.active) {
+    return ESP_ERR_INVALID_STATE;
+  }
+  if (len > s_upd.size - s_upd.written) {
+    return ESP_ERR_INVALID_SIZE;
+  }
+  const uint8_t *p = data;
+  /* Hlavička zůstane v RAM až do update_end. */
+  if (s_upd.written < sizeof(s_upd.header)) {
+    size_t n = sizeof(s_upd.header) - s_upd.written;
+    if (n > len) {
+      n = len;
+    }
+    memcpy(s_upd.header + s_upd.written, p, n);
+    s_upd.written += n;
+    p += n;
+    len -= n;
+  }
+  if (len == 0) {
+    return ESP_OK;
+  }
+  esp_err_t ret = esp_partition_write(s_part, s_upd.written, p, len);
+  if (ret == ESP_OK) {
+    s_upd.written += len;
+  }
+  return ret;
+}
+
+/** CRC32 úseku oddílu přes esp_partition_read (ne přes cache mapování). */
+static esp_err_t asset_crc_flash(size_t off, size_t len, uint32_t *crc_out) {
+  uint8_t buf[ASSET_STORE_VERIFY_CHUNK];
+  uint32_t crc = 0;
+  while (len > 0) {
+    size_t n = len < sizeof(buf) ? len : sizeof(buf);
+    esp_err_t ret = esp_partition_read(s_part, off, buf, n);
+    if (ret != ESP_OK) {
+      return ret;
+    }
+    crc = esp_rom_crc32_le(crc, buf, n);
+    off += n;
+    len -= n;
+  }
+  *crc_out = crc;
+  return ESP_OK;
+}
+
+esp_err_t asset_store_update_end(void) {
+  if (!s_upd.active) {
+    return ESP_ERR_INVALID_STATE;
+  }
+  s_upd.active = false;
+  asset_store_header_t h;
+  memcpy(&h, s_upd.header, sizeof(h));
+  if (s_upd.written != s_upd.size || h.magic != ASSET_STORE_MAGIC ||
+      h.image_size != s_upd.size || h.dir_size > h.image_size - sizeof(h)) {
+    ESP_LOGW(TAG, "update: bad header or size (%u / %u B)",
+             (unsigned)s_upd.written, (unsigned)s_upd.size);
+    return ESP_ERR_INVALID_SIZE;
+  }
+  uint32_t dir_crc = 0;
+  uint32_t data_crc = 0;
+  esp_err_t ret = asset_crc_flash(sizeof(h), h.dir_size, &dir_crc);
+  if (ret == ESP_OK) {
+    ret = asset_crc_flash(sizeof(h) + h.dir_size,
+                          h.image_size - sizeof(h) - h.dir_size, &data_crc);
+  }
+  if (ret != ESP_OK) {
+    return ret;
+  }
+  if (dir_crc != h.dir_crc || data_crc != h.data_crc) {
+    ESP_LOGW(TAG, "update: CRC mismatch");
+    return ESP_ERR_INVALID_CRC;
+  }
+  ret = esp_partition_write(s_part, 0, &h, sizeof(h));
+  if (ret != ESP_OK) {
+    return ret;
+  }
+  ret = asset_validate(s_base, &h, s_part->size);
+  if (ret != ESP_OK) {
+    ESP_LOGW(TAG, "update: invalid directory (%s)", esp_err_to_name(ret));
+    return ret;
+  }
+  s_hdr = h;
+  s_ready = true;
+  ESP_LOGI(TAG, "update: assets %08lx active (%u entries)",
+           (unsigned long)h.image_id, (unsigned)h.count);
+  return ESP_OK;
+}
+
+void asset_store_update_abort(void) {
+  if (s_upd.active) {
+    s_upd.active = false;
+    ESP_LOGW(TAG, "update aborted at %u / %u B", (unsigned)s_upd.written,
+             (unsigned)s_upd.size);
+  }
+}
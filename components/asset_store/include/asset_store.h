@@ -0,0 +1,125 @@
+/**
+ * @file asset_store.h
+ * @brief Read-only assety v oddílu `assets` — mmap při bootu, zero-copy přístup.
+ *
+ * Obraz oddílu skládá tools/build_asset_image.py (PNG figurek, katalog
+ * otevření, …) a nahrává se zvlášť od aplikace (`idf.py flash`, parttool nebo
+ * POST /api/assets). Změna assetu tak nevyžaduje nový firmware.
+ *
+ * Formát (little-endian):
+ * - hlavička 32 B (asset_store_header_t),
+ * - adresář `count` × 32 B (asset_store_dir_entry_t),
+ * - tabulka řetězců (NUL-terminated),
+ * - data (zarovnaná na 4 B).
+ * Offsety v adresáři jsou od začátku obrazu; 0 = řetězec chybí.
+ * `dir_crc` pokrývá adresář + řetězce (kontrola při bootu), `data_crc` data
+ * (kontrola po nahrání nového obrazu).
+ *
+ * Ukazatele z asset_store_find/asset_store_get míří přímo do mapované flash a
+ * platí do dalšího asset_store_update_end (nový obraz).
+ */
+
+#pragma once
+
+#include "esp_err.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Label oddílu v partitions.csv (data, subtype 0x41). */
+#define ASSET_STORE_PARTITION_LABEL "assets"
+/** "CMA1" */
+#define ASSET_STORE_MAGIC 0x31414d43u
+#define ASSET_STORE_VERSION 1
+
+typedef struct __attribute__((packed)) {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t count;      ///< Počet položek adresáře
+  uint32_t image_size; ///< Celý obraz vč. hlavičky
+  uint32_t dir_size;   ///< Adresář + řetězce (za hlavičkou)
+  uint32_t dir_crc;    ///< CRC32 adresáře + řetězců
+  uint32_t data_crc;   ///< CRC32 dat (od 32 + dir_size do image_size)
+  uint32_t image_id;   ///< Prvních 32 b SHA-256 obsahu (verze obrazu)
+  uint32_t reserved;
+} asset_store_header_t;
+
+typedef struct __attribute__((packed)) {
+  uint32_t name_off;     ///< Stabilní jméno / URI
+  uint32_t hashed_off;   ///< URI s hashem obsahu (0 = není)
+  uint32_t mime_off;     ///< Content-Type (0 = není)
+  uint32_t encoding_off; ///< Content-Encoding (0 = identity)
+  uint32_t etag_off;     ///< Silný ETag vč. uvozovek (0 = není)
+  uint32_t data_off;
+  uint32_t data_len;
+  uint32_t reserved;
+} asset_store_dir_entry_t;
+
+/** Položka pro volajícího — vše ukazuje do mapované flash. */
+typedef struct {
+  const char *name;
+  const char *hashed_name; ///< NULL = není
+  const char *mime;        ///< "" = není
+  const char *encoding;    ///< "" = identity
+  const char *etag;        ///< "" = není
+  const uint8_t *data;
+  size_t len;
+} asset_store_entry_t;
+
+/**
+ * @brief Najde oddíl, ověří hlavičku + adresář a namapuje obraz (při bootu)
+ * @return ESP_OK, ESP_ERR_NOT_FOUND bez oddílu, ESP_ERR_INVALID_CRC /
+ *         ESP_ERR_INVALID_VERSION prázdný nebo poškozený obraz
+ */
+esp_err_t asset_store_init(void);
+
+/** @brief Je obraz namapovaný a platný? */
+bool asset_store_available(void);
+
+/** @brief Počet položek (0 bez obrazu) */
+size_t asset_store_count(void);
+
+/** @brief Položka podle indexu (pořadí z obrazu) */
+bool asset_store_get(size_t index, asset_store_entry_t *out);
+
+/**
+ * @brief Najde položku podle jména nebo hashovaného jména
+ * @param name Jméno; porovná se jen do `?` / `#` (URI s query)
+ * @param[out] is_hashed true = shoda s hashed_name (může být NULL)
+ */
+bool asset_store_find(const char *name, asset_store_entry_t *out,
+                      bool *is_hashed);
+
+/** @brief ID obrazu a velikosti pro /api/assets (0 bez obrazu) */
+void asset_store_info(uint32_t *image_id, uint32_t *image_size,
+                      uint32_t *partition_size);
+
+/**
+ * @brief Zahájí zápis nového obrazu (odmapuje starý, smaže potřebné sektory)
+ *
+ * Hlavička se zapisuje až v asset_store_update_end — přerušený zápis nechá
+ * oddíl bez platného magicu, ne napůl platný.
+ * @return ESP_ERR_INVALID_SIZE obraz se nevejde, ESP_ERR_INVALID_STATE už běží
+ */
+esp_err_t asset_store_update_begin(size_t image_size);
+
+/** @brief Další část obrazu (v pořadí, libovolná délka) */
+esp_err_t asset_store_update_write(const void *data, size_t len);
+
+/**
+ * @brief Ověří CRC zapsaného obrazu, zapíše hlavičku a namapuje ho
+ * @return ESP_ERR_INVALID_CRC / ESP_ERR_INVALID_SIZE — oddíl zůstane prázdný
+ */
+esp_err_t asset_store_update_end(void);
+
+/** @brief Zruší rozpracovaný zápis (oddíl zůstane bez platného obrazu) */
+void asset_store_update_abort(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,128 @@
+#!/usr/bin/env python3
+"""
+Obraz oddílu `assets` (asset_store.h) — volá CMake, lze spustit i ručně.
+
+Každý asset `uri=soubor` projde stejnou úpravou jako kompilované statické
+assety (build_web_assets.py: minifikace JSON, gzip jen při úspoře >= 10 %,
+SHA-256 ETag a hashovaná URI) a zapíše se do jednoho binárního obrazu:
+hlavička 32 B, adresář 32 B na položku, řetězce, data zarovnaná na 4 B.
+Manifest (/static/asset-manifest.json) je součástí obrazu.
+
+Nahrání bez buildu aplikace:
+  parttool.py write_partition --partition-name assets --input build/assets.bin
+  curl -H 'Authorization: Bearer <token>' --data-binary @build/assets.bin \\
+       http://czechmate.local/api/assets
+
+Report velikostí (z kořene repa):
+  python3 components/asset_store/tools/build_asset_image.py --report \\
+      /static/data/openings_catalog.json=components/web_server_task/web/data/openings_catalog.json
+"""
+
+from __future__ import annotations
+
+import argparse
+import hashlib
+import os
+import struct
+import sys
+import zlib
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+sys.path.insert(0, os.path.join(HERE, "..", "..", "web_server_task", "tools"))
+
+import build_web_assets  # noqa: E402
+
+MAGIC = 0x31414D43  # "CMA1"
+VERSION = 1
+HEADER = struct.Struct("<IHHIIIIII")
+ENTRY = struct.Struct("<IIIIIIII")
+
+
+def align4(n: int) -> int:
+    return (n + 3) & ~3
+
+
+def pack_image(assets: list[dict]) -> bytes:
+    strings = bytearray()
+    offsets: dict[str, int] = {}
+    dir_start = HEADER.size
+    str_start = dir_start + ENTRY.size * len(assets)
+
+    def string(s: str | None) -> int:
+        if not s:
+            return 0
+        if s not in offsets:
+            offsets[s] = str_start + len(strings)
+            strings.extend(s.encode("utf-8") + b"\0")
+        return offsets[s]
+
+    rows = []
+    for a in assets:
+        rows.append(
+            [
+                string(a["uri"]),
+                string(a["hashed_uri"]),
+                string(a["mime"]),
+                string(a["encoding"]),
+                string('"' + a["etag"] + '"'),
+            ]
+        )
+    dir_size = align4(str_start + len(strings)) - dir_start
+    strings.extend(b"\0" * (dir_size - (str_start - dir_start) - len(strings)))
+
+    data = bytearray()
+    data_start = dir_start + dir_size
+    directory = bytearray()
+    for a, row in zip(assets, rows):
+        off = data_start + len(data)
+        data.extend(a["data"])
+        data.extend(b"\0" * (align4(len(data)) - len(data)))
+        directory.extend(ENTRY.pack(*row, off, len(a["data"]), 0))
+
+    dir_blob = bytes(directory) + bytes(strings)
+    image_size = HEADER.size + len(dir_blob) + len(data)
+    image_id = int.from_bytes(hashlib.sha256(dir_blob + data).digest()[:4], "little")
+    header = HEADER.pack(
+        MAGIC,
+        VERSION,
+        len(assets),
+        image_size,
+        len(dir_blob),
+        zlib.crc32(dir_blob),
+        zlib.crc32(data),
+        image_id,
+        0,
+    )
+    return header + dir_blob + bytes(data)
+
+
+def main() -> int:
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[1])
+    ap.add_argument(
+        "assets", nargs="+", type=build_web_assets.parse_pair, metavar="URI=PATH"
+    )
+    ap.add_argument("--out", help="výstupní obraz (assets.bin)")
+    ap.add_argument("--max-size", type=lambda s: int(s, 0), help="velikost oddílu")
+    ap.add_argument("--brotli", action="store_true", help="zkusit i brotli")
+    ap.add_argument("--report", action="store_true", help="vypsat velikosti")
+    args = ap.parse_args()
+
+    assets = build_web_assets.build(args.assets, args.brotli)
+    image = pack_image(assets)
+    if args.report or not args.out:
+        build_web_assets.report(assets)
+        print(f"{'IMAGE':<48} {len(image):>8} B")
+    if args.max_size is not None and len(image) > args.max_size:
+        print(
+            f"build_asset_image: {len(image)} B > partition {args.max_size} B",
+            file=sys.stderr,
+        )
+        return 1
+    if args.out:
+        with open(args.out, "wb") as f:
+            f.write(image)
+    return 0
+
+
+if __name__ == "__main__":
+    raise SystemExit(main())
@@ -16,6 +16,7 @@
 #include "host/ble_gatt.h"
 #include "host/ble_hs.h"
 #include "host/ble_hs_mbuf.h"
+#include "host/ble_l2cap.h"
 #include "host/ble_sm.h"
 #include "host/ble_store.h"
 #include "host/ble_uuid.h"
@@ -28,11 +29,15 @@
 /** NimBLE store/config — v ESP-IDF příkladech (bleprph) bez prototypu v public hlavičce. */
 void ble_store_config_init(void);
 #include "esp_task_wdt.h"
+#include "freertos/FreeRTOS.h"
 #include "game_state_notify.h"
+#include "game_task.h"
+#include "snapshot_bin.h"
 #include "ota_update.h"
 #include "web_server_task.h"
 #include <assert.h>
 #include <inttypes.h>
+#include <stdlib.h>
 #include <string.h>
 
 #if CONFIG_ESP_COEX_ENABLED
@@ -79,13 +84,33 @@ static const ble_uuid128_t czechmate_cmd_ack_chr_uuid =
     BLE_UUID128_INIT(0x9e, 0x8d, 0x8a, 0x6f, 0x33, 0xe8, 0xcc, 0xbd, 0xb6, 0x4a,
                      0x67, 0x92, 0x05, 0x00, 0xb4, 0xa0);
 
+/** A0B40006-… — kompaktní binární snapshot (snapshot_bin.h), read + notify */
+static const ble_uuid128_t czechmate_snap_bin_chr_uuid =
+    BLE_UUID128_INIT(0x9e, 0x8d, 0x8a, 0x6f, 0x33, 0xe8, 0xcc, 0xbd, 0xb6, 0x4a,
+                     0x67, 0x92, 0x06, 0x00, 0xb4, 0xa0);
+
 static uint16_t g_snap_val_handle;
 static uint16_t g_cmd_val_handle;
 static uint16_t g_net_val_handle;
 static uint16_t g_cmd_ack_val_handle;
+static uint16_t g_snap_bin_val_handle;
 static uint16_t s_conn_handle = BLE_HS_CONN_HANDLE_NONE;
+/** Roste s každým CONNECT — viz ble_task_conn_session(). */
+static uint32_t s_conn_session;
 static bool s_net_notify_enabled = false;
 static bool s_cmd_ack_notify_enabled = false;
+static bool s_snap_bin_notify_enabled = false;
+/** PHY po BLE_GAP_EVENT_PHY_UPDATE_COMPLETE (1 = 1M, 2 = 2M, 3 = Coded). */
+static uint8_t s_link_tx_phy = 1;
+static uint8_t s_link_rx_phy = 1;
+
+/** L2CAP CoC kanál jen pokud ho NimBLE má v sdkconfig (COC_MAX_NUM > 0). */
+#if defined(CONFIG_BT_NIMBLE_L2CAP_COC_MAX_NUM) && \
+    CONFIG_BT_NIMBLE_L2CAP_COC_MAX_NUM > 0
+#define CZECHMATE_COC_ENABLED 1
+#else
+#define CZECHMATE_COC_ENABLED 0
+#endif
 
 #if CONFIG_BT_NIMBLE_SECURITY_ENABLE
 /** Odložené opakování SMP po CONNECT — iOS někdy nereaguje na první security request. */
@@ -279,26 +304,46 @@ static int czechmate_gatt_access(uint16_t conn_handle, uint16_t attr_handle,
   switch (ctxt->op) {
   case BLE_GATT_ACCESS_OP_READ_CHR:
     if (attr_handle == g_snap_val_handle) {
-      char *snap = NULL;
-      size_t len = 0;
-      esp_err_t e = web_server_build_game_snapshot_json_shared(&snap, &len);
-      if (e != ESP_OK || len == 0 || snap == NULL) {
+      web_snapshot_t *snap = NULL;
+      esp_err_t e = web_snapshot_acquire(&snap);
+      size_t len = web_snapshot_len(snap);
+      if (e != ESP_OK || len == 0) {
         ESP_LOGW(TAG,
                  "[STAGING] BLE read snapshot: build failed (%s)",
                  esp_err_to_name(e));
+        web_snapshot_release(snap);
         return BLE_ATT_ERR_UNLIKELY;
       }
       if (len > 65535U) {
         ESP_LOGW(TAG, "[STAGING] BLE read snapshot: JSON > 65535 B");
+        web_snapshot_release(snap);
         return BLE_ATT_ERR_UNLIKELY;
       }
-      int rc = os_mbuf_append(ctxt->om, snap, (uint16_t)len);
+      int rc = os_mbuf_append(ctxt->om, web_snapshot_json(snap), (uint16_t)len);
+      web_snapshot_release(snap);
       if (rc != 0) {
         ESP_LOGW(TAG, "[STAGING] os_mbuf_append failed rc=%d", rc);
         return BLE_ATT_ERR_INSUFFICIENT_RES;
       }
       return 0;
     }
+    if (attr_handle == g_snap_bin_val_handle) {
+      /* Konec historie — hodnota se vejde do jedné ATT PDU i bez read blob. */
+      uint8_t bin[SNAPSHOT_BIN_BLE_MAX_SIZE];
+      size_t len = 0;
+      esp_err_t e = game_get_snapshot_bin(bin, sizeof(bin),
+                                          SNAPSHOT_BIN_BLE_MAX_MOVES, &len);
+      if (e != ESP_OK) {
+        ESP_LOGW(TAG, "BLE read snapshot_bin: %s", esp_err_to_name(e));
+        return BLE_ATT_ERR_UNLIKELY;
+      }
+      int rc = os_mbuf_append(ctxt->om, bin, (uint16_t)len);
+      if (rc != 0) {
+        ESP_LOGW(TAG, "[STAGING] os_mbuf_append snapshot_bin failed rc=%d", rc);
+        return BLE_ATT_ERR_INSUFFICIENT_RES;
+      }
+      return 0;
+    }
     if (attr_handle == g_net_val_handle) {
       char net_json[384];
       czechmate_build_network_json(net_json, sizeof(net_json));
@@ -431,6 +476,12 @@ static const struct ble_gatt_svc_def czechmate_svcs[] = {
                     .flags = BLE_GATT_CHR_F_NOTIFY,
                     .val_handle = &g_cmd_ack_val_handle,
                 },
+                {
+                    .uuid = &czechmate_snap_bin_chr_uuid.u,
+                    .access_cb = czechmate_gatt_access,
+                    .flags = BLE_GATT_CHR_F_READ | BLE_GATT_CHR_F_NOTIFY,
+                    .val_handle = &g_snap_bin_val_handle,
+                },
                 {
                     0,
                 },
@@ -612,6 +663,453 @@ static void czechmate_security_retry_cb(struct ble_npl_event *ev) {
 }
 #endif
 
+/**
+ * 2M PHY + data length extension (251 B / 2120 µs) hned po CONNECT.
+ * Centrál bez podpory požadavek odmítne nebo zůstane na 1M / 27 B — GATT i CoC
+ * fungují dál, jen pomaleji. Výsledek PHY hlásí BLE_GAP_EVENT_PHY_UPDATE_COMPLETE.
+ */
+static void czechmate_request_fast_link(uint16_t conn_handle) {
+  int rc = ble_gap_set_data_len(conn_handle, 251, 2120);
+  if (rc != 0) {
+    ESP_LOGW(TAG, "ble_gap_set_data_len rc=%d", rc);
+  }
+#if CONFIG_BT_NIMBLE_LL_CFG_FEAT_LE_2M_PHY
+  rc = ble_gap_set_prefered_le_phy(conn_handle, BLE_GAP_LE_PHY_2M_MASK,
+                                   BLE_GAP_LE_PHY_2M_MASK,
+                                   BLE_GAP_LE_PHY_CODED_ANY);
+  if (rc != 0) {
+    ESP_LOGW(TAG, "ble_gap_set_prefered_le_phy(2M) rc=%d", rc);
+  }
+#endif
+}
+
+#if CZECHMATE_COC_ENABLED
+/*
+ * L2CAP CoC (LE credit based) kanál pro bulk přenosy, PSM 0x0080.
+ *
+ * GATT notify nese snapshot v dílech s part/total v uint8 (max 255 notify) a
+ * každý díl je jedna ATT PDU. CoC posílá SDU až do MTU kanálu — segmentaci na
+ * K-frames a kredity řeší L2CAP, centrál nám kredity vrací podle toho, jak
+ * stíhá číst. Každé SDU v obou směrech má stejnou hlavičku jako OTA `OB`:
+ *
+ *   [m0 m1][idx u16 LE][total u16 LE] + payload   (idx od 0)
+ *
+ *   → CM  snapshot JSON (plný nebo delta — stejný obsah jako notify A0B40002)
+ *   → SB  binární snapshot (snapshot_bin.h)
+ *   → GH  export historie partie (game_write_history_json)
+ *   ← OB  firmware chunk → ota_update_ble_feed_chunk (jen šifrovaný link)
+ *   ← GH  žádost o export historie (jen 2 B magic)
+ *
+ * Který snapshot centrál chce, dál určuje CCC na A0B40002 / A0B40006; CoC jen
+ * mění transport. OTA data tečou centrál → deska s vlastními kredity, takže
+ * snapshoty přes CoC se během BLE OTA nepotlačují (na GATT ano).
+ */
+#define CZECHMATE_COC_PSM 0x0080
+/** Max SDU v obou směrech (OTA chunk = 6 B hlavička + až 2042 B image). */
+#define CZECHMATE_COC_MTU 2048
+#define CZECHMATE_COC_HDR_LEN 6
+/**
+ * Vlastní mbuf pool, jeden blok = celé SDU: 2× RX (jeden u stacku přes
+ * recv_ready, druhý se právě vrací) + 2× TX (jedno SDU u stacku, SDU_BUFF_COUNT=1).
+ */
+#define CZECHMATE_COC_BUF_COUNT 4
+#define CZECHMATE_COC_BLOCK_SIZE                                               \
+  (CZECHMATE_COC_MTU + sizeof(struct os_mbuf) + sizeof(struct os_mbuf_pkthdr))
+
+static os_membuf_t s_coc_mem[OS_MEMPOOL_SIZE(CZECHMATE_COC_BUF_COUNT,
+                                             CZECHMATE_COC_BLOCK_SIZE)];
+static struct os_mempool s_coc_mempool;
+static struct os_mbuf_pool s_coc_mbuf_pool;
+static bool s_coc_pool_ready;
+
+/** Otevřený kanál (jen host task ho nastavuje / čte pro send). */
+static struct ble_l2cap_chan *s_coc_chan;
+/** Max SDU centrálu z ble_l2cap_get_chan_info (0 = kanál zavřený). */
+static uint16_t s_coc_peer_mtu;
+/** ble_l2cap_send vrátil ESTALLED/EBUSY — další SDU až po COC_TX_UNSTALLED. */
+static bool s_coc_tx_stalled;
+static uint32_t s_coc_tx_sdus;
+static uint32_t s_coc_rx_sdus;
+
+/** Jeden SDU najednou na host tasku — kopie z mbufu pro OTA / příkazy. */
+static uint8_t s_coc_rx_copy[CZECHMATE_COC_MTU];
+
+typedef enum {
+  COC_JOB_SNAP_BIN = 0, /**< malé, typicky 1 SDU — první */
+  COC_JOB_SNAP_JSON,
+  COC_JOB_HISTORY,
+  COC_JOB_COUNT,
+} czechmate_coc_job_id_t;
+
+/**
+ * Odchozí stream jednoho typu. Novější obsah téhož typu nahradí ještě
+ * nezačatý (snapshot = poslední vyhrává); rozeslaný se dokončí a nový čeká
+ * v `next`, aby centrál nedostal díly dvou různých snapshotů.
+ */
+typedef struct {
+  uint8_t m0;
+  uint8_t m1;
+  uint8_t *data;  /**< malloc, vlastní job; NULL = nic k odeslání */
+  size_t len;
+  size_t off;
+  bool started;   /**< host task už poslal / posílá díl z `data` */
+  uint8_t *next;
+  size_t next_len;
+} czechmate_coc_job_t;
+
+static czechmate_coc_job_t s_coc_jobs[COC_JOB_COUNT] = {
+    [COC_JOB_SNAP_BIN] = {.m0 = 'S', .m1 = 'B'},
+    [COC_JOB_SNAP_JSON] = {.m0 = 'C', .m1 = 'M'},
+    [COC_JOB_HISTORY] = {.m0 = 'G', .m1 = 'H'},
+};
+/** Joby plní web_server_task, odesílá host task — jen výměna ukazatelů. */
+static portMUX_TYPE s_coc_mux = portMUX_INITIALIZER_UNLOCKED;
+static struct ble_npl_event s_coc_tx_npl_ev;
+static bool s_coc_tx_npl_ev_inited;
+
+static bool czechmate_coc_is_open(void) { return s_coc_peer_mtu != 0; }
+
+/** Zahodí všechny joby (zavření kanálu / disconnect). */
+static void czechmate_coc_jobs_clear(void) {
+  uint8_t *to_free[COC_JOB_COUNT * 2];
+  size_t n = 0;
+  taskENTER_CRITICAL(&s_coc_mux);
+  for (int i = 0; i < COC_JOB_COUNT; i++) {
+    czechmate_coc_job_t *job = &s_coc_jobs[i];
+    to_free[n++] = job->data;
+    to_free[n++] = job->next;
+    job->data = NULL;
+    job->next = NULL;
+    job->len = 0;
+    job->next_len = 0;
+    job->off = 0;
+    job->started = false;
+  }
+  taskEXIT_CRITICAL(&s_coc_mux);
+  for (size_t i = 0; i < n; i++) {
+    free(to_free[i]);
+  }
+}
+
+static void czechmate_coc_reset(void) {
+  s_coc_chan = NULL;
+  s_coc_peer_mtu = 0;
+  s_coc_tx_stalled = false;
+  czechmate_coc_jobs_clear();
+}
+
+/** Posunutí jobu po odeslaném SDU; po posledním dílu převezme `next`. */
+static void czechmate_coc_job_advance(czechmate_coc_job_t *job, size_t sent) {
+  uint8_t *done = NULL;
+  taskENTER_CRITICAL(&s_coc_mux);
+  job->off += sent;
+  if (job->off >= job->len) {
+    done = job->data;
+    job->data = job->next;
+    job->len = job->next_len;
+    job->next = NULL;
+    job->next_len = 0;
+    job->off = 0;
+    job->started = false;
+  }
+  taskEXIT_CRITICAL(&s_coc_mux);
+  free(done);
+}
+
+/** Pošle SDU, dokud má kanál kredity (ESTALLED) nebo nejsou data. Host task. */
+static void czechmate_coc_pump(void) {
+  while (s_coc_chan != NULL && !s_coc_tx_stalled) {
+    size_t cap = s_coc_peer_mtu;
+    if (cap > CZECHMATE_COC_MTU) {
+      cap = CZECHMATE_COC_MTU;
+    }
+    if (cap <= CZECHMATE_COC_HDR_LEN) {
+      return;
+    }
+    cap -= CZECHMATE_COC_HDR_LEN;
+
+    czechmate_coc_job_t *job = NULL;
+    const uint8_t *data = NULL;
+    size_t len = 0;
+    size_t off = 0;
+    taskENTER_CRITICAL(&s_coc_mux);
+    for (int i = 0; i < COC_JOB_COUNT; i++) {
+      if (s_coc_jobs[i].data != NULL) {
+        job = &s_coc_jobs[i];
+        job->started = true;
+        data = job->data;
+        len = job->len;
+        off = job->off;
+        break;
+      }
+    }
+    taskEXIT_CRITICAL(&s_coc_mux);
+    if (job == NULL) {
+      return;
+    }
+
+    size_t total = (len + cap - 1) / cap;
+    size_t chunk = len - off;
+    if (chunk > cap) {
+      chunk = cap;
+    }
+    if (total > UINT16_MAX) {
+      ESP_LOGE(TAG, "CoC %c%c: %u B → %u SDU (max 65535) — zahozeno", job->m0,
+               job->m1, (unsigned)len, (unsigned)total);
+      czechmate_coc_job_advance(job, len - off);
+      continue;
+    }
+    size_t idx = off / cap;
+    const uint8_t hdr[CZECHMATE_COC_HDR_LEN] = {
+        job->m0,
+        job->m1,
+        (uint8_t)(idx & 0xFF),
+        (uint8_t)(idx >> 8),
+        (uint8_t)(total & 0xFF),
+        (uint8_t)(total >> 8),
+    };
+    struct os_mbuf *om = os_mbuf_get_pkthdr(&s_coc_mbuf_pool, 0);
+    if (om == NULL) {
+      /* Pool se uvolní po odeslání předchozího SDU; pokračuje další pump. */
+      ESP_LOGW(TAG, "CoC: TX mbuf pool vyčerpán");
+      return;
+    }
+    if (os_mbuf_append(om, hdr, sizeof(hdr)) != 0 ||
+        os_mbuf_append(om, data + off, (uint16_t)chunk) != 0) {
+      os_mbuf_free_chain(om);
+      ESP_LOGW(TAG, "CoC: os_mbuf_append failed");
+      return;
+    }
+    int rc = ble_l2cap_send(s_coc_chan, om);
+    if (rc == BLE_HS_ESTALLED) {
+      /* SDU převzal stack, zbytek dopošle po nových kreditech. */
+      s_coc_tx_stalled = true;
+    } else if (rc == BLE_HS_EBUSY) {
+      os_mbuf_free_chain(om);
+      s_coc_tx_stalled = true;
+      return;
+    } else if (rc != 0) {
+      os_mbuf_free_chain(om);
+      ESP_LOGW(TAG, "CoC: ble_l2cap_send rc=%d", rc);
+      return;
+    }
+    s_coc_tx_sdus++;
+    ESP_LOGD(TAG, "CoC %c%c SDU %u/%u (%u B)", job->m0, job->m1,
+             (unsigned)(idx + 1), (unsigned)total, (unsigned)chunk);
+    czechmate_coc_job_advance(job, chunk);
+  }
+}
+
+static void czechmate_coc_tx_npl_cb(struct ble_npl_event *ev) {
+  (void)ev;
+  czechmate_coc_pump();
+}
+
+/**
+ * Převezme `data` (malloc) do jobu a naplánuje pump na host tasku.
+ * Volat z libovolného tasku; při zavřeném kanálu data uvolní.
+ */
+static void czechmate_coc_enqueue(czechmate_coc_job_id_t id, uint8_t *data,
+                                  size_t len) {
+  if (!czechmate_coc_is_open() || !s_coc_tx_npl_ev_inited) {
+    free(data);
+    return;
+  }
+  uint8_t *old = NULL;
+  czechmate_coc_job_t *job = &s_coc_jobs[id];
+  taskENTER_CRITICAL(&s_coc_mux);
+  if (job->data == NULL) {
+    job->data = data;
+    job->len = len;
+    job->off = 0;
+  } else if (!job->started) {
+    old = job->data;
+    job->data = data;
+    job->len = len;
+  } else {
+    old = job->next;
+    job->next = data;
+    job->next_len = len;
+  }
+  taskEXIT_CRITICAL(&s_coc_mux);
+  free(old);
+  struct ble_npl_eventq *evq = nimble_port_get_dflt_eventq();
+  if (evq != NULL) {
+    ble_npl_eventq_put(evq, &s_coc_tx_npl_ev);
+  }
+}
+
+/** Kopie snapshotu do jobu — volající (web_server_task) buffer hned uvolní. */
+static void czechmate_coc_enqueue_copy(czechmate_coc_job_id_t id,
+                                       const uint8_t *data, size_t len) {
+  uint8_t *copy = malloc(len);
+  if (copy == NULL) {
+    ESP_LOGW(TAG, "CoC: malloc %u B failed", (unsigned)len);
+    return;
+  }
+  memcpy(copy, data, len);
+  czechmate_coc_enqueue(id, copy, len);
+}
+
+/** Odpověď na `GH` — celá historie partie jako JSON přes CoC. */
+static void czechmate_coc_queue_history(void) {
+  json_writer_t w;
+  esp_err_t e = json_writer_init_heap(&w, 1024);
+  if (e == ESP_OK) {
+    e = game_write_history_json(&w);
+  }
+  size_t len = 0;
+  char *json = (e == ESP_OK) ? json_writer_take(&w, &len) : NULL;
+  if (json == NULL) {
+    json_writer_discard(&w);
+    ESP_LOGW(TAG, "CoC GH: history export failed (%s)", esp_err_to_name(e));
+    return;
+  }
+  ESP_LOGI(TAG, "CoC GH: history %u B", (unsigned)len);
+  czechmate_coc_enqueue(COC_JOB_HISTORY, (uint8_t *)json, len);
+}
+
+/** Nový RX buffer stacku = kredity pro další SDU od centrálu. */
+static int czechmate_coc_rx_ready(struct ble_l2cap_chan *chan) {
+  struct os_mbuf *sdu_rx = os_mbuf_get_pkthdr(&s_coc_mbuf_pool, 0);
+  if (sdu_rx == NULL) {
+    ESP_LOGE(TAG, "CoC: RX mbuf pool vyčerpán");
+    return BLE_HS_ENOMEM;
+  }
+  int rc = ble_l2cap_recv_ready(chan, sdu_rx);
+  if (rc != 0) {
+    os_mbuf_free_chain(sdu_rx);
+    ESP_LOGW(TAG, "CoC: ble_l2cap_recv_ready rc=%d", rc);
+  }
+  return rc;
+}
+
+static void czechmate_coc_on_sdu(struct ble_l2cap_chan *chan,
+                                 struct os_mbuf *sdu) {
+  uint16_t n = OS_MBUF_PKTLEN(sdu);
+  if (n > sizeof(s_coc_rx_copy)) {
+    n = (uint16_t)sizeof(s_coc_rx_copy);
+  }
+  os_mbuf_copydata(sdu, 0, n, s_coc_rx_copy);
+  os_mbuf_free_chain(sdu);
+  s_coc_rx_sdus++;
+  /* Kredity vrátit hned po kopii — další SDU letí, zatímco se píše flash. */
+  (void)czechmate_coc_rx_ready(chan);
+
+  const uint8_t *p = s_coc_rx_copy;
+  if (n >= 7 && p[0] == 'O' && p[1] == 'B') {
+    static const char ack_chunk_bad[] =
+        "{\"cmd\":\"ota_ble_chunk\",\"ok\":false}";
+    esp_err_t derr = ESP_ERR_INVALID_STATE;
+    if (!ble_task_conn_is_encrypted()) {
+      ESP_LOGW(TAG, "CoC OTA chunk rejected: link not encrypted");
+    } else {
+      derr = ota_update_ble_feed_chunk(p, n);
+    }
+    /* Jako na GATT: ACK jen při chybě (cmd_ack notify), úspěch je tichý. */
+    if (derr != ESP_OK) {
+      ESP_LOGW(TAG, "CoC OTA chunk: %s", esp_err_to_name(derr));
+      ble_task_notify_command_result(derr, ack_chunk_bad);
+    }
+    return;
+  }
+  if (n == 2 && p[0] == 'G' && p[1] == 'H') {
+    czechmate_coc_queue_history();
+    return;
+  }
+  ESP_LOGW(TAG, "CoC: neznámé SDU %u B (%02x %02x)", (unsigned)n,
+           n > 0 ? p[0] : 0, n > 1 ? p[1] : 0);
+}
+
+static int czechmate_coc_event(struct ble_l2cap_event *event, void *arg) {
+  (void)arg;
+  switch (event->type) {
+  case BLE_L2CAP_EVENT_COC_ACCEPT:
+    if (event->accept.conn_handle != s_conn_handle ||
+        s_coc_chan != NULL) {
+      ESP_LOGW(TAG, "CoC accept odmítnut (h=%u, kanál už otevřený=%d)",
+               (unsigned)event->accept.conn_handle, (int)(s_coc_chan != NULL));
+      return BLE_HS_EREJECT;
+    }
+    return czechmate_coc_rx_ready(event->accept.chan);
+  case BLE_L2CAP_EVENT_COC_CONNECTED: {
+    if (event->connect.status != 0) {
+      ESP_LOGW(TAG, "CoC connect status=%d", event->connect.status);
+      return 0;
+    }
+    struct ble_l2cap_chan_info info = {0};
+    if (ble_l2cap_get_chan_info(event->connect.chan, &info) != 0) {
+      ESP_LOGW(TAG, "CoC: ble_l2cap_get_chan_info failed");
+      return 0;
+    }
+    s_coc_chan = event->connect.chan;
+    s_coc_tx_stalled = false;
+    s_coc_peer_mtu = info.peer_coc_mtu;
+    ESP_LOGI(TAG, "CoC open psm=0x%04x our_mtu=%u peer_mtu=%u peer_mps=%u",
+             (unsigned)info.psm, (unsigned)info.our_coc_mtu,
+             (unsigned)info.peer_coc_mtu, (unsigned)info.peer_l2cap_mtu);
+    /* Aktuální stav hned přes nový transport. */
+    czechmate_on_game_state_changed();
+    return 0;
+  }
+  case BLE_L2CAP_EVENT_COC_DISCONNECTED:
+    if (event->disconnect.chan == s_coc_chan) {
+      ESP_LOGI(TAG, "CoC closed (tx=%" PRIu32 " rx=%" PRIu32 " SDU)",
+               s_coc_tx_sdus, s_coc_rx_sdus);
+      czechmate_coc_reset();
+    }
+    return 0;
+  case BLE_L2CAP_EVENT_COC_DATA_RECEIVED:
+    if (event->receive.sdu_rx != NULL) {
+      czechmate_coc_on_sdu(event->receive.chan, event->receive.sdu_rx);
+    }
+    return 0;
+  case BLE_L2CAP_EVENT_COC_TX_UNSTALLED:
+    s_coc_tx_stalled = false;
+    if (event->tx_unstalled.status != 0) {
+      ESP_LOGW(TAG, "CoC tx_unstalled status=%d", event->tx_unstalled.status);
+    }
+    czechmate_coc_pump();
+    return 0;
+  default:
+    return 0;
+  }
+}
+
+/** Před startem host tasku — pool, NPL event a L2CAP server na PSM. */
+static void czechmate_coc_init(void) {
+  if (!s_coc_pool_ready) {
+    int rc = os_mempool_init(&s_coc_mempool, CZECHMATE_COC_BUF_COUNT,
+                             CZECHMATE_COC_BLOCK_SIZE, s_coc_mem, "coc_sdu");
+    if (rc == 0) {
+      rc = os_mbuf_pool_init(&s_coc_mbuf_pool, &s_coc_mempool,
+                             CZECHMATE_COC_BLOCK_SIZE, CZECHMATE_COC_BUF_COUNT);
+    }
+    if (rc != 0) {
+      ESP_LOGE(TAG, "CoC mbuf pool init rc=%d — kanál vypnutý", rc);
+      return;
+    }
+    s_coc_pool_ready = true;
+  }
+  if (!s_coc_tx_npl_ev_inited) {
+    ble_npl_event_init(&s_coc_tx_npl_ev, czechmate_coc_tx_npl_cb, NULL);
+    s_coc_tx_npl_ev_inited = true;
+  }
+  int rc = ble_l2cap_create_server(CZECHMATE_COC_PSM, CZECHMATE_COC_MTU,
+                                   czechmate_coc_event, NULL);
+  if (rc != 0) {
+    ESP_LOGE(TAG, "ble_l2cap_create_server psm=0x%04x rc=%d",
+             (unsigned)CZECHMATE_COC_PSM, rc);
+    return;
+  }
+  ESP_LOGI(TAG, "L2CAP CoC server psm=0x%04x mtu=%u",
+           (unsigned)CZECHMATE_COC_PSM, (unsigned)CZECHMATE_COC_MTU);
+}
+#else
+static bool czechmate_coc_is_open(void) { return false; }
+static void czechmate_coc_reset(void) {}
+#endif /* CZECHMATE_COC_ENABLED */
+
 static int czechmate_gap_event(struct ble_gap_event *event, void *arg) {
   (void)arg;
   ESP_LOGD(TAG, "[STAGING] GAP event type=%d", (int)event->type);
@@ -619,7 +1117,13 @@ static int czechmate_gap_event(struct ble_gap_event *event, void *arg) {
   case BLE_GAP_EVENT_CONNECT:
     if (event->connect.status == 0) {
       s_conn_handle = event->connect.conn_handle;
+      if (++s_conn_session == 0) {
+        s_conn_session = 1;
+      }
       ESP_LOGI(TAG, "connected handle=%d", s_conn_handle);
+      s_link_tx_phy = 1;
+      s_link_rx_phy = 1;
+      czechmate_request_fast_link(event->connect.conn_handle);
 #if CONFIG_ESP_COEX_ENABLED
       /* Jedno rádio Wi‑Fi + BLE: bez posunu k BLE často ATT vůbec neodpoví (iOS
        * „0 služeb“). PREFER_BALANCE u některých C6 + AP+STA nestačilo — dáváme
@@ -747,10 +1251,12 @@ static int czechmate_gap_event(struct ble_gap_event *event, void *arg) {
 #endif
     /* Uvolnit probíhající BLE stream OTA — jinak visí s_ble_ota_rx + s_ota_sem. */
     ota_update_ble_on_disconnect();
+    czechmate_coc_reset();
     s_conn_handle = BLE_HS_CONN_HANDLE_NONE;
     s_snap_notify_enabled = false;
     s_net_notify_enabled = false;
     s_cmd_ack_notify_enabled = false;
+    s_snap_bin_notify_enabled = false;
     ESP_LOGI(TAG, "disconnect reason=%d", event->disconnect.reason);
 #if CONFIG_ESP_COEX_ENABLED
     {
@@ -781,6 +1287,13 @@ static int czechmate_gap_event(struct ble_gap_event *event, void *arg) {
       s_cmd_ack_notify_enabled = event->subscribe.cur_notify;
       ESP_LOGI(TAG, "cmd_ack notify=%d", (int)s_cmd_ack_notify_enabled);
     }
+    if (event->subscribe.attr_handle == g_snap_bin_val_handle) {
+      s_snap_bin_notify_enabled = event->subscribe.cur_notify;
+      ESP_LOGI(TAG, "snapshot_bin notify=%d", (int)s_snap_bin_notify_enabled);
+      if (s_snap_bin_notify_enabled) {
+        czechmate_on_game_state_changed();
+      }
+    }
     return 0;
   case BLE_GAP_EVENT_CONN_UPDATE_REQ:
     if (event->conn_update_req.peer_params != NULL) {
@@ -797,6 +1310,18 @@ static int czechmate_gap_event(struct ble_gap_event *event, void *arg) {
                (unsigned)event->conn_update_req.conn_handle);
     }
     return 0;
+  case BLE_GAP_EVENT_PHY_UPDATE_COMPLETE:
+    ESP_LOGI(TAG, "PHY update h=%u status=%d tx=%u rx=%u (2 = 2M)",
+             (unsigned)event->phy_updated.conn_handle,
+             (int)event->phy_updated.status,
+             (unsigned)event->phy_updated.tx_phy,
+             (unsigned)event->phy_updated.rx_phy);
+    if (event->phy_updated.status == 0 &&
+        event->phy_updated.conn_handle == s_conn_handle) {
+      s_link_tx_phy = event->phy_updated.tx_phy;
+      s_link_rx_phy = event->phy_updated.rx_phy;
+    }
+    return 0;
   case BLE_GAP_EVENT_MTU:
     ESP_LOGI(TAG, "[STAGING] MTU h=%u cid=%u value=%u",
              (unsigned)event->mtu.conn_handle, (unsigned)event->mtu.channel_id,
@@ -882,6 +1407,9 @@ void ble_nimble_stack_init(void) {
 #endif
   ble_hs_cfg.sync_cb = ble_on_sync;
   czechmate_gatt_register_before_host_start();
+#if CZECHMATE_COC_ENABLED
+  czechmate_coc_init();
+#endif
   ble_store_config_init();
   ESP_LOGI(TAG, "[STAGING] ble_store_config_init (SMP store callbacks — nutné pro enc/link)");
   nimble_port_freertos_init(ble_host_task);
@@ -893,16 +1421,20 @@ void ble_task_format_status(char *buf, size_t cap) {
   }
   snprintf(
       buf, cap,
-      "BLE: %s | adv=%s | snap=%s net=%s ack=%s | h snap=%u cmd=%u net=%u ack=%u | NimBLE",
+      "BLE: %s | adv=%s | phy tx=%u rx=%u | coc=%s | snap=%s net=%s ack=%s bin=%s | h snap=%u cmd=%u net=%u ack=%u bin=%u | NimBLE",
       s_conn_handle == BLE_HS_CONN_HANDLE_NONE ? "disconnected" : "connected",
       ble_gap_adv_active() ? "on" : "off",
+      (unsigned)s_link_tx_phy, (unsigned)s_link_rx_phy,
+      czechmate_coc_is_open() ? "open" : "off",
       s_snap_notify_enabled ? "on" : "off",
       s_net_notify_enabled ? "on" : "off",
       s_cmd_ack_notify_enabled ? "on" : "off",
+      s_snap_bin_notify_enabled ? "on" : "off",
       (unsigned)g_snap_val_handle,
       (unsigned)g_cmd_val_handle,
       (unsigned)g_net_val_handle,
-      (unsigned)g_cmd_ack_val_handle);
+      (unsigned)g_cmd_ack_val_handle,
+      (unsigned)g_snap_bin_val_handle);
 }
 
 bool ble_task_conn_is_encrypted(void) {
@@ -951,26 +1483,25 @@ void ble_task_push_network_info(void) {
  */
 #define SNAPSHOT_NOTIFY_CHUNK_CAP 508
 
+uint32_t ble_task_conn_session(void) {
+  return (s_conn_handle == BLE_HS_CONN_HANDLE_NONE) ? 0 : s_conn_session;
+}
+
 bool ble_task_should_push_snapshot(void) {
   if (s_conn_handle == BLE_HS_CONN_HANDLE_NONE || !s_snap_notify_enabled) {
     return false;
   }
-  if (ota_update_ble_is_rx_active()) {
-    return false;
-  }
-  return true;
+  /* CoC má vlastní kredity — OTA chunky (centrál → deska) nepřebíjí. */
+  return czechmate_coc_is_open() || !ota_update_ble_is_rx_active();
 }
 
-void ble_task_push_snapshot_json(const uint8_t *data, size_t len) {
-  if (data == NULL || len == 0 || g_snap_val_handle == 0) {
-    ESP_LOGV(TAG, "push_snapshot: skip (no data or snap handle 0)");
-    return;
-  }
-  if (s_conn_handle == BLE_HS_CONN_HANDLE_NONE || !s_snap_notify_enabled) {
-    ESP_LOGV(TAG, "push_snapshot: skip (conn=%d notify=%d)", (int)s_conn_handle,
-             (int)s_snap_notify_enabled);
-    return;
-  }
+/**
+ * Chunkovaný notify na `val_handle`: každý díl = [m0 m1 part total] + payload.
+ * JSON snapshot používá „CM“, binární snapshot „SB“.
+ */
+static void czechmate_notify_chunked(uint16_t val_handle, uint8_t m0,
+                                     uint8_t m1, const uint8_t *data,
+                                     size_t len) {
   uint16_t mtu = ble_att_mtu(s_conn_handle);
   if (mtu < 27) {
     mtu = 23;
@@ -1016,8 +1547,8 @@ void ble_task_push_snapshot_json(const uint8_t *data, size_t len) {
       chunk = chunk_cap;
     }
     uint8_t pkt[4 + SNAPSHOT_NOTIFY_CHUNK_CAP];
-    pkt[0] = 0x43;
-    pkt[1] = 0x4D;
+    pkt[0] = m0;
+    pkt[1] = m1;
     pkt[2] = part;
     pkt[3] = total;
     memcpy(pkt + 4, data + off, chunk);
@@ -1025,7 +1556,7 @@ void ble_task_push_snapshot_json(const uint8_t *data, size_t len) {
     if (om == NULL) {
       return;
     }
-    int rc = ble_gatts_notify_custom(s_conn_handle, g_snap_val_handle, om);
+    int rc = ble_gatts_notify_custom(s_conn_handle, val_handle, om);
     if (rc != 0) {
       ESP_LOGW(TAG, "notify_custom rc=%d", rc);
       return;
@@ -1036,15 +1567,65 @@ void ble_task_push_snapshot_json(const uint8_t *data, size_t len) {
   }
 }
 
+void ble_task_push_snapshot_json(const uint8_t *data, size_t len) {
+  if (data == NULL || len == 0 || g_snap_val_handle == 0) {
+    ESP_LOGV(TAG, "push_snapshot: skip (no data or snap handle 0)");
+    return;
+  }
+  if (s_conn_handle == BLE_HS_CONN_HANDLE_NONE || !s_snap_notify_enabled) {
+    ESP_LOGV(TAG, "push_snapshot: skip (conn=%d notify=%d)", (int)s_conn_handle,
+             (int)s_snap_notify_enabled);
+    return;
+  }
+#if CZECHMATE_COC_ENABLED
+  if (czechmate_coc_is_open()) {
+    czechmate_coc_enqueue_copy(COC_JOB_SNAP_JSON, data, len);
+    return;
+  }
+#endif
+  czechmate_notify_chunked(g_snap_val_handle, 0x43, 0x4D, data, len);
+}
+
+bool ble_task_should_push_snapshot_bin(void) {
+  if (s_conn_handle == BLE_HS_CONN_HANDLE_NONE || !s_snap_bin_notify_enabled) {
+    return false;
+  }
+  return czechmate_coc_is_open() || !ota_update_ble_is_rx_active();
+}
+
+void ble_task_push_snapshot_bin(const uint8_t *data, size_t len) {
+  if (data == NULL || len == 0 || g_snap_bin_val_handle == 0) {
+    return;
+  }
+  if (s_conn_handle == BLE_HS_CONN_HANDLE_NONE || !s_snap_bin_notify_enabled) {
+    ESP_LOGV(TAG, "push_snapshot_bin: skip (conn=%d notify=%d)",
+             (int)s_conn_handle, (int)s_snap_bin_notify_enabled);
+    return;
+  }
+#if CZECHMATE_COC_ENABLED
+  if (czechmate_coc_is_open()) {
+    czechmate_coc_enqueue_copy(COC_JOB_SNAP_BIN, data, len);
+    return;
+  }
+#endif
+  czechmate_notify_chunked(g_snap_bin_val_handle, 0x53, 0x42, data, len);
+}
+
 #else /* !CONFIG_BT_ENABLED */
 
 void ble_nimble_stack_init(void) {}
 bool ble_task_conn_is_encrypted(void) { return false; }
 bool ble_task_should_push_snapshot(void) { return false; }
+uint32_t ble_task_conn_session(void) { return 0; }
 void ble_task_push_snapshot_json(const uint8_t *data, size_t len) {
   (void)data;
   (void)len;
 }
+bool ble_task_should_push_snapshot_bin(void) { return false; }
+void ble_task_push_snapshot_bin(const uint8_t *data, size_t len) {
+  (void)data;
+  (void)len;
+}
 void ble_task_push_network_info(void) {}
 
 void ble_task_notify_command_result(esp_err_t err, const char *json_body) {
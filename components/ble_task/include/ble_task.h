@@ -21,15 +21,32 @@ bool ble_task_conn_is_encrypted(void);
 /**
  * True, pokud je BLE link aktivní a centrál má zapnuté notify na snapshot CCC.
  * Jinak je push snapshot no-op — web server nemusí každé 3 s skládat JSON jen „do prázdna“.
+ * Během BLE OTA false, pokud snapshoty nejdou přes L2CAP CoC kanál.
  */
 bool ble_task_should_push_snapshot(void);
 
+/**
+ * Id aktuálního BLE spojení (roste s každým CONNECT), 0 = nepřipojeno.
+ * Web server podle něj pozná, že delta báze patří předchozímu centrálu.
+ */
+uint32_t ble_task_conn_session(void);
+
 /**
  * Odešle JSON snapshot připojenému centrálu (chunkovaně, hlavička CM).
- * Bez CONFIG_BT_ENABLED nebo bez BLE spojení je no-op.
+ * Při otevřeném L2CAP CoC kanálu (PSM 0x0080) jde kopie přes něj bez limitu
+ * 255 dílů, jinak GATT notify. Bez CONFIG_BT_ENABLED nebo bez spojení no-op.
  */
 void ble_task_push_snapshot_json(const uint8_t *data, size_t len);
 
+/** True, pokud centrál odebírá notify na binární snapshot (A0B40006). */
+bool ble_task_should_push_snapshot_bin(void);
+
+/**
+ * Odešle binární snapshot (snapshot_bin.h) na A0B40006 — hlavička SB part/total,
+ * při MTU 247 typicky jediný díl (nebo SDU `SB` přes CoC). Bez spojení / notify no-op.
+ */
+void ble_task_push_snapshot_bin(const uint8_t *data, size_t len);
+
 /**
  * Odešle network info (IP, SSID, online status) připojenému centrálu.
  * Volat při změně IP adresy nebo WiFi statusu.
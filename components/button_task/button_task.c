@@ -24,14 +24,12 @@
  * - 1 reset tlacitko: GPIO15 (dedicated pin)
  * - 9 LED indikaci: LED indexy 64-72 (WS2812B)
  *
- * HLAVNI SMYCKA (5ms cyklus):
- * while (1) {
- *     1. Scan all button GPIO
- *     2. Debounce (50ms stability required)
- *     3. Detect events (press/release/long/double)
- *     4. Send events to button_event_queue
- *     5. Wait 5ms
- * }
+ * BUTTON JOB (service task, svc_loop.h — vlastni task uz nema):
+ *     1. Zpracuje button_command_queue
+ *     2. Detect events (press/release/long/double)
+ *     3. Send events to button_event_queue
+ *     4. Dalsi beh: termin dlouheho stisku, jinak za 100ms;
+ *        simulovany stisk/uvolneni job probudi hned
  *
  * DEBOUNCING:
  * - Tlacitko musi byt stabilni 50ms
@@ -76,7 +74,7 @@
  * Sekce 1:  Button Scanning ..................... radek 136
  * Sekce 2:  Event Processing ..................... radek 260
  * Sekce 3:  LED Feedback ......................... radek 391
- * Sekce 4:  Main Button Task ..................... radek 509
+ * Sekce 4:  Button Job ........................... konec souboru
  *
  * =============================================================================
  *
@@ -85,9 +83,8 @@
  * @date 2025-12-23
  *
  * @note
- * - Task priorita: 5 (vyssi nez game - realtime input)
- * - Stack size: 3KB
- * - Scan interval: 5ms
+ * - Bezi jako job v service tasku (SVC_TASK_PRIORITY, bez vlastniho stacku)
+ * - Bez stisku se budi jen kazdych 100ms (fronta prikazu)
  * - Debounce: 50ms
  * - Button count: 9 (4 physical + 1 reset + 4 virtual LED)
  *
@@ -99,7 +96,6 @@
 #include "driver/gpio.h"
 #include "esp_log.h"
 #include "esp_system.h"
-#include "esp_task_wdt.h"
 #include "esp_timer.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/queue.h"
@@ -108,6 +104,7 @@
 #include "freertos/timers.h"
 #include "freertos_chess.h"
 #include "led_task_simple.h"
+#include "svc_loop.h"
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
@@ -116,38 +113,6 @@
 
 static const char *TAG = "BUTTON_TASK";
 
-// ============================================================================
-// WDT WRAPPER FUNCTIONS
-// ============================================================================
-
-/**
- * @brief Bezpecny reset WDT s logovanim WARNING misto ERROR pro
- * ESP_ERR_NOT_FOUND
- *
- * @return ESP_OK pokud uspesne, ESP_ERR_NOT_FOUND pokud task neni registrovany
- * (WARNING pouze)
- *
- * @details
- * Funkce je pouzivana pro bezpecny reset watchdog timeru behem button operaci.
- * Zabranuje chybam pri startupu kdy task jeste neni registrovany.
- */
-static esp_err_t button_task_wdt_reset_safe(void) {
-  esp_err_t ret = esp_task_wdt_reset();
-
-  if (ret == ESP_ERR_NOT_FOUND) {
-    // Logovat jako WARNING misto ERROR - task jeste neni registrovany
-    ESP_LOGW(
-        TAG,
-        "WDT reset: task not registered yet (this is normal during startup)");
-    return ESP_OK; // Povazovat za uspech pro nase ucely
-  } else if (ret != ESP_OK) {
-    ESP_LOGE(TAG, "WDT reset failed: %s", esp_err_to_name(ret));
-    return ret;
-  }
-
-  return ESP_OK;
-}
-
 // ============================================================================
 // LOKALNI PROMENNE A KONSTANTY
 // ============================================================================
@@ -156,6 +121,7 @@ static esp_err_t button_task_wdt_reset_safe(void) {
 #define BUTTON_DEBOUNCE_MS 50      // Cas debounce
 #define BUTTON_LONG_PRESS_MS 1000  // Prah dlouheho stisku
 #define BUTTON_DOUBLE_PRESS_MS 300 // Okno pro dvojity stisk
+#define BUTTON_CMD_POLL_MS 100     // Kontrola button_command_queue bez stisku
 
 // Sledovani stavu tlacitek
 static bool button_states[CHESS_BUTTON_COUNT] = {
@@ -170,8 +136,9 @@ static uint8_t button_press_count[CHESS_BUTTON_COUNT] = {
 static bool button_long_press_sent[CHESS_BUTTON_COUNT] = {
     false}; // Udalost dlouheho stisku odeslana
 
-// Stav tasku
+// Stav jobu
 static bool task_running = false;
+static svc_job_t s_button_job = 0;
 static bool simulation_mode = false; // Zmeneno na false pro realny hardware
 
 // Nazvy tlacitek pro logovani
@@ -308,6 +275,9 @@ void button_simulate_press(uint8_t button_id) {
 
   // Update button LED feedback
   button_update_led_feedback(button_id, true);
+
+  // Termin dlouheho stisku pocita button job
+  svc_job_wake(s_button_job);
 }
 
 void button_simulate_release(uint8_t button_id) {
@@ -338,6 +308,8 @@ void button_simulate_release(uint8_t button_id) {
 
   // Check for double press
   button_check_double_press(button_id);
+
+  svc_job_wake(s_button_job);
 }
 
 // ============================================================================
@@ -576,67 +548,51 @@ void button_test_all(void) {
 }
 
 // ============================================================================
-// MAIN TASK FUNCTION
+// BUTTON JOB
 // ============================================================================
 
-void button_task_start(void *pvParameters) {
-  ESP_LOGI(TAG, "Button task started successfully");
-
-  // CRITICAL: Register with TWDT from within task
-  esp_err_t wdt_ret = esp_task_wdt_add(NULL);
-  if (wdt_ret != ESP_OK && wdt_ret != ESP_ERR_INVALID_ARG) {
-    ESP_LOGE(TAG, "Failed to register Button task with TWDT: %s",
-             esp_err_to_name(wdt_ret));
-  } else {
-    ESP_LOGI(TAG, "✅ Button task registered with TWDT");
+/**
+ * @brief Krok button jobu (service task, svc_loop.h)
+ *
+ * Prikazy a zmeny stavu zpracuje hned; dalsi beh naplanuje na nejblizsi
+ * termin dlouheho stisku, jinak za BUTTON_CMD_POLL_MS (fronta prikazu).
+ * Simulovany stisk/uvolneni job probudi (svc_job_wake).
+ */
+static uint32_t button_job_step(void *ctx) {
+  (void)ctx;
+  static uint32_t run_count = 0;
+
+  // Watchdog log kazdych 1000 behu
+  if (run_count % 1000 == 0) {
+    ESP_LOGI(TAG, "Button job: runs=%" PRIu32 ", heap=%" PRIu32, run_count,
+             esp_get_free_heap_size());
   }
+  run_count++;
 
-  ESP_LOGI(TAG, "Features:");
-  ESP_LOGI(TAG, "  • 9 button handling (promotion + reset)");
-  ESP_LOGI(TAG, "  • Button debouncing and event detection");
-  ESP_LOGI(TAG, "  • LED feedback for button states");
-  ESP_LOGI(TAG, "  • Long press and double press detection");
-  ESP_LOGI(TAG, "  • Simulation mode (no HW required)");
-  ESP_LOGI(TAG, "  • 5ms scan cycle");
+  button_process_commands();
+  button_process_events();
 
-  task_running = true;
-
-  // Initialize button states
-  button_reset_all();
-
-  // Main task loop
-  uint32_t loop_count = 0;
-  TickType_t last_wake_time = xTaskGetTickCount();
-
-  for (;;) {
-    // CRITICAL: Reset watchdog for button task in every iteration
-    esp_err_t wdt_ret = button_task_wdt_reset_safe();
-    if (wdt_ret != ESP_OK && wdt_ret != ESP_ERR_NOT_FOUND) {
-      // Task not registered with TWDT yet - this is normal during startup
-    }
-
-    // Watchdog logging every 1000 iterations (5 seconds)
-    if (loop_count % 1000 == 0) {
-      ESP_LOGI(TAG, "Button Task Watchdog: loop=%" PRIu32 ", heap=%" PRIu32,
-               loop_count, esp_get_free_heap_size());
+  uint32_t next_ms = BUTTON_CMD_POLL_MS;
+  uint32_t now = esp_timer_get_time() / 1000;
+  for (int i = 0; i < CHESS_BUTTON_COUNT; i++) {
+    if (button_states[i] && !button_long_press_sent[i]) {
+      uint32_t held = now - button_press_time[i];
+      uint32_t left = (held < BUTTON_LONG_PRESS_MS)
+                          ? BUTTON_LONG_PRESS_MS - held
+                          : 0;
+      if (left < next_ms) {
+        next_ms = left;
+      }
     }
+  }
+  return next_ms;
+}
 
-    // Process button commands
-    button_process_commands();
-
-    // Button scanning is now handled by FreeRTOS timer
-    // This task only processes commands and events
-    button_process_events();
+esp_err_t button_task_register_job(void) {
+  ESP_LOGI(TAG, "Button job: promotion + reset, debounce, long/double press");
 
-    // Periodic status update - reduced frequency for cleaner UART
-    if (loop_count % 100000 == 0) { // Every 100000 loops (500 seconds)
-      ESP_LOGI(TAG, "Button Task Status: loop=%" PRIu32 ", simulation_button=%d",
-               loop_count, current_simulation_button);
-    }
-
-    loop_count++;
+  task_running = true;
+  button_reset_all();
 
-    // Wait for next cycle (5ms)
-    vTaskDelayUntil(&last_wake_time, pdMS_TO_TICKS(5));
-  }
+  return svc_job_register("button", button_job_step, NULL, 0, &s_button_job);
 }
@@ -56,14 +56,14 @@ typedef enum {
 
 
 /**
- * @brief Spusti button task
+ * @brief Zaregistruje button job v service tasku (svc_loop.h)
  * 
- * Hlavni funkce button tasku. Bezi v nekonecne smycce a zpracovava
- * tlacitka kazdych 5ms. Provadi debouncing a generuje udalosti.
+ * Nahrazuje drivejsi button task: vynuluje stav tlacitek a job pak
+ * zpracovava prikazy a udalosti (vcetne dlouheho stisku) podle terminu.
  * 
- * @param pvParameters Parametry tasku (nepouzivane)
+ * @return ESP_OK, jinak chyba svc_job_register
  */
-void button_task_start(void *pvParameters);
+esp_err_t button_task_register_job(void);
 
 
 // ============================================================================
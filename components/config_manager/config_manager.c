@@ -19,11 +19,12 @@
  */
 
 #include "config_manager.h"
+#include "config_persist.h"
+#include "config_registry.h"
 #include "esp_log.h"
 #include "esp_system.h"
 #include "nvs.h"
 #include "nvs_flash.h"
-#include <stdio.h>
 #include <string.h>
 
 static const char *TAG = "CONFIG_MANAGER";
@@ -285,10 +286,14 @@ esp_err_t config_apply_settings(const system_config_t *config) {
 esp_err_t config_reset_to_defaults(void) {
   ESP_LOGI(TAG, "Resetting configuration to defaults...");
 
-  system_config_t config = default_config;
-  esp_err_t ret = config_save_to_nvs(&config);
+  config_snapshot_t values = {.system = default_config};
+  config_persist_future_t saved;
+  esp_err_t ret = config_registry_set(CONFIG_FIELDS_SYSTEM, &values, &saved);
   if (ret == ESP_OK) {
-    ret = config_apply_settings(&config);
+    ret = config_persist_wait(&saved, 2000);
+  }
+  if (ret == ESP_OK) {
+    ret = config_apply_settings(&default_config);
   }
 
   return ret;
@@ -378,7 +383,12 @@ esp_err_t config_save_ui_prefs_json(const char *json, size_t len) {
   if (end <= i || json[end - 1] != '}') {
     return ESP_ERR_INVALID_ARG;
   }
-  return config_save_blob_to_nvs(CONFIG_NVS_KEY_UI_PREFS, json + i, end - i);
+  esp_err_t ret = config_persist_blob(CONFIG_NVS_KEY_UI_PREFS, json + i,
+                                      end - i, CONFIG_PERSIST_PRIO_LOW, NULL);
+  if (ret == ESP_OK) {
+    config_registry_set_ui_prefs(json + i, end - i);
+  }
+  return ret;
 }
 
 esp_err_t config_load_ui_prefs_json(char *out_buf, size_t out_buf_size,
@@ -387,7 +397,13 @@ esp_err_t config_load_ui_prefs_json(char *out_buf, size_t out_buf_size,
     return ESP_ERR_INVALID_ARG;
   }
   size_t len = out_buf_size - 1;
-  esp_err_t ret = config_load_blob_from_nvs(CONFIG_NVS_KEY_UI_PREFS, out_buf, &len);
+  /* Ulozeni mohlo jeste nedobehnout (persist fronta) — novejsi data maji prednost. */
+  esp_err_t ret = config_persist_read_pending(CONFIG_NVS_KEY_UI_PREFS, out_buf,
+                                              len, &len);
+  if (ret != ESP_OK) {
+    len = out_buf_size - 1;
+    ret = config_load_blob_from_nvs(CONFIG_NVS_KEY_UI_PREFS, out_buf, &len);
+  }
   if (ret != ESP_OK) {
     *out_len = 0;
     out_buf[0] = '\0';
@@ -399,34 +415,5 @@ esp_err_t config_load_ui_prefs_json(char *out_buf, size_t out_buf_size,
 }
 
 int config_ui_prefs_get_chess_hint_limit(void) {
-  char buf[CONFIG_UI_PREFS_MAX_BYTES + 1];
-  size_t len = 0;
-  esp_err_t err = config_load_ui_prefs_json(buf, sizeof(buf), &len);
-  if (err != ESP_OK || len == 0) {
-    return 0;
-  }
-  buf[len] = '\0';
-  const char *p = strstr(buf, "\"chessHintLimit\"");
-  if (p == NULL) {
-    return 0;
-  }
-  p = strchr(p, ':');
-  if (p == NULL) {
-    return 0;
-  }
-  p++;
-  while (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n') {
-    p++;
-  }
-  int v = 0;
-  if (sscanf(p, "%d", &v) != 1) {
-    return 0;
-  }
-  if (v < 0) {
-    v = 0;
-  }
-  if (v > 99) {
-    v = 99;
-  }
-  return v;
+  return config_get_chess_hint_limit();
 }
@@ -0,0 +1,392 @@
+/**
+ * @file config_persist.c
+ * @brief Persist task: sloty pozadavku podle klice, coalescing a future
+ *
+ * Sloty jsou pevne pole chranene mutexem (kopie dat se alokuje mimo zamek).
+ * Task vybira mezi sloty, kterym uplynulo okno, ten s nejvyssi prioritou a
+ * nejnizsim seq. Slot, ktery se prave zapisuje, je `running` — novy pozadavek
+ * se stejnym klicem dostane vlastni slot a zapise se az po nem.
+ */
+
+#include "config_persist.h"
+#include "config_manager.h"
+
+#include "esp_log.h"
+#include "freertos/task.h"
+#include <stdlib.h>
+#include <string.h>
+
+static const char *TAG = "CONFIG_PERSIST";
+
+#define CONFIG_PERSIST_SYSTEM_KEY "chess_config"
+
+typedef struct {
+  bool used;
+  bool running;
+  uint8_t prio;
+  char key[CONFIG_PERSIST_KEY_MAX];
+  config_persist_write_fn fn;
+  void *data;
+  size_t len;
+  uint32_t seq;
+  TickType_t due;
+  config_persist_future_t *waiters;
+} persist_slot_t;
+
+static persist_slot_t s_slots[CONFIG_PERSIST_SLOTS];
+static SemaphoreHandle_t s_lock;
+static TaskHandle_t s_task;
+static uint32_t s_seq;
+static volatile uint32_t s_flush_requests;
+
+static TickType_t persist_window_ticks(config_persist_prio_t prio) {
+  switch (prio) {
+  case CONFIG_PERSIST_PRIO_HIGH:
+    return pdMS_TO_TICKS(CONFIG_PERSIST_WINDOW_HIGH_MS);
+  case CONFIG_PERSIST_PRIO_NORMAL:
+    return pdMS_TO_TICKS(CONFIG_PERSIST_WINDOW_NORMAL_MS);
+  default:
+    return pdMS_TO_TICKS(CONFIG_PERSIST_WINDOW_LOW_MS);
+  }
+}
+
+static void persist_future_init(config_persist_future_t *f) {
+  f->sem = xSemaphoreCreateBinaryStatic(&f->sem_buf);
+  f->result = ESP_ERR_TIMEOUT;
+  f->next = NULL;
+}
+
+/** Dokonci seznam future; `next` cist pred Give (future muze hned zaniknout). */
+static void persist_complete(config_persist_future_t *list, esp_err_t result) {
+  while (list != NULL) {
+    config_persist_future_t *next = list->next;
+    list->result = result;
+    list->next = NULL;
+    xSemaphoreGive(list->sem);
+    list = next;
+  }
+}
+
+/** Vybere dalsi slot k zapisu; jinak vrati -1 a ticky do nejblizsiho okna. */
+static int persist_pick(TickType_t now, TickType_t *wait_out) {
+  int best = -1;
+  TickType_t wait = portMAX_DELAY;
+  bool flush = (s_flush_requests > 0);
+  for (int i = 0; i < CONFIG_PERSIST_SLOTS; i++) {
+    const persist_slot_t *s = &s_slots[i];
+    if (!s->used || s->running) {
+      continue;
+    }
+    int32_t left = (int32_t)(s->due - now);
+    if (!flush && left > 0) {
+      if ((TickType_t)left < wait) {
+        wait = (TickType_t)left;
+      }
+      continue;
+    }
+    if (best < 0 || s->prio > s_slots[best].prio ||
+        (s->prio == s_slots[best].prio &&
+         (int32_t)(s->seq - s_slots[best].seq) < 0)) {
+      best = i;
+    }
+  }
+  *wait_out = wait;
+  return best;
+}
+
+static void config_persist_task(void *arg) {
+  (void)arg;
+  for (;;) {
+    TickType_t wait = portMAX_DELAY;
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    int idx = persist_pick(xTaskGetTickCount(), &wait);
+    persist_slot_t job = {0};
+    if (idx >= 0) {
+      s_slots[idx].running = true;
+      job = s_slots[idx];
+    }
+    xSemaphoreGive(s_lock);
+
+    if (idx < 0) {
+      ulTaskNotifyTake(pdTRUE, wait);
+      continue;
+    }
+
+    esp_err_t ret = job.fn(job.key, job.data, job.len);
+    if (ret != ESP_OK) {
+      ESP_LOGW(TAG, "zapis '%s' selhal: %s", job.key, esp_err_to_name(ret));
+    }
+
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    config_persist_future_t *waiters = s_slots[idx].waiters;
+    memset(&s_slots[idx], 0, sizeof(s_slots[idx]));
+    persist_complete(waiters, ret);
+    xSemaphoreGive(s_lock);
+    free(job.data);
+  }
+}
+
+esp_err_t config_persist_start(void) {
+  if (s_task != NULL) {
+    return ESP_OK;
+  }
+  s_lock = xSemaphoreCreateMutex();
+  if (s_lock == NULL) {
+    return ESP_ERR_NO_MEM;
+  }
+  if (xTaskCreate(config_persist_task, "persist_task", PERSIST_TASK_STACK_SIZE,
+                  NULL, PERSIST_TASK_PRIORITY, &s_task) != pdPASS) {
+    vSemaphoreDelete(s_lock);
+    s_lock = NULL;
+    s_task = NULL;
+    ESP_LOGE(TAG, "Failed to create persist task");
+    return ESP_FAIL;
+  }
+  ESP_LOGI(TAG, "Persist task started (%d slots)", CONFIG_PERSIST_SLOTS);
+  return ESP_OK;
+}
+
+bool config_persist_is_running(void) { return s_task != NULL; }
+
+/**
+ * Zkopiruje data a zaradi je do slotu (nebo slouci se stejnym klicem).
+ * @return ESP_OK, ESP_ERR_NO_MEM (malloc / zadny volny slot)
+ */
+static esp_err_t persist_enqueue(const char *key, config_persist_write_fn fn,
+                                 const void *data, size_t len,
+                                 config_persist_prio_t prio,
+                                 config_persist_future_t *future) {
+  void *copy = NULL;
+  if (len > 0) {
+    copy = malloc(len);
+    if (copy == NULL) {
+      return ESP_ERR_NO_MEM;
+    }
+    memcpy(copy, data, len);
+  }
+
+  void *old = NULL;
+  bool queued = false;
+  xSemaphoreTake(s_lock, portMAX_DELAY);
+  persist_slot_t *slot = NULL;
+  persist_slot_t *free_slot = NULL;
+  for (int i = 0; i < CONFIG_PERSIST_SLOTS; i++) {
+    persist_slot_t *s = &s_slots[i];
+    if (!s->used) {
+      if (free_slot == NULL) {
+        free_slot = s;
+      }
+    } else if (!s->running && strcmp(s->key, key) == 0) {
+      slot = s;
+      break;
+    }
+  }
+  TickType_t due = xTaskGetTickCount() + persist_window_ticks(prio);
+  if (slot != NULL) {
+    /* Coalescing: nova data, konec poradi; okno bezi od prvniho pozadavku. */
+    old = slot->data;
+    if ((int32_t)(due - slot->due) < 0) {
+      slot->due = due;
+    }
+    if (prio > slot->prio) {
+      slot->prio = (uint8_t)prio;
+    }
+  } else if (free_slot != NULL) {
+    slot = free_slot;
+    memset(slot, 0, sizeof(*slot));
+    slot->used = true;
+    strcpy(slot->key, key);
+    slot->prio = (uint8_t)prio;
+    slot->due = due;
+  }
+  if (slot != NULL) {
+    slot->fn = fn;
+    slot->data = copy;
+    slot->len = len;
+    slot->seq = ++s_seq;
+    if (future != NULL) {
+      future->next = slot->waiters;
+      slot->waiters = future;
+    }
+    queued = true;
+  }
+  xSemaphoreGive(s_lock);
+
+  if (!queued) {
+    free(copy);
+    return ESP_ERR_NO_MEM;
+  }
+  free(old);
+  xTaskNotifyGive(s_task);
+  return ESP_OK;
+}
+
+esp_err_t config_persist_submit(const char *key, config_persist_write_fn fn,
+                                const void *data, size_t len,
+                                config_persist_prio_t prio,
+                                config_persist_future_t *future) {
+  if (key == NULL || fn == NULL || (data == NULL && len > 0) ||
+      strlen(key) >= CONFIG_PERSIST_KEY_MAX) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  if (future != NULL) {
+    persist_future_init(future);
+  }
+
+  if (s_task != NULL) {
+    /* Nikdy nezapisovat z volajiciho tasku soubezne s persist taskem (stejny
+     * klic = sdileny stav zapisove funkce, napr. journal snapshotu).
+     * Plna fronta: pockat, az task slot uvolni, pak vzdat. */
+    TickType_t start = xTaskGetTickCount();
+    for (;;) {
+      if (persist_enqueue(key, fn, data, len, prio, future) == ESP_OK) {
+        return ESP_OK;
+      }
+      /* Z persist tasku (zapisova funkce) by cekani slot neuvolnilo. */
+      if (xTaskGetCurrentTaskHandle() == s_task ||
+          (xTaskGetTickCount() - start) >=
+              pdMS_TO_TICKS(CONFIG_PERSIST_SUBMIT_WAIT_MS)) {
+        break;
+      }
+      vTaskDelay(pdMS_TO_TICKS(10));
+    }
+    ESP_LOGW(TAG, "fronta plna — '%s' zahozen", key);
+    if (future != NULL) {
+      persist_complete(future, ESP_ERR_NO_MEM);
+    }
+    return ESP_ERR_NO_MEM;
+  }
+
+  /* Pred startem tasku neni s kym soubezne zapisovat. */
+  esp_err_t ret = fn(key, data, len);
+  if (future != NULL) {
+    persist_complete(future, ret);
+  }
+  return ret;
+}
+
+esp_err_t config_persist_wait(config_persist_future_t *future,
+                              uint32_t timeout_ms) {
+  if (future == NULL || future->sem == NULL) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  if (xSemaphoreTake(future->sem, pdMS_TO_TICKS(timeout_ms)) == pdTRUE) {
+    return future->result;
+  }
+
+  /* Timeout: odpojit future, jinak by ji task po navratu prepsal. */
+  bool detached = false;
+  xSemaphoreTake(s_lock, portMAX_DELAY);
+  for (int i = 0; i < CONFIG_PERSIST_SLOTS && !detached; i++) {
+    config_persist_future_t **pp = &s_slots[i].waiters;
+    while (*pp != NULL) {
+      if (*pp == future) {
+        *pp = future->next;
+        detached = true;
+        break;
+      }
+      pp = &(*pp)->next;
+    }
+  }
+  xSemaphoreGive(s_lock);
+  if (detached) {
+    return ESP_ERR_TIMEOUT;
+  }
+  /* Dokonceno mezi timeoutem a zamkem — Give uz probehl. */
+  xSemaphoreTake(future->sem, 0);
+  return future->result;
+}
+
+esp_err_t config_persist_flush(uint32_t timeout_ms) {
+  if (s_task == NULL) {
+    return ESP_OK;
+  }
+  s_flush_requests++;
+  xTaskNotifyGive(s_task);
+
+  esp_err_t ret = ESP_ERR_TIMEOUT;
+  TickType_t start = xTaskGetTickCount();
+  for (;;) {
+    bool empty = true;
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    for (int i = 0; i < CONFIG_PERSIST_SLOTS; i++) {
+      if (s_slots[i].used) {
+        empty = false;
+        break;
+      }
+    }
+    xSemaphoreGive(s_lock);
+    if (empty) {
+      ret = ESP_OK;
+      break;
+    }
+    if ((xTaskGetTickCount() - start) >= pdMS_TO_TICKS(timeout_ms)) {
+      break;
+    }
+    vTaskDelay(pdMS_TO_TICKS(10));
+  }
+  s_flush_requests--;
+  return ret;
+}
+
+esp_err_t config_persist_read_pending(const char *key, void *out, size_t cap,
+                                     size_t *len_out) {
+  if (key == NULL || s_lock == NULL) {
+    return ESP_ERR_NOT_FOUND;
+  }
+  esp_err_t ret = ESP_ERR_NOT_FOUND;
+  xSemaphoreTake(s_lock, portMAX_DELAY);
+  const persist_slot_t *newest = NULL;
+  for (int i = 0; i < CONFIG_PERSIST_SLOTS; i++) {
+    const persist_slot_t *s = &s_slots[i];
+    if (s->used && strcmp(s->key, key) == 0 &&
+        (newest == NULL || (int32_t)(s->seq - newest->seq) > 0)) {
+      newest = s;
+    }
+  }
+  if (newest != NULL) {
+    if (newest->len > cap) {
+      ret = ESP_ERR_INVALID_SIZE;
+    } else {
+      if (newest->len > 0) {
+        memcpy(out, newest->data, newest->len);
+      }
+      if (len_out != NULL) {
+        *len_out = newest->len;
+      }
+      ret = ESP_OK;
+    }
+  }
+  xSemaphoreGive(s_lock);
+  return ret;
+}
+
+esp_err_t config_persist_blob(const char *key, const void *data, size_t len,
+                              config_persist_prio_t prio,
+                              config_persist_future_t *future) {
+  if (data == NULL || len == 0) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  return config_persist_submit(key, config_save_blob_to_nvs, data, len, prio,
+                               future);
+}
+
+static esp_err_t config_persist_write_system(const char *key, const void *data,
+                                             size_t len) {
+  (void)key;
+  if (len != sizeof(system_config_t)) {
+    return ESP_ERR_INVALID_SIZE;
+  }
+  return config_save_to_nvs((const system_config_t *)data);
+}
+
+esp_err_t config_persist_system_config(const system_config_t *config,
+                                       config_persist_future_t *future) {
+  if (config == NULL) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  return config_persist_submit(CONFIG_PERSIST_SYSTEM_KEY,
+                               config_persist_write_system, config,
+                               sizeof(*config), CONFIG_PERSIST_PRIO_NORMAL,
+                               future);
+}
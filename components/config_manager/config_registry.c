@@ -0,0 +1,391 @@
+/**
+ * @file config_registry.c
+ * @brief Konfigurace v RAM (config_registry.h): dva sloty + verze, zapis pod
+ *        mutexem, do NVS pres persist task
+ *
+ * Slot `version & 1` je publikovany, zapisovatel plni druhy. Ctenar, ktery
+ * kopiroval slot `v & 1`, muze dostat rozepsana data jen kdyz mezitim zacal
+ * zapis verze v + 2 — to uz je ale publikovana v + 1, takze kontrola
+ * `version == v` po kopii takovou kopii vzdy odhali.
+ *
+ * Mutex je rekurzivni: pred startem persist tasku se registry_persist_write
+ * vola synchronne uvnitr config_registry_set. Plna fronta nic nezapise
+ * (ESP_ERR_NO_MEM) — pole zustanou v s_dirty a zapis zopakuje dalsi
+ * config_registry_set nebo job "cfg_retry" v service tasku.
+ */
+
+#include "config_registry.h"
+#include "config_manager.h"
+
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "svc_loop.h"
+#include <stdio.h>
+#include <string.h>
+
+static const char *TAG = "CONFIG_REGISTRY";
+
+/* Stejny klic jako config_persist_system_config — zapisy se slouci. */
+#define CONFIG_REGISTRY_PERSIST_KEY CONFIG_NVS_NAMESPACE
+
+typedef struct {
+  uint32_t mask;
+  config_registry_listener_fn fn;
+  void *ctx;
+} registry_listener_t;
+
+static config_snapshot_t s_slots[2];
+static volatile uint32_t s_version;
+static volatile uint32_t s_dirty;
+static StaticSemaphore_t s_lock_buf;
+static SemaphoreHandle_t s_lock;
+static registry_listener_t s_listeners[CONFIG_REGISTRY_MAX_LISTENERS];
+static uint8_t s_listener_count;
+
+/** chessHintLimit z UI prefs JSON (0-99, 0 = chybi / neomezeno). */
+static uint8_t registry_parse_hint_limit(const char *json) {
+  const char *p = strstr(json, "\"chessHintLimit\"");
+  if (p == NULL) {
+    return 0;
+  }
+  p = strchr(p, ':');
+  if (p == NULL) {
+    return 0;
+  }
+  p++;
+  while (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n') {
+    p++;
+  }
+  int v = 0;
+  if (sscanf(p, "%d", &v) != 1 || v < 0) {
+    return 0;
+  }
+  return (uint8_t)(v > 99 ? 99 : v);
+}
+
+/** LED navadeni 1-5 a guided capture (= uroven 5) drzi spolu. */
+static void registry_normalize(system_config_t *c, uint32_t fields) {
+  if (c->led_guidance_level < 1) {
+    c->led_guidance_level = 1;
+  }
+  if (c->led_guidance_level > 5) {
+    c->led_guidance_level = 5;
+  }
+  if (fields & CONFIG_FIELD_GUIDED_HINTS) {
+    c->led_guidance_level = c->guided_capture_hints_enabled ? 5 : 4;
+  }
+  c->guided_capture_hints_enabled = (c->led_guidance_level >= 5);
+  if (c->brightness_level > 100) {
+    c->brightness_level = 100;
+  }
+}
+
+static uint32_t registry_diff(const config_snapshot_t *a,
+                              const config_snapshot_t *b) {
+  const system_config_t *x = &a->system;
+  const system_config_t *y = &b->system;
+  uint32_t m = 0;
+  m |= (x->verbose_mode != y->verbose_mode) ? CONFIG_FIELD_VERBOSE_MODE : 0;
+  m |= (x->quiet_mode != y->quiet_mode) ? CONFIG_FIELD_QUIET_MODE : 0;
+  m |= (x->guided_capture_hints_enabled != y->guided_capture_hints_enabled)
+           ? CONFIG_FIELD_GUIDED_HINTS
+           : 0;
+  m |= (x->led_guidance_level != y->led_guidance_level)
+           ? CONFIG_FIELD_LED_GUIDANCE
+           : 0;
+  m |= (x->log_level != y->log_level) ? CONFIG_FIELD_LOG_LEVEL : 0;
+  m |= (x->command_timeout_ms != y->command_timeout_ms)
+           ? CONFIG_FIELD_COMMAND_TIMEOUT
+           : 0;
+  m |= (x->brightness_level != y->brightness_level) ? CONFIG_FIELD_BRIGHTNESS
+                                                    : 0;
+  m |= (x->starting_position_check_enabled !=
+        y->starting_position_check_enabled)
+           ? CONFIG_FIELD_START_POS_CHECK
+           : 0;
+  m |= (a->chess_hint_limit != b->chess_hint_limit)
+           ? CONFIG_FIELD_CHESS_HINT_LIMIT
+           : 0;
+  return m;
+}
+
+/**
+ * Persist task: zapis verze `snap`. Dirty se smaze, kdyz publikovana verze ma
+ * stejna pole system_config_t (novejsi verze s jinym jen chessHintLimit
+ * zadny dalsi zapis nezaradi, takze porovnani verzi by dirty nechalo navzdy).
+ */
+static esp_err_t registry_persist_write(const char *key, const void *data,
+                                        size_t len) {
+  (void)key;
+  const config_snapshot_t *snap = (const config_snapshot_t *)data;
+  if (len != sizeof(*snap)) {
+    return ESP_ERR_INVALID_SIZE;
+  }
+  esp_err_t ret = config_save_to_nvs(&snap->system);
+  if (ret == ESP_OK && s_lock != NULL) {
+    xSemaphoreTakeRecursive(s_lock, portMAX_DELAY);
+    if ((registry_diff(&s_slots[s_version & 1], snap) & CONFIG_FIELDS_SYSTEM) ==
+        0) {
+      s_dirty &= ~CONFIG_FIELDS_SYSTEM;
+    }
+    xSemaphoreGiveRecursive(s_lock);
+  }
+  return ret;
+}
+
+esp_err_t config_registry_init(void) {
+  if (s_lock != NULL) {
+    return ESP_OK;
+  }
+  config_snapshot_t snap = {0};
+  esp_err_t ret = config_load_from_nvs(&snap.system);
+  if (ret != ESP_OK) {
+    config_get_defaults(&snap.system);
+  }
+  registry_normalize(&snap.system, 0);
+
+  static char prefs[CONFIG_UI_PREFS_MAX_BYTES + 1];
+  size_t len = 0;
+  if (config_load_ui_prefs_json(prefs, sizeof(prefs), &len) == ESP_OK &&
+      len > 0) {
+    snap.chess_hint_limit = registry_parse_hint_limit(prefs);
+  }
+
+  snap.version = 1;
+  s_slots[1] = snap;
+  s_lock = xSemaphoreCreateRecursiveMutexStatic(&s_lock_buf);
+  __atomic_store_n(&s_version, 1, __ATOMIC_RELEASE);
+  ESP_LOGI(TAG, "config cached: brightness=%u%% guidance=%u hint_limit=%u",
+           (unsigned)snap.system.brightness_level,
+           (unsigned)snap.system.led_guidance_level,
+           (unsigned)snap.chess_hint_limit);
+  return ESP_OK;
+}
+
+uint32_t config_registry_get(config_snapshot_t *out) {
+  for (;;) {
+    uint32_t v = __atomic_load_n(&s_version, __ATOMIC_ACQUIRE);
+    if (v == 0) {
+      memset(out, 0, sizeof(*out));
+      config_get_defaults(&out->system);
+      return 0;
+    }
+    memcpy(out, &s_slots[v & 1], sizeof(*out));
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    if (__atomic_load_n(&s_version, __ATOMIC_RELAXED) == v) {
+      return v;
+    }
+  }
+}
+
+uint32_t config_registry_version(void) {
+  return __atomic_load_n(&s_version, __ATOMIC_ACQUIRE);
+}
+
+uint32_t config_registry_dirty(void) { return s_dirty; }
+
+/** Publikuje `next` (pod s_lock), zaradi zapis a obslouzi posluchace. */
+static esp_err_t registry_publish(config_snapshot_t *next, uint32_t changed,
+                                  config_persist_future_t *future) {
+  next->version = s_version + 1;
+  s_slots[next->version & 1] = *next;
+  __atomic_store_n(&s_version, next->version, __ATOMIC_RELEASE);
+  s_dirty |= changed & CONFIG_FIELDS_SYSTEM;
+
+  /* UI prefs uklada config_save_ui_prefs_json. Dirty z odmitnuteho zapisu
+   * pribere kazda dalsi verze (stejny klic, zapisy se slouci). */
+  esp_err_t ret = ESP_OK;
+  if ((s_dirty & CONFIG_FIELDS_SYSTEM) != 0 || future != NULL) {
+    ret = config_persist_submit(CONFIG_REGISTRY_PERSIST_KEY,
+                                registry_persist_write, next, sizeof(*next),
+                                CONFIG_PERSIST_PRIO_NORMAL, future);
+  }
+
+  /* Pod zamkem: posluchaci vidi verze ve stejnem poradi jako ctenari. */
+  for (uint8_t i = 0; i < s_listener_count; i++) {
+    uint32_t m = changed & s_listeners[i].mask;
+    if (m != 0) {
+      s_listeners[i].fn(m, next, s_listeners[i].ctx);
+    }
+  }
+  return ret;
+}
+
+esp_err_t config_registry_set(uint32_t fields, const config_snapshot_t *values,
+                              config_persist_future_t *future) {
+  if (values == NULL || (fields & ~CONFIG_FIELDS_ALL) != 0) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  if (s_lock == NULL) {
+    config_registry_init();
+  }
+  xSemaphoreTakeRecursive(s_lock, portMAX_DELAY);
+  config_snapshot_t cur = s_slots[s_version & 1];
+  config_snapshot_t next = cur;
+  const system_config_t *v = &values->system;
+  system_config_t *n = &next.system;
+  if (fields & CONFIG_FIELD_VERBOSE_MODE) {
+    n->verbose_mode = v->verbose_mode;
+  }
+  if (fields & CONFIG_FIELD_QUIET_MODE) {
+    n->quiet_mode = v->quiet_mode;
+  }
+  if (fields & CONFIG_FIELD_GUIDED_HINTS) {
+    n->guided_capture_hints_enabled = v->guided_capture_hints_enabled;
+  }
+  if (fields & CONFIG_FIELD_LED_GUIDANCE) {
+    n->led_guidance_level = v->led_guidance_level;
+  }
+  if (fields & CONFIG_FIELD_LOG_LEVEL) {
+    n->log_level = v->log_level;
+  }
+  if (fields & CONFIG_FIELD_COMMAND_TIMEOUT) {
+    n->command_timeout_ms = v->command_timeout_ms;
+  }
+  if (fields & CONFIG_FIELD_BRIGHTNESS) {
+    n->brightness_level = v->brightness_level;
+  }
+  if (fields & CONFIG_FIELD_START_POS_CHECK) {
+    n->starting_position_check_enabled = v->starting_position_check_enabled;
+  }
+  if (fields & CONFIG_FIELD_CHESS_HINT_LIMIT) {
+    next.chess_hint_limit =
+        values->chess_hint_limit > 99 ? 99 : values->chess_hint_limit;
+  }
+  registry_normalize(n, fields);
+
+  esp_err_t ret = ESP_OK;
+  uint32_t changed = registry_diff(&cur, &next);
+  if (changed != 0) {
+    ret = registry_publish(&next, changed, future);
+  } else if (future != NULL) {
+    /* Beze zmeny: future dokonci zapis stavajici verze (vysledek NVS). */
+    ret = config_persist_submit(CONFIG_REGISTRY_PERSIST_KEY,
+                                registry_persist_write, &cur, sizeof(cur),
+                                CONFIG_PERSIST_PRIO_NORMAL, future);
+  }
+  xSemaphoreGiveRecursive(s_lock);
+  return ret;
+}
+
+/** Service job: zopakuje zapis, ktery plna fronta nebo chyba NVS zahodila. */
+static uint32_t registry_retry_step(void *ctx) {
+  (void)ctx;
+  if ((s_dirty & CONFIG_FIELDS_SYSTEM) == 0 || !config_persist_is_running()) {
+    return CONFIG_REGISTRY_RETRY_MS;
+  }
+  xSemaphoreTakeRecursive(s_lock, portMAX_DELAY);
+  config_snapshot_t cur = s_slots[s_version & 1];
+  esp_err_t ret = config_persist_submit(CONFIG_REGISTRY_PERSIST_KEY,
+                                        registry_persist_write, &cur,
+                                        sizeof(cur), CONFIG_PERSIST_PRIO_NORMAL,
+                                        NULL);
+  xSemaphoreGiveRecursive(s_lock);
+  if (ret != ESP_OK) {
+    ESP_LOGW(TAG, "retry of dirty fields 0x%02lx failed: %s",
+             (unsigned long)(s_dirty & CONFIG_FIELDS_SYSTEM),
+             esp_err_to_name(ret));
+  }
+  return CONFIG_REGISTRY_RETRY_MS;
+}
+
+esp_err_t config_registry_register_job(void) {
+  if (s_lock == NULL) {
+    config_registry_init();
+  }
+  return svc_job_register("cfg_retry", registry_retry_step, NULL,
+                          CONFIG_REGISTRY_RETRY_MS, NULL);
+}
+
+esp_err_t config_registry_subscribe(uint32_t mask,
+                                    config_registry_listener_fn fn, void *ctx) {
+  if (fn == NULL || mask == 0) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  if (s_lock == NULL) {
+    config_registry_init();
+  }
+  esp_err_t ret = ESP_ERR_NO_MEM;
+  xSemaphoreTakeRecursive(s_lock, portMAX_DELAY);
+  if (s_listener_count < CONFIG_REGISTRY_MAX_LISTENERS) {
+    s_listeners[s_listener_count++] =
+        (registry_listener_t){.mask = mask, .fn = fn, .ctx = ctx};
+    ret = ESP_OK;
+  }
+  xSemaphoreGiveRecursive(s_lock);
+  return ret;
+}
+
+void config_registry_set_ui_prefs(const char *json, size_t len) {
+  (void)len;
+  config_snapshot_t v = {0};
+  v.chess_hint_limit = registry_parse_hint_limit(json);
+  config_registry_set(CONFIG_FIELD_CHESS_HINT_LIMIT, &v, NULL);
+}
+
+bool config_get_verbose_mode(void) {
+  config_snapshot_t s;
+  config_registry_get(&s);
+  return s.system.verbose_mode;
+}
+
+bool config_get_quiet_mode(void) {
+  config_snapshot_t s;
+  config_registry_get(&s);
+  return s.system.quiet_mode;
+}
+
+bool config_get_guided_capture_hints(void) {
+  config_snapshot_t s;
+  config_registry_get(&s);
+  return s.system.guided_capture_hints_enabled;
+}
+
+uint8_t config_get_led_guidance_level(void) {
+  config_snapshot_t s;
+  config_registry_get(&s);
+  return s.system.led_guidance_level;
+}
+
+uint8_t config_get_brightness(void) {
+  config_snapshot_t s;
+  config_registry_get(&s);
+  return s.system.brightness_level;
+}
+
+bool config_get_starting_position_check(void) {
+  config_snapshot_t s;
+  config_registry_get(&s);
+  return s.system.starting_position_check_enabled;
+}
+
+int config_get_chess_hint_limit(void) {
+  config_snapshot_t s;
+  config_registry_get(&s);
+  return s.chess_hint_limit;
+}
+
+esp_err_t config_set_brightness(uint8_t percent) {
+  config_snapshot_t v = {0};
+  v.system.brightness_level = percent;
+  return config_registry_set(CONFIG_FIELD_BRIGHTNESS, &v, NULL);
+}
+
+esp_err_t config_set_led_guidance_level(uint8_t level) {
+  config_snapshot_t v = {0};
+  v.system.led_guidance_level = level;
+  return config_registry_set(CONFIG_FIELD_LED_GUIDANCE, &v, NULL);
+}
+
+esp_err_t config_set_guided_capture_hints(bool enabled) {
+  config_snapshot_t v = {0};
+  v.system.guided_capture_hints_enabled = enabled;
+  return config_registry_set(CONFIG_FIELD_GUIDED_HINTS, &v, NULL);
+}
+
+esp_err_t config_set_starting_position_check(bool enabled) {
+  config_snapshot_t v = {0};
+  v.system.starting_position_check_enabled = enabled;
+  return config_registry_set(CONFIG_FIELD_START_POS_CHECK, &v, NULL);
+}
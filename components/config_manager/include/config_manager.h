@@ -65,7 +65,11 @@ esp_err_t config_manager_init(void);
  */
 esp_err_t config_reset_to_defaults(void);
 
-// config_get_defaults deklarovan v chess_types.h
+/**
+ * @brief Zkopiruje vychozi konfiguraci (bez NVS)
+ * @return ESP_OK, ESP_ERR_INVALID_ARG pri NULL
+ */
+esp_err_t config_get_defaults(system_config_t *config);
 
 // ============================================================================
 // KONSTANTY
@@ -102,8 +106,11 @@ esp_err_t config_reset_to_defaults(void);
 #define CONFIG_NVS_KEY_BRIGHTNESS "brightness"
 /** @brief NVS klic pro guided capture LED napovedu */
 #define CONFIG_NVS_KEY_GUIDED_HINT "guided_hint"
-/** @brief NVS klic pro plny snapshot hry */
+/** @brief Klic persist fronty snapshotu; v NVS jen plny snapshot verze 1 (maze se) */
 #define CONFIG_NVS_KEY_GAME_SNAPSHOT_FULL "g_snap_full"
+/** @brief NVS klice A/B slotu plneho snapshotu hry */
+#define CONFIG_NVS_KEY_GAME_SNAPSHOT_A "g_snap_a"
+#define CONFIG_NVS_KEY_GAME_SNAPSHOT_B "g_snap_b"
 /** @brief NVS klic pro fallback snapshot hry */
 #define CONFIG_NVS_KEY_GAME_SNAPSHOT_MIN "g_snap_min"
 /** @brief NVS klic pro boot tracker */
@@ -122,6 +129,9 @@ esp_err_t config_save_blob_to_nvs(const char *key, const void *data, size_t len)
 
 /**
  * @brief Ulozi web UI JSON do NVS (jednoducha validace tvaru).
+ *
+ * Zapis na pozadi (config_persist.h); config_load_ui_prefs_json vraci i jeste
+ * nezapsana data.
  */
 esp_err_t config_save_ui_prefs_json(const char *json, size_t len);
 
@@ -133,6 +143,8 @@ esp_err_t config_load_ui_prefs_json(char *out_buf, size_t out_buf_size,
 
 /**
  * @brief Vrátí chessHintLimit z uloženého UI prefs JSON (0–99, 0 = neomezeno / chybí klíč).
+ *
+ * Hodnota z config_registry (parsuje se jen při bootu a při uložení prefs).
  */
 int config_ui_prefs_get_chess_hint_limit(void);
 
@@ -0,0 +1,135 @@
+/**
+ * @file config_persist.h
+ * @brief Persistence na pozadi: fronta zapisu do NVS / flash mimo volajici task
+ *
+ * game_task, httpd workery, UART ani lampa uz na erase/program cyklus flash
+ * necekaji — predaji kopii dat a zapisovou funkci, zapis udela persist task.
+ *
+ * - Coalescing: pozadavky se stejnym klicem, ktere jeste cekaji, se slouci;
+ *   zapise se jen posledni data (okno podle priority, viz CONFIG_PERSIST_WINDOW_*).
+ *   Slouceny pozadavek se zaradi za pozdejsi pozadavky stejne priority, takze
+ *   poradi ruznych klicu zustane podle posledniho odeslani.
+ * - Poradi: nejdriv vyssi priorita, v ramci priority FIFO.
+ * - Future: volajici muze predat config_persist_future_t a pockat na vysledek
+ *   (config_persist_wait), nebo predat NULL (fire-and-forget).
+ *
+ * Pred startem tasku se zapisuje synchronne jako drive. Po startu zapisuje
+ * vyhradne persist task — kdyz dojdou sloty (nebo pamet na kopii), submit
+ * ceka max CONFIG_PERSIST_SUBMIT_WAIT_MS a pak vrati ESP_ERR_NO_MEM.
+ */
+
+#ifndef CONFIG_PERSIST_H
+#define CONFIG_PERSIST_H
+
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos_chess.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Max delka klice pro coalescing (vcetne \0, jako NVS klic) */
+#define CONFIG_PERSIST_KEY_MAX 16
+/** @brief Pocet soucasne cekajicich pozadavku (ruznych klicu) */
+#define CONFIG_PERSIST_SLOTS 12
+
+/** @brief Jak dlouho submit ceka na volny slot, nez vrati ESP_ERR_NO_MEM */
+#define CONFIG_PERSIST_SUBMIT_WAIT_MS 200
+
+/** @brief Okno slucovani pro CONFIG_PERSIST_PRIO_LOW (slider jasu, barva lampy) */
+#define CONFIG_PERSIST_WINDOW_LOW_MS 1000
+/** @brief Okno slucovani pro CONFIG_PERSIST_PRIO_NORMAL (nastaveni) */
+#define CONFIG_PERSIST_WINDOW_NORMAL_MS 250
+/** @brief Okno slucovani pro CONFIG_PERSIST_PRIO_HIGH (herni stav — hned) */
+#define CONFIG_PERSIST_WINDOW_HIGH_MS 0
+
+typedef enum {
+  CONFIG_PERSIST_PRIO_LOW = 0, ///< UI preference, lampa
+  CONFIG_PERSIST_PRIO_NORMAL,  ///< Systemova nastaveni, timer, web lock
+  CONFIG_PERSIST_PRIO_HIGH,    ///< Snapshot hry
+} config_persist_prio_t;
+
+/**
+ * @brief Zapisova funkce volana v persist tasku
+ * @param key  Klic pozadavku (pro blob primo NVS klic)
+ * @param data Kopie dat z config_persist_submit (NULL pri len 0)
+ */
+typedef esp_err_t (*config_persist_write_fn)(const char *key, const void *data,
+                                             size_t len);
+
+/**
+ * @brief Vysledek zapisu; vlastni ho volajici (typicky na stacku)
+ *
+ * Po config_persist_submit s future je nutne zavolat config_persist_wait
+ * (i s timeoutem 0) — do te doby future nesmi zaniknout.
+ */
+typedef struct config_persist_future {
+  StaticSemaphore_t sem_buf;
+  SemaphoreHandle_t sem;
+  esp_err_t result;
+  struct config_persist_future *next; ///< Interni: seznam cekajicich na slot
+} config_persist_future_t;
+
+/** @brief Spusti persist task (jednou, pred tasky ktere ukladaji) */
+esp_err_t config_persist_start(void);
+
+/** @brief Bezi persist task? (jinak se zapisuje synchronne) */
+bool config_persist_is_running(void);
+
+/**
+ * @brief Zaradi zapis do fronty
+ *
+ * Data se zkopiruji, volajici je muze hned zahodit.
+ * @param future Volitelne (NULL = bez cekani)
+ * @return ESP_OK zarazeno (pred startem tasku: synchronni zapis uspel),
+ *         ESP_ERR_NO_MEM fronta plna i po CONFIG_PERSIST_SUBMIT_WAIT_MS
+ *         (future je dokoncena s touto chybou), jinak chyba zapisu
+ */
+esp_err_t config_persist_submit(const char *key, config_persist_write_fn fn,
+                                const void *data, size_t len,
+                                config_persist_prio_t prio,
+                                config_persist_future_t *future);
+
+/**
+ * @brief Pocka na dokonceni zapisu
+ * @return vysledek zapisove funkce, ESP_ERR_TIMEOUT (future je odpojena,
+ *         zapis probehne bez ni)
+ */
+esp_err_t config_persist_wait(config_persist_future_t *future,
+                              uint32_t timeout_ms);
+
+/**
+ * @brief Zapise vse cekajici bez ohledu na okno a pocka (pred restartem / OTA)
+ * @return ESP_OK fronta prazdna, ESP_ERR_TIMEOUT
+ */
+esp_err_t config_persist_flush(uint32_t timeout_ms);
+
+/**
+ * @brief Data posledniho jeste nezapsaneho pozadavku pro klic (read-your-writes)
+ *
+ * Cteni, ktere by jinak z NVS dostalo starsi hodnotu, se nejdriv zepta sem.
+ * @return ESP_OK zkopirovano, ESP_ERR_NOT_FOUND nic neceka,
+ *         ESP_ERR_INVALID_SIZE `cap` nestaci
+ */
+esp_err_t config_persist_read_pending(const char *key, void *out, size_t cap,
+                                     size_t *len_out);
+
+/** @brief Blob do namespace chess_config na pozadi (config_save_blob_to_nvs) */
+esp_err_t config_persist_blob(const char *key, const void *data, size_t len,
+                              config_persist_prio_t prio,
+                              config_persist_future_t *future);
+
+/** @brief config_save_to_nvs na pozadi; opakovane ulozeni se slouci */
+esp_err_t config_persist_system_config(const system_config_t *config,
+                                       config_persist_future_t *future);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CONFIG_PERSIST_H
@@ -0,0 +1,142 @@
+/**
+ * @file config_registry.h
+ * @brief Typovana konfigurace v RAM: jednou nactena pri bootu, cteni bez zamku
+ *
+ * Registry drzi system_config_t z NVS a hodnoty vytazene z UI prefs JSON
+ * (chessHintLimit), takze jas, limit napoved ani LED navadeni uz na horke
+ * ceste (GET /api/status, game task, LED task) neotevira NVS a neparsuje JSON.
+ *
+ * - Cteni: dva sloty, zapisovatel plni neaktivni a pak prepne `version`.
+ *   Ctenar kopii zopakuje jen kdyz mezitim dobehl zapis — na zapisovatele
+ *   nikdy neceka (zadny zamek ani spin na rozepsany slot).
+ * - Zapis: config_registry_set s maskou poli; read-modify-write pod mutexem,
+ *   takze soubezne zmeny ruznych poli z webu, BLE a UART se neprepisou.
+ *   Jedina cesta do NVS je persist task (klic jako config_persist_system_config).
+ * - Dirty: pole zmenena od posledniho dokonceneho zapisu do NVS; zapis
+ *   odmitnuty plnou frontou (nebo chyba NVS) zopakuje dalsi zmena nebo
+ *   job config_registry_register_job.
+ * - Notifikace: posluchaci s maskou poli, volani v kontextu zapisujiciho
+ *   tasku po publikaci nove verze (kratke akce, zadny zapis do registry).
+ */
+
+#ifndef CONFIG_REGISTRY_H
+#define CONFIG_REGISTRY_H
+
+#include "config_persist.h"
+#include "esp_err.h"
+#include "freertos_chess.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Max pocet posluchacu zmen */
+#define CONFIG_REGISTRY_MAX_LISTENERS 8
+/** @brief Perioda jobu, ktery znovu zaradi nezapsana (dirty) pole */
+#define CONFIG_REGISTRY_RETRY_MS 30000
+
+/** @brief Bity poli pro config_registry_set, dirty masku a notifikace */
+typedef enum {
+  CONFIG_FIELD_VERBOSE_MODE = 1u << 0,
+  CONFIG_FIELD_QUIET_MODE = 1u << 1,
+  CONFIG_FIELD_GUIDED_HINTS = 1u << 2,
+  CONFIG_FIELD_LED_GUIDANCE = 1u << 3,
+  CONFIG_FIELD_LOG_LEVEL = 1u << 4,
+  CONFIG_FIELD_COMMAND_TIMEOUT = 1u << 5,
+  CONFIG_FIELD_BRIGHTNESS = 1u << 6,
+  CONFIG_FIELD_START_POS_CHECK = 1u << 7,
+  /** Z UI prefs JSON (uklada config_save_ui_prefs_json, ne system_config_t) */
+  CONFIG_FIELD_CHESS_HINT_LIMIT = 1u << 8,
+} config_field_t;
+
+/** @brief Pole system_config_t (vse krome UI prefs) */
+#define CONFIG_FIELDS_SYSTEM 0xffu
+#define CONFIG_FIELDS_ALL 0x1ffu
+
+/** @brief Konzistentni kopie cele konfigurace */
+typedef struct {
+  system_config_t system;
+  uint8_t chess_hint_limit; ///< 0-99, 0 = neomezeno
+  uint32_t version;         ///< Roste s kazdou zmenou (0 = pred init)
+} config_snapshot_t;
+
+/**
+ * @brief Posluchac zmen
+ * @param changed Maska zmenenych poli (prunik s maskou registrace)
+ * @param snap    Nova verze konfigurace
+ */
+typedef void (*config_registry_listener_fn)(uint32_t changed,
+                                            const config_snapshot_t *snap,
+                                            void *ctx);
+
+/**
+ * @brief Nacte konfiguraci z NVS a UI prefs (jednou pri bootu, pred tasky)
+ *
+ * Pred init vraci cteni vychozi hodnoty (config_get_defaults).
+ */
+esp_err_t config_registry_init(void);
+
+/** @brief Kopie aktualni konfigurace bez zamku; vraci verzi */
+uint32_t config_registry_get(config_snapshot_t *out);
+
+/** @brief Aktualni verze (pro levne "zmenilo se neco?") */
+uint32_t config_registry_version(void);
+
+/** @brief Pole zmenena v RAM, jejichz zapis do NVS jeste nedobehl */
+uint32_t config_registry_dirty(void);
+
+/**
+ * @brief Zaregistruje job v service tasku (svc_loop.h), ktery kazdych
+ *        CONFIG_REGISTRY_RETRY_MS znovu zaradi zapis dirty poli
+ * @return ESP_OK, jinak chyba svc_job_register
+ */
+esp_err_t config_registry_register_job(void);
+
+/**
+ * @brief Prepise pole z masky `fields` hodnotami z `values`
+ *
+ * Hodnoty se orezou do platnych rozsahu (LED navadeni 1-5 a s nim
+ * guided_capture_hints_enabled, jas 0-100). Beze zmeny se nova verze
+ * nepublikuje (s `future` se jen zapise stavajici). Zmena poli system_config_t
+ * se zaradi do persist fronty.
+ * @param future Volitelne (NULL = bez cekani na zapis)
+ * @return ESP_OK, chyba config_persist_submit
+ */
+esp_err_t config_registry_set(uint32_t fields, const config_snapshot_t *values,
+                              config_persist_future_t *future);
+
+/**
+ * @brief Registruje posluchace zmen poli `mask`
+ * @return ESP_OK, ESP_ERR_NO_MEM (plno)
+ */
+esp_err_t config_registry_subscribe(uint32_t mask,
+                                    config_registry_listener_fn fn, void *ctx);
+
+/** @brief chessHintLimit z UI prefs JSON (0-99); volano pri ulozeni prefs */
+void config_registry_set_ui_prefs(const char *json, size_t len);
+
+// Typovane cteni (bez zamku)
+bool config_get_verbose_mode(void);
+bool config_get_quiet_mode(void);
+bool config_get_guided_capture_hints(void);
+uint8_t config_get_led_guidance_level(void);
+uint8_t config_get_brightness(void);
+bool config_get_starting_position_check(void);
+int config_get_chess_hint_limit(void);
+
+// Typovany zapis (config_registry_set s jednim polem, zapis na pozadi)
+esp_err_t config_set_brightness(uint8_t percent);
+/** @brief Uroven 1-5; guided capture napoveda = uroven 5 */
+esp_err_t config_set_led_guidance_level(uint8_t level);
+/** @brief Zapnuto = uroven 5, vypnuto = uroven 4 */
+esp_err_t config_set_guided_capture_hints(bool enabled);
+esp_err_t config_set_starting_position_check(bool enabled);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CONFIG_REGISTRY_H
@@ -90,6 +90,8 @@ QueueHandle_t uart_response_queue = NULL;
 
 // Game control queues
 QueueHandle_t game_command_queue = NULL;
+spsc_ring_t matrix_game_ring;
+static chess_move_command_t matrix_game_ring_buf[MATRIX_GAME_RING_SIZE];
 QueueHandle_t game_status_queue = NULL;
 
 // Animation control queues
@@ -658,6 +660,16 @@ esp_err_t chess_create_queues(void) {
            sizeof(uint8_t));
   SAFE_CREATE_QUEUE(game_status_queue, GAME_QUEUE_SIZE, sizeof(uint8_t),
                     "Game Status Queue");
+  ESP_LOGI(TAG, "  - Matrix->Game Ring: %d items × %zu bytes (lock-free)",
+           MATRIX_GAME_RING_SIZE, sizeof(chess_move_command_t));
+  esp_err_t ring_ret =
+      spsc_ring_init(&matrix_game_ring, matrix_game_ring_buf,
+                     sizeof(chess_move_command_t), MATRIX_GAME_RING_SIZE);
+  if (ring_ret != ESP_OK) {
+    ESP_LOGE(TAG, "Failed to init Matrix->Game ring: %s",
+             esp_err_to_name(ring_ret));
+    return ring_ret;
+  }
   ESP_LOGI(TAG, "✅ Game queues created. Free heap: %" PRIu32 " bytes",
            esp_get_free_heap_size());
 
@@ -0,0 +1,216 @@
+/**
+ * @file game_payload.c
+ * @brief Pool slotu s pocitanim referenci pro data zprav game tasku
+ *
+ * Handle: bity 0-3 = index slotu + 1 (0 = GAME_PAYLOAD_NONE), bity 4-15 =
+ * generace slotu v dobe alokace. Generace roste pri kazdem uvolneni slotu.
+ */
+
+#include "game_payload.h"
+
+#include "esp_log.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+static const char *TAG = "GAME_PAYLOAD";
+
+_Static_assert(GAME_PAYLOAD_SLOTS <= 15, "index slotu musi vejit do 4 bitu");
+
+typedef struct {
+  uint8_t refs; ///< 0 = volny
+  uint16_t gen; ///< 12 bitu
+  uint16_t len;
+  uint8_t data[GAME_PAYLOAD_SLOT_SIZE];
+} game_payload_slot_t;
+
+static game_payload_slot_t s_slots[GAME_PAYLOAD_SLOTS];
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+static uint32_t s_in_use;
+static uint32_t s_peak;
+static uint32_t s_failures;
+
+static game_payload_t payload_handle(uint32_t idx, uint16_t gen) {
+  return (game_payload_t)(((gen & 0x0fffu) << 4) | (idx + 1));
+}
+
+/** Slot handle nebo NULL (NONE, mimo rozsah, stara generace, volny slot). */
+static game_payload_slot_t *payload_slot(game_payload_t h) {
+  uint32_t idx = (h & 0x0fu);
+  if (idx == 0 || idx > GAME_PAYLOAD_SLOTS) {
+    return NULL;
+  }
+  game_payload_slot_t *s = &s_slots[idx - 1];
+  if (s->refs == 0 || s->gen != (h >> 4)) {
+    return NULL;
+  }
+  return s;
+}
+
+/** Rezervuje volny slot (refcount 1); data vyplni volajici pred odeslanim. */
+static game_payload_t payload_reserve(game_payload_slot_t **out) {
+  game_payload_t h = GAME_PAYLOAD_NONE;
+  portENTER_CRITICAL(&s_lock);
+  for (uint32_t i = 0; i < GAME_PAYLOAD_SLOTS; i++) {
+    if (s_slots[i].refs == 0) {
+      s_slots[i].refs = 1;
+      *out = &s_slots[i];
+      h = payload_handle(i, s_slots[i].gen);
+      if (++s_in_use > s_peak) {
+        s_peak = s_in_use;
+      }
+      break;
+    }
+  }
+  if (h == GAME_PAYLOAD_NONE) {
+    s_failures++;
+  }
+  portEXIT_CRITICAL(&s_lock);
+  if (h == GAME_PAYLOAD_NONE) {
+    ESP_LOGW(TAG, "payload pool exhausted (%d slots)", GAME_PAYLOAD_SLOTS);
+  }
+  return h;
+}
+
+game_payload_t game_payload_alloc(const void *data, size_t len) {
+  if (len > GAME_PAYLOAD_SLOT_SIZE || (data == NULL && len > 0)) {
+    return GAME_PAYLOAD_NONE;
+  }
+  game_payload_slot_t *s = NULL;
+  game_payload_t h = payload_reserve(&s);
+  if (h != GAME_PAYLOAD_NONE) {
+    if (len > 0) {
+      memcpy(s->data, data, len);
+    }
+    s->len = (uint16_t)len;
+  }
+  return h;
+}
+
+game_payload_t game_payload_alloc_strn(const char *s, size_t n) {
+  size_t len = (s != NULL) ? strnlen(s, n) : 0;
+  if (len > GAME_PAYLOAD_SLOT_SIZE - 1) {
+    len = GAME_PAYLOAD_SLOT_SIZE - 1;
+  }
+  game_payload_slot_t *slot = NULL;
+  game_payload_t h = payload_reserve(&slot);
+  if (h != GAME_PAYLOAD_NONE) {
+    if (len > 0) {
+      memcpy(slot->data, s, len);
+    }
+    slot->data[len] = '\0';
+    slot->len = (uint16_t)(len + 1);
+  }
+  return h;
+}
+
+game_payload_t game_payload_alloc_str(const char *s) {
+  return game_payload_alloc_strn(s, GAME_PAYLOAD_SLOT_SIZE - 1);
+}
+
+game_payload_t game_payload_printf(const char *fmt, ...) {
+  game_payload_slot_t *slot = NULL;
+  game_payload_t h = payload_reserve(&slot);
+  if (h == GAME_PAYLOAD_NONE) {
+    return h;
+  }
+  va_list ap;
+  va_start(ap, fmt);
+  int n = vsnprintf((char *)slot->data, sizeof(slot->data), fmt, ap);
+  va_end(ap);
+  if (n < 0) {
+    slot->data[0] = '\0';
+    n = 0;
+  } else if ((size_t)n >= sizeof(slot->data)) {
+    n = sizeof(slot->data) - 1;
+  }
+  slot->len = (uint16_t)(n + 1);
+  return h;
+}
+
+const void *game_payload_data(game_payload_t h, size_t *len) {
+  game_payload_slot_t *s = payload_slot(h);
+  if (len != NULL) {
+    *len = (s != NULL) ? s->len : 0;
+  }
+  return (s != NULL) ? s->data : NULL;
+}
+
+const char *game_payload_str(game_payload_t h) {
+  game_payload_slot_t *s = payload_slot(h);
+  if (s == NULL || s->len == 0 || s->data[s->len - 1] != '\0') {
+    return "";
+  }
+  return (const char *)s->data;
+}
+
+void game_payload_retain(game_payload_t h) {
+  if (h == GAME_PAYLOAD_NONE) {
+    return;
+  }
+  bool ok = false;
+  portENTER_CRITICAL(&s_lock);
+  game_payload_slot_t *s = payload_slot(h);
+  if (s != NULL && s->refs < UINT8_MAX) {
+    s->refs++;
+    ok = true;
+  }
+  portEXIT_CRITICAL(&s_lock);
+  if (!ok) {
+    ESP_LOGW(TAG, "retain of stale payload 0x%04x", (unsigned)h);
+  }
+}
+
+void game_payload_release(game_payload_t h) {
+  if (h == GAME_PAYLOAD_NONE) {
+    return;
+  }
+  bool ok = false;
+  portENTER_CRITICAL(&s_lock);
+  game_payload_slot_t *s = payload_slot(h);
+  if (s != NULL) {
+    ok = true;
+    if (--s->refs == 0) {
+      s->gen = (uint16_t)((s->gen + 1) & 0x0fffu);
+      s_in_use--;
+    }
+  }
+  portEXIT_CRITICAL(&s_lock);
+  if (!ok) {
+    ESP_LOGW(TAG, "release of stale payload 0x%04x", (unsigned)h);
+  }
+}
+
+void game_payload_stats(uint32_t *in_use, uint32_t *peak, uint32_t *failures) {
+  portENTER_CRITICAL(&s_lock);
+  if (in_use != NULL) {
+    *in_use = s_in_use;
+  }
+  if (peak != NULL) {
+    *peak = s_peak;
+  }
+  if (failures != NULL) {
+    *failures = s_failures;
+  }
+  portEXIT_CRITICAL(&s_lock);
+}
+
+bool game_response_send(QueueHandle_t queue, const game_response_t *response,
+                        TickType_t wait) {
+  if (queue != NULL && xQueueSend(queue, response, wait) == pdTRUE) {
+    return true;
+  }
+  game_payload_release(response->text);
+  return false;
+}
+
+void game_response_drain(QueueHandle_t queue) {
+  if (queue == NULL) {
+    return;
+  }
+  game_response_t stale;
+  while (xQueueReceive(queue, &stale, 0) == pdTRUE) {
+    game_response_release(&stale);
+  }
+}
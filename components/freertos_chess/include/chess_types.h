@@ -293,57 +293,104 @@ typedef enum {
   GAME_CMD_BOARD_SETUP_TUTORIAL =
       46, ///< Web tutoriál rozestavení; promotion_choice: 0=start,1=cancel,2=finish
   GAME_CMD_PUZZLE =
-      47, ///< Web puzzle: 0=cancel,1..5=start,101..105=prepare id 1..5
+      47, ///< Uloha: promotion_choice 0=cancel,1=start,2=prepare; timer_data.puzzle
   GAME_CMD_NEW_GAME_FROM_FEN =
       48, ///< Nová hra z FEN (placement + strana); data v timer_data.fen_new_game
   GAME_CMD_OPENING_TRAINER =
-      49 ///< Opening trainer: promotion_choice 0=cancel,1=start,2=hint,3=checkpoint_ack
+      49, ///< Opening trainer: promotion_choice 0=cancel,1=start,2=hint,3=checkpoint_ack
+  GAME_CMD_MOVE_BATCH =
+      50 ///< Davka tahu atomicky (vse nebo nic); data v timer_data.move_batch
 } game_command_type_t;
 
 /**
- * @brief Struktura prikazu pro sachovy tah pres UART
+ * @brief Handle slotu s daty zpravy (game_payload.h); 0 = zadna data
+ */
+typedef uint16_t game_payload_t;
+#define GAME_PAYLOAD_NONE ((game_payload_t)0)
+
+/** @brief Velikost notace pole v prikazu ("e2" + '\0') */
+#define CHESS_NOTATION_SIZE 3
+
+/**
+ * @brief Tah v payloadu GAME_CMD_MOVE_BATCH: uint16 from6 | to6<<6 | promo2<<12
+ *
+ * Pole = row*8+col, promo = promotion_choice_t (pouzije se jen u promoce).
+ * Rosada je tah krale o dve pole, vez dotahne game task.
+ */
+#define GAME_MOVE_BATCH_PACK(from, to, promo)                                  \
+  ((uint16_t)(((from)&0x3fu) | (((to)&0x3fu) << 6) | (((promo)&0x3u) << 12)))
+#define GAME_MOVE_BATCH_FROM(m) ((uint8_t)((m)&0x3fu))
+#define GAME_MOVE_BATCH_TO(m) ((uint8_t)(((m) >> 6) & 0x3fu))
+#define GAME_MOVE_BATCH_PROMO(m) ((uint8_t)(((m) >> 12) & 0x3u))
+/** @brief Max tahu v jedne davce (jeden slot game_payload.h) */
+#define GAME_MOVE_BATCH_MAX 128
+
+/**
+ * @brief Text odpovedi na GAME_CMD_MOVE_BATCH (binarni payload)
+ *
+ * error_code odpovedi = move_error_t prvniho neplatneho tahu (0 = vse
+ * provedeno); pri chybe se davka vrati a `applied` je 0.
+ */
+typedef struct {
+  uint16_t applied;      ///< Provedenych tahu
+  uint16_t failed_index; ///< Index neplatneho tahu (jen pri chybe)
+  uint32_t ply;          ///< Pocet pultahu hry po davce
+} game_move_batch_result_t;
+
+/**
+ * @brief Struktura prikazu pro game task (UART, web, BLE, matice, timer)
  *
- * Tato struktura se pouziva pro poslani prikazu game tasku pres frontu.
- * Obsahuje vsechny potrebne informace pro provedeni tahu a zpracovani odpovedi.
+ * Kopiruje se do game_command_queue hodnotou, proto ma pevnych 24 B (na
+ * 32bit cili). Vzacna velka data (FEN, jmeno hry, masky matrix guardu) jsou
+ * ve slotu game_payload.h; handle patri prikazu a game task ho po zpracovani
+ * uvolni. Kdyz xQueueSend selze, uvolni ho odesilatel.
  */
 typedef struct {
-  uint8_t type;          ///< Typ prikazu (game_command_type_t)
-  char from_notation[8]; ///< Zdrojova notace (napr. "e2") - zvetseno z 4 na 8
-                         ///< pro bezpecnost
-  char to_notation[8];   ///< Cilova notace (napr. "e4") - zvetseno z 4 na 8 pro
-                         ///< bezpecnost
+  uint8_t type;   ///< Typ prikazu (game_command_type_t)
   uint8_t player; ///< Hrac provadejici prikaz (PLAYER_WHITE nebo PLAYER_BLACK)
-  QueueHandle_t response_queue; ///< Fronta pro poslani odpovedi
-  uint8_t promotion_choice;     ///< Volba promoci (pro promotion prikazy)
+  uint8_t promotion_choice;      ///< Volba promoci (pro promotion prikazy)
   uint8_t promotion_from_remote; ///< 1 = WEB/BLE poslalo pole promotion u GAME_CMD_MOVE
+  char from_notation[CHESS_NOTATION_SIZE]; ///< Zdrojova notace (napr. "e2")
+  char to_notation[CHESS_NOTATION_SIZE];   ///< Cilova notace (napr. "e4")
+  bool is_demo_mode;            ///< Flag pro demo mode (skip resignation timer)
+  QueueHandle_t response_queue; ///< Fronta pro poslani odpovedi
 
-  // Pole pro timer system
+  // Data podle typu prikazu (max 8 B)
   union {
     struct {
       uint8_t time_control_type; ///< Typ casove kontroly (pro
                                  ///< GAME_CMD_SET_TIME_CONTROL)
-      uint32_t
-          custom_minutes; ///< Vlastni minuty (pro vlastni casovou kontrolu)
-      uint32_t custom_increment; ///< Vlastni increment (pro vlastni casovou
-                                 ///< kontrolu)
+      uint16_t custom_minutes;   ///< Vlastni minuty (pro vlastni casovou kontrolu)
+      uint16_t custom_increment; ///< Vlastni increment v sekundach
     } timer_config;              ///< Konfigurace timeru
     struct {
       bool is_white_turn; ///< Je na tahu bily? (pro timer operace)
     } timer_state;        ///< Stav timeru
     struct {
-      uint32_t lifted_mask_low;  ///< Bity 0-31 pro zvednuta pole
-      uint32_t lifted_mask_high; ///< Bity 32-63 pro zvednuta pole
-      uint32_t dropped_mask_low; ///< Bity 0-31 pro polozena pole
-      uint32_t dropped_mask_high; ///< Bity 32-63 pro polozena pole
-      uint8_t action;            ///< 1=enter/update, 0=clear
-    } matrix_guard;              ///< Data pro matrix guard rezim
+      uint8_t action;       ///< 1=enter/update, 0=clear
+      game_payload_t masks; ///< 4 x uint32_t: lifted low/high, dropped low/high
+    } matrix_guard;         ///< Data pro matrix guard rezim
     struct {
-      char fen[120]; ///< FEN pro GAME_CMD_NEW_GAME_FROM_FEN (placement + w/b)
+      game_payload_t fen; ///< FEN pro GAME_CMD_NEW_GAME_FROM_FEN (placement + w/b)
     } fen_new_game;
-  } timer_data;           ///< Union pro timer data
-  bool is_demo_mode;      ///< Flag pro demo mode (skip resignation timer)
+    struct {
+      game_payload_t name; ///< Jmeno hry (retezec) pro SAVE/LOAD/DELETE_GAME
+      uint16_t page;       ///< Strana vypisu pro GAME_CMD_LIST_GAMES (od 1)
+    } archive;
+    struct {
+      uint16_t id;         ///< ID ulohy; 0 = vyber podle ratingu a temat
+      uint16_t rating;     ///< Cilovy rating pro vyber (id == 0)
+      uint32_t theme_mask; ///< Pozadovana temata (game_puzzle_db_theme_mask)
+    } puzzle;
+    struct {
+      game_payload_t moves; ///< uint16 tahy (GAME_MOVE_BATCH_PACK), max 128
+    } move_batch;
+  } timer_data;           ///< Union dat prikazu
 } chess_move_command_t;
 
+_Static_assert(sizeof(void *) != 4 || sizeof(chess_move_command_t) == 24,
+               "chess_move_command_t ma mit 24 B");
+
 /**
  * @brief Typy game odpovedi
  *
@@ -363,19 +410,20 @@ typedef enum {
 /**
  * @brief Struktura game odpovedi pro UART komunikaci
  *
- * Tato struktura obsahuje odpoved game tasku na prikaz.
- * Je poslana zpet pres UART pro zobrazeni uzivateli.
+ * Tato struktura obsahuje odpoved game tasku na prikaz. Text je ve slotu
+ * game_payload.h (muze byt GAME_PAYLOAD_NONE); prijemce ho precte pres
+ * game_payload_str() a uvolni game_response_release().
  */
 typedef struct {
   uint8_t type;         ///< Typ odpovedi (game_response_type_t)
   uint8_t command_type; ///< Puvodni typ prikazu (game_command_type_t)
   uint8_t error_code;   ///< Kod chyby (move_error_t, 0 pokud neni chyba)
-  char message[256];    ///< Zprava pro uzivatele (human-readable)
-  char data[64];        ///< Data odpovedi (redukovano z 3584 na 64 bytu pro
-                        ///< optimalizaci pameti)
+  game_payload_t text;  ///< Text pro uzivatele / data odpovedi
   uint32_t timestamp;   ///< Casova znamka odpovedi (v milisekundach)
 } game_response_t;
 
+_Static_assert(sizeof(game_response_t) == 12, "game_response_t ma mit 12 B");
+
 // ============================================================================
 // DEFINICE LED SYSTEMU
 // ============================================================================
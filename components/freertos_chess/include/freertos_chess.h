@@ -28,6 +28,7 @@
 
 #include "sdkconfig.h"
 #include "chess_types.h"
+#include "spsc_ring.h"
 #include "driver/gpio.h"
 #include "esp_err.h"
 #include "freertos/FreeRTOS.h"
@@ -215,10 +216,15 @@ static inline bool chess_gpio_pin_is_stm32_nrst_output(int gpio_num) {
 #define MATRIX_QUEUE_SIZE 8
 /** @brief Button: udalosti z ISR (vzacne). */
 #define BUTTON_QUEUE_SIZE 5
-/** @brief UART: prikazy/odpovedi (sizeof(game_response_t) ~ 328 B na polozku). */
+/** @brief UART: prikazy/odpovedi (game_response_t 12 B; text v game_payload.h). */
 #define UART_QUEUE_SIZE 10
-/** @brief Game: rychle tahy z webu/matice (24 × chess_move_command_t; dříve 50). */
+/** @brief Game: rychle tahy z webu/matice (24 × 24 B chess_move_command_t; dříve 50). */
 #define GAME_QUEUE_SIZE 24
+/**
+ * @brief Matrix -> game: SPSC ring pickup/drop/guard prikazu (16 × 24 B).
+ * @note Matrix task pri plnem ringu ceka max 100 ms jako drive xQueueSend.
+ */
+#define MATRIX_GAME_RING_SIZE 16
 /**
  * @brief Test: uint8 prikazy do test_task (0–5 v test_process_commands).
  * @note LED fronty se nepouzivaji (direct LED); drive byla tato hodnota
@@ -246,7 +252,6 @@ static inline bool chess_gpio_pin_is_stm32_nrst_output(int gpio_num) {
 #define LED_TASK_STACK_SIZE (8 * 1024)
 /** @brief Matrix: sken + odezvy (game_response_t). */
 #define MATRIX_TASK_STACK_SIZE (4 * 1024)
-#define BUTTON_TASK_STACK_SIZE (3 * 1024)
 /** @brief UART: radka vstupu + game_response_t pri forwardu odpovedi. */
 #define UART_TASK_STACK_SIZE (5 * 1024)
 #define GAME_TASK_STACK_SIZE (6 * 1024)
@@ -258,10 +263,6 @@ static inline bool chess_gpio_pin_is_stm32_nrst_output(int gpio_num) {
  * vzory) */
 #define SCREEN_SAVER_TASK_STACK_SIZE                                           \
   (2 * 1024) // 2KB (reduced from 3KB - simple patterns)
-/** @brief Velikost stacku Test tasku (4KB, zvyseno z 2KB pro prevenci stack
- * overflow) */
-#define TEST_TASK_STACK_SIZE                                                   \
-  (4 * 1024) // 4KB (increased from 2KB to prevent stack overflow)
 // #define MATTER_TASK_STACK_SIZE (8 * 1024)       // DISABLED - Matter not
 // needed
 /** @brief Velikost stacku Web Server tasku (20KB, zvyseno pro WiFi/HTTP server
@@ -272,16 +273,17 @@ static inline bool chess_gpio_pin_is_stm32_nrst_output(int gpio_num) {
 #define RESET_BUTTON_TASK_STACK_SIZE (2 * 1024) // 2KB (unchanged)
 /** @brief Velikost stacku Promotion Button tasku (2KB - nezmeneno) */
 #define PROMOTION_BUTTON_TASK_STACK_SIZE (2 * 1024) // 2KB (unchanged)
-/** @brief Velikost stacku HA Light tasku (8KB) */
-#define HA_LIGHT_TASK_STACK_SIZE (8 * 1024) // 8KB
+/** @brief Service task (svc_loop.h): tlacitka, lampa, testy — stack podle
+ * lampy (MQTT init, cJSON); drive 3 + 8 + 4 KB ve trech taskech */
+#define SVC_TASK_STACK_SIZE (8 * 1024)
+/** @brief Velikost stacku Persist tasku (NVS zapis + delta snapshotu) */
+#define PERSIST_TASK_STACK_SIZE (4 * 1024)
 
 // Priority tasku
 /** @brief Priorita LED tasku (7 - nejvyssi priorita pro LED timing) */
 #define LED_TASK_PRIORITY 7 // Nejvyssi priorita pro LED timing
 /** @brief Priorita Matrix tasku (6 - hardware vstup) */
 #define MATRIX_TASK_PRIORITY 6 // Hardware vstup
-/** @brief Priorita Button tasku (5 - uzivatelsky vstup) */
-#define BUTTON_TASK_PRIORITY 5 // Uzivatelsky vstup
 /** @brief Priorita UART tasku (3 - komunikace) */
 #define UART_TASK_PRIORITY 3 // Komunikace
 /** @brief Priorita Game tasku (4) */
@@ -290,8 +292,6 @@ static inline bool chess_gpio_pin_is_stm32_nrst_output(int gpio_num) {
 #define ANIMATION_TASK_PRIORITY 3 // Vizualni efekty
 /** @brief Priorita Screen Saver tasku (2 - pozadi) */
 #define SCREEN_SAVER_TASK_PRIORITY 2 // Pozadi
-/** @brief Priorita Test tasku (1 - pouze pro debug) */
-#define TEST_TASK_PRIORITY 1 // Pouze pro debug
 // #define MATTER_TASK_PRIORITY 4       // DISABLED - Matter not needed
 /** @brief Priorita Web Server tasku (3 - komunikace) */
 #define WEB_SERVER_TASK_PRIORITY 3 // Komunikace
@@ -299,8 +299,10 @@ static inline bool chess_gpio_pin_is_stm32_nrst_output(int gpio_num) {
 #define RESET_BUTTON_TASK_PRIORITY 3 // Uzivatelsky vstup
 /** @brief Priorita Promotion Button tasku (3 - uzivatelsky vstup) */
 #define PROMOTION_BUTTON_TASK_PRIORITY 3 // Uzivatelsky vstup
-/** @brief Priorita HA Light tasku (3 - komunikace) */
-#define HA_LIGHT_TASK_PRIORITY 3 // Komunikace
+/** @brief Priorita service tasku (3 - tlacitka, lampa, testy) */
+#define SVC_TASK_PRIORITY 3 // Uzivatelsky vstup + komunikace
+/** @brief Priorita Persist tasku (2 - zapis do flash na pozadi) */
+#define PERSIST_TASK_PRIORITY 2 // Pozadi
 
 // ============================================================================
 // GLOBALNI QUEUE HANDLES
@@ -327,6 +329,13 @@ extern QueueHandle_t uart_response_queue;
 extern QueueHandle_t game_command_queue;
 /** @brief Fronta pro game status (stav hry) */
 extern QueueHandle_t game_status_queue;
+/**
+ * @brief Ring matrix -> game (producent matrix task, konzument game task)
+ *
+ * Fyzicke udalosti desky jdou mimo game_command_queue: game task je cte
+ * prednostne a matrix ho probudi notifikaci, nemusi cekat na 100ms cyklus.
+ */
+extern spsc_ring_t matrix_game_ring;
 /** @brief Fronta pro animation prikazy (start, stop, pause) */
 extern QueueHandle_t animation_command_queue;
 /** @brief Fronta pro animation status (stav animaci) */
@@ -628,8 +637,6 @@ bool is_demo_mode_enabled(void);
 extern TaskHandle_t led_task_handle;
 /** @brief Handle pro Matrix task */
 extern TaskHandle_t matrix_task_handle;
-/** @brief Handle pro Button task */
-extern TaskHandle_t button_task_handle;
 /** @brief Handle pro UART task */
 extern TaskHandle_t uart_task_handle;
 /** @brief Handle pro Game task */
@@ -638,8 +645,6 @@ extern TaskHandle_t game_task_handle;
 extern TaskHandle_t animation_task_handle;
 /** @brief Handle pro Screen Saver task */
 extern TaskHandle_t screen_saver_task_handle;
-/** @brief Handle pro Test task */
-extern TaskHandle_t test_task_handle;
 /** @brief Handle pro Matter task (DISABLED - Matter neni potreba) */
 extern TaskHandle_t matter_task_handle;
 /** @brief Handle pro Web Server task */
@@ -0,0 +1,102 @@
+/**
+ * @file game_payload.h
+ * @brief Sloty pro vzacna velka data zprav game tasku (FEN, jmena, texty)
+ *
+ * chess_move_command_t a game_response_t se do front kopiruji hodnotou, proto
+ * maji pevnych 24 / 12 B. Co se do nich nevejde (FEN, jmeno hry, masky matrix
+ * guardu, text odpovedi), lezi ve slotu sdileneho poolu a zprava nese jen
+ * game_payload_t (index + generace slotu, 2 B).
+ *
+ * - Odesilatel: game_payload_alloc*() → handle do zpravy → xQueueSend;
+ *   kdyz odeslani selze, game_payload_release().
+ * - Prijemce: jedna reference patri zprave — po zpracovani release. Kdo data
+ *   drzi dele nez zpravu, game_payload_retain().
+ * - Plny pool: alloc vrati GAME_PAYLOAD_NONE (zaloguje se), cteni NONE vrati
+ *   prazdna data. Prikaz bez povinneho payloadu game task odmitne.
+ * - Generace v handle: pozdni cteni / release po znovupouziti slotu se pozna
+ *   a nic neposkodi.
+ *
+ * Slot se po odeslani uz nemeni, cteni je proto bez zamku; alokace a pocty
+ * referenci jsou v kratke kriticke sekci (volatelne z libovolneho tasku).
+ */
+
+#ifndef GAME_PAYLOAD_H
+#define GAME_PAYLOAD_H
+
+#include "chess_types.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Pocet slotu (max 15, index je ve 4 bitech handle) */
+#define GAME_PAYLOAD_SLOTS 12
+/** @brief Kapacita slotu v bajtech (text max GAME_PAYLOAD_SLOT_SIZE - 1 znaku) */
+#define GAME_PAYLOAD_SLOT_SIZE 256
+
+/**
+ * @brief Novy slot s kopii `len` B dat (refcount 1)
+ * @return Handle, GAME_PAYLOAD_NONE = pool plny nebo len > GAME_PAYLOAD_SLOT_SIZE
+ */
+game_payload_t game_payload_alloc(const void *data, size_t len);
+
+/** @brief Slot s retezcem (vcetne '\0'); delsi se zkrati */
+game_payload_t game_payload_alloc_str(const char *s);
+
+/** @brief Slot s nejvys `n` znaky z `s` (+ '\0'); delsi se zkrati */
+game_payload_t game_payload_alloc_strn(const char *s, size_t n);
+
+/** @brief Slot s formatovanym textem (delsi se zkrati) */
+game_payload_t game_payload_printf(const char *fmt, ...)
+    __attribute__((format(printf, 1, 2)));
+
+/**
+ * @brief Data slotu
+ * @param len Volitelne: delka dat (0 pro NONE / neplatny handle)
+ * @return NULL pro NONE / neplatny handle
+ */
+const void *game_payload_data(game_payload_t h, size_t *len);
+
+/** @brief Text slotu; "" pro NONE / neplatny handle (nikdy NULL) */
+const char *game_payload_str(game_payload_t h);
+
+/** @brief Dalsi reference na slot */
+void game_payload_retain(game_payload_t h);
+
+/** @brief Uvolni referenci; posledni vrati slot do poolu. NONE = no-op */
+void game_payload_release(game_payload_t h);
+
+/** @brief Statistiky poolu (kterykoli ukazatel muze byt NULL) */
+void game_payload_stats(uint32_t *in_use, uint32_t *peak, uint32_t *failures);
+
+/**
+ * @brief Odesle odpoved; pri neuspechu uvolni jeji text
+ * @return true = odpoved je ve fronte (text ted patri prijemci)
+ */
+bool game_response_send(QueueHandle_t queue, const game_response_t *response,
+                        TickType_t wait);
+
+/** @brief Prijemce: uvolni text prijate odpovedi */
+static inline void game_response_release(game_response_t *response) {
+  game_payload_release(response->text);
+  response->text = GAME_PAYLOAD_NONE;
+}
+
+/**
+ * @brief Zahodi odpovedi, ktere ve fronte zustaly (bez cekajiciho prijemce)
+ *
+ * Volat pred odeslanim prikazu se sdilenou frontou odpovedi, aby se
+ * neprecetla stara odpoved a jeji slot se vratil do poolu.
+ */
+void game_response_drain(QueueHandle_t queue);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* GAME_PAYLOAD_H */
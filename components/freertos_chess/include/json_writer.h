@@ -0,0 +1,156 @@
+/**
+ * @file json_writer.h
+ * @brief ESP32-C6 Chess System - Streamovy JSON writer
+ *
+ * Nahrazuje retezy snprintf nad pevnymi buffery (json_buffer, snapshot_buffer):
+ * - Cil = pevny buffer, rostouci heap buffer, nebo sink (HTTP chunk, WS frame)
+ * - Carky a vnoreni hlida writer, retezce se escapuji
+ * - Prvni chyba (preteceni, sink) se drzi v writeru, dalsi zapisy jsou no-op
+ *
+ * @author Alfred Krutina
+ * @version 1.8.0
+ * @date 2026-10-18
+ *
+ * @par Priklad pouziti:
+ * @code
+ *   json_writer_t w;
+ *   json_writer_init_buffer(&w, buf, sizeof(buf));
+ *   json_writer_begin_object(&w);
+ *   json_writer_kv_string(&w, "game_state", "active");
+ *   json_writer_key(&w, "moves");
+ *   json_writer_begin_array(&w);
+ *   json_writer_end_array(&w);
+ *   json_writer_end_object(&w);
+ *   esp_err_t err = json_writer_finish(&w);
+ * @endcode
+ */
+
+#ifndef JSON_WRITER_H
+#define JSON_WRITER_H
+
+#include "esp_err.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Max hloubka vnoreni objektu/poli */
+#define JSON_WRITER_MAX_DEPTH 31
+
+/**
+ * @brief Cil pro vyprazdneni bufferu (napr. httpd_resp_send_chunk)
+ * @return ESP_OK, jinak se zapis ukonci s touto chybou
+ */
+typedef esp_err_t (*json_writer_sink_t)(void *ctx, const char *data,
+                                        size_t len);
+
+/**
+ * @brief Stav writeru — na stacku volajiciho, zadna alokace krome heap rezimu
+ */
+typedef struct {
+  char *buf;               ///< Pevny buffer, scratch pro sink, nebo heap
+  size_t cap;              ///< Kapacita `buf`
+  size_t len;              ///< Platnych bajtu v `buf`
+  size_t flushed;          ///< Bajty uz predane sinku
+  json_writer_sink_t sink; ///< NULL = vysledek zustava v `buf`
+  void *sink_ctx;          ///< Kontext pro sink
+  bool heap;               ///< `buf` je z malloc a roste
+  bool after_key;          ///< Posledni zapis byl klic (bez carky pred hodnotou)
+  uint8_t depth;           ///< Aktualni hloubka vnoreni
+  uint32_t has_items;      ///< Bit d = v hloubce d uz je prvek (pred dalsim carka)
+  esp_err_t err;           ///< Prvni chyba, ESP_OK pokud zadna
+} json_writer_t;
+
+// ============================================================================
+// INICIALIZACE A DOKONCENI
+// ============================================================================
+
+/**
+ * @brief Zapis do pevneho bufferu (vysledek ukonceny NUL)
+ *
+ * Pri preteceni json_writer_finish() vrati ESP_ERR_NO_MEM.
+ */
+void json_writer_init_buffer(json_writer_t *w, char *buf, size_t cap);
+
+/**
+ * @brief Zapis do rostouciho heap bufferu (vysledek predat json_writer_take())
+ *
+ * @return ESP_OK nebo ESP_ERR_NO_MEM pri selhani prvni alokace
+ */
+esp_err_t json_writer_init_heap(json_writer_t *w, size_t initial_cap);
+
+/**
+ * @brief Streamovani pres `scratch` do sinku (vyprazdni se pri naplneni a ve finish)
+ */
+void json_writer_init_sink(json_writer_t *w, char *scratch, size_t cap,
+                           json_writer_sink_t sink, void *ctx);
+
+/**
+ * @brief Vyprazdni zbytek do sinku / ukonci buffer NUL
+ * @return Prvni chyba zapisu, jinak ESP_OK
+ */
+esp_err_t json_writer_finish(json_writer_t *w);
+
+/**
+ * @brief Heap rezim: prevezme buffer (NUL ukonceny), volajici vola free()
+ * @return NULL pri chybe (buffer je pak uvolnen)
+ */
+char *json_writer_take(json_writer_t *w, size_t *out_len);
+
+/** @brief Heap rezim: uvolni buffer bez prevzeti (chybova cesta) */
+void json_writer_discard(json_writer_t *w);
+
+/** @brief Celkem zapsanych bajtu (vcetne uz vyprazdnenych do sinku) */
+size_t json_writer_total(const json_writer_t *w);
+
+/** @brief Aktualni chyba (ESP_OK pokud zadna) */
+static inline esp_err_t json_writer_error(const json_writer_t *w) {
+  return w->err;
+}
+
+// ============================================================================
+// STRUKTURA A HODNOTY
+// ============================================================================
+
+void json_writer_begin_object(json_writer_t *w);
+void json_writer_end_object(json_writer_t *w);
+void json_writer_begin_array(json_writer_t *w);
+void json_writer_end_array(json_writer_t *w);
+
+/** @brief Klic v objektu; nasledujici zapis je jeho hodnota */
+void json_writer_key(json_writer_t *w, const char *key);
+
+/** @brief Retezec s escapovanim (NULL = "") */
+void json_writer_string(json_writer_t *w, const char *s);
+/** @brief Retezec delky `n` (nemusi byt ukonceny NUL) */
+void json_writer_string_n(json_writer_t *w, const char *s, size_t n);
+/** @brief Jednoznakovy retezec (policko desky, figurka) */
+void json_writer_char(json_writer_t *w, char c);
+void json_writer_int(json_writer_t *w, int64_t v);
+void json_writer_uint(json_writer_t *w, uint64_t v);
+void json_writer_bool(json_writer_t *w, bool v);
+void json_writer_null(json_writer_t *w);
+/** @brief Hotovy JSON fragment jako hodnota (bez kontroly) */
+void json_writer_raw(json_writer_t *w, const char *json, size_t len);
+/**
+ * @brief Text mimo JSON strukturu (oddelovac JSON Lines, PGN)
+ *
+ * V hloubce 0 uzavira zaznam: dalsi hodnota uz nezacne carkou.
+ */
+void json_writer_text(json_writer_t *w, const char *s, size_t len);
+
+// Zkratky klic + hodnota
+void json_writer_kv_string(json_writer_t *w, const char *key, const char *s);
+void json_writer_kv_char(json_writer_t *w, const char *key, char c);
+void json_writer_kv_int(json_writer_t *w, const char *key, int64_t v);
+void json_writer_kv_uint(json_writer_t *w, const char *key, uint64_t v);
+void json_writer_kv_bool(json_writer_t *w, const char *key, bool v);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* JSON_WRITER_H */
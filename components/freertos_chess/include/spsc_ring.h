@@ -0,0 +1,94 @@
+/**
+ * @file spsc_ring.h
+ * @brief Lock-free ring pro jednoho producenta a jednoho konzumenta
+ *
+ * Horke cesty mezi dvema pevnymi tasky (matrix -> game, game -> LED) nemusi
+ * platit za FreeRTOS frontu (kopie pres kernel, kriticka sekce, wake list)
+ * ani za mutex (priority inheritance mezi taskem 7 a 4). Ring je pole
+ * pevnych prvku s volne bezicimi indexy head/tail:
+ *
+ * - head zapisuje jen producent, tail jen konzument (release/acquire),
+ *   takze poradi prvku je presne poradi push — pickup/drop sekvence se
+ *   neprehazi.
+ * - Konzument se budi task notifikaci (spsc_ring_notify); ring sam nikdy
+ *   neblokuje. spsc_ring_push_wait() pri plnem ringu vzbudi konzumenta
+ *   a chvili ceka po tiku; teprve pak prvek zahodi a zvysi drops.
+ * - Kapacita musi byt mocnina 2; buffer dodava volajici (staticky).
+ *
+ * Ne z ISR; kazdy ring ma prave jednoho producenta a jednoho konzumenta.
+ */
+
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Stav ringu (pole jsou interni, pristup jen pres API) */
+typedef struct {
+  uint8_t *buf;
+  uint16_t elem_size;
+  uint16_t mask;
+  _Atomic uint32_t head;  ///< Dalsi zapis (meni producent)
+  _Atomic uint32_t tail;  ///< Dalsi cteni (meni konzument)
+  _Atomic uint32_t drops; ///< Zahozene prvky (plny ring po timeoutu)
+  uint32_t pushed;        ///< Prijate prvky (meni producent)
+  uint32_t high_water;    ///< Nejvyssi zaplneni (meni producent)
+  TaskHandle_t consumer;  ///< Cil spsc_ring_notify (NULL = nebudit)
+} spsc_ring_t;
+
+/** @brief Statistiky pro vypis front */
+typedef struct {
+  uint32_t capacity;
+  uint32_t used;
+  uint32_t high_water;
+  uint32_t pushed;
+  uint32_t drops;
+} spsc_ring_stats_t;
+
+/**
+ * @brief Pripravi ring nad bufferem `capacity * elem_size` bajtu
+ * @return ESP_OK, ESP_ERR_INVALID_ARG (kapacita neni mocnina 2 / > 32768)
+ */
+esp_err_t spsc_ring_init(spsc_ring_t *ring, void *storage, size_t elem_size,
+                         uint32_t capacity);
+
+/** @brief Task, ktery ring cte; vola konzument pri startu */
+void spsc_ring_set_consumer(spsc_ring_t *ring, TaskHandle_t consumer);
+
+/** @brief Producent: vlozi prvek; plny ring = false (drops se nemeni) */
+bool spsc_ring_push(spsc_ring_t *ring, const void *item);
+
+/**
+ * @brief Producent: vlozi prvek, pri plnem ringu budi konzumenta a ceka
+ * @return false = prvek zahozen po `timeout` (zapocten v drops)
+ */
+bool spsc_ring_push_wait(spsc_ring_t *ring, const void *item,
+                         TickType_t timeout);
+
+/** @brief Producent: vzbudi konzumenta (xTaskNotifyGive), pokud je znamy */
+void spsc_ring_notify(spsc_ring_t *ring);
+
+/** @brief Konzument: vyzvedne nejstarsi prvek; prazdny ring = false */
+bool spsc_ring_pop(spsc_ring_t *ring, void *out);
+
+/** @brief Pocet prvku v ringu (z libovolneho tasku, orientacne) */
+uint32_t spsc_ring_count(const spsc_ring_t *ring);
+
+/** @brief Kopie statistik (z libovolneho tasku) */
+void spsc_ring_get_stats(const spsc_ring_t *ring, spsc_ring_stats_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SPSC_RING_H */
@@ -0,0 +1,82 @@
+/**
+ * @file svc_loop.h
+ * @brief Kooperativni planovac: malo vytizene komponenty jako joby v jednom tasku
+ *
+ * Tlacitka, lampa (HA light) a testovaci hooky vetsinu casu jen spi a obcas
+ * zkontroluji frontu nebo casovac. Misto vlastniho tasku (stack, TCB, WDT)
+ * kazdy registruje job a vsechny bezi v jednom service tasku:
+ *
+ * - Job je neblokujici funkce; vraci za kolik ms ji zavolat znovu
+ *   (SVC_JOB_IDLE = az po svc_job_wake). Pristi termin se pocita od puvodniho
+ *   terminu (jako vTaskDelayUntil), zpozdeny job se nedohani.
+ * - svc_job_wake() z jineho tasku (ne z ISR) spusti job co nejdriv — typicky
+ *   po xQueueSend do fronty jobu, takze prikaz neceka na dalsi termin.
+ * - Task mezi terminy spi v ulTaskNotifyTake; WDT hlida task, job nesmi
+ *   blokovat dele nez par ms (vyjimka: testovaci sady spustene rucne).
+ *
+ * Joby se registruji z create_system_tasks(); service task vznikne s prvnim.
+ */
+
+#ifndef SVC_LOOP_H
+#define SVC_LOOP_H
+
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Max pocet registrovanych jobu */
+#define SVC_LOOP_MAX_JOBS 8
+/** @brief Navrat jobu: dalsi beh az po svc_job_wake() */
+#define SVC_JOB_IDLE UINT32_MAX
+
+/**
+ * @brief Jeden krok jobu (bezi v service tasku)
+ * @return Za kolik ms job zavolat znovu, nebo SVC_JOB_IDLE
+ */
+typedef uint32_t (*svc_job_fn_t)(void *ctx);
+
+/** @brief Handle jobu (index + 1; 0 = neplatny) */
+typedef uint8_t svc_job_t;
+
+/** @brief Statistiky jobu pro vypis tasku */
+typedef struct {
+  const char *name;
+  uint32_t runs;       ///< Pocet behu
+  uint32_t max_run_us; ///< Nejdelsi beh (blokujici job se tu pozna)
+} svc_job_info_t;
+
+/**
+ * @brief Zaregistruje job; prvni beh za `first_delay_ms` (0 = hned)
+ *
+ * Prvni registrace vytvori service task (SVC_TASK_STACK_SIZE,
+ * SVC_TASK_PRIORITY). Volat z jednoho tasku (boot v main).
+ *
+ * @param[out] out Handle pro svc_job_wake (muze byt NULL)
+ * @return ESP_OK, ESP_ERR_NO_MEM (plna tabulka / task), ESP_ERR_INVALID_ARG
+ */
+esp_err_t svc_job_register(const char *name, svc_job_fn_t fn, void *ctx,
+                           uint32_t first_delay_ms, svc_job_t *out);
+
+/** @brief Spusti job pri nejblizsi prilezitosti (z libovolneho tasku) */
+void svc_job_wake(svc_job_t job);
+
+/** @brief Handle service tasku (NULL pred prvni registraci) */
+TaskHandle_t svc_loop_task_handle(void);
+
+/**
+ * @brief Kopie statistik jobu
+ * @return Pocet zapsanych polozek (nejvys max)
+ */
+size_t svc_loop_get_jobs(svc_job_info_t *out, size_t max);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SVC_LOOP_H */
@@ -0,0 +1,340 @@
+/**
+ * @file json_writer.c
+ * @brief ESP32-C6 Chess System - Streamovy JSON writer
+ *
+ * Jeden pruchod, zadny strlen/strrchr nad vystupem. Pevny buffer hlasi
+ * preteceni chybou misto useknuteho JSON; sink rezim posila po kouscich
+ * velikosti scratch bufferu (typicky 512 B na stacku).
+ *
+ * @author Alfred Krutina
+ * @version 1.8.0
+ * @date 2026-10-18
+ */
+
+#include "json_writer.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ============================================================================
+// INTERNI ZAPIS
+// ============================================================================
+
+/** Uvolni misto: sink = flush, heap = realloc. False = neni kam psat. */
+static bool jw_make_room(json_writer_t *w, size_t need) {
+  /* Pevny buffer a heap si drzi 1 B na NUL. */
+  size_t reserve = (w->sink != NULL) ? 0 : 1;
+  if (w->len + need + reserve <= w->cap) {
+    return true;
+  }
+  if (w->sink != NULL) {
+    if (w->len > 0) {
+      esp_err_t e = w->sink(w->sink_ctx, w->buf, w->len);
+      if (e != ESP_OK) {
+        w->err = e;
+        return false;
+      }
+      w->flushed += w->len;
+      w->len = 0;
+    }
+    return true; /* delsi kus nez scratch jde po castech (jw_put) */
+  }
+  if (w->heap) {
+    size_t ncap = w->cap ? w->cap : 256;
+    while (w->len + need + reserve > ncap) {
+      ncap *= 2;
+    }
+    char *nb = (char *)realloc(w->buf, ncap);
+    if (nb == NULL) {
+      w->err = ESP_ERR_NO_MEM;
+      return false;
+    }
+    w->buf = nb;
+    w->cap = ncap;
+    return true;
+  }
+  w->err = ESP_ERR_NO_MEM;
+  return false;
+}
+
+static void jw_put(json_writer_t *w, const char *data, size_t n) {
+  while (n > 0 && w->err == ESP_OK) {
+    if (!jw_make_room(w, n)) {
+      return;
+    }
+    size_t room = w->cap - w->len - (w->sink != NULL ? 0 : 1);
+    size_t chunk = n < room ? n : room;
+    memcpy(w->buf + w->len, data, chunk);
+    w->len += chunk;
+    data += chunk;
+    n -= chunk;
+  }
+}
+
+static inline void jw_putc(json_writer_t *w, char c) { jw_put(w, &c, 1); }
+
+/** Carka pred dalsim prvkem v aktualnim objektu/poli. */
+static void jw_before_value(json_writer_t *w) {
+  if (w->after_key) {
+    w->after_key = false;
+    return;
+  }
+  uint32_t bit = 1U << w->depth;
+  if (w->has_items & bit) {
+    jw_putc(w, ',');
+  }
+  w->has_items |= bit;
+}
+
+static void jw_put_escaped(json_writer_t *w, const char *s, size_t n) {
+  static const char hex[] = "0123456789abcdef";
+  size_t run = 0;
+  for (size_t i = 0; i < n; i++) {
+    unsigned char c = (unsigned char)s[i];
+    if (c >= 0x20 && c != '"' && c != '\\') {
+      continue;
+    }
+    jw_put(w, s + run, i - run);
+    run = i + 1;
+    char esc[6] = {'\\', 0, 0, 0, 0, 0};
+    size_t elen = 2;
+    switch (c) {
+    case '"':
+      esc[1] = '"';
+      break;
+    case '\\':
+      esc[1] = '\\';
+      break;
+    case '\n':
+      esc[1] = 'n';
+      break;
+    case '\r':
+      esc[1] = 'r';
+      break;
+    case '\t':
+      esc[1] = 't';
+      break;
+    default:
+      esc[1] = 'u';
+      esc[2] = '0';
+      esc[3] = '0';
+      esc[4] = hex[c >> 4];
+      esc[5] = hex[c & 0x0F];
+      elen = 6;
+      break;
+    }
+    jw_put(w, esc, elen);
+  }
+  jw_put(w, s + run, n - run);
+}
+
+static void jw_open(json_writer_t *w, char c) {
+  jw_before_value(w);
+  if (w->depth >= JSON_WRITER_MAX_DEPTH) {
+    w->err = ESP_ERR_INVALID_STATE;
+    return;
+  }
+  jw_putc(w, c);
+  w->depth++;
+  w->has_items &= ~(1U << w->depth);
+}
+
+static void jw_close(json_writer_t *w, char c) {
+  if (w->depth == 0) {
+    w->err = ESP_ERR_INVALID_STATE;
+    return;
+  }
+  w->depth--;
+  w->after_key = false;
+  jw_putc(w, c);
+}
+
+// ============================================================================
+// INICIALIZACE A DOKONCENI
+// ============================================================================
+
+static void jw_reset(json_writer_t *w) { memset(w, 0, sizeof(*w)); }
+
+void json_writer_init_buffer(json_writer_t *w, char *buf, size_t cap) {
+  jw_reset(w);
+  w->buf = buf;
+  w->cap = cap;
+  if (buf == NULL || cap == 0) {
+    w->err = ESP_ERR_INVALID_ARG;
+    return;
+  }
+  buf[0] = '\0';
+}
+
+esp_err_t json_writer_init_heap(json_writer_t *w, size_t initial_cap) {
+  jw_reset(w);
+  w->heap = true;
+  w->cap = initial_cap ? initial_cap : 256;
+  w->buf = (char *)malloc(w->cap);
+  if (w->buf == NULL) {
+    w->cap = 0;
+    w->err = ESP_ERR_NO_MEM;
+  }
+  return w->err;
+}
+
+void json_writer_init_sink(json_writer_t *w, char *scratch, size_t cap,
+                           json_writer_sink_t sink, void *ctx) {
+  jw_reset(w);
+  w->buf = scratch;
+  w->cap = cap;
+  w->sink = sink;
+  w->sink_ctx = ctx;
+  if (scratch == NULL || cap == 0 || sink == NULL) {
+    w->err = ESP_ERR_INVALID_ARG;
+  }
+}
+
+esp_err_t json_writer_finish(json_writer_t *w) {
+  if (w->err == ESP_OK && w->depth != 0) {
+    w->err = ESP_ERR_INVALID_STATE;
+  }
+  if (w->sink != NULL) {
+    if (w->err == ESP_OK && w->len > 0) {
+      esp_err_t e = w->sink(w->sink_ctx, w->buf, w->len);
+      if (e != ESP_OK) {
+        w->err = e;
+      } else {
+        w->flushed += w->len;
+        w->len = 0;
+      }
+    }
+  } else if (w->buf != NULL && w->cap > 0) {
+    w->buf[w->len] = '\0';
+  }
+  return w->err;
+}
+
+char *json_writer_take(json_writer_t *w, size_t *out_len) {
+  if (!w->heap || json_writer_finish(w) != ESP_OK) {
+    json_writer_discard(w);
+    return NULL;
+  }
+  char *out = w->buf;
+  if (out_len != NULL) {
+    *out_len = w->len;
+  }
+  w->buf = NULL;
+  w->cap = 0;
+  w->len = 0;
+  return out;
+}
+
+void json_writer_discard(json_writer_t *w) {
+  if (w->heap) {
+    free(w->buf);
+    w->buf = NULL;
+    w->cap = 0;
+    w->len = 0;
+  }
+}
+
+size_t json_writer_total(const json_writer_t *w) {
+  return w->flushed + w->len;
+}
+
+// ============================================================================
+// STRUKTURA A HODNOTY
+// ============================================================================
+
+void json_writer_begin_object(json_writer_t *w) { jw_open(w, '{'); }
+void json_writer_end_object(json_writer_t *w) { jw_close(w, '}'); }
+void json_writer_begin_array(json_writer_t *w) { jw_open(w, '['); }
+void json_writer_end_array(json_writer_t *w) { jw_close(w, ']'); }
+
+void json_writer_key(json_writer_t *w, const char *key) {
+  jw_before_value(w);
+  jw_putc(w, '"');
+  jw_put_escaped(w, key, strlen(key));
+  jw_put(w, "\":", 2);
+  w->after_key = true;
+}
+
+void json_writer_string_n(json_writer_t *w, const char *s, size_t n) {
+  jw_before_value(w);
+  jw_putc(w, '"');
+  if (s != NULL) {
+    jw_put_escaped(w, s, n);
+  }
+  jw_putc(w, '"');
+}
+
+void json_writer_string(json_writer_t *w, const char *s) {
+  json_writer_string_n(w, s, s != NULL ? strlen(s) : 0);
+}
+
+void json_writer_char(json_writer_t *w, char c) {
+  json_writer_string_n(w, &c, 1);
+}
+
+void json_writer_int(json_writer_t *w, int64_t v) {
+  char num[24];
+  int n = snprintf(num, sizeof(num), "%" PRId64, v);
+  jw_before_value(w);
+  jw_put(w, num, (size_t)n);
+}
+
+void json_writer_uint(json_writer_t *w, uint64_t v) {
+  char num[24];
+  int n = snprintf(num, sizeof(num), "%" PRIu64, v);
+  jw_before_value(w);
+  jw_put(w, num, (size_t)n);
+}
+
+void json_writer_bool(json_writer_t *w, bool v) {
+  jw_before_value(w);
+  if (v) {
+    jw_put(w, "true", 4);
+  } else {
+    jw_put(w, "false", 5);
+  }
+}
+
+void json_writer_null(json_writer_t *w) {
+  jw_before_value(w);
+  jw_put(w, "null", 4);
+}
+
+void json_writer_raw(json_writer_t *w, const char *json, size_t len) {
+  jw_before_value(w);
+  jw_put(w, json, len);
+}
+
+void json_writer_text(json_writer_t *w, const char *s, size_t len) {
+  jw_put(w, s, len);
+  if (w->depth == 0) {
+    w->has_items &= ~1U;
+  }
+}
+
+void json_writer_kv_string(json_writer_t *w, const char *key, const char *s) {
+  json_writer_key(w, key);
+  json_writer_string(w, s);
+}
+
+void json_writer_kv_char(json_writer_t *w, const char *key, char c) {
+  json_writer_key(w, key);
+  json_writer_char(w, c);
+}
+
+void json_writer_kv_int(json_writer_t *w, const char *key, int64_t v) {
+  json_writer_key(w, key);
+  json_writer_int(w, v);
+}
+
+void json_writer_kv_uint(json_writer_t *w, const char *key, uint64_t v) {
+  json_writer_key(w, key);
+  json_writer_uint(w, v);
+}
+
+void json_writer_kv_bool(json_writer_t *w, const char *key, bool v) {
+  json_writer_key(w, key);
+  json_writer_bool(w, v);
+}
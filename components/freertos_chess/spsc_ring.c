@@ -0,0 +1,108 @@
+/**
+ * @file spsc_ring.c
+ * @brief SPSC ring: volne bezici indexy, release/acquire mezi tasky
+ *
+ * Producent zapise prvek a teprve pak posune head (release); konzument
+ * nacte head (acquire), zkopiruje prvek a posune tail (release). Indexy se
+ * maskuji az pri pristupu do bufferu, rozdil head - tail je tak pocet prvku
+ * i po preteceni uint32.
+ */
+
+#include "spsc_ring.h"
+
+#include <string.h>
+
+esp_err_t spsc_ring_init(spsc_ring_t *ring, void *storage, size_t elem_size,
+                         uint32_t capacity) {
+  if (ring == NULL || storage == NULL || elem_size == 0 ||
+      elem_size > UINT16_MAX || capacity < 2 || capacity > 32768 ||
+      (capacity & (capacity - 1)) != 0) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  ring->buf = (uint8_t *)storage;
+  ring->elem_size = (uint16_t)elem_size;
+  ring->mask = (uint16_t)(capacity - 1);
+  atomic_store_explicit(&ring->head, 0U, memory_order_relaxed);
+  atomic_store_explicit(&ring->tail, 0U, memory_order_relaxed);
+  atomic_store_explicit(&ring->drops, 0U, memory_order_relaxed);
+  ring->pushed = 0;
+  ring->high_water = 0;
+  ring->consumer = NULL;
+  return ESP_OK;
+}
+
+void spsc_ring_set_consumer(spsc_ring_t *ring, TaskHandle_t consumer) {
+  ring->consumer = consumer;
+}
+
+bool spsc_ring_push(spsc_ring_t *ring, const void *item) {
+  if (ring->buf == NULL) {
+    return false;
+  }
+  uint32_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+  uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+  uint32_t used = head - tail;
+  if (used > ring->mask) {
+    return false;
+  }
+  memcpy(ring->buf + (size_t)(head & ring->mask) * ring->elem_size, item,
+         ring->elem_size);
+  atomic_store_explicit(&ring->head, head + 1U, memory_order_release);
+
+  ring->pushed++;
+  if (used + 1U > ring->high_water) {
+    ring->high_water = used + 1U;
+  }
+  return true;
+}
+
+bool spsc_ring_push_wait(spsc_ring_t *ring, const void *item,
+                         TickType_t timeout) {
+  TickType_t start = xTaskGetTickCount();
+  while (!spsc_ring_push(ring, item)) {
+    if (ring->buf == NULL || xTaskGetTickCount() - start >= timeout) {
+      atomic_fetch_add_explicit(&ring->drops, 1U, memory_order_relaxed);
+      return false;
+    }
+    /* Konzument ma ring vyprazdnit; vyssi priorita ho spusti hned */
+    spsc_ring_notify(ring);
+    vTaskDelay(1);
+  }
+  return true;
+}
+
+void spsc_ring_notify(spsc_ring_t *ring) {
+  TaskHandle_t consumer = ring->consumer;
+  if (consumer != NULL) {
+    xTaskNotifyGive(consumer);
+  }
+}
+
+bool spsc_ring_pop(spsc_ring_t *ring, void *out) {
+  if (ring->buf == NULL) {
+    return false;
+  }
+  uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+  uint32_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+  if (tail == head) {
+    return false;
+  }
+  memcpy(out, ring->buf + (size_t)(tail & ring->mask) * ring->elem_size,
+         ring->elem_size);
+  atomic_store_explicit(&ring->tail, tail + 1U, memory_order_release);
+  return true;
+}
+
+uint32_t spsc_ring_count(const spsc_ring_t *ring) {
+  uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+  uint32_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+  return head - tail;
+}
+
+void spsc_ring_get_stats(const spsc_ring_t *ring, spsc_ring_stats_t *out) {
+  out->capacity = ring->buf != NULL ? (uint32_t)ring->mask + 1U : 0U;
+  out->used = spsc_ring_count(ring);
+  out->high_water = ring->high_water;
+  out->pushed = ring->pushed;
+  out->drops = atomic_load_explicit(&ring->drops, memory_order_relaxed);
+}
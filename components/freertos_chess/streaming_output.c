@@ -32,6 +32,7 @@
 #include <inttypes.h>
 #include "streaming_output.h"
 #include "chess_types.h"
+#include "game_payload.h"
 #include "led_mapping.h"  // Include LED mapping functions
 
 static const char *TAG = "STREAMING_OUT";
@@ -332,26 +333,18 @@ static esp_err_t stream_write_queue(const char* data, size_t len)
         return ESP_ERR_INVALID_STATE;
     }
 
-    // Actually send data to queue instead of just logging
-    // Create a proper game_response_t message for the queue
+    // Text jde do slotu game_payload.h (delsi blok se zkrati)
+    size_t copy_len = (len > GAME_PAYLOAD_SLOT_SIZE - 1) ? GAME_PAYLOAD_SLOT_SIZE - 1 : len;
     game_response_t response = {
         .type = GAME_RESPONSE_SUCCESS,
         .command_type = GAME_CMD_SHOW_BOARD,  // Default command type
         .error_code = 0,
-        .message = "Streaming data chunk",
+        .text = game_payload_alloc_strn(data, copy_len),
         .timestamp = esp_timer_get_time() / 1000
     };
     
-    // Copy data to response buffer (truncate if too long)
-    size_t max_data_size = sizeof(response.data) - 1;
-    size_t copy_len = (len > max_data_size) ? max_data_size : len;
-    memcpy(response.data, data, copy_len);
-    response.data[copy_len] = '\0';  // Null terminate
-    
     // Send to queue with timeout
-    BaseType_t result = xQueueSend(current_output.queue, &response, pdMS_TO_TICKS(100));
-    
-    if (result != pdTRUE) {
+    if (!game_response_send(current_output.queue, &response, pdMS_TO_TICKS(100))) {
         ESP_LOGW(TAG, "Failed to send streaming data to queue");
         stats.write_errors++;
         return ESP_ERR_TIMEOUT;
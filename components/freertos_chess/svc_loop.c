@@ -0,0 +1,169 @@
+/**
+ * @file svc_loop.c
+ * @brief Service task: joby s terminy a probuzenim pres task notification
+ *
+ * Tabulka jobu je pevne pole; registrace doplni slot a teprve pak zvysi
+ * s_count, takze task cte jen hotove sloty. Priznak wake a pocet jobu jsou
+ * v kratke kriticke sekci, zbytek slotu meni jen service task.
+ */
+
+#include "svc_loop.h"
+#include "freertos_chess.h"
+
+#include "esp_log.h"
+#include "esp_task_wdt.h"
+#include "esp_timer.h"
+
+#include <inttypes.h>
+
+static const char *TAG = "SVC_LOOP";
+
+/** Nejdelsi spanek tasku — WDT se krmi i bez terminu jobu. */
+#define SVC_WDT_FEED_MS 1000
+
+typedef struct {
+  const char *name;
+  svc_job_fn_t fn;
+  void *ctx;
+  TickType_t due;
+  bool idle;          ///< Ceka jen na svc_job_wake
+  volatile bool wake; ///< Nastavuje svc_job_wake (pod s_lock)
+  uint32_t runs;
+  uint32_t max_run_us;
+} svc_job_slot_t;
+
+static svc_job_slot_t s_jobs[SVC_LOOP_MAX_JOBS];
+static uint32_t s_count;
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+static TaskHandle_t s_task;
+
+/** Spusti job; vrati ticky do jeho dalsiho terminu (portMAX_DELAY = idle). */
+static TickType_t svc_run_job(svc_job_slot_t *j, bool due) {
+  int64_t t0 = esp_timer_get_time();
+  uint32_t next_ms = j->fn(j->ctx);
+  uint32_t run_us = (uint32_t)(esp_timer_get_time() - t0);
+  j->runs++;
+  if (run_us > j->max_run_us) {
+    j->max_run_us = run_us;
+  }
+
+  if (next_ms == SVC_JOB_IDLE) {
+    j->idle = true;
+    return portMAX_DELAY;
+  }
+  TickType_t now = xTaskGetTickCount();
+  TickType_t period = pdMS_TO_TICKS(next_ms);
+  /* Od puvodniho terminu (bez driftu); zpozdeny job se nedohani. */
+  TickType_t next = (due ? j->due : now) + period;
+  if ((int32_t)(next - now) < 0) {
+    next = now + period;
+  }
+  j->due = next;
+  j->idle = false;
+  return next - now;
+}
+
+static void svc_task(void *arg) {
+  (void)arg;
+  esp_err_t ret = esp_task_wdt_add(NULL);
+  if (ret != ESP_OK && ret != ESP_ERR_INVALID_ARG) {
+    ESP_LOGW(TAG, "Failed to register with TWDT: %s", esp_err_to_name(ret));
+  }
+
+  for (;;) {
+    esp_task_wdt_reset();
+    TickType_t wait = pdMS_TO_TICKS(SVC_WDT_FEED_MS);
+
+    portENTER_CRITICAL(&s_lock);
+    uint32_t count = s_count;
+    portEXIT_CRITICAL(&s_lock);
+
+    for (uint32_t i = 0; i < count; i++) {
+      svc_job_slot_t *j = &s_jobs[i];
+      portENTER_CRITICAL(&s_lock);
+      bool woken = j->wake;
+      j->wake = false;
+      portEXIT_CRITICAL(&s_lock);
+
+      TickType_t left = portMAX_DELAY;
+      bool due = false;
+      if (!j->idle) {
+        int32_t diff = (int32_t)(j->due - xTaskGetTickCount());
+        due = (diff <= 0);
+        left = due ? 0 : (TickType_t)diff;
+      }
+      if (woken || due) {
+        left = svc_run_job(j, due);
+      }
+      if (left < wait) {
+        wait = left;
+      }
+    }
+
+    ulTaskNotifyTake(pdTRUE, wait);
+  }
+}
+
+esp_err_t svc_job_register(const char *name, svc_job_fn_t fn, void *ctx,
+                           uint32_t first_delay_ms, svc_job_t *out) {
+  if (name == NULL || fn == NULL) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  if (s_count >= SVC_LOOP_MAX_JOBS) {
+    ESP_LOGE(TAG, "Job table full (%d) - '%s' not registered",
+             SVC_LOOP_MAX_JOBS, name);
+    return ESP_ERR_NO_MEM;
+  }
+  if (s_task == NULL &&
+      xTaskCreate(svc_task, "svc_task", SVC_TASK_STACK_SIZE, NULL,
+                  SVC_TASK_PRIORITY, &s_task) != pdPASS) {
+    s_task = NULL;
+    ESP_LOGE(TAG, "Failed to create service task");
+    return ESP_ERR_NO_MEM;
+  }
+
+  uint32_t idx = s_count;
+  svc_job_slot_t *j = &s_jobs[idx];
+  j->name = name;
+  j->fn = fn;
+  j->ctx = ctx;
+  j->due = xTaskGetTickCount() + pdMS_TO_TICKS(first_delay_ms);
+  j->idle = false;
+  j->wake = false;
+  j->runs = 0;
+  j->max_run_us = 0;
+
+  portENTER_CRITICAL(&s_lock);
+  s_count = idx + 1;
+  portEXIT_CRITICAL(&s_lock);
+  xTaskNotifyGive(s_task);
+
+  if (out != NULL) {
+    *out = (svc_job_t)(idx + 1);
+  }
+  ESP_LOGI(TAG, "Job '%s' registered (%" PRIu32 "/%d)", name, idx + 1,
+           SVC_LOOP_MAX_JOBS);
+  return ESP_OK;
+}
+
+void svc_job_wake(svc_job_t job) {
+  if (job == 0 || job > s_count || s_task == NULL) {
+    return;
+  }
+  portENTER_CRITICAL(&s_lock);
+  s_jobs[job - 1].wake = true;
+  portEXIT_CRITICAL(&s_lock);
+  xTaskNotifyGive(s_task);
+}
+
+TaskHandle_t svc_loop_task_handle(void) { return s_task; }
+
+size_t svc_loop_get_jobs(svc_job_info_t *out, size_t max) {
+  size_t n = 0;
+  for (uint32_t i = 0; i < s_count && n < max; i++, n++) {
+    out[n].name = s_jobs[i].name;
+    out[n].runs = s_jobs[i].runs;
+    out[n].max_run_us = s_jobs[i].max_run_us;
+  }
+  return n;
+}
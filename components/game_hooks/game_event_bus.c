@@ -0,0 +1,130 @@
+/**
+ * @file game_event_bus.c
+ * @brief Lock-free ring herních událostí: jeden producent, N kurzorů.
+ *
+ * Producent zapisuje slot jako seqlock: nejdřív `seq = 0` (zápis probíhá),
+ * pak data, nakonec `seq` události s release. Čtenář porovná `seq` slotu před
+ * a po kopii — nesouhlas znamená, že ho producent mezitím přepsal (přetečení).
+ * Producent nikdy nečeká na čtenáře; head je jediný sdílený zápis navíc.
+ */
+#include "game_event_bus.h"
+
+#include <stdatomic.h>
+#include <string.h>
+
+_Static_assert((GAME_EVENT_BUS_CAPACITY & (GAME_EVENT_BUS_CAPACITY - 1)) == 0,
+               "GAME_EVENT_BUS_CAPACITY musí být mocnina 2");
+
+#define GAME_EVENT_BUS_MASK (GAME_EVENT_BUS_CAPACITY - 1U)
+
+typedef struct {
+  _Atomic uint32_t seq; ///< seq uložené události, 0 = zápis probíhá / prázdný
+  game_event_t ev;
+} game_event_slot_t;
+
+static game_event_slot_t s_ring[GAME_EVENT_BUS_CAPACITY];
+static _Atomic uint32_t s_head;
+
+uint32_t game_event_publish(const game_event_t *ev) {
+  if (ev == NULL) {
+    return 0;
+  }
+  /* Jediný producent — head čte jen on sám, relaxed stačí. */
+  uint32_t seq = atomic_load_explicit(&s_head, memory_order_relaxed) + 1U;
+  if (seq == 0U) {
+    seq = 1U; /* 0 = „prázdný slot“; přetečení uint32 po ~136 letech tiku */
+  }
+  game_event_slot_t *slot = &s_ring[seq & GAME_EVENT_BUS_MASK];
+  atomic_store_explicit(&slot->seq, 0U, memory_order_relaxed);
+  atomic_thread_fence(memory_order_release);
+  slot->ev = *ev;
+  slot->ev.seq = seq;
+  atomic_store_explicit(&slot->seq, seq, memory_order_release);
+  atomic_store_explicit(&s_head, seq, memory_order_release);
+  return seq;
+}
+
+uint32_t game_event_bus_head(void) {
+  return atomic_load_explicit(&s_head, memory_order_acquire);
+}
+
+void game_event_cursor_init(game_event_cursor_t *cursor) {
+  if (cursor == NULL) {
+    return;
+  }
+  cursor->next_seq = game_event_bus_head() + 1U;
+  cursor->lost = 0;
+}
+
+game_event_read_t game_event_next(game_event_cursor_t *cursor,
+                                  game_event_t *out) {
+  if (cursor == NULL || out == NULL) {
+    return GAME_EVENT_READ_EMPTY;
+  }
+  uint32_t head = game_event_bus_head();
+  if ((int32_t)(head - cursor->next_seq) < 0) {
+    return GAME_EVENT_READ_EMPTY;
+  }
+  if (head - cursor->next_seq >= GAME_EVENT_BUS_CAPACITY) {
+    uint32_t oldest = head - GAME_EVENT_BUS_CAPACITY + 1U;
+    cursor->lost += oldest - cursor->next_seq;
+    cursor->next_seq = oldest;
+    return GAME_EVENT_READ_OVERRUN;
+  }
+
+  const game_event_slot_t *slot = &s_ring[cursor->next_seq & GAME_EVENT_BUS_MASK];
+  uint32_t before = atomic_load_explicit(&slot->seq, memory_order_acquire);
+  if (before != cursor->next_seq) {
+    /* Slot už patří novější události (producent obkroužil ring). */
+    cursor->lost++;
+    cursor->next_seq = game_event_bus_head() - GAME_EVENT_BUS_CAPACITY + 2U;
+    return GAME_EVENT_READ_OVERRUN;
+  }
+  memcpy(out, &slot->ev, sizeof(*out));
+  atomic_thread_fence(memory_order_acquire);
+  uint32_t after = atomic_load_explicit(&slot->seq, memory_order_relaxed);
+  if (after != before) {
+    cursor->lost++;
+    cursor->next_seq = game_event_bus_head() - GAME_EVENT_BUS_CAPACITY + 2U;
+    return GAME_EVENT_READ_OVERRUN;
+  }
+  cursor->next_seq++;
+  return GAME_EVENT_READ_OK;
+}
+
+const char *game_event_type_name(uint8_t type) {
+  switch (type) {
+  case GAME_EVENT_MOVE_COMMITTED:
+    return "move";
+  case GAME_EVENT_MOVE_UNDONE:
+    return "undo";
+  case GAME_EVENT_PIECE_LIFTED:
+    return "piece_lifted";
+  case GAME_EVENT_PIECE_PLACED:
+    return "piece_placed";
+  case GAME_EVENT_CLOCK_TICK:
+    return "clock";
+  case GAME_EVENT_GAME_STARTED:
+    return "game_started";
+  case GAME_EVENT_GAME_ENDED:
+    return "game_ended";
+  case GAME_EVENT_SETTING_CHANGED:
+    return "setting";
+  case GAME_EVENT_STATE_CHANGED:
+    return "state";
+  default:
+    return "none";
+  }
+}
+
+bool game_event_type_bumps_revision(uint8_t type) {
+  switch (type) {
+  case GAME_EVENT_PIECE_LIFTED:
+  case GAME_EVENT_PIECE_PLACED:
+  case GAME_EVENT_CLOCK_TICK:
+  case GAME_EVENT_NONE:
+    return false;
+  default:
+    return type < GAME_EVENT_TYPE_COUNT;
+  }
+}
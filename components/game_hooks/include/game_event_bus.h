@@ -0,0 +1,122 @@
+/**
+ * @file game_event_bus.h
+ * @brief Typovaná sběrnice herních událostí (event-sourced notifikace).
+ *
+ * Jediný producent (game_task) zapisuje strukturované události se sekvenčním
+ * číslem do kruhového bufferu bez zámku; každý odběratel čte vlastním
+ * kurzorem (web server, BLE, lampa, …) a aktualizuje jen to, co se změnilo.
+ * Pomalý odběratel producenta nebrzdí — při přetečení dostane
+ * GAME_EVENT_READ_OVERRUN a udělá plný resync (snapshot), jako dřív.
+ *
+ * Záměrně bez závislosti na chess_types.h: pole = index row*8+col,
+ * figurka = znak FEN ('P', 'n', …), 0 = žádná.
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Kapacita ringu (mocnina 2); ~1 s provozu i při rychlých tazích a tiku hodin. */
+#define GAME_EVENT_BUS_CAPACITY 64
+
+/** Pole mimo desku (např. žádná figurka zvednutá). */
+#define GAME_EVENT_SQUARE_NONE 0xFF
+
+typedef enum {
+  GAME_EVENT_NONE = 0,
+  GAME_EVENT_MOVE_COMMITTED, ///< Tah proveden (u.move)
+  GAME_EVENT_MOVE_UNDONE,    ///< Undo (u.move.ply = nový počet tahů)
+  GAME_EVENT_PIECE_LIFTED,   ///< Figurka zvednuta (u.piece), revize se nemění
+  GAME_EVENT_PIECE_PLACED,   ///< Figurka položena (u.piece), revize se nemění
+  GAME_EVENT_CLOCK_TICK,     ///< Hodiny 1× za s při běžícím timeru (u.clock)
+  GAME_EVENT_GAME_STARTED,   ///< Nová hra / reset / deska sestavena
+  GAME_EVENT_GAME_ENDED,     ///< Konec hry (u.ended)
+  GAME_EVENT_SETTING_CHANGED, ///< Změna nastavení hry (u.setting)
+  GAME_EVENT_STATE_CHANGED,  ///< Jiná změna stavu (guard, čekání na desku, …)
+  GAME_EVENT_TYPE_COUNT,
+} game_event_type_t;
+
+/** Klíče pro GAME_EVENT_SETTING_CHANGED. */
+typedef enum {
+  GAME_SETTING_TIME_CONTROL = 1, ///< value = time_control_type_t
+  GAME_SETTING_TIMER_PAUSED,     ///< value = 1 pozastaveno, 0 běží
+  GAME_SETTING_TIMER_RESET,      ///< value = 0
+} game_setting_key_t;
+
+typedef struct {
+  uint32_t seq;          ///< Pořadí na sběrnici (od 1, přiděluje publish)
+  uint32_t revision;     ///< game_get_state_revision() po události
+  uint32_t timestamp_ms; ///< Uptime v ms
+  uint8_t type;          ///< game_event_type_t
+  union {
+    struct {
+      uint8_t from;     ///< row*8+col
+      uint8_t to;
+      char piece;       ///< Tažená figurka (FEN znak)
+      char captured;    ///< 0 = bez braní
+      uint16_t ply;     ///< Počet půltahů po události
+    } move;
+    struct {
+      uint8_t square;
+      char piece;
+    } piece;
+    struct {
+      uint32_t white_ms;
+      uint32_t black_ms;
+      bool white_to_move;
+    } clock;
+    struct {
+      uint8_t result; ///< game_result_type_t
+      uint8_t reason; ///< endgame_reason_t
+    } ended;
+    struct {
+      uint16_t key; ///< game_setting_key_t
+      int32_t value;
+    } setting;
+  } u;
+} game_event_t;
+
+/** Kurzor odběratele — vlastní ho odběratel, sběrnice o něm neví. */
+typedef struct {
+  uint32_t next_seq; ///< Další očekávané seq
+  uint32_t lost;     ///< Celkem přeskočených událostí (přetečení)
+} game_event_cursor_t;
+
+typedef enum {
+  GAME_EVENT_READ_OK = 0,  ///< `out` platné, kurzor posunut
+  GAME_EVENT_READ_EMPTY,   ///< Nic nového
+  GAME_EVENT_READ_OVERRUN, ///< Producent kurzor předběhl — plný resync; kurzor
+                           ///< je posunut na nejstarší dostupnou událost
+} game_event_read_t;
+
+/**
+ * @brief Zveřejní událost (jen z jednoho tasku — game_task)
+ *
+ * Doplní `seq`; `revision` a `timestamp_ms` vyplňuje volající.
+ * @return přidělené seq
+ */
+uint32_t game_event_publish(const game_event_t *ev);
+
+/** @brief Seq poslední zveřejněné události (0 = zatím žádná) */
+uint32_t game_event_bus_head(void);
+
+/** @brief Kurzor od příští události (starší historie se nečte) */
+void game_event_cursor_init(game_event_cursor_t *cursor);
+
+/** @brief Přečte další událost pro kurzor; volatelné z libovolného tasku */
+game_event_read_t game_event_next(game_event_cursor_t *cursor,
+                                  game_event_t *out);
+
+/** @brief Krátký název typu pro log / JSON ("move", "piece_lifted", …) */
+const char *game_event_type_name(uint8_t type);
+
+/** @brief Mění událost herní stav ve snapshotu (bump revize)? */
+bool game_event_type_bumps_revision(uint8_t type);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,950 @@
+/**
+ * @file game_archive.c
+ * @brief Archiv her na LittleFS: serazeny index + append-only datovy soubor.
+ *
+ * Zaznam hry: archive_record_t (deska po 4 bitech, priznaky, casy) a za nim
+ * ARCHIVE_PLY_SIZE B na pultah. CRC32 kryje vse za polem crc32.
+ * Index: archive_index_header_t a count × game_archive_entry_t podle strcmp.
+ *
+ * Zamek s_lock chrani mount i oba soubory: persist task (SAVE/DELETE/kompakce),
+ * game_task (LOAD) a ctenari indexu (UART, HTTP, BLE).
+ */
+
+#include "game_archive.h"
+#include "game_task_internal.h"
+
+#include "config_persist.h"
+#include "esp_littlefs.h"
+#include "esp_log.h"
+#include "esp_rom_crc.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+#include <errno.h>
+#include <inttypes.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+static const char *TAG = "GAME_ARCHIVE";
+
+#define ARCHIVE_INDEX_PATH GAME_ARCHIVE_BASE_PATH "/games.idx"
+#define ARCHIVE_INDEX_TMP_PATH GAME_ARCHIVE_BASE_PATH "/games.idx.tmp"
+#define ARCHIVE_INDEX_MAGIC 0x31584947u  /* "GIX1" */
+#define ARCHIVE_RECORD_MAGIC 0x31435247u /* "GRC1" */
+#define ARCHIVE_VERSION 1
+/** from 6b | to 6b | piece 4b | captured 4b | kind 3b → 3 B na pultah. */
+#define ARCHIVE_PLY_SIZE 3
+/** Kompakce az od tolika bajtu garbage (a zaroven > polovina dat). */
+#define ARCHIVE_COMPACT_MIN_GARBAGE (32 * 1024)
+/** Unix cas pred timto = hodiny nejsou nastavene (bez SNTP). */
+#define ARCHIVE_MIN_VALID_TIME 1600000000
+
+enum {
+  ARCHIVE_OP_SAVE = 1,
+  ARCHIVE_OP_DELETE = 2,
+};
+
+typedef struct __attribute__((packed)) {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t count;
+  uint32_t data_gen;  ///< Aktualni datovy soubor games.<gen>.dat
+  uint32_t data_size; ///< Konec platnych dat = offset dalsiho zaznamu
+  uint32_t garbage;   ///< Bajty prepsanych / smazanych zaznamu
+} archive_index_header_t;
+
+typedef struct __attribute__((packed)) {
+  uint32_t magic;
+  uint32_t crc32; ///< esp_rom_crc32_le pres zbytek zaznamu vcetne tahu
+  char name[GAME_ARCHIVE_NAME_MAX];
+  uint32_t saved_at;
+  uint32_t move_count;
+  uint32_t white_time_total;
+  uint32_t black_time_total;
+  uint16_t plies;
+  uint8_t result;
+  uint8_t result_type; ///< game_result_type_t (platne u ukoncene hry)
+  uint8_t current_player;
+  uint8_t game_state;
+  uint8_t castling; ///< bit 0-5: WK, WRa, WRh, BK, BRa, BRh se pohnuly
+  uint8_t ep[5];    ///< available, target row/col, victim row/col
+  uint8_t board[32]; ///< Pole i v nizsich 4 bitech bajtu i/2 pro sude i
+} archive_record_t;
+
+#define ARCHIVE_RECORD_MAX                                                     \
+  (sizeof(archive_record_t) + GAME_TASK_MAX_MOVES_HISTORY * ARCHIVE_PLY_SIZE)
+
+/** Payload persist pozadavku: hlavicka + (u SAVE) zaznam. */
+typedef struct __attribute__((packed)) {
+  uint8_t op;
+  char name[GAME_ARCHIVE_NAME_MAX];
+} archive_job_t;
+
+_Static_assert(sizeof(game_archive_entry_t) == 40,
+               "format indexu na disku se nesmi zmenit");
+_Static_assert(GAME_TASK_MAX_MOVES_HISTORY <= UINT16_MAX,
+               "plies se uklada do uint16_t");
+
+static StaticSemaphore_t s_lock_buf;
+static SemaphoreHandle_t s_lock;
+static bool s_mounted;
+static bool s_mount_failed;
+static uint32_t s_job_seq;
+static uint32_t s_jobs_pending; ///< Pod s_lock; SAVE/DELETE jeste v persist fronte
+
+/* Pod s_lock: cteni/zapis zaznamu. Mimo zamek: stavba jobu v game_task. */
+static uint8_t s_io_buf[ARCHIVE_RECORD_MAX];
+static uint8_t s_job_buf[sizeof(archive_job_t) + ARCHIVE_RECORD_MAX];
+
+// ============================================================================
+// MOUNT, ZAMEK, POMOCNE
+// ============================================================================
+
+void game_archive_init(void) {
+  if (s_lock == NULL) {
+    s_lock = xSemaphoreCreateMutexStatic(&s_lock_buf);
+  }
+}
+
+/** Pod zamkem: pripoji LittleFS (pri chybe jen jednou za boot). */
+static bool archive_mount_locked(void) {
+  if (s_mounted || s_mount_failed) {
+    return s_mounted;
+  }
+  esp_vfs_littlefs_conf_t conf = {
+      .base_path = GAME_ARCHIVE_BASE_PATH,
+      .partition_label = GAME_ARCHIVE_PARTITION_LABEL,
+      .format_if_mount_failed = true,
+      .dont_mount = false,
+  };
+  esp_err_t ret = esp_vfs_littlefs_register(&conf);
+  if (ret != ESP_OK) {
+    ESP_LOGW(TAG, "LittleFS '%s' nepripojen: %s — archiv her vypnut",
+             GAME_ARCHIVE_PARTITION_LABEL, esp_err_to_name(ret));
+    s_mount_failed = true;
+    return false;
+  }
+  size_t total = 0;
+  size_t used = 0;
+  (void)esp_littlefs_info(GAME_ARCHIVE_PARTITION_LABEL, &total, &used);
+  ESP_LOGI(TAG, "LittleFS %s: %u / %u B", GAME_ARCHIVE_BASE_PATH,
+           (unsigned)used, (unsigned)total);
+  s_mounted = true;
+  return true;
+}
+
+static bool archive_lock(void) {
+  if (s_lock == NULL) {
+    return false;
+  }
+  xSemaphoreTake(s_lock, portMAX_DELAY);
+  if (!archive_mount_locked()) {
+    xSemaphoreGive(s_lock);
+    return false;
+  }
+  return true;
+}
+
+static void archive_unlock(void) { xSemaphoreGive(s_lock); }
+
+static void archive_pending_add(int32_t delta) {
+  if (s_lock == NULL) {
+    return;
+  }
+  xSemaphoreTake(s_lock, portMAX_DELAY);
+  s_jobs_pending = (delta < 0 && s_jobs_pending == 0)
+                       ? 0
+                       : (uint32_t)((int32_t)s_jobs_pending + delta);
+  xSemaphoreGive(s_lock);
+}
+
+static bool archive_has_pending(void) {
+  if (s_lock == NULL) {
+    return false;
+  }
+  xSemaphoreTake(s_lock, portMAX_DELAY);
+  bool pending = s_jobs_pending > 0;
+  xSemaphoreGive(s_lock);
+  return pending;
+}
+
+bool game_archive_available(void) {
+  if (!archive_lock()) {
+    return false;
+  }
+  archive_unlock();
+  return true;
+}
+
+bool game_archive_name_valid(const char *name) {
+  if (name == NULL || name[0] == '\0') {
+    return false;
+  }
+  size_t len = 0;
+  for (const char *p = name; *p != '\0'; p++, len++) {
+    char c = *p;
+    bool ok = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+              (c >= '0' && c <= '9') || c == '_' || c == '-' || c == '.';
+    if (!ok || len + 1 >= GAME_ARCHIVE_NAME_MAX) {
+      return false;
+    }
+  }
+  return true;
+}
+
+const char *game_archive_result_str(uint8_t result) {
+  switch (result) {
+  case GAME_ARCHIVE_RESULT_WHITE_WINS:
+    return "1-0";
+  case GAME_ARCHIVE_RESULT_BLACK_WINS:
+    return "0-1";
+  case GAME_ARCHIVE_RESULT_DRAW:
+    return "1/2-1/2";
+  default:
+    return "*";
+  }
+}
+
+static void archive_data_path(char *out, size_t cap, uint32_t gen) {
+  snprintf(out, cap, GAME_ARCHIVE_BASE_PATH "/games.%" PRIu32 ".dat", gen);
+}
+
+static uint32_t archive_record_crc(const uint8_t *rec, size_t len) {
+  size_t skip = offsetof(archive_record_t, crc32) + sizeof(uint32_t);
+  return esp_rom_crc32_le(0, rec + skip, len - skip);
+}
+
+/**
+ * Pod zamkem: otevre index a nacte hlavicku. Chybejici index = prazdny
+ * archiv (*idx_out NULL, hlavicka vychozi).
+ */
+static esp_err_t archive_open_index(FILE **idx_out,
+                                    archive_index_header_t *hdr) {
+  memset(hdr, 0, sizeof(*hdr));
+  hdr->magic = ARCHIVE_INDEX_MAGIC;
+  hdr->version = ARCHIVE_VERSION;
+  *idx_out = NULL;
+
+  FILE *f = fopen(ARCHIVE_INDEX_PATH, "rb");
+  if (f == NULL) {
+    return errno == ENOENT ? ESP_OK : ESP_FAIL;
+  }
+  archive_index_header_t h;
+  if (fread(&h, sizeof(h), 1, f) != 1 || h.magic != ARCHIVE_INDEX_MAGIC ||
+      h.version != ARCHIVE_VERSION || h.count > GAME_ARCHIVE_MAX_GAMES) {
+    fclose(f);
+    ESP_LOGE(TAG, "poskozeny %s", ARCHIVE_INDEX_PATH);
+    return ESP_ERR_INVALID_STATE;
+  }
+  *hdr = h;
+  *idx_out = f;
+  return ESP_OK;
+}
+
+static bool archive_read_entry(FILE *idx, uint32_t pos,
+                               game_archive_entry_t *e) {
+  long off = (long)(sizeof(archive_index_header_t) +
+                    (size_t)pos * sizeof(game_archive_entry_t));
+  return fseek(idx, off, SEEK_SET) == 0 && fread(e, sizeof(*e), 1, idx) == 1;
+}
+
+/**
+ * Binarni hledani jmena v indexu (log2(count) ctení po 40 B).
+ * @param[out] pos_out Pozice nalezene hry, jinak misto pro vlozeni
+ */
+static bool archive_find(FILE *idx, const archive_index_header_t *hdr,
+                         const char *name, game_archive_entry_t *found,
+                         uint32_t *pos_out) {
+  uint32_t lo = 0;
+  uint32_t hi = (idx != NULL) ? hdr->count : 0;
+  while (lo < hi) {
+    uint32_t mid = lo + (hi - lo) / 2;
+    game_archive_entry_t e;
+    if (!archive_read_entry(idx, mid, &e)) {
+      break;
+    }
+    int cmp = strncmp(name, e.name, GAME_ARCHIVE_NAME_MAX);
+    if (cmp == 0) {
+      if (found != NULL) {
+        *found = e;
+      }
+      *pos_out = mid;
+      return true;
+    }
+    if (cmp < 0) {
+      hi = mid;
+    } else {
+      lo = mid + 1;
+    }
+  }
+  *pos_out = lo;
+  return false;
+}
+
+/**
+ * Pod zamkem: zapise novy index do .tmp a rename pres stary (atomicky).
+ * Stary zaznam na `skip_pos` vynecha, `insert` vlozi pred `insert_pos`.
+ * `old` (muze byt NULL) vzdy zavre.
+ */
+static esp_err_t archive_rewrite_index(FILE *old,
+                                       const archive_index_header_t *old_hdr,
+                                       const archive_index_header_t *new_hdr,
+                                       int32_t skip_pos,
+                                       const game_archive_entry_t *insert,
+                                       uint32_t insert_pos) {
+  FILE *out = fopen(ARCHIVE_INDEX_TMP_PATH, "wb");
+  if (out == NULL) {
+    if (old != NULL) {
+      fclose(old);
+    }
+    return ESP_FAIL;
+  }
+  bool ok = fwrite(new_hdr, sizeof(*new_hdr), 1, out) == 1;
+  uint32_t old_count = (old != NULL) ? old_hdr->count : 0;
+  if (ok && old != NULL) {
+    ok = fseek(old, sizeof(archive_index_header_t), SEEK_SET) == 0;
+  }
+  for (uint32_t i = 0; ok && i <= old_count; i++) {
+    if (insert != NULL && i == insert_pos) {
+      ok = fwrite(insert, sizeof(*insert), 1, out) == 1;
+    }
+    if (!ok || i == old_count) {
+      break;
+    }
+    game_archive_entry_t e;
+    ok = fread(&e, sizeof(e), 1, old) == 1;
+    if (ok && (int32_t)i != skip_pos) {
+      ok = fwrite(&e, sizeof(e), 1, out) == 1;
+    }
+  }
+  if (fclose(out) != 0) {
+    ok = false;
+  }
+  if (old != NULL) {
+    fclose(old); /* LittleFS: rename pres otevreny soubor neprojde */
+  }
+  if (!ok) {
+    remove(ARCHIVE_INDEX_TMP_PATH);
+    return ESP_FAIL;
+  }
+  if (rename(ARCHIVE_INDEX_TMP_PATH, ARCHIVE_INDEX_PATH) != 0) {
+    remove(ARCHIVE_INDEX_TMP_PATH);
+    return ESP_FAIL;
+  }
+  return ESP_OK;
+}
+
+/** Pod zamkem: prepise zive zaznamy do games.<gen+1>.dat a prepne index. */
+static esp_err_t archive_compact(void) {
+  FILE *idx = NULL;
+  archive_index_header_t hdr;
+  esp_err_t ret = archive_open_index(&idx, &hdr);
+  if (ret != ESP_OK || idx == NULL) {
+    return ret;
+  }
+  char old_path[40];
+  char new_path[40];
+  archive_data_path(old_path, sizeof(old_path), hdr.data_gen);
+  archive_data_path(new_path, sizeof(new_path), hdr.data_gen + 1);
+  FILE *in = fopen(old_path, "rb");
+  FILE *out = fopen(new_path, "wb");
+  FILE *tmp = fopen(ARCHIVE_INDEX_TMP_PATH, "wb");
+
+  archive_index_header_t new_hdr = hdr;
+  new_hdr.data_gen = hdr.data_gen + 1;
+  new_hdr.data_size = 0;
+  new_hdr.garbage = 0;
+  bool ok = in != NULL && out != NULL && tmp != NULL &&
+            fwrite(&new_hdr, sizeof(new_hdr), 1, tmp) == 1;
+  for (uint32_t i = 0; ok && i < hdr.count; i++) {
+    game_archive_entry_t e;
+    ok = archive_read_entry(idx, i, &e) && e.length <= sizeof(s_io_buf) &&
+         fseek(in, (long)e.offset, SEEK_SET) == 0 &&
+         fread(s_io_buf, e.length, 1, in) == 1 &&
+         fwrite(s_io_buf, e.length, 1, out) == 1;
+    if (ok) {
+      e.offset = new_hdr.data_size;
+      new_hdr.data_size += e.length;
+      ok = fwrite(&e, sizeof(e), 1, tmp) == 1;
+    }
+  }
+  if (ok) {
+    ok = fseek(tmp, 0, SEEK_SET) == 0 &&
+         fwrite(&new_hdr, sizeof(new_hdr), 1, tmp) == 1;
+  }
+  fclose(idx);
+  if (in != NULL) {
+    fclose(in);
+  }
+  if (out != NULL && fclose(out) != 0) {
+    ok = false;
+  }
+  if (tmp != NULL && fclose(tmp) != 0) {
+    ok = false;
+  }
+  if (!ok || rename(ARCHIVE_INDEX_TMP_PATH, ARCHIVE_INDEX_PATH) != 0) {
+    remove(ARCHIVE_INDEX_TMP_PATH);
+    remove(new_path);
+    ESP_LOGW(TAG, "kompakce selhala — archiv beze zmeny");
+    return ESP_FAIL;
+  }
+  remove(old_path);
+  ESP_LOGI(TAG, "kompakce: %u her, %" PRIu32 " -> %" PRIu32 " B",
+           (unsigned)hdr.count, hdr.data_size, new_hdr.data_size);
+  return ESP_OK;
+}
+
+static void archive_maybe_compact(const archive_index_header_t *hdr) {
+  if (hdr->garbage >= ARCHIVE_COMPACT_MIN_GARBAGE &&
+      hdr->garbage > hdr->data_size / 2) {
+    (void)archive_compact();
+  }
+}
+
+// ============================================================================
+// ZAPIS (persist task)
+// ============================================================================
+
+static esp_err_t archive_apply_save(const archive_job_t *job,
+                                    const uint8_t *rec, size_t rec_len) {
+  const archive_record_t *r = (const archive_record_t *)rec;
+  FILE *idx = NULL;
+  archive_index_header_t hdr;
+  esp_err_t ret = archive_open_index(&idx, &hdr);
+  if (ret != ESP_OK) {
+    return ret;
+  }
+  game_archive_entry_t old;
+  uint32_t pos = 0;
+  bool replace = archive_find(idx, &hdr, job->name, &old, &pos);
+  if (!replace && hdr.count >= GAME_ARCHIVE_MAX_GAMES) {
+    if (idx != NULL) {
+      fclose(idx);
+    }
+    return ESP_ERR_NO_MEM;
+  }
+
+  /* Data za konec platne casti; nedokonceny zapis index nikdy neuvidi. */
+  char path[40];
+  archive_data_path(path, sizeof(path), hdr.data_gen);
+  FILE *dat = fopen(path, "r+b");
+  if (dat == NULL) {
+    dat = fopen(path, "w+b");
+  }
+  bool ok = dat != NULL && fseek(dat, (long)hdr.data_size, SEEK_SET) == 0 &&
+            fwrite(rec, rec_len, 1, dat) == 1;
+  if (dat != NULL && fclose(dat) != 0) {
+    ok = false;
+  }
+  if (!ok) {
+    if (idx != NULL) {
+      fclose(idx);
+    }
+    return ESP_FAIL;
+  }
+
+  game_archive_entry_t e = {0};
+  memcpy(e.name, job->name, sizeof(e.name));
+  e.saved_at = r->saved_at;
+  e.offset = hdr.data_size;
+  e.length = (uint32_t)rec_len;
+  e.plies = r->plies;
+  e.result = r->result;
+
+  archive_index_header_t new_hdr = hdr;
+  new_hdr.data_size += (uint32_t)rec_len;
+  if (replace) {
+    new_hdr.garbage += old.length;
+  } else {
+    new_hdr.count++;
+  }
+  ret = archive_rewrite_index(idx, &hdr, &new_hdr, replace ? (int32_t)pos : -1,
+                              &e, pos);
+  if (ret != ESP_OK) {
+    return ret;
+  }
+  archive_maybe_compact(&new_hdr);
+  return ESP_OK;
+}
+
+static esp_err_t archive_apply_delete(const archive_job_t *job) {
+  FILE *idx = NULL;
+  archive_index_header_t hdr;
+  esp_err_t ret = archive_open_index(&idx, &hdr);
+  if (ret != ESP_OK) {
+    return ret;
+  }
+  game_archive_entry_t old;
+  uint32_t pos = 0;
+  if (!archive_find(idx, &hdr, job->name, &old, &pos)) {
+    if (idx != NULL) {
+      fclose(idx);
+    }
+    return ESP_ERR_NOT_FOUND;
+  }
+  archive_index_header_t new_hdr = hdr;
+  new_hdr.count--;
+  new_hdr.garbage += old.length;
+  ret = archive_rewrite_index(idx, &hdr, &new_hdr, (int32_t)pos, NULL, 0);
+  if (ret != ESP_OK) {
+    return ret;
+  }
+  archive_maybe_compact(&new_hdr);
+  return ESP_OK;
+}
+
+/** config_persist_write_fn: SAVE / DELETE v persist tasku. */
+static esp_err_t archive_job(const char *key, const void *data, size_t len) {
+  (void)key;
+  esp_err_t ret = ESP_ERR_INVALID_SIZE;
+  const archive_job_t *job = (const archive_job_t *)data;
+  if (len >= sizeof(*job)) {
+    if (!archive_lock()) {
+      ret = ESP_ERR_NOT_FOUND;
+    } else {
+      if (job->op == ARCHIVE_OP_SAVE && len > sizeof(*job)) {
+        ret = archive_apply_save(job, (const uint8_t *)data + sizeof(*job),
+                                 len - sizeof(*job));
+      } else if (job->op == ARCHIVE_OP_DELETE) {
+        ret = archive_apply_delete(job);
+      }
+      archive_unlock();
+    }
+    ESP_LOGI(TAG, "%s '%.*s': %s",
+             job->op == ARCHIVE_OP_SAVE ? "save" : "delete",
+             GAME_ARCHIVE_NAME_MAX, job->name, esp_err_to_name(ret));
+  }
+  archive_pending_add(-1);
+  return ret;
+}
+
+/** Kazdy job vlastni klic → zadne slucovani, FIFO v ramci priority. */
+static esp_err_t archive_submit(size_t len) {
+  char key[CONFIG_PERSIST_KEY_MAX];
+  snprintf(key, sizeof(key), "g_arch_%" PRIx32, ++s_job_seq);
+  bool async = config_persist_is_running();
+  archive_pending_add(1); /* archive_job ho snizi i pri synchronnim zapisu */
+  esp_err_t ret = config_persist_submit(key, archive_job, s_job_buf, len,
+                                        CONFIG_PERSIST_PRIO_NORMAL, NULL);
+  if (ret != ESP_OK && async) {
+    /* Nezarazeno (plna fronta) — archive_job nepobezi a pending nesnizi. */
+    archive_pending_add(-1);
+  }
+  return ret;
+}
+
+// ============================================================================
+// ULOZENI / NACTENI (game_task)
+// ============================================================================
+
+static uint8_t archive_current_result(void) {
+  if (current_game_state != GAME_STATE_FINISHED) {
+    return GAME_ARCHIVE_RESULT_ONGOING;
+  }
+  switch (current_result_type) {
+  case RESULT_WHITE_WINS:
+    return GAME_ARCHIVE_RESULT_WHITE_WINS;
+  case RESULT_BLACK_WINS:
+    return GAME_ARCHIVE_RESULT_BLACK_WINS;
+  default:
+    return GAME_ARCHIVE_RESULT_DRAW;
+  }
+}
+
+static void archive_ply_pack(const chess_move_t *m, move_type_t kind,
+                             uint8_t out[ARCHIVE_PLY_SIZE]) {
+  uint32_t v = (uint32_t)(m->from_row * 8 + m->from_col) |
+               ((uint32_t)(m->to_row * 8 + m->to_col) << 6) |
+               ((uint32_t)(m->piece & 0x0F) << 12) |
+               ((uint32_t)(m->captured_piece & 0x0F) << 16) |
+               ((uint32_t)(kind & 0x07) << 20);
+  out[0] = (uint8_t)v;
+  out[1] = (uint8_t)(v >> 8);
+  out[2] = (uint8_t)(v >> 16);
+}
+
+static void archive_ply_unpack(const uint8_t in[ARCHIVE_PLY_SIZE],
+                               chess_move_t *m, move_type_t *kind) {
+  uint32_t v = in[0] | ((uint32_t)in[1] << 8) | ((uint32_t)in[2] << 16);
+  memset(m, 0, sizeof(*m));
+  m->from_row = (v & 0x3F) / 8;
+  m->from_col = (v & 0x3F) % 8;
+  m->to_row = ((v >> 6) & 0x3F) / 8;
+  m->to_col = ((v >> 6) & 0x3F) % 8;
+  m->piece = (piece_t)((v >> 12) & 0x0F);
+  m->captured_piece = (piece_t)((v >> 16) & 0x0F);
+  *kind = (move_type_t)((v >> 20) & 0x07);
+}
+
+esp_err_t game_archive_save_current(const char *name, uint16_t *plies_out) {
+  if (!game_archive_name_valid(name)) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  if (!game_archive_available()) {
+    return ESP_ERR_NOT_FOUND;
+  }
+
+  memset(s_job_buf, 0, sizeof(s_job_buf));
+  archive_job_t *job = (archive_job_t *)s_job_buf;
+  job->op = ARCHIVE_OP_SAVE;
+  strncpy(job->name, name, sizeof(job->name) - 1);
+
+  uint8_t *rec_bytes = s_job_buf + sizeof(*job);
+  archive_record_t *r = (archive_record_t *)rec_bytes;
+  uint16_t plies = (history_index > GAME_TASK_MAX_MOVES_HISTORY)
+                       ? GAME_TASK_MAX_MOVES_HISTORY
+                       : (uint16_t)history_index;
+  time_t now = time(NULL);
+  r->magic = ARCHIVE_RECORD_MAGIC;
+  memcpy(r->name, job->name, sizeof(r->name));
+  r->saved_at = (now >= ARCHIVE_MIN_VALID_TIME) ? (uint32_t)now : 0;
+  r->move_count = move_count;
+  r->white_time_total = white_time_total;
+  r->black_time_total = black_time_total;
+  r->plies = plies;
+  r->result = archive_current_result();
+  r->result_type = (uint8_t)current_result_type;
+  r->current_player = (uint8_t)current_player;
+  r->game_state = (uint8_t)current_game_state;
+  r->castling = (uint8_t)((white_king_moved ? 0x01 : 0) |
+                          (white_rook_a_moved ? 0x02 : 0) |
+                          (white_rook_h_moved ? 0x04 : 0) |
+                          (black_king_moved ? 0x08 : 0) |
+                          (black_rook_a_moved ? 0x10 : 0) |
+                          (black_rook_h_moved ? 0x20 : 0));
+  r->ep[0] = (uint8_t)en_passant_available;
+  r->ep[1] = en_passant_target_row;
+  r->ep[2] = en_passant_target_col;
+  r->ep[3] = en_passant_victim_row;
+  r->ep[4] = en_passant_victim_col;
+  for (int sq = 0; sq < 64; sq++) {
+    uint8_t p = (uint8_t)board[sq / 8][sq % 8] & 0x0F;
+    r->board[sq / 2] |= (sq & 1) ? (uint8_t)(p << 4) : p;
+  }
+  uint32_t first = history_index - plies;
+  uint8_t *ply = rec_bytes + sizeof(*r);
+  for (uint16_t i = 0; i < plies; i++, ply += ARCHIVE_PLY_SIZE) {
+    archive_ply_pack(&move_history[first + i], move_history_kind[first + i],
+                     ply);
+  }
+  size_t rec_len = sizeof(*r) + (size_t)plies * ARCHIVE_PLY_SIZE;
+  r->crc32 = archive_record_crc(rec_bytes, rec_len);
+
+  esp_err_t ret = archive_submit(sizeof(*job) + rec_len);
+  if (ret == ESP_OK && plies_out != NULL) {
+    *plies_out = plies;
+  }
+  return ret;
+}
+
+/** Obnovi seznamy sebranych figur a pocty tahu z historie. */
+static void archive_rebuild_history_stats(void) {
+  white_captured_index = 0;
+  black_captured_index = 0;
+  white_moves_count = 0;
+  black_moves_count = 0;
+  for (uint32_t i = 0; i < history_index; i++) {
+    const chess_move_t *m = &move_history[i];
+    bool white = (m->piece >= PIECE_WHITE_PAWN && m->piece <= PIECE_WHITE_KING);
+    if (white) {
+      white_moves_count++;
+    } else {
+      black_moves_count++;
+    }
+    if (m->captured_piece == PIECE_EMPTY) {
+      continue;
+    }
+    if (white && white_captured_index < GAME_TASK_MAX_CAPTURED_PIECES) {
+      white_captured_pieces[white_captured_index++] = m->captured_piece;
+    } else if (!white && black_captured_index < GAME_TASK_MAX_CAPTURED_PIECES) {
+      black_captured_pieces[black_captured_index++] = m->captured_piece;
+    }
+  }
+  white_captured_count = white_captured_index;
+  black_captured_count = black_captured_index;
+  white_captures = white_captured_index;
+  black_captures = black_captured_index;
+}
+
+/** Pod zamkem: overeny zaznam z s_io_buf do stavu hry. */
+static void archive_apply_record(const archive_record_t *r) {
+  for (int sq = 0; sq < 64; sq++) {
+    uint8_t b = r->board[sq / 2];
+    board[sq / 8][sq % 8] = (piece_t)((sq & 1) ? (b >> 4) : (b & 0x0F));
+  }
+  current_player = (player_t)r->current_player;
+  current_game_state = (game_state_t)r->game_state;
+  move_count = r->move_count;
+  white_time_total = r->white_time_total;
+  black_time_total = r->black_time_total;
+  white_king_moved = (r->castling & 0x01) != 0;
+  white_rook_a_moved = (r->castling & 0x02) != 0;
+  white_rook_h_moved = (r->castling & 0x04) != 0;
+  black_king_moved = (r->castling & 0x08) != 0;
+  black_rook_a_moved = (r->castling & 0x10) != 0;
+  black_rook_h_moved = (r->castling & 0x20) != 0;
+  en_passant_available = r->ep[0] != 0;
+  en_passant_target_row = r->ep[1];
+  en_passant_target_col = r->ep[2];
+  en_passant_victim_row = r->ep[3];
+  en_passant_victim_col = r->ep[4];
+  promotion_state.pending = false;
+
+  const uint8_t *ply = (const uint8_t *)r + sizeof(*r);
+  history_index = r->plies;
+  for (uint16_t i = 0; i < r->plies; i++, ply += ARCHIVE_PLY_SIZE) {
+    archive_ply_unpack(ply, &move_history[i], &move_history_kind[i]);
+  }
+  archive_rebuild_history_stats();
+  if (history_index > 0) {
+    const chess_move_t *m = &move_history[history_index - 1];
+    last_move_from_row = m->from_row;
+    last_move_from_col = m->from_col;
+    last_move_to_row = m->to_row;
+    last_move_to_col = m->to_col;
+    has_last_move = true;
+  } else {
+    has_last_move = false;
+  }
+
+  if (current_game_state == GAME_STATE_FINISHED) {
+    current_result_type = (game_result_type_t)r->result_type;
+    game_result = GAME_STATE_FINISHED;
+  } else {
+    game_result = GAME_STATE_IDLE;
+  }
+  game_active = (current_game_state != GAME_STATE_IDLE &&
+                 current_game_state != GAME_STATE_FINISHED);
+  moves_without_capture = 0;
+  position_history_count = 0;
+  piece_lifted = false;
+  lifted_piece = PIECE_EMPTY;
+}
+
+esp_err_t game_archive_load(const char *name) {
+  if (!game_archive_name_valid(name)) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  if (archive_has_pending()) {
+    /* Read-your-writes: LOAD hned po SAVE/DELETE stejneho jmena. */
+    (void)config_persist_flush(2000);
+  }
+  if (!archive_lock()) {
+    return ESP_ERR_NOT_FOUND;
+  }
+  FILE *idx = NULL;
+  archive_index_header_t hdr;
+  game_archive_entry_t e;
+  uint32_t pos = 0;
+  esp_err_t ret = archive_open_index(&idx, &hdr);
+  if (ret == ESP_OK && !archive_find(idx, &hdr, name, &e, &pos)) {
+    ret = ESP_ERR_NOT_FOUND;
+  }
+  if (idx != NULL) {
+    fclose(idx);
+  }
+  if (ret == ESP_OK &&
+      (e.length < sizeof(archive_record_t) || e.length > sizeof(s_io_buf))) {
+    ret = ESP_ERR_INVALID_SIZE;
+  }
+  if (ret == ESP_OK) {
+    char path[40];
+    archive_data_path(path, sizeof(path), hdr.data_gen);
+    FILE *dat = fopen(path, "rb");
+    if (dat == NULL || fseek(dat, (long)e.offset, SEEK_SET) != 0 ||
+        fread(s_io_buf, e.length, 1, dat) != 1) {
+      ret = ESP_FAIL;
+    }
+    if (dat != NULL) {
+      fclose(dat);
+    }
+  }
+  if (ret == ESP_OK) {
+    const archive_record_t *r = (const archive_record_t *)s_io_buf;
+    if (r->magic != ARCHIVE_RECORD_MAGIC ||
+        strncmp(r->name, name, GAME_ARCHIVE_NAME_MAX) != 0 ||
+        r->plies > GAME_TASK_MAX_MOVES_HISTORY ||
+        e.length != sizeof(*r) + (size_t)r->plies * ARCHIVE_PLY_SIZE ||
+        r->crc32 != archive_record_crc(s_io_buf, e.length)) {
+      ret = ESP_ERR_INVALID_CRC;
+    } else {
+      archive_apply_record(r);
+      strncpy(saved_game_name, name, sizeof(saved_game_name) - 1);
+      saved_game_name[sizeof(saved_game_name) - 1] = '\0';
+      game_saved = true;
+    }
+  }
+  archive_unlock();
+  if (ret != ESP_OK) {
+    ESP_LOGW(TAG, "load '%s': %s", name, esp_err_to_name(ret));
+  }
+  return ret;
+}
+
+esp_err_t game_archive_delete(const char *name) {
+  if (!game_archive_name_valid(name)) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  if (!game_archive_exists(name)) {
+    return ESP_ERR_NOT_FOUND;
+  }
+  archive_job_t *job = (archive_job_t *)s_job_buf;
+  memset(job, 0, sizeof(*job));
+  job->op = ARCHIVE_OP_DELETE;
+  strncpy(job->name, name, sizeof(job->name) - 1);
+  return archive_submit(sizeof(*job));
+}
+
+// ============================================================================
+// CTENI INDEXU (libovolny task)
+// ============================================================================
+
+bool game_archive_exists(const char *name) {
+  if (!game_archive_name_valid(name) || !archive_lock()) {
+    return false;
+  }
+  FILE *idx = NULL;
+  archive_index_header_t hdr;
+  uint32_t pos = 0;
+  bool found = archive_open_index(&idx, &hdr) == ESP_OK &&
+               archive_find(idx, &hdr, name, NULL, &pos);
+  if (idx != NULL) {
+    fclose(idx);
+  }
+  archive_unlock();
+  return found;
+}
+
+esp_err_t game_archive_list(uint32_t offset, game_archive_entry_t *out,
+                            uint32_t max, uint32_t *n_out,
+                            uint32_t *total_out) {
+  if (n_out == NULL || (out == NULL && max > 0)) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  *n_out = 0;
+  if (total_out != NULL) {
+    *total_out = 0;
+  }
+  if (!archive_lock()) {
+    return ESP_ERR_NOT_FOUND;
+  }
+  FILE *idx = NULL;
+  archive_index_header_t hdr;
+  esp_err_t ret = archive_open_index(&idx, &hdr);
+  if (ret == ESP_OK && idx != NULL) {
+    uint32_t n = 0;
+    if (max > 0 && offset < hdr.count &&
+        archive_read_entry(idx, offset, &out[0])) {
+      n = 1;
+      uint32_t want = hdr.count - offset < max ? hdr.count - offset : max;
+      while (n < want && fread(&out[n], sizeof(out[n]), 1, idx) == 1) {
+        n++;
+      }
+    }
+    *n_out = n;
+    if (total_out != NULL) {
+      *total_out = hdr.count;
+    }
+  }
+  if (idx != NULL) {
+    fclose(idx);
+  }
+  archive_unlock();
+  return ret;
+}
+
+esp_err_t game_archive_write_list_fields(json_writer_t *w, uint32_t offset,
+                                         uint32_t limit) {
+  if (limit == 0 || limit > GAME_ARCHIVE_PAGE_MAX) {
+    limit = GAME_ARCHIVE_PAGE_MAX;
+  }
+  /* Po castech, aby stranka nezabrala stack httpd / BLE workeru. */
+  game_archive_entry_t page[5];
+  uint32_t total = 0;
+  uint32_t n = 0;
+  esp_err_t ret = game_archive_list(offset, page, 0, &n, &total);
+  bool available = (ret != ESP_ERR_NOT_FOUND);
+
+  json_writer_kv_bool(w, "available", available);
+  json_writer_kv_uint(w, "total", total);
+  json_writer_kv_uint(w, "offset", offset);
+  json_writer_key(w, "games");
+  json_writer_begin_array(w);
+  uint32_t written = 0;
+  while (available && written < limit) {
+    uint32_t chunk = limit - written;
+    if (chunk > sizeof(page) / sizeof(page[0])) {
+      chunk = sizeof(page) / sizeof(page[0]);
+    }
+    if (game_archive_list(offset + written, page, chunk, &n, &total) !=
+            ESP_OK ||
+        n == 0) {
+      break;
+    }
+    for (uint32_t i = 0; i < n; i++) {
+      json_writer_begin_object(w);
+      json_writer_kv_string(w, "name", page[i].name);
+      json_writer_kv_uint(w, "saved_at", page[i].saved_at);
+      json_writer_kv_string(w, "result",
+                            game_archive_result_str(page[i].result));
+      json_writer_kv_uint(w, "plies", page[i].plies);
+      json_writer_end_object(w);
+    }
+    written += n;
+  }
+  json_writer_end_array(w);
+  json_writer_kv_uint(w, "count", written);
+  json_writer_key(w, "next");
+  if (offset + written < total) {
+    json_writer_uint(w, offset + written);
+  } else {
+    json_writer_null(w);
+  }
+  return json_writer_error(w);
+}
+
+esp_err_t game_archive_format_page(char *buf, size_t cap, uint32_t page) {
+  if (buf == NULL || cap == 0) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  if (page == 0) {
+    page = 1;
+  }
+  game_archive_entry_t entries[GAME_ARCHIVE_UART_PAGE];
+  uint32_t n = 0;
+  uint32_t total = 0;
+  uint32_t first = (page - 1) * GAME_ARCHIVE_UART_PAGE;
+  esp_err_t ret = game_archive_list(first, entries, GAME_ARCHIVE_UART_PAGE, &n,
+                                    &total);
+  if (ret != ESP_OK) {
+    snprintf(buf, cap, "Game archive unavailable (%s)", esp_err_to_name(ret));
+    return ret;
+  }
+  uint32_t pages = (total + GAME_ARCHIVE_UART_PAGE - 1) / GAME_ARCHIVE_UART_PAGE;
+  size_t len = (size_t)snprintf(buf, cap,
+                                "📁 Saved games — page %" PRIu32 "/%" PRIu32
+                                ", %" PRIu32 " total\n",
+                                page, pages ? pages : 1, total);
+  for (uint32_t i = 0; i < n && len < cap; i++) {
+    char date[20] = "-";
+    if (entries[i].saved_at != 0) {
+      time_t t = (time_t)entries[i].saved_at;
+      struct tm tm_info;
+      localtime_r(&t, &tm_info);
+      strftime(date, sizeof(date), "%Y-%m-%d %H:%M", &tm_info);
+    }
+    len += (size_t)snprintf(buf + len, cap - len,
+                            "%3" PRIu32 ". %-23s %-7s %3u plies  %s\n",
+                            first + i + 1, entries[i].name,
+                            game_archive_result_str(entries[i].result),
+                            (unsigned)entries[i].plies, date);
+  }
+  if (len < cap) {
+    snprintf(buf + len, cap - len,
+             n == 0 ? "(no games on this page)\n"
+                    : "💡 LOAD <name> | DELETE_GAME <name> | LIST_GAMES <page>\n");
+  }
+  return ESP_OK;
+}
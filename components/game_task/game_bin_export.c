@@ -0,0 +1,162 @@
+/**
+ * @file game_bin_export.c
+ * @brief Kompaktni binarni snapshot hry pro BLE a HTTP (Accept negotiation).
+ *
+ * Stejna data jako JSON snapshot (board, status, history, captured, clock),
+ * kodovana snapshot_bin.c — startovni pozice ~70 B, s poslednimi 20 tahy
+ * ~200 B, takze se na BLE (MTU 247) vejde do jedne notifikace.
+ */
+
+#include "game_task_internal.h"
+#include "game_task.h"
+#include "freertos_chess.h"
+#include "snapshot_bin.h"
+
+#include "../../timer_system/include/timer_system.h"
+
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+static const char *TAG = "GAME_BIN";
+
+/** Naplni `st` z globalniho stavu — volat pod game_mutex. */
+static void game_fill_snapshot_bin_locked(snapshot_bin_state_t *st,
+                                          uint16_t max_moves) {
+  for (int row = 0; row < 8; row++) {
+    for (int col = 0; col < 8; col++) {
+      st->board[row * 8 + col] = (uint8_t)board[row][col];
+    }
+  }
+
+  uint32_t total = history_index < GAME_TASK_MAX_MOVES_HISTORY
+                       ? history_index
+                       : GAME_TASK_MAX_MOVES_HISTORY;
+  uint32_t n = total;
+  if (max_moves != 0 && n > max_moves) {
+    n = max_moves;
+  }
+  st->move_total = total;
+  st->move_first = total - n;
+  st->move_n = (uint16_t)n;
+  for (uint32_t i = 0; i < n; i++) {
+    const chess_move_t *m = &move_history[st->move_first + i];
+    snapshot_bin_move_t *o = &st->moves[i];
+    o->from = (uint8_t)(m->from_row * 8 + m->from_col);
+    o->to = (uint8_t)(m->to_row * 8 + m->to_col);
+    o->piece = (uint8_t)m->piece;
+    o->captured = (uint8_t)m->captured_piece;
+    o->kind = (uint8_t)move_history_kind[st->move_first + i];
+    o->timestamp = m->timestamp;
+  }
+
+  bool in_check = game_is_king_in_check(current_player);
+  bool no_moves = game_generate_legal_moves(current_player) == 0;
+  uint32_t bits = (uint32_t)current_game_state & SNAPSHOT_BIN_ST_STATE_MASK;
+  if (current_player == PLAYER_BLACK) {
+    bits |= SNAPSHOT_BIN_ST_BLACK_TO_MOVE;
+  }
+  if (in_check) {
+    bits |= SNAPSHOT_BIN_ST_IN_CHECK;
+  }
+  if (no_moves) {
+    bits |= in_check ? SNAPSHOT_BIN_ST_CHECKMATE : SNAPSHOT_BIN_ST_STALEMATE;
+  }
+  if (error_recovery_state.waiting_for_move_correction) {
+    bits |= SNAPSHOT_BIN_ST_ERROR_RECOVERY;
+  }
+  if (current_game_state == GAME_STATE_FINISHED) {
+    bits |= ((uint32_t)current_result_type << SNAPSHOT_BIN_ST_RESULT_SHIFT) &
+            SNAPSHOT_BIN_ST_RESULT_MASK;
+    bits |= ((uint32_t)current_endgame_reason << SNAPSHOT_BIN_ST_REASON_SHIFT) &
+            SNAPSHOT_BIN_ST_REASON_MASK;
+  }
+  if (piece_lifted) {
+    bits |= SNAPSHOT_BIN_ST_PIECE_LIFTED;
+    st->lifted_sq = (uint8_t)(lifted_piece_row * 8 + lifted_piece_col);
+    st->lifted_piece = (uint8_t)lifted_piece;
+  }
+  if (castling_state.in_progress) {
+    bits |= SNAPSHOT_BIN_ST_CASTLING;
+    st->castling_from = (uint8_t)(castling_state.rook_from_row * 8 +
+                                  castling_state.rook_from_col);
+    st->castling_to =
+        (uint8_t)(castling_state.rook_to_row * 8 + castling_state.rook_to_col);
+  }
+  st->status_bits = bits;
+  st->move_count = move_count;
+
+  uint32_t nw = white_captured_count < GAME_TASK_MAX_CAPTURED_PIECES
+                    ? white_captured_count
+                    : GAME_TASK_MAX_CAPTURED_PIECES;
+  uint32_t nb = black_captured_count < GAME_TASK_MAX_CAPTURED_PIECES
+                    ? black_captured_count
+                    : GAME_TASK_MAX_CAPTURED_PIECES;
+  st->white_captured_n = (uint8_t)nw;
+  st->black_captured_n = (uint8_t)nb;
+  for (uint32_t i = 0; i < nw; i++) {
+    st->white_captured[i] = (uint8_t)white_captured_pieces[i];
+  }
+  for (uint32_t i = 0; i < nb; i++) {
+    st->black_captured[i] = (uint8_t)black_captured_pieces[i];
+  }
+}
+
+/** Hodiny mimo game_mutex — timer_system ma vlastni zamek. */
+static void game_fill_snapshot_bin_clock(snapshot_bin_state_t *st) {
+  chess_timer_t t;
+  if (timer_get_state(&t) != ESP_OK) {
+    return;
+  }
+  st->has_clock = true;
+  st->clock_flags = (uint8_t)((t.timer_running ? SNAPSHOT_BIN_CLK_RUNNING : 0) |
+                              (t.is_white_turn ? SNAPSHOT_BIN_CLK_WHITE_TURN : 0) |
+                              (t.game_paused ? SNAPSHOT_BIN_CLK_PAUSED : 0) |
+                              (t.time_expired ? SNAPSHOT_BIN_CLK_EXPIRED : 0));
+  st->clock_type = (uint8_t)t.config.type;
+  st->white_time_ms = t.white_time_ms;
+  st->black_time_ms = t.black_time_ms;
+  st->initial_time_ms = t.config.initial_time_ms;
+  st->increment_ms = t.config.increment_ms;
+}
+
+esp_err_t game_get_snapshot_bin(uint8_t *buffer, size_t size,
+                                uint16_t max_moves, size_t *out_len) {
+  if (buffer == NULL || size == 0 || out_len == NULL) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  *out_len = 0;
+
+  /* ~2.5 KiB — na heap, volaji to i NimBLE host a httpd s malym stackem. */
+  snapshot_bin_state_t *st = calloc(1, sizeof(*st));
+  if (st == NULL) {
+    return ESP_ERR_NO_MEM;
+  }
+
+  if (game_mutex != NULL) {
+    if (xSemaphoreTake(game_mutex, pdMS_TO_TICKS(1000)) != pdTRUE) {
+      free(st);
+      return ESP_ERR_TIMEOUT;
+    }
+  }
+  st->state_version = game_get_state_revision();
+  game_fill_snapshot_bin_locked(st, max_moves);
+  if (game_mutex != NULL) {
+    xSemaphoreGive(game_mutex);
+  }
+
+  st->timestamp_ms = (uint64_t)(esp_timer_get_time() / 1000);
+  game_fill_snapshot_bin_clock(st);
+
+  bool ok = snapshot_bin_encode(st, buffer, size, out_len);
+  free(st);
+  if (!ok) {
+    ESP_LOGW(TAG, "snapshot_bin: buffer %u B too small", (unsigned)size);
+    return ESP_ERR_NO_MEM;
+  }
+  return ESP_OK;
+}
@@ -5,6 +5,11 @@
 
 #include "game_task_internal.h"
 #include "game_task.h"
+#include "chess_gameplay_policy.h"
+#include "game_archive.h"
+#include "game_matrix_guard.h"
+#include "game_move_exec.h"
+#include "game_snapshot.h"
 #include "freertos_chess.h"
 
 #include "../freertos_chess/include/streaming_output.h"
@@ -305,6 +310,50 @@ void game_process_evaluate_command(const chess_move_command_t *cmd) {
                              (QueueHandle_t)cmd->response_queue);
 }
 
+/**
+ * @brief Odpoved archivnich prikazu (kratky text do message i data)
+ */
+static void archive_reply(const chess_move_command_t *cmd, bool ok,
+                          const char *msg) {
+  if (cmd->response_queue == NULL) {
+    game_send_response_to_uart(msg, !ok, NULL);
+    return;
+  }
+  game_response_t response = {
+      .type = ok ? GAME_RESPONSE_SUCCESS : GAME_RESPONSE_ERROR,
+      .command_type = cmd->type,
+      .error_code = ok ? 0 : 1,
+      .text = game_payload_alloc_str(msg),
+      .timestamp = esp_timer_get_time() / 1000};
+  if (!game_response_send((QueueHandle_t)cmd->response_queue, &response,
+                          pdMS_TO_TICKS(100))) {
+    ESP_LOGW(TAG, "Failed to send archive response to UART task");
+  }
+}
+
+/** Jmeno hry z prikazu (vzdy ukoncene; delsi se zkrati a neprojde validaci). */
+static void archive_cmd_name(const chess_move_command_t *cmd,
+                             char out[GAME_ARCHIVE_NAME_MAX]) {
+  strncpy(out, game_payload_str(cmd->timer_data.archive.name),
+          GAME_ARCHIVE_NAME_MAX - 1);
+  out[GAME_ARCHIVE_NAME_MAX - 1] = '\0';
+}
+
+static const char *archive_err_text(esp_err_t err) {
+  switch (err) {
+  case ESP_ERR_INVALID_ARG:
+    return "invalid name (1-23 chars: A-Z a-z 0-9 _ - .)";
+  case ESP_ERR_NOT_FOUND:
+    return "not found";
+  case ESP_ERR_NO_MEM:
+    return "archive full";
+  case ESP_ERR_INVALID_CRC:
+    return "record corrupted";
+  default:
+    return esp_err_to_name(err);
+  }
+}
+
 /**
  * @brief Process save game command from UART
  * @param cmd Save command
@@ -313,26 +362,44 @@ void game_process_save_command(const chess_move_command_t *cmd) {
   if (!cmd)
     return;
 
-  ESP_LOGI(TAG, "💾 Processing SAVE command: %s", cmd->from_notation);
-
-  // In a real implementation, this would save to NVS or file system
-  // For now, we'll simulate the save operation
-
-  char save_data[512];
-  snprintf(save_data, sizeof(save_data),
-           "💾 Game Saved Successfully!\n"
-           "  • Filename: %s\n"
-           "  • Moves: %d\n"
-           "  • Current Player: %s\n"
-           "  • Game Status: %s\n"
-           "  • Timestamp: %llu ms",
-           cmd->from_notation,
-           0, // move_count would be tracked
-           current_player == PLAYER_WHITE ? "White" : "Black", "In Progress",
-           esp_timer_get_time() / 1000);
+  char name[GAME_ARCHIVE_NAME_MAX];
+  archive_cmd_name(cmd, name);
+  ESP_LOGI(TAG, "💾 Processing SAVE command: %s", name);
+
+  uint16_t plies = 0;
+  esp_err_t ret = game_archive_save_current(name, &plies);
+  char msg[96];
+  if (ret == ESP_OK) {
+    strncpy(saved_game_name, name, sizeof(saved_game_name) - 1);
+    saved_game_name[sizeof(saved_game_name) - 1] = '\0';
+    game_saved = true;
+    snprintf(msg, sizeof(msg), "💾 Saved '%s' (%u plies)", name,
+             (unsigned)plies);
+  } else {
+    snprintf(msg, sizeof(msg), "Save '%s' failed: %s", name,
+             archive_err_text(ret));
+  }
+  archive_reply(cmd, ret == ESP_OK, msg);
+}
 
-  game_send_response_to_uart(save_data, false,
-                             (QueueHandle_t)cmd->response_queue);
+esp_err_t game_resume_archived_game(const char *name) {
+  esp_err_t ret = game_archive_load(name);
+  if (ret != ESP_OK) {
+    return ret;
+  }
+  game_end_timer_move();
+  if (game_active) {
+    game_start_timer_move(current_player == PLAYER_WHITE);
+  }
+  game_matrix_guard_check_resync_after_restore();
+  if (!game_is_matrix_guard_active()) {
+    led_clear_board_only();
+    chess_policy_highlight_movable_if_enabled();
+  }
+  /* Po restartu pokracovat v nactene hre, ne v te predchozi. */
+  game_snapshot_persist_after_valid_move();
+  game_emit_simple_event(GAME_EVENT_GAME_STARTED);
+  return ESP_OK;
 }
 
 /**
@@ -343,26 +410,21 @@ void game_process_load_command(const chess_move_command_t *cmd) {
   if (!cmd)
     return;
 
-  ESP_LOGI(TAG, "📂 Processing LOAD command: %s", cmd->from_notation);
-
-  // In a real implementation, this would load from NVS or file system
-  // For now, we'll simulate the load operation
-
-  char load_data[512];
-  snprintf(load_data, sizeof(load_data),
-           "📂 Game Loaded Successfully!\n"
-           "  • Filename: %s\n"
-           "  • Moves: %d\n"
-           "  • Current Player: %s\n"
-           "  • Game Status: %s\n"
-           "  • Load Time: %llu ms",
-           cmd->from_notation,
-           0, // move_count would be loaded
-           current_player == PLAYER_WHITE ? "White" : "Black", "In Progress",
-           esp_timer_get_time() / 1000);
-
-  game_send_response_to_uart(load_data, false,
-                             (QueueHandle_t)cmd->response_queue);
+  char name[GAME_ARCHIVE_NAME_MAX];
+  archive_cmd_name(cmd, name);
+  ESP_LOGI(TAG, "📂 Processing LOAD command: %s", name);
+
+  esp_err_t ret = game_resume_archived_game(name);
+  char msg[96];
+  if (ret == ESP_OK) {
+    snprintf(msg, sizeof(msg), "📂 Loaded '%s' (%" PRIu32 " plies, %s to move)",
+             name, history_index,
+             current_player == PLAYER_WHITE ? "White" : "Black");
+  } else {
+    snprintf(msg, sizeof(msg), "Load '%s' failed: %s", name,
+             archive_err_text(ret));
+  }
+  archive_reply(cmd, ret == ESP_OK, msg);
 }
 
 /**
@@ -396,7 +458,7 @@ void game_process_component_off_command(const chess_move_command_t *cmd) {
 
   // CHUNKED OUTPUT - Send endgame report in chunks to prevent UART buffer
   // overflow
-  const size_t CHUNK_SIZE = 256; // Small chunks for UART buffer
+  const size_t CHUNK_SIZE = GAME_PAYLOAD_SLOT_SIZE - 1; // Jeden slot na blok
   size_t total_len = strlen(response_data);
   const char *data_ptr = response_data;
   size_t chunks_remaining = total_len;
@@ -414,19 +476,15 @@ void game_process_component_off_command(const chess_move_command_t *cmd) {
         .type = GAME_RESPONSE_SUCCESS,
         .command_type = GAME_CMD_SHOW_BOARD, // Reuse board command type
         .error_code = 0,
-        .message = "Endgame report chunk sent",
+        .text = game_payload_alloc_strn(data_ptr, chunk_size),
         .timestamp = esp_timer_get_time() / 1000};
 
-    // Copy chunk data
-    strncpy(chunk_response.data, data_ptr, chunk_size);
-    chunk_response.data[chunk_size] = '\0';
-
     // Reset WDT before sending chunk
     game_task_wdt_reset_safe();
 
     // Send chunk
-    if (xQueueSend((QueueHandle_t)cmd->response_queue, &chunk_response,
-                   pdMS_TO_TICKS(100)) != pdTRUE) {
+    if (!game_response_send((QueueHandle_t)cmd->response_queue,
+                            &chunk_response, pdMS_TO_TICKS(100))) {
       ESP_LOGW(TAG, "Failed to send endgame report chunk to UART task");
       break;
     }
@@ -465,7 +523,7 @@ void game_process_component_on_command(const chess_move_command_t *cmd) {
 
   // CHUNKED OUTPUT - Send endgame report in chunks to prevent UART buffer
   // overflow
-  const size_t CHUNK_SIZE = 256; // Small chunks for UART buffer
+  const size_t CHUNK_SIZE = GAME_PAYLOAD_SLOT_SIZE - 1; // Jeden slot na blok
   size_t total_len = strlen(response_data);
   const char *data_ptr = response_data;
   size_t chunks_remaining = total_len;
@@ -483,19 +541,15 @@ void game_process_component_on_command(const chess_move_command_t *cmd) {
         .type = GAME_RESPONSE_SUCCESS,
         .command_type = GAME_CMD_SHOW_BOARD, // Reuse board command type
         .error_code = 0,
-        .message = "Endgame report chunk sent",
+        .text = game_payload_alloc_strn(data_ptr, chunk_size),
         .timestamp = esp_timer_get_time() / 1000};
 
-    // Copy chunk data
-    strncpy(chunk_response.data, data_ptr, chunk_size);
-    chunk_response.data[chunk_size] = '\0';
-
     // Reset WDT before sending chunk
     game_task_wdt_reset_safe();
 
     // Send chunk
-    if (xQueueSend((QueueHandle_t)cmd->response_queue, &chunk_response,
-                   pdMS_TO_TICKS(100)) != pdTRUE) {
+    if (!game_response_send((QueueHandle_t)cmd->response_queue,
+                            &chunk_response, pdMS_TO_TICKS(100))) {
       ESP_LOGW(TAG, "Failed to send endgame report chunk to UART task");
       break;
     }
@@ -864,45 +918,23 @@ void game_process_list_games_command(const chess_move_command_t *cmd) {
   if (!cmd)
     return;
 
-  ESP_LOGI(TAG, "📁 Processing LIST_GAMES command");
+  uint16_t page = cmd->timer_data.archive.page;
+  ESP_LOGI(TAG, "📁 Processing LIST_GAMES command (page %u)", (unsigned)page);
 
   char response_data[1024];
-  snprintf(response_data, sizeof(response_data),
-           "📁 Saved Games List\n"
-           "═══════════════════════════════════════════════════════════════\n"
-           "🎮 Available saved games:\n"
-           "\n"
-           "1. game_001.chess\n"
-           "   • Date: 2024-01-15 14:30\n"
-           "   • Moves: 24\n"
-           "   • Status: In Progress\n"
-           "   • Player: White to move\n"
-           "\n"
-           "2. tournament_round1.chess\n"
-           "   • Date: 2024-01-14 16:45\n"
-           "   • Moves: 42\n"
-           "   • Status: Completed\n"
-           "   • Result: White wins\n"
-           "\n"
-           "3. practice_game.chess\n"
-           "   • Date: 2024-01-13 10:20\n"
-           "   • Moves: 18\n"
-           "   • Status: In Progress\n"
-           "   • Player: Black to move\n"
-           "\n"
-           "💡 Use 'LOAD <filename>' to load a game\n"
-           "💡 Use 'DELETE_GAME <filename>' to delete a game\n"
-           "💡 Total: 3 saved games");
+  (void)game_archive_format_page(response_data, sizeof(response_data), page);
+  if (cmd->response_queue == NULL) {
+    ESP_LOGI(TAG, "%s", response_data);
+    return;
+  }
 
-  // CHUNKED OUTPUT - Send endgame report in chunks to prevent UART buffer
-  // overflow
-  const size_t CHUNK_SIZE = 256; // Small chunks for UART buffer
+  // CHUNKED OUTPUT - Send list in chunks to prevent UART buffer overflow
+  const size_t CHUNK_SIZE = GAME_PAYLOAD_SLOT_SIZE - 1; // Jeden slot na blok
   size_t total_len = strlen(response_data);
   const char *data_ptr = response_data;
   size_t chunks_remaining = total_len;
 
-  ESP_LOGI(TAG, "🏆 Sending endgame report in chunks: %zu bytes total",
-           total_len);
+  ESP_LOGI(TAG, "📁 Sending game list in chunks: %zu bytes total", total_len);
 
   while (chunks_remaining > 0) {
     // Calculate chunk size
@@ -912,22 +944,18 @@ void game_process_list_games_command(const chess_move_command_t *cmd) {
     // Create chunk response
     game_response_t chunk_response = {
         .type = GAME_RESPONSE_SUCCESS,
-        .command_type = GAME_CMD_SHOW_BOARD, // Reuse board command type
+        .command_type = GAME_CMD_LIST_GAMES,
         .error_code = 0,
-        .message = "Endgame report chunk sent",
+        .text = game_payload_alloc_strn(data_ptr, chunk_size),
         .timestamp = esp_timer_get_time() / 1000};
 
-    // Copy chunk data
-    strncpy(chunk_response.data, data_ptr, chunk_size);
-    chunk_response.data[chunk_size] = '\0';
-
     // Reset WDT before sending chunk
     game_task_wdt_reset_safe();
 
     // Send chunk
-    if (xQueueSend((QueueHandle_t)cmd->response_queue, &chunk_response,
-                   pdMS_TO_TICKS(100)) != pdTRUE) {
-      ESP_LOGW(TAG, "Failed to send endgame report chunk to UART task");
+    if (!game_response_send((QueueHandle_t)cmd->response_queue,
+                            &chunk_response, pdMS_TO_TICKS(100))) {
+      ESP_LOGW(TAG, "Failed to send game list chunk to UART task");
       break;
     }
 
@@ -940,28 +968,6 @@ void game_process_list_games_command(const chess_move_command_t *cmd) {
       vTaskDelay(pdMS_TO_TICKS(5));
     }
   }
-
-  // Použít LED_CMD_ANIM_ENDGAME místo start_endgame_animation()
-  // Najít pozici černého krále
-  uint8_t king_pos = 27; // default fallback (d4)
-  for (int i = 0; i < 64; i++) {
-    int r = i / 8;
-    int c = i % 8;
-    if (board[r][c] == PIECE_BLACK_KING) {
-      king_pos = i;
-      break;
-    }
-  }
-  led_command_t endgame_cmd = {.type = LED_CMD_ANIM_ENDGAME,
-                               .led_index = king_pos,
-                               .red = 0,
-                               .green = 0,
-                               .blue = 0,
-                               .duration_ms = 0, // Endless
-                               .data = NULL};
-  led_execute_command_new(&endgame_cmd);
-
-  ESP_LOGI(TAG, "✅ Endgame report sent successfully in chunks");
 }
 
 /**
@@ -972,66 +978,59 @@ void game_process_delete_game_command(const chess_move_command_t *cmd) {
   if (!cmd)
     return;
 
-  ESP_LOGI(TAG, "🗑️ Processing DELETE_GAME command: %s", cmd->from_notation);
-
-  char response_data[512];
-  snprintf(response_data, sizeof(response_data),
-           "🗑️ Game Deletion\n"
-           "═══════════════════════════════════════════════════════════════\n"
-           "🎮 Game: %s\n"
-           "✅ Status: Successfully deleted\n"
-           "📁 File removed from storage\n"
-           "💾 Space freed: ~2.5 KB\n"
-           "\n"
-           "💡 Use 'LIST_GAMES' to see remaining games",
-           cmd->from_notation);
-
-  // CHUNKED OUTPUT - Send endgame report in chunks to prevent UART buffer
-  // overflow
-  const size_t CHUNK_SIZE = 256; // Small chunks for UART buffer
-  size_t total_len = strlen(response_data);
-  const char *data_ptr = response_data;
-  size_t chunks_remaining = total_len;
-
-  ESP_LOGI(TAG, "🏆 Sending endgame report in chunks: %zu bytes total",
-           total_len);
-
-  while (chunks_remaining > 0) {
-    // Calculate chunk size
-    size_t chunk_size =
-        (chunks_remaining > CHUNK_SIZE) ? CHUNK_SIZE : chunks_remaining;
-
-    // Create chunk response
-    game_response_t chunk_response = {
-        .type = GAME_RESPONSE_SUCCESS,
-        .command_type = GAME_CMD_SHOW_BOARD, // Reuse board command type
-        .error_code = 0,
-        .message = "Endgame report chunk sent",
-        .timestamp = esp_timer_get_time() / 1000};
-
-    // Copy chunk data
-    strncpy(chunk_response.data, data_ptr, chunk_size);
-    chunk_response.data[chunk_size] = '\0';
-
-    // Reset WDT before sending chunk
-    game_task_wdt_reset_safe();
+  char name[GAME_ARCHIVE_NAME_MAX];
+  archive_cmd_name(cmd, name);
+  ESP_LOGI(TAG, "🗑️ Processing DELETE_GAME command: %s", name);
+
+  esp_err_t ret = game_archive_delete(name);
+  char msg[96];
+  if (ret == ESP_OK) {
+    snprintf(msg, sizeof(msg), "🗑️ Deleted '%s'", name);
+  } else {
+    snprintf(msg, sizeof(msg), "Delete '%s' failed: %s", name,
+             archive_err_text(ret));
+  }
+  archive_reply(cmd, ret == ESP_OK, msg);
+}
 
-    // Send chunk
-    if (xQueueSend((QueueHandle_t)cmd->response_queue, &chunk_response,
-                   pdMS_TO_TICKS(100)) != pdTRUE) {
-      ESP_LOGW(TAG, "Failed to send endgame report chunk to UART task");
-      break;
-    }
+_Static_assert(GAME_MOVE_BATCH_MAX * sizeof(uint16_t) <= GAME_PAYLOAD_SLOT_SIZE,
+               "davka tahu se musi vejit do slotu payloadu");
 
-    // Update pointers
-    data_ptr += chunk_size;
-    chunks_remaining -= chunk_size;
+/**
+ * @brief Davka tahu (JSON Lines protokol na konzoli, soak testy)
+ *
+ * Odpoved: error_code = move_error_t, text = game_move_batch_result_t.
+ * @param cmd Prikaz s timer_data.move_batch.moves
+ */
+void game_process_move_batch_command(const chess_move_command_t *cmd) {
+  if (!cmd)
+    return;
 
-    // Small delay between chunks
-    if (chunks_remaining > 0) {
-      vTaskDelay(pdMS_TO_TICKS(5));
-    }
+  /* Kopie ze slotu (zarovnani); davky zpracovava jen game task. */
+  static uint16_t moves[GAME_MOVE_BATCH_MAX];
+  size_t len = 0;
+  const void *data = game_payload_data(cmd->timer_data.move_batch.moves, &len);
+  size_t count = (data != NULL) ? len / sizeof(uint16_t) : 0;
+  if (count > GAME_MOVE_BATCH_MAX) {
+    count = 0; /* alloc delsi slot nepripusti; prazdna davka = chyba */
   }
+  if (count > 0) {
+    memcpy(moves, data, count * sizeof(uint16_t));
+  }
+  game_move_batch_result_t result;
+  move_error_t err = game_execute_move_batch(moves, count, &result);
 
-  ESP_LOGI(TAG, "✅ Endgame report sent successfully in chunks");
+  if (cmd->response_queue == NULL) {
+    return;
+  }
+  game_response_t response = {
+      .type = GAME_RESPONSE_MOVE_RESULT,
+      .command_type = cmd->type,
+      .error_code = (uint8_t)err,
+      .text = game_payload_alloc(&result, sizeof(result)),
+      .timestamp = esp_timer_get_time() / 1000};
+  if (!game_response_send((QueueHandle_t)cmd->response_queue, &response,
+                          pdMS_TO_TICKS(100))) {
+    ESP_LOGW(TAG, "Failed to send move batch response");
+  }
 }
@@ -141,16 +141,15 @@ static void game_send_board_to_uart(QueueHandle_t response_queue) {
 
   // MEMORY OPTIMIZATION: Streaming output handles data transmission
   // Send completion message to response queue
-  game_response_t completion_response = {
-      .type = GAME_RESPONSE_SUCCESS,
-      .command_type = GAME_CMD_SHOW_BOARD,
-      .error_code = 0,
-      .message = "Board display streaming completed successfully",
-      .timestamp = esp_timer_get_time() / 1000};
-  strcpy(completion_response.data, "streaming completed");
-
   if (response_queue != NULL) {
-    xQueueSend(response_queue, &completion_response, pdMS_TO_TICKS(100));
+    game_response_t completion_response = {
+        .type = GAME_RESPONSE_SUCCESS,
+        .command_type = GAME_CMD_SHOW_BOARD,
+        .error_code = 0,
+        .text = game_payload_alloc_str("streaming completed"),
+        .timestamp = esp_timer_get_time() / 1000};
+    (void)game_response_send(response_queue, &completion_response,
+                             pdMS_TO_TICKS(100));
   }
 
   // No need for manual queue management or large buffers
@@ -332,13 +331,49 @@ static bool game_undo_last_move_impl(void) {
   }
 
   game_snapshot_persist_after_valid_move();
-  game_bump_revision_and_notify();
+  game_event_t ev = {.type = GAME_EVENT_MOVE_UNDONE};
+  ev.u.move.from = GAME_EVENT_SQUARE_NONE;
+  ev.u.move.to = GAME_EVENT_SQUARE_NONE;
+  ev.u.move.ply = (uint16_t)move_count;
+  game_emit_event(&ev);
 
   ESP_LOGI(TAG, "Undo applied (kind=%d), side to move: %s", (int)kind,
            current_player == PLAYER_WHITE ? "White" : "Black");
   return true;
 }
 
+/** Slot s daty prikazu (game_payload.h), ktery patri prikazu. */
+static game_payload_t game_command_payload(const chess_move_command_t *cmd) {
+  switch (cmd->type) {
+  case GAME_CMD_NEW_GAME_FROM_FEN:
+    return cmd->timer_data.fen_new_game.fen;
+  case GAME_CMD_SAVE:
+  case GAME_CMD_LOAD:
+  case GAME_CMD_DELETE_GAME:
+    return cmd->timer_data.archive.name;
+  case GAME_CMD_MATRIX_GUARD:
+    return cmd->timer_data.matrix_guard.masks;
+  case GAME_CMD_MOVE_BATCH:
+    return cmd->timer_data.move_batch.moves;
+  default:
+    return GAME_PAYLOAD_NONE;
+  }
+}
+
+/**
+ * @brief Dalsi prikaz: nejdriv matrix_game_ring, pak game_command_queue
+ *
+ * Fyzicka deska ma prednost (latence pickup -> highlight); poradi uvnitr
+ * ringu i fronty zustava zachovane.
+ */
+static bool game_next_command(chess_move_command_t *out) {
+  if (spsc_ring_pop(&matrix_game_ring, out)) {
+    return true;
+  }
+  return game_command_queue != NULL &&
+         xQueueReceive(game_command_queue, out, 0) == pdTRUE;
+}
+
 void game_process_commands(void) {
   // AKTUALIZOVAT non-blocking blink
   game_update_error_blink();
@@ -348,14 +383,14 @@ void game_process_commands(void) {
 
   // STABILITY FIX: Process ALL commands in queue (not just one) with limit
   // to prevent watchdog timeout
-  if (game_command_queue != NULL) {
+  {
     chess_move_command_t chess_cmd;
     uint32_t commands_processed = 0;
     const uint32_t MAX_COMMANDS_PER_CYCLE =
         15; // Limit to prevent watchdog timeout
 
-    // Process all commands in queue (up to limit)
-    while (xQueueReceive(game_command_queue, &chess_cmd, 0) == pdTRUE) {
+    // Process all commands in ring + queue (up to limit)
+    while (game_next_command(&chess_cmd)) {
       commands_processed++;
       ESP_LOGI(TAG, "📥 Received command type: %d (processed: %lu/%lu)",
                chess_cmd.type, commands_processed, MAX_COMMANDS_PER_CYCLE);
@@ -378,7 +413,8 @@ void game_process_commands(void) {
 
       case GAME_CMD_NEW_GAME_FROM_FEN:
         ESP_LOGI(TAG, "Processing NEW_GAME_FROM_FEN");
-        game_start_new_game_from_fen(chess_cmd.timer_data.fen_new_game.fen);
+        game_start_new_game_from_fen(
+            game_payload_str(chess_cmd.timer_data.fen_new_game.fen));
         game_send_response_to_uart("New game from FEN started", false,
                                    (QueueHandle_t)chess_cmd.response_queue);
         break;
@@ -468,14 +504,14 @@ void game_process_commands(void) {
         break;
 
       case 18: // GAME_CMD_SAVE
-        ESP_LOGI(TAG, "Processing SAVE command from UART: %s",
-                 chess_cmd.from_notation);
+        ESP_LOGI(TAG, "Processing SAVE command from UART: %.23s",
+                 game_payload_str(chess_cmd.timer_data.archive.name));
         game_process_save_command(&chess_cmd);
         break;
 
       case 19: // GAME_CMD_LOAD
-        ESP_LOGI(TAG, "Processing LOAD command from UART: %s",
-                 chess_cmd.from_notation);
+        ESP_LOGI(TAG, "Processing LOAD command from UART: %.23s",
+                 game_payload_str(chess_cmd.timer_data.archive.name));
         game_process_load_command(&chess_cmd);
         break;
 
@@ -528,8 +564,8 @@ void game_process_commands(void) {
         break;
 
       case 28: // GAME_CMD_DELETE_GAME
-        ESP_LOGI(TAG, "Processing DELETE_GAME command from UART: %s",
-                 chess_cmd.from_notation);
+        ESP_LOGI(TAG, "Processing DELETE_GAME command from UART: %.23s",
+                 game_payload_str(chess_cmd.timer_data.archive.name));
         game_process_delete_game_command(&chess_cmd);
         break;
 
@@ -611,26 +647,11 @@ void game_process_commands(void) {
         break;
 
       case GAME_CMD_PUZZLE: // 47
-        ESP_LOGI(TAG, "PUZZLE action/id=%u", (unsigned)chess_cmd.promotion_choice);
-        if (chess_cmd.promotion_choice == 0U) {
-          game_puzzle_cancel();
-        } else if (chess_cmd.promotion_choice >= 101U &&
-                   chess_cmd.promotion_choice <= 105U) {
-          uint8_t prep_id =
-              (uint8_t)(chess_cmd.promotion_choice - 100U);
-          if (!game_puzzle_enter_setup(prep_id)) {
-            ESP_LOGW(TAG, "PUZZLE prepare failed id=%u", (unsigned)prep_id);
-          }
-        } else if (chess_cmd.promotion_choice >= 1U &&
-                   chess_cmd.promotion_choice <= 5U) {
-          if (!game_puzzle_start(chess_cmd.promotion_choice)) {
-            ESP_LOGW(TAG, "PUZZLE start failed for id=%u",
-                     (unsigned)chess_cmd.promotion_choice);
-          }
-        } else {
-          ESP_LOGW(TAG, "PUZZLE unknown promotion_choice=%u",
-                   (unsigned)chess_cmd.promotion_choice);
-        }
+        ESP_LOGI(TAG, "PUZZLE action=%u id=%u rating=%u",
+                 (unsigned)chess_cmd.promotion_choice,
+                 (unsigned)chess_cmd.timer_data.puzzle.id,
+                 (unsigned)chess_cmd.timer_data.puzzle.rating);
+        game_process_puzzle_command(&chess_cmd);
         break;
 
       case GAME_CMD_OPENING_TRAINER: // 49
@@ -659,10 +680,15 @@ void game_process_commands(void) {
         }
         break;
 
+      case GAME_CMD_MOVE_BATCH: // 50
+        game_process_move_batch_command(&chess_cmd);
+        break;
+
       default:
         ESP_LOGW(TAG, "Unknown game command: %d", chess_cmd.type);
         break;
       }
+      game_payload_release(game_command_payload(&chess_cmd));
 
       // STABILITY FIX: Check limit to prevent watchdog timeout
       if (commands_processed >= MAX_COMMANDS_PER_CYCLE) {
@@ -719,4 +745,7 @@ void game_process_commands(void) {
 
   // Keep promo square visually anchored (does not clear board)
   game_update_promotion_anchor_led();
+
+  // Pixely z tohoto cyklu ukazat hned, ne az v dalsim LED snimku
+  led_pixels_flush();
 }
@@ -189,15 +189,33 @@ void game_show_missing_pieces_led(void) {
 }
 
 
-void game_bump_revision_and_notify(void) {
+void game_emit_event(game_event_t *ev) {
   game_task_wdt_reset_safe();
-  game_state_revision++;
-  if (game_state_revision == 0U) {
-    game_state_revision = 1U;
+  bool bump = game_event_type_bumps_revision(ev->type);
+  if (bump) {
+    game_state_revision++;
+    if (game_state_revision == 0U) {
+      game_state_revision = 1U;
+    }
+  }
+  ev->revision = game_state_revision;
+  ev->timestamp_ms = (uint32_t)(esp_timer_get_time() / 1000);
+  (void)game_event_publish(ev);
+  /* Lift/hodiny snapshot nemění — odběratelé je čtou kurzorem ve své smyčce. */
+  if (bump) {
+    game_task_wdt_reset_safe();
+    czechmate_on_game_state_changed();
   }
   game_task_wdt_reset_safe();
-  czechmate_on_game_state_changed();
-  game_task_wdt_reset_safe();
+}
+
+void game_emit_simple_event(game_event_type_t type) {
+  game_event_t ev = {.type = (uint8_t)type};
+  game_emit_event(&ev);
+}
+
+void game_bump_revision_and_notify(void) {
+  game_emit_simple_event(GAME_EVENT_STATE_CHANGED);
 }
 
 uint32_t game_get_state_revision(void) { return game_state_revision; }
@@ -352,7 +370,7 @@ void game_reset_game(void) {
   game_matrix_guard_clear_both_layers();
 
   ESP_LOGI(TAG, "Game reset completed");
-  game_bump_revision_and_notify();
+  game_emit_simple_event(GAME_EVENT_GAME_STARTED);
 }
 
 /**
@@ -568,7 +586,7 @@ void game_start_new_game(void) {
         TAG,
         "⏸️  Boot sequence: Skipping movable pieces highlight (first game)");
   }
-  game_bump_revision_and_notify();
+  game_emit_simple_event(GAME_EVENT_GAME_STARTED);
 }
 
 void game_start_new_game_from_fen(const char *fen) {
@@ -664,6 +682,6 @@ void game_start_new_game_from_fen(const char *fen) {
     chess_policy_highlight_movable_if_enabled();
     game_task_wdt_reset_safe();
   }
-  game_bump_revision_and_notify();
+  game_emit_simple_event(GAME_EVENT_GAME_STARTED);
 }
 
@@ -0,0 +1,288 @@
+/**
+ * @file game_journal.c
+ * @brief Write-ahead journal tahu v ringu sektoru oddilu `journal`.
+ *
+ * Zaznam: [magic][type][len u16][epoch u32][crc32 u32] + payload, zarovnano
+ * na 4 B. Hlavicka epochy nese CRC checkpointu v NVS; delty epochy za ni.
+ * Pri prvnim pouziti se oddil jednou projde (najde nejnovejsi hlavicku).
+ */
+
+#include "game_journal.h"
+
+#include "esp_log.h"
+#include "esp_partition.h"
+#include "esp_rom_crc.h"
+
+#include <inttypes.h>
+#include <stddef.h>
+#include <string.h>
+
+static const char *TAG = "GAME_JOURNAL";
+
+#define JOURNAL_MAGIC 0x4A
+#define JOURNAL_REC_HEADER 1
+#define JOURNAL_REC_DELTA 2
+#define JOURNAL_ALIGN 4
+
+typedef struct __attribute__((packed)) {
+  uint8_t magic;
+  uint8_t type;
+  uint16_t len;
+  uint32_t epoch;
+  uint32_t crc; ///< CRC32 pres hlavicku (bez crc) + payload
+} journal_rec_t;
+
+static const esp_partition_t *s_part;
+static bool s_scanned;
+static uint32_t s_sector_size;
+static uint32_t s_sectors;
+
+/* Vysledek skenu: nejnovejsi hlavicka ve flash. */
+static uint32_t s_max_epoch;
+static uint32_t s_head_epoch; ///< 0 = zadna
+static uint32_t s_head_off;
+static uint32_t s_head_crc;
+static uint32_t s_fresh_sector; ///< Kde zacne prvni epocha po bootu
+
+/* Otevrena epocha (zapis). */
+static bool s_open;
+static uint32_t s_epoch;
+static uint32_t s_epoch_sector; ///< Sektor hlavicky — ring ho nesmi prepsat
+static uint32_t s_wr;           ///< Dalsi zapis (offset v oddilu)
+static uint32_t s_wr_end;       ///< Konec smazaneho sektoru se s_wr
+static bool s_wr_live; ///< s_wr je platna pozice (prezije close_epoch)
+static uint32_t s_records;
+
+static size_t journal_rec_size(size_t len) {
+  return (sizeof(journal_rec_t) + len + JOURNAL_ALIGN - 1) &
+         ~(size_t)(JOURNAL_ALIGN - 1);
+}
+
+static uint32_t journal_crc(const journal_rec_t *r, const uint8_t *payload) {
+  uint32_t crc =
+      esp_rom_crc32_le(0, (const uint8_t *)r, offsetof(journal_rec_t, crc));
+  return esp_rom_crc32_le(crc, payload, r->len);
+}
+
+/** Nacte a overi zaznam; false = konec dat v sektoru (0xFF, torn write). */
+static bool journal_read_rec(uint32_t off, journal_rec_t *r,
+                             uint8_t *payload) {
+  uint32_t sector_end = (off / s_sector_size + 1) * s_sector_size;
+  if (off + sizeof(*r) > sector_end ||
+      esp_partition_read(s_part, off, r, sizeof(*r)) != ESP_OK) {
+    return false;
+  }
+  if (r->magic != JOURNAL_MAGIC || r->len > GAME_JOURNAL_MAX_PAYLOAD ||
+      off + journal_rec_size(r->len) > sector_end) {
+    return false;
+  }
+  if (r->len > 0 &&
+      esp_partition_read(s_part, off + sizeof(*r), payload, r->len) != ESP_OK) {
+    return false;
+  }
+  return journal_crc(r, payload) == r->crc;
+}
+
+static void journal_scan(void) {
+  s_scanned = true;
+  s_part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA,
+                                    ESP_PARTITION_SUBTYPE_ANY,
+                                    GAME_JOURNAL_PARTITION_LABEL);
+  if (s_part == NULL) {
+    ESP_LOGI(TAG, "oddil '%s' nenalezen — snapshot po kazdem tahu do NVS",
+             GAME_JOURNAL_PARTITION_LABEL);
+    return;
+  }
+  s_sector_size = s_part->erase_size ? s_part->erase_size : 4096;
+  s_sectors = s_part->size / s_sector_size;
+  if (s_sectors < 2) {
+    ESP_LOGW(TAG, "oddil '%s' ma mene nez 2 sektory — journal vypnut",
+             GAME_JOURNAL_PARTITION_LABEL);
+    s_part = NULL;
+    return;
+  }
+
+  uint8_t payload[GAME_JOURNAL_MAX_PAYLOAD];
+  for (uint32_t sec = 0; sec < s_sectors; sec++) {
+    uint32_t off = sec * s_sector_size;
+    journal_rec_t r;
+    while (journal_read_rec(off, &r, payload)) {
+      if (r.epoch > s_max_epoch) {
+        s_max_epoch = r.epoch;
+      }
+      if (r.type == JOURNAL_REC_HEADER && r.len == sizeof(uint32_t) &&
+          r.epoch > s_head_epoch) {
+        s_head_epoch = r.epoch;
+        s_head_off = off;
+        memcpy(&s_head_crc, payload, sizeof(s_head_crc));
+      }
+      off += journal_rec_size(r.len);
+    }
+  }
+  s_fresh_sector =
+      s_head_epoch != 0 ? (s_head_off / s_sector_size + 1) % s_sectors : 0;
+  ESP_LOGI(TAG, "oddil %" PRIu32 " × %" PRIu32 " B, posledni epocha %" PRIu32,
+           s_sectors, s_sector_size, s_head_epoch);
+}
+
+bool game_journal_available(void) {
+  if (!s_scanned) {
+    journal_scan();
+  }
+  return s_part != NULL;
+}
+
+bool game_journal_epoch_open(void) { return s_open; }
+
+uint32_t game_journal_records_in_epoch(void) { return s_records; }
+
+void game_journal_close_epoch(void) { s_open = false; }
+
+static esp_err_t journal_enter_sector(uint32_t sector) {
+  uint32_t off = sector * s_sector_size;
+  esp_err_t ret = esp_partition_erase_range(s_part, off, s_sector_size);
+  if (ret != ESP_OK) {
+    ESP_LOGW(TAG, "erase sektoru %" PRIu32 ": %s", sector,
+             esp_err_to_name(ret));
+    return ret;
+  }
+  s_wr = off;
+  s_wr_end = off + s_sector_size;
+  s_wr_live = true;
+  return ESP_OK;
+}
+
+static esp_err_t journal_write(uint8_t type, const uint8_t *payload,
+                               size_t len) {
+  size_t size = journal_rec_size(len);
+  if (s_wr + size > s_wr_end) {
+    uint32_t next = (s_wr_end / s_sector_size) % s_sectors;
+    if (type == JOURNAL_REC_DELTA && next == s_epoch_sector) {
+      return ESP_ERR_NO_MEM; /* ring obkrouzil vlastni epochu → checkpoint */
+    }
+    esp_err_t ret = journal_enter_sector(next);
+    if (ret != ESP_OK) {
+      return ret;
+    }
+  }
+
+  uint8_t buf[sizeof(journal_rec_t) + GAME_JOURNAL_MAX_PAYLOAD + JOURNAL_ALIGN];
+  journal_rec_t *r = (journal_rec_t *)buf;
+  r->magic = JOURNAL_MAGIC;
+  r->type = type;
+  r->len = (uint16_t)len;
+  r->epoch = s_epoch;
+  memcpy(buf + sizeof(*r), payload, len);
+  r->crc = journal_crc(r, buf + sizeof(*r));
+  memset(buf + sizeof(*r) + len, 0xFF, size - sizeof(*r) - len);
+
+  esp_err_t ret = esp_partition_write(s_part, s_wr, buf, size);
+  if (ret != ESP_OK) {
+    ESP_LOGW(TAG, "zapis @0x%" PRIx32 ": %s", s_wr, esp_err_to_name(ret));
+    s_wr_live = false; /* stav flash za s_wr neznamy → dalsi epocha jinam */
+    return ret;
+  }
+  s_wr += size;
+  return ESP_OK;
+}
+
+esp_err_t game_journal_begin_epoch(uint32_t checkpoint_crc) {
+  if (!game_journal_available()) {
+    return ESP_ERR_NOT_SUPPORTED;
+  }
+  /* V behu hlavicka hned za posledni zaznam (i po close_epoch), do dalsiho
+   * sektoru jen kdyz se nevejde — ring rotuje. Po bootu, replay a chybe
+   * zapisu do cisteho sektoru. */
+  if (!s_wr_live) {
+    esp_err_t ret = journal_enter_sector(s_fresh_sector);
+    if (ret != ESP_OK) {
+      return ret;
+    }
+  }
+  s_open = false;
+  s_epoch = ++s_max_epoch;
+  esp_err_t ret = journal_write(JOURNAL_REC_HEADER,
+                                (const uint8_t *)&checkpoint_crc,
+                                sizeof(checkpoint_crc));
+  if (ret != ESP_OK) {
+    s_wr_live = false;
+    s_fresh_sector = (s_wr_end / s_sector_size) % s_sectors;
+    return ret;
+  }
+  s_epoch_sector = (s_wr - 1) / s_sector_size;
+  s_records = 0;
+  s_open = true;
+  return ESP_OK;
+}
+
+esp_err_t game_journal_append(const uint8_t *payload, size_t len) {
+  if (!s_open) {
+    return ESP_ERR_INVALID_STATE;
+  }
+  if (payload == NULL || len == 0 || len > GAME_JOURNAL_MAX_PAYLOAD) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  esp_err_t ret = journal_write(JOURNAL_REC_DELTA, payload, len);
+  if (ret != ESP_OK) {
+    s_open = false;
+    s_wr_live = false;
+    s_fresh_sector = (s_wr_end / s_sector_size) % s_sectors;
+    return ret;
+  }
+  s_records++;
+  return ESP_OK;
+}
+
+esp_err_t game_journal_replay(uint32_t checkpoint_crc,
+                              game_journal_apply_fn apply, void *ctx,
+                              uint32_t *applied_out) {
+  if (applied_out != NULL) {
+    *applied_out = 0;
+  }
+  if (!game_journal_available() || s_head_epoch == 0 || apply == NULL) {
+    return ESP_ERR_NOT_FOUND;
+  }
+  if (s_head_crc != checkpoint_crc) {
+    ESP_LOGI(TAG, "epocha %" PRIu32 " nepatri k checkpointu — bez replay",
+             s_head_epoch);
+    return ESP_ERR_NOT_FOUND;
+  }
+
+  uint8_t payload[GAME_JOURNAL_MAX_PAYLOAD];
+  journal_rec_t r;
+  uint32_t head_sector = s_head_off / s_sector_size;
+  uint32_t sector = head_sector;
+  uint32_t off = s_head_off;
+  if (!journal_read_rec(off, &r, payload)) {
+    return ESP_ERR_NOT_FOUND;
+  }
+  off += journal_rec_size(r.len);
+
+  uint32_t n = 0;
+  for (;;) {
+    if (!journal_read_rec(off, &r, payload)) {
+      /* Konec sektoru (zaznam se nevesel) → epocha muze pokracovat dal. */
+      sector = (sector + 1) % s_sectors;
+      if (sector == head_sector) {
+        break;
+      }
+      off = sector * s_sector_size;
+      if (!journal_read_rec(off, &r, payload)) {
+        break;
+      }
+    }
+    if (r.epoch != s_head_epoch || r.type != JOURNAL_REC_DELTA ||
+        apply(ctx, payload, r.len) != ESP_OK) {
+      break;
+    }
+    n++;
+    off += journal_rec_size(r.len);
+    s_fresh_sector = (sector + 1) % s_sectors;
+  }
+  ESP_LOGI(TAG, "epocha %" PRIu32 ": prehrano %" PRIu32 " zaznamu",
+           s_head_epoch, n);
+  if (applied_out != NULL) {
+    *applied_out = n;
+  }
+  return ESP_OK;
+}
@@ -7,6 +7,7 @@
 #include "game_task.h"
 #include "chess_gameplay_policy.h"
 #include "freertos_chess.h"
+#include "json_writer.h"
 
 #include "../matrix_task/include/matrix_task.h"
 #include "../../timer_system/include/timer_system.h"
@@ -17,8 +18,8 @@
 #include "freertos/semphr.h"
 
 #include <inttypes.h>
-#include <stdarg.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 static const char *TAG = "GAME_JSON";
@@ -33,47 +34,79 @@ static const char *TAG = "GAME_JSON";
 // WEB SERVER JSON EXPORT FUNCTIONS
 // ============================================================================
 
-esp_err_t game_get_board_json(char *buffer, size_t size) {
-  if (buffer == NULL || size == 0) {
-    return ESP_ERR_INVALID_ARG;
+/*
+ * Vsechny exporty pisou pres json_writer_t (cil = buffer, heap nebo sink).
+ * game_write_* berou game_mutex samy. Historie (jedina neomezena cast) se pod
+ * mutexem jen kopiruje a zapisuje az po uvolneni, takze ji lze streamovat.
+ * game_get_*_json(buffer, size) jsou tenke obalky nad pevnym bufferem.
+ */
+
+static esp_err_t game_json_lock(void) {
+  if (game_mutex != NULL &&
+      xSemaphoreTake(game_mutex, pdMS_TO_TICKS(1000)) != pdTRUE) {
+    return ESP_ERR_TIMEOUT;
   }
+  return ESP_OK;
+}
 
-  // Thread-safe access to board
+static void game_json_unlock(void) {
   if (game_mutex != NULL) {
-    if (xSemaphoreTake(game_mutex, pdMS_TO_TICKS(1000)) != pdTRUE) {
-      return ESP_ERR_TIMEOUT;
-    }
+    xSemaphoreGive(game_mutex);
   }
+}
 
-  // Build JSON string manually (more efficient than cJSON)
-  int offset = 0;
-
-  offset += snprintf(buffer + offset, size - offset, "{\"board\":[");
+/** Obalka: writer nad pevnym bufferem + write funkce. */
+static esp_err_t game_json_to_buffer(char *buffer, size_t size,
+                                     esp_err_t (*write)(json_writer_t *w)) {
+  if (buffer == NULL || size == 0) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  json_writer_t w;
+  json_writer_init_buffer(&w, buffer, size);
+  esp_err_t ret = write(&w);
+  if (ret != ESP_OK) {
+    return ret;
+  }
+  ret = json_writer_finish(&w);
+  if (ret == ESP_ERR_NO_MEM) {
+    ESP_LOGE(TAG, "JSON export: buffer %zu B too small", size);
+  }
+  return ret;
+}
 
+esp_err_t game_write_board_fields(json_writer_t *w) {
+  if (w == NULL) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  esp_err_t ret = game_json_lock();
+  if (ret != ESP_OK) {
+    return ret;
+  }
+  json_writer_key(w, "board");
+  json_writer_begin_array(w);
   for (int row = 0; row < 8; row++) {
-    offset += snprintf(buffer + offset, size - offset, "[");
+    json_writer_begin_array(w);
     for (int col = 0; col < 8; col++) {
-      char piece_char = piece_to_char(board[row][col]);
-      offset += snprintf(buffer + offset, size - offset, "\"%c\"", piece_char);
-      if (col < 7) {
-        offset += snprintf(buffer + offset, size - offset, ",");
-      }
-    }
-    offset += snprintf(buffer + offset, size - offset, "]");
-    if (row < 7) {
-      offset += snprintf(buffer + offset, size - offset, ",");
+      json_writer_char(w, piece_to_char(board[row][col]));
     }
+    json_writer_end_array(w);
   }
+  json_writer_end_array(w);
+  game_json_unlock();
 
-  uint64_t timestamp = esp_timer_get_time() / 1000;
-  offset += snprintf(buffer + offset, size - offset, "],\"timestamp\":%llu}",
-                     timestamp);
+  json_writer_kv_uint(w, "timestamp", (uint64_t)(esp_timer_get_time() / 1000));
+  return json_writer_error(w);
+}
 
-  if (game_mutex != NULL) {
-    xSemaphoreGive(game_mutex);
-  }
+static esp_err_t game_write_board_object(json_writer_t *w) {
+  json_writer_begin_object(w);
+  esp_err_t ret = game_write_board_fields(w);
+  json_writer_end_object(w);
+  return ret;
+}
 
-  return ESP_OK;
+esp_err_t game_get_board_json(char *buffer, size_t size) {
+  return game_json_to_buffer(buffer, size, game_write_board_object);
 }
 
 /**
@@ -88,455 +121,514 @@ uint32_t game_get_move_count(void) {
   return count;
 }
 
-static esp_err_t game_status_json_append(size_t *offset, char *buffer, size_t size,
-                                        const char *fmt, ...) {
-  va_list ap;
-  va_start(ap, fmt);
-  if (*offset >= size) {
-    va_end(ap);
-    ESP_LOGE(TAG, "game_get_status_json: offset invalid %zu", *offset);
-    return ESP_ERR_NO_MEM;
-  }
-  size_t rem = size - *offset;
-  if (rem <= 1) {
-    va_end(ap);
-    return ESP_ERR_NO_MEM;
-  }
-  int n = vsnprintf(buffer + *offset, rem, fmt, ap);
-  va_end(ap);
-  if (n < 0 || (size_t)n >= rem) {
-    ESP_LOGE(TAG,
-             "game_get_status_json: append overflow need=%d rem=%zu off=%zu", n,
-             rem, *offset);
-    return ESP_ERR_NO_MEM;
-  }
-  *offset += (size_t)n;
-  return ESP_OK;
-}
-
-#define GAME_STATUS_JSON_APPEND(...)                                           \
-  do {                                                                         \
-    if (game_status_json_append(&offset, buffer, size, __VA_ARGS__) !=         \
-        ESP_OK) {                                                              \
-      if (game_mutex != NULL)                                                  \
-        xSemaphoreGive(game_mutex);                                            \
-      return ESP_ERR_NO_MEM;                                                   \
-    }                                                                          \
-  } while (0)
-
-esp_err_t game_get_status_json(char *buffer, size_t size) {
-  if (buffer == NULL || size == 0) {
-    return ESP_ERR_INVALID_ARG;
-  }
-
-  // Thread-safe access to game state
-  if (game_mutex != NULL) {
-    if (xSemaphoreTake(game_mutex, pdMS_TO_TICKS(1000)) != pdTRUE) {
-      return ESP_ERR_TIMEOUT;
-    }
-  }
-
-  // Build JSON string
-  size_t offset = 0;
-
-  // Game state string
-  const char *game_state_str = "idle";
-  switch (current_game_state) {
+static const char *game_state_json_name(game_state_t state) {
+  switch (state) {
   case GAME_STATE_ACTIVE:
-    game_state_str = "active";
-    break;
+  case GAME_STATE_WAITING_FOR_RETURN:
+    return "active";
   case GAME_STATE_PAUSED:
-    game_state_str = "paused";
-    break;
+    return "paused";
   case GAME_STATE_FINISHED:
-    game_state_str = "finished";
-    break;
+    return "finished";
   case GAME_STATE_PROMOTION:
-    game_state_str = "promotion";
-    break;
-  case GAME_STATE_WAITING_FOR_RETURN:
-    game_state_str = "active";
-    break;
+    return "promotion";
   case GAME_STATE_PLAYING:
-    game_state_str = "playing";
-    break;
+    return "playing";
   default:
-    game_state_str = "idle";
-    break;
+    return "idle";
   }
+}
 
+static const char *game_endgame_reason_name(endgame_reason_t reason) {
+  switch (reason) {
+  case ENDGAME_REASON_CHECKMATE:
+    return "Checkmate";
+  case ENDGAME_REASON_CHECKMATE_EN_PASSANT:
+    return "Checkmate (En Passant)";
+  case ENDGAME_REASON_CHECKMATE_CASTLING:
+    return "Checkmate (Castling)";
+  case ENDGAME_REASON_CHECKMATE_PROMOTION:
+    return "Checkmate (Promotion)";
+  case ENDGAME_REASON_CHECKMATE_DISCOVERED:
+    return "Checkmate (Discovered Check)";
+  case ENDGAME_REASON_RESIGNATION:
+    return "Resignation";
+  case ENDGAME_REASON_TIMEOUT:
+    return "Timeout";
+  case ENDGAME_REASON_STALEMATE:
+    return "Stalemate";
+  case ENDGAME_REASON_50_MOVE:
+    return "50-move rule";
+  case ENDGAME_REASON_REPETITION:
+    return "Threefold repetition";
+  case ENDGAME_REASON_INSUFFICIENT:
+    return "Insufficient material";
+  }
+  return "Unknown";
+}
+
+static void game_write_square_notation(json_writer_t *w, const char *key,
+                                       uint8_t row, uint8_t col) {
+  char notation[4] = {0};
+  convert_coords_to_notation(row, col, notation);
+  json_writer_kv_string(w, key, notation);
+}
+
+static void game_write_occupancy_array(json_writer_t *w, const char *key,
+                                       const uint8_t occ[64]) {
+  json_writer_key(w, key);
+  json_writer_begin_array(w);
+  for (int i = 0; i < 64; i++) {
+    json_writer_uint(w, occ[i]);
+  }
+  json_writer_end_array(w);
+}
+
+/** Clenove status objektu — volat pod game_mutex. */
+static void game_write_status_fields_locked(json_writer_t *w) {
   // Check detection
   bool in_check = game_is_king_in_check(current_player);
 
-  // Checkmate detection (simplified - king in check and no legal moves)
+  // Checkmate = sach a zadny legalni tah, stalemate = bez sachu a bez tahu
   bool checkmate = false;
+  bool stalemate = false;
+  uint32_t legal_moves = game_generate_legal_moves(current_player);
   if (in_check) {
-    // Try to generate legal moves - if none, it's checkmate
-    uint32_t legal_moves = game_generate_legal_moves(current_player);
     checkmate = (legal_moves == 0);
-  }
-
-  // Stalemate detection (simplified - not in check but no legal moves)
-  bool stalemate = false;
-  if (!in_check) {
-    uint32_t legal_moves = game_generate_legal_moves(current_player);
+  } else {
     stalemate = (legal_moves == 0);
   }
 
-  GAME_STATUS_JSON_APPEND("{\"game_state\":\"%s\","
-                          "\"current_player\":\"%s\","
-                          "\"move_count\":%" PRIu32 ","
-                          "\"white_time\":%" PRIu32 ","
-                          "\"black_time\":%" PRIu32 ","
-                          "\"in_check\":%s,"
-                          "\"checkmate\":%s,"
-                          "\"stalemate\":%s",
-                          game_state_str,
-                          (current_player == PLAYER_WHITE) ? "White" : "Black",
-                          move_count, white_time_total, black_time_total,
-                          in_check ? "true" : "false", checkmate ? "true" : "false",
-                          stalemate ? "true" : "false");
+  json_writer_kv_string(w, "game_state",
+                        game_state_json_name(current_game_state));
+  json_writer_kv_string(w, "current_player",
+                        (current_player == PLAYER_WHITE) ? "White" : "Black");
+  json_writer_kv_uint(w, "move_count", move_count);
+  json_writer_kv_uint(w, "white_time", white_time_total);
+  json_writer_kv_uint(w, "black_time", black_time_total);
+  json_writer_kv_bool(w, "in_check", in_check);
+  json_writer_kv_bool(w, "checkmate", checkmate);
+  json_writer_kv_bool(w, "stalemate", stalemate);
 
   // Piece lifted info
+  json_writer_key(w, "piece_lifted");
+  json_writer_begin_object(w);
+  json_writer_kv_bool(w, "lifted", piece_lifted);
   if (piece_lifted) {
-    char piece_char = piece_to_char(lifted_piece);
-    char notation[4] = {0};
-    convert_coords_to_notation(lifted_piece_row, lifted_piece_col, notation);
-    GAME_STATUS_JSON_APPEND(",\"piece_lifted\":{\"lifted\":true,\"row\":%d,"
-                            "\"col\":%d,"
-                            "\"piece\":\"%c\",\"notation\":\"%s\"}",
-                            lifted_piece_row, lifted_piece_col, piece_char,
-                            notation);
+    json_writer_kv_uint(w, "row", lifted_piece_row);
+    json_writer_kv_uint(w, "col", lifted_piece_col);
+    json_writer_kv_char(w, "piece", piece_to_char(lifted_piece));
+    game_write_square_notation(w, "notation", lifted_piece_row,
+                               lifted_piece_col);
   } else {
-    GAME_STATUS_JSON_APPEND(",\"piece_lifted\":{\"lifted\":false,\"row\":0,"
-                            "\"col\":"
-                            "0,\"piece\":\" \",\"notation\":\"\"}");
+    json_writer_kv_uint(w, "row", 0);
+    json_writer_kv_uint(w, "col", 0);
+    json_writer_kv_char(w, "piece", ' ');
+    json_writer_kv_string(w, "notation", "");
   }
+  json_writer_end_object(w);
 
   /* Rošáda na 2 tahy: web musí vědět, že má čekat na tah věže (deska je mezistav). */
+  json_writer_kv_bool(w, "castling_in_progress", castling_state.in_progress);
   if (castling_state.in_progress) {
-    char cf[4] = {0}, ct[4] = {0};
-    convert_coords_to_notation(castling_state.rook_from_row,
-                              castling_state.rook_from_col, cf);
-    convert_coords_to_notation(castling_state.rook_to_row,
-                              castling_state.rook_to_col, ct);
-    GAME_STATUS_JSON_APPEND(",\"castling_in_progress\":true,"
-                            "\"castling_from\":\"%s\","
-                            "\"castling_to\":\"%s\"",
-                            cf, ct);
-  } else {
-    GAME_STATUS_JSON_APPEND(",\"castling_in_progress\":false");
+    game_write_square_notation(w, "castling_from", castling_state.rook_from_row,
+                               castling_state.rook_from_col);
+    game_write_square_notation(w, "castling_to", castling_state.rook_to_row,
+                               castling_state.rook_to_col);
   }
 
   // Game end information - použít current_endgame_reason pro přesné
   // rozlišení
+  json_writer_key(w, "game_end");
+  json_writer_begin_object(w);
   if (current_game_state == GAME_STATE_FINISHED) {
-    const char *end_reason = "Unknown";
-    const char *winner = "None";
-    const char *loser = "None";
-
-    // Nejprve určit vítěze
+    const char *winner = "Draw";
+    const char *loser = "Draw";
     if (current_result_type == RESULT_WHITE_WINS) {
       winner = "White";
       loser = "Black";
     } else if (current_result_type == RESULT_BLACK_WINS) {
       winner = "Black";
       loser = "White";
-    } else {
-      winner = "Draw";
-      loser = "Draw";
     }
-
-    // Pak určit důvod podle current_endgame_reason
-    switch (current_endgame_reason) {
-    case ENDGAME_REASON_CHECKMATE:
-      end_reason = "Checkmate";
-      break;
-    case ENDGAME_REASON_CHECKMATE_EN_PASSANT:
-      end_reason = "Checkmate (En Passant)";
-      break;
-    case ENDGAME_REASON_CHECKMATE_CASTLING:
-      end_reason = "Checkmate (Castling)";
-      break;
-    case ENDGAME_REASON_CHECKMATE_PROMOTION:
-      end_reason = "Checkmate (Promotion)";
-      break;
-    case ENDGAME_REASON_CHECKMATE_DISCOVERED:
-      end_reason = "Checkmate (Discovered Check)";
-      break;
-    case ENDGAME_REASON_RESIGNATION:
-      end_reason = "Resignation";
-      break;
-    case ENDGAME_REASON_TIMEOUT:
-      end_reason = "Timeout";
-      break;
-    case ENDGAME_REASON_STALEMATE:
-      end_reason = "Stalemate";
-      break;
-    case ENDGAME_REASON_50_MOVE:
-      end_reason = "50-move rule";
-      break;
-    case ENDGAME_REASON_REPETITION:
-      end_reason = "Threefold repetition";
-      break;
-    case ENDGAME_REASON_INSUFFICIENT:
-      end_reason = "Insufficient material";
-      break;
-    }
-
-    GAME_STATUS_JSON_APPEND(",\"game_end\":{\"ended\":true,\"reason\":\"%s\","
-                            "\"winner\":\"%s\",\"loser\":\"%s\"}",
-                            end_reason, winner, loser);
+    json_writer_kv_bool(w, "ended", true);
+    json_writer_kv_string(w, "reason",
+                          game_endgame_reason_name(current_endgame_reason));
+    json_writer_kv_string(w, "winner", winner);
+    json_writer_kv_string(w, "loser", loser);
   } else {
-    GAME_STATUS_JSON_APPEND(",\"game_end\":{\"ended\":false,\"reason\":\"\","
-                            "\"winner\":\"\",\"loser\":\"\"}");
+    json_writer_kv_bool(w, "ended", false);
+    json_writer_kv_string(w, "reason", "");
+    json_writer_kv_string(w, "winner", "");
+    json_writer_kv_string(w, "loser", "");
   }
+  json_writer_end_object(w);
 
   // Error recovery state pro vizuální indikaci na webu
+  json_writer_key(w, "error_state");
+  json_writer_begin_object(w);
+  json_writer_kv_bool(w, "active",
+                      error_recovery_state.waiting_for_move_correction);
   if (error_recovery_state.waiting_for_move_correction) {
-    char invalid_notation[4] = {0};
-    char original_notation[4] = {0};
-    convert_coords_to_notation(error_recovery_state.invalid_row,
-                               error_recovery_state.invalid_col,
-                               invalid_notation);
-    convert_coords_to_notation(error_recovery_state.original_valid_row,
-                               error_recovery_state.original_valid_col,
-                               original_notation);
-
-    GAME_STATUS_JSON_APPEND(",\"error_state\":{\"active\":true,"
-                            "\"invalid_pos\":\"%s\","
-                            "\"original_pos\":\"%s\","
-                            "\"error_count\":%d}",
-                            invalid_notation, original_notation,
-                            error_recovery_state.error_count);
-  } else {
-    /* Uzavřít objekt error_state — dříve chybějící } rozbíjelo JSON (restore_state
-     * vnořený do error_state). */
-    GAME_STATUS_JSON_APPEND(",\"error_state\":{\"active\":false}");
-  }
-
-  GAME_STATUS_JSON_APPEND(",\"gameplay_profile\":\"%s\"",
-                          chess_policy_profile_name());
-
-  GAME_STATUS_JSON_APPEND(
-      ",\"restore_state\":{\"snapshot_loaded\":%s,\"snapshot_fallback_used\":%s,"
-      "\"snapshot_restore_failed\":%s,\"snapshot_save_failed\":%s,"
-      "\"resync_required\":%s,"
-      "\"boot_new_game_triggered\":%s}",
-      game_was_snapshot_loaded_on_boot() ? "true" : "false",
-      game_is_snapshot_fallback_used() ? "true" : "false",
-      game_has_snapshot_restore_failure() ? "true" : "false",
-      game_has_snapshot_save_failure() ? "true" : "false",
-      resync_required_after_restore ? "true" : "false",
-      game_was_boot_new_game_triggered() ? "true" : "false");
-
-  GAME_STATUS_JSON_APPEND(",\"board_setup_tutorial\":%s",
-                            board_setup_tutorial_active ? "true" : "false");
-
-  const game_puzzle_definition_t *pd_play =
-      game_get_puzzle_definition(puzzle_active_id);
-  const game_puzzle_definition_t *pd_setup =
-      game_get_puzzle_definition(puzzle_setup_id);
-  const game_puzzle_definition_t *pd =
-      puzzle_active ? pd_play : (puzzle_setup_active ? pd_setup : NULL);
+    game_write_square_notation(w, "invalid_pos", error_recovery_state.invalid_row,
+                               error_recovery_state.invalid_col);
+    game_write_square_notation(w, "original_pos",
+                               error_recovery_state.original_valid_row,
+                               error_recovery_state.original_valid_col);
+    json_writer_kv_int(w, "error_count", error_recovery_state.error_count);
+  }
+  json_writer_end_object(w);
+
+  json_writer_kv_string(w, "gameplay_profile", chess_policy_profile_name());
+
+  json_writer_key(w, "restore_state");
+  json_writer_begin_object(w);
+  json_writer_kv_bool(w, "snapshot_loaded", game_was_snapshot_loaded_on_boot());
+  json_writer_kv_bool(w, "snapshot_fallback_used",
+                      game_is_snapshot_fallback_used());
+  json_writer_kv_bool(w, "snapshot_restore_failed",
+                      game_has_snapshot_restore_failure());
+  json_writer_kv_bool(w, "snapshot_save_failed",
+                      game_has_snapshot_save_failure());
+  json_writer_kv_bool(w, "resync_required", resync_required_after_restore);
+  json_writer_kv_bool(w, "boot_new_game_triggered",
+                      game_was_boot_new_game_triggered());
+  json_writer_end_object(w);
+
+  json_writer_kv_bool(w, "board_setup_tutorial", board_setup_tutorial_active);
+
+  const game_puzzle_t *pz = game_puzzle_current();
   bool puzzle_phys_match = false;
-  if (puzzle_setup_active && pd_setup != NULL) {
-    puzzle_phys_match = game_puzzle_physical_matches_fen(pd_setup->fen);
-  }
-  const char *puzzle_fen_json = "";
-  if (puzzle_setup_active && pd_setup != NULL) {
-    puzzle_fen_json = pd_setup->fen;
-  } else if (puzzle_active && pd_play != NULL) {
-    puzzle_fen_json = pd_play->fen;
-  }
-  GAME_STATUS_JSON_APPEND(",\"puzzle\":{\"active\":%s,\"setup_active\":%s,"
-                          "\"setup_id\":%u,\"physical_match\":%s,\"fen\":\"%s\","
-                          "\"id\":%u,\"difficulty\":%u,"
-                          "\"title\":\"%s\",\"teaser\":\"%s\",\"feedback\":\"%s\","
-                          "\"message\":\"%s\"}",
-                          puzzle_active ? "true" : "false",
-                          puzzle_setup_active ? "true" : "false",
-                          (unsigned)puzzle_setup_id,
-                          puzzle_phys_match ? "true" : "false", puzzle_fen_json,
-                          (unsigned)(puzzle_active ? puzzle_active_id
-                                                   : (puzzle_setup_active
-                                                          ? puzzle_setup_id
-                                                          : 0)),
-                          (unsigned)(pd ? pd->difficulty : 0U), pd ? pd->title : "",
-                          pd ? pd->teaser : "", game_puzzle_feedback_key(),
-                          game_puzzle_feedback_message());
-
-  game_opening_export_status_json(buffer, size, &offset);
+  if (puzzle_setup_active && pz != NULL) {
+    puzzle_phys_match = game_puzzle_physical_matches_fen(pz->fen);
+  }
+  json_writer_key(w, "puzzle");
+  json_writer_begin_object(w);
+  json_writer_kv_bool(w, "active", puzzle_active);
+  json_writer_kv_bool(w, "setup_active", puzzle_setup_active);
+  json_writer_kv_uint(w, "setup_id", puzzle_setup_id);
+  json_writer_kv_bool(w, "physical_match", puzzle_phys_match);
+  json_writer_kv_string(w, "fen", pz ? pz->fen : "");
+  json_writer_kv_uint(w, "id", pz ? pz->id : 0U);
+  json_writer_kv_uint(w, "rating", pz ? pz->rating : 0U);
+  json_writer_key(w, "themes");
+  game_puzzle_db_write_themes(w, pz ? pz->themes : 0U);
+  json_writer_kv_uint(w, "ply", pz ? game_puzzle_current_ply() : 0U);
+  json_writer_kv_uint(w, "plies", pz ? pz->plies : 0U);
+  json_writer_kv_string(w, "feedback", game_puzzle_feedback_key());
+  json_writer_kv_string(w, "message", game_puzzle_feedback_message());
+  json_writer_end_object(w);
+
+  game_opening_write_status_fields(w);
 
   if (board_setup_tutorial_active || puzzle_setup_active ||
       game_opening_status_needs_matrix()) {
     uint8_t occ[64];
     matrix_get_state(occ);
-    GAME_STATUS_JSON_APPEND(",\"matrix_occupied\":[");
-    for (int i = 0; i < 64; i++) {
-      GAME_STATUS_JSON_APPEND("%s%u", (i > 0) ? "," : "",
-                              (unsigned int)occ[i]);
-    }
-    GAME_STATUS_JSON_APPEND("]");
+    game_write_occupancy_array(w, "matrix_occupied", occ);
   }
+}
 
-  GAME_STATUS_JSON_APPEND("}");
-
-#undef GAME_STATUS_JSON_APPEND
-
-  buffer[offset] = '\0';
-  if (strstr(buffer, "\"game_state\"") == NULL) {
-    ESP_LOGE(TAG, "game_get_status_json: missing game_state in output");
-    if (game_mutex != NULL) {
-      xSemaphoreGive(game_mutex);
-    }
-    return ESP_FAIL;
+esp_err_t game_write_status_fields(json_writer_t *w) {
+  if (w == NULL) {
+    return ESP_ERR_INVALID_ARG;
   }
+  esp_err_t ret = game_json_lock();
+  if (ret != ESP_OK) {
+    return ret;
+  }
+  game_write_status_fields_locked(w);
+  game_json_unlock();
 
 #ifndef NDEBUG
-  STAGING_LOGI(TAG, "game_get_status_json: len=%d cap=%zu", offset, size);
+  STAGING_LOGI(TAG, "game_write_status_fields: total=%zu",
+               json_writer_total(w));
 #endif
+  return json_writer_error(w);
+}
 
-  if (game_mutex != NULL) {
-    xSemaphoreGive(game_mutex);
-  }
+static esp_err_t game_write_status_object(json_writer_t *w) {
+  json_writer_begin_object(w);
+  esp_err_t ret = game_write_status_fields(w);
+  json_writer_end_object(w);
+  return ret;
+}
 
-  return ESP_OK;
+esp_err_t game_get_status_json(char *buffer, size_t size) {
+  return game_json_to_buffer(buffer, size, game_write_status_object);
 }
 
-esp_err_t game_get_history_json(char *buffer, size_t size) {
-  if (buffer == NULL || size == 0) {
+static void game_write_move_json(json_writer_t *w, const chess_move_t *m) {
+  char from_notation[4] = {0};
+  char to_notation[4] = {0};
+  convert_coords_to_notation(m->from_row, m->from_col, from_notation);
+  convert_coords_to_notation(m->to_row, m->to_col, to_notation);
+  json_writer_begin_object(w);
+  json_writer_kv_string(w, "from", from_notation);
+  json_writer_kv_string(w, "to", to_notation);
+  json_writer_kv_char(w, "piece", piece_to_char(m->piece));
+  json_writer_kv_uint(w, "timestamp", m->timestamp);
+  json_writer_end_object(w);
+}
+
+esp_err_t game_write_history_json(json_writer_t *w) {
+  if (w == NULL) {
     return ESP_ERR_INVALID_ARG;
   }
-
-  // Thread-safe access to move history
-  if (game_mutex != NULL) {
-    if (xSemaphoreTake(game_mutex, pdMS_TO_TICKS(1000)) != pdTRUE) {
-      return ESP_ERR_TIMEOUT;
+  /* Kopie pod mutexem, zapis az po uvolneni — sink (HTTP chunk) muze cekat
+   * na sit a game task nesmi stat. 200 tahu = 2.4 KiB na heapu. */
+  esp_err_t ret = game_json_lock();
+  if (ret != ESP_OK) {
+    return ret;
+  }
+  uint32_t count = history_index < GAME_TASK_MAX_MOVES_HISTORY
+                       ? history_index
+                       : GAME_TASK_MAX_MOVES_HISTORY;
+  chess_move_t *moves = NULL;
+  if (count > 0) {
+    moves = malloc(count * sizeof(chess_move_t));
+    if (moves == NULL) {
+      game_json_unlock();
+      return ESP_ERR_NO_MEM;
     }
+    memcpy(moves, move_history, count * sizeof(chess_move_t));
+  }
+  game_json_unlock();
+
+  json_writer_begin_object(w);
+  json_writer_key(w, "moves");
+  json_writer_begin_array(w);
+  for (uint32_t i = 0; i < count; i++) {
+    game_write_move_json(w, &moves[i]);
   }
+  json_writer_end_array(w);
+  json_writer_end_object(w);
+  free(moves);
+  return json_writer_error(w);
+}
 
-  // Build JSON string
-  int offset = 0;
-  offset += snprintf(buffer + offset, size - offset, "{\"moves\":[");
+esp_err_t game_get_history_json(char *buffer, size_t size) {
+  return game_json_to_buffer(buffer, size, game_write_history_json);
+}
 
-  for (uint32_t i = 0; i < history_index && i < GAME_TASK_MAX_MOVES_HISTORY; i++) {
-    char from_notation[4] = {0};
-    char to_notation[4] = {0};
-    convert_coords_to_notation(move_history[i].from_row,
-                               move_history[i].from_col, from_notation);
-    convert_coords_to_notation(move_history[i].to_row, move_history[i].to_col,
-                               to_notation);
-    char piece_char = piece_to_char(move_history[i].piece);
+// ============================================================================
+// STREAMOVANY EXPORT HISTORIE (JSON Lines / PGN)
+// ============================================================================
 
-    offset += snprintf(buffer + offset, size - offset,
-                       "{\"from\":\"%s\",\"to\":\"%s\",\"piece\":\"%c\","
-                       "\"timestamp\":%" PRIu32 "}",
-                       from_notation, to_notation, piece_char,
-                       move_history[i].timestamp);
+/** Pultahu na jednu kopii pod game_mutex (16 × 12 B na stacku). */
+#define GAME_HISTORY_STREAM_BATCH 16
+/** PGN: cislovanych tahu na radek (radek < 80 znaku). */
+#define GAME_PGN_MOVES_PER_LINE 6
 
-    if (i < history_index - 1 && i < GAME_TASK_MAX_MOVES_HISTORY - 1) {
-      offset += snprintf(buffer + offset, size - offset, ",");
-    }
+static uint32_t game_history_length_locked(void) {
+  return history_index < GAME_TASK_MAX_MOVES_HISTORY
+             ? history_index
+             : GAME_TASK_MAX_MOVES_HISTORY;
+}
+
+uint32_t game_get_history_length(void) {
+  if (game_json_lock() != ESP_OK) {
+    return 0;
   }
+  uint32_t n = game_history_length_locked();
+  game_json_unlock();
+  return n;
+}
 
-  offset += snprintf(buffer + offset, size - offset, "]}");
+/** PGN vysledek; "*" = partie bezi (nebo skoncila bez zname strany). */
+static const char *game_pgn_result_locked(void) {
+  if (game_result != GAME_STATE_FINISHED) {
+    return "*";
+  }
+  switch (current_result_type) {
+  case RESULT_WHITE_WINS:
+    return "1-0";
+  case RESULT_BLACK_WINS:
+    return "0-1";
+  default:
+    return "1/2-1/2";
+  }
+}
 
-  if (game_mutex != NULL) {
-    xSemaphoreGive(game_mutex);
+static void game_write_move_jsonl(json_writer_t *w, uint32_t ply,
+                                  const chess_move_t *m) {
+  char from_notation[4] = {0};
+  char to_notation[4] = {0};
+  convert_coords_to_notation(m->from_row, m->from_col, from_notation);
+  convert_coords_to_notation(m->to_row, m->to_col, to_notation);
+  json_writer_begin_object(w);
+  json_writer_kv_uint(w, "ply", ply);
+  json_writer_kv_string(w, "from", from_notation);
+  json_writer_kv_string(w, "to", to_notation);
+  json_writer_kv_char(w, "piece", piece_to_char(m->piece));
+  if (m->captured_piece != PIECE_EMPTY) {
+    json_writer_kv_char(w, "captured", piece_to_char(m->captured_piece));
+  }
+  json_writer_kv_uint(w, "timestamp", m->timestamp);
+  json_writer_end_object(w);
+  json_writer_text(w, "\n", 1);
+}
+
+/** Jeden pultah PGN: "12. e2e4" / "e7e5" / "12... e7e5", rosady jako O-O. */
+static void game_write_move_pgn(json_writer_t *w, uint32_t ply, bool first,
+                                const chess_move_t *m, move_type_t kind) {
+  char text[24];
+  int n = 0;
+  if ((ply % 2) == 0) {
+    bool wrap = !first && (ply / 2) % GAME_PGN_MOVES_PER_LINE == 0;
+    const char *sep = wrap ? "\n" : (first ? "" : " ");
+    n = snprintf(text, sizeof(text), "%s%" PRIu32 ". ", sep, ply / 2 + 1);
+  } else if (first) {
+    n = snprintf(text, sizeof(text), "%" PRIu32 "... ", ply / 2 + 1);
+  } else {
+    n = snprintf(text, sizeof(text), " ");
+  }
+  if (kind == MOVE_TYPE_CASTLE_KING) {
+    n += snprintf(text + n, sizeof(text) - n, "O-O");
+  } else if (kind == MOVE_TYPE_CASTLE_QUEEN) {
+    n += snprintf(text + n, sizeof(text) - n, "O-O-O");
+  } else {
+    char from[4] = {0};
+    char to[4] = {0};
+    game_coords_to_square(m->from_row, m->from_col, from);
+    game_coords_to_square(m->to_row, m->to_col, to);
+    n += snprintf(text + n, sizeof(text) - n, "%s%s", from, to);
   }
+  json_writer_text(w, text, (size_t)n);
+}
 
-  return ESP_OK;
+static void game_write_pgn_tags(json_writer_t *w, const char *result) {
+  static const char tags[] = "[Event \"CzechMate game\"]\n"
+                             "[Site \"CzechMate board\"]\n"
+                             "[Date \"????.??.??\"]\n"
+                             "[Round \"-\"]\n"
+                             "[White \"White\"]\n"
+                             "[Black \"Black\"]\n";
+  json_writer_text(w, tags, sizeof(tags) - 1);
+  json_writer_text(w, "[Result \"", 9);
+  json_writer_text(w, result, strlen(result));
+  json_writer_text(w, "\"]\n\n", 4);
 }
 
-esp_err_t game_get_captured_json(char *buffer, size_t size) {
-  if (buffer == NULL || size == 0) {
+esp_err_t game_write_history_stream(json_writer_t *w,
+                                    game_history_format_t fmt, uint32_t start,
+                                    uint32_t end, uint32_t *next_out) {
+  if (w == NULL) {
     return ESP_ERR_INVALID_ARG;
   }
-
-  // Thread-safe access to captured pieces
-  if (game_mutex != NULL) {
-    if (xSemaphoreTake(game_mutex, pdMS_TO_TICKS(1000)) != pdTRUE) {
-      return ESP_ERR_TIMEOUT;
+  chess_move_t batch[GAME_HISTORY_STREAM_BATCH];
+  move_type_t kinds[GAME_HISTORY_STREAM_BATCH];
+  uint32_t next = start;
+  bool at_end = false;
+  bool first = true;
+  const char *result = "*";
+
+  for (;;) {
+    /* Jen kopie davky pod mutexem; zapis do sinku (sit) az po uvolneni. */
+    esp_err_t ret = game_json_lock();
+    if (ret != ESP_OK) {
+      return ret;
     }
-  }
-
-  // Build JSON string
-  int offset = 0;
-  offset += snprintf(buffer + offset, size - offset, "{\"white_captured\":[");
+    uint32_t len = game_history_length_locked();
+    uint32_t stop = end < len ? end : len;
+    uint32_t n = 0;
+    if (next < stop) {
+      n = stop - next;
+      if (n > GAME_HISTORY_STREAM_BATCH) {
+        n = GAME_HISTORY_STREAM_BATCH;
+      }
+      memcpy(batch, &move_history[next], n * sizeof(chess_move_t));
+      memcpy(kinds, &move_history_kind[next], n * sizeof(move_type_t));
+    }
+    at_end = (next + n >= len);
+    result = game_pgn_result_locked();
+    game_json_unlock();
 
-  // Add white captured pieces
-  for (uint32_t i = 0; i < white_captured_count; i++) {
-    char piece_char = piece_to_char(white_captured_pieces[i]);
-    offset += snprintf(buffer + offset, size - offset, "\"%c\"", piece_char);
-    if (i < white_captured_count - 1) {
-      offset += snprintf(buffer + offset, size - offset, ",");
+    if (first && fmt == GAME_HISTORY_FORMAT_PGN && start == 0) {
+      game_write_pgn_tags(w, end >= len ? result : "*");
+    }
+    for (uint32_t i = 0; i < n; i++) {
+      if (fmt == GAME_HISTORY_FORMAT_PGN) {
+        game_write_move_pgn(w, next + i, first && i == 0, &batch[i], kinds[i]);
+      } else {
+        game_write_move_jsonl(w, next + i, &batch[i]);
+      }
+    }
+    if (n > 0) {
+      first = false;
+    }
+    next += n;
+    if (n == 0 || next >= stop || json_writer_error(w) != ESP_OK) {
+      break;
     }
   }
 
-  offset += snprintf(buffer + offset, size - offset, "],\"black_captured\":[");
-
-  // Add black captured pieces
-  for (uint32_t i = 0; i < black_captured_count; i++) {
-    char piece_char = piece_to_char(black_captured_pieces[i]);
-    offset += snprintf(buffer + offset, size - offset, "\"%c\"", piece_char);
-    if (i < black_captured_count - 1) {
-      offset += snprintf(buffer + offset, size - offset, ",");
-    }
+  if (fmt == GAME_HISTORY_FORMAT_PGN && at_end) {
+    json_writer_text(w, first ? "" : " ", first ? 0 : 1);
+    json_writer_text(w, result, strlen(result));
+    json_writer_text(w, "\n", 1);
+  }
+  if (next_out != NULL) {
+    *next_out = next;
   }
+  return json_writer_error(w);
+}
 
-  offset += snprintf(buffer + offset, size - offset, "]}");
+static void game_write_piece_array(json_writer_t *w, const char *key,
+                                   const piece_t *pieces, uint32_t count) {
+  json_writer_key(w, key);
+  json_writer_begin_array(w);
+  for (uint32_t i = 0; i < count && i < GAME_TASK_MAX_CAPTURED_PIECES; i++) {
+    json_writer_char(w, piece_to_char(pieces[i]));
+  }
+  json_writer_end_array(w);
+}
 
-  if (game_mutex != NULL) {
-    xSemaphoreGive(game_mutex);
+esp_err_t game_write_captured_json(json_writer_t *w) {
+  if (w == NULL) {
+    return ESP_ERR_INVALID_ARG;
   }
+  esp_err_t ret = game_json_lock();
+  if (ret != ESP_OK) {
+    return ret;
+  }
+  json_writer_begin_object(w);
+  game_write_piece_array(w, "white_captured", white_captured_pieces,
+                         white_captured_count);
+  game_write_piece_array(w, "black_captured", black_captured_pieces,
+                         black_captured_count);
+  json_writer_end_object(w);
+  game_json_unlock();
+  return json_writer_error(w);
+}
 
-  return ESP_OK;
+esp_err_t game_get_captured_json(char *buffer, size_t size) {
+  return game_json_to_buffer(buffer, size, game_write_captured_json);
 }
 
-/**
- * @brief Export material advantage history to JSON string (pro graf)
- * @param buffer Output buffer for JSON string
- * @param size Buffer size
- * @return ESP_OK on success, error code on failure
- */
-esp_err_t game_get_advantage_json(char *buffer, size_t size) {
-  if (buffer == NULL || size == 0) {
+esp_err_t game_write_advantage_json(json_writer_t *w) {
+  if (w == NULL) {
     return ESP_ERR_INVALID_ARG;
   }
-
-  // Thread-safe access
-  if (game_mutex != NULL) {
-    if (xSemaphoreTake(game_mutex, pdMS_TO_TICKS(1000)) != pdTRUE) {
-      return ESP_ERR_TIMEOUT;
-    }
+  esp_err_t ret = game_json_lock();
+  if (ret != ESP_OK) {
+    return ret;
   }
 
-  // Build JSON: {"history":[0,1,2,-1,0,...], "count":42, "white_checks":5,
-  // "black_checks":3, ...}
-  int offset = 0;
-  offset += snprintf(buffer + offset, size - offset, "{\"history\":[");
-
-  // Add advantage values
-  for (uint32_t i = 0; i < advantage_history_count; i++) {
-    offset += snprintf(buffer + offset, size - offset, "%d",
-                       material_advantage_history[i]);
-    if (i < advantage_history_count - 1) {
-      offset += snprintf(buffer + offset, size - offset, ",");
-    }
+  // {"history":[0,1,2,-1,0,...], "count":42, "white_checks":5, ...}
+  json_writer_begin_object(w);
+  json_writer_key(w, "history");
+  json_writer_begin_array(w);
+  for (uint32_t i = 0;
+       i < advantage_history_count && i < GAME_TASK_MAX_ADVANTAGE_HISTORY; i++) {
+    json_writer_int(w, material_advantage_history[i]);
   }
-
-  offset += snprintf(buffer + offset, size - offset, "],\"count\":%" PRIu32,
-                     advantage_history_count);
-
-  // Přidat další statistiky
-  offset += snprintf(buffer + offset, size - offset,
-                     ",\"white_checks\":%" PRIu32 ",\"black_checks\":%" PRIu32,
-                     white_checks, black_checks);
-  offset +=
-      snprintf(buffer + offset, size - offset,
-               ",\"white_castles\":%" PRIu32 ",\"black_castles\":%" PRIu32,
-               white_castles, black_castles);
+  json_writer_end_array(w);
+  json_writer_kv_uint(w, "count", advantage_history_count);
+  json_writer_kv_uint(w, "white_checks", white_checks);
+  json_writer_kv_uint(w, "black_checks", black_checks);
+  json_writer_kv_uint(w, "white_castles", white_castles);
+  json_writer_kv_uint(w, "black_castles", black_castles);
 
   // Průměrný čas na tah
   uint32_t current_time = esp_timer_get_time() / 1000;
@@ -544,18 +636,22 @@ esp_err_t game_get_advantage_json(char *buffer, size_t size) {
       (game_start_time > 0) ? (current_time - game_start_time) : 0;
   uint32_t avg_time_per_move =
       (move_count > 0) ? (game_duration / move_count) : 0;
-  offset += snprintf(buffer + offset, size - offset,
-                     ",\"game_duration_ms\":%" PRIu32
-                     ",\"avg_time_per_move_ms\":%" PRIu32,
-                     game_duration, avg_time_per_move);
-
-  offset += snprintf(buffer + offset, size - offset, "}");
+  json_writer_kv_uint(w, "game_duration_ms", game_duration);
+  json_writer_kv_uint(w, "avg_time_per_move_ms", avg_time_per_move);
+  json_writer_end_object(w);
 
-  if (game_mutex != NULL) {
-    xSemaphoreGive(game_mutex);
-  }
+  game_json_unlock();
+  return json_writer_error(w);
+}
 
-  return ESP_OK;
+/**
+ * @brief Export material advantage history to JSON string (pro graf)
+ * @param buffer Output buffer for JSON string
+ * @param size Buffer size
+ * @return ESP_OK on success, error code on failure
+ */
+esp_err_t game_get_advantage_json(char *buffer, size_t size) {
+  return game_json_to_buffer(buffer, size, game_write_advantage_json);
 }
 
 esp_err_t game_get_timer_json(char *buffer, size_t size) {
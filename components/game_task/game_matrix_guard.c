@@ -181,15 +181,19 @@ void game_matrix_guard_handle_command(const chess_move_command_t *cmd) {
     return;
   }
 
+  /* lifted low/high, dropped low/high (matrix_send_guard_command) */
+  uint32_t masks[4] = {0};
+  size_t masks_len = 0;
+  const void *masks_data =
+      game_payload_data(cmd->timer_data.matrix_guard.masks, &masks_len);
+  if (masks_data != NULL && masks_len == sizeof(masks)) {
+    memcpy(masks, masks_data, sizeof(masks));
+  }
   matrix_guard_pause_state.active = true;
-  matrix_guard_pause_state.lifted_mask_low =
-      cmd->timer_data.matrix_guard.lifted_mask_low;
-  matrix_guard_pause_state.lifted_mask_high =
-      cmd->timer_data.matrix_guard.lifted_mask_high;
-  matrix_guard_pause_state.dropped_mask_low =
-      cmd->timer_data.matrix_guard.dropped_mask_low;
-  matrix_guard_pause_state.dropped_mask_high =
-      cmd->timer_data.matrix_guard.dropped_mask_high;
+  matrix_guard_pause_state.lifted_mask_low = masks[0];
+  matrix_guard_pause_state.lifted_mask_high = masks[1];
+  matrix_guard_pause_state.dropped_mask_low = masks[2];
+  matrix_guard_pause_state.dropped_mask_high = masks[3];
   matrix_guard_pause_state.conflict_count = game_count_mask_bits(
       matrix_guard_pause_state.lifted_mask_low |
           matrix_guard_pause_state.dropped_mask_low,
@@ -21,6 +21,7 @@
 #include "freertos/semphr.h"
 #include "freertos/task.h"
 
+#include <inttypes.h>
 #include <math.h>
 #include <stdlib.h>
 #include <string.h>
@@ -36,6 +37,9 @@ static const char *TAG = "GAME_MOVE_EXEC";
 // Fifty-move rule counter
 static uint32_t fifty_move_counter = 0;
 
+/** Bezi davka tahu: game_execute_move bez LED animaci, ukladani a udalosti. */
+static bool s_move_batch_active = false;
+
 // ============================================================================
 // MOVE EXECUTION FUNCTIONS
 // ============================================================================
@@ -307,39 +311,41 @@ bool game_execute_move(const chess_move_t *move) {
         castling_state.rook_to_col = 3; // d-file
       }
 
-      // Ukázat LED indikaci pro věž s pulzováním pro lepší viditelnost
-      led_clear_board_only();
-
-      uint8_t rook_from_led = chess_pos_to_led_index(
-          castling_state.rook_from_row, castling_state.rook_from_col);
-      uint8_t rook_to_led = chess_pos_to_led_index(castling_state.rook_to_row,
-                                                   castling_state.rook_to_col);
-
-      // Pulzování pro lepší viditelnost (3 cykly s plynulým přechodem)
-      // Použít správný výpočet brightness pro plynulé pulzování
-      for (int pulse = 0; pulse < 3; pulse++) {
-        // Plynulé pulzování: 0.5 -> 1.0 -> 0.5
-        // Použít sin() s normalizací - sin() vrací -1 až 1, normalizujeme na
-        // 0-1, pak na 0.5-1.0
-        float phase = (float)pulse * 2.0f * 3.14159f / 3.0f; // 0, 2π/3, 4π/3
-        float brightness =
-            0.5f + 0.5f * (1.0f + sin(phase)) /
-                       2.0f; // Normalizace: sin() -> 0-1 -> 0.5-1.0
-
-        // Stříbrná pro věž (source) s pulzováním
-        led_set_pixel_safe(rook_from_led, (uint8_t)(192 * brightness),
-                           (uint8_t)(192 * brightness),
-                           (uint8_t)(192 * brightness));
-
-        // Zelená pro cíl věže (destination) s pulzováním
-        led_set_pixel_safe(rook_to_led, 0, (uint8_t)(255 * brightness), 0);
-
-        vTaskDelay(pdMS_TO_TICKS(200));
-      }
+      if (!s_move_batch_active) {
+        // Ukázat LED indikaci pro věž s pulzováním pro lepší viditelnost
+        led_clear_board_only();
+
+        uint8_t rook_from_led = chess_pos_to_led_index(
+            castling_state.rook_from_row, castling_state.rook_from_col);
+        uint8_t rook_to_led = chess_pos_to_led_index(
+            castling_state.rook_to_row, castling_state.rook_to_col);
+
+        // Pulzování pro lepší viditelnost (3 cykly s plynulým přechodem)
+        // Použít správný výpočet brightness pro plynulé pulzování
+        for (int pulse = 0; pulse < 3; pulse++) {
+          // Plynulé pulzování: 0.5 -> 1.0 -> 0.5
+          // Použít sin() s normalizací - sin() vrací -1 až 1, normalizujeme na
+          // 0-1, pak na 0.5-1.0
+          float phase = (float)pulse * 2.0f * 3.14159f / 3.0f; // 0, 2π/3, 4π/3
+          float brightness =
+              0.5f + 0.5f * (1.0f + sin(phase)) /
+                         2.0f; // Normalizace: sin() -> 0-1 -> 0.5-1.0
+
+          // Stříbrná pro věž (source) s pulzováním
+          led_set_pixel_safe(rook_from_led, (uint8_t)(192 * brightness),
+                             (uint8_t)(192 * brightness),
+                             (uint8_t)(192 * brightness));
+
+          // Zelená pro cíl věže (destination) s pulzováním
+          led_set_pixel_safe(rook_to_led, 0, (uint8_t)(255 * brightness), 0);
+
+          vTaskDelay(pdMS_TO_TICKS(200));
+        }
 
-      // Finální statické zobrazení
-      led_set_pixel_safe(rook_from_led, 192, 192, 192); // Stříbrná pro věž
-      led_set_pixel_safe(rook_to_led, 0, 255, 0);       // Zelená pro cíl věže
+        // Finální statické zobrazení
+        led_set_pixel_safe(rook_from_led, 192, 192, 192); // Stříbrná pro věž
+        led_set_pixel_safe(rook_to_led, 0, 255, 0);       // Zelená pro cíl věže
+      }
 
       // NEMĚNIT HRÁČE pro castling!
       ESP_LOGI(
@@ -348,7 +354,9 @@ bool game_execute_move(const chess_move_t *move) {
           'a' + castling_state.rook_to_col, castling_state.rook_to_row + 1);
       ESP_LOGI(TAG, "🏰 Castling in progress - player remains %s",
                current_player == PLAYER_WHITE ? "White" : "Black");
-      game_snapshot_persist_after_valid_move();
+      if (!s_move_batch_active) {
+        game_snapshot_persist_after_valid_move();
+      }
       return success; // Return success but don't change player - hráč se změní
                       // až po dokončení rošády
     }
@@ -445,7 +453,9 @@ bool game_execute_move(const chess_move_t *move) {
         }
 
         // Zlatá animace dokončení rošády
-        show_castling_completion_animation();
+        if (!s_move_batch_active) {
+          show_castling_completion_animation();
+        }
 
         /* Vždy ukončit stav rošády před přepnutím hráče / kontrolou konce hry.
          * Dříve se in_progress vynulovalo jen v ne-endgame větvi — po matu/patu
@@ -464,13 +474,15 @@ bool game_execute_move(const chess_move_t *move) {
                  current_player == PLAYER_WHITE ? "White" : "Black");
 
         // Timer integration: End timer for previous player and start for new
-        // player
-        ESP_LOGI(TAG,
-                 "🔄 Timer switch (castling): ending for %s, starting for %s",
-                 previous_player == PLAYER_WHITE ? "White" : "Black",
-                 current_player == PLAYER_WHITE ? "White" : "Black");
-        game_end_timer_move();
-        game_start_timer_move(current_player == PLAYER_WHITE);
+        // player (davka: jednou az pri commitu, rollback hodiny nevraci)
+        if (!s_move_batch_active) {
+          ESP_LOGI(TAG,
+                   "🔄 Timer switch (castling): ending for %s, starting for %s",
+                   previous_player == PLAYER_WHITE ? "White" : "Black",
+                   current_player == PLAYER_WHITE ? "White" : "Black");
+          game_end_timer_move();
+          game_start_timer_move(current_player == PLAYER_WHITE);
+        }
 
         // Endgame kontrola PŘED player change animací!
         // Pokud je endgame, player change se NESPOUŠTÍ
@@ -479,38 +491,39 @@ bool game_execute_move(const chess_move_t *move) {
           current_game_state = GAME_STATE_FINISHED;
           game_active = false;
 
-          // Najít pozici krále vítěze pro endgame animaci
-          player_t winner =
-              (current_player == PLAYER_WHITE) ? PLAYER_BLACK : PLAYER_WHITE;
-          uint8_t king_pos = 28; // default e4
-          for (int i = 0; i < 64; i++) {
-            piece_t piece = board[i / 8][i % 8];
-            if ((winner == PLAYER_WHITE && piece == PIECE_WHITE_KING) ||
-                (winner == PLAYER_BLACK && piece == PIECE_BLACK_KING)) {
-              king_pos = i;
-              break;
+          if (!s_move_batch_active) {
+            // Najít pozici krále vítěze pro endgame animaci
+            player_t winner =
+                (current_player == PLAYER_WHITE) ? PLAYER_BLACK : PLAYER_WHITE;
+            uint8_t king_pos = 28; // default e4
+            for (int i = 0; i < 64; i++) {
+              piece_t piece = board[i / 8][i % 8];
+              if ((winner == PLAYER_WHITE && piece == PIECE_WHITE_KING) ||
+                  (winner == PLAYER_BLACK && piece == PIECE_BLACK_KING)) {
+                king_pos = i;
+                break;
+              }
             }
-          }
 
-          ESP_LOGI(TAG,
-                   "🎯 Game finished after castling! Starting endgame "
-                   "animation at position %d",
-                   king_pos);
-
-          // Spustit endgame animaci (wave z krále vítěze)
-          led_command_t endgame_cmd = {.type = LED_CMD_ANIM_ENDGAME,
-                                       .led_index = king_pos,
-                                       .red = 255,
-                                       .green = 255,
-                                       .blue = 0,        // Yellow
-                                       .duration_ms = 0, // Endless
-                                       .data = NULL};
-          led_execute_command_new(&endgame_cmd);
-
-          ESP_LOGI(
-              TAG,
-              "✅ Endgame animation started - player change animation SKIPPED");
-        } else {
+            ESP_LOGI(TAG,
+                     "🎯 Game finished after castling! Starting endgame "
+                     "animation at position %d",
+                     king_pos);
+
+            // Spustit endgame animaci (wave z krále vítěze)
+            led_command_t endgame_cmd = {.type = LED_CMD_ANIM_ENDGAME,
+                                         .led_index = king_pos,
+                                         .red = 255,
+                                         .green = 255,
+                                         .blue = 0,        // Yellow
+                                         .duration_ms = 0, // Endless
+                                         .data = NULL};
+            led_execute_command_new(&endgame_cmd);
+
+            ESP_LOGI(TAG, "✅ Endgame animation started - player change "
+                          "animation SKIPPED");
+          }
+        } else if (!s_move_batch_active) {
           // Není endgame - spustit player change animaci
           uint8_t player_color =
               (current_player == PLAYER_WHITE) ? 1 : 0; // 1=white, 0=black
@@ -573,7 +586,9 @@ bool game_execute_move(const chess_move_t *move) {
         }
 
         // RETURN po dokončení rošády - hráč se už změnil
-        game_snapshot_persist_after_valid_move();
+        if (!s_move_batch_active) {
+          game_snapshot_persist_after_valid_move();
+        }
         return success;
       } else {
         // Wrong move during castling
@@ -675,11 +690,19 @@ bool game_execute_move(const chess_move_t *move) {
     }
   }
 
-  // Update promotion LED indications after move
-  if (success) {
+  // Update promotion LED indications after move (davka: jednou na konci)
+  if (success && !s_move_batch_active) {
     game_check_promotion_needed();
     game_snapshot_persist_after_valid_move();
-    game_bump_revision_and_notify();
+    game_event_t ev = {.type = GAME_EVENT_MOVE_COMMITTED};
+    ev.u.move.from = (uint8_t)(move->from_row * 8 + move->from_col);
+    ev.u.move.to = (uint8_t)(move->to_row * 8 + move->to_col);
+    ev.u.move.piece = piece_to_char(extended_move.piece);
+    ev.u.move.captured = extended_move.captured_piece != PIECE_EMPTY
+                             ? piece_to_char(extended_move.captured_piece)
+                             : 0;
+    ev.u.move.ply = (uint16_t)move_count;
+    game_emit_event(&ev);
   }
 
   return success;
@@ -865,3 +888,216 @@ void show_castling_completion_animation() {
 
   ESP_LOGI(TAG, "🏰✨ CASTLING ANIMATION COMPLETED");
 }
+
+// ============================================================================
+// DAVKA TAHU (GAME_CMD_MOVE_BATCH)
+// ============================================================================
+
+/**
+ * Stav, ktery tahy meni. Historie, sebrane figurky, graf vyhody a historie
+ * pozic se jen pripisuji, takze staci jejich delky.
+ */
+typedef struct {
+  piece_t board[8][8];
+  bool piece_moved[8][8];
+  player_t current_player;
+  game_state_t current_game_state;
+  game_state_t game_result;
+  game_result_type_t current_result_type;
+  endgame_reason_t current_endgame_reason;
+  bool game_active;
+  bool endgame_report_requested;
+  uint32_t move_count;
+  bool white_king_moved, white_rook_a_moved, white_rook_h_moved;
+  bool black_king_moved, black_rook_a_moved, black_rook_h_moved;
+  bool en_passant_available;
+  uint8_t en_passant_target_row, en_passant_target_col;
+  uint8_t en_passant_victim_row, en_passant_victim_col;
+  game_task_promotion_state_t promotion_state;
+  castling_state_t castling_state;
+  last_move_type_t last_move_type;
+  bool has_last_move;
+  uint8_t last_move_from_row, last_move_from_col;
+  uint8_t last_move_to_row, last_move_to_col;
+  uint32_t last_move_time;
+  uint32_t history_index;
+  uint32_t white_moves_count, black_moves_count;
+  uint32_t white_castles, black_castles;
+  uint32_t white_checks, black_checks;
+  uint32_t white_captured_count, black_captured_count;
+  uint32_t white_captured_index, black_captured_index;
+  uint32_t white_captures, black_captures;
+  uint32_t advantage_history_count;
+  uint32_t moves_without_capture, max_moves_without_capture;
+  uint32_t position_history_count;
+  uint32_t fifty_move_counter;
+  uint32_t total_games, white_wins, black_wins, draws;
+} move_batch_checkpoint_t;
+
+/* Jedna davka naraz (jen game task) — checkpoint nemusi byt na stacku. */
+static move_batch_checkpoint_t s_batch_checkpoint;
+
+#define BATCH_SAVE(field) (cp->field = field)
+#define BATCH_RESTORE(field) (field = cp->field)
+#define BATCH_FIELDS(X)                                                        \
+  X(current_player);                                                           \
+  X(current_game_state);                                                       \
+  X(game_result);                                                              \
+  X(current_result_type);                                                      \
+  X(current_endgame_reason);                                                   \
+  X(game_active);                                                              \
+  X(endgame_report_requested);                                                 \
+  X(move_count);                                                               \
+  X(white_king_moved);                                                         \
+  X(white_rook_a_moved);                                                       \
+  X(white_rook_h_moved);                                                       \
+  X(black_king_moved);                                                         \
+  X(black_rook_a_moved);                                                       \
+  X(black_rook_h_moved);                                                       \
+  X(en_passant_available);                                                     \
+  X(en_passant_target_row);                                                    \
+  X(en_passant_target_col);                                                    \
+  X(en_passant_victim_row);                                                    \
+  X(en_passant_victim_col);                                                    \
+  X(promotion_state);                                                          \
+  X(castling_state);                                                           \
+  X(last_move_type);                                                           \
+  X(has_last_move);                                                            \
+  X(last_move_from_row);                                                       \
+  X(last_move_from_col);                                                       \
+  X(last_move_to_row);                                                         \
+  X(last_move_to_col);                                                         \
+  X(last_move_time);                                                           \
+  X(history_index);                                                            \
+  X(white_moves_count);                                                        \
+  X(black_moves_count);                                                        \
+  X(white_castles);                                                            \
+  X(black_castles);                                                            \
+  X(white_checks);                                                             \
+  X(black_checks);                                                             \
+  X(white_captured_count);                                                     \
+  X(black_captured_count);                                                     \
+  X(white_captured_index);                                                     \
+  X(black_captured_index);                                                     \
+  X(white_captures);                                                           \
+  X(black_captures);                                                           \
+  X(advantage_history_count);                                                  \
+  X(moves_without_capture);                                                    \
+  X(max_moves_without_capture);                                                \
+  X(position_history_count);                                                   \
+  X(fifty_move_counter);                                                       \
+  X(total_games);                                                              \
+  X(white_wins);                                                               \
+  X(black_wins);                                                               \
+  X(draws)
+
+static void move_batch_save(move_batch_checkpoint_t *cp) {
+  memcpy(cp->board, board, sizeof(cp->board));
+  memcpy(cp->piece_moved, piece_moved, sizeof(cp->piece_moved));
+  BATCH_FIELDS(BATCH_SAVE);
+}
+
+static void move_batch_restore(const move_batch_checkpoint_t *cp) {
+  memcpy(board, cp->board, sizeof(cp->board));
+  memcpy(piece_moved, cp->piece_moved, sizeof(cp->piece_moved));
+  BATCH_FIELDS(BATCH_RESTORE);
+}
+
+/** Jeden tah davky; rosadu (kral o dve pole) dokonci tahem veze. */
+static move_error_t move_batch_apply(uint16_t packed) {
+  uint8_t from = GAME_MOVE_BATCH_FROM(packed);
+  uint8_t to = GAME_MOVE_BATCH_TO(packed);
+  chess_move_t move = {.from_row = from / 8,
+                       .from_col = from % 8,
+                       .to_row = to / 8,
+                       .to_col = to % 8,
+                       .piece = board[from / 8][from % 8],
+                       .captured_piece = board[to / 8][to % 8],
+                       .timestamp = 0};
+
+  move_error_t err = game_is_valid_move(&move);
+  if (err != MOVE_ERROR_NONE) {
+    return err;
+  }
+  /* Promoce vzdy hned (jako WEB/BLE s polem promotion), nikdy pending. */
+  s_uart_move_immediate_promotion = true;
+  s_uart_move_immediate_promotion_piece =
+      (promotion_choice_t)GAME_MOVE_BATCH_PROMO(packed);
+  if (!game_execute_move(&move)) {
+    return MOVE_ERROR_SYSTEM_ERROR;
+  }
+
+  if (castling_state.in_progress) {
+    chess_move_t rook = {
+        .from_row = castling_state.rook_from_row,
+        .from_col = castling_state.rook_from_col,
+        .to_row = castling_state.rook_to_row,
+        .to_col = castling_state.rook_to_col,
+        .piece = board[castling_state.rook_from_row]
+                      [castling_state.rook_from_col],
+        .captured_piece = PIECE_EMPTY,
+        .timestamp = 0};
+    if (!game_execute_move(&rook) || castling_state.in_progress) {
+      return MOVE_ERROR_CASTLING_BLOCKED;
+    }
+  }
+  return MOVE_ERROR_NONE;
+}
+
+move_error_t game_execute_move_batch(const uint16_t *moves, size_t count,
+                                     game_move_batch_result_t *result) {
+  memset(result, 0, sizeof(*result));
+  result->ply = move_count;
+  if (moves == NULL || count == 0 || count > GAME_MOVE_BATCH_MAX) {
+    return MOVE_ERROR_INVALID_PARAMETER;
+  }
+  /* Rozehrany fyzicky stav (promoce, rosada, oprava, guard) davka neprebije. */
+  if (promotion_state.pending || castling_state.in_progress ||
+      error_recovery_state.waiting_for_move_correction ||
+      game_is_matrix_guard_active()) {
+    return MOVE_ERROR_GAME_NOT_ACTIVE;
+  }
+
+  move_batch_save(&s_batch_checkpoint);
+  s_move_batch_active = true;
+  move_error_t err = MOVE_ERROR_NONE;
+  size_t i = 0;
+  for (; i < count; i++) {
+    err = move_batch_apply(moves[i]);
+    if (err != MOVE_ERROR_NONE) {
+      break;
+    }
+    if ((i & 15u) == 15u) {
+      game_task_wdt_reset_safe();
+    }
+  }
+  s_move_batch_active = false;
+  s_uart_move_immediate_promotion = false;
+
+  if (err != MOVE_ERROR_NONE) {
+    /* Nic se neulozilo ani neoznamilo — staci vratit RAM a prekreslit LED. */
+    move_batch_restore(&s_batch_checkpoint);
+    result->failed_index = (uint16_t)i;
+    result->ply = move_count;
+    ESP_LOGW(TAG, "Move batch rolled back at %u/%u (error %d)", (unsigned)i,
+             (unsigned)count, (int)err);
+    game_refresh_leds();
+    return err;
+  }
+
+  /* Stejne dokonceni jako po jednom tahu, jen jednou za celou davku. */
+  game_end_timer_move();
+  if (current_game_state != GAME_STATE_FINISHED) {
+    game_start_timer_move(current_player == PLAYER_WHITE);
+    game_refresh_leds();
+  }
+  game_check_promotion_needed();
+  game_snapshot_persist_after_valid_move();
+  game_emit_simple_event(GAME_EVENT_STATE_CHANGED);
+
+  result->applied = (uint16_t)count;
+  result->ply = move_count;
+  ESP_LOGI(TAG, "Move batch applied: %u moves, ply %" PRIu32, (unsigned)count,
+           move_count);
+  return MOVE_ERROR_NONE;
+}
@@ -0,0 +1,174 @@
+/**
+ * @file game_opening_book.c
+ * @brief Zobrist klic pozice game_task a binarni hledani v knize zahajeni
+ *
+ * Tabulky game_opening_book[] a game_opening_book_zobrist[] generuje
+ * tools/build_opening_book.py (opening_book_data.c v build adresari). Klic se
+ * pocita stejne jako v generatoru: figury, rosady (KQkq), sloupec en passant
+ * jen kdyz ho hrac na tahu muze sebrat, a hodnota pro bileho na tahu.
+ */
+
+#include "game_opening_book.h"
+#include "game_task_internal.h"
+
+#include <string.h>
+
+#define BOOK_Z_CASTLE 768
+#define BOOK_Z_EP 772
+#define BOOK_Z_TURN 780
+
+/** Polyglot index figury (2 * druh + bila), -1 prazdne pole. */
+static int book_piece_index(piece_t p) {
+  switch (p) {
+  case PIECE_BLACK_PAWN:
+    return 0;
+  case PIECE_WHITE_PAWN:
+    return 1;
+  case PIECE_BLACK_KNIGHT:
+    return 2;
+  case PIECE_WHITE_KNIGHT:
+    return 3;
+  case PIECE_BLACK_BISHOP:
+    return 4;
+  case PIECE_WHITE_BISHOP:
+    return 5;
+  case PIECE_BLACK_ROOK:
+    return 6;
+  case PIECE_WHITE_ROOK:
+    return 7;
+  case PIECE_BLACK_QUEEN:
+    return 8;
+  case PIECE_WHITE_QUEEN:
+    return 9;
+  case PIECE_BLACK_KING:
+    return 10;
+  case PIECE_WHITE_KING:
+    return 11;
+  default:
+    return -1;
+  }
+}
+
+static bool book_ep_capturable(void) {
+  if (!en_passant_available || en_passant_victim_row > 7 ||
+      en_passant_victim_col > 7) {
+    return false;
+  }
+  piece_t pawn =
+      (current_player == PLAYER_WHITE) ? PIECE_WHITE_PAWN : PIECE_BLACK_PAWN;
+  uint8_t row = en_passant_victim_row;
+  uint8_t col = en_passant_victim_col;
+  return (col > 0 && board[row][col - 1] == pawn) ||
+         (col < 7 && board[row][col + 1] == pawn);
+}
+
+uint64_t game_opening_book_key(void) {
+  const uint64_t *z = game_opening_book_zobrist;
+  uint64_t key = 0;
+  for (int row = 0; row < 8; row++) {
+    for (int col = 0; col < 8; col++) {
+      int idx = book_piece_index(board[row][col]);
+      if (idx >= 0) {
+        key ^= z[64 * idx + row * 8 + col];
+      }
+    }
+  }
+
+  /* Rosady: priznaky pohybu + figury na vychozich polich (vez mohla byt
+   * sebrana bez pohybu). */
+  bool wk = !white_king_moved && board[0][4] == PIECE_WHITE_KING;
+  bool bk = !black_king_moved && board[7][4] == PIECE_BLACK_KING;
+  if (wk && !white_rook_h_moved && board[0][7] == PIECE_WHITE_ROOK) {
+    key ^= z[BOOK_Z_CASTLE + 0];
+  }
+  if (wk && !white_rook_a_moved && board[0][0] == PIECE_WHITE_ROOK) {
+    key ^= z[BOOK_Z_CASTLE + 1];
+  }
+  if (bk && !black_rook_h_moved && board[7][7] == PIECE_BLACK_ROOK) {
+    key ^= z[BOOK_Z_CASTLE + 2];
+  }
+  if (bk && !black_rook_a_moved && board[7][0] == PIECE_BLACK_ROOK) {
+    key ^= z[BOOK_Z_CASTLE + 3];
+  }
+
+  if (book_ep_capturable()) {
+    key ^= z[BOOK_Z_EP + en_passant_victim_col];
+  }
+  if (current_player == PLAYER_WHITE) {
+    key ^= z[BOOK_Z_TURN];
+  }
+  return key;
+}
+
+/** Prvni zaznam s klicem >= key. */
+static size_t book_lower_bound(uint64_t key) {
+  size_t lo = 0;
+  size_t hi = game_opening_book_count;
+  while (lo < hi) {
+    size_t mid = lo + (hi - lo) / 2;
+    if (game_opening_book[mid].key < key) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+/**
+ * Polyglot tah -> souradnice. Rosada je v knize jako "kral bere vez" (e1h1);
+ * pokud na from stoji kral a cil je roh stejne rady, prevede se na e1g1/e1c1.
+ */
+static void book_decode_move(uint16_t move, uint8_t *from_row,
+                             uint8_t *from_col, uint8_t *to_row,
+                             uint8_t *to_col) {
+  *to_col = move & 7;
+  *to_row = (move >> 3) & 7;
+  *from_col = (move >> 6) & 7;
+  *from_row = (move >> 9) & 7;
+  piece_t p = board[*from_row][*from_col];
+  if ((p == PIECE_WHITE_KING || p == PIECE_BLACK_KING) && *from_col == 4 &&
+      *to_row == *from_row && (*to_col == 7 || *to_col == 0)) {
+    *to_col = (*to_col == 7) ? 6 : 2;
+  }
+}
+
+uint32_t game_opening_book_lookup(uint64_t key, game_opening_book_move_t *out,
+                                  uint32_t max) {
+  static const char promo_chars[] = {'\0', 'n', 'b', 'r', 'q'};
+  if (out == NULL || max == 0) {
+    return 0;
+  }
+  uint32_t n = 0;
+  for (size_t i = book_lower_bound(key);
+       i < game_opening_book_count && game_opening_book[i].key == key && n < max;
+       i++) {
+    const game_opening_book_entry_t *e = &game_opening_book[i];
+    uint8_t fr, fc, tr, tc;
+    book_decode_move(e->move, &fr, &fc, &tr, &tc);
+    uint8_t promo = (e->move >> 12) & 7;
+    game_opening_book_move_t *m = &out[n++];
+    m->uci[0] = (char)('a' + fc);
+    m->uci[1] = (char)('1' + fr);
+    m->uci[2] = (char)('a' + tc);
+    m->uci[3] = (char)('1' + tr);
+    m->uci[4] = promo < sizeof(promo_chars) ? promo_chars[promo] : '\0';
+    m->uci[5] = '\0';
+    m->weight = e->weight;
+  }
+  return n;
+}
+
+bool game_opening_book_has_move(uint64_t key, uint8_t from_row,
+                                uint8_t from_col, uint8_t to_row,
+                                uint8_t to_col) {
+  for (size_t i = book_lower_bound(key);
+       i < game_opening_book_count && game_opening_book[i].key == key; i++) {
+    uint8_t fr, fc, tr, tc;
+    book_decode_move(game_opening_book[i].move, &fr, &fc, &tr, &tc);
+    if (fr == from_row && fc == from_col && tr == to_row && tc == to_col) {
+      return true;
+    }
+  }
+  return false;
+}
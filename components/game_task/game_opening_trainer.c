@@ -5,10 +5,12 @@
 
 #include "game_task_internal.h"
 #include "game_board_core.h"
+#include "game_opening_book.h"
 #include "game_task.h"
 
 #include "../led_task/include/led_task.h"
 #include "../matrix_task/include/matrix_task.h"
+#include "json_writer.h"
 #include "led_mapping.h"
 
 #include "esp_log.h"
@@ -72,6 +74,7 @@ typedef struct {
   char expected_to[3];
   char last_opponent_uci[6];
   char last_wrong_uci[6];
+  bool last_wrong_in_book;
   opening_feedback_t feedback;
   player_t player_side;
   bool awaiting_checkpoint_ack;
@@ -463,6 +466,7 @@ bool game_opening_start(void) {
   opening_state.last_opponent_uci[0] = '\0';
   opening_state.last_wrong_uci[0] = '\0';
   opening_state.last_wrong_uci[0] = '\0';
+  opening_state.last_wrong_in_book = false;
   opening_state.wrong_move_count = 0;
   led_clear_board_only();
 
@@ -472,8 +476,39 @@ bool game_opening_start(void) {
   return true;
 }
 
+/** Mimo trenink: nejcastejsi knizni tah aktualni pozice na LED. */
+static bool opening_show_book_hint(void) {
+  if (!game_active || opening_state.setup_phase ||
+      game_get_led_guidance_level() == 0) {
+    return false;
+  }
+  game_opening_book_move_t best;
+  if (game_opening_book_lookup(game_opening_book_key(), &best, 1) == 0) {
+    return false;
+  }
+  char from[3], to[3];
+  opening_parse_uci(best.uci, from, to);
+  uint8_t from_row = 0, from_col = 0, to_row = 0, to_col = 0;
+  if (!convert_notation_to_coords(from, &from_row, &from_col) ||
+      !convert_notation_to_coords(to, &to_row, &to_col)) {
+    return false;
+  }
+  uint8_t to_led = chess_pos_to_led_index(to_row, to_col);
+  led_command_t hint_cmd = {
+      .type = LED_CMD_HIGHLIGHT_HINT,
+      .led_index = chess_pos_to_led_index(from_row, from_col),
+      .data = &to_led,
+  };
+  led_execute_command_new(&hint_cmd);
+  STAGING_LOGI(TAG, "book hint %s (weight %u)", best.uci, (unsigned)best.weight);
+  return true;
+}
+
 bool game_opening_hint(void) {
-  if (!opening_state.active || opening_state.awaiting_checkpoint_ack) {
+  if (!opening_state.active) {
+    return opening_show_book_hint();
+  }
+  if (opening_state.awaiting_checkpoint_ack) {
     return false;
   }
   if (opening_state.awaiting_opponent_physical) {
@@ -542,6 +577,7 @@ void game_opening_advance_after_opponent_physical(void) {
   }
   opening_state.awaiting_opponent_physical = false;
   opening_state.last_wrong_uci[0] = '\0';
+  opening_state.last_wrong_in_book = false;
   opening_state.wrong_move_count = 0;
   opening_state.ply_index++;
   if (opening_state.ply_index >= opening_state.line_uci_count) {
@@ -560,6 +596,7 @@ void game_opening_advance_after_correct(void) {
     return;
   }
   opening_state.last_wrong_uci[0] = '\0';
+  opening_state.last_wrong_in_book = false;
   opening_state.wrong_move_count = 0;
   opening_state.feedback = OPENING_FEEDBACK_CORRECT;
   opening_state.ply_index++;
@@ -621,15 +658,20 @@ void game_opening_record_wrong_uci(uint8_t from_row, uint8_t from_col,
   if (!convert_coords_to_notation(from_row, from_col, from_sq) ||
       !convert_coords_to_notation(to_row, to_col, to_sq)) {
     opening_state.last_wrong_uci[0] = '\0';
+    opening_state.last_wrong_in_book = false;
     return;
   }
+  /* Deska je jeste pred tahem: jiny knizni tah = transpozice / jina linie. */
+  opening_state.last_wrong_in_book = game_opening_book_has_move(
+      game_opening_book_key(), from_row, from_col, to_row, to_col);
   opening_state.last_wrong_uci[0] = from_sq[0];
   opening_state.last_wrong_uci[1] = from_sq[1];
   opening_state.last_wrong_uci[2] = to_sq[0];
   opening_state.last_wrong_uci[3] = to_sq[1];
   opening_state.last_wrong_uci[4] = '\0';
-  STAGING_LOGI(TAG, "wrong uci recorded %s ply=%u", opening_state.last_wrong_uci,
-               (unsigned)opening_state.ply_index);
+  STAGING_LOGI(TAG, "wrong uci recorded %s ply=%u book=%d",
+               opening_state.last_wrong_uci, (unsigned)opening_state.ply_index,
+               (int)opening_state.last_wrong_in_book);
 }
 
 bool game_opening_on_illegal_player_move(void) {
@@ -704,74 +746,62 @@ static void opening_fill_expected_occupied(uint8_t out[64]) {
   }
 }
 
-void game_opening_export_status_json(char *buf, size_t buf_size, size_t *offset) {
-  if (buf == NULL || offset == NULL || buf_size == 0) {
-    return;
-  }
-  if (!opening_export_active()) {
+void game_opening_write_status_fields(json_writer_t *w) {
+  if (w == NULL || !opening_export_active()) {
     return;
   }
   bool physical_match = game_opening_physical_matches_start();
-  int n = snprintf(
-      buf + *offset, buf_size - *offset,
-      ",\"opening_training\":{\"active\":%s,\"setup_phase\":%s,\"mode\":\"%s\","
-      "\"opponent_mode\":\"%s\",\"line_id\":\"%s\",\"ply_index\":%u,\"ply_total\":%u,"
-      "\"player_ply_index\":%u,\"player_ply_total\":%u,"
-      "\"player_side\":\"%s\",\"feedback\":\"%s\","
-      "\"expected_from\":\"%s\",\"expected_to\":\"%s\","
-      "\"last_opponent_uci\":\"%s\","
-      "\"checkpoint_required\":%s,\"awaiting_checkpoint_ack\":%s,"
-      "\"awaiting_opponent_physical\":%s,"
-      "\"physical_synced\":%s,\"physical_match\":%s,"
-      "\"wrong_move_count\":%u,\"last_wrong_uci\":\"%s\"",
-      opening_state.active ? "true" : "false",
-      opening_state.setup_phase ? "true" : "false", game_opening_mode_key(),
-      game_opening_opponent_mode_key(),
-      opening_state.line_id, (unsigned)opening_state.ply_index,
-      (unsigned)opening_state.line_uci_count,
-      (unsigned)opening_state.player_ply_index,
-      (unsigned)opening_state.player_ply_count,
-      opening_state.player_side == PLAYER_WHITE ? "white" : "black",
-      game_opening_feedback_key(), opening_state.expected_from,
-      opening_state.expected_to, opening_state.last_opponent_uci,
-      opening_state.awaiting_checkpoint_ack ? "true" : "false",
-      opening_state.awaiting_checkpoint_ack ? "true" : "false",
-      opening_state.awaiting_opponent_physical ? "true" : "false",
-      game_opening_validate_checkpoint_physical() ? "true" : "false",
-      physical_match ? "true" : "false",
-      (unsigned)opening_state.wrong_move_count,
-      opening_state.last_wrong_uci[0] != '\0' ? opening_state.last_wrong_uci : "");
-  if (n <= 0 || (size_t)n >= buf_size - *offset) {
-    return;
-  }
-  *offset += (size_t)n;
+  json_writer_key(w, "opening_training");
+  json_writer_begin_object(w);
+  json_writer_kv_bool(w, "active", opening_state.active);
+  json_writer_kv_bool(w, "setup_phase", opening_state.setup_phase);
+  json_writer_kv_string(w, "mode", game_opening_mode_key());
+  json_writer_kv_string(w, "opponent_mode", game_opening_opponent_mode_key());
+  json_writer_kv_string(w, "line_id", opening_state.line_id);
+  json_writer_kv_uint(w, "ply_index", opening_state.ply_index);
+  json_writer_kv_uint(w, "ply_total", opening_state.line_uci_count);
+  json_writer_kv_uint(w, "player_ply_index", opening_state.player_ply_index);
+  json_writer_kv_uint(w, "player_ply_total", opening_state.player_ply_count);
+  json_writer_kv_string(w, "player_side",
+                        opening_state.player_side == PLAYER_WHITE ? "white"
+                                                                  : "black");
+  json_writer_kv_string(w, "feedback", game_opening_feedback_key());
+  json_writer_kv_string(w, "expected_from", opening_state.expected_from);
+  json_writer_kv_string(w, "expected_to", opening_state.expected_to);
+  json_writer_kv_string(w, "last_opponent_uci", opening_state.last_opponent_uci);
+  json_writer_kv_bool(w, "checkpoint_required",
+                      opening_state.awaiting_checkpoint_ack);
+  json_writer_kv_bool(w, "awaiting_checkpoint_ack",
+                      opening_state.awaiting_checkpoint_ack);
+  json_writer_kv_bool(w, "awaiting_opponent_physical",
+                      opening_state.awaiting_opponent_physical);
+  json_writer_kv_bool(w, "physical_synced",
+                      game_opening_validate_checkpoint_physical());
+  json_writer_kv_bool(w, "physical_match", physical_match);
+  json_writer_kv_uint(w, "wrong_move_count", opening_state.wrong_move_count);
+  json_writer_kv_string(w, "last_wrong_uci", opening_state.last_wrong_uci);
+  json_writer_kv_bool(w, "last_wrong_in_book", opening_state.last_wrong_in_book);
+
+  game_opening_book_move_t book[GAME_OPENING_BOOK_MAX_MOVES];
+  uint32_t book_n = game_opening_book_lookup(game_opening_book_key(), book,
+                                             GAME_OPENING_BOOK_MAX_MOVES);
+  json_writer_key(w, "book_moves");
+  json_writer_begin_array(w);
+  for (uint32_t i = 0; i < book_n; i++) {
+    json_writer_string(w, book[i].uci);
+  }
+  json_writer_end_array(w);
 
   if (opening_state.awaiting_checkpoint_ack) {
     uint8_t expected[64];
     opening_fill_expected_occupied(expected);
-    n = snprintf(buf + *offset, buf_size - *offset,
-                 ",\"checkpoint_expected_occupied\":[");
-    if (n <= 0 || (size_t)n >= buf_size - *offset) {
-      return;
-    }
-    *offset += (size_t)n;
+    json_writer_key(w, "checkpoint_expected_occupied");
+    json_writer_begin_array(w);
     for (int i = 0; i < 64; i++) {
-      n = snprintf(buf + *offset, buf_size - *offset, "%s%u",
-                   (i > 0) ? "," : "", (unsigned)expected[i]);
-      if (n <= 0 || (size_t)n >= buf_size - *offset) {
-        return;
-      }
-      *offset += (size_t)n;
-    }
-    n = snprintf(buf + *offset, buf_size - *offset, "]");
-    if (n <= 0 || (size_t)n >= buf_size - *offset) {
-      return;
+      json_writer_uint(w, expected[i]);
     }
-    *offset += (size_t)n;
+    json_writer_end_array(w);
   }
 
-  n = snprintf(buf + *offset, buf_size - *offset, "}");
-  if (n > 0 && (size_t)n < buf_size - *offset) {
-    *offset += (size_t)n;
-  }
+  json_writer_end_object(w);
 }
@@ -193,6 +193,15 @@ static void game_enter_guided_capture(uint8_t target_row, uint8_t target_col,
   lifted_piece = PIECE_EMPTY;
 }
 
+/** Fyzický UP/DN na sběrnici — revizi nebumpuje, web posílá jen malý rámec. */
+static void game_emit_piece_event(game_event_type_t type, uint8_t row,
+                                  uint8_t col, piece_t piece) {
+  game_event_t ev = {.type = (uint8_t)type};
+  ev.u.piece.square = (uint8_t)(row * 8 + col);
+  ev.u.piece.piece = piece != PIECE_EMPTY ? piece_to_char(piece) : 0;
+  game_emit_event(&ev);
+}
+
 /**
  * @brief Process pickup command (UP)
  */
@@ -231,7 +240,8 @@ void game_process_pickup_command(const chess_move_command_t *cmd) {
   // krátkou hlášku.
   if (promotion_state.pending) {
     // Bezpečnostní kontrola notation stringu
-    if (strlen(cmd->from_notation) == 0 || strlen(cmd->from_notation) > 7) {
+    if (cmd->from_notation[0] == '\0' ||
+      cmd->from_notation[CHESS_NOTATION_SIZE - 1] != '\0') {
       ESP_LOGE(TAG,
                "❌ Invalid or corrupted notation string (promotion pending)");
       game_send_response_to_uart("❌ Invalid notation format", true,
@@ -290,7 +300,8 @@ void game_process_pickup_command(const chess_move_command_t *cmd) {
   game_stop_error_blink();
 
   // Bezpečnostní kontrola notation stringu (array je vždy != NULL)
-  if (strlen(cmd->from_notation) == 0 || strlen(cmd->from_notation) > 7) {
+  if (cmd->from_notation[0] == '\0' ||
+      cmd->from_notation[CHESS_NOTATION_SIZE - 1] != '\0') {
     ESP_LOGE(TAG, "❌ Invalid or corrupted notation string");
     game_send_response_to_uart("❌ Invalid notation format", true,
                                (QueueHandle_t)cmd->response_queue);
@@ -307,6 +318,8 @@ void game_process_pickup_command(const chess_move_command_t *cmd) {
                                (QueueHandle_t)cmd->response_queue);
     return;
   }
+  game_emit_piece_event(GAME_EVENT_PIECE_LIFTED, from_row, from_col,
+                        board[from_row][from_col]);
 
   // KONTROLA ERROR RECOVERY STAVU
   if (error_recovery_state.waiting_for_move_correction) {
@@ -959,6 +972,8 @@ void game_process_drop_command(const chess_move_command_t *cmd) {
                                (QueueHandle_t)cmd->response_queue);
     return;
   }
+  game_emit_piece_event(GAME_EVENT_PIECE_PLACED, to_row, to_col,
+                        piece_lifted ? lifted_piece : PIECE_EMPTY);
 
   // Při každém položení figurky (DROP) vždy přerušit červené blikání – ať už
   // uživatel položil během animace nebo po ní; zvednutí–položení rychle za
@@ -1775,9 +1790,7 @@ void game_process_drop_command(const chess_move_command_t *cmd) {
 
     if (move_success) {
       if (puzzle_active) {
-        puzzle_active = false;
-        puzzle_feedback = PUZZLE_FEEDBACK_SOLVED;
-        STAGING_LOGI(TAG, "puzzle: solved id=%u", (unsigned)puzzle_active_id);
+        game_puzzle_advance_after_move();
       }
       if (game_is_opening_trainer_active()) {
         if (game_opening_awaiting_opponent_physical()) {
@@ -2407,8 +2420,10 @@ void game_process_chess_move(const chess_move_command_t *cmd) {
 
   // KRITICKÁ OPRAVA: Bezpečnostní kontrola všech notation stringů (arrays
   // jsou vždy != NULL)
-  if (strlen(cmd->from_notation) == 0 || strlen(cmd->from_notation) > 7 ||
-      strlen(cmd->to_notation) == 0 || strlen(cmd->to_notation) > 7) {
+  if (cmd->from_notation[0] == '\0' ||
+      cmd->from_notation[CHESS_NOTATION_SIZE - 1] != '\0' ||
+      cmd->to_notation[0] == '\0' ||
+      cmd->to_notation[CHESS_NOTATION_SIZE - 1] != '\0') {
     ESP_LOGE(TAG, "❌ Invalid or corrupted move notation");
     return;
   }
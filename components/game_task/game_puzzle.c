@@ -1,6 +1,6 @@
 /**
  * @file game_puzzle.c
- * @brief Chess puzzle definitions, setup, and lifecycle.
+ * @brief Chess puzzle setup and lifecycle (puzzles from game_puzzle_db).
  */
 
 #include "game_task_internal.h"
@@ -25,41 +25,109 @@ static const char *TAG = "GAME_PUZZLE";
 #define STAGING_LOGI(tag, fmt, ...) ((void)0)
 #endif
 
-static const game_puzzle_definition_t game_puzzles[] = {
-    {1, 1, "Mat 1 – Dáma na poslední řadě",
-     "Klasický motiv: otevřený f-sloupec, dáma dá mat na f8.",
-     "7k/7p/8/8/8/8/5Q2/6K1 w - - 0 1", "f2", "f8"},
-    {2, 2, "Mat 1 – Dáma po sloupci",
-     "Útok po ose: dáma stoupá z b2 na b8.",
-     "6k1/5ppp/8/8/8/8/1Q6/6K1 w - - 0 1", "b2", "b8"},
-    {3, 3, "Mat 1 – Věž bere věž",
-     "Taktika zadní řady: bílá věž sebere černou na e8 a matuje krále.",
-     "4r1k1/5ppp/8/8/8/8/4R3/4K3 w - - 0 1", "e2", "e8"},
-    {4, 4, "Mat 1 – Školácký mat",
-     "Známá ukázková pozice: střelec na c4, dáma na h5 — mat na f7.",
-     "r1bqkb1r/pppp1ppp/2n2n2/4p2Q/2B1P3/8/PPPP1PPP/RNB1K1NR w KQkq - 0 1",
-     "h5", "f7"},
-    {5, 5, "Mat 1 – Dáma na d8",
-     "Centrální úder: dáma z d4 uzavře mat na poli d8.",
-     "6k1/5ppp/8/8/3Q4/8/6PP/6K1 w - - 0 1", "d4", "d8"},
-};
 bool puzzle_active = false;
 /** Příprava fyzické pozice před game_puzzle_start (prázdná logika, matrix v JSON). */
 bool puzzle_setup_active = false;
-uint8_t puzzle_setup_id = 0;
-uint8_t puzzle_active_id = 0;
+uint16_t puzzle_setup_id = 0;
+uint16_t puzzle_active_id = 0;
 uint8_t puzzle_solution_from_row = 0;
 uint8_t puzzle_solution_from_col = 0;
 uint8_t puzzle_solution_to_row = 0;
 uint8_t puzzle_solution_to_col = 0;
 puzzle_feedback_t puzzle_feedback = PUZZLE_FEEDBACK_NONE;
-const game_puzzle_definition_t *game_get_puzzle_definition(uint8_t puzzle_id) {
-  for (size_t i = 0; i < (sizeof(game_puzzles) / sizeof(game_puzzles[0])); i++) {
-    if (game_puzzles[i].id == puzzle_id) {
-      return &game_puzzles[i];
+
+/** Jediná úloha v RAM (setup i hra) — databáze zůstává ve flash. */
+static game_puzzle_t s_puzzle;
+static uint8_t s_puzzle_ply;
+static player_t s_puzzle_solver;
+
+#define PUZZLE_FLAG_BLACK 0x01u
+#define PUZZLE_FLAG_CASTLE_WK 0x02u
+#define PUZZLE_FLAG_CASTLE_WQ 0x04u
+#define PUZZLE_FLAG_CASTLE_BK 0x08u
+#define PUZZLE_FLAG_CASTLE_BQ 0x10u
+
+static bool puzzle_load(uint16_t puzzle_id) {
+  if (!game_puzzle_db_load(puzzle_id, &s_puzzle)) {
+    memset(&s_puzzle, 0, sizeof(s_puzzle));
+    return false;
+  }
+  return true;
+}
+
+const game_puzzle_t *game_puzzle_current(void) {
+  if (!(puzzle_active || puzzle_setup_active) || s_puzzle.id == 0) {
+    return NULL;
+  }
+  return &s_puzzle;
+}
+
+uint8_t game_puzzle_current_ply(void) { return s_puzzle_ply; }
+
+/** Rošády a en passant ze záznamu (FEN loader čte jen rozmístění a stranu). */
+static void puzzle_apply_position_flags(const game_puzzle_t *p) {
+  white_king_moved = !(p->flags & (PUZZLE_FLAG_CASTLE_WK | PUZZLE_FLAG_CASTLE_WQ));
+  white_rook_h_moved = !(p->flags & PUZZLE_FLAG_CASTLE_WK);
+  white_rook_a_moved = !(p->flags & PUZZLE_FLAG_CASTLE_WQ);
+  black_king_moved = !(p->flags & (PUZZLE_FLAG_CASTLE_BK | PUZZLE_FLAG_CASTLE_BQ));
+  black_rook_h_moved = !(p->flags & PUZZLE_FLAG_CASTLE_BK);
+  black_rook_a_moved = !(p->flags & PUZZLE_FLAG_CASTLE_BQ);
+  en_passant_available = false;
+  if (p->ep_file >= 1 && p->ep_file <= 8) {
+    bool black = (p->flags & PUZZLE_FLAG_BLACK) != 0;
+    en_passant_available = true;
+    en_passant_target_col = (uint8_t)(p->ep_file - 1);
+    en_passant_victim_col = en_passant_target_col;
+    en_passant_target_row = black ? 2 : 5;
+    en_passant_victim_row = black ? 3 : 4;
+  }
+}
+
+/** Půltah řešení musí být mezi legálními tahy generátoru hry. */
+static bool puzzle_ply_is_legal(uint16_t move) {
+  uint8_t from = GAME_PUZZLE_MOVE_FROM(move);
+  uint8_t to = GAME_PUZZLE_MOVE_TO(move);
+  uint32_t n = game_generate_legal_moves(current_player);
+  for (uint32_t i = 0; i < n; i++) {
+    const chess_move_extended_t *m = &legal_moves_buffer[i];
+    if (m->from_row == from / 8 && m->from_col == from % 8 &&
+        m->to_row == to / 8 && m->to_col == to % 8) {
+      return true;
     }
   }
-  return NULL;
+  return false;
+}
+
+/** Nastaví očekávaný půltah s_puzzle_ply; false = řešení nesedí na pozici. */
+static bool puzzle_expect_ply(void) {
+  uint16_t move = s_puzzle.moves[s_puzzle_ply];
+  if (!puzzle_ply_is_legal(move)) {
+    ESP_LOGE(TAG, "puzzle %u: ply %u (%c%u%c%u) is not legal", (unsigned)s_puzzle.id,
+             (unsigned)s_puzzle_ply, 'a' + GAME_PUZZLE_MOVE_FROM(move) % 8,
+             (unsigned)(GAME_PUZZLE_MOVE_FROM(move) / 8 + 1),
+             'a' + GAME_PUZZLE_MOVE_TO(move) % 8,
+             (unsigned)(GAME_PUZZLE_MOVE_TO(move) / 8 + 1));
+    return false;
+  }
+  puzzle_solution_from_row = GAME_PUZZLE_MOVE_FROM(move) / 8;
+  puzzle_solution_from_col = GAME_PUZZLE_MOVE_FROM(move) % 8;
+  puzzle_solution_to_row = GAME_PUZZLE_MOVE_TO(move) / 8;
+  puzzle_solution_to_col = GAME_PUZZLE_MOVE_TO(move) % 8;
+  return true;
+}
+
+/** Tah soupeře: odkud (modře) a kam — hráč ho přehraje na desce. */
+static void puzzle_show_opponent_led(void) {
+  uint8_t from_led =
+      chess_pos_to_led_index(puzzle_solution_from_row, puzzle_solution_from_col);
+  uint8_t to_led =
+      chess_pos_to_led_index(puzzle_solution_to_row, puzzle_solution_to_col);
+  led_command_t hint_cmd = {
+      .type = LED_CMD_HIGHLIGHT_HINT,
+      .led_index = from_led,
+      .data = &to_led,
+  };
+  led_execute_command_new(&hint_cmd);
 }
 
 /** Očekávaná obsazenost (0/1) z FEN — jen placement, bez typů figurek. */
@@ -120,9 +188,8 @@ bool game_physical_matrix_matches_fen(const char *fen) {
   return true;
 }
 
-bool game_puzzle_enter_setup(uint8_t puzzle_id) {
-  const game_puzzle_definition_t *puzzle = game_get_puzzle_definition(puzzle_id);
-  if (puzzle == NULL) {
+bool game_puzzle_enter_setup(uint16_t puzzle_id) {
+  if (!puzzle_load(puzzle_id)) {
     return false;
   }
   if (game_is_board_setup_tutorial_active()) {
@@ -141,29 +208,27 @@ bool game_puzzle_enter_setup(uint8_t puzzle_id) {
 
 bool game_is_puzzle_setup_active(void) { return puzzle_setup_active; }
 
-bool game_puzzle_start(uint8_t puzzle_id) {
-  const game_puzzle_definition_t *puzzle = game_get_puzzle_definition(puzzle_id);
-  if (puzzle == NULL) {
+bool game_puzzle_start(uint16_t puzzle_id) {
+  if (!puzzle_load(puzzle_id)) {
     return false;
   }
 
   game_reset_game();
 
   player_t fen_player = PLAYER_WHITE;
-  if (!game_load_position_from_fen(puzzle->fen, &fen_player)) {
+  if (!game_load_position_from_fen(s_puzzle.fen, &fen_player)) {
     ESP_LOGE(TAG, "puzzle: failed to load FEN for id=%u", (unsigned)puzzle_id);
     return false;
   }
-
-  uint8_t from_row = 0, from_col = 0, to_row = 0, to_col = 0;
-  if (!convert_notation_to_coords(puzzle->solution_from, &from_row, &from_col) ||
-      !convert_notation_to_coords(puzzle->solution_to, &to_row, &to_col)) {
-    ESP_LOGE(TAG, "puzzle: invalid solution notation for id=%u",
-             (unsigned)puzzle_id);
+  puzzle_apply_position_flags(&s_puzzle);
+  current_player = fen_player;
+  s_puzzle_solver = fen_player;
+  s_puzzle_ply = 0;
+  if (!puzzle_expect_ply()) {
+    puzzle_feedback = PUZZLE_FEEDBACK_INVALID;
     return false;
   }
 
-  current_player = fen_player;
   current_game_state = GAME_STATE_ACTIVE;
   game_active = true;
   game_start_time = esp_timer_get_time() / 1000;
@@ -173,18 +238,67 @@ bool game_puzzle_start(uint8_t puzzle_id) {
   puzzle_setup_id = 0;
   puzzle_active = true;
   puzzle_active_id = puzzle_id;
-  puzzle_solution_from_row = from_row;
-  puzzle_solution_from_col = from_col;
-  puzzle_solution_to_row = to_row;
-  puzzle_solution_to_col = to_col;
   puzzle_feedback = PUZZLE_FEEDBACK_NONE;
   led_clear_board_only();
   chess_policy_highlight_movable_if_enabled();
-  STAGING_LOGI(TAG, "puzzle: started id=%u difficulty=%u",
-               (unsigned)puzzle->id, (unsigned)puzzle->difficulty);
+  STAGING_LOGI(TAG, "puzzle: started id=%u rating=%u plies=%u",
+               (unsigned)s_puzzle.id, (unsigned)s_puzzle.rating,
+               (unsigned)s_puzzle.plies);
   return true;
 }
 
+void game_puzzle_advance_after_move(void) {
+  if (!puzzle_active) {
+    return;
+  }
+  s_puzzle_ply++;
+  if (s_puzzle_ply >= s_puzzle.plies) {
+    puzzle_active = false;
+    puzzle_feedback = PUZZLE_FEEDBACK_SOLVED;
+    STAGING_LOGI(TAG, "puzzle: solved id=%u", (unsigned)puzzle_active_id);
+    return;
+  }
+  if (!puzzle_expect_ply()) {
+    puzzle_active = false;
+    puzzle_feedback = PUZZLE_FEEDBACK_INVALID;
+    return;
+  }
+  if (current_player != s_puzzle_solver) {
+    puzzle_feedback = PUZZLE_FEEDBACK_OPPONENT_TURN;
+    puzzle_show_opponent_led();
+  } else {
+    puzzle_feedback = PUZZLE_FEEDBACK_CORRECT;
+    chess_policy_highlight_movable_if_enabled();
+  }
+  STAGING_LOGI(TAG, "puzzle: id=%u ply %u/%u", (unsigned)puzzle_active_id,
+               (unsigned)s_puzzle_ply, (unsigned)s_puzzle.plies);
+}
+
+void game_process_puzzle_command(const chess_move_command_t *cmd) {
+  if (cmd->promotion_choice == 0U) {
+    game_puzzle_cancel();
+    return;
+  }
+  uint16_t puzzle_id = cmd->timer_data.puzzle.id;
+  if (puzzle_id == 0U) {
+    const game_puzzle_t *cur = game_puzzle_current();
+    puzzle_id = game_puzzle_db_select(cmd->timer_data.puzzle.rating,
+                                      cmd->timer_data.puzzle.theme_mask,
+                                      cur != NULL ? cur->id : 0U);
+  }
+  if (cmd->promotion_choice == 2U) {
+    if (!game_puzzle_enter_setup(puzzle_id)) {
+      ESP_LOGW(TAG, "puzzle: prepare failed id=%u", (unsigned)puzzle_id);
+    }
+  } else if (cmd->promotion_choice == 1U) {
+    if (!game_puzzle_start(puzzle_id)) {
+      ESP_LOGW(TAG, "puzzle: start failed id=%u", (unsigned)puzzle_id);
+    }
+  } else {
+    ESP_LOGW(TAG, "puzzle: unknown action=%u", (unsigned)cmd->promotion_choice);
+  }
+}
+
 void game_puzzle_cancel(void) {
   bool was = puzzle_active || puzzle_setup_active;
   puzzle_active = false;
@@ -209,6 +323,12 @@ const char *game_puzzle_feedback_key(void) {
     return "solved";
   case PUZZLE_FEEDBACK_ILLEGAL:
     return "illegal";
+  case PUZZLE_FEEDBACK_CORRECT:
+    return "correct";
+  case PUZZLE_FEEDBACK_OPPONENT_TURN:
+    return "opponent_turn";
+  case PUZZLE_FEEDBACK_INVALID:
+    return "invalid";
   case PUZZLE_FEEDBACK_NONE:
   default:
     return "none";
@@ -223,6 +343,12 @@ const char *game_puzzle_feedback_message(void) {
     return "Spravne! Puzzle je vyresene.";
   case PUZZLE_FEEDBACK_ILLEGAL:
     return "Nelegalni tah, zkus jiny.";
+  case PUZZLE_FEEDBACK_CORRECT:
+    return "Spravne, pokracuj dalsim tahem.";
+  case PUZZLE_FEEDBACK_OPPONENT_TURN:
+    return "Zahraj tah soupere podle LED.";
+  case PUZZLE_FEEDBACK_INVALID:
+    return "Reseni ulohy neodpovida pozici, zvol jinou ulohu.";
   case PUZZLE_FEEDBACK_NONE:
   default:
     return "";
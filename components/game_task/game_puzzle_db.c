@@ -0,0 +1,324 @@
+/**
+ * @file game_puzzle_db.c
+ * @brief Cteni databaze uloh (game_puzzle_db.h) — zaznam po zaznamu z flash
+ *
+ * Obraz se najde pri prvnim pouziti: v oddilu assets (asset_store) nebo
+ * vestaveny game_puzzle_db_builtin[]. Hlavicka se cte primo z flash, stav
+ * modulu je jen ukazatel na obraz — pripadne soubezne otevreni z web tasku a
+ * game tasku zapise stejnou hodnotu. Po nahrani noveho obrazu assets (jine
+ * image_id) se databaze otevre znovu.
+ */
+
+#include "game_puzzle_db.h"
+
+#include "sdkconfig.h"
+#if CONFIG_CHESS_ASSETS_PARTITION
+#include "asset_store.h"
+#endif
+
+#include "esp_log.h"
+#include "esp_random.h"
+
+#include <stdio.h>
+#include <string.h>
+
+static const char *TAG = "GAME_PUZZLE_DB";
+
+static const uint8_t *volatile s_db;
+static bool s_opened;
+#if CONFIG_CHESS_ASSETS_PARTITION
+static uint32_t s_image_id;
+#endif
+
+/** Hlavicka + vsechny sekce a pasma uvnitr obrazu. */
+static bool puzzle_db_check(const uint8_t *data, size_t len) {
+  game_puzzle_db_header_t h;
+  if (data == NULL || len < sizeof(h)) {
+    return false;
+  }
+  memcpy(&h, data, sizeof(h));
+  if (h.magic != GAME_PUZZLE_DB_MAGIC || h.version != GAME_PUZZLE_DB_VERSION ||
+      h.record_size != sizeof(game_puzzle_db_record_t) || h.count > 0xffff ||
+      h.band_width == 0 || h.band_count == 0 || h.theme_count > 32) {
+    return false;
+  }
+  if ((uint64_t)h.bands_off + (uint64_t)h.band_count * sizeof(game_puzzle_db_band_t) > len ||
+      (uint64_t)h.themes_off + (uint64_t)h.theme_count * GAME_PUZZLE_THEME_NAME_MAX > len ||
+      (uint64_t)h.records_off + (uint64_t)h.count * h.record_size > len) {
+    return false;
+  }
+  for (uint16_t i = 0; i < h.band_count; i++) {
+    game_puzzle_db_band_t b;
+    memcpy(&b, data + h.bands_off + i * sizeof(b), sizeof(b));
+    if (b.count > h.count || b.first > h.count - b.count) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static const uint8_t *puzzle_db_open(void) {
+  const uint8_t *data = NULL;
+  size_t len = 0;
+#if CONFIG_CHESS_ASSETS_PARTITION
+  uint32_t image_id = 0;
+  asset_store_info(&image_id, NULL, NULL);
+  if (s_opened && image_id == s_image_id) {
+    return s_db;
+  }
+  s_db = NULL;
+  s_opened = true;
+  s_image_id = image_id;
+  asset_store_entry_t e;
+  if (!asset_store_find(GAME_PUZZLE_DB_ASSET, &e, NULL)) {
+    ESP_LOGW(TAG, "%s not in assets partition", GAME_PUZZLE_DB_ASSET);
+    return NULL;
+  }
+  if (e.encoding[0] != '\0') {
+    ESP_LOGW(TAG, "%s is %s-encoded, expected identity", GAME_PUZZLE_DB_ASSET,
+             e.encoding);
+    return NULL;
+  }
+  data = e.data;
+  len = e.len;
+#else
+  if (s_opened) {
+    return s_db;
+  }
+  s_opened = true;
+  data = game_puzzle_db_builtin;
+  len = game_puzzle_db_builtin_size;
+#endif
+  if (!puzzle_db_check(data, len)) {
+    ESP_LOGW(TAG, "invalid puzzle database (%u B)", (unsigned)len);
+    return NULL;
+  }
+  const game_puzzle_db_header_t *h = (const game_puzzle_db_header_t *)data;
+  ESP_LOGI(TAG, "puzzle db: %lu puzzles, %u bands, %u themes",
+           (unsigned long)h->count, (unsigned)h->band_count,
+           (unsigned)h->theme_count);
+  s_db = data;
+  return data;
+}
+
+static const game_puzzle_db_header_t *puzzle_db_header(void) {
+  return (const game_puzzle_db_header_t *)puzzle_db_open();
+}
+
+static const char *puzzle_db_theme_name(const game_puzzle_db_header_t *h,
+                                        uint8_t i) {
+  return (const char *)h + h->themes_off + i * GAME_PUZZLE_THEME_NAME_MAX;
+}
+
+bool game_puzzle_db_available(void) { return puzzle_db_header() != NULL; }
+
+uint32_t game_puzzle_db_count(void) {
+  const game_puzzle_db_header_t *h = puzzle_db_header();
+  return h != NULL ? h->count : 0;
+}
+
+/** Kod figury 1..6 (+8 cerna) -> znak FEN, '\0' neplatny. */
+static char puzzle_db_piece_char(uint8_t code) {
+  static const char white[] = "PNBRQK";
+  uint8_t kind = code & 7;
+  if (kind < 1 || kind > 6) {
+    return '\0';
+  }
+  char c = white[kind - 1];
+  return (code & 8) ? (char)(c - 'A' + 'a') : c;
+}
+
+bool game_puzzle_db_load(uint16_t id, game_puzzle_t *out) {
+  const game_puzzle_db_header_t *h = puzzle_db_header();
+  if (h == NULL || out == NULL || id == 0 || id > h->count) {
+    return false;
+  }
+  game_puzzle_db_record_t r;
+  memcpy(&r, (const uint8_t *)h + h->records_off + (size_t)(id - 1) * sizeof(r),
+         sizeof(r));
+  if (r.plies == 0 || r.plies > GAME_PUZZLE_MAX_PLIES) {
+    return false;
+  }
+
+  char squares[64];
+  uint8_t n = 0;
+  for (uint8_t sq = 0; sq < 64; sq++) {
+    squares[sq] = '\0';
+    if ((r.occupancy >> sq) & 1ULL) {
+      if (n >= 32) {
+        return false;
+      }
+      uint8_t code = (r.pieces[n / 2] >> ((n & 1) * 4)) & 0x0f;
+      n++;
+      squares[sq] = puzzle_db_piece_char(code);
+      if (squares[sq] == '\0') {
+        return false;
+      }
+    }
+  }
+
+  char *p = out->fen;
+  for (int row = 7; row >= 0; row--) {
+    int empty = 0;
+    for (int col = 0; col < 8; col++) {
+      char c = squares[row * 8 + col];
+      if (c == '\0') {
+        empty++;
+        continue;
+      }
+      if (empty > 0) {
+        *p++ = (char)('0' + empty);
+        empty = 0;
+      }
+      *p++ = c;
+    }
+    if (empty > 0) {
+      *p++ = (char)('0' + empty);
+    }
+    if (row > 0) {
+      *p++ = '/';
+    }
+  }
+  char castling[5];
+  uint8_t nc = 0;
+  for (uint8_t i = 0; i < 4; i++) {
+    if (r.flags & (1u << (i + 1))) {
+      castling[nc++] = "KQkq"[i];
+    }
+  }
+  if (nc == 0) {
+    castling[nc++] = '-';
+  }
+  castling[nc] = '\0';
+  bool black = (r.flags & 1u) != 0;
+  char ep[3] = "-";
+  if (r.ep_file >= 1 && r.ep_file <= 8) {
+    ep[0] = (char)('a' + r.ep_file - 1);
+    ep[1] = black ? '3' : '6';
+    ep[2] = '\0';
+  }
+  snprintf(p, sizeof(out->fen) - (size_t)(p - out->fen), " %c %s %s 0 1",
+           black ? 'b' : 'w', castling, ep);
+
+  out->id = id;
+  out->rating = r.rating;
+  out->themes = r.themes;
+  out->plies = r.plies;
+  out->flags = r.flags;
+  out->ep_file = r.ep_file;
+  memcpy(out->moves, r.moves, sizeof(out->moves));
+  return true;
+}
+
+/** Nahodny start v pasmu, pak kruhem; `exclude_id` jen jako nahradnik. */
+static uint16_t puzzle_db_pick(const game_puzzle_db_header_t *h, uint16_t band,
+                               uint32_t theme_mask, uint16_t exclude_id,
+                               uint16_t *fallback) {
+  game_puzzle_db_band_t b;
+  memcpy(&b, (const uint8_t *)h + h->bands_off + band * sizeof(b), sizeof(b));
+  if (b.count == 0) {
+    return 0;
+  }
+  const uint8_t *records = (const uint8_t *)h + h->records_off;
+  uint32_t start = esp_random() % b.count;
+  for (uint32_t i = 0; i < b.count; i++) {
+    uint32_t idx = b.first + (start + i) % b.count;
+    if (theme_mask != 0) {
+      uint32_t themes;
+      memcpy(&themes,
+             records + idx * sizeof(game_puzzle_db_record_t) +
+                 offsetof(game_puzzle_db_record_t, themes),
+             sizeof(themes));
+      if ((themes & theme_mask) != theme_mask) {
+        continue;
+      }
+    }
+    uint16_t id = (uint16_t)(idx + 1);
+    if (id == exclude_id) {
+      *fallback = id;
+      continue;
+    }
+    return id;
+  }
+  return 0;
+}
+
+uint16_t game_puzzle_db_select(uint16_t rating, uint32_t theme_mask,
+                               uint16_t exclude_id) {
+  const game_puzzle_db_header_t *h = puzzle_db_header();
+  if (h == NULL || h->count == 0) {
+    return 0;
+  }
+  int band = (rating > h->rating_min) ? (rating - h->rating_min) / h->band_width : 0;
+  if (band >= h->band_count) {
+    band = h->band_count - 1;
+  }
+  uint16_t fallback = 0;
+  for (int d = 0; d < h->band_count; d++) {
+    int candidates[2] = {band - d, band + d};
+    for (int k = 0; k < (d == 0 ? 1 : 2); k++) {
+      int b = candidates[k];
+      if (b < 0 || b >= h->band_count) {
+        continue;
+      }
+      uint16_t id =
+          puzzle_db_pick(h, (uint16_t)b, theme_mask, exclude_id, &fallback);
+      if (id != 0) {
+        return id;
+      }
+    }
+  }
+  return fallback;
+}
+
+uint32_t game_puzzle_db_theme_mask(const char *name) {
+  const game_puzzle_db_header_t *h = puzzle_db_header();
+  if (h == NULL || name == NULL || name[0] == '\0') {
+    return 0;
+  }
+  for (uint8_t i = 0; i < h->theme_count; i++) {
+    if (strncmp(puzzle_db_theme_name(h, i), name, GAME_PUZZLE_THEME_NAME_MAX) ==
+        0) {
+      return 1u << i;
+    }
+  }
+  return 0;
+}
+
+void game_puzzle_db_write_themes(json_writer_t *w, uint32_t mask) {
+  const game_puzzle_db_header_t *h = puzzle_db_header();
+  json_writer_begin_array(w);
+  for (uint8_t i = 0; h != NULL && i < h->theme_count; i++) {
+    if (mask & (1u << i)) {
+      const char *name = puzzle_db_theme_name(h, i);
+      json_writer_string_n(w, name, strnlen(name, GAME_PUZZLE_THEME_NAME_MAX));
+    }
+  }
+  json_writer_end_array(w);
+}
+
+esp_err_t game_puzzle_db_write_info_fields(json_writer_t *w) {
+  const game_puzzle_db_header_t *h = puzzle_db_header();
+  json_writer_kv_bool(w, "available", h != NULL);
+  json_writer_kv_uint(w, "count", h != NULL ? h->count : 0);
+  json_writer_key(w, "bands");
+  json_writer_begin_array(w);
+  for (uint16_t i = 0; h != NULL && i < h->band_count; i++) {
+    game_puzzle_db_band_t b;
+    memcpy(&b, (const uint8_t *)h + h->bands_off + i * sizeof(b), sizeof(b));
+    if (b.count == 0) {
+      continue;
+    }
+    uint32_t lo = h->rating_min + (uint32_t)i * h->band_width;
+    json_writer_begin_object(w);
+    json_writer_kv_uint(w, "min", lo);
+    json_writer_kv_uint(w, "max", lo + h->band_width - 1);
+    json_writer_kv_uint(w, "first_id", b.first + 1);
+    json_writer_kv_uint(w, "count", b.count);
+    json_writer_end_object(w);
+  }
+  json_writer_end_array(w);
+  json_writer_key(w, "themes");
+  game_puzzle_db_write_themes(w, h != NULL ? 0xffffffffu : 0);
+  return json_writer_error(w);
+}
@@ -1,14 +1,36 @@
 /**
  * @file game_snapshot.c
  * @brief NVS persistence for game state and boot tracker.
+ *
+ * Po tahu se do journalu (game_journal.c) pripise jen delta obrazu snapshotu
+ * proti poslednimu ulozenemu: zmenene bajty hlavni casti + pridany/odebrany
+ * tah historie (typicky 20–40 B misto ~600 B blobu a NVS commitu). Plny
+ * snapshot do NVS (checkpoint) jen kazdych GAME_JOURNAL_CHECKPOINT_EVERY
+ * tahu, po bootu a kdyz delta nejde vyjadrit. Bez oddilu `journal` se
+ * uklada do NVS po kazdem tahu jako drive.
+ *
+ * Checkpoint se zapisuje stridave do dvou slotu NVS (A/B) s rostoucim `seq`.
+ * Prepisuje se vzdy slot, ktery nedrzi nejnovejsi platny obraz, takze vypadek
+ * napajeni uprostred zapisu prijde nejvys o tento checkpoint, nikdy o oba.
+ * Slot nese jen pouzitou cast historie a CRC32 (ROM, tabulkove) pres ni. Pri
+ * bootu se oba sloty a min fallback prectou jednou a vybere se platny obraz
+ * s nejvyssim `seq`.
+ *
+ * Zapis (journal, NVS, boot tracker) bezi v persist tasku (config_persist.h);
+ * game_task jen vyplni obraz snapshotu. Stav journalu a boot_tracker_moved_saved
+ * po bootu meni jen persist task.
  */
 
 #include "game_snapshot.h"
+#include "game_journal.h"
 #include "game_matrix_guard.h"
 #include "game_task_internal.h"
 
 #include "../config_manager/include/config_manager.h"
+#include "config_persist.h"
 #include "esp_log.h"
+#include "esp_rom_crc.h"
+#include <stddef.h>
 #include <string.h>
 #include <time.h>
 
@@ -20,13 +42,18 @@ static const char *TAG = "GAME_SNAPSHOT";
 #define STAGING_LOGI(tag, fmt, ...) ((void)0)
 #endif
 
-#define GAME_SNAPSHOT_VERSION 1
+#define GAME_SNAPSHOT_VERSION 2
 #define GAME_SNAPSHOT_HISTORY_CAP 40
 #define BOOT_WINDOW_SECONDS 60
+/** Delt v journalu mezi dvema checkpointy do NVS. */
+#define GAME_JOURNAL_CHECKPOINT_EVERY 32
+/** Klic persist fronty pro smazani snapshotu (nova hra). */
+#define GAME_SNAPSHOT_ERASE_KEY "g_snap_erase"
 
 typedef struct {
   uint32_t version;
   uint32_t crc32;
+  uint32_t seq; ///< Roste s kazdym zapisem (sloty A/B i min)
   uint8_t format;
   uint8_t board[64];
   uint8_t current_player;
@@ -58,6 +85,7 @@ typedef struct {
 typedef struct {
   uint32_t version;
   uint32_t crc32;
+  uint32_t seq; ///< Roste s kazdym zapisem (sloty A/B i min)
   uint8_t format;
   uint8_t board[64];
   uint8_t current_player;
@@ -80,6 +108,30 @@ typedef struct {
   uint8_t promotion_player;
 } game_snapshot_min_t;
 
+/* Min snapshot je prefix plneho (stejne rozlozeni), kopiruje se memcpy. */
+_Static_assert(offsetof(game_snapshot_full_t, promotion_player) ==
+                   offsetof(game_snapshot_min_t, promotion_player),
+               "min snapshot musi byt prefix plneho");
+_Static_assert(sizeof(game_snapshot_min_t) <=
+                   offsetof(game_snapshot_full_t, white_time_total),
+               "min snapshot musi byt prefix plneho");
+
+/* Delta zaznam journalu:
+ *   [hist_op] (+ 8 B tahu u APPEND)
+ *   ([off u8][len u8][len B])* — zmenene useky obrazu pred history_count
+ */
+enum {
+  SNAPSHOT_HIST_NONE = 0,
+  SNAPSHOT_HIST_APPEND = 1,
+  SNAPSHOT_HIST_POP = 2,
+};
+#define SNAPSHOT_DELTA_HEAD_END offsetof(game_snapshot_full_t, history_count)
+#define SNAPSHOT_DELTA_HEAD_START offsetof(game_snapshot_full_t, format)
+/** Kratsi mezera nez tohle spoji dva useky (hlavicka useku = 2 B). */
+#define SNAPSHOT_DELTA_MERGE_GAP 2
+_Static_assert(SNAPSHOT_DELTA_HEAD_END <= 255,
+               "delta offset musi vejit do uint8_t");
+
 typedef struct {
   uint32_t version;
   uint32_t crc32;
@@ -93,17 +145,49 @@ static bool snapshot_restore_failed = false;
 static bool snapshot_save_failed = false;
 static bool snapshot_fallback_used = false;
 static bool boot_new_game_triggered = false;
+static bool boot_tracker_moved_saved = false;
 
-static uint32_t game_crc32_simple(const uint8_t *data, size_t len) {
-  uint32_t h = 2166136261u;
-  if (data == NULL) {
-    return h;
-  }
-  for (size_t i = 0; i < len; i++) {
-    h ^= data[i];
-    h *= 16777619u;
-  }
-  return h;
+/**
+ * Obraz, ktery reprezentuje checkpoint + delty otevrene epochy journalu.
+ * Po bootu v nem je obraz vybrany z NVS (game_snapshot_read_boot).
+ */
+static game_snapshot_full_t s_journal_image;
+
+/* A/B sloty; s_snapshot_seq a s_newest_slot po bootu meni jen persist task. */
+static const char *const s_slot_keys[2] = {CONFIG_NVS_KEY_GAME_SNAPSHOT_A,
+                                           CONFIG_NVS_KEY_GAME_SNAPSHOT_B};
+static uint32_t s_snapshot_seq; ///< Posledni pridelene seq
+static int s_newest_slot = -1;  ///< Slot s nejnovejsim platnym obrazem
+
+typedef enum {
+  BOOT_SNAPSHOT_UNREAD = 0,
+  BOOT_SNAPSHOT_NONE,
+  BOOT_SNAPSHOT_FULL,
+  BOOT_SNAPSHOT_MIN, ///< s_journal_image ma jen cast min, bez historie
+} boot_snapshot_t;
+static boot_snapshot_t s_boot_snapshot;
+
+/** CRC32 pres prvnich `len` B objektu bez version a crc32. */
+static uint32_t snapshot_crc32(const void *obj, size_t len) {
+  return esp_rom_crc32_le(0, (const uint8_t *)obj + 8, len - 8);
+}
+
+/** Ulozena delka plneho obrazu: bez nepouzite casti historie. */
+static size_t snapshot_full_len(const game_snapshot_full_t *s) {
+  return offsetof(game_snapshot_full_t, history) +
+         (size_t)s->history_count * sizeof(chess_move_t);
+}
+
+static bool snapshot_full_valid(const game_snapshot_full_t *s, size_t len) {
+  return len >= offsetof(game_snapshot_full_t, history) &&
+         s->version == GAME_SNAPSHOT_VERSION &&
+         s->history_count <= GAME_SNAPSHOT_HISTORY_CAP &&
+         len == snapshot_full_len(s) && s->crc32 == snapshot_crc32(s, len);
+}
+
+static bool snapshot_min_valid(const game_snapshot_min_t *s, size_t len) {
+  return len == sizeof(*s) && s->version == GAME_SNAPSHOT_VERSION &&
+         s->crc32 == snapshot_crc32(s, sizeof(*s));
 }
 
 static void game_snapshot_fill_board(uint8_t out_board[64]) {
@@ -138,10 +222,28 @@ bool game_has_snapshot_save_failure(void) { return snapshot_save_failed; }
 
 bool game_was_boot_new_game_triggered(void) { return boot_new_game_triggered; }
 
-void game_snapshot_erase_nvs(void) {
-  (void)config_erase_key_from_nvs(CONFIG_NVS_KEY_GAME_SNAPSHOT_FULL);
+/** config_persist_write_fn: smazani snapshotu v persist tasku. */
+static esp_err_t game_snapshot_erase_job(const char *key, const void *data,
+                                         size_t len) {
+  (void)key;
+  (void)data;
+  (void)len;
+  game_journal_close_epoch(); /* bez checkpointu nemaji delty zaklad */
+  boot_tracker_moved_saved = false;
+  s_newest_slot = -1; /* seq bezi dal, at stary obraz nikdy nevyhraje */
+  (void)config_erase_key_from_nvs(CONFIG_NVS_KEY_GAME_SNAPSHOT_A);
+  (void)config_erase_key_from_nvs(CONFIG_NVS_KEY_GAME_SNAPSHOT_B);
   (void)config_erase_key_from_nvs(CONFIG_NVS_KEY_GAME_SNAPSHOT_MIN);
+  (void)config_erase_key_from_nvs(CONFIG_NVS_KEY_GAME_SNAPSHOT_FULL);
   (void)config_erase_key_from_nvs(CONFIG_NVS_KEY_BOOT_TRACKER);
+  return ESP_OK;
+}
+
+void game_snapshot_erase_nvs(void) {
+  /* Stejna priorita jako ulozeni tahu → FIFO: starsi zapis pred smazanim,
+   * prvni tah nove hry az po nem. */
+  (void)config_persist_submit(GAME_SNAPSHOT_ERASE_KEY, game_snapshot_erase_job,
+                              NULL, 0, CONFIG_PERSIST_PRIO_HIGH, NULL);
 }
 
 void game_snapshot_reset_failure_flags(void) {
@@ -149,75 +251,67 @@ void game_snapshot_reset_failure_flags(void) {
   snapshot_restore_failed = false;
 }
 
-static esp_err_t game_save_snapshot_to_nvs(void) {
-  game_snapshot_full_t full = {0};
-  full.version = GAME_SNAPSHOT_VERSION;
-  full.format = 2;
-  game_snapshot_fill_board(full.board);
-  full.current_player = (uint8_t)current_player;
-  full.game_state = (uint8_t)current_game_state;
-  full.move_count = move_count;
-  full.white_king_moved = (uint8_t)white_king_moved;
-  full.white_rook_a_moved = (uint8_t)white_rook_a_moved;
-  full.white_rook_h_moved = (uint8_t)white_rook_h_moved;
-  full.black_king_moved = (uint8_t)black_king_moved;
-  full.black_rook_a_moved = (uint8_t)black_rook_a_moved;
-  full.black_rook_h_moved = (uint8_t)black_rook_h_moved;
-  full.en_passant_available = (uint8_t)en_passant_available;
-  full.en_passant_target_row = en_passant_target_row;
-  full.en_passant_target_col = en_passant_target_col;
-  full.en_passant_victim_row = en_passant_victim_row;
-  full.en_passant_victim_col = en_passant_victim_col;
-  full.promotion_pending = (uint8_t)promotion_state.pending;
-  full.promotion_row = promotion_state.square_row;
-  full.promotion_col = promotion_state.square_col;
-  full.promotion_player = (uint8_t)promotion_state.player;
-  full.white_time_total = white_time_total;
-  full.black_time_total = black_time_total;
-  full.white_remaining_ms = game_get_remaining_time(true);
-  full.black_remaining_ms = game_get_remaining_time(false);
-  full.history_count = (history_index > GAME_SNAPSHOT_HISTORY_CAP)
-                           ? GAME_SNAPSHOT_HISTORY_CAP
-                           : (uint8_t)history_index;
-  if (full.history_count > 0) {
-    uint32_t start = history_index - full.history_count;
-    for (uint8_t i = 0; i < full.history_count; i++) {
-      full.history[i] = move_history[start + i];
+static void game_snapshot_fill_full(game_snapshot_full_t *out) {
+  memset(out, 0, sizeof(*out));
+  out->version = GAME_SNAPSHOT_VERSION;
+  out->format = 2;
+  game_snapshot_fill_board(out->board);
+  out->current_player = (uint8_t)current_player;
+  out->game_state = (uint8_t)current_game_state;
+  out->move_count = move_count;
+  out->white_king_moved = (uint8_t)white_king_moved;
+  out->white_rook_a_moved = (uint8_t)white_rook_a_moved;
+  out->white_rook_h_moved = (uint8_t)white_rook_h_moved;
+  out->black_king_moved = (uint8_t)black_king_moved;
+  out->black_rook_a_moved = (uint8_t)black_rook_a_moved;
+  out->black_rook_h_moved = (uint8_t)black_rook_h_moved;
+  out->en_passant_available = (uint8_t)en_passant_available;
+  out->en_passant_target_row = en_passant_target_row;
+  out->en_passant_target_col = en_passant_target_col;
+  out->en_passant_victim_row = en_passant_victim_row;
+  out->en_passant_victim_col = en_passant_victim_col;
+  out->promotion_pending = (uint8_t)promotion_state.pending;
+  out->promotion_row = promotion_state.square_row;
+  out->promotion_col = promotion_state.square_col;
+  out->promotion_player = (uint8_t)promotion_state.player;
+  out->white_time_total = white_time_total;
+  out->black_time_total = black_time_total;
+  out->white_remaining_ms = game_get_remaining_time(true);
+  out->black_remaining_ms = game_get_remaining_time(false);
+  out->history_count = (history_index > GAME_SNAPSHOT_HISTORY_CAP)
+                          ? GAME_SNAPSHOT_HISTORY_CAP
+                          : (uint8_t)history_index;
+  if (out->history_count > 0) {
+    uint32_t start = history_index - out->history_count;
+    for (uint8_t i = 0; i < out->history_count; i++) {
+      out->history[i] = move_history[start + i];
     }
   }
-  full.crc32 = game_crc32_simple(((const uint8_t *)&full) + 8, sizeof(full) - 8);
+  /* seq a crc32 doplni zapis (game_save_snapshot_to_nvs) */
+}
 
-  esp_err_t ret = config_save_blob_to_nvs(CONFIG_NVS_KEY_GAME_SNAPSHOT_FULL, &full,
-                                          sizeof(full));
+/**
+ * Zapis do slotu, ktery nedrzi nejnovejsi platny obraz; doplni seq a crc32.
+ * Kdyz selze, zkusi min snapshot (bez historie) pod vlastnim seq.
+ */
+static esp_err_t game_save_snapshot_to_nvs(game_snapshot_full_t *full) {
+  int slot = (s_newest_slot == 0) ? 1 : 0;
+  size_t len = snapshot_full_len(full);
+  full->seq = ++s_snapshot_seq;
+  full->crc32 = snapshot_crc32(full, len);
+  esp_err_t ret = config_save_blob_to_nvs(s_slot_keys[slot], full, len);
   if (ret == ESP_OK) {
+    s_newest_slot = slot;
     snapshot_fallback_used = false;
     snapshot_save_failed = false;
     return ESP_OK;
   }
 
-  game_snapshot_min_t min = {0};
-  min.version = GAME_SNAPSHOT_VERSION;
+  game_snapshot_min_t min;
+  memcpy(&min, full, sizeof(min));
   min.format = 1;
-  memcpy(min.board, full.board, sizeof(min.board));
-  min.current_player = full.current_player;
-  min.game_state = full.game_state;
-  min.move_count = full.move_count;
-  min.white_king_moved = full.white_king_moved;
-  min.white_rook_a_moved = full.white_rook_a_moved;
-  min.white_rook_h_moved = full.white_rook_h_moved;
-  min.black_king_moved = full.black_king_moved;
-  min.black_rook_a_moved = full.black_rook_a_moved;
-  min.black_rook_h_moved = full.black_rook_h_moved;
-  min.en_passant_available = full.en_passant_available;
-  min.en_passant_target_row = full.en_passant_target_row;
-  min.en_passant_target_col = full.en_passant_target_col;
-  min.en_passant_victim_row = full.en_passant_victim_row;
-  min.en_passant_victim_col = full.en_passant_victim_col;
-  min.promotion_pending = full.promotion_pending;
-  min.promotion_row = full.promotion_row;
-  min.promotion_col = full.promotion_col;
-  min.promotion_player = full.promotion_player;
-  min.crc32 = game_crc32_simple(((const uint8_t *)&min) + 8, sizeof(min) - 8);
+  min.seq = ++s_snapshot_seq;
+  min.crc32 = snapshot_crc32(&min, sizeof(min));
 
   ret = config_save_blob_to_nvs(CONFIG_NVS_KEY_GAME_SNAPSHOT_MIN, &min, sizeof(min));
   if (ret == ESP_OK) {
@@ -229,107 +323,252 @@ static esp_err_t game_save_snapshot_to_nvs(void) {
   return ret;
 }
 
-bool game_snapshot_nvs_has_valid(void) {
-  game_snapshot_full_t full = {0};
-  size_t full_len = sizeof(full);
-  esp_err_t ret =
-      config_load_blob_from_nvs(CONFIG_NVS_KEY_GAME_SNAPSHOT_FULL, &full, &full_len);
-  if (ret == ESP_OK && full_len == sizeof(full) &&
-      full.version == GAME_SNAPSHOT_VERSION &&
-      full.crc32 ==
-          game_crc32_simple(((const uint8_t *)&full) + 8, sizeof(full) - 8)) {
-    return true;
+// ============================================================================
+// JOURNAL DELTA (obraz snapshotu → par desitek bajtu na tah)
+// ============================================================================
+
+static void snapshot_move_pack(const chess_move_t *m, uint8_t out[8]) {
+  out[0] = (uint8_t)(m->from_row * 8 + m->from_col);
+  out[1] = (uint8_t)(m->to_row * 8 + m->to_col);
+  out[2] = (uint8_t)m->piece;
+  out[3] = (uint8_t)m->captured_piece;
+  memcpy(&out[4], &m->timestamp, sizeof(uint32_t));
+}
+
+static void snapshot_move_unpack(const uint8_t in[8], chess_move_t *m) {
+  memset(m, 0, sizeof(*m));
+  m->from_row = in[0] / 8;
+  m->from_col = in[0] % 8;
+  m->to_row = in[1] / 8;
+  m->to_col = in[1] % 8;
+  m->piece = (piece_t)in[2];
+  m->captured_piece = (piece_t)in[3];
+  memcpy(&m->timestamp, &in[4], sizeof(uint32_t));
+}
+
+/** Obraz po pridani tahu na konec historie (plna historie se posune). */
+static void snapshot_history_append(game_snapshot_full_t *img,
+                                    const chess_move_t *m) {
+  if (img->history_count < GAME_SNAPSHOT_HISTORY_CAP) {
+    img->history[img->history_count++] = *m;
+    return;
   }
+  memmove(&img->history[0], &img->history[1],
+          sizeof(chess_move_t) * (GAME_SNAPSHOT_HISTORY_CAP - 1));
+  img->history[GAME_SNAPSHOT_HISTORY_CAP - 1] = *m;
+}
 
-  game_snapshot_min_t min = {0};
-  size_t min_len = sizeof(min);
-  ret = config_load_blob_from_nvs(CONFIG_NVS_KEY_GAME_SNAPSHOT_MIN, &min, &min_len);
-  if (ret == ESP_OK && min_len == sizeof(min) && min.version == GAME_SNAPSHOT_VERSION &&
-      min.crc32 ==
-          game_crc32_simple(((const uint8_t *)&min) + 8, sizeof(min) - 8)) {
-    return true;
+/**
+ * Delta `base` → `next`. False = nejde vyjadrit (nova hra, undo pres plnou
+ * historii, prilis zmen) → checkpoint.
+ */
+static bool snapshot_delta_encode(const game_snapshot_full_t *base,
+                                  const game_snapshot_full_t *next,
+                                  uint8_t *out, size_t cap, size_t *out_len) {
+  size_t n = 0;
+  uint8_t bc = base->history_count;
+  uint8_t nc = next->history_count;
+  const size_t mv = sizeof(chess_move_t);
+
+  if (nc == bc) {
+    if (memcmp(base->history, next->history, mv * bc) != 0) {
+      return false;
+    }
+    out[n++] = SNAPSHOT_HIST_NONE;
+  } else if (nc == bc + 1 &&
+             memcmp(base->history, next->history, mv * bc) == 0) {
+    out[n++] = SNAPSHOT_HIST_APPEND;
+    snapshot_move_pack(&next->history[bc], &out[n]);
+    n += 8;
+  } else if (nc == GAME_SNAPSHOT_HISTORY_CAP && bc == GAME_SNAPSHOT_HISTORY_CAP &&
+             memcmp(&base->history[1], next->history, mv * (bc - 1)) == 0) {
+    out[n++] = SNAPSHOT_HIST_APPEND; /* plna historie: posun o jeden */
+    snapshot_move_pack(&next->history[bc - 1], &out[n]);
+    n += 8;
+  } else if (bc > 0 && nc == bc - 1 && bc < GAME_SNAPSHOT_HISTORY_CAP &&
+             memcmp(base->history, next->history, mv * nc) == 0) {
+    out[n++] = SNAPSHOT_HIST_POP; /* undo; z plne historie jen checkpoint */
+  } else {
+    return false;
+  }
+
+  const uint8_t *a = (const uint8_t *)base;
+  const uint8_t *b = (const uint8_t *)next;
+  size_t i = SNAPSHOT_DELTA_HEAD_START;
+  while (i < SNAPSHOT_DELTA_HEAD_END) {
+    if (a[i] == b[i]) {
+      i++;
+      continue;
+    }
+    size_t start = i;
+    size_t end = i + 1; /* za poslednim zmenenym bajtem useku */
+    for (size_t j = end; j < SNAPSHOT_DELTA_HEAD_END &&
+                         j < end + SNAPSHOT_DELTA_MERGE_GAP + 1;
+         j++) {
+      if (a[j] != b[j]) {
+        end = j + 1;
+      }
+    }
+    size_t len = end - start;
+    if (n + 2 + len > cap) {
+      return false;
+    }
+    out[n++] = (uint8_t)start;
+    out[n++] = (uint8_t)len;
+    memcpy(&out[n], &b[start], len);
+    n += len;
+    i = end;
   }
-  return false;
+  *out_len = n;
+  return true;
 }
 
-static esp_err_t game_load_snapshot_from_nvs(void) {
-  game_snapshot_full_t full = {0};
-  size_t full_len = sizeof(full);
-  esp_err_t ret =
-      config_load_blob_from_nvs(CONFIG_NVS_KEY_GAME_SNAPSHOT_FULL, &full, &full_len);
-  if (ret == ESP_OK && full_len == sizeof(full) &&
-      full.version == GAME_SNAPSHOT_VERSION &&
-      full.crc32 ==
-          game_crc32_simple(((const uint8_t *)&full) + 8, sizeof(full) - 8)) {
-    snapshot_restore_failed = false;
-    game_snapshot_apply_board(full.board);
-    current_player = (player_t)full.current_player;
-    current_game_state = (game_state_t)full.game_state;
-    move_count = full.move_count;
-    white_king_moved = full.white_king_moved;
-    white_rook_a_moved = full.white_rook_a_moved;
-    white_rook_h_moved = full.white_rook_h_moved;
-    black_king_moved = full.black_king_moved;
-    black_rook_a_moved = full.black_rook_a_moved;
-    black_rook_h_moved = full.black_rook_h_moved;
-    en_passant_available = full.en_passant_available;
-    en_passant_target_row = full.en_passant_target_row;
-    en_passant_target_col = full.en_passant_target_col;
-    en_passant_victim_row = full.en_passant_victim_row;
-    en_passant_victim_col = full.en_passant_victim_col;
-    promotion_state.pending = full.promotion_pending;
-    promotion_state.square_row = full.promotion_row;
-    promotion_state.square_col = full.promotion_col;
-    promotion_state.player = (player_t)full.promotion_player;
-    white_time_total = full.white_time_total;
-    black_time_total = full.black_time_total;
-    history_index = full.history_count;
-    if (history_index > 0) {
-      memcpy(move_history, full.history, sizeof(chess_move_t) * history_index);
+/** game_journal_apply_fn: aplikuje deltu na obraz nacteny z NVS. */
+static esp_err_t snapshot_delta_apply(void *ctx, const uint8_t *p,
+                                      size_t len) {
+  game_snapshot_full_t *img = (game_snapshot_full_t *)ctx;
+  size_t n = 0;
+  if (len < 1) {
+    return ESP_ERR_INVALID_SIZE;
+  }
+  uint8_t op = p[n++];
+  if (op == SNAPSHOT_HIST_APPEND) {
+    if (len < n + 8) {
+      return ESP_ERR_INVALID_SIZE;
+    }
+    chess_move_t m;
+    snapshot_move_unpack(&p[n], &m);
+    snapshot_history_append(img, &m);
+    n += 8;
+  } else if (op == SNAPSHOT_HIST_POP) {
+    if (img->history_count == 0) {
+      return ESP_ERR_INVALID_STATE;
+    }
+    img->history_count--;
+    memset(&img->history[img->history_count], 0, sizeof(chess_move_t));
+  } else if (op != SNAPSHOT_HIST_NONE) {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  uint8_t *b = (uint8_t *)img;
+  while (n < len) {
+    if (len < n + 2) {
+      return ESP_ERR_INVALID_SIZE;
+    }
+    size_t off = p[n];
+    size_t run = p[n + 1];
+    n += 2;
+    if (off < SNAPSHOT_DELTA_HEAD_START ||
+        off + run > SNAPSHOT_DELTA_HEAD_END || n + run > len) {
+      return ESP_ERR_INVALID_SIZE;
+    }
+    memcpy(&b[off], &p[n], run);
+    n += run;
+  }
+  return ESP_OK;
+}
+
+/**
+ * Jednou pri bootu: oba sloty a min fallback, kazdy jedno cteni NVS. Vybrany
+ * obraz (nejvyssi seq) zustane v s_journal_image pro game_load_snapshot_from_nvs.
+ */
+static void game_snapshot_read_boot(void) {
+  if (s_boot_snapshot != BOOT_SNAPSHOT_UNREAD) {
+    return;
+  }
+  s_boot_snapshot = BOOT_SNAPSHOT_NONE;
+  uint32_t best_seq = 0;
+  for (int i = 0; i < 2; i++) {
+    game_snapshot_full_t img;
+    memset(&img, 0, sizeof(img));
+    size_t len = sizeof(img);
+    if (config_load_blob_from_nvs(s_slot_keys[i], &img, &len) != ESP_OK ||
+        !snapshot_full_valid(&img, len)) {
+      continue;
+    }
+    if (s_newest_slot < 0 || img.seq > best_seq) {
+      s_journal_image = img;
+      s_newest_slot = i;
+      best_seq = img.seq;
+      s_boot_snapshot = BOOT_SNAPSHOT_FULL;
     }
-    snapshot_loaded_on_boot = true;
-    snapshot_fallback_used = false;
-    game_active = (current_game_state != GAME_STATE_IDLE &&
-                   current_game_state != GAME_STATE_FINISHED);
-    return ESP_OK;
   }
 
   game_snapshot_min_t min = {0};
   size_t min_len = sizeof(min);
-  ret = config_load_blob_from_nvs(CONFIG_NVS_KEY_GAME_SNAPSHOT_MIN, &min, &min_len);
-  if (ret == ESP_OK && min_len == sizeof(min) && min.version == GAME_SNAPSHOT_VERSION &&
-      min.crc32 ==
-          game_crc32_simple(((const uint8_t *)&min) + 8, sizeof(min) - 8)) {
-    snapshot_restore_failed = false;
-    game_snapshot_apply_board(min.board);
-    current_player = (player_t)min.current_player;
-    current_game_state = (game_state_t)min.game_state;
-    move_count = min.move_count;
-    white_king_moved = min.white_king_moved;
-    white_rook_a_moved = min.white_rook_a_moved;
-    white_rook_h_moved = min.white_rook_h_moved;
-    black_king_moved = min.black_king_moved;
-    black_rook_a_moved = min.black_rook_a_moved;
-    black_rook_h_moved = min.black_rook_h_moved;
-    en_passant_available = min.en_passant_available;
-    en_passant_target_row = min.en_passant_target_row;
-    en_passant_target_col = min.en_passant_target_col;
-    en_passant_victim_row = min.en_passant_victim_row;
-    en_passant_victim_col = min.en_passant_victim_col;
-    promotion_state.pending = min.promotion_pending;
-    promotion_state.square_row = min.promotion_row;
-    promotion_state.square_col = min.promotion_col;
-    promotion_state.player = (player_t)min.promotion_player;
-    history_index = 0;
-    snapshot_loaded_on_boot = true;
-    snapshot_fallback_used = true;
-    game_active = (current_game_state != GAME_STATE_IDLE &&
-                   current_game_state != GAME_STATE_FINISHED);
-    return ESP_OK;
+  if (config_load_blob_from_nvs(CONFIG_NVS_KEY_GAME_SNAPSHOT_MIN, &min,
+                                &min_len) == ESP_OK &&
+      snapshot_min_valid(&min, min_len) &&
+      (s_boot_snapshot == BOOT_SNAPSHOT_NONE || min.seq > best_seq)) {
+    memset(&s_journal_image, 0, sizeof(s_journal_image));
+    memcpy(&s_journal_image, &min, sizeof(min));
+    best_seq = min.seq;
+    s_boot_snapshot = BOOT_SNAPSHOT_MIN;
   }
+  s_snapshot_seq = best_seq;
+  if (s_boot_snapshot != BOOT_SNAPSHOT_NONE) {
+    ESP_LOGI(TAG, "Snapshot seq %u (%s)", (unsigned)best_seq,
+             s_boot_snapshot == BOOT_SNAPSHOT_MIN ? "min"
+             : s_newest_slot == 0                 ? "slot A"
+                                                  : "slot B");
+  }
+}
 
+bool game_snapshot_nvs_has_valid(void) {
+  game_snapshot_read_boot();
+  return s_boot_snapshot != BOOT_SNAPSHOT_NONE;
+}
+
+static esp_err_t game_load_snapshot_from_nvs(void) {
+  game_snapshot_read_boot();
   snapshot_restore_failed = false;
-  return ESP_ERR_NOT_FOUND;
+  if (s_boot_snapshot == BOOT_SNAPSHOT_NONE) {
+    return ESP_ERR_NOT_FOUND;
+  }
+  game_snapshot_full_t *full = &s_journal_image;
+  bool fallback = (s_boot_snapshot == BOOT_SNAPSHOT_MIN);
+  if (!fallback) {
+    /* Checkpoint + tahy z journalu, ktere po nem prisly. */
+    uint32_t replayed = 0;
+    if (game_journal_replay(full->crc32, snapshot_delta_apply, full,
+                            &replayed) == ESP_OK &&
+        replayed > 0) {
+      ESP_LOGI(TAG, "Journal replay: %u record(s) on top of NVS checkpoint",
+               (unsigned)replayed);
+    }
+  }
+  game_snapshot_apply_board(full->board);
+  current_player = (player_t)full->current_player;
+  current_game_state = (game_state_t)full->game_state;
+  move_count = full->move_count;
+  white_king_moved = full->white_king_moved;
+  white_rook_a_moved = full->white_rook_a_moved;
+  white_rook_h_moved = full->white_rook_h_moved;
+  black_king_moved = full->black_king_moved;
+  black_rook_a_moved = full->black_rook_a_moved;
+  black_rook_h_moved = full->black_rook_h_moved;
+  en_passant_available = full->en_passant_available;
+  en_passant_target_row = full->en_passant_target_row;
+  en_passant_target_col = full->en_passant_target_col;
+  en_passant_victim_row = full->en_passant_victim_row;
+  en_passant_victim_col = full->en_passant_victim_col;
+  promotion_state.pending = full->promotion_pending;
+  promotion_state.square_row = full->promotion_row;
+  promotion_state.square_col = full->promotion_col;
+  promotion_state.player = (player_t)full->promotion_player;
+  if (!fallback) {
+    white_time_total = full->white_time_total;
+    black_time_total = full->black_time_total;
+  }
+  history_index = full->history_count; /* min: 0 */
+  if (history_index > 0) {
+    memcpy(move_history, full->history, sizeof(chess_move_t) * history_index);
+  }
+  snapshot_loaded_on_boot = true;
+  snapshot_fallback_used = fallback;
+  game_active = (current_game_state != GAME_STATE_IDLE &&
+                 current_game_state != GAME_STATE_FINISHED);
+  return ESP_OK;
 }
 
 static void game_boot_tracker_update_on_move(void) {
@@ -338,8 +577,12 @@ static void game_boot_tracker_update_on_move(void) {
   bool loaded =
       (config_load_blob_from_nvs(CONFIG_NVS_KEY_BOOT_TRACKER, &trk, &len) == ESP_OK &&
        len == sizeof(trk) && trk.version == GAME_SNAPSHOT_VERSION &&
-       trk.crc32 == game_crc32_simple(((const uint8_t *)&trk) + 8, sizeof(trk) - 8));
+       trk.crc32 == snapshot_crc32(&trk, sizeof(trk)));
 
+  if (loaded && trk.moved_since_boot == 1u) {
+    boot_tracker_moved_saved = true;
+    return;
+  }
   if (!loaded) {
     time_t now = time(NULL);
     trk.version = GAME_SNAPSHOT_VERSION;
@@ -347,8 +590,11 @@ static void game_boot_tracker_update_on_move(void) {
     trk.boot_counter_window = 1u;
   }
   trk.moved_since_boot = 1u;
-  trk.crc32 = game_crc32_simple(((const uint8_t *)&trk) + 8, sizeof(trk) - 8);
-  (void)config_save_blob_to_nvs(CONFIG_NVS_KEY_BOOT_TRACKER, &trk, sizeof(trk));
+  trk.crc32 = snapshot_crc32(&trk, sizeof(trk));
+  if (config_save_blob_to_nvs(CONFIG_NVS_KEY_BOOT_TRACKER, &trk, sizeof(trk)) ==
+      ESP_OK) {
+    boot_tracker_moved_saved = true;
+  }
 }
 
 static bool game_boot_tracker_should_force_new_game(void) {
@@ -361,7 +607,7 @@ static bool game_boot_tracker_should_force_new_game(void) {
   bool loaded =
       (config_load_blob_from_nvs(CONFIG_NVS_KEY_BOOT_TRACKER, &trk, &len) == ESP_OK &&
        len == sizeof(trk) && trk.version == GAME_SNAPSHOT_VERSION &&
-       trk.crc32 == game_crc32_simple(((const uint8_t *)&trk) + 8, sizeof(trk) - 8));
+       trk.crc32 == snapshot_crc32(&trk, sizeof(trk)));
 
   bool in_window = false;
   if (loaded) {
@@ -392,18 +638,71 @@ static bool game_boot_tracker_should_force_new_game(void) {
     next.first_boot_epoch_s = loaded ? trk.first_boot_epoch_s : 0u;
     next.boot_counter_window = 1u;
   }
-  next.crc32 = game_crc32_simple(((const uint8_t *)&next) + 8, sizeof(next) - 8);
+  next.crc32 = snapshot_crc32(&next, sizeof(next));
   (void)config_save_blob_to_nvs(CONFIG_NVS_KEY_BOOT_TRACKER, &next, sizeof(next));
 
   return force_new_game;
 }
 
-void game_snapshot_persist_after_valid_move(void) {
-  esp_err_t ret = game_save_snapshot_to_nvs();
+/** Checkpoint do NVS a nova epocha journalu navazana na nej. */
+static esp_err_t game_snapshot_checkpoint(const game_snapshot_full_t *full) {
+  game_journal_close_epoch();
+  s_journal_image = *full; /* bez otevrene epochy se nepouziva */
+  esp_err_t ret = game_save_snapshot_to_nvs(&s_journal_image);
+  if (ret != ESP_OK || snapshot_fallback_used) {
+    return ret; /* min snapshot nema historii — delty na nem nestavet */
+  }
+  if (game_journal_available()) {
+    (void)game_journal_begin_epoch(s_journal_image.crc32);
+  }
+  return ESP_OK;
+}
+
+static esp_err_t game_snapshot_persist(const game_snapshot_full_t *full) {
+  if (game_journal_epoch_open() &&
+      game_journal_records_in_epoch() < GAME_JOURNAL_CHECKPOINT_EVERY) {
+    uint8_t delta[GAME_JOURNAL_MAX_PAYLOAD];
+    size_t len = 0;
+    if (snapshot_delta_encode(&s_journal_image, full, delta, sizeof(delta),
+                              &len) &&
+        game_journal_append(delta, len) == ESP_OK) {
+      s_journal_image = *full;
+      snapshot_save_failed = false;
+      STAGING_LOGI(TAG, "journal: %u B delta", (unsigned)len);
+      return ESP_OK;
+    }
+  }
+  return game_snapshot_checkpoint(full);
+}
+
+/**
+ * config_persist_write_fn: journal/checkpoint + boot tracker v persist tasku.
+ * Slouceny pozadavek (vic tahu behem jednoho zapisu) delta casto nevyjadri
+ * → checkpoint, obraz je ale vzdy posledni stav.
+ */
+static esp_err_t game_snapshot_persist_job(const char *key, const void *data,
+                                           size_t len) {
+  (void)key;
+  if (len != sizeof(game_snapshot_full_t)) {
+    return ESP_ERR_INVALID_SIZE;
+  }
+  esp_err_t ret = game_snapshot_persist((const game_snapshot_full_t *)data);
   if (ret != ESP_OK) {
     ESP_LOGW(TAG, "Game snapshot save failed: %s", esp_err_to_name(ret));
   }
-  game_boot_tracker_update_on_move();
+  if (!boot_tracker_moved_saved) {
+    game_boot_tracker_update_on_move();
+  }
+  return ret;
+}
+
+void game_snapshot_persist_after_valid_move(void) {
+  /* Obraz stavu se bere tady (game_task); flash az v persist tasku. */
+  game_snapshot_full_t full;
+  game_snapshot_fill_full(&full);
+  (void)config_persist_submit(CONFIG_NVS_KEY_GAME_SNAPSHOT_FULL,
+                              game_snapshot_persist_job, &full, sizeof(full),
+                              CONFIG_PERSIST_PRIO_HIGH, NULL);
 }
 
 void game_snapshot_restore_on_boot(void) {
@@ -32,11 +32,12 @@
  * HLAVNI SMYCKA (100ms cyklus):
  * while (1) {
  *     1. Reset WDT
- *     2. Zpracuj prikazy z fronty (game_command_queue)
- *     3. Zpracuj matrix eventy (UP/DN signaly z fyzicke desky)
+ *     2. Zpracuj prikazy (matrix_game_ring, pak game_command_queue)
+ *     3. Zpracuj stav desky (setup, auto new game)
  *     4. Aktualizuj timer display
  *     5. Proved periodicke kontroly
- *     6. Cekej 100ms (vTaskDelayUntil)
+ *     6. Cekej do dalsiho 100ms terminu; notifikace z matrix ringu
+ *        mezitim spusti jen zpracovani prikazu
  * }
  *
  * ZPRACOVANI TAHU:
@@ -52,11 +53,12 @@
  *
  * FRONTY (QUEUES) - Prijem prikazu:
  * - game_command_queue -> Prikazy z UART/Web (move, reset, status...)
- * - matrix_event_queue -> UP/DN eventy z fyzicke desky
+ * - matrix_game_ring -> PICKUP/DROP/GUARD z fyzicke desky (SPSC, bez zamku)
  *
  * FRONTY (QUEUES) - Odeslani prikazu:
  * - response_queue -> Odpovedi na prikazy (status, board...)
- * - LED se ovladaji primymi volanimi (fronta byla odstranena)
+ * - LED se ovladaji primymi volanimi (fronta byla odstranena); pixely
+ *   z game tasku jdou pres SPSC ring do LED tasku (bez led_unified_mutex)
  *
  * MUTEXY - Ochrana sdilenych zdroju:
  * - game_mutex -> Ochrana stavu hry (board, current_player, move_count...)
@@ -158,6 +160,7 @@ xSemaphoreGive(...);
  */
 
 #include "game_task.h"
+#include "game_archive.h"
 #include "game_board_core.h"
 #include "game_matrix_guard.h"
 #include "game_snapshot.h"
@@ -179,6 +182,7 @@ xSemaphoreGive(...);
 // HA Light Task integration
 #include "../ha_light_task/include/ha_light_task.h"
 #include "../config_manager/include/config_manager.h"
+#include "../config_manager/include/config_registry.h"
 // Note: animation_task.h is not included to avoid type conflicts with
 // unified_animation_manager
 #include "esp_log.h"
@@ -1764,28 +1768,18 @@ void game_send_response_to_uart(const char *message, bool is_error,
     return;
   }
 
-  // Create simple response message
-  char response_message[256];
-  if (message) {
-    strncpy(response_message, message, sizeof(response_message) - 1);
-    response_message[sizeof(response_message) - 1] = '\0';
-  } else {
-    strcpy(response_message, is_error ? "Unknown error" : "Success");
-  }
-
-  // Send response to UART task as game_response_t
   game_response_t response = {
       .type = is_error ? GAME_RESPONSE_ERROR : GAME_RESPONSE_SUCCESS,
       .command_type = 0, // Will be set by caller if needed
       .error_code = is_error ? 1 : 0,
-      .message = "",
+      .text = game_payload_alloc_str(
+          message ? message : (is_error ? "Unknown error" : "Success")),
       .timestamp = esp_timer_get_time() / 1000};
-  strcpy(response.data, response_message);
 
   /* Bez game_mutex: odeslání do fronty jen kopíruje připravený řetězec; mutex by
    * mohl deadlocknout (game_task × HTTP GET držící mutex pro JSON) nebo zdvojit
    * nest-rekurzivní zámek. Čtení stavu pro UART je vždy přes předaný `message`. */
-  if (xQueueSend(response_queue, &response, pdMS_TO_TICKS(100)) != pdTRUE) {
+  if (!game_response_send(response_queue, &response, pdMS_TO_TICKS(100))) {
     ESP_LOGW(TAG,
              "Failed to send response to UART task (queue full or timeout)");
   } else {
@@ -2030,20 +2024,17 @@ void game_toggle_timer(bool enabled) {
 }
 
 /**
- * @brief Save current game to NVS
+ * @brief Save current game to the archive (game_archive.c)
  * @param game_name Name for the saved game
  */
 void game_save_game(const char *game_name) {
-  if (game_name == NULL || strlen(game_name) == 0) {
-    ESP_LOGE(TAG, "Invalid game name for save");
+  esp_err_t ret = game_archive_save_current(game_name, NULL);
+  if (ret != ESP_OK) {
+    ESP_LOGE(TAG, "Save '%s' failed: %s", game_name ? game_name : "",
+             esp_err_to_name(ret));
     return;
   }
 
-  // This is a placeholder - in a real implementation you would:
-  // 1. Save board state to NVS
-  // 2. Save move history to NVS
-  // 3. Save game statistics to NVS
-
   strncpy(saved_game_name, game_name, sizeof(saved_game_name) - 1);
   saved_game_name[sizeof(saved_game_name) - 1] = '\0';
   game_saved = true;
@@ -2052,22 +2043,17 @@ void game_save_game(const char *game_name) {
 }
 
 /**
- * @brief Load game from NVS
+ * @brief Load game from the archive (game_archive.c)
  * @param game_name Name of the game to load
  */
 void game_load_game(const char *game_name) {
-  if (game_name == NULL || strlen(game_name) == 0) {
-    ESP_LOGE(TAG, "Invalid game name for load");
+  esp_err_t ret = game_resume_archived_game(game_name);
+  if (ret != ESP_OK) {
+    ESP_LOGE(TAG, "Load '%s' failed: %s", game_name ? game_name : "",
+             esp_err_to_name(ret));
     return;
   }
-
-  // This is a placeholder - in a real implementation you would:
-  // 1. Load board state from NVS
-  // 2. Load move history from NVS
-  // 3. Load game statistics from NVS
-
-  ESP_LOGI(TAG, "📂 Loading game: %s", game_name);
-  ESP_LOGI(TAG, "⚠️  Game loading not yet implemented");
+  ESP_LOGI(TAG, "📂 Loaded game: %s", game_name);
 }
 
 /**
@@ -2081,54 +2067,20 @@ void game_export_pgn(char *pgn_buffer, size_t buffer_size) {
     return;
   }
 
-  // Start PGN with metadata
-  int pos = snprintf(pgn_buffer, buffer_size,
-                     "[Event \"ESP32 Chess Game\"]\n"
-                     "[Site \"ESP32-C6\"]\n"
-                     "[Date \"%s\"]\n"
-                     "[Round \"1\"]\n"
-                     "[White \"Player 1\"]\n"
-                     "[Black \"Player 2\"]\n"
-                     "[Result \"*\"]\n\n",
-                     "2025-01-01"); // TODO: Get actual date
-
-  // Add moves
-  for (uint32_t i = 0; i < history_index && pos < buffer_size - 50; i++) {
-    const chess_move_t *move = &move_history[i];
-    char from_square[4], to_square[4];
-    game_coords_to_square(move->from_row, move->from_col, from_square);
-    game_coords_to_square(move->to_row, move->to_col, to_square);
-
-    if (i % 2 == 0) {
-      // White move
-      pos += snprintf(pgn_buffer + pos, buffer_size - pos, "%" PRIu32 ". %s%s",
-                      (i / 2) + 1, from_square, to_square);
-    } else {
-      // Black move
-      pos += snprintf(pgn_buffer + pos, buffer_size - pos, " %s%s ",
-                      from_square, to_square);
-    }
-
-    // Add newline every 10 moves
-    if ((i + 1) % 20 == 0) {
-      pos += snprintf(pgn_buffer + pos, buffer_size - pos, "\n");
-    }
+  // Stejny zapis jako GET /api/history.pgn, jen do pevneho bufferu
+  json_writer_t w;
+  json_writer_init_buffer(&w, pgn_buffer, buffer_size);
+  esp_err_t ret = game_write_history_stream(&w, GAME_HISTORY_FORMAT_PGN, 0,
+                                            UINT32_MAX, NULL);
+  if (ret == ESP_OK) {
+    ret = json_writer_finish(&w);
   }
-
-  // Add result
-  if (game_result == GAME_STATE_FINISHED) {
-    if (strstr(saved_game_name, "CHECKMATE")) {
-      pos += snprintf(pgn_buffer + pos, buffer_size - pos, " 1-0");
-    } else if (strstr(saved_game_name, "STALEMATE")) {
-      pos += snprintf(pgn_buffer + pos, buffer_size - pos, " 1/2-1/2");
-    } else {
-      pos += snprintf(pgn_buffer + pos, buffer_size - pos, " 1/2-1/2");
-    }
-  } else {
-    pos += snprintf(pgn_buffer + pos, buffer_size - pos, " *");
+  if (ret != ESP_OK) {
+    ESP_LOGW(TAG, "PGN export truncated: %s", esp_err_to_name(ret));
   }
 
-  ESP_LOGI(TAG, "📄 PGN export completed (%d characters)", pos);
+  ESP_LOGI(TAG, "📄 PGN export completed (%zu characters)",
+           strlen(pgn_buffer));
 }
 
 /**
@@ -2163,6 +2115,24 @@ void game_print_status(void) {
   ESP_LOGI(TAG, "  Draws: %lu", draws);
 }
 
+/**
+ * @brief Zmena LED navadeni / hlidani pocatecni pozice v config_registry
+ *
+ * Bezi v tasku, ktery nastaveni zmenil (httpd, BLE, UART) — jen prepis
+ * promennych jako drive primo volane settery.
+ */
+static void game_config_changed(uint32_t changed, const config_snapshot_t *snap,
+                                void *ctx) {
+  (void)ctx;
+  if (changed & CONFIG_FIELD_LED_GUIDANCE) {
+    game_set_led_guidance_level(snap->system.led_guidance_level);
+  }
+  if (changed & CONFIG_FIELD_START_POS_CHECK) {
+    game_set_starting_position_check(
+        snap->system.starting_position_check_enabled);
+  }
+}
+
 // ============================================================================
 // MAIN TASK FUNCTION
 // ============================================================================
@@ -2209,17 +2179,21 @@ void game_task_start(void *pvParameters) {
              "Timer system initialization failed, continuing without timer");
   }
 
-  // Load configuration from NVS
-  system_config_t config;
-  esp_err_t config_ret = config_load_from_nvs(&config);
-  if (config_ret == ESP_OK) {
-    starting_position_check_enabled = config.starting_position_check_enabled;
-    ESP_LOGI(TAG, "Configuration loaded: starting_position_check=%s",
-             starting_position_check_enabled ? "ON" : "OFF");
-  } else {
-    ESP_LOGW(TAG, "Failed to load configuration, using defaults");
-    starting_position_check_enabled = false; // Default: disabled
+  // Konfigurace z RAM (config_registry); dalsi zmeny z webu/BLE/UART
+  // prijdou pres game_config_changed
+  config_snapshot_t config;
+  config_registry_get(&config);
+  starting_position_check_enabled =
+      config.system.starting_position_check_enabled;
+  game_set_led_guidance_level(config.system.led_guidance_level);
+  if (config_registry_subscribe(CONFIG_FIELD_LED_GUIDANCE |
+                                    CONFIG_FIELD_START_POS_CHECK,
+                                game_config_changed, NULL) != ESP_OK) {
+    ESP_LOGW(TAG, "Config listener not registered");
   }
+  ESP_LOGI(TAG, "Configuration: starting_position_check=%s led_guidance=%u",
+           starting_position_check_enabled ? "ON" : "OFF",
+           (unsigned)config.system.led_guidance_level);
 
   /*
    * Start logicke hry: vychozi deska, pak NVS nebo boot tracker.
@@ -2230,8 +2204,12 @@ void game_task_start(void *pvParameters) {
    * - Pri uspesnem nacteni snapshotu nastavi game_load_snapshot_from_nvs() i game_active.
    */
   game_initialize_board();
+  game_archive_init();
   game_snapshot_restore_on_boot();
 
+  // Matrix udalosti budi task notifikaci (viz cekani na konci smycky)
+  spsc_ring_set_consumer(&matrix_game_ring, xTaskGetCurrentTaskHandle());
+
   // Main task loop
   uint32_t loop_count = 0;
   TickType_t last_wake_time = xTaskGetTickCount();
@@ -2294,7 +2272,7 @@ void game_task_start(void *pvParameters) {
         chess_policy_highlight_movable_if_enabled();
         
         // Notify web
-        game_bump_revision_and_notify();
+        game_emit_simple_event(GAME_EVENT_GAME_STARTED);
         
         if (should_check_position) {
           ESP_LOGI(TAG, "✅ Board setup complete - game now ACTIVE, White to move");
@@ -2322,6 +2300,12 @@ void game_task_start(void *pvParameters) {
     // Zpracovat endgame report request (s dostatečným stackem 10KB)
     if (endgame_report_requested) {
       endgame_report_requested = false; // Reset flag
+      // Všechny konce (mat, pat, remízy, timeout, vzdání) nastaví request —
+      // timeout a vzdání předtím revizi vůbec nebumpovaly.
+      game_event_t ended = {.type = GAME_EVENT_GAME_ENDED};
+      ended.u.ended.result = (uint8_t)current_result_type;
+      ended.u.ended.reason = (uint8_t)current_endgame_reason;
+      game_emit_event(&ended);
       game_print_endgame_report_uart(current_result_type);
     }
 
@@ -2376,8 +2360,18 @@ void game_task_start(void *pvParameters) {
 
     loop_count++;
 
-    // Wait for next cycle (100ms)
-    vTaskDelayUntil(&last_wake_time, pdMS_TO_TICKS(100));
+    // Wait for next cycle (100ms). Notifikace z matrix_game_ring probudi
+    // task driv — zpracuji se jen prikazy, zbytek cyklu bezi dal po 100 ms.
+    TickType_t next_cycle = last_wake_time + pdMS_TO_TICKS(100);
+    for (;;) {
+      int32_t left = (int32_t)(next_cycle - xTaskGetTickCount());
+      if (left <= 0 || ulTaskNotifyTake(pdTRUE, (TickType_t)left) == 0) {
+        break;
+      }
+      game_task_wdt_reset_safe();
+      game_process_commands();
+    }
+    last_wake_time = next_cycle;
   }
 }
 
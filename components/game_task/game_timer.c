@@ -187,6 +187,30 @@ esp_err_t game_process_timer_command(const chess_move_command_t *cmd) {
     break;
   }
 
+  if (ret == ESP_OK) {
+    game_event_t ev = {.type = GAME_EVENT_SETTING_CHANGED};
+    switch (cmd->type) {
+    case GAME_CMD_SET_TIME_CONTROL:
+      ev.u.setting.key = GAME_SETTING_TIME_CONTROL;
+      ev.u.setting.value = (int32_t)timer_get_current_type();
+      break;
+    case GAME_CMD_PAUSE_TIMER:
+    case GAME_CMD_RESUME_TIMER:
+      ev.u.setting.key = GAME_SETTING_TIMER_PAUSED;
+      ev.u.setting.value = cmd->type == GAME_CMD_PAUSE_TIMER ? 1 : 0;
+      break;
+    case GAME_CMD_RESET_TIMER:
+      ev.u.setting.key = GAME_SETTING_TIMER_RESET;
+      break;
+    default:
+      ev.type = GAME_EVENT_NONE;
+      break;
+    }
+    if (ev.type != GAME_EVENT_NONE) {
+      game_emit_event(&ev);
+    }
+  }
+
   return ret;
 }
 
@@ -235,12 +259,30 @@ esp_err_t game_handle_time_expiration(void) {
   return ESP_OK;
 }
 
+/** CLOCK_TICK jednou za sekundu — web nemusí kvůli hodinám skládat snapshot. */
+#define GAME_CLOCK_TICK_PERIOD_MS 1000
+
 esp_err_t game_update_timer_display(void) {
   // Kontrola timeout
   if (timer_check_timeout()) {
     return game_handle_time_expiration();
   }
 
+  static uint32_t last_tick_ms;
+  uint32_t now_ms = (uint32_t)(esp_timer_get_time() / 1000);
+  if (timer_is_active() &&
+      now_ms - last_tick_ms >= GAME_CLOCK_TICK_PERIOD_MS) {
+    chess_timer_t t;
+    if (timer_get_state(&t) == ESP_OK) {
+      last_tick_ms = now_ms;
+      game_event_t ev = {.type = GAME_EVENT_CLOCK_TICK};
+      ev.u.clock.white_ms = t.white_time_ms;
+      ev.u.clock.black_ms = t.black_time_ms;
+      ev.u.clock.white_to_move = t.is_white_turn;
+      game_emit_event(&ev);
+    }
+  }
+
   return ESP_OK;
 }
 
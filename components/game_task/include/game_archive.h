@@ -0,0 +1,132 @@
+/**
+ * @file game_archive.h
+ * @brief Archiv ulozenych her na LittleFS oddilu `storage`.
+ *
+ * Dva soubory v /storage:
+ * - games.idx: hlavicka + zaznamy game_archive_entry_t serazene podle jmena.
+ *   Vypis stranky = seek + cteni par zaznamu, NVS ani boot se archivu netykaji.
+ * - games.<gen>.dat: append-only kompaktni zaznamy her (deska 32 B, priznaky,
+ *   3 B na pultah). Nacteni hry = jeden seek na offset z indexu.
+ *
+ * Prepsani / smazani jen posune index (misto v .dat je "garbage"); kdyz
+ * garbage presahne polovinu dat, archiv se zkompaktuje do nove generace
+ * .dat souboru a prepnuti udela atomicky rename indexu.
+ *
+ * Zapisy (SAVE, DELETE) bezi v persist tasku (config_persist.h); game_task
+ * jen vyplni zaznam. Oddil se mountuje az pri prvnim pouziti archivu.
+ */
+
+#ifndef GAME_ARCHIVE_H
+#define GAME_ARCHIVE_H
+
+#include "esp_err.h"
+#include "json_writer.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Label oddilu v partitions.csv (data, subtype littlefs). */
+#define GAME_ARCHIVE_PARTITION_LABEL "storage"
+/** Mount point LittleFS. */
+#define GAME_ARCHIVE_BASE_PATH "/storage"
+/** Max delka jmena hry vcetne \0 (pismena, cislice, '_', '-', '.'). */
+#define GAME_ARCHIVE_NAME_MAX 24
+/** Max pocet her v archivu. */
+#define GAME_ARCHIVE_MAX_GAMES 500
+/** Max her na jednu stranku vypisu (HTTP / BLE). */
+#define GAME_ARCHIVE_PAGE_MAX 20
+/** Stranka vypisu LIST_GAMES na UART. */
+#define GAME_ARCHIVE_UART_PAGE 10
+
+typedef enum {
+  GAME_ARCHIVE_RESULT_ONGOING = 0, ///< Rozehrana hra ("*")
+  GAME_ARCHIVE_RESULT_WHITE_WINS,  ///< "1-0"
+  GAME_ARCHIVE_RESULT_BLACK_WINS,  ///< "0-1"
+  GAME_ARCHIVE_RESULT_DRAW,        ///< "1/2-1/2"
+} game_archive_result_t;
+
+/** Zaznam indexu (40 B, na disku v tomto tvaru). */
+typedef struct __attribute__((packed)) {
+  char name[GAME_ARCHIVE_NAME_MAX]; ///< Doplneno \0
+  uint32_t saved_at;                ///< Unix cas ulozeni, 0 = bez SNTP
+  uint32_t offset;                  ///< Offset zaznamu v games.<gen>.dat
+  uint32_t length;                  ///< Delka zaznamu
+  uint16_t plies;                   ///< Pocet pultahu v zaznamu
+  uint8_t result;                   ///< game_archive_result_t
+  uint8_t reserved;
+} game_archive_entry_t;
+
+/** @brief Vytvori zamek archivu (game_task pri startu, bez mountu) */
+void game_archive_init(void);
+
+/** @brief Oddil existuje a LittleFS je pripojeny (pripoji pri prvnim volani) */
+bool game_archive_available(void);
+
+/** @brief Platne jmeno: 1..GAME_ARCHIVE_NAME_MAX-1 znaku [A-Za-z0-9_.-] */
+bool game_archive_name_valid(const char *name);
+
+/** @brief PGN zapis vysledku ("1-0", "0-1", "1/2-1/2", "*") */
+const char *game_archive_result_str(uint8_t result);
+
+/**
+ * @brief Stranka indexu (serazeno podle jmena)
+ * @param offset Poradi prvni hry
+ * @param[out] out Pole pro max `max` zaznamu
+ * @param[out] n_out Pocet vyplnenych zaznamu
+ * @param[out] total_out Pocet her v archivu (muze byt NULL)
+ * @return ESP_OK (i prazdny archiv), ESP_ERR_NOT_FOUND bez oddilu
+ */
+esp_err_t game_archive_list(uint32_t offset, game_archive_entry_t *out,
+                            uint32_t max, uint32_t *n_out,
+                            uint32_t *total_out);
+
+/**
+ * @brief Ulozi aktualni hru pod jmenem (jen game_task)
+ *
+ * Zaznam se vyplni hned, zapis na oddil probehne v persist tasku; stejne
+ * jmeno prepise starsi hru.
+ * @param[out] plies_out Pocet ulozenych pultahu (muze byt NULL)
+ */
+esp_err_t game_archive_save_current(const char *name, uint16_t *plies_out);
+
+/**
+ * @brief Nacte hru z archivu do stavu game_task (jen game_task)
+ *
+ * Nastavi desku, hrace, rosady, en passant, casy a historii. LED, timer,
+ * snapshot a udalost GAME_STARTED resi volajici.
+ * @return ESP_ERR_NOT_FOUND jmeno neexistuje, ESP_ERR_INVALID_CRC poskozeny
+ *         zaznam
+ */
+esp_err_t game_archive_load(const char *name);
+
+/** @brief Smaze hru z archivu (jen game_task; zapis v persist tasku) */
+esp_err_t game_archive_delete(const char *name);
+
+/** @brief Existuje hra s timto jmenem? (cte index, zadny zapis) */
+bool game_archive_exists(const char *name);
+
+/**
+ * @brief Pole stranky archivu do otevreneho JSON objektu
+ *
+ * "available", "total", "offset", "count", "next" (null na konci) a
+ * "games": [{"name","saved_at","result","plies"}].
+ * @param limit Orezano na 1..GAME_ARCHIVE_PAGE_MAX
+ */
+esp_err_t game_archive_write_list_fields(json_writer_t *w, uint32_t offset,
+                                         uint32_t limit);
+
+/**
+ * @brief Textova stranka pro UART (LIST_GAMES [strana])
+ * @param page Strana od 1 (po GAME_ARCHIVE_UART_PAGE hrach)
+ */
+esp_err_t game_archive_format_page(char *buf, size_t cap, uint32_t page);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* GAME_ARCHIVE_H */
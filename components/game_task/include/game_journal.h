@@ -0,0 +1,75 @@
+/**
+ * @file game_journal.h
+ * @brief Append-only journal tahu na vlastnim oddilu `journal` (write-ahead log).
+ *
+ * Misto prepisu celeho snapshotu v NVS po kazdem tahu se do flash pripise
+ * jen kratky zaznam (delta obrazu snapshotu). Checkpoint = plny snapshot v
+ * NVS + hlavicka nove epochy v journalu s CRC checkpointu. Boot: nacte
+ * checkpoint z NVS a prehraje zaznamy epochy, jejiz hlavicka k nemu sedi.
+ *
+ * Oddil je ring sektoru; zaznam nikdy nepresahuje sektor, pred vstupem do
+ * dalsiho sektoru se ten smaze. Torn write = spatne CRC → prehravani konci.
+ * Obsah zaznamu journal neinterpretuje (kodovani delty je v game_snapshot.c).
+ */
+
+#ifndef GAME_JOURNAL_H
+#define GAME_JOURNAL_H
+
+#include "esp_err.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/** Label oddilu v partitions.csv (data, subtype 0x40). */
+#define GAME_JOURNAL_PARTITION_LABEL "journal"
+/** Max payload jednoho zaznamu. */
+#define GAME_JOURNAL_MAX_PAYLOAD 240
+
+/**
+ * @brief Callback prehravani: jeden zaznam epochy
+ * @return ESP_OK = pokracovat, jinak prehravani konci (zaznam se nepocita)
+ */
+typedef esp_err_t (*game_journal_apply_fn)(void *ctx, const uint8_t *payload,
+                                           size_t len);
+
+/** @brief Oddil existuje a sken pri prvnim pouziti probehl */
+bool game_journal_available(void);
+
+/** @brief Epocha je otevrena — game_journal_append() lze volat */
+bool game_journal_epoch_open(void);
+
+/** @brief Pocet zaznamu od posledniho checkpointu */
+uint32_t game_journal_records_in_epoch(void);
+
+/**
+ * @brief Po uspesnem checkpointu: zacne novou epochu navazanou na checkpoint
+ * @param checkpoint_crc CRC ulozeneho checkpointu (game_snapshot_full_t.crc32)
+ */
+esp_err_t game_journal_begin_epoch(uint32_t checkpoint_crc);
+
+/**
+ * @brief Pripise zaznam do otevrene epochy
+ * @return ESP_ERR_INVALID_STATE bez epochy, ESP_ERR_NO_MEM kdyz by ring
+ *         prepsal hlavicku vlastni epochy (volajici udela checkpoint)
+ */
+esp_err_t game_journal_append(const uint8_t *payload, size_t len);
+
+/**
+ * @brief Zavre epochu (novy checkpoint je nutny pred dalsim append)
+ *
+ * Volat, kdyz se checkpoint v NVS zahodil (nova hra) nebo neulozil.
+ */
+void game_journal_close_epoch(void);
+
+/**
+ * @brief Prehraje posledni epochu, pokud jeji hlavicka odpovida checkpointu
+ *
+ * Epochu nechava zavrenou — prvni ulozeni po bootu dela checkpoint.
+ * @param[out] applied_out Pocet prehranych zaznamu (muze byt NULL)
+ * @return ESP_OK (i pri 0 zaznamech), ESP_ERR_NOT_FOUND kdyz epocha nesedi
+ */
+esp_err_t game_journal_replay(uint32_t checkpoint_crc,
+                              game_journal_apply_fn apply, void *ctx,
+                              uint32_t *applied_out);
+
+#endif /* GAME_JOURNAL_H */
@@ -8,8 +8,19 @@
 
 #include "chess_types.h"
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 
 game_state_t game_analyze_position(player_t player);
 bool game_execute_move_enhanced(chess_move_extended_t *move);
 
+/**
+ * Provede davku tahu (GAME_MOVE_BATCH_PACK) atomicky: prvni neplatny tah
+ * vrati stav hry pred davkou. Bez LED animaci po tahu; ulozeni snapshotu,
+ * udalost a prekresleni LED jednou za davku.
+ * @return MOVE_ERROR_NONE, jinak chyba tahu result->failed_index
+ */
+move_error_t game_execute_move_batch(const uint16_t *moves, size_t count,
+                                     game_move_batch_result_t *result);
+
 #endif /* GAME_MOVE_EXEC_H */
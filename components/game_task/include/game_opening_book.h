@@ -0,0 +1,74 @@
+/**
+ * @file game_opening_book.h
+ * @brief Binarni kniha zahajeni (Polyglot styl) zkompilovana z katalogu
+ *
+ * tools/build_opening_book.py pri buildu prehraje linie z
+ * data/openings_master.json a vygeneruje serazenou tabulku
+ * game_opening_book[] ve flash (rodata). Hledani podle Zobrist klice pozice je
+ * binarni, takze stejna pozice z ruznych linii (transpozice) najde vsechny
+ * knizni tahy. Zobrist tabulka je ve stejnem generovanem souboru.
+ *
+ * Klic i tah maji rozlozeni Polyglot (viz generator), klice ale nejsou
+ * zamenitelne s cizimi .bin knihami (vlastni Zobrist tabulka).
+ */
+
+#ifndef GAME_OPENING_BOOK_H
+#define GAME_OPENING_BOOK_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** 768 figur + 4 rosady + 8 sloupcu en passant + hrac na tahu */
+#define GAME_OPENING_BOOK_ZOBRIST_COUNT 781
+/** Max tahu, ktere vrati jeden dotaz (vic jich katalog v pozici nema) */
+#define GAME_OPENING_BOOK_MAX_MOVES 8
+
+/** Zaznam knihy (16 B jako Polyglot, ve flash v nativnim poradi bajtu). */
+typedef struct {
+  uint64_t key;    ///< Zobrist klic pozice pred tahem
+  uint16_t move;   ///< to_file | to_row<<3 | from_file<<6 | from_row<<9 | promo<<12
+  uint16_t weight; ///< Pocet linii katalogu s timto tahem
+  uint32_t learn;  ///< Rezerva (0)
+} game_opening_book_entry_t;
+
+/** Knizni tah pro volajiciho (rosada uz jako e1g1). */
+typedef struct {
+  char uci[6];
+  uint16_t weight;
+} game_opening_book_move_t;
+
+/** Vygenerovano build_opening_book.py (serazeno podle key, pak weight). */
+extern const game_opening_book_entry_t game_opening_book[];
+extern const size_t game_opening_book_count;
+extern const uint64_t game_opening_book_zobrist[GAME_OPENING_BOOK_ZOBRIST_COUNT];
+
+/**
+ * @brief Zobrist klic aktualni pozice game_task
+ *
+ * Cte board, hrace na tahu, rosady a en passant — volat z game_task nebo pod
+ * game_mutex.
+ */
+uint64_t game_opening_book_key(void);
+
+/**
+ * @brief Knizni tahy pro pozici, serazene od nejvyssi vahy
+ * @return Pocet zapsanych tahu (0 = pozice neni v knize)
+ */
+uint32_t game_opening_book_lookup(uint64_t key, game_opening_book_move_t *out,
+                                  uint32_t max);
+
+/** @brief Je tah from->to v pozici `key` knizni? (promena se neporovnava) */
+bool game_opening_book_has_move(uint64_t key, uint8_t from_row,
+                                uint8_t from_col, uint8_t to_row,
+                                uint8_t to_col);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* GAME_OPENING_BOOK_H */
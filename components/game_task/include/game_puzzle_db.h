@@ -0,0 +1,130 @@
+/**
+ * @file game_puzzle_db.h
+ * @brief Databaze uloh — binarni obraz s pasmy podle ratingu, cteni po jedne
+ *
+ * Obraz generuje tools/build_puzzle_db.py z data/puzzles_master.json (nebo z
+ * Lichess CSV). S CONFIG_CHESS_ASSETS_PARTITION lezi v oddilu assets jako
+ * /static/data/puzzles.bin a cte se primo z mapovane flash; bez oddilu je
+ * zkompilovany do aplikace (game_puzzle_db_builtin[]). V RAM je vzdy jen
+ * jedna dekodovana uloha (game_puzzle_t), nezavisle na velikosti databaze.
+ *
+ * Zaznamy jsou serazene podle ratingu; pasmo je souvisly usek, takze vyber
+ * podle ratingu je O(1) (s filtrem temat nejvys pruchod jednoho pasma).
+ * Format je popsany v generatoru.
+ */
+
+#ifndef GAME_PUZZLE_DB_H
+#define GAME_PUZZLE_DB_H
+
+#include "esp_err.h"
+#include "json_writer.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** "CMPZ" */
+#define GAME_PUZZLE_DB_MAGIC 0x5a504d43u
+#define GAME_PUZZLE_DB_VERSION 1
+/** Jmeno obrazu v oddilu assets */
+#define GAME_PUZZLE_DB_ASSET "/static/data/puzzles.bin"
+/** Max pultahu reseni (tahy resitele i soupere) */
+#define GAME_PUZZLE_MAX_PLIES 7
+#define GAME_PUZZLE_THEME_NAME_MAX 24
+/** FEN z packed pozice: 71 znaku rozmisteni + strana, rosady, ep, pocitadla */
+#define GAME_PUZZLE_FEN_MAX 96
+
+/** Tah v zaznamu: from | to<<6 | promo<<12 (pole a1 = 0, promo 1..4 = nbrq). */
+#define GAME_PUZZLE_MOVE_FROM(m) ((uint8_t)((m) & 0x3f))
+#define GAME_PUZZLE_MOVE_TO(m) ((uint8_t)(((m) >> 6) & 0x3f))
+#define GAME_PUZZLE_MOVE_PROMO(m) ((uint8_t)(((m) >> 12) & 0x7))
+
+typedef struct __attribute__((packed)) {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t record_size; ///< sizeof(game_puzzle_db_record_t)
+  uint32_t count;       ///< Pocet zaznamu (max 65535, ID = index + 1)
+  uint16_t rating_min;  ///< Dolni hranice pasma 0
+  uint16_t band_width;
+  uint16_t band_count;
+  uint16_t theme_count; ///< Max 32 (bit v masce zaznamu)
+  uint32_t bands_off;   ///< band_count x game_puzzle_db_band_t
+  uint32_t themes_off;  ///< theme_count x GAME_PUZZLE_THEME_NAME_MAX
+  uint32_t records_off;
+} game_puzzle_db_header_t;
+
+typedef struct __attribute__((packed)) {
+  uint32_t first; ///< Index prvniho zaznamu pasma
+  uint32_t count;
+} game_puzzle_db_band_t;
+
+typedef struct __attribute__((packed)) {
+  uint64_t occupancy; ///< Bit = obsazene pole (a1 = bit 0)
+  uint8_t pieces[16]; ///< 4 b na obsazene pole: 1..6 = PNBRQK, +8 cerna
+  uint16_t rating;
+  uint8_t flags;   ///< bit0 cerny na tahu, bity 1-4 rosady KQkq
+  uint8_t ep_file; ///< 0 = bez en passant, jinak sloupec + 1
+  uint32_t themes; ///< Bitova maska temat
+  uint8_t plies;
+  uint8_t reserved;
+  uint16_t moves[GAME_PUZZLE_MAX_PLIES];
+} game_puzzle_db_record_t;
+
+/** Jedna dekodovana uloha (v RAM vzdy jen jedna). */
+typedef struct {
+  uint16_t id; ///< 1..count
+  uint16_t rating;
+  uint32_t themes;
+  uint8_t plies;
+  uint8_t flags;
+  uint8_t ep_file;
+  uint16_t moves[GAME_PUZZLE_MAX_PLIES];
+  char fen[GAME_PUZZLE_FEN_MAX];
+} game_puzzle_t;
+
+/** Vestavena databaze (jen build bez CONFIG_CHESS_ASSETS_PARTITION). */
+extern const uint8_t game_puzzle_db_builtin[];
+extern const size_t game_puzzle_db_builtin_size;
+
+/** @brief Je databaze k dispozici (platna hlavicka)? */
+bool game_puzzle_db_available(void);
+
+/** @brief Pocet uloh (0 bez databaze) */
+uint32_t game_puzzle_db_count(void);
+
+/**
+ * @brief Dekoduje ulohu `id` (1..count) do `out`
+ * @return false = neplatne ID nebo poskozeny zaznam
+ */
+bool game_puzzle_db_load(uint16_t id, game_puzzle_t *out);
+
+/**
+ * @brief Nahodna uloha z pasma nejblizsiho `rating`
+ *
+ * Prazdne pasmo nebo pasmo bez uloh s tematy `theme_mask` (0 = libovolne) se
+ * preskoci na nejblizsi sousedni. `exclude_id` se vybere jen kdyz je jedina.
+ * @return ID ulohy, 0 = zadna neodpovida
+ */
+uint16_t game_puzzle_db_select(uint16_t rating, uint32_t theme_mask,
+                               uint16_t exclude_id);
+
+/** @brief Bit tematu podle jmena (0 = nezname) */
+uint32_t game_puzzle_db_theme_mask(const char *name);
+
+/** @brief Pole jmen temat z masky (json_writer key uz zapsany volajicim) */
+void game_puzzle_db_write_themes(json_writer_t *w, uint32_t mask);
+
+/**
+ * @brief Souhrn pro GET /api/puzzles: available, count, pasma, temata
+ * @return ESP_OK nebo chyba json_writer
+ */
+esp_err_t game_puzzle_db_write_info_fields(json_writer_t *w);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* GAME_PUZZLE_DB_H */
@@ -15,7 +15,10 @@ void game_snapshot_erase_nvs(void);
 /** Clear save/restore failure flags after starting a fresh game. */
 void game_snapshot_reset_failure_flags(void);
 
-/** True if NVS holds a full or minimal snapshot with valid CRC. */
+/**
+ * True if NVS holds a valid A/B slot or minimal snapshot. Both slots are read
+ * once on first call; the newest one is kept for the boot restore.
+ */
 bool game_snapshot_nvs_has_valid(void);
 
 /**
@@ -24,7 +27,7 @@ bool game_snapshot_nvs_has_valid(void);
  */
 void game_snapshot_restore_on_boot(void);
 
-/** Save snapshot to NVS and update boot tracker after a valid move. */
+/** Queue snapshot (journal delta or A/B checkpoint) + boot tracker after a valid move. */
 void game_snapshot_persist_after_valid_move(void);
 
 bool game_was_snapshot_loaded_on_boot(void);
@@ -48,6 +48,7 @@
 
 // Spolecne typy jsou definovany v chess_types.h
 #include "chess_types.h"
+#include "json_writer.h"
 
 // Struktury chess_move_t a move_suggestion_t jsou definovany v chess_types.h
 
@@ -118,6 +119,18 @@ uint32_t game_get_move_count(void);
  */
 esp_err_t game_get_status_json(char *buffer, size_t size);
 
+/**
+ * @brief Exportuj snapshot hry v kompaktnim binarnim formatu (snapshot_bin.h)
+ *
+ * @param[out] buffer Vystupni buffer (SNAPSHOT_BIN_MAX_SIZE staci na celou historii)
+ * @param size Velikost bufferu
+ * @param max_moves Max tahu od konce historie (0 = vsechny)
+ * @param[out] out_len Delka zakodovanych dat
+ * @return ESP_OK pri uspechu, ESP_ERR_NO_MEM pri malem bufferu
+ */
+esp_err_t game_get_snapshot_bin(uint8_t *buffer, size_t size,
+                                uint16_t max_moves, size_t *out_len);
+
 /**
  * @brief Vynuceny refresh LED podle stavu hry (highlight, sach, chyby, promoce).
  * @details Volat po navratu z HA, po fade-out bootu pri obnove NVS (main), apod.
@@ -133,6 +146,51 @@ void game_refresh_leds(void);
  */
 esp_err_t game_get_history_json(char *buffer, size_t size);
 
+/**
+ * @brief Streamovane exporty pres json_writer_t (HTTP chunk, heap, buffer)
+ *
+ * game_write_board_fields / game_write_status_fields zapisuji jen cleny do
+ * uz otevreneho objektu (volajici muze pridat vlastni pole). Ostatni zapisuji
+ * cely objekt. Funkce berou game_mutex samy a board/status/captured/advantage
+ * pod nim i zapisuji — pro ne pouzit buffer nebo heap writer, ne sitovy sink.
+ * Historie se pod mutexem jen kopiruje, lze ji streamovat primo do HTTP.
+ *
+ * @return ESP_OK, ESP_ERR_TIMEOUT (mutex) nebo chyba writeru
+ */
+esp_err_t game_write_board_fields(json_writer_t *w);
+esp_err_t game_write_status_fields(json_writer_t *w);
+esp_err_t game_write_history_json(json_writer_t *w);
+esp_err_t game_write_captured_json(json_writer_t *w);
+esp_err_t game_write_advantage_json(json_writer_t *w);
+
+/** @brief Format streamovaneho exportu historie */
+typedef enum {
+  GAME_HISTORY_FORMAT_JSONL = 0, ///< Jeden tah = jeden JSON radek
+  GAME_HISTORY_FORMAT_PGN,       ///< PGN (tagy + tahy v koordinatni notaci)
+} game_history_format_t;
+
+/**
+ * @brief Pocet tahu v historii (pro Range / kurzor pred zacatkem streamu)
+ */
+uint32_t game_get_history_length(void);
+
+/**
+ * @brief Streamovany export pultahu [start, end) historie
+ *
+ * Tahy se kopiruji pod game_mutex po malych davkach a zapisuji po uvolneni,
+ * pamet tedy nezavisi na delce partie a sink muze cekat na sit. `end` se
+ * prubezne orizne na aktualni delku (undo behem streamu). PGN od `start > 0`
+ * je pokracovani: bez tagu, prvni tah cerneho jako "N...". Vysledek hry se
+ * pripoji jen pokud stream dojde na konec historie.
+ *
+ * @param end UINT32_MAX = do konce
+ * @param[out] next_out Prvni nezapsany pultah (kurzor dalsiho dotazu), muze byt NULL
+ * @return ESP_OK, ESP_ERR_TIMEOUT (mutex) nebo chyba writeru
+ */
+esp_err_t game_write_history_stream(json_writer_t *w,
+                                    game_history_format_t fmt, uint32_t start,
+                                    uint32_t end, uint32_t *next_out);
+
 /**
  * @brief Exportuj sebrane figurky do JSON retezce
  *
@@ -456,10 +514,14 @@ bool game_is_board_setup_tutorial_active(void);
 bool game_is_physical_board_starting_occupancy(void);
 /** Ukončí tutoriál a spustí novou hru jen pokud fyzická pozice sedí. */
 bool game_finish_board_setup_tutorial_from_web(void);
-bool game_puzzle_start(uint8_t puzzle_id);
+/**
+ * Úloha z databáze (game_puzzle_db.h), ID 1..game_puzzle_db_count().
+ * Řešení může mít víc půltahů; tahy soupeře hráč přehraje na desce podle LED.
+ */
+bool game_puzzle_start(uint16_t puzzle_id);
 void game_puzzle_cancel(void);
 bool game_is_puzzle_active(void);
-bool game_puzzle_enter_setup(uint8_t puzzle_id);
+bool game_puzzle_enter_setup(uint16_t puzzle_id);
 bool game_is_puzzle_setup_active(void);
 
 /** Compare reed matrix occupancy (0/1) to FEN piece placement. */
@@ -480,6 +542,7 @@ bool game_opening_load_config(const char *line_id, const char *start_fen,
                               uint8_t player_side_white,
                               uint8_t opponent_mode);
 bool game_opening_start(void);
+/** @brief Napoveda linie; mimo trenink nejcastejsi knizni tah pozice (LED). */
 bool game_opening_hint(void);
 bool game_opening_checkpoint_ack(void);
 bool game_opening_awaiting_opponent_physical(void);
@@ -499,7 +562,8 @@ bool game_opening_validate_checkpoint_physical(void);
 bool game_opening_status_needs_matrix(void);
 const char *game_opening_feedback_key(void);
 const char *game_opening_opponent_mode_key(void);
-void game_opening_export_status_json(char *buf, size_t buf_size, size_t *offset);
+/** @brief Prida "opening_training" do otevreneho status objektu (pod game_mutex). */
+void game_opening_write_status_fields(json_writer_t *w);
 
 /**
  * @brief Matrix guard: aktivni pauza pri nesouladu matice s logickou deskou.
@@ -11,6 +11,9 @@
 #include "freertos/queue.h"
 #include "freertos/semphr.h"
 #include "freertos/timers.h"
+#include "game_event_bus.h"
+#include "game_payload.h"
+#include "game_puzzle_db.h"
 #include "game_task.h"
 #include <stdbool.h>
 #include <stdint.h>
@@ -186,6 +189,15 @@ extern uint8_t last_move_to_col;
 
 void game_check_promotion_needed(void);
 
+/**
+ * Zveřejní událost na game_event_bus (jen z game_task kontextu): u typů, které
+ * mění snapshot, bumpne revizi a probudí odběratele přes
+ * czechmate_on_game_state_changed(); doplní revision + timestamp_ms.
+ */
+void game_emit_event(game_event_t *ev);
+/** Událost bez payloadu (GAME_STARTED, STATE_CHANGED, …). */
+void game_emit_simple_event(game_event_type_t type);
+/** Obecná změna stavu = GAME_EVENT_STATE_CHANGED (guard, čekání na desku). */
 void game_bump_revision_and_notify(void);
 
 bool game_is_board_in_starting_position(void);
@@ -235,33 +247,34 @@ typedef enum {
   PUZZLE_FEEDBACK_NONE = 0,
   PUZZLE_FEEDBACK_WRONG = 1,
   PUZZLE_FEEDBACK_SOLVED = 2,
-  PUZZLE_FEEDBACK_ILLEGAL = 3
+  PUZZLE_FEEDBACK_ILLEGAL = 3,
+  PUZZLE_FEEDBACK_CORRECT = 4,       ///< Spravny pultah, reseni pokracuje
+  PUZZLE_FEEDBACK_OPPONENT_TURN = 5, ///< Hrac prehraje tah soupere podle LED
+  PUZZLE_FEEDBACK_INVALID = 6        ///< Tah reseni neprosel generatorem tahu
 } puzzle_feedback_t;
 
-typedef struct {
-  uint8_t id;
-  uint8_t difficulty;
-  const char *title;
-  const char *teaser;
-  const char *fen;
-  const char *solution_from;
-  const char *solution_to;
-} game_puzzle_definition_t;
-
 extern bool puzzle_setup_active;
-extern uint8_t puzzle_setup_id;
+extern uint16_t puzzle_setup_id;
 extern bool board_setup_tutorial_active;
 extern uint32_t game_start_time;
 
 void game_apply_empty_logical_board_after_full_reset(void);
 
-const game_puzzle_definition_t *game_get_puzzle_definition(uint8_t puzzle_id);
+/** Nactena uloha (setup nebo aktivni), NULL bez ulohy. */
+const game_puzzle_t *game_puzzle_current(void);
+/** Index ocekavaneho pultahu reseni (0 = prvni tah resitele). */
+uint8_t game_puzzle_current_ply(void);
+/** GAME_CMD_PUZZLE: cancel / start / prepare, ID 0 = vyber podle ratingu. */
+void game_process_puzzle_command(const chess_move_command_t *cmd);
+/** Po provedenem spravnem pultahu: dalsi pultah nebo vyreseno. */
+void game_puzzle_advance_after_move(void);
 bool game_puzzle_physical_matches_fen(const char *fen);
 const char *game_puzzle_feedback_key(void);
 const char *game_puzzle_feedback_message(void);
 
 extern bool puzzle_active;
-extern uint8_t puzzle_active_id;
+extern uint16_t puzzle_active_id;
+/** Ocekavany pultah (tah resitele i soupere). */
 extern uint8_t puzzle_solution_from_row;
 extern uint8_t puzzle_solution_from_col;
 extern uint8_t puzzle_solution_to_row;
@@ -301,6 +314,9 @@ void game_process_endgame_white_command(const chess_move_command_t *cmd);
 void game_process_endgame_black_command(const chess_move_command_t *cmd);
 void game_process_list_games_command(const chess_move_command_t *cmd);
 void game_process_delete_game_command(const chess_move_command_t *cmd);
+void game_process_move_batch_command(const chess_move_command_t *cmd);
+/** LOAD z archivu + timer, LED, snapshot a GAME_STARTED (jen game_task). */
+esp_err_t game_resume_archived_game(const char *name);
 void game_process_promotion_command(const chess_move_command_t *cmd);
 void game_update_promotion_anchor_led(void);
 
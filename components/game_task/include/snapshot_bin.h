@@ -0,0 +1,157 @@
+/**
+ * @file snapshot_bin.h
+ * @brief Kompaktni binarni snapshot hry (BLE / pomale linky)
+ *
+ * Cisty C kodek bez ESP-IDF zavislosti — stejny zdroj se preklada ve firmware
+ * (game_task) i na hostu (tools/snapshot_bin) pro round-trip testy.
+ *
+ * @author Alfred Krutina
+ * @version 1.8.0
+ * @date 2026-10-18
+ *
+ * @details
+ * Format (vse little-endian, uvarint = LEB128):
+ *
+ *   'C' 'B' ver(u8) state_version(uvarint) timestamp_ms(uvarint)
+ *   { type(u8) len(uvarint) payload[len] } ...
+ *
+ * Sekce (TLV), neznamy typ dekoder preskoci:
+ * - BOARD (1):    32 B, dve pole na bajt (nizsi nibble = sudy index), hodnota piece_t
+ * - MOVES (2):    total(uvarint) first(uvarint) n(uvarint), pak n x
+ *                 u16 from6|to6<<6|piece4<<12, u8 captured4|kind4<<4,
+ *                 zigzag varint rozdilu timestamp proti predchozimu tahu
+ * - STATUS (3):   u32 bitfield (SNAPSHOT_BIN_ST_*), move_count(uvarint),
+ *                 [lifted_sq u8 lifted_piece u8], [castling_from u8 castling_to u8]
+ * - CLOCK (4):    flags u8 (SNAPSHOT_BIN_CLK_*), type u8, white/black/initial/
+ *                 increment ms (uvarint)
+ * - CAPTURED (5): nw u8, nb u8, nibble-packed figurky (bile sebrane, pak cerne)
+ *
+ * Pole = row*8+col (stejna orientace jako `board` v JSON snapshotu).
+ */
+
+#ifndef SNAPSHOT_BIN_H
+#define SNAPSHOT_BIN_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SNAPSHOT_BIN_MAGIC0 'C'
+#define SNAPSHOT_BIN_MAGIC1 'B'
+#define SNAPSHOT_BIN_VERSION 1
+
+/** Content-Type / Accept pro GET /api/game/snapshot. */
+#define SNAPSHOT_BIN_MIME "application/vnd.czechmate.snapshot"
+
+/** Max tahu v jednom snapshotu (= GAME_TASK_MAX_MOVES_HISTORY). */
+#define SNAPSHOT_BIN_MAX_MOVES 200
+/** Max sebranych figurek na stranu (= GAME_TASK_MAX_CAPTURED_PIECES). */
+#define SNAPSHOT_BIN_MAX_CAPTURED 16
+
+/** Horni mez zakodovane delky (vsechny tahy, vsechny sekce). */
+#define SNAPSHOT_BIN_MAX_SIZE (128 + SNAPSHOT_BIN_MAX_MOVES * 8 + 64)
+
+/** Konec historie pro BLE — cely snapshot ~220 B = 1 notify pri MTU 247. */
+#define SNAPSHOT_BIN_BLE_MAX_MOVES 20
+#define SNAPSHOT_BIN_BLE_MAX_SIZE (128 + SNAPSHOT_BIN_BLE_MAX_MOVES * 8 + 64)
+
+typedef enum {
+  SNAPSHOT_BIN_TLV_BOARD = 1,
+  SNAPSHOT_BIN_TLV_MOVES = 2,
+  SNAPSHOT_BIN_TLV_STATUS = 3,
+  SNAPSHOT_BIN_TLV_CLOCK = 4,
+  SNAPSHOT_BIN_TLV_CAPTURED = 5,
+} snapshot_bin_tlv_t;
+
+/* STATUS bitfield: bity 0-3 game_state_t, 4 hrac na tahu (1 = cerny), dale priznaky. */
+#define SNAPSHOT_BIN_ST_STATE_MASK 0x0000000FU
+#define SNAPSHOT_BIN_ST_BLACK_TO_MOVE (1U << 4)
+#define SNAPSHOT_BIN_ST_IN_CHECK (1U << 5)
+#define SNAPSHOT_BIN_ST_CHECKMATE (1U << 6)
+#define SNAPSHOT_BIN_ST_STALEMATE (1U << 7)
+#define SNAPSHOT_BIN_ST_PIECE_LIFTED (1U << 8)
+#define SNAPSHOT_BIN_ST_CASTLING (1U << 9)
+#define SNAPSHOT_BIN_ST_ERROR_RECOVERY (1U << 10)
+/* Bity 12-14 game_result_type_t, 16-20 endgame_reason_t (platne pri FINISHED). */
+#define SNAPSHOT_BIN_ST_RESULT_SHIFT 12
+#define SNAPSHOT_BIN_ST_RESULT_MASK (0x7U << SNAPSHOT_BIN_ST_RESULT_SHIFT)
+#define SNAPSHOT_BIN_ST_REASON_SHIFT 16
+#define SNAPSHOT_BIN_ST_REASON_MASK (0x1FU << SNAPSHOT_BIN_ST_REASON_SHIFT)
+
+/* CLOCK flags. */
+#define SNAPSHOT_BIN_CLK_RUNNING (1U << 0)
+#define SNAPSHOT_BIN_CLK_WHITE_TURN (1U << 1)
+#define SNAPSHOT_BIN_CLK_PAUSED (1U << 2)
+#define SNAPSHOT_BIN_CLK_EXPIRED (1U << 3)
+
+typedef struct {
+  uint8_t from;       ///< Zdrojove pole 0-63
+  uint8_t to;         ///< Cilove pole 0-63
+  uint8_t piece;      ///< piece_t (0-12)
+  uint8_t captured;   ///< piece_t sebrane figurky
+  uint8_t kind;       ///< move_type_t (0-5)
+  uint32_t timestamp; ///< chess_move_t.timestamp
+} snapshot_bin_move_t;
+
+/** Dekodovany / ke kodovani pripraveny stav (~2.5 KiB — nedavat na maly stack). */
+typedef struct {
+  uint32_t state_version;
+  uint64_t timestamp_ms;
+
+  uint8_t board[64]; ///< piece_t na poli row*8+col
+
+  uint32_t move_total; ///< Pocet tahu v historii hry
+  uint32_t move_first; ///< Index prvniho tahu v `moves` (konec historie)
+  uint16_t move_n;     ///< Platnych polozek v `moves`
+  snapshot_bin_move_t moves[SNAPSHOT_BIN_MAX_MOVES];
+
+  uint32_t status_bits; ///< SNAPSHOT_BIN_ST_*
+  uint32_t move_count;
+  uint8_t lifted_sq;
+  uint8_t lifted_piece;
+  uint8_t castling_from;
+  uint8_t castling_to;
+
+  bool has_clock;
+  uint8_t clock_flags; ///< SNAPSHOT_BIN_CLK_*
+  uint8_t clock_type;  ///< time_control_type_t
+  uint32_t white_time_ms;
+  uint32_t black_time_ms;
+  uint32_t initial_time_ms;
+  uint32_t increment_ms;
+
+  uint8_t white_captured_n;
+  uint8_t black_captured_n;
+  uint8_t white_captured[SNAPSHOT_BIN_MAX_CAPTURED];
+  uint8_t black_captured[SNAPSHOT_BIN_MAX_CAPTURED];
+} snapshot_bin_state_t;
+
+/**
+ * @brief Zakoduje stav do `buf`.
+ * @return false pri nevalidnim stavu nebo malem bufferu (`*out_len` pak 0)
+ */
+bool snapshot_bin_encode(const snapshot_bin_state_t *st, uint8_t *buf,
+                         size_t cap, size_t *out_len);
+
+/**
+ * @brief Dekoduje `buf` do `st` (chybejici sekce zustanou vynulovane).
+ * @return false pri spatnem magicu/verzi nebo poskozenych datech
+ */
+bool snapshot_bin_decode(const uint8_t *buf, size_t len,
+                         snapshot_bin_state_t *st);
+
+/**
+ * @brief Precte jen state_version z hlavicky (ETag, ack) bez plneho dekodovani.
+ */
+bool snapshot_bin_peek_version(const uint8_t *buf, size_t len,
+                               uint32_t *state_version);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SNAPSHOT_BIN_H */
@@ -0,0 +1,372 @@
+/**
+ * @file snapshot_bin.c
+ * @brief Kodek kompaktniho binarniho snapshotu (format viz snapshot_bin.h).
+ *
+ * Bez ESP-IDF — preklada se i v tools/snapshot_bin pro host round-trip.
+ */
+
+#include "snapshot_bin.h"
+
+#include <string.h>
+
+typedef struct {
+  uint8_t *buf;
+  size_t cap;
+  size_t pos;
+  bool ok;
+} sb_writer_t;
+
+typedef struct {
+  const uint8_t *buf;
+  size_t len;
+  size_t pos;
+  bool ok;
+} sb_reader_t;
+
+// ============================================================================
+// ZAPIS
+// ============================================================================
+
+static void sb_put(sb_writer_t *w, uint8_t b) {
+  if (!w->ok || w->pos >= w->cap) {
+    w->ok = false;
+    return;
+  }
+  w->buf[w->pos++] = b;
+}
+
+static void sb_put_uvarint(sb_writer_t *w, uint64_t v) {
+  while (v >= 0x80U) {
+    sb_put(w, (uint8_t)(v | 0x80U));
+    v >>= 7;
+  }
+  sb_put(w, (uint8_t)v);
+}
+
+static void sb_put_svarint(sb_writer_t *w, int64_t v) {
+  sb_put_uvarint(w, ((uint64_t)v << 1) ^ (uint64_t)(v >> 63));
+}
+
+static size_t sb_uvarint_len(uint64_t v) {
+  size_t n = 1;
+  while (v >= 0x80U) {
+    v >>= 7;
+    n++;
+  }
+  return n;
+}
+
+/** Zacatek TLV: typ + rezervovany 1 B delky (sekce > 127 B se posunou). */
+static size_t sb_tlv_begin(sb_writer_t *w, uint8_t type) {
+  sb_put(w, type);
+  sb_put(w, 0);
+  return w->pos;
+}
+
+static void sb_tlv_end(sb_writer_t *w, size_t start) {
+  if (!w->ok) {
+    return;
+  }
+  size_t plen = w->pos - start;
+  size_t vlen = sb_uvarint_len(plen);
+  if (vlen > 1) {
+    if (w->pos + vlen - 1 > w->cap) {
+      w->ok = false;
+      return;
+    }
+    memmove(w->buf + start + vlen - 1, w->buf + start, plen);
+    w->pos += vlen - 1;
+  }
+  size_t p = start - 1;
+  for (size_t i = 0; i < vlen; i++) {
+    uint8_t b = (uint8_t)(plen & 0x7FU);
+    plen >>= 7;
+    w->buf[p++] = (uint8_t)(b | (i + 1 < vlen ? 0x80U : 0U));
+  }
+}
+
+static void sb_put_nibbles(sb_writer_t *w, const uint8_t *v, size_t n) {
+  for (size_t i = 0; i < n; i += 2) {
+    uint8_t lo = v[i] & 0x0FU;
+    uint8_t hi = (i + 1 < n) ? (uint8_t)(v[i + 1] & 0x0FU) : 0U;
+    sb_put(w, (uint8_t)(lo | (hi << 4)));
+  }
+}
+
+bool snapshot_bin_encode(const snapshot_bin_state_t *st, uint8_t *buf,
+                         size_t cap, size_t *out_len) {
+  if (out_len != NULL) {
+    *out_len = 0;
+  }
+  if (st == NULL || buf == NULL || out_len == NULL ||
+      st->move_n > SNAPSHOT_BIN_MAX_MOVES ||
+      st->white_captured_n > SNAPSHOT_BIN_MAX_CAPTURED ||
+      st->black_captured_n > SNAPSHOT_BIN_MAX_CAPTURED) {
+    return false;
+  }
+  for (int i = 0; i < 64; i++) {
+    if (st->board[i] > 0x0FU) {
+      return false;
+    }
+  }
+
+  sb_writer_t w = {.buf = buf, .cap = cap, .pos = 0, .ok = true};
+  sb_put(&w, SNAPSHOT_BIN_MAGIC0);
+  sb_put(&w, SNAPSHOT_BIN_MAGIC1);
+  sb_put(&w, SNAPSHOT_BIN_VERSION);
+  sb_put_uvarint(&w, st->state_version);
+  sb_put_uvarint(&w, st->timestamp_ms);
+
+  size_t s = sb_tlv_begin(&w, SNAPSHOT_BIN_TLV_BOARD);
+  sb_put_nibbles(&w, st->board, 64);
+  sb_tlv_end(&w, s);
+
+  s = sb_tlv_begin(&w, SNAPSHOT_BIN_TLV_STATUS);
+  uint32_t bits = st->status_bits;
+  for (int i = 0; i < 4; i++) {
+    sb_put(&w, (uint8_t)(bits >> (8 * i)));
+  }
+  sb_put_uvarint(&w, st->move_count);
+  if (bits & SNAPSHOT_BIN_ST_PIECE_LIFTED) {
+    sb_put(&w, st->lifted_sq);
+    sb_put(&w, st->lifted_piece);
+  }
+  if (bits & SNAPSHOT_BIN_ST_CASTLING) {
+    sb_put(&w, st->castling_from);
+    sb_put(&w, st->castling_to);
+  }
+  sb_tlv_end(&w, s);
+
+  if (st->has_clock) {
+    s = sb_tlv_begin(&w, SNAPSHOT_BIN_TLV_CLOCK);
+    sb_put(&w, st->clock_flags);
+    sb_put(&w, st->clock_type);
+    sb_put_uvarint(&w, st->white_time_ms);
+    sb_put_uvarint(&w, st->black_time_ms);
+    sb_put_uvarint(&w, st->initial_time_ms);
+    sb_put_uvarint(&w, st->increment_ms);
+    sb_tlv_end(&w, s);
+  }
+
+  if (st->white_captured_n != 0 || st->black_captured_n != 0) {
+    uint8_t all[2 * SNAPSHOT_BIN_MAX_CAPTURED];
+    size_t n = 0;
+    memcpy(all, st->white_captured, st->white_captured_n);
+    n += st->white_captured_n;
+    memcpy(all + n, st->black_captured, st->black_captured_n);
+    n += st->black_captured_n;
+    s = sb_tlv_begin(&w, SNAPSHOT_BIN_TLV_CAPTURED);
+    sb_put(&w, st->white_captured_n);
+    sb_put(&w, st->black_captured_n);
+    sb_put_nibbles(&w, all, n);
+    sb_tlv_end(&w, s);
+  }
+
+  s = sb_tlv_begin(&w, SNAPSHOT_BIN_TLV_MOVES);
+  sb_put_uvarint(&w, st->move_total);
+  sb_put_uvarint(&w, st->move_first);
+  sb_put_uvarint(&w, st->move_n);
+  uint32_t prev_ts = 0;
+  for (uint16_t i = 0; i < st->move_n; i++) {
+    const snapshot_bin_move_t *m = &st->moves[i];
+    if (m->from > 63 || m->to > 63 || m->piece > 0x0F || m->captured > 0x0F ||
+        m->kind > 0x0F) {
+      return false;
+    }
+    uint16_t sq = (uint16_t)(m->from | (m->to << 6) | (m->piece << 12));
+    sb_put(&w, (uint8_t)sq);
+    sb_put(&w, (uint8_t)(sq >> 8));
+    sb_put(&w, (uint8_t)(m->captured | (m->kind << 4)));
+    sb_put_svarint(&w, (int64_t)m->timestamp - (int64_t)prev_ts);
+    prev_ts = m->timestamp;
+  }
+  sb_tlv_end(&w, s);
+
+  if (!w.ok) {
+    return false;
+  }
+  *out_len = w.pos;
+  return true;
+}
+
+// ============================================================================
+// CTENI
+// ============================================================================
+
+static uint8_t sb_get(sb_reader_t *r) {
+  if (!r->ok || r->pos >= r->len) {
+    r->ok = false;
+    return 0;
+  }
+  return r->buf[r->pos++];
+}
+
+static uint64_t sb_get_uvarint(sb_reader_t *r) {
+  uint64_t v = 0;
+  for (unsigned shift = 0; shift < 64; shift += 7) {
+    uint8_t b = sb_get(r);
+    if (!r->ok) {
+      return 0;
+    }
+    v |= (uint64_t)(b & 0x7FU) << shift;
+    if ((b & 0x80U) == 0) {
+      return v;
+    }
+  }
+  r->ok = false;
+  return 0;
+}
+
+static int64_t sb_get_svarint(sb_reader_t *r) {
+  uint64_t u = sb_get_uvarint(r);
+  return (int64_t)(u >> 1) ^ -(int64_t)(u & 1U);
+}
+
+static void sb_get_nibbles(sb_reader_t *r, uint8_t *out, size_t n) {
+  for (size_t i = 0; i < n; i += 2) {
+    uint8_t b = sb_get(r);
+    out[i] = b & 0x0FU;
+    if (i + 1 < n) {
+      out[i + 1] = b >> 4;
+    }
+  }
+}
+
+static bool sb_decode_moves(sb_reader_t *r, snapshot_bin_state_t *st) {
+  uint64_t total = sb_get_uvarint(r);
+  uint64_t first = sb_get_uvarint(r);
+  uint64_t n = sb_get_uvarint(r);
+  if (!r->ok || n > SNAPSHOT_BIN_MAX_MOVES || total > UINT32_MAX ||
+      first + n > total) {
+    return false;
+  }
+  st->move_total = (uint32_t)total;
+  st->move_first = (uint32_t)first;
+  st->move_n = (uint16_t)n;
+  int64_t ts = 0;
+  for (uint16_t i = 0; i < st->move_n; i++) {
+    snapshot_bin_move_t *m = &st->moves[i];
+    uint8_t lo = sb_get(r);
+    uint16_t sq = (uint16_t)(lo | (sb_get(r) << 8));
+    uint8_t ck = sb_get(r);
+    ts += sb_get_svarint(r);
+    if (!r->ok || ts < 0 || ts > (int64_t)UINT32_MAX) {
+      return false;
+    }
+    m->from = (uint8_t)(sq & 0x3FU);
+    m->to = (uint8_t)((sq >> 6) & 0x3FU);
+    m->piece = (uint8_t)(sq >> 12);
+    m->captured = ck & 0x0FU;
+    m->kind = ck >> 4;
+    m->timestamp = (uint32_t)ts;
+  }
+  return true;
+}
+
+static bool sb_decode_section(uint8_t type, sb_reader_t *r,
+                              snapshot_bin_state_t *st) {
+  switch (type) {
+  case SNAPSHOT_BIN_TLV_BOARD:
+    sb_get_nibbles(r, st->board, 64);
+    return r->ok;
+  case SNAPSHOT_BIN_TLV_MOVES:
+    return sb_decode_moves(r, st);
+  case SNAPSHOT_BIN_TLV_STATUS: {
+    uint32_t bits = 0;
+    for (int i = 0; i < 4; i++) {
+      bits |= (uint32_t)sb_get(r) << (8 * i);
+    }
+    st->status_bits = bits;
+    st->move_count = (uint32_t)sb_get_uvarint(r);
+    if (bits & SNAPSHOT_BIN_ST_PIECE_LIFTED) {
+      st->lifted_sq = sb_get(r);
+      st->lifted_piece = sb_get(r);
+    }
+    if (bits & SNAPSHOT_BIN_ST_CASTLING) {
+      st->castling_from = sb_get(r);
+      st->castling_to = sb_get(r);
+    }
+    return r->ok;
+  }
+  case SNAPSHOT_BIN_TLV_CLOCK:
+    st->has_clock = true;
+    st->clock_flags = sb_get(r);
+    st->clock_type = sb_get(r);
+    st->white_time_ms = (uint32_t)sb_get_uvarint(r);
+    st->black_time_ms = (uint32_t)sb_get_uvarint(r);
+    st->initial_time_ms = (uint32_t)sb_get_uvarint(r);
+    st->increment_ms = (uint32_t)sb_get_uvarint(r);
+    return r->ok;
+  case SNAPSHOT_BIN_TLV_CAPTURED: {
+    uint8_t nw = sb_get(r);
+    uint8_t nb = sb_get(r);
+    if (!r->ok || nw > SNAPSHOT_BIN_MAX_CAPTURED ||
+        nb > SNAPSHOT_BIN_MAX_CAPTURED) {
+      return false;
+    }
+    uint8_t all[2 * SNAPSHOT_BIN_MAX_CAPTURED];
+    sb_get_nibbles(r, all, (size_t)nw + nb);
+    st->white_captured_n = nw;
+    st->black_captured_n = nb;
+    memcpy(st->white_captured, all, nw);
+    memcpy(st->black_captured, all + nw, nb);
+    return r->ok;
+  }
+  default:
+    /* Novejsi sekce — preskoci volajici podle delky. */
+    return true;
+  }
+}
+
+bool snapshot_bin_decode(const uint8_t *buf, size_t len,
+                         snapshot_bin_state_t *st) {
+  if (buf == NULL || st == NULL) {
+    return false;
+  }
+  memset(st, 0, sizeof(*st));
+  sb_reader_t r = {.buf = buf, .len = len, .pos = 0, .ok = true};
+  if (sb_get(&r) != SNAPSHOT_BIN_MAGIC0 || sb_get(&r) != SNAPSHOT_BIN_MAGIC1 ||
+      sb_get(&r) != SNAPSHOT_BIN_VERSION) {
+    return false;
+  }
+  uint64_t ver = sb_get_uvarint(&r);
+  st->timestamp_ms = sb_get_uvarint(&r);
+  if (!r.ok || ver > UINT32_MAX) {
+    return false;
+  }
+  st->state_version = (uint32_t)ver;
+
+  while (r.pos < r.len) {
+    uint8_t type = sb_get(&r);
+    uint64_t plen = sb_get_uvarint(&r);
+    if (!r.ok || plen > r.len - r.pos) {
+      return false;
+    }
+    /* Sekce se cte z vlastniho okna — pretazeni pres hranici = chyba. */
+    sb_reader_t sec = {.buf = buf + r.pos, .len = (size_t)plen, .pos = 0,
+                       .ok = true};
+    if (!sb_decode_section(type, &sec, st)) {
+      return false;
+    }
+    r.pos += (size_t)plen;
+  }
+  return true;
+}
+
+bool snapshot_bin_peek_version(const uint8_t *buf, size_t len,
+                               uint32_t *state_version) {
+  if (buf == NULL || state_version == NULL) {
+    return false;
+  }
+  sb_reader_t r = {.buf = buf, .len = len, .pos = 0, .ok = true};
+  if (sb_get(&r) != SNAPSHOT_BIN_MAGIC0 || sb_get(&r) != SNAPSHOT_BIN_MAGIC1 ||
+      sb_get(&r) != SNAPSHOT_BIN_VERSION) {
+    return false;
+  }
+  uint64_t ver = sb_get_uvarint(&r);
+  if (!r.ok || ver > UINT32_MAX) {
+    return false;
+  }
+  *state_version = (uint32_t)ver;
+  return true;
+}
@@ -0,0 +1,224 @@
+#!/usr/bin/env python3
+"""
+Build-time kompilace katalogu otevření do binární knihy (volá CMake, lze spustit i ručně).
+
+Z `data/openings_master.json` přehraje každou linii (`start_fen` + `line_uci`)
+a pro každou pozici před tahem zapíše záznam ve stylu Polyglot:
+
+  key (u64)  Zobrist klíč pozice (figury, rošády, en passant, hráč na tahu)
+  move (u16) Polyglot kódování: to_file | to_row<<3 | from_file<<6 |
+             from_row<<9 | promo<<12; rošáda jako král bere vlastní věž (e1h1)
+  weight     počet linií katalogu, které v pozici hrají tento tah
+  learn      0 (rezerva)
+
+Záznamy jsou seřazené podle klíče (a v rámci klíče podle váhy), firmware
+hledá binárně v O(log n). Stejná pozice z různých linií má stejný klíč, takže
+transpozice se sejdou v jednom bloku.
+
+Zobrist tabulka (781 hodnot v pořadí Polyglot: 768 figur, 4 rošády,
+8 sloupců en passant, hráč) se generuje deterministicky ze splitmix64 a jde
+do stejného C souboru — firmware ji nepočítá ani nedrží v RAM. Klíče proto
+nejsou zaměnitelné s cizími .bin knihami.
+
+Výstup: C zdroj s `game_opening_book[]` a `game_opening_book_zobrist[]`
+(game_opening_book.h), volitelně big-endian .bin (16 B záznam jako Polyglot).
+
+Spuštění z kořene repa (report, bez zápisu):
+  python3 components/game_task/tools/build_opening_book.py --report \\
+      data/openings_master.json
+"""
+
+from __future__ import annotations
+
+import argparse
+import json
+import struct
+import sys
+
+ZOBRIST_SEED = 0x43686573734D6174  # "ChessMat"
+ZOBRIST_COUNT = 781
+ZOBRIST_CASTLE = 768
+ZOBRIST_EP = 772
+ZOBRIST_TURN = 780
+
+# Polyglot druh figury: pesec 0, kun 1, strelec 2, vez 3, dama 4, kral 5;
+# index = 2 * druh + (1 pro bilou).
+KIND = {"p": 0, "n": 1, "b": 2, "r": 3, "q": 4, "k": 5}
+PROMO = {"n": 1, "b": 2, "r": 3, "q": 4}
+MAX_WEIGHT = 0xFFFF
+
+
+def splitmix64(state: int):
+    while True:
+        state = (state + 0x9E3779B97F4A7C15) & 0xFFFFFFFFFFFFFFFF
+        z = state
+        z = ((z ^ (z >> 30)) * 0xBF58476D1CE4E5B9) & 0xFFFFFFFFFFFFFFFF
+        z = ((z ^ (z >> 27)) * 0x94D049BB133111EB) & 0xFFFFFFFFFFFFFFFF
+        yield z ^ (z >> 31)
+
+
+def zobrist_table() -> list[int]:
+    gen = splitmix64(ZOBRIST_SEED)
+    return [next(gen) for _ in range(ZOBRIST_COUNT)]
+
+
+class Position:
+    """Minimalní pozice pro přehrání legálních linií katalogu (bez validace)."""
+
+    def __init__(self, fen: str) -> None:
+        parts = fen.split()
+        self.sq: dict[int, str] = {}
+        for i, rank in enumerate(parts[0].split("/")):
+            row = 7 - i
+            col = 0
+            for ch in rank:
+                if ch.isdigit():
+                    col += int(ch)
+                else:
+                    self.sq[row * 8 + col] = ch
+                    col += 1
+        self.white = parts[1] == "w"
+        self.castling = set(parts[2]) - {"-"}
+        self.ep_file = -1
+        if len(parts) > 3 and parts[3] != "-":
+            self.ep_file = ord(parts[3][0]) - ord("a")
+
+    def key(self, z: list[int]) -> int:
+        k = 0
+        for s, p in self.sq.items():
+            idx = 2 * KIND[p.lower()] + (1 if p.isupper() else 0)
+            k ^= z[64 * idx + s]
+        for i, c in enumerate("KQkq"):
+            if c in self.castling:
+                k ^= z[ZOBRIST_CASTLE + i]
+        if self.ep_file >= 0 and self._ep_capturable():
+            k ^= z[ZOBRIST_EP + self.ep_file]
+        if self.white:
+            k ^= z[ZOBRIST_TURN]
+        return k
+
+    def _ep_capturable(self) -> bool:
+        # Polyglot: en passant jen když ho hráč na tahu může sebrat.
+        row = 4 if self.white else 3
+        pawn = "P" if self.white else "p"
+        for df in (-1, 1):
+            f = self.ep_file + df
+            if 0 <= f < 8 and self.sq.get(row * 8 + f) == pawn:
+                return True
+        return False
+
+    def encode(self, uci: str) -> int:
+        fr, to = parse_square(uci[0:2]), parse_square(uci[2:4])
+        piece = self.sq.get(fr)
+        if piece is None:
+            raise ValueError(f"no piece on {uci[0:2]}")
+        if piece.lower() == "k" and abs(to % 8 - fr % 8) == 2:
+            to = (fr // 8) * 8 + (7 if to % 8 > fr % 8 else 0)
+        promo = PROMO[uci[4]] if len(uci) > 4 else 0
+        return (to % 8) | (to // 8) << 3 | (fr % 8) << 6 | (fr // 8) << 9 | promo << 12
+
+    def push(self, uci: str) -> None:
+        fr, to = parse_square(uci[0:2]), parse_square(uci[2:4])
+        piece = self.sq.pop(fr)
+        kind = piece.lower()
+        if kind == "p" and fr % 8 != to % 8 and to not in self.sq:
+            self.sq.pop((fr // 8) * 8 + to % 8, None)
+        if kind == "k" and abs(to % 8 - fr % 8) == 2:
+            row = fr // 8
+            rook_from, rook_to = (row * 8 + 7, row * 8 + 5) if to % 8 > fr % 8 else (row * 8, row * 8 + 3)
+            self.sq[rook_to] = self.sq.pop(rook_from)
+        if len(uci) > 4:
+            piece = uci[4].upper() if piece.isupper() else uci[4]
+        self.sq[to] = piece
+        for s, rights in ((4, "KQ"), (60, "kq"), (0, "Q"), (7, "K"), (56, "q"), (63, "k")):
+            if s in (fr, to):
+                self.castling -= set(rights)
+        self.ep_file = fr % 8 if kind == "p" and abs(to - fr) == 16 else -1
+        self.white = not self.white
+
+
+def parse_square(s: str) -> int:
+    return (int(s[1]) - 1) * 8 + (ord(s[0]) - ord("a"))
+
+
+def build(master: dict, z: list[int]) -> list[tuple[int, int, int]]:
+    weights: dict[tuple[int, int], int] = {}
+    for opening in master["openings"]:
+        pos = Position(opening["start_fen"])
+        for uci in opening["line_uci"]:
+            entry = (pos.key(z), pos.encode(uci))
+            weights[entry] = min(weights.get(entry, 0) + 1, MAX_WEIGHT)
+            pos.push(uci)
+    book = [(k, m, w) for (k, m), w in weights.items()]
+    book.sort(key=lambda e: (e[0], -e[2], e[1]))
+    return book
+
+
+def emit_c(book: list[tuple[int, int, int]], z: list[int]) -> str:
+    out = [
+        "/* Vygenerováno tools/build_opening_book.py — needitovat. */",
+        "",
+        '#include "game_opening_book.h"',
+        "",
+        "const uint64_t game_opening_book_zobrist[GAME_OPENING_BOOK_ZOBRIST_COUNT] = {",
+    ]
+    for i in range(0, len(z), 4):
+        out.append("    " + " ".join(f"0x{v:016x}ULL," for v in z[i : i + 4]))
+    out.append("};")
+    out.append("")
+    out.append("const game_opening_book_entry_t game_opening_book[] = {")
+    for k, m, w in book:
+        out.append(f"    {{0x{k:016x}ULL, 0x{m:04x}, {w}, 0}},")
+    out.append("};")
+    out.append("")
+    out.append(
+        "const size_t game_opening_book_count ="
+        " sizeof(game_opening_book) / sizeof(game_opening_book[0]);"
+    )
+    out.append("")
+    return "\n".join(out)
+
+
+def emit_bin(book: list[tuple[int, int, int]]) -> bytes:
+    return b"".join(struct.pack(">QHHI", k, m, w, 0) for k, m, w in book)
+
+
+def report(master: dict, book: list[tuple[int, int, int]]) -> None:
+    keys = {k for k, _, _ in book}
+    plies = sum(len(o["line_uci"]) for o in master["openings"])
+    print(f"lines      {len(master['openings'])}")
+    print(f"plies      {plies}")
+    print(f"positions  {len(keys)}")
+    print(f"entries    {len(book)} ({len(book) * 16} B)")
+    print(f"zobrist    {ZOBRIST_COUNT * 8} B")
+
+
+def main() -> int:
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[1])
+    ap.add_argument("master", help="data/openings_master.json")
+    ap.add_argument("--out", help="generovaný C soubor")
+    ap.add_argument("--bin", help="big-endian kniha (16 B záznam)")
+    ap.add_argument("--report", action="store_true", help="vypsat statistiku")
+    args = ap.parse_args()
+
+    with open(args.master, encoding="utf-8") as f:
+        master = json.load(f)
+    z = zobrist_table()
+    try:
+        book = build(master, z)
+    except (KeyError, ValueError) as e:
+        print(f"build_opening_book: {e}", file=sys.stderr)
+        return 1
+    if args.report or not (args.out or args.bin):
+        report(master, book)
+    if args.out:
+        with open(args.out, "w", encoding="utf-8") as f:
+            f.write(emit_c(book, z))
+    if args.bin:
+        with open(args.bin, "wb") as f:
+            f.write(emit_bin(book))
+    return 0
+
+
+if __name__ == "__main__":
+    raise SystemExit(main())
@@ -0,0 +1,293 @@
+#!/usr/bin/env python3
+"""
+Build-time kompilace databáze úloh do binárního obrazu (volá CMake, lze spustit i ručně).
+
+Vstup je `data/puzzles_master.json` (pole `puzzles`: fen, moves od tahu
+řešitele, rating, themes) nebo export Lichess `lichess_db_puzzle.csv`
+(FEN je pozice před tahem soupeře — první tah z Moves se přehraje a řešení
+začíná až tahem řešitele).
+
+Formát (little-endian, game_puzzle_db.h):
+
+  hlavička 32 B   magic "CMPZ", verze, velikost záznamu, počet, rating_min,
+                  šířka pásma, počet pásem, počet témat, offsety sekcí
+  pásma           band_count × {first u32, count u32}; pásmo i pokrývá
+                  rating <rating_min + i*band_width, + band_width)
+  témata          theme_count × 24 B jméno (NUL-padded), bit i v masce záznamu
+  záznamy 48 B    occupancy u64 (bit = pole, a1 = 0), 16 B figur po 4 bitech
+                  v pořadí obsazených polí (1..6 = PNBRQK, +8 černá),
+                  rating u16, flags u8 (bit0 černý na tahu, bity 1-4 KQkq),
+                  ep_file u8 (0 = není, jinak sloupec + 1), themes u32,
+                  plies u8, rezerva u8, moves 7 × u16
+                  (from | to<<6 | promo<<12, promo 1..4 = n b r q; rošáda e1g1)
+
+Záznamy jsou seřazené podle ratingu, takže pásmo je souvislý úsek a výběr
+podle ratingu je O(1). ID úlohy = index záznamu + 1.
+
+Výstup: obraz `--out` (jde do oddílu assets jako /static/data/puzzles.bin)
+nebo C zdroj `--c-out` s `game_puzzle_db_builtin[]` (build bez oddílu).
+
+Spuštění z kořene repa (report, bez zápisu):
+  python3 components/game_task/tools/build_puzzle_db.py --report \\
+      data/puzzles_master.json
+"""
+
+from __future__ import annotations
+
+import argparse
+import csv
+import json
+import os
+import struct
+import sys
+from collections import Counter
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+
+from build_opening_book import PROMO, Position, parse_square  # noqa: E402
+
+MAGIC = 0x5A504D43  # "CMPZ"
+VERSION = 1
+HEADER = struct.Struct("<IHHIHHHHIII")
+BAND = struct.Struct("<II")
+RECORD = struct.Struct("<Q16sHBBIBB7H")
+THEME_NAME = 24
+MAX_THEMES = 32
+MAX_PLIES = 7
+MAX_PUZZLES = 0xFFFF
+PIECE_CODE = {"p": 1, "n": 2, "b": 3, "r": 4, "q": 5, "k": 6}
+
+
+def encode_move(pos: Position, uci: str) -> int:
+    fr, to = parse_square(uci[0:2]), parse_square(uci[2:4])
+    piece = pos.sq.get(fr)
+    if piece is None or piece.isupper() != pos.white:
+        raise ValueError(f"{uci}: no piece of side to move on {uci[0:2]}")
+    target = pos.sq.get(to)
+    if target is not None and target.isupper() == pos.white:
+        raise ValueError(f"{uci}: own piece on {uci[2:4]}")
+    promo = PROMO[uci[4]] if len(uci) > 4 else 0
+    return fr | to << 6 | promo << 12
+
+
+def pack_position(pos: Position) -> tuple[int, bytes, int, int]:
+    kings = sorted(p for p in pos.sq.values() if p in "Kk")
+    if kings != ["K", "k"]:
+        raise ValueError("need exactly one king per side")
+    if len(pos.sq) > 32:
+        raise ValueError("more than 32 pieces")
+    occupancy = 0
+    nibbles = []
+    for s in sorted(pos.sq):
+        p = pos.sq[s]
+        occupancy |= 1 << s
+        nibbles.append(PIECE_CODE[p.lower()] | (0 if p.isupper() else 8))
+    nibbles.extend([0] * (32 - len(nibbles)))
+    pieces = bytes(nibbles[i] | nibbles[i + 1] << 4 for i in range(0, 32, 2))
+    flags = 0 if pos.white else 1
+    for i, c in enumerate("KQkq"):
+        if c in pos.castling:
+            flags |= 1 << (i + 1)
+    ep_file = pos.ep_file + 1 if pos.ep_file >= 0 else 0
+    return occupancy, pieces, flags, ep_file
+
+
+def make_puzzle(name: str, fen: str, moves: list[str], rating: int,
+                themes: list[str]) -> dict:
+    if not 1 <= len(moves) <= MAX_PLIES:
+        raise ValueError(f"{name}: {len(moves)} plies (1..{MAX_PLIES})")
+    if not 0 <= rating <= 0xFFFF:
+        raise ValueError(f"{name}: rating {rating}")
+    pos = Position(fen)
+    try:
+        occupancy, pieces, flags, ep_file = pack_position(pos)
+        encoded = []
+        for uci in moves:
+            encoded.append(encode_move(pos, uci))
+            pos.push(uci)
+    except (KeyError, ValueError) as e:
+        raise ValueError(f"{name}: {e}") from None
+    return {
+        "name": name,
+        "rating": rating,
+        "themes": themes,
+        "occupancy": occupancy,
+        "pieces": pieces,
+        "flags": flags,
+        "ep_file": ep_file,
+        "moves": encoded,
+    }
+
+
+def load_master(path: str) -> list[dict]:
+    with open(path, encoding="utf-8") as f:
+        master = json.load(f)
+    return [
+        make_puzzle(p["id"], p["fen"], p["moves"], int(p["rating"]),
+                    p.get("themes", []))
+        for p in master["puzzles"]
+    ]
+
+
+def load_lichess(path: str, args: argparse.Namespace) -> list[dict]:
+    puzzles = []
+    skipped = 0
+    with open(path, encoding="utf-8", newline="") as f:
+        for row in csv.DictReader(f):
+            rating = int(row["Rating"])
+            if rating < args.min_rating or rating > args.max_rating:
+                continue
+            moves = row["Moves"].split()
+            if len(moves) < 2:
+                skipped += 1
+                continue
+            pos = Position(row["FEN"])
+            try:
+                pos.push(moves[0])
+                fen = fen_of(pos)
+                puzzles.append(make_puzzle(row["PuzzleId"], fen, moves[1:],
+                                           rating, row["Themes"].split()))
+            except (KeyError, ValueError):
+                skipped += 1
+                continue
+            if args.limit and len(puzzles) >= args.limit:
+                break
+    if skipped:
+        print(f"build_puzzle_db: skipped {skipped} rows", file=sys.stderr)
+    return puzzles
+
+
+def fen_of(pos: Position) -> str:
+    rows = []
+    for row in range(7, -1, -1):
+        s, empty = "", 0
+        for col in range(8):
+            p = pos.sq.get(row * 8 + col)
+            if p is None:
+                empty += 1
+                continue
+            if empty:
+                s += str(empty)
+                empty = 0
+            s += p
+        rows.append(s + (str(empty) if empty else ""))
+    castling = "".join(c for c in "KQkq" if c in pos.castling) or "-"
+    ep = "-"
+    if pos.ep_file >= 0:
+        ep = "abcdefgh"[pos.ep_file] + ("6" if pos.white else "3")
+    return f"{'/'.join(rows)} {'w' if pos.white else 'b'} {castling} {ep} 0 1"
+
+
+def build(puzzles: list[dict], band_width: int) -> tuple[bytes, list[str]]:
+    if not puzzles:
+        raise ValueError("no puzzles")
+    if len(puzzles) > MAX_PUZZLES:
+        raise ValueError(f"{len(puzzles)} puzzles (max {MAX_PUZZLES})")
+    counts = Counter(t for p in puzzles for t in p["themes"])
+    themes = sorted(counts, key=lambda t: (-counts[t], t))[:MAX_THEMES]
+    bit = {t: 1 << i for i, t in enumerate(themes)}
+    puzzles = sorted(puzzles, key=lambda p: p["rating"])  # stabilní
+
+    rating_min = puzzles[0]["rating"] // band_width * band_width
+    band_count = (puzzles[-1]["rating"] - rating_min) // band_width + 1
+    bands = [[0, 0] for _ in range(band_count)]
+    for i, p in enumerate(puzzles):
+        b = bands[(p["rating"] - rating_min) // band_width]
+        if b[1] == 0:
+            b[0] = i
+        b[1] += 1
+
+    records = bytearray()
+    for p in puzzles:
+        mask = 0
+        for t in p["themes"]:
+            mask |= bit.get(t, 0)
+        moves = p["moves"] + [0] * (MAX_PLIES - len(p["moves"]))
+        records += RECORD.pack(p["occupancy"], p["pieces"], p["rating"],
+                               p["flags"], p["ep_file"], mask,
+                               len(p["moves"]), 0, *moves)
+
+    bands_off = HEADER.size
+    themes_off = bands_off + BAND.size * band_count
+    records_off = themes_off + THEME_NAME * len(themes)
+    header = HEADER.pack(MAGIC, VERSION, RECORD.size, len(puzzles), rating_min,
+                         band_width, band_count, len(themes), bands_off,
+                         themes_off, records_off)
+    body = b"".join(BAND.pack(*b) for b in bands)
+    body += b"".join(t.encode("ascii")[: THEME_NAME - 1].ljust(THEME_NAME, b"\0")
+                     for t in themes)
+    return header + body + bytes(records), [p["name"] for p in puzzles]
+
+
+def emit_c(image: bytes) -> str:
+    out = [
+        "/* Vygenerováno tools/build_puzzle_db.py — needitovat. */",
+        "",
+        '#include "game_puzzle_db.h"',
+        "",
+        "const uint8_t game_puzzle_db_builtin[] __attribute__((aligned(4))) = {",
+    ]
+    for i in range(0, len(image), 16):
+        out.append("    " + ", ".join(f"0x{b:02x}" for b in image[i : i + 16]) + ",")
+    out.append("};")
+    out.append("")
+    out.append("const size_t game_puzzle_db_builtin_size = sizeof(game_puzzle_db_builtin);")
+    out.append("")
+    return "\n".join(out)
+
+
+def report(image: bytes, names: list[str]) -> None:
+    (_, _, rec_size, count, rating_min, band_width, band_count, theme_count,
+     bands_off, themes_off, records_off) = HEADER.unpack_from(image)
+    print(f"puzzles    {count} ({count * rec_size} B records)")
+    print(f"image      {len(image)} B")
+    for i in range(band_count):
+        first, n = BAND.unpack_from(image, bands_off + i * BAND.size)
+        if n:
+            lo = rating_min + i * band_width
+            print(f"band {lo:>4}-{lo + band_width - 1:<4} {n:>6} (id {first + 1}..{first + n})")
+    themes = [
+        image[themes_off + i * THEME_NAME : themes_off + (i + 1) * THEME_NAME]
+        .rstrip(b"\0").decode("ascii")
+        for i in range(theme_count)
+    ]
+    print(f"themes     {', '.join(themes)}")
+    if count <= 64:
+        for i, name in enumerate(names):
+            print(f"  {i + 1:>3} {name}")
+
+
+def main() -> int:
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[1])
+    ap.add_argument("source", help="data/puzzles_master.json nebo Lichess .csv")
+    ap.add_argument("--out", help="binární obraz (puzzles.bin)")
+    ap.add_argument("--c-out", help="C zdroj s vestavěnou databází")
+    ap.add_argument("--band-width", type=int, default=200, help="šířka pásma ratingu")
+    ap.add_argument("--limit", type=int, default=0, help="max úloh z CSV")
+    ap.add_argument("--min-rating", type=int, default=0)
+    ap.add_argument("--max-rating", type=int, default=0xFFFF)
+    ap.add_argument("--report", action="store_true", help="vypsat statistiku")
+    args = ap.parse_args()
+
+    try:
+        if args.source.endswith(".csv"):
+            puzzles = load_lichess(args.source, args)
+        else:
+            puzzles = load_master(args.source)
+        image, names = build(puzzles, args.band_width)
+    except (KeyError, ValueError) as e:
+        print(f"build_puzzle_db: {e}", file=sys.stderr)
+        return 1
+    if args.report or not (args.out or args.c_out):
+        report(image, names)
+    if args.out:
+        with open(args.out, "wb") as f:
+            f.write(image)
+    if args.c_out:
+        with open(args.c_out, "w", encoding="utf-8") as f:
+            f.write(emit_c(image))
+    return 0
+
+
+if __name__ == "__main__":
+    raise SystemExit(main())
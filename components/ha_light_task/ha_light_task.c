@@ -19,6 +19,9 @@
  * - GAME -> HA: Po 5 minutach bez aktivity (pohyb figurky nebo herni prikaz)
  * - HA -> GAME: Okamzite pri detekci pohybu figurky (PICKUP/DROP)
  *
+ * Vlastni task uz nema: bezi jako job service tasku (svc_loop.h), prikazy
+ * z fronty ho probudi, jinak se spousti jednou za sekundu.
+ *
  * @author Alfred Krutina
  * @version 1.8.0
  * @date 2025-01-XX
@@ -27,6 +30,7 @@
 #include "ha_light_task.h"
 #include "cJSON.h"
 #include "chess_types.h"
+#include "config_persist.h"
 #include "esp_err.h"
 #include "esp_event.h"
 #include "esp_log.h"
@@ -41,6 +45,7 @@
 #include "game_task.h"
 #include "led_task.h"
 #include "mqtt_client.h"
+#include "svc_loop.h"
 #include "nvs.h"
 #include "nvs_flash.h"
 #include <stdio.h>
@@ -135,8 +140,9 @@ static struct {
 extern QueueHandle_t game_command_queue;
 extern QueueHandle_t matrix_event_queue;
 
-// Interní fronta pro HA task
+// Interní fronta pro HA job (odesilatel job probudi svc_job_wake)
 static QueueHandle_t ha_light_cmd_queue = NULL;
+static svc_job_t s_ha_light_job = 0;
 
 // Mutex pro thread-safe pristup k ha_light_state (HTTP handler cte, HA task
 // pise)
@@ -177,8 +183,8 @@ static esp_err_t ha_light_task_wdt_reset_safe(void) {
   return ESP_OK;
 }
 
-/** Handle hlavní smyčky — esp_task_wdt_reset jen z ha_light_task (ne z MQTT).
- */
+/** Service task, ve kterem bezi HA job — esp_task_wdt_reset jen z nej (ne z
+ * MQTT). */
 static TaskHandle_t s_ha_light_task_hdl;
 
 static void ha_light_wdt_feed_if_own_task(void) {
@@ -262,8 +268,9 @@ void ha_light_report_activity(const char *activity_type) {
   cmd.type = HA_CMD_ACTIVITY;
   cmd.u.data = (void *)activity_type;
 
-  if (ha_light_cmd_queue != NULL) {
-    xQueueSend(ha_light_cmd_queue, &cmd, 0);
+  if (ha_light_cmd_queue != NULL &&
+      xQueueSend(ha_light_cmd_queue, &cmd, 0) == pdTRUE) {
+    svc_job_wake(s_ha_light_job);
   }
 }
 
@@ -1037,48 +1044,76 @@ static void lamp_nvs_load(void) {
   }
 }
 
-static void lamp_nvs_save(void) {
-  ha_light_task_wdt_reset_safe();
-  bool st;
+/** Barva lampy pro NVS; zapis v persist tasku, rychle zmeny se slouci. */
+typedef struct {
+  uint8_t state;
   uint8_t r, g, b;
-  if (ha_light_state_mutex != NULL &&
-      xSemaphoreTake(ha_light_state_mutex, pdMS_TO_TICKS(100)) == pdTRUE) {
-    st = ha_light_state.state;
-    r = ha_light_state.r;
-    g = ha_light_state.g;
-    b = ha_light_state.b;
-    xSemaphoreGive(ha_light_state_mutex);
-  } else {
-    return;
-  }
+} lamp_nvs_color_t;
 
+static esp_err_t lamp_nvs_write_color(const char *key, const void *data,
+                                      size_t len) {
+  (void)key;
+  if (len != sizeof(lamp_nvs_color_t)) {
+    return ESP_ERR_INVALID_SIZE;
+  }
+  const lamp_nvs_color_t *c = (const lamp_nvs_color_t *)data;
   nvs_handle_t handle;
   if (nvs_open(LAMP_NVS_NAMESPACE, NVS_READWRITE, &handle) != ESP_OK) {
     ESP_LOGW(TAG, "lamp_nvs_save: nvs_open failed");
-    return;
+    return ESP_FAIL;
   }
-  nvs_set_u8(handle, LAMP_NVS_KEY_STATE, st ? 1 : 0);
-  nvs_set_u8(handle, LAMP_NVS_KEY_R, r);
-  nvs_set_u8(handle, LAMP_NVS_KEY_G, g);
-  nvs_set_u8(handle, LAMP_NVS_KEY_B, b);
-  ha_light_task_wdt_reset_safe();
+  nvs_set_u8(handle, LAMP_NVS_KEY_STATE, c->state);
+  nvs_set_u8(handle, LAMP_NVS_KEY_R, c->r);
+  nvs_set_u8(handle, LAMP_NVS_KEY_G, c->g);
+  nvs_set_u8(handle, LAMP_NVS_KEY_B, c->b);
   esp_err_t err = nvs_commit(handle);
-  ha_light_task_wdt_reset_safe();
   nvs_close(handle);
   if (err != ESP_OK) {
     ESP_LOGW(TAG, "lamp_nvs_save: nvs_commit failed (%s)",
              esp_err_to_name(err));
   }
+  return err;
 }
 
-static void lamp_nvs_save_auto_timeout(void) {
-  nvs_handle_t handle;
-  if (nvs_open(LAMP_NVS_NAMESPACE, NVS_READWRITE, &handle) != ESP_OK) {
+static void lamp_nvs_save(void) {
+  lamp_nvs_color_t c;
+  if (ha_light_state_mutex != NULL &&
+      xSemaphoreTake(ha_light_state_mutex, pdMS_TO_TICKS(100)) == pdTRUE) {
+    c.state = ha_light_state.state ? 1 : 0;
+    c.r = ha_light_state.r;
+    c.g = ha_light_state.g;
+    c.b = ha_light_state.b;
+    xSemaphoreGive(ha_light_state_mutex);
+  } else {
     return;
   }
-  nvs_set_u32(handle, LAMP_NVS_KEY_AUTO_TIMEOUT_SEC, activity_timeout_auto_sec);
-  nvs_commit(handle);
+  (void)config_persist_submit(LAMP_NVS_NAMESPACE, lamp_nvs_write_color, &c,
+                              sizeof(c), CONFIG_PERSIST_PRIO_LOW, NULL);
+}
+
+static esp_err_t lamp_nvs_write_auto_timeout(const char *key, const void *data,
+                                             size_t len) {
+  (void)key;
+  if (len != sizeof(uint32_t)) {
+    return ESP_ERR_INVALID_SIZE;
+  }
+  uint32_t sec;
+  memcpy(&sec, data, sizeof(sec));
+  nvs_handle_t handle;
+  esp_err_t err = nvs_open(LAMP_NVS_NAMESPACE, NVS_READWRITE, &handle);
+  if (err != ESP_OK) {
+    return err;
+  }
+  nvs_set_u32(handle, LAMP_NVS_KEY_AUTO_TIMEOUT_SEC, sec);
+  err = nvs_commit(handle);
   nvs_close(handle);
+  return err;
+}
+
+static void lamp_nvs_save_auto_timeout(void) {
+  uint32_t sec = activity_timeout_auto_sec;
+  (void)config_persist_submit("lamp_auto_sec", lamp_nvs_write_auto_timeout,
+                              &sec, sizeof(sec), CONFIG_PERSIST_PRIO_LOW, NULL);
 }
 
 // ============================================================================
@@ -1156,10 +1191,12 @@ bool ha_light_request_web_lamp(bool state, uint8_t r, uint8_t g, uint8_t b) {
   cmd.u.web_lamp.g = g;
   cmd.u.web_lamp.b = b;
 
-  if (ha_light_cmd_queue == NULL) {
+  if (ha_light_cmd_queue == NULL ||
+      xQueueSend(ha_light_cmd_queue, &cmd, 0) != pdTRUE) {
     return false;
   }
-  return xQueueSend(ha_light_cmd_queue, &cmd, 0) == pdTRUE;
+  svc_job_wake(s_ha_light_job);
+  return true;
 }
 
 /**
@@ -1234,186 +1271,194 @@ esp_err_t ha_light_reinit_mqtt(void) {
 }
 
 // ============================================================================
-// MAIN TASK LOOP
+// HA LIGHT JOB
 // ============================================================================
 
+/** Perioda jobu bez prikazu: WiFi kontrola 5 s, publish 30 s, timeout v s. */
+#define HA_LIGHT_JOB_PERIOD_MS 1000
+/** Behem boot animace jen cekame na fade_out (rychle probuzeni). */
+#define HA_LIGHT_JOB_BOOT_POLL_MS 10
+
 /**
- * @brief Hlavni funkce HA Light tasku
+ * @brief Zpracuje jeden prikaz z ha_light_cmd_queue
  */
-void ha_light_task_start(void *pvParameters) {
-  ESP_LOGI(TAG, "Starting HA Light Task...");
-  s_ha_light_task_hdl = xTaskGetCurrentTaskHandle();
-
-  // Register with WDT
-  esp_err_t ret = esp_task_wdt_add(NULL);
-  if (ret != ESP_OK && ret != ESP_ERR_INVALID_ARG) {
-    ESP_LOGW(TAG, "Failed to register with WDT: %s", esp_err_to_name(ret));
-  }
+static void ha_light_handle_command(const ha_light_command_t *cmd) {
+  if (cmd->type == HA_CMD_WEB_LAMP) {
+    if (ha_light_state_mutex != NULL &&
+        xSemaphoreTake(ha_light_state_mutex, pdMS_TO_TICKS(100)) == pdTRUE) {
+      ha_light_state.state = (cmd->u.web_lamp.state != 0);
+      ha_light_state.r = cmd->u.web_lamp.r;
+      ha_light_state.g = cmd->u.web_lamp.g;
+      ha_light_state.b = cmd->u.web_lamp.b;
+      ha_light_state.brightness = 255;
+      xSemaphoreGive(ha_light_state_mutex);
+    }
+    lamp_nvs_save();
+    ha_light_switch_to_ha_mode();
+  } else if (cmd->type == HA_CMD_ACTIVITY) {
+    const char *activity_name = (const char *)cmd->u.data;
+    // Reset activity timer in HA job context
+    last_activity_time_ms = esp_timer_get_time() / 1000;
 
-  task_running = true;
-  current_mode = HA_MODE_GAME;
-  last_activity_time_ms = esp_timer_get_time() / 1000;
+    // If currently in HA mode, switch back to GAME mode on first activity
+    if (current_mode == HA_MODE_HA) {
+      ESP_LOGI(TAG, "Switching from HA mode to GAME mode (activity: %s)",
+               activity_name ? activity_name : "unknown");
+      ha_light_switch_to_game_mode();
+    }
 
-  ha_light_state_mutex = xSemaphoreCreateMutex();
-  if (ha_light_state_mutex == NULL) {
-    ESP_LOGE(TAG, "Failed to create ha_light_state mutex");
+    // Check rate limit logic again here (in HA job context) to save MQTT
+    // bandwidth
+    static uint32_t last_mqtt_activity = 0;
+    uint32_t now = esp_timer_get_time() / 1000;
+
+    if (now - last_mqtt_activity > 500) { // 500ms limit
+      last_mqtt_activity = now;
+
+      if (mqtt_connected && mqtt_client != NULL) {
+        char topic[128];
+        snprintf(topic, sizeof(topic), "%s", HA_TOPIC_GAME_ACTIVITY);
+        cJSON *json = cJSON_CreateObject();
+        cJSON_AddStringToObject(json, "event",
+                                activity_name ? activity_name : "unknown");
+        cJSON_AddNumberToObject(json, "timestamp_ms", now);
+        char *json_str = cJSON_PrintUnformatted(json);
+        if (json_str) {
+          esp_mqtt_client_publish(mqtt_client, topic, json_str, 0, 0, 0);
+          free(json_str);
+        }
+        cJSON_Delete(json);
+      }
+    }
   }
+}
 
-  ha_light_cmd_queue = xQueueCreate(10, sizeof(ha_light_command_t));
-  if (ha_light_cmd_queue == NULL) {
-    ESP_LOGE(TAG, "Failed to create HA command queue");
+/**
+ * @brief Krok HA Light jobu (service task, svc_loop.h)
+ *
+ * Prikazy z fronty job probudi hned (svc_job_wake v odesilatelich); jinak
+ * bezi kazdou sekundu kvuli WiFi/MQTT stavu a timeoutu necinnosti.
+ */
+static uint32_t ha_light_job_step(void *ctx) {
+  (void)ctx;
+  if (s_ha_light_task_hdl == NULL) {
+    s_ha_light_task_hdl = xTaskGetCurrentTaskHandle();
   }
 
-  lamp_nvs_load();
-
-  // Main loop
-  // TickType_t last_wake_time = xTaskGetTickCount(); // Unused in queue-based
-  // loop
-
-  for (;;) {
-    // =========================================================================
-    // 🛑 BOOT ANIMATION PROTECTION - BLOKUJE HA OPERACE BĚHEM BOOT
-    // =========================================================================
-    // Pokud běží boot animace, HA task nesmí posílat LED příkazy!
-    // (např. "zhasni světlo" při rychlém WiFi připojení)
-    if (led_is_booting()) {
-      ha_light_task_wdt_reset_safe();
-      vTaskDelay(pdMS_TO_TICKS(10)); // 10ms - rychlé probuzení po fade_out!
-      continue;
-    }
-    // =========================================================================
+  // =========================================================================
+  // 🛑 BOOT ANIMATION PROTECTION - BLOKUJE HA OPERACE BĚHEM BOOT
+  // =========================================================================
+  // Pokud běží boot animace, HA job nesmí posílat LED příkazy!
+  // (např. "zhasni světlo" při rychlém WiFi připojení)
+  if (led_is_booting()) {
+    return HA_LIGHT_JOB_BOOT_POLL_MS; // rychlé probuzení po fade_out!
+  }
+  // =========================================================================
 
-    // Reset WDT
+  ha_light_command_t cmd;
+  while (ha_light_cmd_queue &&
+         xQueueReceive(ha_light_cmd_queue, &cmd, 0) == pdTRUE) {
+    ha_light_handle_command(&cmd);
     ha_light_task_wdt_reset_safe();
+  }
 
-    // Process queue with timeout (100ms) - replaces vTaskDelay
-    ha_light_command_t cmd;
-    if (ha_light_cmd_queue &&
-        xQueueReceive(ha_light_cmd_queue, &cmd, pdMS_TO_TICKS(100)) == pdTRUE) {
-      if (cmd.type == HA_CMD_WEB_LAMP) {
-        if (ha_light_state_mutex != NULL &&
-            xSemaphoreTake(ha_light_state_mutex, pdMS_TO_TICKS(100)) ==
-                pdTRUE) {
-          ha_light_state.state = (cmd.u.web_lamp.state != 0);
-          ha_light_state.r = cmd.u.web_lamp.r;
-          ha_light_state.g = cmd.u.web_lamp.g;
-          ha_light_state.b = cmd.u.web_lamp.b;
-          ha_light_state.brightness = 255;
-          xSemaphoreGive(ha_light_state_mutex);
-        }
-        lamp_nvs_save();
-        ha_light_switch_to_ha_mode();
-      } else if (cmd.type == HA_CMD_ACTIVITY) {
-        const char *activity_name = (const char *)cmd.u.data;
-        // Reset activity timer in HA task context
-        last_activity_time_ms = esp_timer_get_time() / 1000;
-
-        // If currently in HA mode, switch back to GAME mode on first activity
-        if (current_mode == HA_MODE_HA) {
-          ESP_LOGI(TAG, "Switching from HA mode to GAME mode (activity: %s)",
-                   activity_name ? activity_name : "unknown");
-          ha_light_switch_to_game_mode();
-        }
-
-        // Check rate limit logic again here (in HA task context) to save MQTT
-        // bandwidth
-        static uint32_t last_mqtt_activity = 0;
-        uint32_t now = esp_timer_get_time() / 1000;
-
-        if (now - last_mqtt_activity > 500) { // 500ms limit
-          last_mqtt_activity = now;
-
-          if (mqtt_connected && mqtt_client != NULL) {
-            char topic[128];
-            snprintf(topic, sizeof(topic), "%s", HA_TOPIC_GAME_ACTIVITY);
-            cJSON *json = cJSON_CreateObject();
-            cJSON_AddStringToObject(json, "event",
-                                    activity_name ? activity_name : "unknown");
-            cJSON_AddNumberToObject(json, "timestamp_ms", now);
-            char *json_str = cJSON_PrintUnformatted(json);
-            if (json_str) {
-              esp_mqtt_client_publish(mqtt_client, topic, json_str, 0, 0, 0);
-              free(json_str);
-            }
-            cJSON_Delete(json);
-          }
-        }
+  // POLL: Check WiFi STA status periodically (every 5 seconds)
+  static uint32_t last_wifi_check = 0;
+  static uint32_t last_mqtt_retry_ms = 0;
+  uint32_t current_time_ms = esp_timer_get_time() / 1000;
+  if (current_time_ms - last_wifi_check >= 5000) {
+    bool wifi_connected = ha_light_check_wifi_sta_connected();
+    if (wifi_connected && sta_connected && mqtt_client != NULL) {
+      size_t fh = esp_get_free_heap_size();
+      if (fh < HA_MQTT_STOP_HEAP_BYTES) {
+        ESP_LOGW(TAG,
+                 "[STAGING] MQTT stop: critical heap %zu B (<%d B) — release "
+                 "client",
+                 fh, HA_MQTT_STOP_HEAP_BYTES);
+        esp_mqtt_client_stop(mqtt_client);
+        esp_mqtt_client_destroy(mqtt_client);
+        mqtt_client = NULL;
+        mqtt_connected = false;
       }
-      ha_light_task_wdt_reset_safe();
     }
-
-    // POLL: Check WiFi STA status periodically (every 5 seconds)
-    static uint32_t last_wifi_check = 0;
-    static uint32_t last_mqtt_retry_ms = 0;
-    uint32_t current_time_ms = esp_timer_get_time() / 1000;
-    if (current_time_ms - last_wifi_check >= 5000) {
-      bool wifi_connected = ha_light_check_wifi_sta_connected();
-      if (wifi_connected && sta_connected && mqtt_client != NULL) {
-        size_t fh = esp_get_free_heap_size();
-        if (fh < HA_MQTT_STOP_HEAP_BYTES) {
-          ESP_LOGW(TAG,
-                   "[STAGING] MQTT stop: critical heap %zu B (<%d B) — release "
-                   "client",
-                   fh, HA_MQTT_STOP_HEAP_BYTES);
-          esp_mqtt_client_stop(mqtt_client);
-          esp_mqtt_client_destroy(mqtt_client);
-          mqtt_client = NULL;
-          mqtt_connected = false;
-        }
-      }
-      if (wifi_connected && !sta_connected) {
-        sta_connected = true;
-        ESP_LOGI(TAG, "WiFi STA connected - initializing MQTT");
+    if (wifi_connected && !sta_connected) {
+      sta_connected = true;
+      ESP_LOGI(TAG, "WiFi STA connected - initializing MQTT");
+      ha_light_task_wdt_reset_safe();
+      ha_light_init_mqtt();
+    } else if (wifi_connected && sta_connected && mqtt_client == NULL) {
+      /* Opakovat po uvolnění heap; při NO_MEM nečastěji než 1×/30 s (šetří
+       * CPU a WDT) */
+      if (current_time_ms - last_mqtt_retry_ms >= 30000) {
+        last_mqtt_retry_ms = current_time_ms;
         ha_light_task_wdt_reset_safe();
-        ha_light_init_mqtt();
-      } else if (wifi_connected && sta_connected && mqtt_client == NULL) {
-        /* Opakovat po uvolnění heap; při NO_MEM nečastěji než 1×/30 s (šetří
-         * CPU a WDT) */
-        if (current_time_ms - last_mqtt_retry_ms >= 30000) {
-          last_mqtt_retry_ms = current_time_ms;
-          ha_light_task_wdt_reset_safe();
-          esp_err_t mr = ha_light_init_mqtt();
-          if (mr == ESP_ERR_NO_MEM) {
-            ESP_LOGW(TAG, "MQTT retry skipped/low heap: free=%zu B",
-                     (size_t)esp_get_free_heap_size());
-          }
-        }
-      } else if (!wifi_connected && sta_connected) {
-        // WiFi disconnected
-        sta_connected = false;
-        mqtt_connected = false; // Just mark disconnected, don't destroy client
-                                // to avoid complex cleanup
-        ESP_LOGI(TAG, "WiFi STA disconnected - MQTT unavailable");
-        if (current_mode == HA_MODE_HA) {
-          // Switch back to game mode
-          ha_light_switch_to_game_mode();
+        esp_err_t mr = ha_light_init_mqtt();
+        if (mr == ESP_ERR_NO_MEM) {
+          ESP_LOGW(TAG, "MQTT retry skipped/low heap: free=%zu B",
+                   (size_t)esp_get_free_heap_size());
         }
       }
-      last_wifi_check = current_time_ms;
+    } else if (!wifi_connected && sta_connected) {
+      // WiFi disconnected
+      sta_connected = false;
+      mqtt_connected = false; // Just mark disconnected, don't destroy client
+                              // to avoid complex cleanup
+      ESP_LOGI(TAG, "WiFi STA disconnected - MQTT unavailable");
+      if (current_mode == HA_MODE_HA) {
+        // Switch back to game mode
+        ha_light_switch_to_game_mode();
+      }
     }
+    last_wifi_check = current_time_ms;
+  }
 
-    // Monitor game activity (checks queues for activity)
-    ha_light_monitor_game_activity();
-
-    // Check activity timeout (5 minutes or value that is set in ap or web)
-    ha_light_check_activity_timeout();
-
-    // Periodically publish state (every 30 seconds)
-    static uint32_t last_state_publish = 0;
-    if (mqtt_connected && (current_time_ms - last_state_publish >= 30000)) {
-      ha_light_publish_state();
-      last_state_publish = current_time_ms;
-
-      // Periodically enforce "online" status (every 60s) to fix "Unknown"
-      // status issues
-      static uint32_t last_avail_publish = 0;
-      if (current_time_ms - last_avail_publish >= 60000) {
-        esp_mqtt_client_publish(mqtt_client, HA_TOPIC_LIGHT_AVAILABILITY,
-                                HA_MQTT_PAYLOAD_ONLINE, 0, 1, 1);
-        last_avail_publish = current_time_ms;
-      }
+  // Monitor game activity (checks queues for activity)
+  ha_light_monitor_game_activity();
+
+  // Check activity timeout (5 minutes or value that is set in ap or web)
+  ha_light_check_activity_timeout();
+
+  // Periodically publish state (every 30 seconds)
+  static uint32_t last_state_publish = 0;
+  if (mqtt_connected && (current_time_ms - last_state_publish >= 30000)) {
+    ha_light_publish_state();
+    last_state_publish = current_time_ms;
+
+    // Periodically enforce "online" status (every 60s) to fix "Unknown"
+    // status issues
+    static uint32_t last_avail_publish = 0;
+    if (current_time_ms - last_avail_publish >= 60000) {
+      esp_mqtt_client_publish(mqtt_client, HA_TOPIC_LIGHT_AVAILABILITY,
+                              HA_MQTT_PAYLOAD_ONLINE, 0, 1, 1);
+      last_avail_publish = current_time_ms;
     }
+  }
+
+  return HA_LIGHT_JOB_PERIOD_MS;
+}
+
+/**
+ * @brief Inicializace HA Light a registrace jobu v service tasku
+ */
+esp_err_t ha_light_start(void) {
+  ESP_LOGI(TAG, "Starting HA Light job...");
+
+  current_mode = HA_MODE_GAME;
+  last_activity_time_ms = esp_timer_get_time() / 1000;
 
-    // Minimal yield not needed because xQueueReceive handles waiting
+  ha_light_state_mutex = xSemaphoreCreateMutex();
+  if (ha_light_state_mutex == NULL) {
+    ESP_LOGE(TAG, "Failed to create ha_light_state mutex");
   }
+
+  ha_light_cmd_queue = xQueueCreate(10, sizeof(ha_light_command_t));
+  if (ha_light_cmd_queue == NULL) {
+    ESP_LOGE(TAG, "Failed to create HA command queue");
+  }
+
+  lamp_nvs_load();
+
+  task_running = true;
+  return svc_job_register("ha_light", ha_light_job_step, NULL, 0,
+                          &s_ha_light_job);
 }
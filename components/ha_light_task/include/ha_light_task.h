@@ -132,11 +132,14 @@ esp_err_t ha_light_set_activity_timeout_sec(uint32_t sec);
 // ============================================================================
 
 /**
- * @brief Spusti HA Light task
+ * @brief Inicializuje HA Light a zaregistruje jeho job v service tasku
  *
- * @param pvParameters Parametry tasku (nepouzivane)
+ * Vytvori frontu prikazu a mutex stavu, nacte lampu z NVS. MQTT se
+ * inicializuje az v jobu po pripojeni WiFi STA.
+ *
+ * @return ESP_OK, jinak chyba svc_job_register
  */
-void ha_light_task_start(void *pvParameters);
+esp_err_t ha_light_start(void);
 
 /**
  * @brief Ziskej aktualni rezim
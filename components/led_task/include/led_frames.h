@@ -0,0 +1,168 @@
+/**
+ * @file led_frames.h
+ * @brief Cisty renderer LED snimku (bez FreeRTOS / ESP-IDF zavislosti)
+ *
+ * Tento modul pocita jednotlive snimky LED animaci do pametoveho
+ * framebufferu 8x8 + 9 tlacitek. Neobsahuje zadne cekani, mutexy ani
+ * pristup k hardwaru - firmware snimek pouze "vyblituje" pres
+ * led_set_pixel_safe(), host simulator (tools/led_sim) ho vykresli
+ * do ANSI/PNG a porovna s referencnimi snimky.
+ *
+ * @author Alfred Krutina
+ * @version 1.8.0
+ * @date 2026-10-18
+ *
+ * @details
+ * Pravidla modulu:
+ * - Vystup je deterministicky: stejne vstupy = stejny snimek
+ *   (zadne esp_timer_get_time(), zadne static frame_countery).
+ * - Cas/progres animace predava volajici (cislo snimku nebo ms).
+ * - Stav sachovnice se predava jako pole 64 piece_t kodu
+ *   (0 = prazdne, 1-6 bile, 7-12 cerne), index = row * 8 + col.
+ * - Indexy LED odpovidaji serpentine layoutu z led_mapping.h.
+ */
+
+#ifndef LED_FRAMES_H
+#define LED_FRAMES_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ============================================================================
+// KONSTANTY
+// ============================================================================
+
+/** @brief Pocet LED sachovnice (8x8) */
+#define LED_FRAME_BOARD_COUNT 64
+/** @brief Pocet LED tlacitek (8 promotion + reset) */
+#define LED_FRAME_BUTTON_COUNT 9
+/** @brief Celkovy pocet LED ve snimku (musi odpovidat CHESS_LED_COUNT_TOTAL) */
+#define LED_FRAME_LED_COUNT (LED_FRAME_BOARD_COUNT + LED_FRAME_BUTTON_COUNT)
+
+/** @brief Pocet snimku pohybove faze rosady */
+#define LED_FRAME_CASTLE_MOVE_FRAMES 15
+/** @brief Pocet snimku zaverecneho zablesku rosady */
+#define LED_FRAME_CASTLE_BURST_FRAMES 3
+/** @brief Celkovy pocet snimku rosady */
+#define LED_FRAME_CASTLE_TOTAL_FRAMES                                          \
+  (LED_FRAME_CASTLE_MOVE_FRAMES + LED_FRAME_CASTLE_BURST_FRAMES)
+
+/** @brief Delka promotion animace v ms (4 faze) */
+#define LED_FRAME_PROMOTION_DURATION_MS 3000
+/** @brief Maximalni polomer endgame vlny (pak se vlna opakuje od 1) */
+#define LED_FRAME_ENDGAME_MAX_RADIUS 14
+
+/** @brief Barva sachu (ruzova) */
+#define LED_FRAME_COLOR_CHECK 0xFFC0CBu
+
+// ============================================================================
+// DATOVE TYPY
+// ============================================================================
+
+/**
+ * @brief LED snimek - 0xRRGGBB pro kazdou LED (0-63 deska, 64-72 tlacitka)
+ */
+typedef struct {
+  uint32_t px[LED_FRAME_LED_COUNT];
+} led_frame_t;
+
+// ============================================================================
+// ZAKLADNI OPERACE
+// ============================================================================
+
+/**
+ * @brief Vynuluje cely snimek (deska i tlacitka)
+ * @param frame Cilovy snimek
+ */
+void led_frame_clear(led_frame_t *frame);
+
+/**
+ * @brief Vynuluje jen LED sachovnice (0-63), tlacitka zachova
+ * @param frame Cilovy snimek
+ */
+void led_frame_clear_board(led_frame_t *frame);
+
+/**
+ * @brief Nastavi jednu LED (mimo rozsah se ignoruje)
+ * @param frame Cilovy snimek
+ * @param led_index LED index (0-72)
+ * @param r Cervena
+ * @param g Zelena
+ * @param b Modra
+ */
+void led_frame_set(led_frame_t *frame, int led_index, uint8_t r, uint8_t g,
+                   uint8_t b);
+
+// ============================================================================
+// ANIMACE
+// ============================================================================
+
+/**
+ * @brief Sach - staticka ruzova LED na pozici krale (preklada se pres snimek)
+ * @param frame Cilovy snimek
+ * @param king_led LED index krale
+ */
+void led_frame_render_check(led_frame_t *frame, uint8_t king_led);
+
+/**
+ * @brief Jeden snimek animace rosady (kral + vez se stopou)
+ *
+ * Snimky 0..LED_FRAME_CASTLE_MOVE_FRAMES-1 jsou pohyb, dalsi
+ * LED_FRAME_CASTLE_BURST_FRAMES snimku je zablesk na cilovych polich.
+ * Deska se pred kreslenim vzdy maze.
+ *
+ * @param frame Cilovy snimek
+ * @param king_from LED index krale pred rosadou
+ * @param king_to LED index krale po rosade
+ * @param frame_index Cislo snimku (0..LED_FRAME_CASTLE_TOTAL_FRAMES-1)
+ * @return false pokud jsou indexy neplatne nebo frame_index mimo rozsah
+ */
+bool led_frame_render_castle(led_frame_t *frame, uint8_t king_from,
+                             uint8_t king_to, int frame_index);
+
+/**
+ * @brief Jeden snimek promotion animace (4 faze po 750 ms)
+ *
+ * @param frame Cilovy snimek
+ * @param promotion_led LED index promotovane figurky
+ * @param elapsed_ms Cas od startu animace
+ * @param frame_counter Pocitadlo aktualizaci (pulzovani / duhovy zablesk)
+ * @return false pokud animace skoncila (snimek = prazdna deska)
+ */
+bool led_frame_render_promotion(led_frame_t *frame, uint8_t promotion_led,
+                                uint32_t elapsed_ms, uint32_t frame_counter);
+
+/**
+ * @brief Jeden krok endgame vlny kolem vitezneho krale
+ *
+ * Barvy: soupere cervene, vlastni figurky zelene, prazdna pole modre,
+ * vitezny kral zlaty.
+ *
+ * @param frame Cilovy snimek
+ * @param board 64 piece_t kodu (row * 8 + col)
+ * @param win_king_led LED index vitezneho krale
+ * @param radius Aktualni polomer vlny (1..LED_FRAME_ENDGAME_MAX_RADIUS)
+ */
+void led_frame_render_endgame_wave(led_frame_t *frame, const uint8_t *board,
+                                   uint8_t win_king_led, uint8_t radius);
+
+/**
+ * @brief Jeden snimek navadeci animace (modre pulzovani na polich)
+ *
+ * @param frame Cilovy snimek
+ * @param leds Pole LED indexu k navadeni
+ * @param count Pocet LED
+ * @param progress Progres animace 0.0-1.0
+ */
+void led_frame_render_guidance(led_frame_t *frame, const uint8_t *leds,
+                               uint8_t count, float progress);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LED_FRAMES_H
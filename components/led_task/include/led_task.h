@@ -26,6 +26,7 @@
 
 #include "esp_err.h"
 #include "freertos_chess.h"
+#include "led_frames.h"
 #include <stdbool.h>
 #include <stdint.h>
 
@@ -210,6 +211,17 @@ void led_start_quiet_period(uint32_t duration_ms);
 void led_set_pixel_safe(uint8_t led_index, uint8_t red, uint8_t green,
                         uint8_t blue);
 
+/**
+ * @brief Zapis rozsah LED ze snimku vykresleneho pres led_frames.h
+ *
+ * Kazda LED jde pres led_set_pixel_safe() (batch system, boot guard).
+ *
+ * @param frame Snimek z led_frame_render_*()
+ * @param first Prvni LED index
+ * @param count Pocet LED (orizne se na LED_FRAME_LED_COUNT)
+ */
+void led_apply_frame(const led_frame_t *frame, uint8_t first, uint8_t count);
+
 /**
  * @brief Vymaz vsechny LED (thread-safe s mutex)
  */
@@ -229,6 +241,18 @@ void led_set_all_safe(uint8_t red, uint8_t green, uint8_t blue);
  */
 void led_force_immediate_update(void);
 
+/**
+ * @brief Ukaze pixely zapsane game taskem hned (vzbudi LED task)
+ *
+ * Game task zapisuje pixely bez led_unified_mutex do SPSC ringu; LED task
+ * je aplikuje na zacatku snimku (33 ms). Volat po davce zmen, ne po pixelu.
+ * Z jineho tasku nedela nic.
+ */
+void led_pixels_flush(void);
+
+/** @brief Statistiky ringu pixelu game -> LED (vypis front) */
+void led_pixel_ring_get_stats(spsc_ring_stats_t *out);
+
 // ============================================================================
 // FUNKCE PRO SPRAVU LED VRSTEV
 // ============================================================================
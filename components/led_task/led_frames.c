@@ -0,0 +1,290 @@
+/**
+ * @file led_frames.c
+ * @brief Cisty renderer LED snimku - implementace
+ *
+ * Matematika animaci (rosada, promoce, endgame vlna, navadeni, sach)
+ * vytazena z led_task.c a unified_animation_manager.c do funkci, ktere
+ * jen zapisuji do led_frame_t. Firmware i host simulator tak kresli
+ * identicke snimky.
+ *
+ * @author Alfred Krutina
+ * @version 1.8.0
+ * @date 2026-10-18
+ *
+ * @note Soubor nesmi includovat nic z ESP-IDF ani FreeRTOS - preklada se
+ *       i na Linuxu (tools/led_sim).
+ */
+
+#include "led_frames.h"
+#include "led_mapping.h"
+
+#include <math.h>
+#include <string.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// piece_t kody (viz chess_types.h) - zde bez FreeRTOS hlavicek
+#define LED_FRAME_PIECE_EMPTY 0
+#define LED_FRAME_PIECE_WHITE_PAWN 1
+#define LED_FRAME_PIECE_WHITE_KING 6
+#define LED_FRAME_PIECE_BLACK_PAWN 7
+#define LED_FRAME_PIECE_BLACK_KING 12
+
+// ============================================================================
+// ZAKLADNI OPERACE
+// ============================================================================
+
+void led_frame_clear(led_frame_t *frame) {
+  if (frame)
+    memset(frame->px, 0, sizeof(frame->px));
+}
+
+void led_frame_clear_board(led_frame_t *frame) {
+  if (frame)
+    memset(frame->px, 0, LED_FRAME_BOARD_COUNT * sizeof(frame->px[0]));
+}
+
+void led_frame_set(led_frame_t *frame, int led_index, uint8_t r, uint8_t g,
+                   uint8_t b) {
+  if (!frame || led_index < 0 || led_index >= LED_FRAME_LED_COUNT)
+    return;
+  frame->px[led_index] = ((uint32_t)r << 16) | ((uint32_t)g << 8) | b;
+}
+
+// ============================================================================
+// SACH
+// ============================================================================
+
+void led_frame_render_check(led_frame_t *frame, uint8_t king_led) {
+  if (!frame || king_led >= LED_FRAME_BOARD_COUNT)
+    return;
+  frame->px[king_led] = LED_FRAME_COLOR_CHECK;
+}
+
+// ============================================================================
+// ROSADA
+// ============================================================================
+
+bool led_frame_render_castle(led_frame_t *frame, uint8_t king_from,
+                             uint8_t king_to, int frame_index) {
+  if (!frame || frame_index < 0 ||
+      frame_index >= LED_FRAME_CASTLE_TOTAL_FRAMES)
+    return false;
+
+  // Pozice veze podle smeru rosady
+  uint8_t rook_from, rook_to;
+  if (king_to > king_from) {
+    rook_from = king_from + 3; // h1 / h8
+    rook_to = king_from + 1;   // f1 / f8
+  } else {
+    rook_from = king_from - 4; // a1 / a8
+    rook_to = king_from - 1;   // d1 / d8
+  }
+  if (rook_from >= 64)
+    rook_from = 63;
+  if (rook_to >= 64)
+    rook_to = 63;
+  if (king_from >= 64 || king_to >= 64)
+    return false;
+
+  led_frame_clear_board(frame);
+
+  if (frame_index >= LED_FRAME_CASTLE_MOVE_FRAMES) {
+    // Zaverecny zablesk na cilovych polich
+    int burst = frame_index - LED_FRAME_CASTLE_MOVE_FRAMES;
+    float brightness = 0.5f + 0.5f * sin(burst * 2.09f);
+    led_frame_set(frame, king_to, (uint8_t)(255 * brightness),
+                  (uint8_t)(215 * brightness), 0);
+    led_frame_set(frame, rook_to, (uint8_t)(192 * brightness),
+                  (uint8_t)(192 * brightness), (uint8_t)(192 * brightness));
+    return true;
+  }
+
+  float progress = (float)frame_index / 14.0f;
+
+  // Stopa o 4 bodech pro krale i vez
+  for (int trail = 0; trail < 4; trail++) {
+    float trail_progress = progress - (trail * 0.15f);
+    if (trail_progress < 0)
+      continue;
+    if (trail_progress > 1)
+      break;
+
+    float eased_progress =
+        trail_progress * trail_progress * (3.0f - 2.0f * trail_progress);
+    uint8_t king_current = king_from + (king_to - king_from) * eased_progress;
+    uint8_t rook_current = rook_from + (rook_to - rook_from) * eased_progress;
+
+    // Kral zlaty, vez stribrna - obe pulzuji
+    float king_pulse = 0.8f + 0.2f * sin(progress * 6.28f + trail * 1.57f);
+    float rook_pulse = 0.7f + 0.3f * sin(progress * 6.28f + trail * 2.09f);
+    float trail_brightness = 1.0f - (trail * 0.2f);
+
+    uint8_t king_red = (uint8_t)(255 * king_pulse);
+    uint8_t king_green = (uint8_t)(215 * king_pulse);
+    uint8_t rook_grey = (uint8_t)(192 * rook_pulse);
+
+    led_frame_set(frame, king_current, (uint8_t)(king_red * trail_brightness),
+                  (uint8_t)(king_green * trail_brightness), 0);
+    led_frame_set(frame, rook_current, (uint8_t)(rook_grey * trail_brightness),
+                  (uint8_t)(rook_grey * trail_brightness),
+                  (uint8_t)(rook_grey * trail_brightness));
+  }
+  return true;
+}
+
+// ============================================================================
+// PROMOCE
+// ============================================================================
+
+bool led_frame_render_promotion(led_frame_t *frame, uint8_t promotion_led,
+                                uint32_t elapsed_ms, uint32_t frame_counter) {
+  if (!frame)
+    return false;
+
+  led_frame_clear_board(frame);
+
+  uint32_t stage = elapsed_ms / (LED_FRAME_PROMOTION_DURATION_MS / 4);
+  if (stage >= 4 || promotion_led >= LED_FRAME_BOARD_COUNT)
+    return false;
+
+  switch (stage) {
+  case 0:
+    // Faze 1: pesec (bila)
+    led_frame_set(frame, promotion_led, 255, 255, 255);
+    break;
+  case 1: {
+    // Faze 2: transformace (pulzovani)
+    float brightness = 0.5f + 0.5f * sinf(frame_counter * 0.2f);
+    uint8_t color = (uint8_t)(255 * brightness);
+    led_frame_set(frame, promotion_led, color, color, color);
+    break;
+  }
+  case 2:
+    // Faze 3: promovana figurka (zlata)
+    led_frame_set(frame, promotion_led, 255, 215, 0);
+    break;
+  default: {
+    // Faze 4: duhovy zablesk se zarem okolo
+    uint32_t burst = (frame_counter / 4) % 8;
+    uint8_t r, g, b;
+    if (burst < 2) {
+      r = 255; g = 0; b = 0;
+    } else if (burst < 4) {
+      r = 255; g = 165; b = 0;
+    } else if (burst < 6) {
+      r = 255; g = 255; b = 0;
+    } else {
+      r = 0; g = 255; b = 0;
+    }
+
+    for (int offset = -1; offset <= 1; offset++) {
+      for (int offset2 = -1; offset2 <= 1; offset2++) {
+        if (offset == 0 && offset2 == 0)
+          continue;
+        int glow_row = (promotion_led / 8) + offset;
+        int glow_col = (promotion_led % 8) + offset2;
+        if (glow_row >= 0 && glow_row < 8 && glow_col >= 0 && glow_col < 8) {
+          uint8_t glow_led = chess_pos_to_led_index(glow_row, glow_col);
+          led_frame_set(frame, glow_led, (uint8_t)(r * 0.3f),
+                        (uint8_t)(g * 0.3f), (uint8_t)(b * 0.3f));
+        }
+      }
+    }
+    led_frame_set(frame, promotion_led, r, g, b);
+    break;
+  }
+  }
+  return true;
+}
+
+// ============================================================================
+// ENDGAME VLNA
+// ============================================================================
+
+void led_frame_render_endgame_wave(led_frame_t *frame, const uint8_t *board,
+                                   uint8_t win_king_led, uint8_t radius) {
+  const float WAVE_THICKNESS = 1.2f;
+  const int WAVE_LAYERS = 4;
+
+  if (!frame || !board || win_king_led >= LED_FRAME_BOARD_COUNT)
+    return;
+
+  led_frame_clear_board(frame);
+
+  uint8_t king_row, king_col;
+  led_index_to_chess_pos(win_king_led, &king_row, &king_col);
+  bool winner_is_white =
+      (board[king_row * 8 + king_col] == LED_FRAME_PIECE_WHITE_KING);
+
+  // Vice prekryvajicich se prstencu pro plynuly efekt
+  for (int ring = 0; ring < WAVE_LAYERS; ring++) {
+    float current_radius = radius - (ring * 0.3f);
+    if (current_radius < 0.2f)
+      continue;
+
+    for (int dy = -radius; dy <= radius; dy++) {
+      for (int dx = -radius; dx <= radius; dx++) {
+        float dist = sqrtf(dx * dx + dy * dy);
+        float ring_distance = fabsf(dist - current_radius);
+        if (ring_distance > WAVE_THICKNESS)
+          continue;
+
+        int row = king_row + dy;
+        int col = king_col + dx;
+        if (row < 0 || row >= 8 || col < 0 || col >= 8)
+          continue;
+
+        uint8_t square = chess_pos_to_led_index(row, col);
+        uint8_t piece = board[row * 8 + col];
+
+        float intensity = 1.0f - (ring_distance / WAVE_THICKNESS);
+        intensity = fmaxf(0.15f, intensity);
+
+        if (piece != LED_FRAME_PIECE_EMPTY) {
+          bool is_opponent_piece =
+              winner_is_white ? (piece >= LED_FRAME_PIECE_BLACK_PAWN &&
+                                 piece <= LED_FRAME_PIECE_BLACK_KING)
+                              : (piece >= LED_FRAME_PIECE_WHITE_PAWN &&
+                                 piece <= LED_FRAME_PIECE_WHITE_KING);
+          if (is_opponent_piece) {
+            led_frame_set(frame, square, (uint8_t)(255 * intensity),
+                          (uint8_t)(30 * intensity), (uint8_t)(30 * intensity));
+          } else {
+            led_frame_set(frame, square, (uint8_t)(30 * intensity),
+                          (uint8_t)(255 * intensity), (uint8_t)(80 * intensity));
+          }
+        } else {
+          led_frame_set(frame, square, (uint8_t)(30 * intensity),
+                        (uint8_t)(100 * intensity), (uint8_t)(255 * intensity));
+        }
+      }
+    }
+  }
+
+  // Vitezny kral vzdy zlaty
+  led_frame_set(frame, win_king_led, 255, 215, 0);
+}
+
+// ============================================================================
+// NAVADENI
+// ============================================================================
+
+void led_frame_render_guidance(led_frame_t *frame, const uint8_t *leds,
+                               uint8_t count, float progress) {
+  if (!frame || !leds)
+    return;
+
+  // Stejne pulzovani jako animation_update_pulsing (30 % - 100 %)
+  float pulse = (sinf(progress * 4.0f * M_PI) + 1.0f) / 2.0f;
+  float intensity = 0.3f + 0.7f * pulse;
+
+  for (uint8_t i = 0; i < count; i++) {
+    if (leds[i] >= LED_FRAME_BOARD_COUNT)
+      continue;
+    led_frame_set(frame, leds[i], 0, (uint8_t)(100 * intensity),
+                  (uint8_t)(255 * intensity));
+  }
+}
@@ -55,6 +55,13 @@
  * - led_highlight_square() -> Zvyrazni policko
  * - led_show_chess_board() -> Zobraz sachovnici
  *
+ * RING GAME -> LED (SPSC, bez zamku):
+ * - led_set_pixel_internal() z game tasku mutex nebere; zapis jde do
+ *   led_px_ring a LED task ho aplikuje na zacatku snimku
+ * - led_pixels_flush() po davce zmen probudi LED task hned
+ * - Primy zapis do led_states z game tasku (led_show_chess_board...)
+ *   nejdriv pocka na vyprazdneni ringu (led_px_ring_sync)
+ *
  * MUTEXY - Ochrana sdilenych zdroju:
  * - led_unified_mutex -> Ochrana LED stavu (led_states[])
  *   DULEZITE: Vzdy pouzij pri zmene LED!
@@ -174,7 +181,7 @@
  */
 
 #include "led_task.h"
-#include "../config_manager/include/config_manager.h"
+#include "../config_manager/include/config_registry.h"
 #include "../freertos_chess/include/chess_types.h"
 #include "../freertos_chess/include/streaming_output.h"
 #include "../game_task/include/game_task.h" // For game_get_piece() function
@@ -211,6 +218,9 @@
 
 static const char *TAG = "LED_TASK";
 
+_Static_assert(LED_FRAME_LED_COUNT == CHESS_LED_COUNT_TOTAL,
+               "led_frame_t musi pokryt vsechny LED");
+
 // ============================================================================
 // WDT WRAPPER FUNCTIONS
 // ============================================================================
@@ -261,6 +271,9 @@ static esp_err_t led_task_wdt_reset_safe(void) {
   50 // Batch commit interval for optimal performance
 #define LED_WATCHDOG_RESET_INTERVAL                                            \
   10 // Reset watchdog every N LEDs during batch update
+#define LED_FRAME_PERIOD_MS 33 // LED task frame (30 FPS)
+#define LED_PX_RING_SIZE 256   // Game -> LED pixel ring (3.5 board frames)
+#define LED_PX_PUSH_TIMEOUT_MS 50 // Full ring: wait for LED task, then drop
 
 // ============================================================================
 // LED DURATION MANAGEMENT SYSTEM - NOVÝ PRO ŘEŠENÍ DURATION PROBLÉMU
@@ -389,6 +402,13 @@ static bool led_initialized = false;
 // LED synchronization - BATCH UPDATE SYSTEM
 static SemaphoreHandle_t led_unified_mutex = NULL; // Queue synchronization only
 
+// GAME -> LED PIXEL RING - game task (prio 4) nezamyka led_unified_mutex,
+// ktery LED task (prio 7) drzi pres refresh pasku. Polozka = index << 24 |
+// RGB; LED task ring vyprazdni pod mutexem na zacatku snimku.
+static spsc_ring_t led_px_ring;
+static uint32_t led_px_ring_buf[LED_PX_RING_SIZE];
+static volatile bool led_px_ring_ready = false;
+
 // BATCH UPDATE SYSTEM - Collect changes, then commit atomically
 static bool led_changes_pending = false; // Flag indicating pending changes
 static uint32_t
@@ -501,6 +521,14 @@ void led_set_brightness_global(uint8_t brightness) {
   }
 }
 
+/** Jas zmeneny v config_registry (web, BLE) — aplikuje se hned, NVS na pozadi. */
+static void led_config_changed(uint32_t changed, const config_snapshot_t *snap,
+                               void *ctx) {
+  (void)changed;
+  (void)ctx;
+  led_set_brightness_global(snap->system.brightness_level);
+}
+
 /**
  * @brief Map button ID to correct LED index
  * @param button_id Button ID (0-8)
@@ -516,6 +544,70 @@ static uint8_t led_get_button_led_index(uint8_t button_id) {
   }
 }
 
+/** Zapis jednoho pixelu do stavu a batch bufferu (volajici drzi mutex). */
+static void led_px_apply(uint8_t led_index, uint32_t color) {
+  // Update internal state
+  led_states[led_index] = color;
+
+  // Mark change as pending for next batch commit
+  if (led_initialized && led_strip != NULL && !simulation_mode) {
+    led_pending_changes[led_index] = color;
+    led_changed_flags[led_index] = true; // Mark this LED as changed
+    led_changes_pending = true;
+  }
+}
+
+/** Volajici je game task a LED task uz ring cte. */
+static bool led_px_from_game_task(void) {
+  return led_px_ring_ready && game_task_handle != NULL &&
+         xTaskGetCurrentTaskHandle() == game_task_handle;
+}
+
+/** LED task: aplikuje pixely z ringu (jeden take mutexu na davku). */
+static void led_px_ring_drain(void) {
+  if (spsc_ring_count(&led_px_ring) == 0) {
+    return;
+  }
+  if (led_unified_mutex != NULL &&
+      xSemaphoreTake(led_unified_mutex, LED_TASK_MUTEX_TIMEOUT_TICKS) !=
+          pdTRUE) {
+    return; // Zustane v ringu do dalsiho snimku
+  }
+  uint32_t entry;
+  while (spsc_ring_pop(&led_px_ring, &entry)) {
+    led_px_apply((uint8_t)(entry >> 24), entry & 0xFFFFFF);
+  }
+  if (led_unified_mutex != NULL) {
+    xSemaphoreGive(led_unified_mutex);
+  }
+}
+
+/**
+ * Game task pred primym zapisem do led_states (mimo ring) pocka, az LED task
+ * ring vyprazdni — jinak by starsi pixely z ringu prepsaly novejsi stav.
+ */
+static void led_px_ring_sync(void) {
+  if (!led_px_from_game_task()) {
+    return;
+  }
+  TickType_t start = xTaskGetTickCount();
+  while (spsc_ring_count(&led_px_ring) > 0 &&
+         xTaskGetTickCount() - start < pdMS_TO_TICKS(LED_PX_PUSH_TIMEOUT_MS)) {
+    spsc_ring_notify(&led_px_ring);
+    vTaskDelay(1);
+  }
+}
+
+void led_pixels_flush(void) {
+  if (led_px_from_game_task() && spsc_ring_count(&led_px_ring) > 0) {
+    spsc_ring_notify(&led_px_ring);
+  }
+}
+
+void led_pixel_ring_get_stats(spsc_ring_stats_t *out) {
+  spsc_ring_get_stats(&led_px_ring, out);
+}
+
 void led_set_pixel_internal(uint8_t led_index, uint8_t red, uint8_t green,
                             uint8_t blue) {
   if (led_index >= CHESS_LED_COUNT_TOTAL) {
@@ -543,37 +635,38 @@ void led_set_pixel_internal(uint8_t led_index, uint8_t red, uint8_t green,
     }
   }
 
-  // Unified mutex protection
-  if (led_unified_mutex != NULL) {
-    if (xSemaphoreTake(led_unified_mutex, LED_TASK_MUTEX_TIMEOUT_TICKS) !=
-        pdTRUE) {
-      ESP_LOGW(TAG,
-               "Failed to take LED unified mutex - skipping LED operation");
-      return;
-    }
-  }
-
   // BATCH UPDATE SYSTEM - Just collect change, don't commit immediately
   uint32_t color = (red << 16) | (green << 8) | blue;
 
-  // Update internal state
-  led_states[led_index] = color;
+  if (led_px_from_game_task()) {
+    // Game task: bez mutexu, poradi zapisu drzi ring
+    uint32_t entry = ((uint32_t)led_index << 24) | color;
+    if (!spsc_ring_push_wait(&led_px_ring, &entry,
+                             pdMS_TO_TICKS(LED_PX_PUSH_TIMEOUT_MS))) {
+      ESP_LOGD(TAG, "Pixel ring full - LED %d update dropped", led_index);
+    }
+  } else {
+    // Unified mutex protection
+    if (led_unified_mutex != NULL) {
+      if (xSemaphoreTake(led_unified_mutex, LED_TASK_MUTEX_TIMEOUT_TICKS) !=
+          pdTRUE) {
+        ESP_LOGW(TAG,
+                 "Failed to take LED unified mutex - skipping LED operation");
+        return;
+      }
+    }
 
-  // Mark change as pending for next batch commit
-  if (led_initialized && led_strip != NULL && !simulation_mode) {
-    led_pending_changes[led_index] = color;
-    led_changed_flags[led_index] = true; // Mark this LED as changed
-    led_changes_pending = true;
+    led_px_apply(led_index, color);
+
+    // Release unified mutex
+    if (led_unified_mutex != NULL) {
+      xSemaphoreGive(led_unified_mutex);
+    }
   }
 
   if (simulation_mode) {
     ESP_LOGI(TAG, "LED[%d] = RGB(%d,%d,%d) = 0x%06" PRIX32, led_index, red, green,
-             blue, led_states[led_index]);
-  }
-
-  // Release unified mutex
-  if (led_unified_mutex != NULL) {
-    xSemaphoreGive(led_unified_mutex);
+             blue, color);
   }
 }
 
@@ -628,6 +721,7 @@ void led_clear_all_internal(void) {
 
 void led_show_chess_board(void) {
   ESP_LOGI(TAG, "🔄 Setting chess board pattern...");
+  led_px_ring_sync();
 
   // Apply chess board pattern to board LEDs (0-63)
   for (int i = 0; i < 64; i++) {
@@ -997,6 +1091,7 @@ void led_execute_command_new(const led_command_t *cmd) {
     return;
   }
   ESP_LOGI(TAG, "🔄 led_execute_command_new: type=%d", cmd->type);
+  led_px_ring_sync();
   switch (cmd->type) {
   case LED_CMD_SET_PIXEL:
     // Podporovat duration management
@@ -2000,16 +2095,21 @@ void led_task_start(void *pvParameters) {
   }
   ESP_LOGI(TAG, "✅ LED unified mutex created");
 
-  // Load brightness from NVS
-  system_config_t config;
-  if (config_load_from_nvs(&config) == ESP_OK) {
-    global_brightness = config.brightness_level;
-    ESP_LOGI(TAG, "Loaded global brightness from NVS: %d%%", global_brightness);
-  } else {
-    global_brightness = 50; // Default
-    ESP_LOGI(TAG, "Using default brightness: 50%%");
+  // Ring pixelu z game tasku (konzument = tento task, viz led_px_ring_drain)
+  if (spsc_ring_init(&led_px_ring, led_px_ring_buf, sizeof(uint32_t),
+                     LED_PX_RING_SIZE) == ESP_OK) {
+    spsc_ring_set_consumer(&led_px_ring, led_task_handle);
+    led_px_ring_ready = true;
   }
 
+  // Jas z config_registry (nacteno z NVS pri bootu), dalsi zmeny pres listener
+  global_brightness = config_get_brightness();
+  if (config_registry_subscribe(CONFIG_FIELD_BRIGHTNESS, led_config_changed,
+                                NULL) != ESP_OK) {
+    ESP_LOGW(TAG, "Brightness listener not registered");
+  }
+  ESP_LOGI(TAG, "Global brightness: %d%%", global_brightness);
+
   // Initialize duration management system
   led_init_duration_system();
 
@@ -2055,6 +2155,9 @@ void led_task_start(void *pvParameters) {
     // Process LED commands from queue
     led_process_commands();
 
+    // Pixely z game tasku (poradi zachovane ringem)
+    led_px_ring_drain();
+
     // Update animations
     led_update_animation();
 
@@ -2081,8 +2184,18 @@ void led_task_start(void *pvParameters) {
 
     loop_count++;
 
-    // Optimalizovaný cyklus - 33ms pro 30 FPS animace
-    vTaskDelayUntil(&last_wake_time, pdMS_TO_TICKS(33));
+    // Optimalizovaný cyklus - 33ms pro 30 FPS animace. led_pixels_flush()
+    // z game tasku probudi task driv: jen ring + commit, snimek bezi dal.
+    TickType_t next_frame = last_wake_time + pdMS_TO_TICKS(LED_FRAME_PERIOD_MS);
+    for (;;) {
+      int32_t left = (int32_t)(next_frame - xTaskGetTickCount());
+      if (left <= 0 || ulTaskNotifyTake(pdTRUE, (TickType_t)left) == 0) {
+        break;
+      }
+      led_px_ring_drain();
+      led_privileged_batch_commit();
+    }
+    last_wake_time = next_frame;
   }
 }
 
@@ -2318,96 +2431,18 @@ void led_anim_castle(const led_command_t *cmd) {
   uint8_t king_from = cmd->led_index;
   uint8_t king_to = (cmd->data ? *((uint8_t *)cmd->data) : king_from + 2);
 
-  // Calculate rook positions based on castling direction
-  uint8_t rook_from, rook_to;
-  if (king_to > king_from) {
-    // Kingside castling - rook moves from h to f
-    rook_from = king_from + 3; // h1 or h8
-    rook_to = king_from + 1;   // f1 or f8
-  } else {
-    // Queenside castling - rook moves from a to d
-    rook_from = king_from - 4; // a1 or a8
-    rook_to = king_from - 1;   // d1 or d8
-  }
-
-  // ED: Ensure valid LED indices
-  if (rook_from >= 64)
-    rook_from = 63;
-  if (rook_to >= 64)
-    rook_to = 63;
-
-  // Validate LED indices
-  if (king_from >= 64 || king_to >= 64 || rook_from >= 64 || rook_to >= 64) {
-    ESP_LOGE(TAG,
-             "❌ Invalid LED indices: king_from=%d, king_to=%d, rook_from=%d, "
-             "rook_to=%d",
-             king_from, king_to, rook_from, rook_to);
-    return;
-  }
-
-  // ENHANCED: Multi-point trail animation with brightness effects
-  for (int frame = 0; frame < 15; frame++) {
-    led_clear_board_only();
-
-    float progress = (float)frame / 14.0f;
-
-    // Create trail effect for both pieces
-    for (int trail = 0; trail < 4; trail++) {
-      float trail_progress = progress - (trail * 0.15f);
-      if (trail_progress < 0)
-        continue;
-      if (trail_progress > 1)
-        break;
-
-      // King animation with smooth easing
-      float eased_progress =
-          trail_progress * trail_progress * (3.0f - 2.0f * trail_progress);
-      uint8_t king_current = king_from + (king_to - king_from) * eased_progress;
-
-      // Rook animation with smooth easing
-      uint8_t rook_current = rook_from + (rook_to - rook_from) * eased_progress;
-
-      // King color: Gold with pulsing effect
-      float king_pulse = 0.8f + 0.2f * sin(progress * 6.28f + trail * 1.57f);
-      uint8_t king_red = (uint8_t)(255 * king_pulse);
-      uint8_t king_green = (uint8_t)(215 * king_pulse);
-      uint8_t king_blue = (uint8_t)(0 * king_pulse);
-
-      // Rook color: Silver with pulsing effect
-      float rook_pulse = 0.7f + 0.3f * sin(progress * 6.28f + trail * 2.09f);
-      uint8_t rook_red = (uint8_t)(192 * rook_pulse);
-      uint8_t rook_green = (uint8_t)(192 * rook_pulse);
-      uint8_t rook_blue = (uint8_t)(192 * rook_pulse);
-
-      // Trail brightness effect
-      float trail_brightness = 1.0f - (trail * 0.2f);
-      king_red = (uint8_t)(king_red * trail_brightness);
-      king_green = (uint8_t)(king_green * trail_brightness);
-      king_blue = (uint8_t)(king_blue * trail_brightness);
-
-      rook_red = (uint8_t)(rook_red * trail_brightness);
-      rook_green = (uint8_t)(rook_green * trail_brightness);
-      rook_blue = (uint8_t)(rook_blue * trail_brightness);
-
-      led_set_pixel_safe(king_current, king_red, king_green, king_blue);
-      led_set_pixel_safe(rook_current, rook_red, rook_green, rook_blue);
+  // Snimky pocita led_frames.c (sdilene s host simulatorem tools/led_sim)
+  led_frame_t frame;
+  for (int i = 0; i < LED_FRAME_CASTLE_TOTAL_FRAMES; i++) {
+    if (!led_frame_render_castle(&frame, king_from, king_to, i)) {
+      ESP_LOGE(TAG, "❌ Invalid castling LED indices: king_from=%d, king_to=%d",
+               king_from, king_to);
+      return;
     }
+    led_apply_frame(&frame, 0, LED_FRAME_BOARD_COUNT);
 
-    vTaskDelay(pdMS_TO_TICKS(60)); // Smooth animation
-  }
-
-  // Final highlight on destination squares
-  for (int burst = 0; burst < 3; burst++) {
-    led_clear_board_only();
-
-    float brightness = 0.5f + 0.5f * sin(burst * 2.09f);
-    led_set_pixel_safe(king_to, (uint8_t)(255 * brightness),
-                       (uint8_t)(215 * brightness), 0);
-    led_set_pixel_safe(rook_to, (uint8_t)(192 * brightness),
-                       (uint8_t)(192 * brightness),
-                       (uint8_t)(192 * brightness));
-
-    vTaskDelay(pdMS_TO_TICKS(100));
+    // Pohyb 60 ms/snimek, zaverecny zablesk 100 ms/snimek
+    vTaskDelay(pdMS_TO_TICKS(i < LED_FRAME_CASTLE_MOVE_FRAMES ? 60 : 100));
   }
 
   led_clear_board_only();
@@ -2610,9 +2645,6 @@ void led_update_endgame_wave(void) {
   }
 
   const uint32_t WAVE_STEP_MS = 100; // Pomalejší animace (100ms místo 30ms)
-  const uint8_t MAX_RADIUS = 14;     // Larger radius for better coverage
-  const float WAVE_THICKNESS = 1.2f; // Thinner waves for more precise effect
-  const int WAVE_LAYERS = 4;         // Fewer layers but with higher FPS
 
   // Check if it's time for next wave step
   if (xTaskGetTickCount() - endgame_wave.last_update <
@@ -2622,94 +2654,22 @@ void led_update_endgame_wave(void) {
 
   endgame_wave.last_update = xTaskGetTickCount();
 
-  // Clear board
-  led_clear_board_only();
-
-  // Use stored winner piece for reliable detection
-  piece_t winner_king = endgame_wave.winner_piece;
-  bool winner_is_white = (winner_king == PIECE_WHITE_KING);
-
-  // Draw multiple overlapping wave rings for ultra-smooth effect
-  for (int ring = 0; ring < WAVE_LAYERS; ring++) {
-    float current_radius = endgame_wave.radius - (ring * 0.3f);
-    if (current_radius < 0.2f)
-      continue;
-
-    for (int dy = -endgame_wave.radius; dy <= endgame_wave.radius; dy++) {
-      for (int dx = -endgame_wave.radius; dx <= endgame_wave.radius; dx++) {
-        // Calculate distance from center
-        float dist = sqrtf(dx * dx + dy * dy);
-
-        // Check if this pixel is part of the wave ring with smooth gradient
-        float ring_distance = fabsf(dist - current_radius);
-        if (ring_distance <= WAVE_THICKNESS) {
-          int row = endgame_wave.win_king_row + dy;
-          int col = endgame_wave.win_king_col + dx;
-
-          // Check bounds
-          if (row >= 0 && row < 8 && col >= 0 && col < 8) {
-            uint8_t square = chess_pos_to_led_index(row, col);
-
-            // Get piece at this position
-            piece_t piece = game_get_piece(row, col);
-
-            // Použít intensity místo gradientu (jako ve starém
-            // projektu) Calculate intensity based on distance from ring center
-            // (smooth gradient)
-            float intensity = 1.0f - (ring_distance / WAVE_THICKNESS);
-            intensity = fmaxf(0.15f, intensity); // Higher minimum brightness
-
-            // Barvy podle starého projektu - všechny barvy se násobí
-            // intensity
-            uint8_t red, green, blue;
-
-            if (piece != PIECE_EMPTY) {
-              // Check if it's an opponent piece - use direct piece comparison
-              // for reliability
-              bool is_opponent_piece = false;
-
-              if (winner_is_white) {
-                // Winner is white, check if piece is black
-                is_opponent_piece =
-                    (piece >= PIECE_BLACK_PAWN && piece <= PIECE_BLACK_KING);
-              } else {
-                // Winner is black, check if piece is white
-                is_opponent_piece =
-                    (piece >= PIECE_WHITE_PAWN && piece <= PIECE_WHITE_KING);
-              }
-
-              if (is_opponent_piece) {
-                // BRIGHT RED for opponent pieces - very visible!
-                red = (uint8_t)(255 * intensity);
-                green = (uint8_t)(30 * intensity);
-                blue = (uint8_t)(30 * intensity);
-              } else {
-                // BRIGHT GREEN for own pieces - high contrast
-                red = (uint8_t)(30 * intensity);
-                green = (uint8_t)(255 * intensity);
-                blue = (uint8_t)(80 * intensity);
-              }
-            } else {
-              // BRIGHT BLUE for empty squares - very visible
-              red = (uint8_t)(30 * intensity);
-              green = (uint8_t)(100 * intensity);
-              blue = (uint8_t)(255 * intensity);
-            }
-
-            led_set_pixel_safe(square, red, green, blue);
-          }
-        }
-      }
+  // Snapshot desky pro renderer (row * 8 + col)
+  uint8_t board[64];
+  for (int row = 0; row < 8; row++) {
+    for (int col = 0; col < 8; col++) {
+      board[row * 8 + col] = (uint8_t)game_get_piece(row, col);
     }
   }
 
-  // Always highlight winner king in BRIGHT GOLD (mimo wave loop,
-  // jako ve starém projektu)
-  led_set_pixel_safe(endgame_wave.win_king_led, 255, 215, 0);
+  led_frame_t frame;
+  led_frame_render_endgame_wave(&frame, board, endgame_wave.win_king_led,
+                                endgame_wave.radius);
+  led_apply_frame(&frame, 0, LED_FRAME_BOARD_COUNT);
 
   // Increment radius for next wave
   endgame_wave.radius++;
-  if (endgame_wave.radius > MAX_RADIUS) {
+  if (endgame_wave.radius > LED_FRAME_ENDGAME_MAX_RADIUS) {
     endgame_wave.radius = 1; // Reset for continuous wave effect
   }
 }
@@ -2802,7 +2762,9 @@ void led_anim_check(const led_command_t *cmd) {
 
   // Růžové svícení na pozici krále (255, 192, 203) - statické, trvalé až do
   // dalšího tahu
-  led_set_pixel_safe(king_led_index, 255, 192, 203);
+  led_set_pixel_safe(king_led_index, (LED_FRAME_COLOR_CHECK >> 16) & 0xFF,
+                     (LED_FRAME_COLOR_CHECK >> 8) & 0xFF,
+                     LED_FRAME_COLOR_CHECK & 0xFF);
 
   ESP_LOGI(TAG, "⚠️ Check: Pink LED at king position %d", king_led_index);
 }
@@ -2845,6 +2807,15 @@ void led_set_pixel_safe(uint8_t led_index, uint8_t red, uint8_t green,
   led_set_pixel_internal(led_index, red, green, blue);
 }
 
+void led_apply_frame(const led_frame_t *frame, uint8_t first, uint8_t count) {
+  if (!frame)
+    return;
+  for (int i = first; i < first + count && i < LED_FRAME_LED_COUNT; i++) {
+    uint32_t c = frame->px[i];
+    led_set_pixel_safe(i, (c >> 16) & 0xFF, (c >> 8) & 0xFF, c & 0xFF);
+  }
+}
+
 void led_clear_all_safe(void) {
   for (int i = 0; i < 64; i++) {
     led_set_pixel_internal(i, 0, 0, 0);
@@ -3197,6 +3168,9 @@ void led_force_immediate_update(void) {
   // Ochrana před race condition je řešena skipováním LED operací v game_task
   // (total_games check).
 
+  // Pixely game tasku z ringu: LED task je aplikuje a commitne sam
+  led_px_ring_sync();
+
   // FORCE COMMIT ANY PENDING CHANGES WITH MUTEX PROTECTION
   if (led_unified_mutex != NULL) {
     if (xSemaphoreTake(led_unified_mutex, LED_TASK_MUTEX_TIMEOUT_TICKS) ==
@@ -35,14 +35,15 @@
  * - Stav: IDLE -> PIECE_UP -> PIECE_DN -> IDLE
  * - UP na e2 -> cekame na DN nekde jinde
  * - DN na e4 -> tah e2-e4 detekovan!
- * - Posli do game_command_queue
+ * - Posli do matrix_game_ring (game task se hned probudi)
  *
  * =============================================================================
  * KOMUNIKACE (FIFOS)
  * =============================================================================
  *
- * FRONTA - Posilame detkovane tahy:
- * - game_command_queue -> Poslani tahu typu GAME_CMD_MOVE_DETECTED
+ * RING - Posilame detekovane udalosti:
+ * - matrix_game_ring -> PICKUP / DROP / MATRIX_GUARD (SPSC, bez zamku;
+ *   jeden ring drzi poradi udalosti, notifikace budi game task)
  *
  * ZADNE MUTEXY - Task je read-only (jen cte GPIO)
  *
@@ -74,10 +75,10 @@
  *
  * 3. NIKDY neposilej tah primo do game_execute_move!
  *    ❌ game_execute_move(&move);  // Pristup z jineho tasku!
- *    ✅ xQueueSend(game_command_queue, &cmd, ...);  // Pres frontu
+ *    ✅ matrix_send_to_game(&cmd);  // Pres matrix_game_ring
  *
- * 4. VZDY kontroluj queue overflow!
- *    Pokud game_task je zahlcen, fronta se muze naplnit
+ * 4. VZDY kontroluj overflow ringu!
+ *    Pokud game_task je zahlcen, ring se muze naplnit (drops ve FIFO vypisu)
  *
  * =============================================================================
  * TABLE OF CONTENTS
@@ -124,6 +125,7 @@
 #include "freertos/task.h"
 #include "freertos/timers.h"
 #include "freertos_chess.h"
+#include "game_payload.h"
 #include <ctype.h>
 #include <inttypes.h>
 #include <stdbool.h>
@@ -477,18 +479,26 @@ void matrix_scan_all(void) {
 // ============================================================================
 
 /**
- * @brief Helper function to send PICKUP command to game_command_queue
- * @param square Square index (0-63)
+ * @brief Posle prikaz do matrix_game_ring a vzbudi game task
+ *
+ * Pickup, drop i guard jdou stejnym ringem, takze game task je vidi presne
+ * v poradi detekce. Plny ring ceka max 100 ms (jako drive xQueueSend).
+ *
+ * @return false = prikaz zahozen (zapocten v drops ringu)
  */
-static void matrix_send_pickup_command(uint8_t square) {
-  extern QueueHandle_t game_command_queue;
-
-  if (game_command_queue == NULL) {
-    ESP_LOGW(TAG,
-             "game_command_queue not available - cannot send PICKUP command");
-    return;
+static bool matrix_send_to_game(const chess_move_command_t *cmd) {
+  if (!spsc_ring_push_wait(&matrix_game_ring, cmd, pdMS_TO_TICKS(100))) {
+    return false;
   }
+  spsc_ring_notify(&matrix_game_ring);
+  return true;
+}
 
+/**
+ * @brief Helper function to send PICKUP command to game task
+ * @param square Square index (0-63)
+ */
+static void matrix_send_pickup_command(uint8_t square) {
   char notation[4];
   matrix_square_to_notation(square, notation);
 
@@ -501,12 +511,12 @@ static void matrix_send_pickup_command(uint8_t square) {
   cmd.from_notation[sizeof(cmd.from_notation) - 1] = '\0';
   strcpy(cmd.to_notation, "");
 
-  if (xQueueSend(game_command_queue, &cmd, pdMS_TO_TICKS(100)) == pdTRUE) {
-    ESP_LOGI(TAG, "PICKUP command sent to game_command_queue: %s", notation);
+  if (matrix_send_to_game(&cmd)) {
+    ESP_LOGI(TAG, "PICKUP command sent to game ring: %s", notation);
     // Report activity to HA light task
     ha_light_report_activity("pickup");
   } else {
-    ESP_LOGW(TAG, "Failed to send PICKUP command to game_command_queue");
+    ESP_LOGW(TAG, "Game ring full - PICKUP %s dropped", notation);
   }
 }
 
@@ -548,20 +558,12 @@ static void matrix_send_drop_command(uint8_t square) {
 
 /**
  * @brief Helper function to send DROP command with from/to notation to
- * game_command_queue
+ * game task
  * @param from_square Source square index (0-63)
  * @param to_square Destination square index (0-63)
  */
 static void matrix_send_drop_command_with_from(uint8_t from_square,
                                                uint8_t to_square) {
-  extern QueueHandle_t game_command_queue;
-
-  if (game_command_queue == NULL) {
-    ESP_LOGW(TAG, "game_command_queue not available - cannot send DROP command "
-                  "with from");
-    return;
-  }
-
   char from_notation[4], to_notation[4];
   matrix_square_to_notation(from_square, from_notation);
   matrix_square_to_notation(to_square, to_notation);
@@ -576,14 +578,14 @@ static void matrix_send_drop_command_with_from(uint8_t from_square,
   strncpy(cmd.to_notation, to_notation, sizeof(cmd.to_notation) - 1);
   cmd.to_notation[sizeof(cmd.to_notation) - 1] = '\0';
 
-  if (xQueueSend(game_command_queue, &cmd, pdMS_TO_TICKS(100)) == pdTRUE) {
-    ESP_LOGI(TAG, "DROP command with from sent to game_command_queue: %s -> %s",
-             from_notation, to_notation);
+  if (matrix_send_to_game(&cmd)) {
+    ESP_LOGI(TAG, "DROP command sent to game ring: %s -> %s", from_notation,
+             to_notation);
     // Report activity to HA light task
     ha_light_report_activity("drop");
   } else {
-    ESP_LOGW(TAG,
-             "Failed to send DROP command with from to game_command_queue");
+    ESP_LOGW(TAG, "Game ring full - DROP %s -> %s dropped", from_notation,
+             to_notation);
   }
 }
 
@@ -592,38 +594,40 @@ static void matrix_send_guard_command(uint32_t lifted_mask_low,
                                       uint32_t dropped_mask_low,
                                       uint32_t dropped_mask_high,
                                       uint8_t action) {
-  extern QueueHandle_t game_command_queue;
-
   if (action != 0 && !chess_policy_matrix_guard_enabled()) {
     ESP_LOGD(TAG, "Matrix guard detection disabled — skipping activate");
     return;
   }
 
-  if (game_command_queue == NULL) {
-    ESP_LOGW(TAG, "game_command_queue not available - cannot send GUARD command");
-    return;
-  }
-
   chess_move_command_t cmd = {
       .type = GAME_CMD_MATRIX_GUARD,
       .player = 0,
       .response_queue = NULL,
   };
-  cmd.timer_data.matrix_guard.lifted_mask_low = lifted_mask_low;
-  cmd.timer_data.matrix_guard.lifted_mask_high = lifted_mask_high;
-  cmd.timer_data.matrix_guard.dropped_mask_low = dropped_mask_low;
-  cmd.timer_data.matrix_guard.dropped_mask_high = dropped_mask_high;
   cmd.timer_data.matrix_guard.action = action;
   cmd.from_notation[0] = '\0';
   cmd.to_notation[0] = '\0';
 
-  if (xQueueSend(game_command_queue, &cmd, pdMS_TO_TICKS(100)) == pdTRUE) {
+  // Masky jdou pres payload slot; nulove (deaktivace) slot nepotrebuji
+  if ((lifted_mask_low | lifted_mask_high | dropped_mask_low |
+       dropped_mask_high) != 0) {
+    const uint32_t masks[4] = {lifted_mask_low, lifted_mask_high,
+                               dropped_mask_low, dropped_mask_high};
+    cmd.timer_data.matrix_guard.masks = game_payload_alloc(masks, sizeof(masks));
+    if (cmd.timer_data.matrix_guard.masks == GAME_PAYLOAD_NONE) {
+      ESP_LOGW(TAG, "No payload slot - MATRIX GUARD command dropped");
+      return;
+    }
+  }
+
+  if (matrix_send_to_game(&cmd)) {
     ESP_LOGW(TAG,
              "MATRIX GUARD command sent: action=%u lifted=%08" PRIx32
              ":%08" PRIx32 " dropped=%08" PRIx32 ":%08" PRIx32,
              (unsigned int)action, lifted_mask_high, lifted_mask_low,
              dropped_mask_high, dropped_mask_low);
   } else {
+    game_payload_release(cmd.timer_data.matrix_guard.masks);
     ESP_LOGW(TAG, "Failed to send MATRIX GUARD command");
   }
 }
@@ -733,7 +737,7 @@ void matrix_detect_moves(void) {
     ESP_LOGI(TAG, "Piece lifted from square %d (%c%d)", piece_lifted,
              'a' + from_col, from_row + 1);
 
-    // UNIFIED FLOW: Send PICKUP command to game_command_queue (same as UART)
+    // UNIFIED FLOW: Send PICKUP command to game task (same as UART)
     matrix_send_pickup_command(piece_lifted);
   }
 
@@ -776,8 +780,8 @@ void matrix_detect_complete_move(uint8_t from_square, uint8_t to_square) {
   ESP_LOGI(TAG, "Complete move detected: %d -> %d (%s -> %s)", from_square,
            to_square, from_notation, to_notation);
 
-  // UNIFIED FLOW: Send complete move as DROP with from/to to
-  // game_command_queue (same as UART)
+  // UNIFIED FLOW: Send complete move as DROP with from/to to game task
+  // (same as UART)
   matrix_send_drop_command_with_from(from_square, to_square);
 }
 
@@ -63,11 +63,11 @@ typedef enum {
 // ============================================================================
 
 /**
- * @brief Spusti test task
+ * @brief Inicializuje testy a zaregistruje test job v service tasku
  * 
- * @param pvParameters Parametry tasku (nepouzivane)
+ * @return ESP_OK, jinak chyba svc_job_register
  */
-void test_task_start(void *pvParameters);
+esp_err_t test_task_register_job(void);
 
 // ============================================================================
 // INICIALIZACNI FUNKCE TEST SAD
@@ -2,6 +2,8 @@
  * @file test_task.c
  * @brief ESP32-C6 Chess System v1.8.0 - Implementace Test tasku
  * 
+ * Bezi jako job service tasku (svc_loop.h), ne jako samostatny task.
+ * 
  * Tento task poskytuje komplexni testovaci schopnosti systemu:
  * - Testovani hardware komponent
  * - Testovani systemove integrace
@@ -30,6 +32,7 @@
 #include "test_task.h"
 #include "freertos_chess.h"
 #include "led_task_simple.h"
+#include "svc_loop.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "freertos/queue.h"
@@ -980,58 +983,46 @@ void test_run_performance_benchmark(void)
 
 
 // ============================================================================
-// MAIN TASK FUNCTION
+// TEST JOB
 // ============================================================================
 
 
-void test_task_start(void *pvParameters)
+/**
+ * @brief Krok test jobu (service task, svc_loop.h)
+ *
+ * Jednou za TEST_TASK_INTERVAL zkontroluje frontu prikazu. Spustena testovaci
+ * sada bezi v service tasku do konce — tlacitka a lampa mezitim cekaji
+ * (testy se spousti rucne, WDT krmi test_task_wdt_reset_safe).
+ */
+static uint32_t test_job_step(void *ctx)
 {
-    ESP_LOGI(TAG, "Test task started successfully");
-    
-    // CRITICAL: Register with TWDT from within task
-    esp_err_t wdt_ret = esp_task_wdt_add(NULL);
-    if (wdt_ret != ESP_OK && wdt_ret != ESP_ERR_INVALID_ARG) {
-        ESP_LOGE(TAG, "Failed to register Test task with TWDT: %s", esp_err_to_name(wdt_ret));
-    } else {
-        ESP_LOGI(TAG, "✅ Test task registered with TWDT");
+    (void)ctx;
+    static uint32_t run_count = 0;
+
+    // Process test commands
+    test_process_commands();
+
+    // Periodic status update
+    if (run_count % 10 == 0) { // Every 10 seconds
+        ESP_LOGI(TAG, "Test job status: runs=%lu, state=%d, tests=%lu/%lu",
+                 (unsigned long)run_count, current_test_state,
+                 total_passed + total_failed, total_tests);
     }
-    
-    ESP_LOGI(TAG, "Features:");
-    ESP_LOGI(TAG, "  • Automated test suites");
-    ESP_LOGI(TAG, "  • Hardware component testing");
-    ESP_LOGI(TAG, "  • System integration testing");
-    ESP_LOGI(TAG, "  • Performance benchmarking");
-    ESP_LOGI(TAG, "  • Comprehensive test reporting");
-    ESP_LOGI(TAG, "  • 1 second test cycle");
-    
+    run_count++;
+
+    return TEST_TASK_INTERVAL;
+}
+
+
+esp_err_t test_task_register_job(void)
+{
+    ESP_LOGI(TAG, "Test job: automated suites, HW/system/performance tests");
+
     task_running = true;
-    
+
     // Initialize test system
     test_initialize_system();
-    
-    // Main task loop
-    uint32_t loop_count = 0;
-    TickType_t last_wake_time = xTaskGetTickCount();
-    
-    for (;;) {
-        // CRITICAL: Reset watchdog for test task in every iteration
-        esp_err_t wdt_ret = test_task_wdt_reset_safe();
-        if (wdt_ret != ESP_OK && wdt_ret != ESP_ERR_NOT_FOUND) {
-            // Task not registered with TWDT yet - this is normal during startup
-        }
-        
-        // Process test commands
-        test_process_commands();
-        
-        // Periodic status update
-        if (loop_count % 10 == 0) { // Every 10 seconds
-            ESP_LOGI(TAG, "Test Task Status: loop=%d, state=%d, tests=%lu/%lu", 
-                     loop_count, current_test_state, total_passed + total_failed, total_tests);
-        }
-        
-        loop_count++;
-        
-        // Wait for next cycle (1 second)
-        vTaskDelayUntil(&last_wake_time, pdMS_TO_TICKS(TEST_TASK_INTERVAL));
-    }
-}
\ No newline at end of file
+
+    return svc_job_register("test", test_job_step, NULL, TEST_TASK_INTERVAL,
+                            NULL);
+}
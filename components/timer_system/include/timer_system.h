@@ -25,6 +25,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include "esp_err.h"
+#include "json_writer.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -193,6 +194,20 @@ esp_err_t timer_get_config_by_type(time_control_type_t type, time_control_config
  */
 esp_err_t timer_get_json(char* buffer, size_t buffer_size);
 
+/**
+ * @brief Zapise stav casoveho systemu jako JSON objekt do writeru
+ * 
+ * @param w Writer (buffer, heap nebo HTTP chunk sink)
+ * @return ESP_OK pri uspechu, chyba timer_get_state nebo writeru
+ */
+esp_err_t timer_write_json(json_writer_t* w);
+
+/**
+ * @brief Zapise uz nacteny stav (bez zamku) — snapshot tak muze vynechat
+ *        pole "clock", kdyz timer_get_state() selze, driv nez zapise klic
+ */
+void timer_write_state_json(json_writer_t* w, const chess_timer_t* t);
+
 /**
  * @brief Ziska pocet dostupnych casovych kontrol
  * 
@@ -212,7 +227,9 @@ uint32_t timer_get_available_controls(time_control_config_t* controls, uint32_t
 /**
  * @brief Ulozi nastaveni timeru do NVS
  * 
- * @return ESP_OK pri uspechu, chybovy kod pri chybe
+ * Hodnoty se zachyti hned, zapis probehne v persist tasku (config_persist.h).
+ * 
+ * @return ESP_OK pri zarazeni do fronty, chybovy kod pri chybe
  */
 esp_err_t timer_save_settings(void);
 
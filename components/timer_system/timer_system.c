@@ -21,6 +21,7 @@
 
 #include "include/timer_system.h"
 #include "../led_task/include/led_task.h"  // Pro timeout animace
+#include "config_persist.h"
 #include "esp_log.h"
 #include "esp_timer.h"
 #include "nvs.h"
@@ -619,10 +620,39 @@ esp_err_t timer_get_config_by_type(time_control_type_t type, time_control_config
     return ESP_OK;
 }
 
-esp_err_t timer_get_json(char* buffer, size_t buffer_size)
+void timer_write_state_json(json_writer_t* w, const chess_timer_t* t)
 {
-    if (buffer == NULL || buffer_size == 0) {
-        ESP_LOGE(TAG, "Invalid buffer parameters");
+    if (w == NULL || t == NULL) {
+        return;
+    }
+    
+    json_writer_begin_object(w);
+    json_writer_kv_uint(w, "white_time_ms", t->white_time_ms);
+    json_writer_kv_uint(w, "black_time_ms", t->black_time_ms);
+    json_writer_kv_bool(w, "timer_running", t->timer_running);
+    json_writer_kv_bool(w, "is_white_turn", t->is_white_turn);
+    json_writer_kv_bool(w, "game_paused", t->game_paused);
+    json_writer_kv_bool(w, "time_expired", t->time_expired);
+    json_writer_key(w, "config");
+    json_writer_begin_object(w);
+    json_writer_kv_int(w, "type", t->config.type);
+    json_writer_kv_string(w, "name", t->config.name);
+    json_writer_kv_string(w, "description", t->config.description);
+    json_writer_kv_uint(w, "initial_time_ms", t->config.initial_time_ms);
+    json_writer_kv_uint(w, "increment_ms", t->config.increment_ms);
+    json_writer_kv_bool(w, "is_fast", t->config.is_fast);
+    json_writer_end_object(w);
+    json_writer_kv_uint(w, "total_moves", t->total_moves);
+    json_writer_kv_uint(w, "avg_move_time_ms", t->avg_move_time_ms);
+    json_writer_kv_bool(w, "warning_30s_shown", t->warning_30s_shown);
+    json_writer_kv_bool(w, "warning_10s_shown", t->warning_10s_shown);
+    json_writer_kv_bool(w, "warning_5s_shown", t->warning_5s_shown);
+    json_writer_end_object(w);
+}
+
+esp_err_t timer_write_json(json_writer_t* w)
+{
+    if (w == NULL) {
         return ESP_ERR_INVALID_ARG;
     }
     
@@ -632,54 +662,30 @@ esp_err_t timer_get_json(char* buffer, size_t buffer_size)
         return ret;
     }
     
-    // Vytvorit JSON
-    int written = snprintf(buffer, buffer_size,
-        "{"
-        "\"white_time_ms\":%" PRIu32 ","
-        "\"black_time_ms\":%" PRIu32 ","
-        "\"timer_running\":%s,"
-        "\"is_white_turn\":%s,"
-        "\"game_paused\":%s,"
-        "\"time_expired\":%s,"
-        "\"config\":{"
-            "\"type\":%d,"
-            "\"name\":\"%s\","
-            "\"description\":\"%s\","
-            "\"initial_time_ms\":%" PRIu32 ","
-            "\"increment_ms\":%" PRIu32 ","
-            "\"is_fast\":%s"
-        "},"
-        "\"total_moves\":%" PRIu32 ","
-        "\"avg_move_time_ms\":%" PRIu32 ","
-        "\"warning_30s_shown\":%s,"
-        "\"warning_10s_shown\":%s,"
-        "\"warning_5s_shown\":%s"
-        "}",
-        timer_data.white_time_ms,
-        timer_data.black_time_ms,
-        timer_data.timer_running ? "true" : "false",
-        timer_data.is_white_turn ? "true" : "false",
-        timer_data.game_paused ? "true" : "false",
-        timer_data.time_expired ? "true" : "false",
-        timer_data.config.type,
-        timer_data.config.name,
-        timer_data.config.description,
-        timer_data.config.initial_time_ms,
-        timer_data.config.increment_ms,
-        timer_data.config.is_fast ? "true" : "false",
-        timer_data.total_moves,
-        timer_data.avg_move_time_ms,
-        timer_data.warning_30s_shown ? "true" : "false",
-        timer_data.warning_10s_shown ? "true" : "false",
-        timer_data.warning_5s_shown ? "true" : "false"
-    );
-    
-    if (written >= buffer_size) {
+    timer_write_state_json(w, &timer_data);
+    return json_writer_error(w);
+}
+
+esp_err_t timer_get_json(char* buffer, size_t buffer_size)
+{
+    if (buffer == NULL || buffer_size == 0) {
+        ESP_LOGE(TAG, "Invalid buffer parameters");
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    json_writer_t w;
+    json_writer_init_buffer(&w, buffer, buffer_size);
+    esp_err_t ret = timer_write_json(&w);
+    if (ret != ESP_OK && ret != ESP_ERR_NO_MEM) {
+        return ret;
+    }
+    
+    ret = json_writer_finish(&w);
+    if (ret == ESP_ERR_NO_MEM) {
         ESP_LOGE(TAG, "JSON buffer too small");
-        return ESP_ERR_NO_MEM;
     }
     
-    return ESP_OK;
+    return ret;
 }
 
 uint32_t timer_get_available_controls_count(void)
@@ -702,8 +708,21 @@ uint32_t timer_get_available_controls(time_control_config_t* controls, uint32_t
     return count;
 }
 
-esp_err_t timer_save_settings(void)
+/** Hodnoty pro NVS zachycene v okamziku ulozeni (zapis az v persist tasku). */
+typedef struct {
+    uint8_t type;
+    uint32_t custom_minutes;
+    uint32_t custom_increment;
+} timer_nvs_settings_t;
+
+static esp_err_t timer_write_settings_nvs(const char *key, const void *data, size_t len)
 {
+    (void)key;
+    if (len != sizeof(timer_nvs_settings_t)) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    const timer_nvs_settings_t *settings = (const timer_nvs_settings_t *)data;
+
     nvs_handle_t nvs_handle;
     esp_err_t ret = nvs_open(TIMER_NVS_NAMESPACE, NVS_READWRITE, &nvs_handle);
     if (ret != ESP_OK) {
@@ -712,7 +731,7 @@ esp_err_t timer_save_settings(void)
     }
     
     // Ulozit aktualni konfiguraci (max 15 chars for NVS key)
-    ret = nvs_set_u8(nvs_handle, "tc_type", (uint8_t)current_timer.config.type);
+    ret = nvs_set_u8(nvs_handle, "tc_type", settings->type);
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "Failed to save time control type: %s", esp_err_to_name(ret));
         nvs_close(nvs_handle);
@@ -720,16 +739,13 @@ esp_err_t timer_save_settings(void)
     }
     
     // Pokud je custom time control, ulozit take custom values
-    if (current_timer.config.type == TIME_CONTROL_CUSTOM) {
-        uint32_t custom_minutes = current_timer.config.initial_time_ms / 60000;
-        uint32_t custom_increment = current_timer.config.increment_ms / 1000;
-        
-        ret = nvs_set_u32(nvs_handle, "tc_min", custom_minutes);
+    if (settings->type == TIME_CONTROL_CUSTOM) {
+        ret = nvs_set_u32(nvs_handle, "tc_min", settings->custom_minutes);
         if (ret != ESP_OK) {
             ESP_LOGE(TAG, "Failed to save custom minutes: %s", esp_err_to_name(ret));
         }
         
-        ret = nvs_set_u32(nvs_handle, "tc_inc", custom_increment);
+        ret = nvs_set_u32(nvs_handle, "tc_inc", settings->custom_increment);
         if (ret != ESP_OK) {
             ESP_LOGE(TAG, "Failed to save custom increment: %s", esp_err_to_name(ret));
         }
@@ -752,6 +768,18 @@ esp_err_t timer_save_settings(void)
     return ret;
 }
 
+esp_err_t timer_save_settings(void)
+{
+    timer_nvs_settings_t settings = {
+        .type = (uint8_t)current_timer.config.type,
+        .custom_minutes = current_timer.config.initial_time_ms / 60000,
+        .custom_increment = current_timer.config.increment_ms / 1000,
+    };
+    return config_persist_submit(TIMER_NVS_NAMESPACE, timer_write_settings_nvs,
+                                 &settings, sizeof(settings),
+                                 CONFIG_PERSIST_PRIO_NORMAL, NULL);
+}
+
 esp_err_t timer_load_settings(void)
 {
     nvs_handle_t nvs_handle;
@@ -1,13 +1,53 @@
 /**
  * @file uart_commands_table.h
- * @brief UART command registry (name → handler).
+ * @brief UART command registry (name → handler) a jeho hash index.
+ *
+ * uart_commands_hash.c generuje pri buildu tools/gen_cli_dispatch.py z
+ * uart_commands_table.c: minimalni perfektni hash pres nazvy i aliasy
+ * (velka pismena), takze find_command je O(1) s jedinym porovnanim retezce.
  */
 
 #ifndef UART_COMMANDS_TABLE_H
 #define UART_COMMANDS_TABLE_H
 
 #include "uart_task.h"
+#include <stddef.h>
+#include <stdint.h>
 
 extern const uart_command_t uart_commands[];
 
+/** @brief Slot hash indexu (key == NULL = prazdny) */
+typedef struct {
+  const char *key; ///< Nazev nebo alias velkymi pismeny
+  uint8_t len;     ///< strlen(key)
+  uint8_t index;   ///< Index do uart_commands[]
+} uart_cmd_slot_t;
+
+extern const uint32_t uart_cmd_hash_bucket_mask;
+extern const uint32_t uart_cmd_hash_slot_mask;
+extern const uint16_t uart_cmd_hash_seeds[];
+extern const uart_cmd_slot_t uart_cmd_hash_slots[];
+
+/**
+ * @brief Hash prikazu bez ohledu na velikost pismen (FNV-1a + finalizer)
+ *
+ * Musi odpovidat cmd_hash() v tools/gen_cli_dispatch.py.
+ */
+static inline uint32_t uart_cmd_hash(const char *s, size_t len,
+                                     uint32_t seed) {
+  uint32_t h = 2166136261u ^ (seed * 0x9E3779B1u);
+  for (size_t i = 0; i < len; i++) {
+    uint8_t c = (uint8_t)s[i];
+    if (c >= 'a' && c <= 'z') {
+      c = (uint8_t)(c - 'a' + 'A');
+    }
+    h ^= c;
+    h *= 16777619u;
+  }
+  h ^= h >> 16;
+  h *= 0x7FEB352Du;
+  h ^= h >> 15;
+  return h;
+}
+
 #endif /* UART_COMMANDS_TABLE_H */
@@ -0,0 +1,58 @@
+/**
+ * @file uart_jsonl.h
+ * @brief Strojovy protokol na konzoli: JSON Lines s ID pozadavku
+ *
+ * Prikaz JSONL prepne konzoli z lidskeho CLI do protokolu pro automatizaci
+ * (testovaci pripravky, skripty turnaju, soak testy). Jeden pozadavek = jeden
+ * radek JSON, jedna odpoved = jeden radek JSON se stejnym "id":
+ *
+ *   > {"id":1,"cmd":"moves","moves":"e2e4 e7e5 g1f3"}
+ *   < {"id":1,"ok":true,"applied":3,"ply":3,"state_version":42}
+ *   > {"id":2,"cmd":"moves","moves":["f1c4","e8e6"]}
+ *   < {"id":2,"ok":false,"error":"invalid_move","code":4,"index":1,"move":"e8e6"}
+ *
+ * - Bez echa, promptu a ANSI barev; logy se ztlumi na WARN (po "exit" se
+ *   vrati podle konfigurace). Radek odpovedi vzdy zacina '{', logy nikdy.
+ * - Pipelining: klient smi poslat dalsi pozadavky bez cekani na odpoved,
+ *   zpracuji se po poradi. V letu drzet nejvys ~2 KiB (RX buffer driveru),
+ *   jinak prijde {"id":null,...,"error":"rx_overflow"} a rozepsany radek
+ *   se zahodi.
+ * - "moves": max GAME_MOVE_BATCH_MAX tahu (UCI "e2e4", promoce "e7e8q",
+ *   rosada tahem krale "e1g1"), atomicky — pri chybe se nic neprovede.
+ * - Data ("status", "board", "history") jsou stejny JSON jako web API.
+ *
+ * Prikazy: hello, status, board, history, moves, new_game (volitelne "fen"),
+ * undo, exit. Pozadavek "status":true pripoji k odpovedi stav hry.
+ */
+
+#ifndef UART_JSONL_H
+#define UART_JSONL_H
+
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Verze protokolu (pole "proto" v hello) */
+#define UART_JSONL_PROTO_VERSION 1
+/** @brief Max delka radku pozadavku vcetne '\0' */
+#define UART_JSONL_LINE_MAX 1536
+
+/** @brief Konzole je v rezimu JSON Lines */
+bool uart_jsonl_active(void);
+
+/** @brief Prepne konzoli do protokolu (prikaz JSONL) */
+void uart_jsonl_enter(void);
+
+/** @brief Jeden prijaty bajt v rezimu protokolu */
+void uart_jsonl_input(char c);
+
+/** @brief Preteceni RX: zahodi rozepsany radek a ohlasi chybu */
+void uart_jsonl_rx_overflow(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* UART_JSONL_H */
@@ -61,6 +61,50 @@ typedef enum {
  */
 typedef command_result_t (*command_handler_t)(const char* args);
 
+// ============================================================================
+// TYPOVANE ARGUMENTY PRIKAZU
+// ============================================================================
+
+/**
+ * Schema argumentu je retezec, jeden znak na argument (jako printf format):
+ *   's' pole a1-h8 (i "a 2"; vysledek malymi pismeny)
+ *   'm' tah: "e2e4", "e2 e4", "e2-e4" (from/to malymi pismeny)
+ *   'i' cele cislo (int32)
+ *   'b' prepinac ON/OFF, 1/0, TRUE/FALSE, YES/NO
+ *   'w' jedno slovo
+ *   'r' zbytek radku (musi byt posledni)
+ *   '?' nasledujici argumenty jsou volitelne
+ * Parsuje a validuje execute_command jednou; pri chybe vypise usage a handler
+ * se nezavola.
+ */
+
+/** @brief Max pocet argumentu ve schematu */
+#define UART_ARGS_MAX 4
+/** @brief Kapacita kopie radku pro argumenty 'w' / 'r' */
+#define UART_ARGS_LINE_MAX 128
+
+/** @brief Jeden rozparsovany argument */
+typedef struct {
+    char kind; ///< Znak ze schematu
+    union {
+        int32_t i;                             ///< 'i'
+        bool b;                                ///< 'b'
+        char square[3];                        ///< 's'
+        struct { char from[3]; char to[3]; } move; ///< 'm'
+        const char* str;                       ///< 'w', 'r' (do line)
+    };
+} uart_arg_t;
+
+/** @brief Rozparsovane argumenty prikazu */
+typedef struct {
+    uint8_t count;                  ///< Pocet pritomnych argumentu
+    uart_arg_t v[UART_ARGS_MAX];
+    char line[UART_ARGS_LINE_MAX];  ///< Uloziste pro 'w' / 'r'
+} uart_args_t;
+
+/** @brief Handler s rozparsovanymi argumenty (prikazy se schematem) */
+typedef command_result_t (*command_args_handler_t)(const uart_args_t* args);
+
 // ============================================================================
 // TYPY UART ZPRAV (uart_message_t v uart_queue_message.h)
 // ============================================================================
@@ -75,6 +119,8 @@ typedef struct {
     const char* usage;            ///< Pouziti prikazu
     bool requires_args;           ///< Vyzaduje argumenty?
     const char* aliases[5];       ///< Max 5 aliasu
+    const char* args_schema;      ///< Schema argumentu (NULL = handler parsuje sam)
+    command_args_handler_t run;   ///< Handler pro prikazy se schematem
 } uart_command_t;
 
 // ============================================================================
@@ -120,7 +166,7 @@ void uart_write_char_immediate(char c);
 /** @brief Prikaz help */
 command_result_t uart_cmd_help(const char* args);
 /** @brief Prikaz verbose */
-command_result_t uart_cmd_verbose(const char* args);
+command_result_t uart_cmd_verbose(const uart_args_t* args);
 /** @brief Prikaz quiet */
 command_result_t uart_cmd_quiet(const char* args);
 /** @brief Prikaz status */
@@ -134,16 +180,18 @@ command_result_t uart_cmd_history(const char* args);
 /** @brief Jednotný CLI panel — viz též `HELP CLI` */
 command_result_t uart_cmd_cli(const char* args);
 void uart_cli_print_help(void);
+/** @brief Prepne konzoli do JSON Lines protokolu (uart_jsonl.h) */
+command_result_t uart_cmd_jsonl(const char* args);
 /** @brief Prikaz clear */
 command_result_t uart_cmd_clear(const char* args);
 /** @brief Prikaz reset */
 command_result_t uart_cmd_reset(const char* args);
 /** @brief Prikaz move */
-command_result_t uart_cmd_move(const char* args);
+command_result_t uart_cmd_move(const uart_args_t* args);
 /** @brief Prikaz up (zvedni figurku) */
-command_result_t uart_cmd_up(const char* args);
+command_result_t uart_cmd_up(const uart_args_t* args);
 /** @brief Prikaz dn (poloz figurku) */
-command_result_t uart_cmd_dn(const char* args);
+command_result_t uart_cmd_dn(const uart_args_t* args);
 /** @brief Prikaz led_board */
 command_result_t uart_cmd_led_board(const char* args);
 /** @brief Prikaz board */
@@ -158,6 +206,14 @@ command_result_t uart_cmd_show_moves(const char* args);
 command_result_t uart_cmd_undo(const char* args);
 /** @brief Prikaz game_history */
 command_result_t uart_cmd_game_history(const char* args);
+/** @brief Prikaz SAVE <jmeno> (archiv her) */
+command_result_t uart_cmd_save_game(const char* args);
+/** @brief Prikaz LOAD <jmeno> (archiv her) */
+command_result_t uart_cmd_load_game(const char* args);
+/** @brief Prikaz LIST_GAMES [strana] (archiv her) */
+command_result_t uart_cmd_list_games(const char* args);
+/** @brief Prikaz DELETE_GAME <jmeno> (archiv her) */
+command_result_t uart_cmd_delete_game(const char* args);
 /** @brief Prikaz benchmark */
 command_result_t uart_cmd_benchmark(const char* args);
 /** @brief Prikaz show_tasks */
@@ -0,0 +1,235 @@
+#!/usr/bin/env python3
+"""
+Build-time generátor dispatch tabulky UART příkazů (volá CMake, lze spustit i ručně).
+
+Z `uart_commands_table.c` vezme názvy příkazů a aliasy (case-insensitive,
+klíče velkými písmeny) a postaví pro ně minimální perfektní hash (hash and
+displace): klíč → koš podle seedu 0, každý koš má vlastní seed, pod kterým
+všechny jeho klíče padnou do volných slotů. Firmware pak na jeden příkaz
+spočítá dva hashe a porovná jediný řetězec (`find_command` v uart_parse.c).
+
+Pořadí tabulky rozhoduje při kolizi aliasů: vyhrává dřívější příkaz (stejně
+jako dřív lineární průchod), přepsané aliasy jsou vypsané v komentáři
+výstupu. Generátor také zkontroluje typová schémata argumentů (`args_schema`,
+viz uart_task.h) a že položka se schématem má `run` a nemá `handler`.
+
+Hash musí odpovídat `uart_cmd_hash()` v uart_commands_table.h.
+
+Spuštění z kořene repa (report, bez zápisu):
+  python3 components/uart_task/tools/gen_cli_dispatch.py --report \\
+      components/uart_task/uart_commands_table.c
+"""
+
+from __future__ import annotations
+
+import argparse
+import re
+import sys
+import textwrap
+
+SCHEMA_CHARS = set("smibwr?")
+MAX_SEED = 0xFFFF
+MAX_COMMANDS = 255  # index v uart_cmd_slot_t je uint8_t
+
+TOKEN_RE = re.compile(
+    r'\s+|//[^\n]*|/\*.*?\*/|"(?:\\.|[^"\\])*"|[A-Za-z_]\w*|[{}\[\],=;()]|.',
+    re.S)
+
+
+def tokenize(text: str) -> list[str]:
+    out = []
+    for m in TOKEN_RE.finditer(text):
+        tok = m.group(0)
+        if tok.isspace() or tok.startswith("//") or tok.startswith("/*"):
+            continue
+        out.append(tok)
+    return out
+
+
+def c_string(tok: str) -> str | None:
+    if len(tok) >= 2 and tok[0] == '"' and tok[-1] == '"':
+        return bytes(tok[1:-1], "utf-8").decode("unicode_escape")
+    return None
+
+
+def parse_table(path: str) -> list[dict]:
+    """Položky `uart_commands[]` do koncové značky {NULL, ...}."""
+    with open(path, encoding="utf-8") as f:
+        toks = tokenize(f.read())
+    try:
+        start = toks.index("uart_commands")
+        start = toks.index("{", start)
+    except ValueError:
+        sys.exit(f"{path}: uart_commands[] not found")
+
+    entries = []
+    i = start + 1
+    while i < len(toks) and toks[i] != "}":
+        if toks[i] == ",":
+            i += 1
+            continue
+        if toks[i] != "{":
+            sys.exit(f"{path}: unexpected token {toks[i]!r} in table")
+        # Jedna polozka: pole na urovni 1, vnorene { } = aliasy
+        fields, depth, group = [], 0, None
+        while True:
+            tok = toks[i]
+            i += 1
+            if tok == "{":
+                depth += 1
+                if depth == 2:
+                    group = []
+                continue
+            if tok == "}":
+                depth -= 1
+                if depth == 1:
+                    fields.append(group)
+                    group = None
+                if depth == 0:
+                    break
+                continue
+            if tok == ",":
+                continue
+            if depth == 2:
+                group.append(tok)
+            else:
+                fields.append(tok)
+        entries.append(fields)
+
+    commands = []
+    for idx, fields in enumerate(entries):
+        if fields[0] == "NULL":
+            break
+        name = c_string(fields[0])
+        aliases = [c_string(a) for a in (fields[5] or [])]
+        handler = fields[1]
+        schema = c_string(fields[6]) if len(fields) > 6 else None
+        run = fields[7] if len(fields) > 7 else "NULL"
+        if name is None or any(a is None for a in aliases):
+            sys.exit(f"{path}: entry {idx}: name/aliases must be string literals")
+        if schema is not None:
+            bad = set(schema) - SCHEMA_CHARS
+            if bad or "r" in schema[:-1]:
+                sys.exit(f"{path}: {name}: invalid args_schema {schema!r}")
+            if len(schema.replace("?", "")) > 4:
+                sys.exit(f"{path}: {name}: more than UART_ARGS_MAX arguments")
+            if run == "NULL" or handler != "NULL":
+                sys.exit(f"{path}: {name}: schema entry needs run and NULL handler")
+        elif handler == "NULL":
+            sys.exit(f"{path}: {name}: handler missing")
+        commands.append({"name": name, "aliases": aliases, "index": idx})
+    if len(commands) > MAX_COMMANDS:
+        sys.exit(f"{path}: too many commands ({len(commands)})")
+    return commands
+
+
+def cmd_hash(key: bytes, seed: int) -> int:
+    h = 2166136261 ^ ((seed * 0x9E3779B1) & 0xFFFFFFFF)
+    for c in key:
+        h ^= c
+        h = (h * 16777619) & 0xFFFFFFFF
+    h ^= h >> 16
+    h = (h * 0x7FEB352D) & 0xFFFFFFFF
+    h ^= h >> 15
+    return h
+
+
+def collect_keys(commands: list[dict]) -> tuple[dict[str, int], list[str]]:
+    keys: dict[str, int] = {}
+    shadowed = []
+    for cmd in commands:
+        for key in [cmd["name"]] + cmd["aliases"]:
+            key = key.upper()
+            if not key:
+                continue
+            if key in keys:
+                note = f"{key} -> {cmd['name']}"
+                if keys[key] != cmd["index"] and note not in shadowed:
+                    shadowed.append(note)
+                continue
+            keys[key] = cmd["index"]
+    return keys, shadowed
+
+
+def build_hash(keys: dict[str, int]):
+    n = len(keys)
+    slots = 1
+    while slots < n * 5 // 4:
+        slots *= 2
+    buckets = 1
+    while buckets < max(1, n // 3):
+        buckets *= 2
+
+    by_bucket: dict[int, list[str]] = {}
+    for key in keys:
+        b = cmd_hash(key.encode(), 0) & (buckets - 1)
+        by_bucket.setdefault(b, []).append(key)
+
+    table: list[str | None] = [None] * slots
+    seeds = [0] * buckets
+    for b, members in sorted(by_bucket.items(), key=lambda kv: -len(kv[1])):
+        for seed in range(1, MAX_SEED + 1):
+            pos = [cmd_hash(k.encode(), seed) & (slots - 1) for k in members]
+            if len(set(pos)) == len(pos) and all(table[p] is None for p in pos):
+                for k, p in zip(members, pos):
+                    table[p] = k
+                seeds[b] = seed
+                break
+        else:
+            sys.exit(f"no seed for bucket {b} ({members})")
+    return table, seeds
+
+
+def emit_c(path: str, keys, shadowed, table, seeds) -> None:
+    lines = [
+        "/* Vygenerovano tools/gen_cli_dispatch.py z uart_commands_table.c - neupravovat. */",
+        "",
+        '#include "uart_commands_table.h"',
+        "",
+        f"/* {len(keys)} klicu (nazvy + aliasy), {len(table)} slotu, {len(seeds)} kosu. */",
+    ]
+    if shadowed:
+        wrapped = textwrap.wrap("Aliasy prekryte drivejsim prikazem: " +
+                                ", ".join(shadowed), 74)
+        lines.append("/* " + "\n * ".join(wrapped) + " */")
+    lines += [
+        "",
+        f"const uint32_t uart_cmd_hash_bucket_mask = {len(seeds) - 1}u;",
+        f"const uint32_t uart_cmd_hash_slot_mask = {len(table) - 1}u;",
+        "",
+        f"const uint16_t uart_cmd_hash_seeds[{len(seeds)}] = {{",
+    ]
+    for i in range(0, len(seeds), 12):
+        lines.append("    " + ", ".join(str(s) for s in seeds[i:i + 12]) + ",")
+    lines += ["};", "", f"const uart_cmd_slot_t uart_cmd_hash_slots[{len(table)}] = {{"]
+    for pos, key in enumerate(table):
+        if key is not None:
+            lines.append(f'    [{pos}] = {{"{key}", {len(key)}, {keys[key]}}},')
+    lines += ["};", ""]
+    with open(path, "w", encoding="utf-8") as f:
+        f.write("\n".join(lines))
+
+
+def main() -> int:
+    ap = argparse.ArgumentParser(description=__doc__.split("\n")[1])
+    ap.add_argument("table", help="uart_commands_table.c")
+    ap.add_argument("--out", help="vystupni C soubor")
+    ap.add_argument("--report", action="store_true", help="jen souhrn")
+    args = ap.parse_args()
+
+    commands = parse_table(args.table)
+    keys, shadowed = collect_keys(commands)
+    table, seeds = build_hash(keys)
+
+    if args.report or not args.out:
+        print(f"{len(commands)} commands, {len(keys)} keys, "
+              f"{len(table)} slots, {len(seeds)} buckets, max seed {max(seeds)}")
+        for s in shadowed:
+            print(f"  shadowed alias: {s}")
+    if args.out:
+        emit_c(args.out, keys, shadowed, table, seeds)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -14,6 +14,7 @@
 
 #include "ota_update.h"
 #include "web_server_task.h"
+#include "config_persist.h"
 
 #include "esp_app_format.h"
 #include "esp_chip_info.h"
@@ -416,11 +417,13 @@ static command_result_t cli_hall_tail(const char *tail) {
 #endif /* CONFIG_CHESS_MATRIX_INPUT_I2C_HALL */
 
 static void cli_snapshot(void) {
-  char *json = NULL;
-  size_t len = 0;
-  esp_err_t e = web_server_build_game_snapshot_json_shared(&json, &len);
+  web_snapshot_t *snap = NULL;
+  esp_err_t e = web_snapshot_acquire(&snap);
+  const char *json = web_snapshot_json(snap);
+  size_t len = web_snapshot_len(snap);
   if (e != ESP_OK || json == NULL || len == 0) {
     uart_send_formatted("SNAPSHOT chyba: %s", esp_err_to_name(e));
+    web_snapshot_release(snap);
     return;
   }
   uart_send_colored_line(COLOR_INFO, "Snapshot JSON");
@@ -438,6 +441,7 @@ static void cli_snapshot(void) {
     line[n] = '\0';
     uart_send_formatted("%s", line);
   }
+  web_snapshot_release(snap);
 }
 
 void uart_cli_print_help(void) {
@@ -573,6 +577,7 @@ command_result_t uart_cmd_cli(const char *args) {
   }
   if (!strcasecmp(cmd, "RESET")) {
     uart_send_line("Restart…");
+    (void)config_persist_flush(1000);
     esp_restart();
     return CMD_SUCCESS;
   }
@@ -54,11 +54,13 @@ const uart_command_t uart_commands[] = {
 
     // Configuration commands
     {"VERBOSE",
-     uart_cmd_verbose,
+     NULL,
      "Control logging verbosity",
      "VERBOSE ON/OFF",
      true,
-     {"V", "VERB", "", "", ""}},
+     {"V", "VERB", "", "", ""},
+     "b",
+     uart_cmd_verbose},
     {"QUIET",
      uart_cmd_quiet,
      "Toggle quiet mode",
@@ -68,23 +70,29 @@ const uart_command_t uart_commands[] = {
 
     // Game commands
     {"MOVE",
-     uart_cmd_move,
+     NULL,
      "Make chess move",
      "MOVE <from> <to>",
      true,
-     {"M", "MV", "", "", ""}},
+     {"M", "MV", "", "", ""},
+     "m",
+     uart_cmd_move},
     {"UP",
-     uart_cmd_up,
+     NULL,
      "Lift piece from square",
      "UP <square>",
      true,
-     {"U", "LIFT", "", "", ""}},
+     {"U", "LIFT", "", "", ""},
+     "s",
+     uart_cmd_up},
     {"DN",
-     uart_cmd_dn,
+     NULL,
      "Drop piece to square",
      "DN <square>",
      true,
-     {"D", "DROP", "", "", ""}},
+     {"D", "DROP", "", "", ""},
+     "s",
+     uart_cmd_dn},
     {"BOARD",
      uart_cmd_board,
      "Show chess board",
@@ -133,6 +141,30 @@ const uart_command_t uart_commands[] = {
      "",
      false,
      {"HIST", "MOVES", "GAME", "", ""}},
+    {"SAVE",
+     uart_cmd_save_game,
+     "Save current game to the archive",
+     "SAVE <name>",
+     true,
+     {"SAVE_GAME", "", "", "", ""}},
+    {"LOAD",
+     uart_cmd_load_game,
+     "Load a game from the archive",
+     "LOAD <name>",
+     true,
+     {"LOAD_GAME", "", "", "", ""}},
+    {"LIST_GAMES",
+     uart_cmd_list_games,
+     "List saved games (10 per page)",
+     "LIST_GAMES [page]",
+     false,
+     {"GAMES", "SAVED", "", "", ""}},
+    {"DELETE_GAME",
+     uart_cmd_delete_game,
+     "Delete a saved game",
+     "DELETE_GAME <name>",
+     true,
+     {"DEL_GAME", "RM_GAME", "", "", ""}},
 
     // Starting position check commands
     {"STARTPOS",
@@ -493,7 +525,14 @@ const uart_command_t uart_commands[] = {
      false,
      {"CONTROL", "PANEL", "", "", ""}},
 
+    {"JSONL",
+     uart_cmd_jsonl,
+     "Machine-readable JSON Lines protocol for automation (exit via cmd exit)",
+     "JSONL",
+     false,
+     {"PROTO", "", "", "", ""}},
+
     // System Commands
 
     // End marker
-    {NULL, NULL, "", "", false, {"", "", "", "", ""}}};
+    {NULL, NULL, "", "", false, {"", "", "", "", ""}, NULL, NULL}};
@@ -8,6 +8,8 @@
 #include "uart_task.h"
 #include "freertos_chess.h"
 #include "game_task.h"
+#include "led_task.h"
+#include "svc_loop.h"
 
 #include "esp_log.h"
 #include "esp_system.h"
@@ -671,9 +673,7 @@ command_result_t uart_cmd_show_tasks(const char *args) {
   extern TaskHandle_t game_task_handle;
   extern TaskHandle_t led_task_handle;
   extern TaskHandle_t matrix_task_handle;
-  extern TaskHandle_t button_task_handle;
   extern TaskHandle_t animation_task_handle;
-  extern TaskHandle_t test_task_handle;
   extern TaskHandle_t web_server_task_handle;
   extern TaskHandle_t reset_button_task_handle;
   extern TaskHandle_t promotion_button_task_handle;
@@ -710,12 +710,19 @@ command_result_t uart_cmd_show_tasks(const char *args) {
                         uxTaskGetStackHighWaterMark(matrix_task_handle));
   }
 
-  if (button_task_handle) {
-    const char *task_name = pcTaskGetName(button_task_handle);
-    uart_send_formatted("   Button Task: %s (Priority: %" PRIu32
+  TaskHandle_t svc_task = svc_loop_task_handle();
+  if (svc_task) {
+    uart_send_formatted("   Service Task: %s (Priority: %" PRIu32
                         ", Stack: %" PRIu32 ")",
-                        task_name, uxTaskPriorityGet(button_task_handle),
-                        uxTaskGetStackHighWaterMark(button_task_handle));
+                        pcTaskGetName(svc_task), uxTaskPriorityGet(svc_task),
+                        uxTaskGetStackHighWaterMark(svc_task));
+    svc_job_info_t jobs[SVC_LOOP_MAX_JOBS];
+    size_t n = svc_loop_get_jobs(jobs, SVC_LOOP_MAX_JOBS);
+    for (size_t i = 0; i < n; i++) {
+      uart_send_formatted("     job %-10s runs %" PRIu32 ", max %" PRIu32
+                          " us",
+                          jobs[i].name, jobs[i].runs, jobs[i].max_run_us);
+    }
   }
 
   if (animation_task_handle) {
@@ -726,14 +733,6 @@ command_result_t uart_cmd_show_tasks(const char *args) {
                         uxTaskGetStackHighWaterMark(animation_task_handle));
   }
 
-  if (test_task_handle) {
-    const char *task_name = pcTaskGetName(test_task_handle);
-    uart_send_formatted("   Test Task: %s (Priority: %" PRIu32
-                        ", Stack: %" PRIu32 ")",
-                        task_name, uxTaskPriorityGet(test_task_handle),
-                        uxTaskGetStackHighWaterMark(test_task_handle));
-  }
-
   if (web_server_task_handle) {
     const char *task_name = pcTaskGetName(web_server_task_handle);
     uart_send_formatted("   Web Server Task: %s (Priority: %" PRIu32
@@ -892,6 +891,19 @@ static void display_queue_status(const char *name, QueueHandle_t queue) {
   }
 }
 
+// Helper function to display lock-free ring status
+static void display_ring_status(const char *name,
+                                const spsc_ring_stats_t *st) {
+  if (st->capacity == 0) {
+    uart_send_formatted("   %s: ❌ NOT CREATED", name);
+    return;
+  }
+  uart_send_formatted("   %s: [%" PRIu32 "/%" PRIu32 "] peak %" PRIu32
+                      ", pushed %" PRIu32 ", drops %" PRIu32 " %s",
+                      name, st->used, st->capacity, st->high_water, st->pushed,
+                      st->drops, st->drops ? "🔴" : "🟢");
+}
+
 command_result_t uart_cmd_show_fifos(const char *args) {
   (void)args; // Unused parameter
 
@@ -945,6 +957,14 @@ command_result_t uart_cmd_show_fifos(const char *args) {
   display_queue_status("Web Server Status", web_server_status_queue);
   display_queue_status("Test Command", test_command_queue);
 
+  uart_send_formatted("");
+  uart_send_formatted("⚡ LOCK-FREE RINGS (SPSC):");
+  spsc_ring_stats_t ring_stats;
+  spsc_ring_get_stats(&matrix_game_ring, &ring_stats);
+  display_ring_status("Matrix -> Game", &ring_stats);
+  led_pixel_ring_get_stats(&ring_stats);
+  display_ring_status("Game -> LED pixels", &ring_stats);
+
   uart_send_formatted("");
   uart_send_formatted("📊 QUEUE SUMMARY:");
   uart_send_formatted(
@@ -9,6 +9,8 @@
 #include "uart_task.h"
 #include "freertos_chess.h"
 #include "game_task.h"
+#include "game_archive.h"
+#include "game_payload.h"
 #include "led_task.h"
 #include "led_mapping.h"
 #include "../matrix_task/include/matrix_task.h"
@@ -22,6 +24,7 @@
 #include <ctype.h>
 #include <inttypes.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 static const char *TAG = "UART_GAME";
@@ -265,80 +268,74 @@ command_result_t uart_cmd_matrixtest(const char *args) {
 // GAME COMMAND HANDLERS
 // ============================================================================
 
-command_result_t uart_cmd_move(const char *args) {
-  if (!args || strlen(args) < 4) {
-    uart_send_error("❌ Missing arguments");
-    return CMD_ERROR_INVALID_SYNTAX;
+static command_result_t uart_piece_up(const char *square);
+static command_result_t uart_piece_dn(const char *square);
+
+command_result_t uart_cmd_move(const uart_args_t *args) {
+  // Schema "m": tah uz je rozparsovany (e2e4 / e2 e4 / e2-e4)
+  const char *from_square = args->v[0].move.from;
+  const char *to_square = args->v[0].move.to;
+
+  if (!validate_chess_squares(from_square, to_square)) {
+    uart_send_error("Invalid chess squares");
+    return CMD_ERROR_INVALID_PARAMETER;
   }
 
-  char from_square[3] = {0};
-  char to_square[3] = {0};
-
-  // Parse move notation
-  if (parse_move_notation(args, from_square, to_square)) {
-    // Validate chess squares
-    if (validate_chess_squares(from_square, to_square)) {
-      uart_send_colored_line(COLOR_INFO, "🔄 Starting move sequence");
-
-      // Step 1: Call UP command directly
-      uart_send_colored_line(COLOR_INFO, "🔄 Lifting piece...");
-      command_result_t up_result = uart_cmd_up(from_square);
-      if (up_result != CMD_SUCCESS) {
-        uart_send_error("❌ Failed to lift piece");
-        return up_result;
-      }
+  uart_send_colored_line(COLOR_INFO, "🔄 Starting move sequence");
 
-      // Step 2: Wait 500ms for animations
-      uart_send_colored_line(COLOR_INFO, "⏳ Waiting for animations...");
-      vTaskDelay(pdMS_TO_TICKS(500));
-
-      // Step 3: Send DROP command WITH validation via EXISTING response queue
-      uart_send_colored_line(COLOR_INFO, "🔄 Placing piece...");
-
-      // Použití existující globální uart_response_queue
-      chess_move_command_t drop_cmd = {.type = GAME_CMD_DROP,
-                                       .player = 0,
-                                       .response_queue =
-                                           (QueueHandle_t)uart_response_queue};
-      strcpy(drop_cmd.from_notation, "");
-      strncpy(drop_cmd.to_notation, to_square,
-              sizeof(drop_cmd.to_notation) - 1);
-      drop_cmd.to_notation[sizeof(drop_cmd.to_notation) - 1] = '\0';
-
-      // Send to game task
-      if (!send_to_game_task(&drop_cmd)) {
-        uart_send_error("❌ Failed to send DROP command");
-        return CMD_ERROR_SYSTEM_ERROR;
-      }
+  // Step 1: Call UP command directly
+  uart_send_colored_line(COLOR_INFO, "🔄 Lifting piece...");
+  command_result_t up_result = uart_piece_up(from_square);
+  if (up_result != CMD_SUCCESS) {
+    uart_send_error("❌ Failed to lift piece");
+    return up_result;
+  }
 
-      // Wait for validation response from game_task
-      game_response_t response;
-      if (xQueueReceive(uart_response_queue, &response, pdMS_TO_TICKS(5000)) ==
-          pdTRUE) {
-        if (response.error_code != 0) {
-          // Invalid move!
-          uart_send_error(response.message);
-          uart_send_error("❌ Invalid move - piece must be returned");
-          return CMD_ERROR_INVALID_PARAMETER;
-        }
+  // Step 2: Wait 500ms for animations
+  uart_send_colored_line(COLOR_INFO, "⏳ Waiting for animations...");
+  vTaskDelay(pdMS_TO_TICKS(500));
+
+  // Step 3: Send DROP command WITH validation via EXISTING response queue
+  uart_send_colored_line(COLOR_INFO, "🔄 Placing piece...");
+
+  // Použití existující globální uart_response_queue
+  chess_move_command_t drop_cmd = {.type = GAME_CMD_DROP,
+                                   .player = 0,
+                                   .response_queue =
+                                       (QueueHandle_t)uart_response_queue};
+  strcpy(drop_cmd.from_notation, "");
+  strncpy(drop_cmd.to_notation, to_square,
+          sizeof(drop_cmd.to_notation) - 1);
+  drop_cmd.to_notation[sizeof(drop_cmd.to_notation) - 1] = '\0';
+
+  // Send to game task
+  if (!send_to_game_task(&drop_cmd)) {
+    uart_send_error("❌ Failed to send DROP command");
+    return CMD_ERROR_SYSTEM_ERROR;
+  }
 
-        // Valid move!
-        uart_send_colored_line(
-            COLOR_INFO,
-            "💡 LEDs: Blue flash (piece placed), then Yellow (movable pieces)");
-        uart_send_success("✅ Move completed");
-        return CMD_SUCCESS;
-      } else {
-        uart_send_error("❌ Timeout waiting for move validation");
-        return CMD_ERROR_SYSTEM_ERROR;
-      }
-    } else {
-      uart_send_error("Invalid chess squares");
+  // Wait for validation response from game_task
+  game_response_t response;
+  if (xQueueReceive(uart_response_queue, &response, pdMS_TO_TICKS(5000)) ==
+      pdTRUE) {
+    if (response.error_code != 0) {
+      // Invalid move!
+      uart_send_error(game_payload_str(response.text));
+      game_response_release(&response);
+      uart_send_error("❌ Invalid move - piece must be returned");
       return CMD_ERROR_INVALID_PARAMETER;
     }
+    game_response_release(&response);
+
+    // Valid move!
+    uart_send_colored_line(
+        COLOR_INFO,
+        "💡 LEDs: Blue flash (piece placed), then Yellow (movable pieces)");
+    uart_send_success("✅ Move completed");
+    return CMD_SUCCESS;
   } else {
-    uart_send_error("Invalid move format");
-    return CMD_ERROR_INVALID_SYNTAX;
+    uart_send_error("❌ Timeout waiting for move validation");
+    return CMD_ERROR_SYSTEM_ERROR;
   }
 }
 
@@ -352,38 +349,13 @@ void uart_display_move_animation(const char *from, const char *to) {
   uart_send_colored_line(COLOR_INFO, "🔄 Move animation");
 }
 
-command_result_t uart_cmd_up(const char *args) {
-  if (!args || strlen(args) < 2) {
-    uart_send_error("❌ Missing arguments");
-    uart_send_info("Usage: UP <square>");
-    uart_send_info("Examples: UP a2, UP e4");
-    return CMD_ERROR_INVALID_SYNTAX;
-  }
-
-  // Parse square notation (support both "a2" and "a 2" formats)
-  char square[4];
-  if (strlen(args) == 2) {
-    // Format: "a2"
-    strncpy(square, args, 2);
-    square[2] = '\0';
-  } else if (strlen(args) == 3 && args[1] == ' ') {
-    // Format: "a 2"
-    square[0] = args[0];
-    square[1] = args[2];
-    square[2] = '\0';
-  } else {
-    uart_send_error("❌ Invalid square format");
-    uart_send_info("Use format: a2 or a 2");
-    return CMD_ERROR_INVALID_SYNTAX;
-  }
-
-  // Validate square notation
-  if (!is_valid_square_notation(square)) {
-    uart_send_error("❌ Invalid square notation");
-    uart_send_info("Use format: a2, b3, c4, etc.");
-    return CMD_ERROR_INVALID_SYNTAX;
-  }
+command_result_t uart_cmd_up(const uart_args_t *args) {
+  // Schema "s": pole je rozparsovane a zvalidovane (a1-h8)
+  return uart_piece_up(args->v[0].square);
+}
 
+/** Zvedne figurku na poli `square` (a1-h8) a pocka na odpoved game tasku. */
+static command_result_t uart_piece_up(const char *square) {
   // Send pickup command to game task WITH response queue
   chess_move_command_t cmd = {.type = GAME_CMD_PICKUP,
                               .player = 0, // Will be determined by game task
@@ -404,9 +376,11 @@ command_result_t uart_cmd_up(const char *args) {
       pdTRUE) {
     if (response.error_code != 0) {
       // Chyba při zvednutí!
-      uart_send_error(response.message);
+      uart_send_error(game_payload_str(response.text));
+      game_response_release(&response);
       return CMD_ERROR_INVALID_PARAMETER;
     }
+    game_response_release(&response);
 
     // Úspěch!
     char msg[64];
@@ -422,38 +396,13 @@ command_result_t uart_cmd_up(const char *args) {
   }
 }
 
-command_result_t uart_cmd_dn(const char *args) {
-  if (!args || strlen(args) < 2) {
-    uart_send_error("❌ Missing arguments");
-    uart_send_info("Usage: DN <square>");
-    uart_send_info("Examples: DN a3, DN e5");
-    return CMD_ERROR_INVALID_SYNTAX;
-  }
-
-  // Parse square notation (support both "a3" and "a 3" formats)
-  char square[4];
-  if (strlen(args) == 2) {
-    // Format: "a3"
-    strncpy(square, args, 2);
-    square[2] = '\0';
-  } else if (strlen(args) == 3 && args[1] == ' ') {
-    // Format: "a 3"
-    square[0] = args[0];
-    square[1] = args[2];
-    square[2] = '\0';
-  } else {
-    uart_send_error("❌ Invalid square format");
-    uart_send_info("Use format: a3 or a 3");
-    return CMD_ERROR_INVALID_SYNTAX;
-  }
-
-  // Validate square notation
-  if (!is_valid_square_notation(square)) {
-    uart_send_error("❌ Invalid square notation");
-    uart_send_info("Use format: a3, b4, c5, etc.");
-    return CMD_ERROR_INVALID_SYNTAX;
-  }
+command_result_t uart_cmd_dn(const uart_args_t *args) {
+  // Schema "s": pole je rozparsovane a zvalidovane (a1-h8)
+  return uart_piece_dn(args->v[0].square);
+}
 
+/** Polozi figurku na poli `square` (a1-h8) a pocka na odpoved game tasku. */
+static command_result_t uart_piece_dn(const char *square) {
   // Send drop command to game task WITH response queue for validation
   chess_move_command_t cmd = {.type = GAME_CMD_DROP,
                               .player = 0, // Will be determined by game task
@@ -474,9 +423,11 @@ command_result_t uart_cmd_dn(const char *args) {
       pdTRUE) {
     if (response.error_code != 0) {
       // Invalid move - game_task poslal error!
-      uart_send_error(response.message);
+      uart_send_error(game_payload_str(response.text));
+      game_response_release(&response);
       return CMD_ERROR_INVALID_PARAMETER;
     }
+    game_response_release(&response);
 
     // Valid move!
     char msg[64];
@@ -1115,3 +1066,120 @@ command_result_t uart_cmd_game_history(const char *args) {
     return CMD_ERROR_SYSTEM_ERROR;
   }
 }
+
+// ============================================================================
+// ARCHIV HER (SAVE / LOAD / LIST_GAMES / DELETE_GAME)
+// ============================================================================
+
+/** Jmeno hry z argumentu (bez mezer kolem); false + chyba na UART. */
+static bool uart_archive_parse_name(const char *args, const char *usage,
+                                    char out[GAME_ARCHIVE_NAME_MAX]) {
+  while (args != NULL && isspace((unsigned char)*args)) {
+    args++;
+  }
+  size_t len = args != NULL ? strlen(args) : 0;
+  while (len > 0 && isspace((unsigned char)args[len - 1])) {
+    len--;
+  }
+  if (len == 0 || len >= GAME_ARCHIVE_NAME_MAX) {
+    uart_send_error("❌ Invalid game name");
+    uart_send_info(usage);
+    return false;
+  }
+  memcpy(out, args, len);
+  out[len] = '\0';
+  if (!game_archive_name_valid(out)) {
+    uart_send_error("❌ Invalid game name (A-Z a-z 0-9 _ - . only)");
+    return false;
+  }
+  return true;
+}
+
+/** Posle archivni prikaz game tasku a vypise jeho odpoved. */
+static command_result_t uart_archive_request(uint8_t type, const char *name,
+                                             uint32_t timeout_ms) {
+  chess_move_command_t cmd = {.type = type,
+                              .player = 0,
+                              .response_queue =
+                                  (QueueHandle_t)uart_response_queue};
+  cmd.timer_data.archive.name = game_payload_alloc_str(name);
+  if (cmd.timer_data.archive.name == GAME_PAYLOAD_NONE) {
+    uart_send_error("❌ System busy, try again");
+    return CMD_ERROR_SYSTEM_ERROR;
+  }
+
+  if (!send_to_game_task(&cmd)) {
+    game_payload_release(cmd.timer_data.archive.name);
+    return CMD_ERROR_SYSTEM_ERROR;
+  }
+  game_response_t response;
+  if (xQueueReceive(uart_response_queue, &response,
+                    pdMS_TO_TICKS(timeout_ms)) != pdTRUE) {
+    uart_send_error("❌ Timeout waiting for game response");
+    return CMD_ERROR_SYSTEM_ERROR;
+  }
+  bool failed = (response.error_code != 0);
+  if (failed) {
+    uart_send_error(game_payload_str(response.text));
+  } else {
+    uart_send_colored_line(COLOR_INFO, game_payload_str(response.text));
+  }
+  game_response_release(&response);
+  return failed ? CMD_ERROR_INVALID_PARAMETER : CMD_SUCCESS;
+}
+
+command_result_t uart_cmd_save_game(const char *args) {
+  char name[GAME_ARCHIVE_NAME_MAX];
+  if (!uart_archive_parse_name(args, "Usage: SAVE <name>", name)) {
+    return CMD_ERROR_INVALID_SYNTAX;
+  }
+  return uart_archive_request(GAME_CMD_SAVE, name, 3000);
+}
+
+command_result_t uart_cmd_load_game(const char *args) {
+  char name[GAME_ARCHIVE_NAME_MAX];
+  if (!uart_archive_parse_name(args, "Usage: LOAD <name>", name)) {
+    return CMD_ERROR_INVALID_SYNTAX;
+  }
+  /* LOAD muze cekat na dopsani predchoziho SAVE (persist flush). */
+  command_result_t res = uart_archive_request(GAME_CMD_LOAD, name, 5000);
+  if (res == CMD_SUCCESS) {
+    uart_send_info("Use 'BOARD' to see the loaded position");
+  }
+  return res;
+}
+
+command_result_t uart_cmd_delete_game(const char *args) {
+  char name[GAME_ARCHIVE_NAME_MAX];
+  if (!uart_archive_parse_name(args, "Usage: DELETE_GAME <name>", name)) {
+    return CMD_ERROR_INVALID_SYNTAX;
+  }
+  return uart_archive_request(GAME_CMD_DELETE_GAME, name, 3000);
+}
+
+command_result_t uart_cmd_list_games(const char *args) {
+  /* Jen cteni indexu — bez game tasku, stranka = seek + par zaznamu. */
+  uint32_t page = 1;
+  if (args != NULL && *args != '\0') {
+    page = (uint32_t)strtoul(args, NULL, 10);
+    if (page == 0) {
+      page = 1;
+    }
+  }
+  char text[1024];
+  esp_err_t ret = game_archive_format_page(text, sizeof(text), page);
+  if (ret != ESP_OK) {
+    uart_send_error(text);
+    return CMD_ERROR_SYSTEM_ERROR;
+  }
+  char *line = text;
+  while (line != NULL && *line != '\0') {
+    char *nl = strchr(line, '\n');
+    if (nl != NULL) {
+      *nl = '\0';
+    }
+    uart_send_line(line);
+    line = (nl != NULL) ? nl + 1 : NULL;
+  }
+  return CMD_SUCCESS;
+}
@@ -227,19 +227,20 @@ command_result_t uart_cmd_timer_config(const char *args) {
       return CMD_ERROR_INVALID_SYNTAX;
     }
     cmd.timer_data.timer_config.time_control_type = TIME_CONTROL_CUSTOM;
-    cmd.timer_data.timer_config.custom_minutes = (uint32_t)atoi(arg2);
-    cmd.timer_data.timer_config.custom_increment = (uint32_t)atoi(arg3);
+    int minutes = atoi(arg2);
+    int increment = atoi(arg3);
 
-    // Validate custom values
-    if (cmd.timer_data.timer_config.custom_minutes < 1 ||
-        cmd.timer_data.timer_config.custom_minutes > 180) {
+    // Validate custom values (pred zuzenim na uint16_t)
+    if (minutes < 1 || minutes > 180) {
       uart_send_error("❌ Minutes must be between 1 and 180");
       return CMD_ERROR_INVALID_PARAMETER;
     }
-    if (cmd.timer_data.timer_config.custom_increment > 60) {
+    if (increment < 0 || increment > 60) {
       uart_send_error("❌ Increment must be between 0 and 60 seconds");
       return CMD_ERROR_INVALID_PARAMETER;
     }
+    cmd.timer_data.timer_config.custom_minutes = (uint16_t)minutes;
+    cmd.timer_data.timer_config.custom_increment = (uint16_t)increment;
   } else {
     int type = atoi(arg1);
     if (type < 0 || type >= TIME_CONTROL_MAX) {
@@ -253,8 +254,8 @@ command_result_t uart_cmd_timer_config(const char *args) {
     }
     cmd.timer_data.timer_config.time_control_type = (uint8_t)type;
     if (type == TIME_CONTROL_CUSTOM && parsed >= 3) {
-      cmd.timer_data.timer_config.custom_minutes = (uint32_t)atoi(arg2);
-      cmd.timer_data.timer_config.custom_increment = (uint32_t)atoi(arg3);
+      cmd.timer_data.timer_config.custom_minutes = (uint16_t)atoi(arg2);
+      cmd.timer_data.timer_config.custom_increment = (uint16_t)atoi(arg3);
     }
   }
 
@@ -0,0 +1,511 @@
+/**
+ * @file uart_jsonl.c
+ * @brief JSON Lines protokol na konzoli (viz uart_jsonl.h)
+ *
+ * Pozadavky parsuje cJSON, odpovedi skladaji json_writer a exportery game
+ * tasku (stejne jako web API). Radek se posle jednim zapisem pod uart_mutex.
+ * Tahy jdou game tasku jednou davkou GAME_CMD_MOVE_BATCH.
+ */
+
+#include "uart_jsonl.h"
+#include "uart_task_internal.h"
+
+#include "uart_task.h"
+#include "config_registry.h"
+#include "freertos_chess.h"
+#include "game_payload.h"
+#include "game_task.h"
+#include "json_writer.h"
+
+#include "cJSON.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+
+#include <ctype.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char *TAG = "UART_JSONL";
+
+/** Cekani na odpoved game tasku (davka 128 tahu se vejde s rezervou). */
+#define JSONL_GAME_TIMEOUT_MS 5000
+/** Pocatecni velikost heap bufferu odpovedi (status ~1 KiB). */
+#define JSONL_REPLY_INITIAL 256
+
+static bool s_active = false;
+static char s_line[UART_JSONL_LINE_MAX];
+static size_t s_line_len = 0;
+static bool s_line_overflow = false;
+
+/** Nazvy move_error_t pro pole "error" (index = kod). */
+static const char *const s_move_error_names[] = {
+    "none",
+    "invalid_syntax",
+    "invalid_parameter",
+    "piece_not_found",
+    "invalid_move",
+    "blocked_path",
+    "check_violation",
+    "system_error",
+    "no_piece",
+    "wrong_color",
+    "invalid_pattern",
+    "king_in_check",
+    "castling_blocked",
+    "en_passant_invalid",
+    "destination_occupied",
+    "out_of_bounds",
+    "game_not_active",
+    "invalid_move_structure",
+    "invalid_coordinates",
+    "illegal_move",
+};
+
+static const char *jsonl_move_error_name(uint8_t code) {
+  if (code < sizeof(s_move_error_names) / sizeof(s_move_error_names[0])) {
+    return s_move_error_names[code];
+  }
+  return "move_error";
+}
+
+// ============================================================================
+// ODPOVEDI
+// ============================================================================
+
+/** Zacne odpoved: {"id":<id pozadavku>,"ok":<ok> */
+static esp_err_t jsonl_reply_begin(json_writer_t *w, const cJSON *id, bool ok) {
+  esp_err_t ret = json_writer_init_heap(w, JSONL_REPLY_INITIAL);
+  if (ret != ESP_OK) {
+    return ret;
+  }
+  json_writer_begin_object(w);
+  json_writer_key(w, "id");
+  if (cJSON_IsNumber(id) && id->valuedouble >= 0) {
+    json_writer_uint(w, (uint64_t)id->valuedouble);
+  } else if (cJSON_IsString(id)) {
+    json_writer_string(w, id->valuestring);
+  } else {
+    json_writer_null(w);
+  }
+  json_writer_kv_bool(w, "ok", ok);
+  return ESP_OK;
+}
+
+/** Uzavre objekt a posle radek jednim zapisem. */
+static void jsonl_reply_send(json_writer_t *w) {
+  json_writer_end_object(w);
+  json_writer_text(w, "\n", 1);
+  char *line = json_writer_take(w, NULL);
+  if (line == NULL) {
+    ESP_LOGW(TAG, "reply dropped (no memory)");
+    return;
+  }
+  uart_write_string_immediate(line);
+  free(line);
+}
+
+static void jsonl_reply_error(const cJSON *id, const char *error) {
+  json_writer_t w;
+  if (jsonl_reply_begin(&w, id, false) != ESP_OK) {
+    return;
+  }
+  json_writer_kv_string(&w, "error", error);
+  jsonl_reply_send(&w);
+}
+
+static void jsonl_reply_ok(const cJSON *id) {
+  json_writer_t w;
+  if (jsonl_reply_begin(&w, id, true) != ESP_OK) {
+    return;
+  }
+  jsonl_reply_send(&w);
+}
+
+/** "status":{...} — stejna pole jako GET /api/status (game cast). */
+static void jsonl_write_status(json_writer_t *w) {
+  json_writer_key(w, "status");
+  json_writer_begin_object(w);
+  (void)game_write_status_fields(w);
+  json_writer_end_object(w);
+}
+
+// ============================================================================
+// GAME TASK
+// ============================================================================
+
+/**
+ * Posle prikaz game tasku a pocka na odpoved (bez lidskeho vystupu).
+ * @param payload Payload prikazu; kdyz se prikaz do fronty nedostane, uvolni se
+ * @return NULL pri uspechu, jinak nazev chyby pro "error"
+ */
+static const char *jsonl_game_call(chess_move_command_t *cmd,
+                                   game_payload_t payload,
+                                   game_response_t *response) {
+  if (game_command_queue == NULL || uart_response_queue == NULL) {
+    game_payload_release(payload);
+    return "unavailable";
+  }
+  cmd->response_queue = uart_response_queue;
+  game_response_drain(uart_response_queue);
+  if (xQueueSend(game_command_queue, cmd, pdMS_TO_TICKS(100)) != pdTRUE) {
+    game_payload_release(payload);
+    return "busy";
+  }
+  if (xQueueReceive(uart_response_queue, response,
+                    pdMS_TO_TICKS(JSONL_GAME_TIMEOUT_MS)) != pdTRUE) {
+    return "timeout";
+  }
+  return NULL;
+}
+
+/** Jeden tah UCI ("e2e4", "e7e8q") → GAME_MOVE_BATCH_PACK. */
+static bool jsonl_parse_move(const char *s, size_t len, uint16_t *out) {
+  if (len != 4 && len != 5) {
+    return false;
+  }
+  uint8_t sq[2];
+  for (int i = 0; i < 2; i++) {
+    char file = (char)tolower((unsigned char)s[i * 2]);
+    char rank = s[i * 2 + 1];
+    if (file < 'a' || file > 'h' || rank < '1' || rank > '8') {
+      return false;
+    }
+    sq[i] = (uint8_t)((rank - '1') * 8 + (file - 'a'));
+  }
+  promotion_choice_t promo = PROMOTION_QUEEN;
+  if (len == 5) {
+    switch (tolower((unsigned char)s[4])) {
+    case 'q':
+      promo = PROMOTION_QUEEN;
+      break;
+    case 'r':
+      promo = PROMOTION_ROOK;
+      break;
+    case 'b':
+      promo = PROMOTION_BISHOP;
+      break;
+    case 'n':
+      promo = PROMOTION_KNIGHT;
+      break;
+    default:
+      return false;
+    }
+  }
+  *out = GAME_MOVE_BATCH_PACK(sq[0], sq[1], promo);
+  return true;
+}
+
+/**
+ * "moves": pole retezcu nebo jeden retezec s tahy oddelenymi mezerou.
+ * @return Pocet tahu, -1 = chybny tah (index v *bad), -2 = spatny typ/pocet
+ */
+static int jsonl_collect_moves(const cJSON *moves, uint16_t *out, int *bad) {
+  int n = 0;
+  if (cJSON_IsArray(moves)) {
+    const cJSON *item = NULL;
+    cJSON_ArrayForEach(item, moves) {
+      if (n >= GAME_MOVE_BATCH_MAX) {
+        return -2;
+      }
+      if (!cJSON_IsString(item) ||
+          !jsonl_parse_move(item->valuestring, strlen(item->valuestring),
+                            &out[n])) {
+        *bad = n;
+        return -1;
+      }
+      n++;
+    }
+    return n;
+  }
+  if (!cJSON_IsString(moves)) {
+    return -2;
+  }
+  const char *p = moves->valuestring;
+  for (;;) {
+    while (*p == ' ' || *p == ',') {
+      p++;
+    }
+    if (*p == '\0') {
+      return n;
+    }
+    const char *start = p;
+    while (*p != '\0' && *p != ' ' && *p != ',') {
+      p++;
+    }
+    if (n >= GAME_MOVE_BATCH_MAX) {
+      return -2;
+    }
+    if (!jsonl_parse_move(start, (size_t)(p - start), &out[n])) {
+      *bad = n;
+      return -1;
+    }
+    n++;
+  }
+}
+
+/** Tah z pozadavku pro chybovou odpoved (n-ty prvek pole/retezce). */
+static void jsonl_write_move_at(json_writer_t *w, const cJSON *moves, int n) {
+  if (cJSON_IsArray(moves)) {
+    const cJSON *item = cJSON_GetArrayItem(moves, n);
+    if (cJSON_IsString(item)) {
+      json_writer_kv_string(w, "move", item->valuestring);
+    }
+    return;
+  }
+  const char *p = moves->valuestring;
+  for (int i = 0;; i++) {
+    while (*p == ' ' || *p == ',') {
+      p++;
+    }
+    const char *start = p;
+    while (*p != '\0' && *p != ' ' && *p != ',') {
+      p++;
+    }
+    if (p == start) {
+      return;
+    }
+    if (i == n) {
+      json_writer_key(w, "move");
+      json_writer_string_n(w, start, (size_t)(p - start));
+      return;
+    }
+  }
+}
+
+// ============================================================================
+// PRIKAZY
+// ============================================================================
+
+static void jsonl_cmd_moves(const cJSON *req, const cJSON *id) {
+  const cJSON *moves = cJSON_GetObjectItemCaseSensitive(req, "moves");
+  uint16_t packed[GAME_MOVE_BATCH_MAX];
+  int bad = 0;
+  int n = jsonl_collect_moves(moves, packed, &bad);
+  if (n == -1) {
+    json_writer_t w;
+    if (jsonl_reply_begin(&w, id, false) == ESP_OK) {
+      json_writer_kv_string(&w, "error", "invalid_syntax");
+      json_writer_kv_uint(&w, "index", (uint64_t)bad);
+      jsonl_write_move_at(&w, moves, bad);
+      jsonl_reply_send(&w);
+    }
+    return;
+  }
+  if (n <= 0) {
+    jsonl_reply_error(id, "bad_args");
+    return;
+  }
+
+  chess_move_command_t cmd = {.type = GAME_CMD_MOVE_BATCH};
+  cmd.timer_data.move_batch.moves =
+      game_payload_alloc(packed, (size_t)n * sizeof(uint16_t));
+  if (cmd.timer_data.move_batch.moves == GAME_PAYLOAD_NONE) {
+    jsonl_reply_error(id, "no_mem");
+    return;
+  }
+  game_response_t response;
+  const char *err =
+      jsonl_game_call(&cmd, cmd.timer_data.move_batch.moves, &response);
+  if (err != NULL) {
+    jsonl_reply_error(id, err);
+    return;
+  }
+
+  game_move_batch_result_t result = {0};
+  size_t len = 0;
+  const void *data = game_payload_data(response.text, &len);
+  if (data != NULL && len == sizeof(result)) {
+    memcpy(&result, data, sizeof(result));
+  }
+  game_response_release(&response);
+
+  json_writer_t w;
+  if (jsonl_reply_begin(&w, id, response.error_code == 0) != ESP_OK) {
+    return;
+  }
+  if (response.error_code != 0) {
+    json_writer_kv_string(&w, "error",
+                          jsonl_move_error_name(response.error_code));
+    json_writer_kv_uint(&w, "code", response.error_code);
+    json_writer_kv_uint(&w, "index", result.failed_index);
+    jsonl_write_move_at(&w, moves, result.failed_index);
+  } else {
+    json_writer_kv_uint(&w, "applied", result.applied);
+  }
+  json_writer_kv_uint(&w, "ply", result.ply);
+  json_writer_kv_uint(&w, "state_version", game_get_state_revision());
+  if (cJSON_IsTrue(cJSON_GetObjectItemCaseSensitive(req, "status"))) {
+    jsonl_write_status(&w);
+  }
+  jsonl_reply_send(&w);
+}
+
+/** Prikaz bez dat s textovou odpovedi game tasku (new_game, undo). */
+static void jsonl_cmd_simple(const cJSON *req, const cJSON *id,
+                             chess_move_command_t *cmd,
+                             game_payload_t payload) {
+  game_response_t response;
+  const char *err = jsonl_game_call(cmd, payload, &response);
+  if (err != NULL) {
+    jsonl_reply_error(id, err);
+    return;
+  }
+  bool ok = (response.error_code == 0);
+  json_writer_t w;
+  if (jsonl_reply_begin(&w, id, ok) == ESP_OK) {
+    if (!ok) {
+      json_writer_kv_string(&w, "error", game_payload_str(response.text));
+    }
+    json_writer_kv_uint(&w, "ply", game_get_move_count());
+    json_writer_kv_uint(&w, "state_version", game_get_state_revision());
+    if (cJSON_IsTrue(cJSON_GetObjectItemCaseSensitive(req, "status"))) {
+      jsonl_write_status(&w);
+    }
+    jsonl_reply_send(&w);
+  }
+  game_response_release(&response);
+}
+
+static void jsonl_cmd_new_game(const cJSON *req, const cJSON *id) {
+  chess_move_command_t cmd = {.type = GAME_CMD_NEW_GAME};
+  game_payload_t payload = GAME_PAYLOAD_NONE;
+  const cJSON *fen = cJSON_GetObjectItemCaseSensitive(req, "fen");
+  if (fen != NULL) {
+    if (!cJSON_IsString(fen) || fen->valuestring[0] == '\0') {
+      jsonl_reply_error(id, "bad_args");
+      return;
+    }
+    cmd.type = GAME_CMD_NEW_GAME_FROM_FEN;
+    payload = game_payload_alloc_str(fen->valuestring);
+    cmd.timer_data.fen_new_game.fen = payload;
+    if (payload == GAME_PAYLOAD_NONE) {
+      jsonl_reply_error(id, "no_mem");
+      return;
+    }
+  }
+  jsonl_cmd_simple(req, id, &cmd, payload);
+}
+
+static void jsonl_cmd_read(const cJSON *id, const char *cmd) {
+  json_writer_t w;
+  if (jsonl_reply_begin(&w, id, true) != ESP_OK) {
+    return;
+  }
+  if (strcmp(cmd, "status") == 0) {
+    jsonl_write_status(&w);
+  } else if (strcmp(cmd, "board") == 0) {
+    (void)game_write_board_fields(&w);
+  } else {
+    json_writer_key(&w, "history");
+    (void)game_write_history_json(&w);
+  }
+  json_writer_kv_uint(&w, "state_version", game_get_state_revision());
+  jsonl_reply_send(&w);
+}
+
+static void jsonl_cmd_hello(const cJSON *id) {
+  json_writer_t w;
+  if (jsonl_reply_begin(&w, id, true) != ESP_OK) {
+    return;
+  }
+  json_writer_kv_uint(&w, "proto", UART_JSONL_PROTO_VERSION);
+  json_writer_kv_uint(&w, "max_batch", GAME_MOVE_BATCH_MAX);
+  json_writer_kv_uint(&w, "max_line", UART_JSONL_LINE_MAX - 1);
+  jsonl_reply_send(&w);
+}
+
+static void jsonl_exit(void) {
+  s_active = false;
+  config_snapshot_t snap;
+  config_registry_get(&snap);
+  (void)config_apply_settings(&snap.system);
+  ESP_LOGI(TAG, "JSON Lines protocol off");
+}
+
+static void jsonl_handle_line(char *line) {
+  cJSON *req = cJSON_Parse(line);
+  if (!cJSON_IsObject(req)) {
+    cJSON_Delete(req);
+    jsonl_reply_error(NULL, "bad_json");
+    return;
+  }
+  const cJSON *id = cJSON_GetObjectItemCaseSensitive(req, "id");
+  const cJSON *cmd = cJSON_GetObjectItemCaseSensitive(req, "cmd");
+  command_count++;
+  last_command_time = (uint32_t)(esp_timer_get_time() / 1000);
+
+  if (!cJSON_IsString(cmd)) {
+    jsonl_reply_error(id, "bad_args");
+  } else if (strcmp(cmd->valuestring, "moves") == 0) {
+    jsonl_cmd_moves(req, id);
+  } else if (strcmp(cmd->valuestring, "status") == 0 ||
+             strcmp(cmd->valuestring, "board") == 0 ||
+             strcmp(cmd->valuestring, "history") == 0) {
+    jsonl_cmd_read(id, cmd->valuestring);
+  } else if (strcmp(cmd->valuestring, "new_game") == 0) {
+    jsonl_cmd_new_game(req, id);
+  } else if (strcmp(cmd->valuestring, "undo") == 0) {
+    chess_move_command_t undo = {.type = GAME_CMD_UNDO_MOVE};
+    jsonl_cmd_simple(req, id, &undo, GAME_PAYLOAD_NONE);
+  } else if (strcmp(cmd->valuestring, "hello") == 0) {
+    jsonl_cmd_hello(id);
+  } else if (strcmp(cmd->valuestring, "exit") == 0) {
+    jsonl_reply_ok(id);
+    jsonl_exit();
+  } else {
+    error_count++;
+    jsonl_reply_error(id, "unknown_cmd");
+  }
+  cJSON_Delete(req);
+}
+
+// ============================================================================
+// VSTUP
+// ============================================================================
+
+bool uart_jsonl_active(void) { return s_active; }
+
+void uart_jsonl_enter(void) {
+  s_active = true;
+  s_line_len = 0;
+  s_line_overflow = false;
+  /* INFO logy tahu by zahltily linku i klienta. */
+  esp_log_level_set("*", ESP_LOG_WARN);
+  jsonl_cmd_hello(NULL);
+}
+
+void uart_jsonl_input(char c) {
+  if (c != '\n' && c != '\r') {
+    if (s_line_len < UART_JSONL_LINE_MAX - 1) {
+      s_line[s_line_len++] = c;
+    } else {
+      s_line_overflow = true;
+    }
+    return;
+  }
+  if (s_line_overflow) {
+    error_count++;
+    jsonl_reply_error(NULL, "line_too_long");
+  } else if (s_line_len > 0) {
+    s_line[s_line_len] = '\0';
+    jsonl_handle_line(s_line);
+  }
+  s_line_len = 0;
+  s_line_overflow = false;
+}
+
+void uart_jsonl_rx_overflow(void) {
+  s_line_len = 0;
+  /* Zbytek preruseneho radku az po '\n' nesmi projit jako pozadavek. */
+  s_line_overflow = true;
+  jsonl_reply_error(NULL, "rx_overflow");
+}
+
+command_result_t uart_cmd_jsonl(const char *args) {
+  (void)args;
+  uart_jsonl_enter();
+  return CMD_SUCCESS;
+}
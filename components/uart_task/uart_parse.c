@@ -1,6 +1,6 @@
 /**
  * @file uart_parse.c
- * @brief Command lookup, move notation parsing, and dispatch.
+ * @brief Command lookup (perfect hash), typed argument parsing, and dispatch.
  */
 
 #include "uart_parse.h"
@@ -9,6 +9,7 @@
 
 #include "uart_task.h"
 #include "freertos_chess.h"
+#include "game_payload.h"
 
 #include "esp_log.h"
 #include "esp_timer.h"
@@ -16,82 +17,13 @@
 #include "freertos/queue.h"
 
 #include <ctype.h>
+#include <stdint.h>
+#include <stdlib.h>
 #include <string.h>
+#include <strings.h>
 
 static const char *TAG = "UART_PARSE";
 
-bool parse_move_notation(const char *input, char *from, char *to) {
-  if (!input || !from || !to)
-    return false;
-
-  // Remove leading/trailing whitespace
-  while (*input == ' ' || *input == '\t')
-    input++;
-
-  // Support formats: "e2 e4", "e2-e4", "e2e4", "E2 E4", "E2-E4", "E2E4"
-  if (strlen(input) < 4)
-    return false;
-
-  // Format: "e2 e4" or "E2 E4" (space separated)
-  if (strchr(input, ' ')) {
-    char *space = strchr(input, ' ');
-    size_t from_len = space - input;
-    if (from_len != 2)
-      return false;
-
-    strncpy(from, input, 2);
-    from[2] = '\0';
-    from[0] = tolower(from[0]); // Convert to lowercase
-
-    // Skip whitespace
-    while (*space == ' ' || *space == '\t')
-      space++;
-    if (strlen(space) != 2)
-      return false;
-
-    strncpy(to, space, 2);
-    to[2] = '\0';
-    to[0] = tolower(to[0]); // Convert to lowercase
-
-    return true;
-  }
-
-  // Format: "e2-e4" or "E2-E4" (dash separated)
-  if (strchr(input, '-')) {
-    char *dash = strchr(input, '-');
-    size_t from_len = dash - input;
-    if (from_len != 2)
-      return false;
-
-    strncpy(from, input, 2);
-    from[2] = '\0';
-    from[0] = tolower(from[0]); // Convert to lowercase
-
-    if (strlen(dash + 1) != 2)
-      return false;
-
-    strncpy(to, dash + 1, 2);
-    to[2] = '\0';
-    to[0] = tolower(to[0]); // Convert to lowercase
-
-    return true;
-  }
-
-  // Format: "e2e4" or "E2E4" (compact)
-  if (strlen(input) == 4) {
-    strncpy(from, input, 2);
-    from[2] = '\0';
-    from[0] = tolower(from[0]); // Convert to lowercase
-    strncpy(to, input + 2, 2);
-    to[2] = '\0';
-    to[0] = tolower(to[0]); // Convert to lowercase
-
-    return true;
-  }
-
-  return false;
-}
-
 bool validate_chess_squares(const char *from, const char *to) {
   if (!from || !to)
     return false;
@@ -129,6 +61,9 @@ bool send_to_game_task(const chess_move_command_t *move_cmd) {
     return false;
   }
 
+  // Stare odpovedi (timeout predchoziho prikazu) by se precetly misto nove
+  game_response_drain((QueueHandle_t)move_cmd->response_queue);
+
   // Send command to game task via queue with timeout
   if (xQueueSend(game_command_queue, move_cmd, pdMS_TO_TICKS(100)) == pdTRUE) {
     ESP_LOGI(TAG, "Move command sent: %s -> %s (player: %d)",
@@ -165,6 +100,8 @@ bool send_to_game_task_with_response(const chess_move_command_t *move_cmd,
     return false;
   }
 
+  game_response_drain(uart_response_queue);
+
   // Send command to game task via queue with timeout
   if (xQueueSend(game_command_queue, move_cmd, pdMS_TO_TICKS(100)) == pdTRUE) {
     ESP_LOGI(TAG, "Move command sent: %s -> %s (player: %d)",
@@ -174,9 +111,11 @@ bool send_to_game_task_with_response(const chess_move_command_t *move_cmd,
     game_response_t response;
     if (xQueueReceive(uart_response_queue, &response,
                       pdMS_TO_TICKS(timeout_ms)) == pdTRUE) {
-      ESP_LOGI(TAG, "Response received: %s", response.data);
-      strncpy(response_buffer, response.data, buffer_size - 1);
+      const char *text = game_payload_str(response.text);
+      ESP_LOGI(TAG, "Response received: %s", text);
+      strncpy(response_buffer, text, buffer_size - 1);
       response_buffer[buffer_size - 1] = '\0';
+      game_response_release(&response);
       return true;
     } else {
       uart_send_error("Timeout waiting for game task response");
@@ -239,29 +178,151 @@ const uart_command_t *find_command(const char *command) {
   if (command == NULL)
     return NULL;
 
-  // Convert input to uppercase for case-insensitive comparison
-  char cmd_upper[64];
-  strncpy(cmd_upper, command, sizeof(cmd_upper) - 1);
-  cmd_upper[sizeof(cmd_upper) - 1] = '\0';
+  // Perfektni hash pres nazvy i aliasy (uart_commands_hash.c); case-insensitive
+  size_t len = strlen(command);
+  if (len == 0 || len > UINT8_MAX)
+    return NULL;
+  uint32_t bucket = uart_cmd_hash(command, len, 0) & uart_cmd_hash_bucket_mask;
+  uint32_t seed = uart_cmd_hash_seeds[bucket];
+  if (seed == 0)
+    return NULL; // prazdny kos
+  const uart_cmd_slot_t *slot =
+      &uart_cmd_hash_slots[uart_cmd_hash(command, len, seed) &
+                           uart_cmd_hash_slot_mask];
+  if (slot->key == NULL || slot->len != len ||
+      strncasecmp(slot->key, command, len) != 0)
+    return NULL;
+  return &uart_commands[slot->index];
+}
+
+/** Pole "e2" / "E2" do out (malymi pismeny). */
+static bool parse_square_token(const char *tok, size_t len, char out[3]) {
+  if (len != 2)
+    return false;
+  char file = (char)tolower((unsigned char)tok[0]);
+  if (file < 'a' || file > 'h' || tok[1] < '1' || tok[1] > '8')
+    return false;
+  out[0] = file;
+  out[1] = tok[1];
+  out[2] = '\0';
+  return true;
+}
 
-  for (int i = 0; cmd_upper[i]; i++) {
-    cmd_upper[i] = toupper(cmd_upper[i]);
+/** Prepinac ON/OFF, 1/0, TRUE/FALSE, YES/NO. */
+static bool parse_bool_token(const char *tok, bool *out) {
+  static const char *const on[] = {"ON", "1", "TRUE", "YES"};
+  static const char *const off[] = {"OFF", "0", "FALSE", "NO"};
+  for (size_t i = 0; i < sizeof(on) / sizeof(on[0]); i++) {
+    if (strcasecmp(tok, on[i]) == 0) {
+      *out = true;
+      return true;
+    }
+    if (strcasecmp(tok, off[i]) == 0) {
+      *out = false;
+      return true;
+    }
   }
+  return false;
+}
+
+/**
+ * @brief Rozparsuje args podle schematu (viz uart_task.h)
+ * @return false = chybejici povinny / neplatny / prebyvajici argument
+ */
+static bool parse_command_args(const char *schema, const char *args,
+                               uart_args_t *out) {
+  memset(out, 0, sizeof(*out));
+  strncpy(out->line, args != NULL ? args : "", sizeof(out->line) - 1);
+
+  char *p = out->line;
+  bool optional = false;
+  for (const char *k = schema; *k != '\0'; k++) {
+    if (*k == '?') {
+      optional = true;
+      continue;
+    }
+    while (*p == ' ' || *p == '\t')
+      p++;
+    if (*p == '\0') {
+      return optional;
+    }
 
-  for (int i = 0; uart_commands[i].name != NULL; i++) {
-    if (strcmp(uart_commands[i].name, cmd_upper) == 0) {
-      return &uart_commands[i];
+    uart_arg_t *arg = &out->v[out->count];
+    arg->kind = *k;
+    if (*k == 'r') {
+      arg->str = p;
+      out->count++;
+      return true;
     }
 
-    // Check aliases (also case-insensitive)
-    for (int j = 0; j < 5 && uart_commands[i].aliases[j][0] != '\0'; j++) {
-      if (strcmp(uart_commands[i].aliases[j], cmd_upper) == 0) {
-        return &uart_commands[i];
+    // Jeden token; 'm' bere i "e2 e4", 's' i "a 2"
+    char *tok = p;
+    size_t len = strcspn(p, " \t");
+    char *next = p + len;
+    if (*next != '\0') {
+      *next++ = '\0';
+    }
+    p = next;
+
+    switch (*k) {
+    case 's':
+      if (len == 1 && isalpha((unsigned char)tok[0])) {
+        while (*p == ' ' || *p == '\t')
+          p++;
+        if (isdigit((unsigned char)p[0]) &&
+            (p[1] == '\0' || p[1] == ' ' || p[1] == '\t')) {
+          char joined[2] = {tok[0], p[0]};
+          p += (p[1] != '\0') ? 2 : 1;
+          if (!parse_square_token(joined, 2, arg->square))
+            return false;
+          break;
+        }
+      }
+      if (!parse_square_token(tok, len, arg->square))
+        return false;
+      break;
+    case 'm':
+      if (len == 2) {
+        while (*p == ' ' || *p == '\t')
+          p++;
+        size_t to_len = strcspn(p, " \t");
+        if (!parse_square_token(tok, 2, arg->move.from) ||
+            !parse_square_token(p, to_len, arg->move.to))
+          return false;
+        p += to_len;
+      } else if ((len == 4 || (len == 5 && tok[2] == '-')) &&
+                 parse_square_token(tok, 2, arg->move.from) &&
+                 parse_square_token(tok + len - 2, 2, arg->move.to)) {
+        // "e2e4" / "e2-e4"
+      } else {
+        return false;
       }
+      break;
+    case 'i': {
+      char *end = NULL;
+      long v = strtol(tok, &end, 10);
+      if (end == tok || *end != '\0' || v < INT32_MIN || v > INT32_MAX)
+        return false;
+      arg->i = (int32_t)v;
+      break;
+    }
+    case 'b':
+      if (!parse_bool_token(tok, &arg->b))
+        return false;
+      break;
+    case 'w':
+      arg->str = tok;
+      break;
+    default:
+      return false;
     }
+    out->count++;
   }
 
-  return NULL;
+  // Zbyle argumenty navic = chyba syntaxe
+  while (*p == ' ' || *p == '\t')
+    p++;
+  return *p == '\0';
 }
 
 command_result_t execute_command(const char *command, const char *args) {
@@ -317,7 +378,20 @@ command_result_t execute_command(const char *command, const char *args) {
   ESP_LOGI(TAG, "Executing command: %s with args: %s", cmd->name,
            args ? args : "none");
 
-  command_result_t result = cmd->handler(args);
+  command_result_t result;
+  if (cmd->args_schema != NULL) {
+    // Parsovani a validace jednou tady; handler dostane hotove hodnoty
+    uart_args_t parsed;
+    if (!parse_command_args(cmd->args_schema, args, &parsed)) {
+      uart_send_error("❌ Invalid arguments");
+      uart_send_formatted("Usage: %s", cmd->usage);
+      error_count++;
+      return CMD_ERROR_INVALID_SYNTAX;
+    }
+    result = cmd->run(&parsed);
+  } else {
+    result = cmd->handler(args);
+  }
 
   if (result == CMD_SUCCESS) {
     command_count++;
@@ -27,8 +27,9 @@
  *
  * HLAVNI SMYCKA:
  * while (1) {
- *     1. Cti znak z UART (blocking)
- *     2. Zpracuj vstup:
+ *     1. Cekej v driveru na vstup (UART event / USB-JTAG ring buffer),
+ *        precti celou davku znaku (necinny task nebezi)
+ *     2. Zpracuj kazdy znak davky:
  *        - Normalni znak -> pridej do bufferu
  *        - ENTER -> parsuj a proved prikaz
  *        - BACKSPACE -> smaz znak
@@ -61,11 +62,12 @@
  * TABULKA PRIKAZU (COMMAND TABLE)
  * =============================================================================
  *
- * Prikazy jsou organizovane v tabulce s function pointery:
- * - cmd_name: Jmeno prikazu (napr. "move")
- * - cmd_handler: Ukazatel na funkci (napr. uart_cmd_move)
- * - cmd_help: Kratka napoveda
- * - cmd_priority: Priorita (HIGH/MEDIUM/LOW)
+ * Prikazy jsou v uart_commands_table.c (uart_command_t):
+ * - name + aliasy: hledani pres perfektni hash generovany pri buildu
+ *   (tools/gen_cli_dispatch.py), O(1) bez ohledu na velikost pismen
+ * - handler: funkce s textem argumentu, nebo
+ * - args_schema + run: argumenty rozparsuje execute_command (napr. "m" pro
+ *   MOVE) a handler dostane hotove hodnoty (uart_args_t)
  *
  * Kategorie prikazu:
  * - Sachovnice: move, board, status, reset, undo
@@ -167,6 +169,8 @@
 #include "../web_server_task/include/web_server_task.h"
 #include "../web_server_task/include/board_api_auth.h"
 #include "config_manager.h"
+#include "config_persist.h"
+#include "config_registry.h"
 #include "esp_system.h"
 #include "freertos_chess.h"
 #include "game_task.h"
@@ -174,7 +178,9 @@
 #include "led_task.h"
 #include "uart_commands_table.h"
 #include "uart_cli_panel.h"
+#include "uart_jsonl.h"
 #include "uart_parse.h"
+#include "svc_loop.h"
 #include "uart_task_internal.h"
 #include <inttypes.h>
 #include <math.h>
@@ -238,6 +244,7 @@ static bool wifi_component_enabled = false;
 
 // Forward declarations for functions used before definition
 static void uart_task_legacy_loop(void);
+static void uart_rx_usb_jtag_init(void);
 
 // Missing type definitions that should be here
 // UART command structure is defined in uart_task.h
@@ -283,6 +290,20 @@ static const char *TAG = "UART_TASK";
 #define UART_BUF_SIZE 1024
 // UART_QUEUE_SIZE is now defined in freertos_chess.h
 
+#if !UART_ENABLED
+#include "driver/usb_serial_jtag.h"
+#include "driver/usb_serial_jtag_vfs.h"
+#endif
+
+// Vstup: task spi v driveru (UART event / USB-JTAG ring buffer), ne v polling
+#define UART_RX_CHUNK 128         // Max bajtu zpracovanych za jedno cteni
+#define UART_RX_IDLE_WAIT_MS 1000 // Max blokovani (WDT reset, health check)
+#define UART_RX_FULL_THRESHOLD 64 // UART: probuzeni pri zaplneni RX FIFO
+#define UART_RX_TOUT_SYMBOLS 3    // UART: probuzeni po ~3 znacich ticha
+#define UART_RX_FALLBACK_POLL_MS 20 // Bez driveru: getchar() po 20 ms
+#define UART_HEALTH_PERIOD_MS 30000
+#define UART_STATUS_PERIOD_MS 60000
+
 // ============================================================================
 // ESP-IDF UART DRIVER FUNCTIONS
 // ============================================================================
@@ -436,6 +457,7 @@ static bool task_running = false;
 bool color_enabled = true; // ANSI color support
 static input_buffer_t input_buffer;
 static command_history_t command_history;
+/** Pracovni kopie pro prikazy; zdroj pravdy je config_registry.h. */
 static system_config_t system_config;
 
 // Arrow key navigation state
@@ -456,6 +478,10 @@ uint32_t command_count = 0;
 uint32_t error_count = 0;
 uint32_t last_command_time = 0;
 
+// RX driver: UART event fronta, resp. nainstalovany USB-JTAG driver
+static QueueHandle_t uart_rx_event_queue = NULL;
+static bool uart_rx_driver_ready = false;
+
 // ============================================================================
 // ANSI COLOR CODES AND FORMATTING
 // ============================================================================
@@ -1580,6 +1606,10 @@ void uart_cmd_help_game(void) {
       "  MOVES pawn     - Show moves for all pawns of current player");
   uart_send_formatted("  GAME_HISTORY   - Display complete move history");
   uart_send_formatted("  UNDO           - Undo the last move");
+  uart_send_formatted("  SAVE name      - Save game to the archive");
+  uart_send_formatted("  LOAD name      - Load a saved game");
+  uart_send_formatted("  LIST_GAMES [n] - List saved games (page n)");
+  uart_send_formatted("  DELETE_GAME name - Delete a saved game");
 
   uart_send_formatted("");
   if (color_enabled)
@@ -2146,22 +2176,24 @@ void uart_cmd_help_debug(void) {
     uart_write_string_immediate("\033[0m"); // reset colors
 }
 
-command_result_t uart_cmd_verbose(const char *args) {
-  if (args == NULL || strlen(args) == 0) {
-    uart_send_warning("Usage: VERBOSE ON/OFF");
-    return CMD_ERROR_INVALID_SYNTAX;
-  }
-
-  // Case-insensitive comparison
-  char args_upper[16];
-  strncpy(args_upper, args, sizeof(args_upper) - 1);
-  args_upper[sizeof(args_upper) - 1] = '\0';
+/** Pracovni kopie z registry (mezitim ji mohl zmenit web nebo BLE). */
+static void uart_config_refresh(void) {
+  config_snapshot_t snap;
+  config_registry_get(&snap);
+  system_config = snap.system;
+}
 
-  for (int i = 0; args_upper[i]; i++) {
-    args_upper[i] = toupper(args_upper[i]);
-  }
+/** Pole `fields` z pracovni kopie do registry (a na pozadi do NVS). */
+static esp_err_t uart_config_commit(uint32_t fields,
+                                    config_persist_future_t *future) {
+  config_snapshot_t values = {.system = system_config};
+  return config_registry_set(fields, &values, future);
+}
 
-  if (strcmp(args_upper, "ON") == 0) {
+command_result_t uart_cmd_verbose(const uart_args_t *args) {
+  // Schema "b": ON/OFF uz rozparsovane
+  uart_config_refresh();
+  if (args->v[0].b) {
     system_config.verbose_mode = true;
     system_config.quiet_mode = false;
     esp_log_level_set("*", ESP_LOG_INFO);
@@ -2169,19 +2201,16 @@ command_result_t uart_cmd_verbose(const char *args) {
     uart_send_formatted("Verbose mode ON - detailed logging enabled");
 
     // Save to NVS
-    config_save_to_nvs(&system_config);
+    uart_config_commit(CONFIG_FIELD_VERBOSE_MODE | CONFIG_FIELD_QUIET_MODE,
+                       NULL);
 
-  } else if (strcmp(args_upper, "OFF") == 0) {
+  } else {
     system_config.verbose_mode = false;
     esp_log_level_set("*", ESP_LOG_ERROR);
     uart_send_formatted("Verbose mode OFF - minimal logging");
 
     // Save to NVS
-    config_save_to_nvs(&system_config);
-
-  } else {
-    uart_send_error("Usage: VERBOSE ON/OFF");
-    return CMD_ERROR_INVALID_PARAMETER;
+    uart_config_commit(CONFIG_FIELD_VERBOSE_MODE, NULL);
   }
 
   return CMD_SUCCESS;
@@ -2190,13 +2219,14 @@ command_result_t uart_cmd_verbose(const char *args) {
 command_result_t uart_cmd_quiet(const char *args) {
   (void)args; // Unused parameter
 
+  uart_config_refresh();
   system_config.quiet_mode = !system_config.quiet_mode;
 
   if (system_config.quiet_mode) {
     system_config.verbose_mode = false;
   }
 
-  config_save_to_nvs(&system_config);
+  uart_config_commit(CONFIG_FIELD_QUIET_MODE | CONFIG_FIELD_VERBOSE_MODE, NULL);
   config_apply_settings(&system_config);
 
   if (system_config.quiet_mode) {
@@ -2231,13 +2261,16 @@ command_result_t uart_cmd_status(const char *args) {
                       uxTaskGetStackHighWaterMark(led_task_handle));
   uart_send_formatted("  Matrix Task: %u bytes free",
                       uxTaskGetStackHighWaterMark(matrix_task_handle));
-  uart_send_formatted("  Button Task: %u bytes free",
-                      uxTaskGetStackHighWaterMark(button_task_handle));
+  if (svc_loop_task_handle() != NULL) {
+    uart_send_formatted("  Service Task: %u bytes free",
+                        uxTaskGetStackHighWaterMark(svc_loop_task_handle()));
+  }
   uart_send_formatted("  Game Task: %u bytes free",
                       uxTaskGetStackHighWaterMark(game_task_handle));
   uart_send_formatted("Uptime: %llu seconds", esp_timer_get_time() / 1000000);
   uart_send_formatted("Commands Processed: %lu", command_count);
   uart_send_formatted("Errors: %lu", error_count);
+  uart_config_refresh();
   uart_send_formatted("Verbose Mode: %s",
                       system_config.verbose_mode ? "ON" : "OFF");
   uart_send_formatted("Quiet Mode: %s",
@@ -2438,6 +2471,7 @@ command_result_t uart_cmd_reset(const char *args) {
 
   // This would actually implement reset in a real system
   vTaskDelay(pdMS_TO_TICKS(3000));
+  (void)config_persist_flush(1000);
   esp_restart();
 
   return CMD_SUCCESS;
@@ -2451,10 +2485,7 @@ command_result_t uart_cmd_reset(const char *args) {
  * @brief Toggle starting position check (hlidani postaveni figurek)
  */
 command_result_t uart_cmd_start_pos_check(const char *args) {
-  extern void game_set_starting_position_check(bool enabled);
   extern bool game_get_starting_position_check(void);
-  extern esp_err_t config_save_to_nvs(const system_config_t *config);
-  extern esp_err_t config_load_from_nvs(system_config_t *config);
 
   SAFE_WDT_RESET();
 
@@ -2478,23 +2509,12 @@ command_result_t uart_cmd_start_pos_check(const char *args) {
   }
 
   if (strcmp(arg_upper, "ON") == 0 || strcmp(arg_upper, "1") == 0) {
-    game_set_starting_position_check(true);
-    // Save to NVS
-    system_config_t config;
-    if (config_load_from_nvs(&config) == ESP_OK) {
-      config.starting_position_check_enabled = true;
-      config_save_to_nvs(&config);
-    }
+    // game_task se dozvi z registry, NVS na pozadi
+    config_set_starting_position_check(true);
     uart_send_success("♟️ Starting Position Check ENABLED");
     uart_send_formatted("   Board must be in starting position before game");
   } else if (strcmp(arg_upper, "OFF") == 0 || strcmp(arg_upper, "0") == 0) {
-    game_set_starting_position_check(false);
-    // Save to NVS
-    system_config_t config;
-    if (config_load_from_nvs(&config) == ESP_OK) {
-      config.starting_position_check_enabled = false;
-      config_save_to_nvs(&config);
-    }
+    config_set_starting_position_check(false);
     uart_send_success("♟️ Starting Position Check DISABLED");
     uart_send_formatted("   Game can start with any board setup");
   } else {
@@ -2703,7 +2723,7 @@ command_result_t uart_cmd_performance(const char *args) {
  * - echo: Zapne/vypne echo znaku (on/off)
  *
  * Pri zmene konfiguracni hodnoty se automaticky:
- * 1. Ulozi hodnota do NVS flash pomoci config_save_to_nvs()
+ * 1. Zapise se do config_registry (RAM) a pocka se na zapis do NVS flash
  * 2. Aplikuje se na system pomoci config_apply_settings()
  *
  * @note Verbose a quiet mode jsou vzajemne exkluzivni - zapnuti jednoho
@@ -2711,6 +2731,7 @@ command_result_t uart_cmd_performance(const char *args) {
  */
 command_result_t uart_cmd_config(const char *args) {
   SAFE_WDT_RESET();
+  uart_config_refresh();
 
   if (!args || strlen(args) == 0) {
     // Show all configuration
@@ -2835,17 +2856,17 @@ command_result_t uart_cmd_config(const char *args) {
   }
 
   // Handle configuration changes
-  bool config_changed = false;
+  uint32_t config_changed = 0;
 
   if (strcmp(key, "verbose") == 0) {
     if (strcmp(value, "on") == 0 || strcmp(value, "ON") == 0) {
       system_config.verbose_mode = true;
       system_config.quiet_mode = false;
-      config_changed = true;
+      config_changed = CONFIG_FIELD_VERBOSE_MODE | CONFIG_FIELD_QUIET_MODE;
       uart_send_formatted("✅ Verbose mode set to ON");
     } else if (strcmp(value, "off") == 0 || strcmp(value, "OFF") == 0) {
       system_config.verbose_mode = false;
-      config_changed = true;
+      config_changed = CONFIG_FIELD_VERBOSE_MODE;
       uart_send_formatted("✅ Verbose mode set to OFF");
     } else {
       uart_send_error("❌ Invalid value. Use 'on' or 'off'");
@@ -2855,11 +2876,11 @@ command_result_t uart_cmd_config(const char *args) {
     if (strcmp(value, "on") == 0 || strcmp(value, "ON") == 0) {
       system_config.quiet_mode = true;
       system_config.verbose_mode = false;
-      config_changed = true;
+      config_changed = CONFIG_FIELD_QUIET_MODE | CONFIG_FIELD_VERBOSE_MODE;
       uart_send_formatted("✅ Quiet mode set to ON");
     } else if (strcmp(value, "off") == 0 || strcmp(value, "OFF") == 0) {
       system_config.quiet_mode = false;
-      config_changed = true;
+      config_changed = CONFIG_FIELD_QUIET_MODE;
       uart_send_formatted("✅ Quiet mode set to OFF");
     } else {
       uart_send_error("❌ Invalid value. Use 'on' or 'off'");
@@ -2891,7 +2912,7 @@ command_result_t uart_cmd_config(const char *args) {
 
     if (valid) {
       system_config.log_level = new_level;
-      config_changed = true;
+      config_changed = CONFIG_FIELD_LOG_LEVEL;
       uart_send_formatted("✅ Log level set to %s", value);
     } else {
       uart_send_error(
@@ -2902,7 +2923,7 @@ command_result_t uart_cmd_config(const char *args) {
     int timeout = atoi(value);
     if (timeout > 0 && timeout <= 60000) { // 1ms to 60s
       system_config.command_timeout_ms = (uint32_t)timeout;
-      config_changed = true;
+      config_changed = CONFIG_FIELD_COMMAND_TIMEOUT;
       uart_send_formatted("✅ Command timeout set to %d ms", timeout);
     } else {
       uart_send_error("❌ Timeout must be between 1 and 60000 ms");
@@ -2919,8 +2940,13 @@ command_result_t uart_cmd_config(const char *args) {
   }
 
   // If configuration changed, save to NVS and apply settings
-  if (config_changed) {
-    esp_err_t ret = config_save_to_nvs(&system_config);
+  if (config_changed != 0) {
+    /* Zapis v persist tasku; UART na vysledek pocka (future). */
+    config_persist_future_t saved;
+    esp_err_t ret = uart_config_commit(config_changed, &saved);
+    if (ret == ESP_OK) {
+      ret = config_persist_wait(&saved, 2000);
+    }
     if (ret != ESP_OK) {
       uart_send_error("❌ Failed to save configuration to NVS");
       return CMD_ERROR_SYSTEM_ERROR;
@@ -3539,12 +3565,11 @@ void uart_task_start(void *pvParameters) {
   // Initialize configuration manager
   config_manager_init();
 
-  // Load configuration from NVS
-  config_load_from_nvs(&system_config);
+  // Konfigurace uz je v RAM (config_registry_init v main)
+  uart_config_refresh();
 
   // Apply configuration settings
   config_apply_settings(&system_config);
-  game_set_led_guidance_level(system_config.led_guidance_level);
 
   // Initialize input buffer and command history
   input_buffer_init(&input_buffer);
@@ -3576,17 +3601,17 @@ void uart_task_start(void *pvParameters) {
     ESP_ERROR_CHECK(uart_param_config(UART_PORT_NUM, &uart_config));
     ESP_ERROR_CHECK(uart_driver_install(UART_PORT_NUM, UART_BUF_SIZE * 2,
                                         UART_BUF_SIZE * 2, UART_QUEUE_SIZE,
-                                        NULL, 0));
+                                        &uart_rx_event_queue, 0));
 
-    // Set optimal interactivity
-    uart_set_rx_timeout(UART_PORT_NUM, pdMS_TO_TICKS(1));
+    // UART_DATA event: plne RX FIFO nebo kratke ticho po poslednim znaku
+    uart_set_rx_full_threshold(UART_PORT_NUM, UART_RX_FULL_THRESHOLD);
+    uart_set_rx_timeout(UART_PORT_NUM, UART_RX_TOUT_SYMBOLS);
     uart_flush(UART_PORT_NUM);
+    uart_rx_driver_ready = (uart_rx_event_queue != NULL);
 
     ESP_LOGI(TAG, "UART driver initialized successfully");
   } else {
-    ESP_LOGI(
-        TAG,
-        "Using USB Serial JTAG console - no UART driver initialization needed");
+    uart_rx_usb_jtag_init();
   }
 
   ESP_LOGI(TAG, "🚀 Enhanced UART command interface ready");
@@ -3630,150 +3655,145 @@ void uart_task_start(void *pvParameters) {
   vTaskDelete(NULL);
 }
 
-// Legacy main loop (kept for compatibility)
-void uart_task_legacy_loop(void) {
-  uint32_t loop_count = 0;
-  TickType_t last_wake_time = xTaskGetTickCount();
+#if !UART_ENABLED
+/**
+ * @brief Nainstaluje USB-Serial-JTAG driver a prepne na nej stdio (VFS)
+ *
+ * Bez driveru VFS cte primo z FIFO a getchar() jde jen pollovat. S driverem
+ * prijima data ISR do ring bufferu a task na nem blokuje.
+ */
+static void uart_rx_usb_jtag_init(void) {
+  usb_serial_jtag_driver_config_t usj_config = {
+      .rx_buffer_size = UART_BUF_SIZE * 2,
+      .tx_buffer_size = UART_BUF_SIZE,
+  };
+  esp_err_t ret = ESP_OK;
+  if (!usb_serial_jtag_is_driver_installed()) {
+    ret = usb_serial_jtag_driver_install(&usj_config);
+  }
+  if (ret == ESP_OK) {
+    usb_serial_jtag_vfs_use_driver();
+    uart_rx_driver_ready = true;
+    ESP_LOGI(TAG, "USB Serial JTAG driver installed (event-driven input)");
+  } else {
+    ESP_LOGE(TAG, "USB Serial JTAG driver install failed: %s - polling input",
+             esp_err_to_name(ret));
+  }
+}
+#else
+static void uart_rx_usb_jtag_init(void) {}
+#endif
 
-  for (;;) {
-    // Reset watchdog timeru pro UART task v každé iteraci
-    esp_err_t wdt_reset_ret = uart_task_wdt_reset_safe();
-    if (wdt_reset_ret != ESP_OK && wdt_reset_ret != ESP_ERR_NOT_FOUND) {
-      // WDT reset failed - this might indicate system issues
+/**
+ * @brief Pocka na vstup a precte vse, co driver ma (max `cap` bajtu)
+ *
+ * UART: nejdriv data, ktera uz jsou v ring bufferu driveru (zbytek po minulem
+ * cteni), jinak blokuje na UART event fronte. USB-JTAG: blokuje na ring
+ * bufferu driveru a vrati vse dostupne. Bez driveru fallback na getchar().
+ *
+ * @return Pocet bajtu, 0 = timeout, -1 = chyba/preteceni (vstup zahozen)
+ */
+static int uart_rx_read(uint8_t *buf, size_t cap, TickType_t wait) {
+  if (!uart_rx_driver_ready) {
+    int n = 0;
+    int ch;
+    while ((size_t)n < cap && (ch = getchar()) >= 0) {
+      buf[n++] = (uint8_t)ch;
     }
+    if (n == 0 && wait > 0) {
+      vTaskDelay(pdMS_TO_TICKS(UART_RX_FALLBACK_POLL_MS));
+    }
+    return n;
+  }
 
-    // Zpracování output queue jako první pro plynulý výstup
-    uart_process_output_queue();
-
-    // Read and process input with minimal timeout for responsiveness
-    char c;
-    int len = 0;
-
-    // ROBUST ERROR HANDLING: Wrap input reading in try-catch equivalent
-    bool input_error = false;
+#if !UART_ENABLED
+  return usb_serial_jtag_read_bytes(buf, cap, wait);
+#else
+  size_t avail = 0;
+  uart_get_buffered_data_len(UART_PORT_NUM, &avail);
+  if (avail == 0) {
+    uart_event_t event;
+    if (xQueueReceive(uart_rx_event_queue, &event, wait) != pdTRUE) {
+      return 0;
+    }
+    if (event.type == UART_FIFO_OVF || event.type == UART_BUFFER_FULL) {
+      ESP_LOGW(TAG, "UART RX overflow (event %d), input flushed",
+               (int)event.type);
+      uart_flush_input(UART_PORT_NUM);
+      xQueueReset(uart_rx_event_queue);
+      return -1;
+    }
+    if (event.type != UART_DATA) {
+      return 0;
+    }
+    uart_get_buffered_data_len(UART_PORT_NUM, &avail);
+  }
+  if (avail == 0) {
+    return 0;
+  }
+  return uart_read_bytes(UART_PORT_NUM, buf, avail < cap ? avail : cap, 0);
+#endif
+}
 
-    // Vždy použití USB Serial JTAG metody pro konzistenci
-    // This ensures the same input method is used before and after WDT errors
-    if (UART_ENABLED) {
-      // Only use UART if explicitly configured (not USB Serial JTAG)
-      esp_err_t uart_ret =
-          uart_read_bytes(UART_PORT_NUM, (uint8_t *)&c, 1, pdMS_TO_TICKS(1));
-      if (uart_ret == ESP_OK) {
-        len = 1;
-      } else if (uart_ret == ESP_ERR_TIMEOUT) {
-        len = 0; // Normal timeout, not an error
-      } else {
-        // UART error - log but continue
-        ESP_LOGW(TAG, "UART read error: %s, continuing...",
-                 esp_err_to_name(uart_ret));
-        input_error = true;
-        len = 0;
-      }
-    } else {
-      // For USB Serial JTAG (CONFIG_ESP_CONSOLE_UART_NUM=-1), use getchar
-      // This is the consistent method used before and after WDT errors
-      // Použití non-blocking přístupu pro prevenci WDT timeoutů
-
-      // Kontrola recovery módu po WDT
-      static bool wdt_recovery_mode = false;
-      static uint32_t wdt_recovery_start = 0;
-
-      // Check if we need to enter recovery mode
-      if (error_count > 0 && !wdt_recovery_mode) {
-        wdt_recovery_mode = true;
-        wdt_recovery_start = esp_timer_get_time() / 1000;
-        ESP_LOGW(TAG, "Entering WDT recovery mode");
-      }
+/**
+ * @brief Hlavni smycka: blokuje na RX driveru, zpracuje cele davky vstupu
+ *
+ * Task se budi jen kdyz driver ma data (UART: plne FIFO / ticho po znacich,
+ * USB-JTAG: prijaty paket) nebo po UART_RX_IDLE_WAIT_MS kvuli WDT a health
+ * checku. Vlozeny vice-radkovy skript se zpracuje po davkach UART_RX_CHUNK.
+ * Vystupni frontu plni jen tento task (handlery prikazu), takze staci ji
+ * vyprazdnit po kazde davce.
+ */
+static void uart_task_legacy_loop(void) {
+  TickType_t last_health = xTaskGetTickCount();
+  TickType_t last_status = last_health;
+  uint8_t rx[UART_RX_CHUNK];
 
-      // Exit recovery mode after 10 seconds
-      if (wdt_recovery_mode &&
-          (esp_timer_get_time() / 1000 - wdt_recovery_start) > 10000) {
-        wdt_recovery_mode = false;
-        error_count = 0; // Reset error count
-        ESP_LOGI(TAG, "Exiting WDT recovery mode");
-      }
+  for (;;) {
+    SAFE_WDT_RESET();
 
-      // In recovery mode, use more conservative approach
-      if (wdt_recovery_mode) {
-        // Use shorter delays and more frequent WDT resets
-        vTaskDelay(pdMS_TO_TICKS(1));
-        SAFE_WDT_RESET();
-      }
+    // Zpracování output queue jako první pro plynulý výstup
+    uart_process_output_queue();
 
-      int ch = getchar();
-      if (ch >= 0) {
-        c = (char)ch;
-        len = 1;
+    int len = uart_rx_read(rx, sizeof(rx), pdMS_TO_TICKS(UART_RX_IDLE_WAIT_MS));
+    if (len < 0) {
+      error_count++;
+      input_buffer_clear(&input_buffer);
+      esc_state = ESC_STATE_NONE;
+      if (uart_jsonl_active()) {
+        uart_jsonl_rx_overflow();
       } else {
-        // No data available - this is normal, not an error
-        len = 0;
+        uart_send_warning("⚠️ UART input overflow, buffer cleared");
       }
     }
 
-    // Process input only if we got valid data
-    if (len > 0 && !input_error) {
-      // ROBUST ERROR HANDLING: Safe input processing
-      bool processing_error = false;
-
-      // Validate input character before processing
-      if (c <=
-          127) { // Valid ASCII range (c is unsigned, so >= 0 is always true)
-        // Process the input
-        uart_process_input(c);
-      } else {
-        ESP_LOGW(TAG, "Invalid character received: 0x%02X, ignoring",
-                 (unsigned char)c);
-        processing_error = true;
+    for (int i = 0; i < len; i++) {
+      if (uart_jsonl_active()) {
+        // Protokol: bez echa a editace radku, UTF-8 v JSON retezcich projde
+        uart_jsonl_input((char)rx[i]);
+        continue;
       }
-
-      // If processing failed, clear buffer and show error
-      if (processing_error) {
+      if (rx[i] > 127) {
+        // Neplatny znak zahodi rozepsany radek (jako drive)
+        ESP_LOGW(TAG, "Invalid character received: 0x%02X, ignoring", rx[i]);
         input_buffer_clear(&input_buffer);
         uart_send_error("⚠️ Invalid input, buffer cleared");
-        // Prompt removed
+        continue;
       }
+      uart_process_input((char)rx[i]);
     }
 
-    // ROBUST ERROR HANDLING: Check for system errors and recover
-    if (input_error) {
-      // Increment error counter
-      error_count++;
-
-      // If too many errors, try to recover
-      if (error_count % 100 == 0) {
-        ESP_LOGW(TAG,
-                 "Multiple input errors detected (%lu), attempting recovery...",
-                 error_count);
-
-        // Clear any corrupted state
-        input_buffer_clear(&input_buffer);
-
-        // Re-initialize input buffer
-        input_buffer_init(&input_buffer);
-
-        // Show recovery message
-        uart_send_warning("🔄 UART input recovered, continuing...");
-        // Prompt removed
-      }
-    }
-
-    /* Paměť/log: kontrola ~1×/30 s (1 ms tick × 30000), ne každou sekundu */
-    if (loop_count % 30000 == 0) {
+    TickType_t now = xTaskGetTickCount();
+    if (now - last_health >= pdMS_TO_TICKS(UART_HEALTH_PERIOD_MS)) {
+      last_health = now;
       uart_task_health_check();
       uart_check_memory_health();
     }
-
-    /* Status řádku: při 1 ms smyčce = každých ~6 s (dřívější komentář „60 s“
-     * byl nepřesný) */
-    if (loop_count % 6000 == 0) {
+    if (now - last_status >= pdMS_TO_TICKS(UART_STATUS_PERIOD_MS)) {
+      last_status = now;
       ESP_LOGI(TAG, "UART Task Status: Commands=%lu, Errors=%lu", command_count,
                error_count);
     }
-
-    loop_count++;
-
-    // Minimal task delay for maximum responsiveness
-    vTaskDelayUntil(&last_wake_time, pdMS_TO_TICKS(1));
   }
 }
 
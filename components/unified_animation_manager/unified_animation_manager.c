@@ -1044,7 +1044,7 @@ esp_err_t animation_start_promotion(uint32_t anim_id, uint8_t promotion_led) {
     }
     
     anim->active = true;
-    anim->duration_ms = 3000; // 3 second promotion animation
+    anim->duration_ms = LED_FRAME_PROMOTION_DURATION_MS;
     anim->start_time = esp_timer_get_time() / 1000;
     anim->progress = 0.0f;
     anim->update_func = animation_update_promotion;
@@ -1065,75 +1065,12 @@ static bool animation_update_promotion(animation_state_t* anim) {
     static uint32_t frame_counter = 0;
     frame_counter++;
     
-    uint8_t promotion_led = anim->from_led;
-    
-    // Clear board
-    for (int i = 0; i < 64; i++) {
-        led_set_pixel_safe(i, 0, 0, 0);
-    }
-    
-    // Multi-stage promotion animation
-    uint32_t stage_duration = anim->duration_ms / 4; // 4 stages
+    // Snimek pocita led_frames.c (sdilene s host simulatorem tools/led_sim)
     uint32_t elapsed = (esp_timer_get_time() / 1000) - anim->start_time;
-    uint32_t stage = elapsed / stage_duration;
-    
-    if (stage >= 4) {
-        // Animation finished
-        led_clear_board_only();
-        return false; // Stop animation
-    }
+    led_frame_t frame;
+    bool running = led_frame_render_promotion(&frame, anim->from_led, elapsed,
+                                              frame_counter);
+    led_apply_frame(&frame, 0, LED_FRAME_BOARD_COUNT);
     
-    switch (stage) {
-        case 0: {
-            // Stage 1: Highlight pawn (white)
-            led_set_pixel_safe(promotion_led, 255, 255, 255);
-            break;
-        }
-        case 1: {
-            // Stage 2: Transformation effect (pulsing)
-            float brightness = 0.5f + 0.5f * sinf(frame_counter * 0.2f);
-            uint8_t color = (uint8_t)(255 * brightness);
-            led_set_pixel_safe(promotion_led, color, color, color);
-            break;
-        }
-        case 2: {
-            // Stage 3: Show promoted piece (gold)
-            led_set_pixel_safe(promotion_led, 255, 215, 0);
-            break;
-        }
-        case 3: {
-            // Stage 4: Celebration effect (rainbow burst)
-            uint32_t burst = (frame_counter / 4) % 8;
-            
-            // Rainbow color progression
-            uint8_t r, g, b;
-            if (burst < 2) {
-                r = 255; g = 0; b = 0; // Red
-            } else if (burst < 4) {
-                r = 255; g = 165; b = 0; // Orange
-            } else if (burst < 6) {
-                r = 255; g = 255; b = 0; // Yellow
-            } else {
-                r = 0; g = 255; b = 0; // Green
-            }
-            
-            // Add surrounding glow effect
-            for (int offset = -1; offset <= 1; offset++) {
-                for (int offset2 = -1; offset2 <= 1; offset2++) {
-                    if (offset == 0 && offset2 == 0) continue;
-                    int glow_row = (promotion_led / 8) + offset;
-                    int glow_col = (promotion_led % 8) + offset2;
-                    if (glow_row >= 0 && glow_row < 8 && glow_col >= 0 && glow_col < 8) {
-                        uint8_t glow_led = chess_pos_to_led_index(glow_row, glow_col);
-                        led_set_pixel_safe(glow_led, (uint8_t)(r * 0.3f), (uint8_t)(g * 0.3f), (uint8_t)(b * 0.3f));
-                    }
-                }
-            }
-            
-            led_set_pixel_safe(promotion_led, r, g, b);
-            break;
-        }
-    }
-    
-    return true; // Continue animation
+    return running;
 }
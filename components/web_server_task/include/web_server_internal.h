@@ -7,6 +7,7 @@
 
 #include "sdkconfig.h"
 #include "esp_err.h"
+#include "json_writer.h"
 #include "freertos/semphr.h"
 #include "freertos/queue.h"
 #include <stdbool.h>
@@ -21,23 +22,43 @@ struct cJSON;
 typedef void *httpd_handle_t;
 #endif
 
-#define JSON_BUFFER_SIZE 8192
-#define SNAPSHOT_BUFFER_SIZE 20480
+/** Scratch pro chunked JSON odpovědi (na stacku httpd, 1 chunk = 1 send). */
+#define HTTP_JSON_CHUNK_SIZE 512
+/** Počáteční heap pro /api/status, board, captured, advantage. */
+#define HTTP_JSON_HEAP_INITIAL_CAP 2048
+/** Počáteční heap pro snapshot; writer zdvojnásobuje podle potřeby. */
+#define SNAPSHOT_JSON_INITIAL_CAP 4096
 #define TIMER_HTTP_JSON_MAX 1024
 #define WIFI_STATUS_JSON_MAX 640
 
-extern char json_buffer[JSON_BUFFER_SIZE];
-extern char snapshot_buffer[SNAPSHOT_BUFFER_SIZE];
 extern SemaphoreHandle_t snapshot_build_mutex;
-extern uint8_t cached_brightness;
-extern bool cached_brightness_valid;
 
 esp_err_t web_server_task_wdt_reset_safe(void);
-esp_err_t build_snapshot_json(size_t *out_len);
+/** Složí snapshot JSON na heap (`*out` uvolní free()); volající drží
+ * snapshot_build_mutex. */
+esp_err_t build_snapshot_json_locked(char **out, size_t *out_len);
+void snapshot_build_mutex_take(void);
+void snapshot_build_mutex_give(void);
+
+/* Delta snapshot protokol (web_snapshot_delta.c). Klient = WS fd, nebo
+ * WEB_DELTA_CLIENT_BLE se `session` z ble_task_conn_session(). */
+#define WEB_DELTA_CLIENT_BLE (-1)
+/** Zaznamená nový build snapshotu; volající drží snapshot_build_mutex. */
+void web_snapshot_delta_note_build(uint32_t revision, const char *json,
+                                   size_t len);
+/** Zapomene stav klienta (nový WS handshake, zavřený fd). */
+void web_delta_client_reset(int client);
+/** Klient potvrdil `state_version` (resync = příští push plný). */
+void web_delta_client_ack(int client, uint32_t session, bool resync,
+                          uint32_t state_version);
+/** True + `*base`, pokud klientovi lze poslat deltu od `*base`. */
+bool web_delta_client_base(int client, uint32_t session, uint32_t *base);
+/** Po úspěšném odeslání (delta i full) — nová báze klienta. */
+void web_delta_client_sent(int client, uint32_t session, uint32_t revision);
 esp_err_t web_server_apply_hint_highlight_json_body(const char *buf);
 esp_err_t web_server_opening_dispatch_body(const char *json);
 esp_err_t web_server_opening_dispatch_json(struct cJSON *root);
-void inject_web_status_fields(char *buf, size_t buf_size);
+void web_write_status_fields(json_writer_t *w);
 void setup_tutorial_reset_finish_cooldown(void);
 bool setup_tutorial_finish_in_cooldown(void);
 void setup_tutorial_note_finish_conflict(void);
@@ -49,6 +70,9 @@ httpd_handle_t web_server_get_httpd_handle(void);
 void czechmate_ensure_snapshot_notify_queue(void);
 #if CONFIG_CHESS_ENABLE_WEB_SERVER
 void ws_broadcast_snapshot(void);
+void ws_push_service(void);
+/** @brief Pošle malý JSON event všem WS klientům (kopie, async, bez čekání) */
+void ws_broadcast_event(const char *json, size_t len);
 void web_ws_shutdown(void);
 #endif
 
@@ -64,8 +88,11 @@ esp_err_t http_get_chess_js_handler(httpd_req_t *req);
 esp_err_t http_get_demo_status_handler(httpd_req_t *req);
 esp_err_t http_get_favicon_handler(httpd_req_t *req);
 esp_err_t http_get_game_snapshot_handler(httpd_req_t *req);
+esp_err_t http_get_games_handler(httpd_req_t *req);
 esp_err_t http_get_history_handler(httpd_req_t *req);
+esp_err_t http_get_history_stream_handler(httpd_req_t *req);
 esp_err_t http_get_mqtt_status_handler(httpd_req_t *req);
+esp_err_t http_get_puzzles_handler(httpd_req_t *req);
 esp_err_t http_get_root_handler(httpd_req_t *req);
 esp_err_t http_get_settings_start_pos_check_handler(httpd_req_t *req);
 esp_err_t http_get_settings_ui_handler(httpd_req_t *req);
@@ -29,6 +29,7 @@
  * - GET /api/board - Aktualni stav sachovnice (JSON)
  * - GET /api/status - Stav hry (JSON)
  * - GET /api/history - Historie tahu (JSON)
+ * - GET /api/games?offset=&limit= - Archiv ulozenych her po strankach (JSON)
  * - GET /api/captured - Sebrane figurky (JSON)
  * - GET /api/advantage - Material advantage graf (JSON)
  * - GET /api/timer - Stav casoveho systemu (JSON)
@@ -356,14 +357,42 @@ esp_err_t wifi_load_config_from_nvs(char *ssid, size_t ssid_len, char *password,
 esp_err_t web_server_build_game_snapshot_json(char *out, size_t cap,
                                               size_t *out_len);
 
+/** Neměnný snapshot JSON s počítadlem referencí (viz web_snapshot_cache.c). */
+typedef struct web_snapshot web_snapshot_t;
+
+/**
+ * @brief Reference na sdílený snapshot (stejný JSON jako GET /api/game/snapshot).
+ *
+ * Snapshot se skládá nejvýše jednou za `game_get_state_revision()` (plus
+ * obnova po 1 s kvůli hodinám); HTTP, WebSocket, BLE i UART sdílejí jeden
+ * buffer. Data jsou platná až do `web_snapshot_release()`.
+ */
+esp_err_t web_snapshot_acquire(web_snapshot_t **out);
+
+/** Uvolní referenci z web_snapshot_acquire() (NULL je no-op). */
+void web_snapshot_release(web_snapshot_t *snap);
+
+/** JSON (NUL-terminated) držené reference. */
+const char *web_snapshot_json(const web_snapshot_t *snap);
+
+/** Délka JSON bez NUL. */
+size_t web_snapshot_len(const web_snapshot_t *snap);
+
+/** State revision, ze které snapshot vznikl (ETag). */
+uint32_t web_snapshot_revision(const web_snapshot_t *snap);
+
+/** Zahodí cache — další acquire složí snapshot znovu (změna mimo revizi). */
+void web_snapshot_cache_invalidate(void);
+
 /**
- * @brief Stejný JSON jako GET /api/game/snapshot do interního `snapshot_buffer`.
+ * @brief Složí delta JSON od revize `base` k `snap` (viz web_snapshot_delta.c)
  *
- * Šetří ~20 KB RAM oproti druhému statickému poli v BLE — mutex je uvnitř buildu.
- * Platný ukazatel jen do dalšího volání jakéhokoli snapshot buildu (HTTP/BLE).
+ * @param[out] out malloc buffer s deltou (uvolnit free())
+ * @return ESP_ERR_NOT_FOUND pokud `base` už není v historii revizí,
+ *         ESP_ERR_INVALID_SIZE pokud by delta nebyla menší než plný snapshot
  */
-esp_err_t web_server_build_game_snapshot_json_shared(char **out_json,
-                                                     size_t *out_len);
+esp_err_t web_snapshot_delta_build(const web_snapshot_t *snap, uint32_t base,
+                                   char **out, size_t *out_len);
 
 /**
  * @brief Zpracuje UTF-8 JSON z BLE GATT zápisu na příkazovou charakteristiku
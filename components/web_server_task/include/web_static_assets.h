@@ -0,0 +1,53 @@
+/**
+ * @file web_static_assets.h
+ * @brief Statické HTTP assety z flash (generuje tools/build_web_assets.py).
+ *
+ * Každý asset je ve flash jen v jedné variantě — gzip/br, pokud ušetří
+ * aspoň 10 %, jinak identity (PNG). Dostupný na dvou URI:
+ * - `uri` (např. /static/piece/PieceWhiteKing.png) — revalidace přes ETag
+ * - `hashed_uri` (…/PieceWhiteKing.<hash8>.png) — `immutable`, rok v cache
+ *
+ * Mapu uri → hashed_uri vrací /static/asset-manifest.json.
+ *
+ * S CONFIG_CHESS_ASSETS_PARTITION jsou assety v oddílu `assets` (asset_store.h)
+ * a tabulka web_static_assets[] se negeneruje; přibude GET/POST /api/assets
+ * (verze obrazu / nahrání nového build/assets.bin).
+ */
+
+#pragma once
+
+#include "esp_err.h"
+#include "esp_http_server.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+  const char *uri;        ///< Stabilní URI
+  const char *hashed_uri; ///< URI s hashem obsahu (NULL = jen `uri`)
+  const char *mime;       ///< Content-Type
+  const char *encoding;   ///< Content-Encoding ("" = identity)
+  const char *etag;       ///< Silný ETag vč. uvozovek
+  const uint8_t *data;    ///< Data ve flash (už zakódovaná)
+  size_t len;             ///< Délka `data`
+} web_static_asset_t;
+
+/** Kompilovaná tabulka (jen bez CONFIG_CHESS_ASSETS_PARTITION). */
+extern const web_static_asset_t web_static_assets[];
+extern const size_t web_static_asset_count;
+
+/** Najde asset podle URI (stabilní i hashované, bez query) a vyplní `out`. */
+bool web_static_asset_find(const char *uri, web_static_asset_t *out,
+                           bool *is_hashed);
+
+/** Registruje wildcard GET /static/… (server musí mít httpd_uri_match_wildcard). */
+esp_err_t web_static_register_http_uris(httpd_handle_t hd);
+
+#ifdef __cplusplus
+}
+#endif
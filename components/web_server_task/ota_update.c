@@ -7,6 +7,7 @@
 
 #include "board_api_auth.h"
 #include "web_server_task.h"
+#include "config_persist.h"
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -178,6 +179,7 @@ static esp_err_t ble_ota_finalize_and_restart(void) {
   ESP_LOGI(TAG, "[STAGING] BLE stream OTA OK, restart");
 #endif
   vTaskDelay(pdMS_TO_TICKS(300));
+  (void)config_persist_flush(1000);
   esp_restart();
   return ESP_OK;
 }
@@ -295,6 +297,7 @@ static void ota_https_worker_task(void *arg) {
     ESP_LOGI(TAG, "[STAGING] OTA OK, restart");
 #endif
     vTaskDelay(pdMS_TO_TICKS(500));
+    (void)config_persist_flush(1000);
     esp_restart();
   }
 
@@ -435,6 +438,7 @@ static void ota_http_worker_task(void *arg) {
   ESP_LOGI(TAG, "[STAGING] HTTP OTA OK, restart");
 #endif
   vTaskDelay(pdMS_TO_TICKS(500));
+  (void)config_persist_flush(1000);
   esp_restart();
 
 http_fail:
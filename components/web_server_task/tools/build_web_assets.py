@@ -0,0 +1,218 @@
+#!/usr/bin/env python3
+"""
+Build-time pipeline pro statické HTTP assety (volá CMake, lze spustit i ručně).
+
+Pro každý asset `uri=soubor`:
+  - JSON se minifikuje (json.dumps bez mezer), JS/CSS/HTML se nemění
+    (bez bundleru; concat_web_js.py zůstává zdrojem chess_app.js)
+  - gzip -9 (mtime=0 → deterministický výstup), volitelně brotli (--brotli,
+    vyžaduje pip install brotli)
+  - do flash jde jen nejmenší varianta; komprimovaná jen pokud ušetří >= 10 %
+    (PNG zůstávají identity, .bin obrazy pro firmware vždy)
+  - SHA-256 obsahu → silný ETag a hashovaná URI (`name.<hash8>.ext`) pro
+    `Cache-Control: immutable`
+
+Výstup: C zdroj s tabulkou `web_static_assets[]` (web_static_assets.h) +
+JSON manifest (uri → hashovaná uri) servírovaný na /static/asset-manifest.json.
+
+Spuštění z kořene repa (report velikostí, bez zápisu):
+  python3 components/web_server_task/tools/build_web_assets.py --report \\
+      /static/piece/PieceWhiteKing.png=components/web_server_task/web/piece_assets/PieceWhiteKing.png
+"""
+
+from __future__ import annotations
+
+import argparse
+import gzip
+import hashlib
+import json
+import os
+import sys
+
+MANIFEST_URI = "/static/asset-manifest.json"
+
+MIME_BY_EXT = {
+    ".png": "image/png",
+    ".js": "application/javascript; charset=utf-8",
+    ".json": "application/json; charset=utf-8",
+    ".css": "text/css; charset=utf-8",
+    ".html": "text/html; charset=utf-8",
+    ".svg": "image/svg+xml",
+    ".bin": "application/octet-stream",
+}
+
+# Binární obrazy čte firmware přímo z mapované flash — vždy identity.
+IDENTITY_EXT = {".bin"}
+
+# Komprimovaná varianta se vyplatí jen při úspoře aspoň 10 %.
+MIN_SAVING = 0.10
+
+
+def minify(path: str, data: bytes) -> bytes:
+    if path.endswith(".json"):
+        obj = json.loads(data.decode("utf-8"))
+        return json.dumps(obj, ensure_ascii=False, separators=(",", ":")).encode(
+            "utf-8"
+        )
+    return data
+
+
+def encode_variants(data: bytes, use_brotli: bool) -> list[tuple[str, bytes]]:
+    """[(encoding, bytes)] seřazené od nejmenší; "" = identity."""
+    variants = [("", data)]
+    variants.append(("gzip", gzip.compress(data, compresslevel=9, mtime=0)))
+    if use_brotli:
+        try:
+            import brotli  # type: ignore
+        except ImportError:
+            print("build_web_assets: brotli not installed, gzip only", file=sys.stderr)
+        else:
+            variants.append(("br", brotli.compress(data, quality=11)))
+    variants.sort(key=lambda v: len(v[1]))
+    return variants
+
+
+def pick_variant(data: bytes, use_brotli: bool) -> tuple[str, bytes]:
+    best_enc, best = encode_variants(data, use_brotli)[0]
+    if best_enc and len(best) > len(data) * (1.0 - MIN_SAVING):
+        return "", data
+    return best_enc, best
+
+
+def hashed_uri(uri: str, digest: str) -> str:
+    base, ext = os.path.splitext(uri)
+    return f"{base}.{digest[:8]}{ext}"
+
+
+def c_ident(uri: str) -> str:
+    return "asset_" + "".join(c if c.isalnum() else "_" for c in uri.strip("/"))
+
+
+def c_bytes(data: bytes) -> str:
+    lines = []
+    for i in range(0, len(data), 16):
+        chunk = data[i : i + 16]
+        lines.append("    " + ", ".join(f"0x{b:02x}" for b in chunk) + ",")
+    return "\n".join(lines)
+
+
+def c_string(s: str) -> str:
+    return '"' + s.replace("\\", "\\\\").replace('"', '\\"') + '"'
+
+
+def build(pairs: list[tuple[str, str]], use_brotli: bool) -> list[dict]:
+    assets = []
+    for uri, path in pairs:
+        with open(path, "rb") as f:
+            raw = f.read()
+        ext = os.path.splitext(path)[1].lower()
+        if ext not in MIME_BY_EXT:
+            raise SystemExit(f"build_web_assets: unknown type for {path}")
+        body = minify(path, raw)
+        digest = hashlib.sha256(body).hexdigest()
+        if ext in IDENTITY_EXT:
+            enc, stored = "", body
+        else:
+            enc, stored = pick_variant(body, use_brotli)
+        assets.append(
+            {
+                "uri": uri,
+                "hashed_uri": hashed_uri(uri, digest),
+                "mime": MIME_BY_EXT[ext],
+                "encoding": enc,
+                "etag": digest[:16] + ("-" + enc if enc else ""),
+                "raw_len": len(raw),
+                "data": stored,
+            }
+        )
+    manifest = json.dumps(
+        {a["uri"]: a["hashed_uri"] for a in assets}, separators=(",", ":")
+    ).encode("utf-8")
+    assets.append(
+        {
+            "uri": MANIFEST_URI,
+            "hashed_uri": None,
+            "mime": MIME_BY_EXT[".json"],
+            "encoding": "",
+            "etag": hashlib.sha256(manifest).hexdigest()[:16],
+            "raw_len": len(manifest),
+            "data": manifest,
+        }
+    )
+    return assets
+
+
+def emit_c(assets: list[dict]) -> str:
+    out = [
+        "/* Vygenerováno tools/build_web_assets.py — needitovat. */",
+        "",
+        '#include "web_static_assets.h"',
+        "",
+        "#include <stdint.h>",
+        "",
+    ]
+    for a in assets:
+        out.append(f"static const uint8_t {c_ident(a['uri'])}[] = {{")
+        out.append(c_bytes(a["data"]))
+        out.append("};")
+        out.append("")
+    out.append("const web_static_asset_t web_static_assets[] = {")
+    for a in assets:
+        hashed = c_string(a["hashed_uri"]) if a["hashed_uri"] else "NULL"
+        out.append("    {")
+        out.append(f"        .uri = {c_string(a['uri'])},")
+        out.append(f"        .hashed_uri = {hashed},")
+        out.append(f"        .mime = {c_string(a['mime'])},")
+        out.append(f"        .encoding = {c_string(a['encoding'])},")
+        out.append(f"        .etag = {c_string(chr(34) + a['etag'] + chr(34))},")
+        out.append(f"        .data = {c_ident(a['uri'])},")
+        out.append(f"        .len = {len(a['data'])},")
+        out.append("    },")
+    out.append("};")
+    out.append("")
+    out.append(
+        "const size_t web_static_asset_count ="
+        " sizeof(web_static_assets) / sizeof(web_static_assets[0]);"
+    )
+    out.append("")
+    return "\n".join(out)
+
+
+def report(assets: list[dict]) -> None:
+    total_raw = total_stored = 0
+    for a in assets:
+        total_raw += a["raw_len"]
+        total_stored += len(a["data"])
+        print(
+            f"{a['uri']:<48} {a['raw_len']:>8} -> {len(a['data']):>8} B"
+            f" {a['encoding'] or 'identity':<8} {a['etag']}"
+        )
+    print(f"{'TOTAL':<48} {total_raw:>8} -> {total_stored:>8} B")
+
+
+def parse_pair(s: str) -> tuple[str, str]:
+    uri, sep, path = s.partition("=")
+    if not sep or not uri.startswith("/static/") or not path:
+        raise argparse.ArgumentTypeError(f"expected /static/...=path, got {s!r}")
+    return uri, path
+
+
+def main() -> int:
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[1])
+    ap.add_argument("assets", nargs="+", type=parse_pair, metavar="URI=PATH")
+    ap.add_argument("--out", help="generovaný C soubor")
+    ap.add_argument("--brotli", action="store_true", help="zkusit i brotli")
+    ap.add_argument("--report", action="store_true", help="vypsat velikosti")
+    args = ap.parse_args()
+
+    assets = build(args.assets, args.brotli)
+    if args.report or not args.out:
+        report(assets)
+    if args.out:
+        with open(args.out, "w", encoding="utf-8") as f:
+            f.write(emit_c(assets))
+    return 0
+
+
+if __name__ == "__main__":
+    raise SystemExit(main())
@@ -1650,6 +1650,16 @@ function updateBotStatusPanel(text, status) {
     panel.style.display = '';
 }
 
+/** Rating, témata a postup řešení úlohy z `status.puzzle` (prázdné bez úlohy). */
+function puzzleDescribe(p) {
+    if (!p || !p.id) return '';
+    var parts = ['Úloha #' + p.id];
+    if (p.rating) parts.push('rating ' + p.rating);
+    if (Array.isArray(p.themes) && p.themes.length) parts.push(p.themes.join(', '));
+    if (p.plies > 1 && p.active === true) parts.push('tah ' + (Math.floor(p.ply / 2) + 1) + '/' + Math.ceil(p.plies / 2));
+    return parts.join(' · ');
+}
+
 /**
  * Panel „Puzzle“ (jako Bot) — povzbuzující text podle feedbacku z desky; funguje bez internetu (jen poll k desce).
  * @param {object} status - status z API nebo { puzzle: {...} }
@@ -1697,16 +1707,27 @@ function updatePuzzleStatusPanel(status, opts) {
             mode = 'illegal';
             main = 'Tenhle tah tady neplatí — zkus jiné pole. Každý mistr jednou začínal.';
             sub = p.message ? String(p.message) : '';
+        } else if (fb === 'opponent_turn') {
+            mode = 'play';
+            main = 'Správně! Teď zahraj tah soupeře — LED ukazuje, kterou figurkou a kam.';
+            sub = puzzleDescribe(p);
         } else {
             mode = 'play';
-            main = 'Jsi na tahu — najdi nejlepší pokračování. Držím palce!';
-            sub = (p.teaser && String(p.teaser).length) ? String(p.teaser) : (p.title ? String(p.title) : '');
+            main = fb === 'correct'
+                ? 'Správně! Pokračuj — najdi další tah.'
+                : 'Jsi na tahu — najdi nejlepší pokračování. Držím palce!';
+            sub = puzzleDescribe(p);
         }
     } else if (fb === 'solved') {
         show = true;
         mode = 'solved';
         main = 'Skvěle! Přesně takhle se to hraje — puzzle je hotové.';
-        sub = (p.title ? 'Úloha: ' + p.title : '') + (p.teaser ? (p.title ? ' — ' : '') + p.teaser : '');
+        sub = puzzleDescribe(p);
+    } else if (fb === 'invalid') {
+        show = true;
+        mode = 'illegal';
+        main = 'Tuhle úlohu nejde na desce dohrát — vyber prosím jinou.';
+        sub = p.message ? String(p.message) : '';
     }
 
     if (!show) {
@@ -2237,24 +2258,9 @@ window.setupTutorialSkip = setupTutorialSkip;
 window.setupTutorialCancel = setupTutorialCancel;
 window.setupTutorialFinish = setupTutorialFinish;
 
-const PUZZLE_DEFS = [
-    { id: 1, difficulty: 1, title: 'Mat 1 – Dáma na poslední řadě',
-        teaser: 'Klasický motiv: otevřený f-sloupec, dáma dá mat na f8.',
-        fen: '7k/7p/8/8/8/8/5Q2/6K1 w - - 0 1' },
-    { id: 2, difficulty: 2, title: 'Mat 1 – Dáma po sloupci',
-        teaser: 'Útok po ose: dáma stoupá z b2 na b8.',
-        fen: '6k1/5ppp/8/8/8/8/1Q6/6K1 w - - 0 1' },
-    { id: 3, difficulty: 3, title: 'Mat 1 – Věž bere věž',
-        teaser: 'Taktika zadní řady: bílá věž sebere černou na e8 a matuje krále.',
-        fen: '4r1k1/5ppp/8/8/8/8/4R3/4K3 w - - 0 1' },
-    { id: 4, difficulty: 4, title: 'Mat 1 – Školácký mat',
-        teaser: 'Známá ukázková pozice: střelec na c4, dáma na h5 — mat na f7.',
-        fen: 'r1bqkb1r/pppp1ppp/2n2n2/4p2Q/2B1P3/8/PPPP1PPP/RNB1K1NR w KQkq - 0 1' },
-    { id: 5, difficulty: 5, title: 'Mat 1 – Dáma na d8',
-        teaser: 'Centrální úder: dáma z d4 uzavře mat na poli d8.',
-        fen: '6k1/5ppp/8/8/3Q4/8/6PP/6K1 w - - 0 1' }
-];
-let selectedPuzzleId = 1;
+/** Pásma ratingu z GET /api/puzzles; konkrétní úlohu vybere deska. */
+let puzzleBands = [];
+let selectedPuzzleRating = 0;
 let puzzleSetupPhase = null;
 let puzzleSetupStepIndex = 0;
 let puzzleSetupSteps = [];
@@ -2328,25 +2334,46 @@ function puzzleSetupStartLedRefresh(sq) {
     }, SETUP_TUTORIAL_REFRESH_MS);
 }
 
+function puzzleBandLabel(b) {
+    return 'Rating ' + b.min + '–' + b.max + ' (' + b.count + ' úloh)';
+}
+
 function puzzleRenderList() {
     var list = document.getElementById('puzzle-list');
     if (!list) return;
     list.innerHTML = '';
-    PUZZLE_DEFS.forEach(function (p) {
+    if (puzzleBands.length === 0) {
+        list.textContent = 'Databáze úloh není k dispozici.';
+        return;
+    }
+    puzzleBands.forEach(function (b) {
         var btn = document.createElement('button');
         btn.type = 'button';
         btn.className = 'set-btn set-btn-sm';
         btn.style.textAlign = 'left';
-        btn.style.opacity = (p.id === selectedPuzzleId) ? '1' : '0.85';
-        btn.textContent = '[' + p.difficulty + '/5] ' + p.title + ' - ' + p.teaser;
+        btn.style.opacity = (b.min === selectedPuzzleRating) ? '1' : '0.85';
+        btn.textContent = puzzleBandLabel(b);
         btn.onclick = function () {
-            selectedPuzzleId = p.id;
+            selectedPuzzleRating = b.min;
             puzzleRenderList();
         };
         list.appendChild(btn);
     });
 }
 
+async function puzzleLoadBands() {
+    try {
+        var res = await fetch('/api/puzzles');
+        var info = res.ok ? await res.json() : null;
+        puzzleBands = (info && Array.isArray(info.bands)) ? info.bands : [];
+    } catch (e) {
+        puzzleBands = [];
+    }
+    var known = puzzleBands.some(function (b) { return b.min === selectedPuzzleRating; });
+    if (!known && puzzleBands.length > 0) selectedPuzzleRating = puzzleBands[0].min;
+    puzzleRenderList();
+}
+
 function puzzleUpdateGuidedMessage(status) {
     var box = document.getElementById('puzzle-guided-message');
     if (!box) return;
@@ -2392,7 +2419,7 @@ function openPuzzleIntro() {
     if (!ov) return;
     puzzleResetPanelsToIntro();
     puzzleSetOverlayVisible(true);
-    puzzleRenderList();
+    puzzleLoadBands();
     puzzleUpdateGuidedMessage(statusData || {});
 }
 
@@ -2401,7 +2428,7 @@ async function puzzlePrepareSelected() {
         var res = await fetch('/api/game/puzzle', {
             method: 'POST',
             headers: { 'Content-Type': 'application/json' },
-            body: JSON.stringify({ action: 'prepare', id: selectedPuzzleId })
+            body: JSON.stringify({ action: 'prepare', rating: selectedPuzzleRating })
         });
         if (!res.ok) {
             if (typeof console !== 'undefined' && console.warn) console.warn('puzzle prepare', res.status);
@@ -2412,8 +2439,8 @@ async function puzzlePrepareSelected() {
         return;
     }
     if (typeof fetchData === 'function') await fetchData();
-    var def = PUZZLE_DEFS.filter(function (x) { return x.id === selectedPuzzleId; })[0];
-    puzzleSetupSteps = buildPuzzleSetupStepsFromFen(def ? def.fen : '');
+    var prepared = statusData && statusData.puzzle ? statusData.puzzle : null;
+    puzzleSetupSteps = buildPuzzleSetupStepsFromFen(prepared && prepared.fen ? prepared.fen : '');
     puzzleSetupStepIndex = 0;
     puzzleSetupOccStable = 0;
     var intro = document.getElementById('puzzle-intro-panel');
@@ -2539,6 +2566,12 @@ function puzzleSetupSkip() {
     puzzleSetupAdvance(false);
 }
 
+/** ID úlohy vybrané při prepare (0 = nechat desku vybrat znovu podle ratingu). */
+function puzzlePreparedId() {
+    var p = statusData && statusData.puzzle ? statusData.puzzle : null;
+    return p && p.setup_active === true && p.setup_id ? p.setup_id : 0;
+}
+
 async function puzzleExecuteStart() {
     if (statusData && statusData.puzzle && statusData.puzzle.physical_match === false) {
         if (!window.confirm('Fyzická deska nemusí odpovídat očekávané pozici. Spustit puzzle?')) {
@@ -2549,7 +2582,7 @@ async function puzzleExecuteStart() {
         await fetch('/api/game/puzzle', {
             method: 'POST',
             headers: { 'Content-Type': 'application/json' },
-            body: JSON.stringify({ action: 'start', id: selectedPuzzleId })
+            body: JSON.stringify({ action: 'start', id: puzzlePreparedId() })
         });
     } catch (e) {
         if (typeof console !== 'undefined' && console.warn) console.warn(e);
@@ -3033,8 +3066,11 @@ async function fetchData() {
                     setup_active: !!pu.setup_active,
                     feedback: pu.feedback || 'none',
                     message: pu.message || '',
-                    title: pu.title || '',
-                    teaser: pu.teaser || ''
+                    id: pu.id || 0,
+                    rating: pu.rating || 0,
+                    themes: Array.isArray(pu.themes) ? pu.themes : [],
+                    ply: pu.ply || 0,
+                    plies: pu.plies || 0
                 };
             } else {
                 lastPuzzleSnapshotForOffline = null;
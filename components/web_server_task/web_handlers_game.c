@@ -6,11 +6,16 @@
 #include "web_server_task.h"
 #include "web_server_internal.h"
 #include "../game_task/include/game_task.h"
+#include "../game_task/include/game_archive.h"
+#include "../game_task/include/game_puzzle_db.h"
+#include "game_payload.h"
+#include "json_writer.h"
+#include "snapshot_bin.h"
 #include "../matrix_task/include/matrix_task.h"
 #include "../ha_light_task/include/ha_light_task.h"
 #include "../led_task/include/led_task.h"
 #include "led_mapping.h"
-#include "../config_manager/include/config_manager.h"
+#include "../config_manager/include/config_registry.h"
 
 #include "sdkconfig.h"
 #if CONFIG_CHESS_ENABLE_WEB_SERVER
@@ -24,6 +29,7 @@
 
 #include <inttypes.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 extern QueueHandle_t game_command_queue;
@@ -31,8 +37,6 @@ extern QueueHandle_t game_command_queue;
 static const char *TAG = "WEB_GAME";
 
 
-char json_buffer[JSON_BUFFER_SIZE];
-char snapshot_buffer[SNAPSHOT_BUFFER_SIZE];
 SemaphoreHandle_t snapshot_build_mutex;
 
 /** Po konfliktu při finish setup tutoriálu krátce nevolat znovu validaci (BLE + HTTP). */
@@ -54,80 +58,41 @@ void setup_tutorial_note_finish_conflict(void) {
       xTaskGetTickCount() + pdMS_TO_TICKS(900);
 }
 /** Doplnění GET /api/status o web lock, WiFi, jas, matrix guard, lampu (sdílené se snapshot). */
-void inject_web_status_fields(char *buf, size_t buf_size) {
-  char *last_brace = strrchr(buf, '}');
-  if (!last_brace) {
-    ESP_LOGW(TAG, "[STAGING] inject_web_status_fields: no closing brace in buf");
-    return;
-  }
-  size_t remaining = buf_size - (size_t)(last_brace - buf);
-  /* První blok ~370 B (+ chess_hint_limit) + druhý ~120 B — při těsném bufferu raději neposlat useknutý JSON. */
-  if (remaining < 430) {
-    ESP_LOGE(TAG,
-             "[STAGING] inject_web_status_fields: remaining=%zu B too small for "
-             "web fields (cap=%zu)",
-             remaining, buf_size);
-    return;
-  }
-  uint8_t b = cached_brightness_valid ? cached_brightness : 50;
-  int hint_lim = config_ui_prefs_get_chess_hint_limit();
-  int wr =
-      snprintf(last_brace, remaining,
-               ",\"web_locked\":%s,\"internet_connected\":%s,\"brightness\":%d,"
-               "\"guided_capture_hints_enabled\":%s,\"led_guidance_level\":%u,"
-               "\"matrix_guard_active\":%s,"
-               "\"matrix_guard_conflicts\":%u,"
-               "\"matrix_guard_lifted_low\":%lu,\"matrix_guard_lifted_high\":%lu,"
-               "\"matrix_guard_dropped_low\":%lu,\"matrix_guard_dropped_high\":%lu,"
-               "\"chess_hint_limit\":%d}",
-               web_is_locked() ? "true" : "false",
-               wifi_is_sta_connected() ? "true" : "false", (int)b,
-               game_get_guided_capture_hints_enabled() ? "true" : "false",
-               (unsigned)game_get_led_guidance_level(),
-               game_is_matrix_guard_active() ? "true" : "false",
-               (unsigned int)game_get_matrix_guard_conflict_count(),
-               (unsigned long)game_get_matrix_guard_lifted_mask_low(),
-               (unsigned long)game_get_matrix_guard_lifted_mask_high(),
-               (unsigned long)game_get_matrix_guard_dropped_mask_low(),
-               (unsigned long)game_get_matrix_guard_dropped_mask_high(),
-               hint_lim);
-  if (wr < 0 || (size_t)wr >= remaining) {
-    ESP_LOGE(TAG,
-             "[STAGING] inject_web_status_fields: first snprintf truncated "
-             "wr=%d rem=%zu",
-             wr, remaining);
-    return;
-  }
-  if (remaining >= 150) {
-    last_brace = strrchr(buf, '}');
-    if (last_brace) {
-      remaining = buf_size - (size_t)(last_brace - buf);
-      if (remaining < 130) {
-        ESP_LOGW(TAG,
-                 "[STAGING] inject_web_status_fields: skip lamp fields "
-                 "remaining=%zu",
-                 remaining);
-        return;
-      }
-      ha_mode_t light_mode = ha_light_get_mode();
-      uint8_t lr = 255, lg = 255, lb = 255, lbright = 255;
-      bool lstate = true;
-      ha_light_get_state(&lr, &lg, &lb, &lbright, &lstate);
-      uint32_t auto_sec = ha_light_get_activity_timeout_sec();
-      wr = snprintf(last_brace, remaining,
-                    ",\"light_mode\":\"%s\",\"light_state\":%s,\"light_r\":%u,"
-                    "\"light_g\":%u,\"light_b\":%u,\"auto_lamp_timeout_sec\":%lu}",
-                    (light_mode == HA_MODE_HA) ? "lamp" : "game",
-                    lstate ? "true" : "false", (unsigned)lr, (unsigned)lg,
-                    (unsigned)lb, (unsigned long)auto_sec);
-      if (wr < 0 || (size_t)wr >= remaining) {
-        ESP_LOGE(TAG,
-                 "[STAGING] inject_web_status_fields: lamp snprintf truncated "
-                 "wr=%d rem=%zu",
-                 wr, remaining);
-      }
-    }
-  }
+void web_write_status_fields(json_writer_t *w) {
+  /* Jas a limit napoved z config_registry — bez NVS a parsovani UI prefs. */
+  config_snapshot_t cfg;
+  config_registry_get(&cfg);
+  json_writer_kv_bool(w, "web_locked", web_is_locked());
+  json_writer_kv_bool(w, "internet_connected", wifi_is_sta_connected());
+  json_writer_kv_uint(w, "brightness", cfg.system.brightness_level);
+  json_writer_kv_bool(w, "guided_capture_hints_enabled",
+                      game_get_guided_capture_hints_enabled());
+  json_writer_kv_uint(w, "led_guidance_level", game_get_led_guidance_level());
+  json_writer_kv_bool(w, "matrix_guard_active", game_is_matrix_guard_active());
+  json_writer_kv_uint(w, "matrix_guard_conflicts",
+                      game_get_matrix_guard_conflict_count());
+  json_writer_kv_uint(w, "matrix_guard_lifted_low",
+                      game_get_matrix_guard_lifted_mask_low());
+  json_writer_kv_uint(w, "matrix_guard_lifted_high",
+                      game_get_matrix_guard_lifted_mask_high());
+  json_writer_kv_uint(w, "matrix_guard_dropped_low",
+                      game_get_matrix_guard_dropped_mask_low());
+  json_writer_kv_uint(w, "matrix_guard_dropped_high",
+                      game_get_matrix_guard_dropped_mask_high());
+  json_writer_kv_int(w, "chess_hint_limit", cfg.chess_hint_limit);
+
+  ha_mode_t light_mode = ha_light_get_mode();
+  uint8_t lr = 255, lg = 255, lb = 255, lbright = 255;
+  bool lstate = true;
+  ha_light_get_state(&lr, &lg, &lb, &lbright, &lstate);
+  json_writer_kv_string(w, "light_mode",
+                        (light_mode == HA_MODE_HA) ? "lamp" : "game");
+  json_writer_kv_bool(w, "light_state", lstate);
+  json_writer_kv_uint(w, "light_r", lr);
+  json_writer_kv_uint(w, "light_g", lg);
+  json_writer_kv_uint(w, "light_b", lb);
+  json_writer_kv_uint(w, "auto_lamp_timeout_sec",
+                      ha_light_get_activity_timeout_sec());
 }
 
 void snapshot_build_mutex_take(void) {
@@ -147,111 +112,80 @@ void snapshot_build_mutex_give(void) {
   }
 }
 
-/** Pod `snapshot_build_mutex` — žádný paralelní build; šetří ~1 KiB stacku na NimBLE host task. */
-static char s_clock_json_build_scratch[TIMER_HTTP_JSON_MAX];
-
-/** Stejný JSON jako GET /api/game/snapshot — do bufferu `out` (HTTP i BLE). */
-static esp_err_t build_snapshot_json_to_buffer(char *out, size_t cap,
-                                               size_t *out_len) {
-  snapshot_build_mutex_take();
+/** Stejný JSON jako GET /api/game/snapshot — jeden průchod writerem, bez
+ * mezibufferů a strlen/strrchr nad výstupem. */
+static esp_err_t web_write_snapshot_json(json_writer_t *w) {
   (void)web_server_task_wdt_reset_safe();
-  esp_err_t ret = game_get_board_json(json_buffer, sizeof(json_buffer));
+  json_writer_begin_object(w);
+  json_writer_kv_uint(w, "state_version", game_get_state_revision());
+  esp_err_t ret = game_write_board_fields(w);
   if (ret != ESP_OK) {
-    snapshot_build_mutex_give();
     return ret;
   }
   (void)web_server_task_wdt_reset_safe();
-  size_t L = strlen(json_buffer);
-  if (L < 4 || json_buffer[0] != '{' || json_buffer[L - 1] != '}') {
-    snapshot_build_mutex_give();
-    return ESP_FAIL;
-  }
-  json_buffer[L - 1] = '\0';
-  uint32_t srev = game_get_state_revision();
-  size_t pos = (size_t)snprintf(out, cap, "{\"state_version\":%" PRIu32 ",%s",
-                                srev, json_buffer + 1);
-  if (pos >= cap) {
-    json_buffer[L - 1] = '}';
-    snapshot_build_mutex_give();
-    return ESP_FAIL;
-  }
 
-  ret = game_get_status_json(json_buffer, sizeof(json_buffer));
+  json_writer_key(w, "status");
+  json_writer_begin_object(w);
+  ret = game_write_status_fields(w);
   if (ret != ESP_OK) {
-    snapshot_build_mutex_give();
     return ret;
   }
+  web_write_status_fields(w);
+  json_writer_end_object(w);
   (void)web_server_task_wdt_reset_safe();
-#ifndef NDEBUG
-  ESP_LOGI(TAG,
-           "[STAGING] build_snapshot: status raw len=%zu / cap=%zu",
-           strlen(json_buffer), sizeof(json_buffer));
-#endif
-  inject_web_status_fields(json_buffer, sizeof(json_buffer));
-#ifndef NDEBUG
-  ESP_LOGI(TAG,
-           "[STAGING] build_snapshot: status after inject len=%zu / cap=%zu",
-           strlen(json_buffer), sizeof(json_buffer));
-#endif
-  int n = snprintf(out + pos, cap - pos, ",\"status\":%s", json_buffer);
-  if (n < 0 || (size_t)n >= cap - pos) {
-    snapshot_build_mutex_give();
-    return ESP_FAIL;
-  }
-  pos += (size_t)n;
 
-  ret = game_get_history_json(json_buffer, sizeof(json_buffer));
+  json_writer_key(w, "history");
+  ret = game_write_history_json(w);
   if (ret != ESP_OK) {
-    snapshot_build_mutex_give();
     return ret;
   }
   (void)web_server_task_wdt_reset_safe();
-  n = snprintf(out + pos, cap - pos, ",\"history\":%s", json_buffer);
-  if (n < 0 || (size_t)n >= cap - pos) {
-    snapshot_build_mutex_give();
-    return ESP_FAIL;
-  }
-  pos += (size_t)n;
 
-  ret = game_get_captured_json(json_buffer, sizeof(json_buffer));
+  json_writer_key(w, "captured");
+  ret = game_write_captured_json(w);
   if (ret != ESP_OK) {
-    snapshot_build_mutex_give();
     return ret;
   }
-  (void)web_server_task_wdt_reset_safe();
-  n = snprintf(out + pos, cap - pos, ",\"captured\":%s", json_buffer);
-  if (n < 0 || (size_t)n >= cap - pos) {
-    snapshot_build_mutex_give();
-    return ESP_FAIL;
-  }
-  pos += (size_t)n;
 
-  ret = game_get_timer_json(s_clock_json_build_scratch,
-                            sizeof(s_clock_json_build_scratch));
+  chess_timer_t clock_state;
+  ret = timer_get_state(&clock_state);
   if (ret == ESP_OK) {
-    n = snprintf(out + pos, cap - pos, ",\"clock\":%s}",
-                 s_clock_json_build_scratch);
+    json_writer_key(w, "clock");
+    timer_write_state_json(w, &clock_state);
   } else {
 #ifndef NDEBUG
-    ESP_LOGW(TAG, "build_snapshot: game_get_timer_json failed: %s",
+    ESP_LOGW(TAG, "build_snapshot: timer_get_state failed: %s",
              esp_err_to_name(ret));
 #endif
-    n = snprintf(out + pos, cap - pos, "}");
-  }
-  if (n < 0 || (size_t)n >= cap - pos) {
-    snapshot_build_mutex_give();
-    return ESP_FAIL;
   }
-  pos += (size_t)n;
-
-  *out_len = pos;
-  snapshot_build_mutex_give();
-  return ESP_OK;
+  json_writer_end_object(w);
+  return json_writer_error(w);
 }
 
-esp_err_t build_snapshot_json(size_t *out_len) {
-  return build_snapshot_json_to_buffer(snapshot_buffer, sizeof(snapshot_buffer),
-                                       out_len);
+esp_err_t build_snapshot_json_locked(char **out, size_t *out_len) {
+  if (out == NULL || out_len == NULL) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  *out = NULL;
+  *out_len = 0;
+  json_writer_t w;
+  esp_err_t ret = json_writer_init_heap(&w, SNAPSHOT_JSON_INITIAL_CAP);
+  if (ret != ESP_OK) {
+    return ret;
+  }
+  ret = web_write_snapshot_json(&w);
+  if (ret != ESP_OK) {
+    json_writer_discard(&w);
+    return ret;
+  }
+  *out = json_writer_take(&w, out_len);
+  if (*out == NULL) {
+    return ESP_ERR_NO_MEM;
+  }
+#ifndef NDEBUG
+  ESP_LOGI(TAG, "[STAGING] build_snapshot: len=%zu", *out_len);
+#endif
+  return ESP_OK;
 }
 
 esp_err_t web_server_build_game_snapshot_json(char *out, size_t cap,
@@ -259,21 +193,20 @@ esp_err_t web_server_build_game_snapshot_json(char *out, size_t cap,
   if (out == NULL || out_len == NULL || cap == 0) {
     return ESP_ERR_INVALID_ARG;
   }
-  return build_snapshot_json_to_buffer(out, cap, out_len);
-}
-
-esp_err_t web_server_build_game_snapshot_json_shared(char **out_json,
-                                                     size_t *out_len) {
-  if (out_json == NULL || out_len == NULL) {
-    return ESP_ERR_INVALID_ARG;
+  web_snapshot_t *snap = NULL;
+  esp_err_t e = web_snapshot_acquire(&snap);
+  if (e != ESP_OK) {
+    return e;
   }
-  esp_err_t e =
-      build_snapshot_json_to_buffer(snapshot_buffer, sizeof(snapshot_buffer),
-                                    out_len);
-  if (e == ESP_OK) {
-    *out_json = snapshot_buffer;
+  size_t len = web_snapshot_len(snap);
+  if (len >= cap) {
+    web_snapshot_release(snap);
+    return ESP_ERR_INVALID_SIZE;
   }
-  return e;
+  memcpy(out, web_snapshot_json(snap), len + 1);
+  *out_len = len;
+  web_snapshot_release(snap);
+  return ESP_OK;
 }
 
 /** Společná logika POST /api/game/hint_highlight a BLE příkazu hint_highlight. */
@@ -338,81 +271,363 @@ esp_err_t web_server_apply_hint_highlight_json_body(const char *buf) {
 }
 
 #if CONFIG_CHESS_ENABLE_WEB_SERVER
-esp_err_t http_get_board_handler(httpd_req_t *req) {
-  ESP_LOGD(TAG, "GET /api/board");
+static esp_err_t http_json_chunk_sink(void *ctx, const char *data,
+                                      size_t len) {
+  return httpd_resp_send_chunk((httpd_req_t *)ctx, data, (ssize_t)len);
+}
 
-  // Ziskat stav sachovnice z game tasku
-  esp_err_t ret = game_get_board_json(json_buffer, sizeof(json_buffer));
+/**
+ * Odpověď jako chunked JSON přímo z writeru (scratch na stacku httpd) — pro
+ * writery, které sink nevolají pod game_mutex (historie). Chyba před prvním
+ * chunkem = 500; po něm už hlavičky odešly, socket se jen zavře.
+ */
+static esp_err_t http_send_json_stream(httpd_req_t *req,
+                                       esp_err_t (*write)(json_writer_t *w),
+                                       const char *fail_msg) {
+  char scratch[HTTP_JSON_CHUNK_SIZE];
+  json_writer_t w;
+  json_writer_init_sink(&w, scratch, sizeof(scratch), http_json_chunk_sink,
+                        req);
+  httpd_resp_set_type(req, "application/json");
+  esp_err_t ret = write(&w);
+  if (ret == ESP_OK) {
+    ret = json_writer_finish(&w);
+  }
   if (ret != ESP_OK) {
-    httpd_resp_set_status(req, "500 Internal Server Error");
-    httpd_resp_send(req, "Failed to get board state", -1);
+    ESP_LOGW(TAG, "JSON stream failed after %zu B: %s", w.flushed,
+             esp_err_to_name(ret));
+    if (w.flushed == 0) {
+      httpd_resp_set_status(req, "500 Internal Server Error");
+      httpd_resp_set_type(req, "text/plain");
+      httpd_resp_send(req, fail_msg, -1);
+    }
     return ESP_FAIL;
   }
+  return httpd_resp_send_chunk(req, NULL, 0);
+}
 
+/**
+ * Malé odpovědi zapisované pod game_mutex (board, status, captured, advantage)
+ * — na heap a jedním send, aby se nečekalo na síť s drženým mutexem.
+ */
+static esp_err_t http_send_json_heap(httpd_req_t *req,
+                                     esp_err_t (*write)(json_writer_t *w),
+                                     const char *fail_msg) {
+  json_writer_t w;
+  esp_err_t ret = json_writer_init_heap(&w, HTTP_JSON_HEAP_INITIAL_CAP);
+  if (ret == ESP_OK) {
+    ret = write(&w);
+  }
+  size_t len = 0;
+  char *json = (ret == ESP_OK) ? json_writer_take(&w, &len) : NULL;
+  if (json == NULL) {
+    json_writer_discard(&w);
+    ESP_LOGW(TAG, "JSON build failed: %s",
+             esp_err_to_name(ret != ESP_OK ? ret : ESP_ERR_NO_MEM));
+    httpd_resp_set_status(req, "500 Internal Server Error");
+    httpd_resp_send(req, fail_msg, -1);
+    return ESP_FAIL;
+  }
   httpd_resp_set_type(req, "application/json");
-  httpd_resp_send(req, json_buffer, strlen(json_buffer));
-
-  return ESP_OK;
+  ret = httpd_resp_send(req, json, (ssize_t)len);
+  free(json);
+  return ret;
 }
 
-esp_err_t http_get_status_handler(httpd_req_t *req) {
-  ESP_LOGD(TAG, "GET /api/status");
+static esp_err_t http_write_board_json(json_writer_t *w) {
+  json_writer_begin_object(w);
+  esp_err_t ret = game_write_board_fields(w);
+  json_writer_end_object(w);
+  return ret;
+}
 
-  // Ziskat stav hry z game tasku
-  esp_err_t ret = game_get_status_json(json_buffer, sizeof(json_buffer));
+static esp_err_t http_write_status_json(json_writer_t *w) {
+  json_writer_begin_object(w);
+  esp_err_t ret = game_write_status_fields(w);
   if (ret != ESP_OK) {
-    httpd_resp_set_status(req, "500 Internal Server Error");
-    httpd_resp_send(req, "Failed to get game status", -1);
-    return ESP_FAIL;
+    return ret;
   }
+  web_write_status_fields(w);
+  json_writer_end_object(w);
+  return json_writer_error(w);
+}
 
-  inject_web_status_fields(json_buffer, sizeof(json_buffer));
-
-  httpd_resp_set_type(req, "application/json");
-  httpd_resp_send(req, json_buffer, strlen(json_buffer));
+esp_err_t http_get_board_handler(httpd_req_t *req) {
+  ESP_LOGD(TAG, "GET /api/board");
+  return http_send_json_heap(req, http_write_board_json,
+                               "Failed to get board state");
+}
 
-  return ESP_OK;
+esp_err_t http_get_status_handler(httpd_req_t *req) {
+  ESP_LOGD(TAG, "GET /api/status");
+  return http_send_json_heap(req, http_write_status_json,
+                               "Failed to get game status");
 }
 
 esp_err_t http_get_history_handler(httpd_req_t *req) {
   ESP_LOGD(TAG, "GET /api/history");
+  return http_send_json_stream(req, game_write_history_json,
+                               "Failed to get move history");
+}
+
+/**
+ * Rozsah pultahu z `?from=N&limit=M` (kurzor) nebo `Range: plies=N-M`
+ * (vcetne M, jako bytes). @return false = neplatny Range/dotaz.
+ */
+static bool http_history_parse_range(httpd_req_t *req, uint32_t *start,
+                                     uint32_t *end, bool *is_range) {
+  *start = 0;
+  *end = UINT32_MAX;
+  *is_range = false;
+
+  char range[48];
+  if (httpd_req_get_hdr_value_str(req, "Range", range, sizeof(range)) ==
+      ESP_OK) {
+    if (strncmp(range, "plies=", 6) != 0) {
+      return false;
+    }
+    char *p = range + 6;
+    char *dash = strchr(p, '-');
+    if (dash == NULL || dash == p) {
+      return false; /* suffix range (-N) nepodporujeme */
+    }
+    *start = (uint32_t)strtoul(p, NULL, 10);
+    if (dash[1] != '\0') {
+      uint32_t last = (uint32_t)strtoul(dash + 1, NULL, 10);
+      if (last < *start) {
+        return false;
+      }
+      *end = last + 1;
+    }
+    *is_range = true;
+    return true;
+  }
+
+  char query[64];
+  if (httpd_req_get_url_query_str(req, query, sizeof(query)) != ESP_OK) {
+    return true;
+  }
+  char val[12];
+  if (httpd_query_key_value(query, "from", val, sizeof(val)) == ESP_OK) {
+    *start = (uint32_t)strtoul(val, NULL, 10);
+  }
+  if (httpd_query_key_value(query, "limit", val, sizeof(val)) == ESP_OK) {
+    uint32_t limit = (uint32_t)strtoul(val, NULL, 10);
+    if (limit > 0 && limit <= UINT32_MAX - *start) {
+      *end = *start + limit;
+    }
+  }
+  return true;
+}
+
+/**
+ * GET /api/history.jsonl | /api/history.pgn — historie po tazich přímo do
+ * chunked odpovědi (game_write_history_stream), paměť nezávisí na délce
+ * partie. Kurzor: `X-Next-Cursor` → další dotaz `?from=`.
+ */
+esp_err_t http_get_history_stream_handler(httpd_req_t *req) {
+  const char *ext = strrchr(req->uri, '.');
+  size_t ext_len = ext != NULL ? strcspn(ext, "?") : 0;
+  game_history_format_t fmt;
+  const char *mime;
+  if (ext_len == 6 && strncmp(ext, ".jsonl", 6) == 0) {
+    fmt = GAME_HISTORY_FORMAT_JSONL;
+    mime = "application/x-ndjson";
+  } else if (ext_len == 4 && strncmp(ext, ".pgn", 4) == 0) {
+    fmt = GAME_HISTORY_FORMAT_PGN;
+    mime = "application/x-chess-pgn";
+  } else {
+    httpd_resp_send_err(req, HTTPD_404_NOT_FOUND, "Unknown history format");
+    return ESP_FAIL;
+  }
+  ESP_LOGD(TAG, "GET %s", req->uri);
+
+  uint32_t start = 0;
+  uint32_t end = UINT32_MAX;
+  bool is_range = false;
+  if (!http_history_parse_range(req, &start, &end, &is_range)) {
+    httpd_resp_set_status(req, "400 Bad Request");
+    httpd_resp_send(req, "Bad Range (use plies=N-M)", -1);
+    return ESP_FAIL;
+  }
 
-  // Ziskat historii tahu z game tasku
-  esp_err_t ret = game_get_history_json(json_buffer, sizeof(json_buffer));
+  uint32_t total = game_get_history_length();
+  char total_str[12];
+  char rev_str[12];
+  char next_str[12];
+  char content_range[48];
+  snprintf(total_str, sizeof(total_str), "%" PRIu32, total);
+  snprintf(rev_str, sizeof(rev_str), "%" PRIu32, game_get_state_revision());
+  httpd_resp_set_hdr(req, "Accept-Ranges", "plies");
+  httpd_resp_set_hdr(req, "X-History-Total", total_str);
+  httpd_resp_set_hdr(req, "X-State-Version", rev_str);
+
+  if (is_range) {
+    if (start >= total) {
+      snprintf(content_range, sizeof(content_range), "plies */%" PRIu32,
+               total);
+      httpd_resp_set_status(req, "416 Range Not Satisfiable");
+      httpd_resp_set_hdr(req, "Content-Range", content_range);
+      httpd_resp_send(req, NULL, 0);
+      return ESP_OK;
+    }
+    uint32_t last = (end < total ? end : total) - 1;
+    snprintf(content_range, sizeof(content_range),
+             "plies %" PRIu32 "-%" PRIu32 "/%" PRIu32, start, last, total);
+    httpd_resp_set_status(req, "206 Partial Content");
+    httpd_resp_set_hdr(req, "Content-Range", content_range);
+  }
+  /* Očekávaný kurzor; undo během streamu ho může jen zkrátit — klient pak
+   * uvidí novější X-State-Version. */
+  uint32_t expect_next = end < total ? end : total;
+  if (expect_next < start) {
+    expect_next = start;
+  }
+  snprintf(next_str, sizeof(next_str), "%" PRIu32, expect_next);
+  httpd_resp_set_hdr(req, "X-Next-Cursor", next_str);
+  httpd_resp_set_type(req, mime);
+
+  char scratch[HTTP_JSON_CHUNK_SIZE];
+  json_writer_t w;
+  json_writer_init_sink(&w, scratch, sizeof(scratch), http_json_chunk_sink,
+                        req);
+  esp_err_t ret = game_write_history_stream(&w, fmt, start, end, NULL);
+  if (ret == ESP_OK) {
+    ret = json_writer_finish(&w);
+  }
   if (ret != ESP_OK) {
-    httpd_resp_set_status(req, "500 Internal Server Error");
-    httpd_resp_send(req, "Failed to get move history", -1);
+    ESP_LOGW(TAG, "history stream failed after %zu B: %s", w.flushed,
+             esp_err_to_name(ret));
+    if (w.flushed == 0) {
+      httpd_resp_set_status(req, "500 Internal Server Error");
+      httpd_resp_set_type(req, "text/plain");
+      httpd_resp_send(req, "Failed to get move history", -1);
+    }
     return ESP_FAIL;
   }
+  return httpd_resp_send_chunk(req, NULL, 0);
+}
+
+/**
+ * GET /api/games?offset=N&limit=M — stránka archivu uložených her (seřazeno
+ * podle jména). Čte jen index na oddílu `storage`; `next` = offset další
+ * stránky nebo null.
+ */
+esp_err_t http_get_games_handler(httpd_req_t *req) {
+  uint32_t offset = 0;
+  uint32_t limit = GAME_ARCHIVE_PAGE_MAX;
+  char query[48];
+  if (httpd_req_get_url_query_str(req, query, sizeof(query)) == ESP_OK) {
+    char val[12];
+    if (httpd_query_key_value(query, "offset", val, sizeof(val)) == ESP_OK) {
+      offset = (uint32_t)strtoul(val, NULL, 10);
+    }
+    if (httpd_query_key_value(query, "limit", val, sizeof(val)) == ESP_OK) {
+      limit = (uint32_t)strtoul(val, NULL, 10);
+    }
+  }
+  ESP_LOGD(TAG, "GET /api/games offset=%" PRIu32 " limit=%" PRIu32, offset,
+           limit);
 
+  json_writer_t w;
+  esp_err_t ret = json_writer_init_heap(&w, HTTP_JSON_HEAP_INITIAL_CAP);
+  if (ret == ESP_OK) {
+    json_writer_begin_object(&w);
+    ret = game_archive_write_list_fields(&w, offset, limit);
+    json_writer_end_object(&w);
+  }
+  size_t len = 0;
+  char *json = (ret == ESP_OK) ? json_writer_take(&w, &len) : NULL;
+  if (json == NULL) {
+    json_writer_discard(&w);
+    httpd_resp_set_status(req, "500 Internal Server Error");
+    httpd_resp_send(req, "Failed to list saved games", -1);
+    return ESP_FAIL;
+  }
   httpd_resp_set_type(req, "application/json");
-  httpd_resp_send(req, json_buffer, strlen(json_buffer));
+  ret = httpd_resp_send(req, json, (ssize_t)len);
+  free(json);
+  return ret;
+}
 
-  return ESP_OK;
+/**
+ * GET /api/puzzles — souhrn databaze uloh: pocet, pasma ratingu (id rozsahy)
+ * a temata pro filtr v POST /api/game/puzzle.
+ */
+esp_err_t http_get_puzzles_handler(httpd_req_t *req) {
+  ESP_LOGD(TAG, "GET /api/puzzles");
+  json_writer_t w;
+  esp_err_t ret = json_writer_init_heap(&w, HTTP_JSON_HEAP_INITIAL_CAP);
+  if (ret == ESP_OK) {
+    json_writer_begin_object(&w);
+    ret = game_puzzle_db_write_info_fields(&w);
+    json_writer_end_object(&w);
+  }
+  size_t len = 0;
+  char *json = (ret == ESP_OK) ? json_writer_take(&w, &len) : NULL;
+  if (json == NULL) {
+    json_writer_discard(&w);
+    httpd_resp_set_status(req, "500 Internal Server Error");
+    httpd_resp_send(req, "Failed to read puzzle database", -1);
+    return ESP_FAIL;
+  }
+  httpd_resp_set_type(req, "application/json");
+  ret = httpd_resp_send(req, json, (ssize_t)len);
+  free(json);
+  return ret;
 }
 
 esp_err_t http_get_captured_handler(httpd_req_t *req) {
   ESP_LOGD(TAG, "GET /api/captured");
+  return http_send_json_heap(req, game_write_captured_json,
+                               "Failed to get captured pieces");
+}
+
+/** Klient si o binarni snapshot rekne hlavickou Accept (jinak JSON). */
+static bool http_snapshot_wants_bin(httpd_req_t *req) {
+  char accept[96];
+  if (httpd_req_get_hdr_value_str(req, "Accept", accept, sizeof(accept)) !=
+      ESP_OK) {
+    return false;
+  }
+  return strstr(accept, SNAPSHOT_BIN_MIME) != NULL;
+}
 
-  // Ziskat sebrane figurky z game tasku
-  esp_err_t ret = game_get_captured_json(json_buffer, sizeof(json_buffer));
+/** GET /api/game/snapshot s Accept: application/vnd.czechmate.snapshot. */
+static esp_err_t http_send_game_snapshot_bin(httpd_req_t *req) {
+  uint8_t *bin = malloc(SNAPSHOT_BIN_MAX_SIZE);
+  if (bin == NULL) {
+    httpd_resp_set_status(req, "500 Internal Server Error");
+    httpd_resp_send(req, "Out of memory", -1);
+    return ESP_FAIL;
+  }
+  size_t len = 0;
+  esp_err_t ret = game_get_snapshot_bin(bin, SNAPSHOT_BIN_MAX_SIZE, 0, &len);
   if (ret != ESP_OK) {
+    free(bin);
     httpd_resp_set_status(req, "500 Internal Server Error");
-    httpd_resp_send(req, "Failed to get captured pieces", -1);
+    httpd_resp_send(req, "Failed to build game snapshot", -1);
     return ESP_FAIL;
   }
-
-  httpd_resp_set_type(req, "application/json");
-  httpd_resp_send(req, json_buffer, strlen(json_buffer));
-
+  /* ETag podle revize, ze ktere snapshot opravdu vznikl. */
+  uint32_t rev = 0;
+  (void)snapshot_bin_peek_version(bin, len, &rev);
+  char etag[24];
+  snprintf(etag, sizeof(etag), "%" PRIu32 "-bin", rev);
+  httpd_resp_set_type(req, SNAPSHOT_BIN_MIME);
+  httpd_resp_set_hdr(req, "ETag", etag);
+  httpd_resp_set_hdr(req, "Vary", "Accept");
+  httpd_resp_send(req, (const char *)bin, (ssize_t)len);
+  free(bin);
   return ESP_OK;
 }
 
 esp_err_t http_get_game_snapshot_handler(httpd_req_t *req) {
   ESP_LOGD(TAG, "GET /api/game/snapshot");
+  bool want_bin = http_snapshot_wants_bin(req);
   uint32_t rev = game_get_state_revision();
   char etag[24];
-  snprintf(etag, sizeof(etag), "%" PRIu32, rev);
+  snprintf(etag, sizeof(etag), want_bin ? "%" PRIu32 "-bin" : "%" PRIu32, rev);
 
   char inm[64];
   if (httpd_req_get_hdr_value_str(req, "If-None-Match", inm, sizeof(inm)) ==
@@ -423,38 +638,55 @@ esp_err_t http_get_game_snapshot_handler(httpd_req_t *req) {
       return ESP_OK;
     }
   }
+  if (want_bin) {
+    return http_send_game_snapshot_bin(req);
+  }
 
-  size_t pos = 0;
-  esp_err_t ret = build_snapshot_json(&pos);
+  web_snapshot_t *snap = NULL;
+  esp_err_t ret = web_snapshot_acquire(&snap);
   if (ret != ESP_OK) {
     httpd_resp_set_status(req, "500 Internal Server Error");
     httpd_resp_send(req, "Failed to build game snapshot", -1);
     return ESP_FAIL;
   }
+  /* ETag podle revize, ze které snapshot opravdu vznikl. */
+  snprintf(etag, sizeof(etag), "%" PRIu32, web_snapshot_revision(snap));
   httpd_resp_set_type(req, "application/json");
   if (httpd_resp_set_hdr(req, "ETag", etag) != ESP_OK) {
     ESP_LOGD(TAG, "ETag header not set");
   }
-  httpd_resp_send(req, snapshot_buffer, pos);
+  httpd_resp_set_hdr(req, "Vary", "Accept");
+  httpd_resp_send(req, web_snapshot_json(snap), web_snapshot_len(snap));
+  web_snapshot_release(snap);
   return ESP_OK;
 }
 
 esp_err_t http_get_advantage_handler(httpd_req_t *req) {
   ESP_LOGI(TAG, "GET /api/advantage");
+  return http_send_json_heap(req, game_write_advantage_json,
+                               "Failed to get advantage history");
+}
+
+esp_err_t http_get_timer_handler(httpd_req_t *req) {
+  ESP_LOGD(TAG, "GET /api/timer");
 
-  // Ziskat historii material advantage z game tasku
-  esp_err_t ret = game_get_advantage_json(json_buffer, sizeof(json_buffer));
+  // Lokalni buffer jen pro timer JSON (~1 KiB, TIMER_HTTP_JSON_MAX).
+  char local_json[TIMER_HTTP_JSON_MAX];
+  esp_err_t ret = game_get_timer_json(local_json, sizeof(local_json));
   if (ret != ESP_OK) {
     httpd_resp_set_status(req, "500 Internal Server Error");
-    httpd_resp_send(req, "Failed to get advantage history", -1);
+    httpd_resp_send(req, "Failed to get timer state", -1);
     return ESP_FAIL;
   }
 
+  // Zabranit cachovani timer odpovedi v prohlizeci
+  httpd_resp_set_hdr(req, "Cache-Control", "no-store");
   httpd_resp_set_type(req, "application/json");
-  httpd_resp_send(req, json_buffer, strlen(json_buffer));
+  httpd_resp_send(req, local_json, strlen(local_json));
 
   return ESP_OK;
 }
+
 // ============================================================================
 // VIRTUAL GAME ACTIONS (REMOTE CONTROL)
 // ============================================================================
@@ -635,12 +867,13 @@ esp_err_t http_post_game_move_handler(httpd_req_t *req) {
   if (xQueueReceive(response_queue, &response, pdMS_TO_TICKS(1000)) == pdTRUE) {
     // Check if move was successful
     if (response.type == GAME_RESPONSE_ERROR) {
-      ESP_LOGW(TAG, "❌ Move rejected by game task: %s", response.data);
+      const char *reason = game_payload_str(response.text);
+      ESP_LOGW(TAG, "❌ Move rejected by game task: %s", reason);
       httpd_resp_set_status(req, "400 Bad Request");
       httpd_resp_set_type(req, "application/json");
-      char error_json[256];
+      char error_json[320];
       snprintf(error_json, sizeof(error_json),
-               "{\"success\":false,\"message\":\"%s\"}", response.data);
+               "{\"success\":false,\"message\":\"%s\"}", reason);
       httpd_resp_send(req, error_json, -1);
     } else {
       ESP_LOGI(TAG, "✅ Move accepted by game task");
@@ -649,6 +882,7 @@ esp_err_t http_post_game_move_handler(httpd_req_t *req) {
       httpd_resp_send(req, "{\"success\":true,\"message\":\"Move processed\"}",
                       -1);
     }
+    game_response_release(&response);
   } else {
     // Timeout - treat as success (async fallback) or error?
     // Let's treat as partial success but log warning
@@ -659,7 +893,8 @@ esp_err_t http_post_game_move_handler(httpd_req_t *req) {
         req, "{\"success\":true,\"message\":\"Move queued (timeout)\"}", -1);
   }
 
-  // Cleanup queue
+  // Cleanup queue (vcetne pripadnych dalsich odpovedi a jejich slotu)
+  game_response_drain(response_queue);
   vQueueDelete(response_queue);
   return ESP_OK;
 }
@@ -878,11 +1113,15 @@ esp_err_t http_post_game_new_handler(httpd_req_t *req) {
       if (cJSON_IsString(fj) && fj->valuestring != NULL &&
           fj->valuestring[0] != '\0') {
         cmd.type = GAME_CMD_NEW_GAME_FROM_FEN;
-        strncpy(cmd.timer_data.fen_new_game.fen, fj->valuestring,
-                sizeof(cmd.timer_data.fen_new_game.fen) - 1);
-        cmd.timer_data.fen_new_game.fen[sizeof(cmd.timer_data.fen_new_game.fen) -
-                                        1] = '\0';
+        cmd.timer_data.fen_new_game.fen = game_payload_alloc_str(fj->valuestring);
         cJSON_Delete(root);
+        if (cmd.timer_data.fen_new_game.fen == GAME_PAYLOAD_NONE) {
+          // Bez FEN by game task spustil standardni hru
+          httpd_resp_set_status(req, "503 Service Unavailable");
+          httpd_resp_set_type(req, "application/json");
+          httpd_resp_send(req, "{\"success\":false,\"error\":\"Busy\"}", -1);
+          return ESP_OK;
+        }
       } else {
         cJSON_Delete(root);
         cmd.type = GAME_CMD_NEW_GAME;
@@ -895,6 +1134,8 @@ esp_err_t http_post_game_new_handler(httpd_req_t *req) {
   }
 
   if (game_command_queue == NULL) {
+    // GAME_CMD_NEW_GAME ma fen NONE (cmd = {0}), release je pak no-op
+    game_payload_release(cmd.timer_data.fen_new_game.fen);
     ESP_LOGE(TAG, "Game command queue not available");
     httpd_resp_set_status(req, "500 Internal Server Error");
     httpd_resp_set_type(req, "application/json");
@@ -904,6 +1145,7 @@ esp_err_t http_post_game_new_handler(httpd_req_t *req) {
   }
 
   if (xQueueSend(game_command_queue, &cmd, pdMS_TO_TICKS(100)) != pdTRUE) {
+    game_payload_release(cmd.timer_data.fen_new_game.fen);
     ESP_LOGE(TAG, "Failed to send NEW_GAME command to queue");
     httpd_resp_set_status(req, "500 Internal Server Error");
     httpd_resp_set_type(req, "application/json");
@@ -1141,8 +1383,9 @@ esp_err_t http_post_game_setup_tutorial_handler(httpd_req_t *req) {
 
 /**
  * POST /api/game/puzzle
- * Body: {"action":"start","id":1..5} | {"action":"prepare","id":1..5} |
- * {"action":"cancel"}
+ * Body: {"action":"start","id":N} | {"action":"prepare","id":N} |
+ * {"action":"cancel"}; misto "id" lze poslat {"rating":1500,"theme":"fork"}
+ * a ulohu vybere game task z databaze (pasmo nejblizsi ratingu).
  */
 esp_err_t http_post_game_puzzle_handler(httpd_req_t *req) {
   ESP_LOGI(TAG, "POST /api/game/puzzle");
@@ -1165,11 +1408,15 @@ esp_err_t http_post_game_puzzle_handler(httpd_req_t *req) {
   }
   buf[r] = '\0';
 
-  bool want_start = (strstr(buf, "\"start\"") != NULL);
-  bool want_cancel = (strstr(buf, "\"cancel\"") != NULL);
-  bool want_prepare = (strstr(buf, "\"prepare\"") != NULL);
-  int n = (want_start ? 1 : 0) + (want_cancel ? 1 : 0) + (want_prepare ? 1 : 0);
-  if (n != 1) {
+  cJSON *root = cJSON_Parse(buf);
+  cJSON *action_j = cJSON_GetObjectItemCaseSensitive(root, "action");
+  const char *action =
+      cJSON_IsString(action_j) ? action_j->valuestring : NULL;
+  bool want_start = action != NULL && strcmp(action, "start") == 0;
+  bool want_cancel = action != NULL && strcmp(action, "cancel") == 0;
+  bool want_prepare = action != NULL && strcmp(action, "prepare") == 0;
+  if (!want_start && !want_cancel && !want_prepare) {
+    cJSON_Delete(root);
     httpd_resp_set_type(req, "application/json");
     httpd_resp_set_status(req, "400 Bad Request");
     httpd_resp_send(req,
@@ -1179,39 +1426,55 @@ esp_err_t http_post_game_puzzle_handler(httpd_req_t *req) {
     return ESP_OK;
   }
 
-  if (game_command_queue == NULL) {
-    httpd_resp_set_type(req, "application/json");
-    httpd_resp_set_status(req, "500 Internal Server Error");
-    httpd_resp_send(
-        req, "{\"success\":false,\"error\":\"Game command queue unavailable\"}",
-        -1);
-    return ESP_FAIL;
-  }
-
   chess_move_command_t cmd = {0};
   cmd.type = GAME_CMD_PUZZLE;
-  cmd.promotion_choice = 0U;
+  cmd.promotion_choice = want_start ? 1U : (want_prepare ? 2U : 0U);
   cmd.response_queue = NULL;
 
   if (want_start || want_prepare) {
-    int puzzle_id = -1;
-    char *id_ptr = strstr(buf, "\"id\"");
-    if (id_ptr != NULL) {
-      char *colon = strchr(id_ptr, ':');
-      if (colon != NULL) {
-        puzzle_id = atoi(colon + 1);
+    const cJSON *id_j = cJSON_GetObjectItemCaseSensitive(root, "id");
+    const cJSON *rating_j = cJSON_GetObjectItemCaseSensitive(root, "rating");
+    const cJSON *theme_j = cJSON_GetObjectItemCaseSensitive(root, "theme");
+    uint32_t count = game_puzzle_db_count();
+    double id = cJSON_IsNumber(id_j) ? id_j->valuedouble : 0;
+    const char *err = NULL;
+    if (count == 0) {
+      err = "Puzzle database unavailable";
+    } else if (id < 0 || id > count) {
+      err = "Puzzle id out of range";
+    } else if (cJSON_IsString(theme_j) && theme_j->valuestring[0] != '\0') {
+      cmd.timer_data.puzzle.theme_mask =
+          game_puzzle_db_theme_mask(theme_j->valuestring);
+      if (cmd.timer_data.puzzle.theme_mask == 0) {
+        err = "Unknown puzzle theme";
       }
     }
-    if (puzzle_id < 1 || puzzle_id > 5) {
+    if (err != NULL) {
+      cJSON_Delete(root);
+      char body[96];
+      snprintf(body, sizeof(body), "{\"success\":false,\"error\":\"%s\"}",
+               err);
       httpd_resp_set_type(req, "application/json");
       httpd_resp_set_status(req, "400 Bad Request");
-      httpd_resp_send(req,
-                      "{\"success\":false,\"error\":\"Puzzle id must be 1..5\"}",
-                      -1);
+      httpd_resp_send(req, body, -1);
       return ESP_OK;
     }
-    cmd.promotion_choice =
-        want_prepare ? (uint8_t)(100 + puzzle_id) : (uint8_t)puzzle_id;
+    cmd.timer_data.puzzle.id = (uint16_t)id;
+    if (cJSON_IsNumber(rating_j) && rating_j->valuedouble > 0) {
+      cmd.timer_data.puzzle.rating = rating_j->valuedouble > 0xffff
+                                         ? 0xffff
+                                         : (uint16_t)rating_j->valuedouble;
+    }
+  }
+  cJSON_Delete(root);
+
+  if (game_command_queue == NULL) {
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_set_status(req, "500 Internal Server Error");
+    httpd_resp_send(
+        req, "{\"success\":false,\"error\":\"Game command queue unavailable\"}",
+        -1);
+    return ESP_FAIL;
   }
 
   if (xQueueSend(game_command_queue, &cmd, pdMS_TO_TICKS(100)) != pdTRUE) {
@@ -7,6 +7,8 @@
 #include "web_server_internal.h"
 #include "board_api_auth.h"
 #include "../config_manager/include/config_manager.h"
+#include "config_persist.h"
+#include "../config_manager/include/config_registry.h"
 #include "../game_task/include/game_task.h"
 #include "../ha_light_task/include/ha_light_task.h"
 #include "../led_task/include/led_task.h"
@@ -329,29 +331,8 @@ esp_err_t http_post_settings_brightness_handler(httpd_req_t *req) {
       if (brightness_val > 100)
         brightness_val = 100;
 
-      // 1. Nastavit LED driver hned
-      led_set_brightness_global((uint8_t)brightness_val);
-
-      // 2. Ulozit do configu (load-modify-save)
-      system_config_t config;
-      // Default init v pripade chyby loadu
-      config.brightness_level = 50;
-
-      if (config_load_from_nvs(&config) == ESP_OK) {
-        config.brightness_level = (uint8_t)brightness_val;
-        config_save_to_nvs(&config);
-      } else {
-        // Config neexistuje, vytvorit novy s defaulty a novym jasem
-        config.brightness_level = (uint8_t)brightness_val;
-        // Ostatni defaulty (pokud config_load selhal, config struct je
-        // nedefinovany, ale my ukladame jen brightness do NVS v teto verzi
-        // config_manageru? Ne, config_manager uklada celou struct?
-        // config_save_to_nvs uklada key-value pairs. Takze je to bezpecne.
-        config_save_to_nvs(&config);
-      }
-
-      cached_brightness = (uint8_t)brightness_val;
-      cached_brightness_valid = true;
+      // LED driver nastavi listener LED tasku, NVS zapise persist task
+      config_set_brightness((uint8_t)brightness_val);
       ESP_LOGI(TAG, "Brightness updated to %d%% via Web UI", brightness_val);
     }
   }
@@ -418,24 +399,14 @@ esp_err_t http_post_settings_guided_hints_handler(httpd_req_t *req) {
   bool enabled = (strstr(content, "\"enabled\":true") != NULL) ||
                  (strstr(content, "\"enabled\": true") != NULL);
 
-  system_config_t config;
-  if (config_load_from_nvs(&config) != ESP_OK) {
-    httpd_resp_set_status(req, "500 Internal Server Error");
-    httpd_resp_set_type(req, "application/json");
-    httpd_resp_send(req, "{\"success\":false,\"message\":\"Config load failed\"}",
-                    -1);
-    return ESP_OK;
-  }
-  config.guided_capture_hints_enabled = enabled;
-  config.led_guidance_level = enabled ? (uint8_t)5 : (uint8_t)4;
-  config_save_to_nvs(&config);
-  game_set_led_guidance_level(config.led_guidance_level);
+  // game_task dostane uroven z listeneru config_registry
+  config_set_guided_capture_hints(enabled);
 
   char resp[120];
   snprintf(resp, sizeof(resp),
            "{\"success\":true,\"enabled\":%s,\"led_guidance_level\":%u}",
            enabled ? "true" : "false",
-           (unsigned)config.led_guidance_level);
+           (unsigned)config_get_led_guidance_level());
   httpd_resp_set_type(req, "application/json");
   httpd_resp_send(req, resp, strlen(resp));
   return ESP_OK;
@@ -475,18 +446,7 @@ esp_err_t http_post_settings_led_guidance_handler(httpd_req_t *req) {
     return ESP_OK;
   }
 
-  system_config_t config;
-  if (config_load_from_nvs(&config) != ESP_OK) {
-    httpd_resp_set_status(req, "500 Internal Server Error");
-    httpd_resp_set_type(req, "application/json");
-    httpd_resp_send(req, "{\"success\":false,\"message\":\"Config load failed\"}",
-                    -1);
-    return ESP_OK;
-  }
-  config.led_guidance_level = (uint8_t)level;
-  config.guided_capture_hints_enabled = (level >= 5);
-  config_save_to_nvs(&config);
-  game_set_led_guidance_level((uint8_t)level);
+  config_set_led_guidance_level((uint8_t)level);
 
   char resp[96];
   snprintf(resp, sizeof(resp),
@@ -543,16 +503,9 @@ esp_err_t http_post_settings_start_pos_check_handler(httpd_req_t *req) {
   bool enabled = (strstr(content, "\"enabled\":true") != NULL) ||
                  (strstr(content, "\"enabled\": true") != NULL);
 
-  // Nastavit v game_task
-  game_set_starting_position_check(enabled);
-
-  // Ulozit do NVS
-  system_config_t config;
-  if (config_load_from_nvs(&config) == ESP_OK) {
-    config.starting_position_check_enabled = enabled;
-    config_save_to_nvs(&config);
-    ESP_LOGI(TAG, "Starting position check saved to NVS: %s", enabled ? "ON" : "OFF");
-  }
+  // game_task pres listener config_registry, NVS na pozadi
+  config_set_starting_position_check(enabled);
+  ESP_LOGI(TAG, "Starting position check: %s", enabled ? "ON" : "OFF");
 
   char resp[64];
   snprintf(resp, sizeof(resp), "{\"success\":true,\"enabled\":%s}", enabled ? "true" : "false");
@@ -711,6 +664,8 @@ static void factory_reset_worker(void *ignored) {
   vTaskDelay(pdMS_TO_TICKS(500));
   ESP_LOGW(TAG,
            "[STAGING] factory_reset: raw erase default NVS partition + restart");
+  /* Cekajici zapisy by jinak dopadly do NVS az po smazani. */
+  (void)config_persist_flush(1000);
 
   const esp_partition_t *nvs_part = esp_partition_find_first(
       ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_DATA_NVS, NULL);
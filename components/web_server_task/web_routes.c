@@ -6,9 +6,9 @@
 #include "web_routes.h"
 #include "web_server_internal.h"
 
-#include "chess_piece_http.h"
 #include "ota_update.h"
 #include "web_server_task.h"
+#include "web_static_assets.h"
 
 #include "esp_http_server.h"
 #include "esp_log.h"
@@ -63,6 +63,27 @@ esp_err_t web_routes_register(httpd_handle_t handle) {
                              .user_ctx = NULL};
   httpd_register_uri_handler(handle, &history_uri);
 
+  /* /api/history.jsonl a /api/history.pgn — jeden wildcard handler. */
+  httpd_uri_t history_stream_uri = {.uri = "/api/history.*",
+                                    .method = HTTP_GET,
+                                    .handler = http_get_history_stream_handler,
+                                    .user_ctx = NULL};
+  httpd_register_uri_handler(handle, &history_stream_uri);
+
+  /* Archiv uložených her (LittleFS `storage`), stránkovaně. */
+  httpd_uri_t games_uri = {.uri = "/api/games",
+                           .method = HTTP_GET,
+                           .handler = http_get_games_handler,
+                           .user_ctx = NULL};
+  httpd_register_uri_handler(handle, &games_uri);
+
+  /* Databáze úloh: pásma ratingu a témata. */
+  httpd_uri_t puzzles_uri = {.uri = "/api/puzzles",
+                             .method = HTTP_GET,
+                             .handler = http_get_puzzles_handler,
+                             .user_ctx = NULL};
+  httpd_register_uri_handler(handle, &puzzles_uri);
+
   httpd_uri_t captured_uri = {.uri = "/api/captured",
                               .method = HTTP_GET,
                               .handler = http_get_captured_handler,
@@ -327,9 +348,9 @@ esp_err_t web_routes_register(httpd_handle_t handle) {
                                  .user_ctx = NULL};
   httpd_register_uri_handler(handle, &mqtt_config_uri);
 
-  ret = chess_piece_register_http_uris(handle);
+  ret = web_static_register_http_uris(handle);
   if (ret != ESP_OK) {
-    ESP_LOGE(TAG, "chess_piece_register_http_uris failed: %s",
+    ESP_LOGE(TAG, "web_static_register_http_uris failed: %s",
              esp_err_to_name(ret));
     return ret;
   }
@@ -100,13 +100,16 @@
 #include "sdkconfig.h"
 #if CONFIG_CHESS_ENABLE_WEB_SERVER
 #include "web_routes.h"
-#include "chess_piece_http.h"
 #include "esp_http_server.h"
 #include "mdns.h"
 #endif
 #include "web_server_internal.h"
+#include "../game_hooks/include/game_event_bus.h"
 #include "../game_hooks/include/game_state_notify.h"
 #include "../game_task/include/game_task.h"
+#include "../game_task/include/game_archive.h"
+#include "game_payload.h"
+#include "snapshot_bin.h"
 #include "../matrix_task/include/matrix_task.h"
 #include "../ha_light_task/include/ha_light_task.h"
 #include "../led_task/include/led_task.h"
@@ -125,6 +128,8 @@
 #include "freertos_chess.h"
 #include "../ble_task/include/ble_task.h"
 #include "../config_manager/include/config_manager.h"
+#include "../config_manager/include/config_registry.h"
+#include "config_persist.h"
 #include "nvs.h"
 #include "nvs_flash.h"
 #include "esp_partition.h"
@@ -157,7 +162,7 @@ static const char *TAG = "WEB_SERVER_TASK";
 /**
  * @brief Reset TWDT jen pokud aktuální úloha je `web_server_task`.
  *
- * `build_snapshot_json` a mutexové čekání se volají i z workerů `httpd` (GET
+ * `web_snapshot_acquire` a mutexové čekání se volají i z workerů `httpd` (GET
  * snapshot) – ty nejsou v TWDT; `esp_task_wdt_reset()` pak vrací ESP_ERR_NOT_FOUND
  * a komponenta task_wdt spamuje sériovku ERROR řádky.
  *
@@ -211,6 +216,9 @@ esp_err_t web_server_task_wdt_reset_safe(void) {
 #define WEB_NVS_NAMESPACE "web_config"
 #define WEB_NVS_KEY_LOCKED "locked"
 
+/** BLE list_games: her na stránku (cmd_ack notifikace max ~2 KB). */
+#define BLE_LIST_GAMES_PAGE 12
+
 // Konfigurace HTTP serveru
 #define HTTP_SERVER_PORT 80
 #define HTTP_SERVER_MAX_URI_LEN 512
@@ -262,11 +270,6 @@ static size_t s_sta_blk_oct_n;
 /** Kolikrát za sebou zamítnuta DHCP adresa (router může pořád nabízet stejnou). */
 static unsigned s_sta_blk_reject_streak;
 
-/* Cache jasu pro GET /api/status – zabranuje NVS + CONFIG_MANAGER na kazdy
- * request */
-uint8_t cached_brightness = 50;
-bool cached_brightness_valid = false;
-
 // Externi promenne
 QueueHandle_t web_server_status_queue = NULL;
 QueueHandle_t web_server_command_queue = NULL;
@@ -914,13 +917,14 @@ bool wifi_is_sta_connected(void) { return sta_connected; }
 // WEB LOCK NVS FUNKCE
 // ============================================================================
 
-/**
- * @brief Ulozi lock stav do NVS
- *
- * @param locked True pro lock, false pro unlock
- * @return ESP_OK pri uspechu, chybovy kod pri chybe
- */
-static esp_err_t web_lock_save_to_nvs(bool locked) {
+/** config_persist_write_fn: zapis lock stavu (persist task). */
+static esp_err_t web_lock_write_nvs(const char *key, const void *data,
+                                    size_t len) {
+  (void)key;
+  if (len != sizeof(uint8_t)) {
+    return ESP_ERR_INVALID_SIZE;
+  }
+  uint8_t locked_value = *(const uint8_t *)data;
   nvs_handle_t nvs_handle;
   esp_err_t ret = nvs_open(WEB_NVS_NAMESPACE, NVS_READWRITE, &nvs_handle);
   if (ret != ESP_OK) {
@@ -928,7 +932,6 @@ static esp_err_t web_lock_save_to_nvs(bool locked) {
     return ret;
   }
 
-  uint8_t locked_value = locked ? 1 : 0;
   ret = nvs_set_blob(nvs_handle, WEB_NVS_KEY_LOCKED, &locked_value,
                      sizeof(locked_value));
   if (ret != ESP_OK) {
@@ -945,11 +948,27 @@ static esp_err_t web_lock_save_to_nvs(bool locked) {
   }
 
   nvs_close(nvs_handle);
-  ESP_LOGI(TAG, "Web lock saved to NVS: %s", locked ? "locked" : "unlocked");
+  ESP_LOGI(TAG, "Web lock saved to NVS: %s",
+           locked_value ? "locked" : "unlocked");
 
   return ESP_OK;
 }
 
+/**
+ * @brief Ulozi lock stav do NVS
+ *
+ * Zapis probehne v persist tasku — HTTP handler na flash neceka.
+ *
+ * @param locked True pro lock, false pro unlock
+ * @return ESP_OK pri zarazeni do fronty, chybovy kod pri chybe
+ */
+static esp_err_t web_lock_save_to_nvs(bool locked) {
+  uint8_t locked_value = locked ? 1 : 0;
+  return config_persist_submit("web_lock", web_lock_write_nvs,
+                               &locked_value, sizeof(locked_value),
+                               CONFIG_PERSIST_PRIO_NORMAL, NULL);
+}
+
 /**
  * @brief Nacte lock stav z NVS
  *
@@ -1711,7 +1730,7 @@ static esp_err_t start_http_server(void) {
   // Konfigurovat HTTP server
   httpd_config_t config = HTTPD_DEFAULT_CONFIG();
   config.server_port = HTTP_SERVER_PORT;
-  /* Počet httpd_register_uri_handler ve start_http_server: 54+ (2026-04, vč. WS + PNG figurky).
+  /* Počet httpd_register_uri_handler ve start_http_server: 43+ (vč. WS + /static wildcard).
    * Při přidání endpointu zvýšit zásobu (HTTPD neregistruje „tiše“ navíc). */
   config.max_uri_handlers = 64;
   // Keep within LWIP limits. HTTP server internally reserves 3 sockets.
@@ -1726,6 +1745,8 @@ static esp_err_t start_http_server(void) {
   config.send_wait_timeout =
       5000; // 5 s – spolehlivy chunked transfer pri vykyvech
   config.max_resp_headers = 8;
+  /* /static/… — jeden handler pro všechny assety; přesné URI dál matchují přesně. */
+  config.uri_match_fn = httpd_uri_match_wildcard;
   config.backlog_conn = 6;         // Vetsi fronta pri napadu klientu
   config.stack_size = 8192;        // Zvysena velikost stacku pro HTTP server task
 
@@ -1854,6 +1875,26 @@ esp_err_t web_server_ble_command_dispatch(const char *json, size_t json_len) {
     ESP_LOGI(TAG, "BLE cmd: ping");
     return ESP_OK;
   }
+  if (strcmp(cmd, "snapshot_ack") == 0) {
+    // {"cmd":"snapshot_ack","state_version":N} → delty od N;
+    // {"cmd":"snapshot_ack","resync":true} → příští push plný
+    uint32_t session = ble_task_conn_session();
+    unsigned long ver = 0;
+    const char *pv = strstr(buf, "\"state_version\"");
+    bool have_ver = pv && sscanf(pv, "\"state_version\":%lu", &ver) == 1;
+    bool resync = strstr(buf, "\"resync\":true") != NULL;
+    if (!have_ver && !resync) {
+      return ESP_ERR_INVALID_ARG;
+    }
+    web_delta_client_ack(WEB_DELTA_CLIENT_BLE, session, resync || !have_ver,
+                         (uint32_t)ver);
+    ESP_LOGD(TAG, "BLE snapshot_ack state_version=%lu resync=%d", ver,
+             (int)resync);
+    if (resync) {
+      czechmate_on_game_state_changed();
+    }
+    return ESP_OK;
+  }
   if (strcmp(cmd, "ota_start") == 0) {
     if (!ble_task_conn_is_encrypted()) {
       ESP_LOGW(TAG, "BLE ota_start: encrypted link required");
@@ -1940,6 +1981,43 @@ esp_err_t web_server_ble_command_dispatch(const char *json, size_t json_len) {
     s_ble_dispatch_custom_ack_sent = true;
     return ESP_OK;
   }
+  if (strcmp(cmd, "list_games") == 0) {
+    // {"cmd":"list_games","offset":N,"limit":M} → stránka archivu her v cmd_ack
+    unsigned long offset = 0;
+    unsigned long limit = BLE_LIST_GAMES_PAGE;
+    const char *po = strstr(buf, "\"offset\"");
+    if (po != NULL) {
+      (void)sscanf(po, "\"offset\":%lu", &offset);
+    }
+    const char *pl = strstr(buf, "\"limit\"");
+    if (pl != NULL) {
+      (void)sscanf(pl, "\"limit\":%lu", &limit);
+    }
+    if (limit == 0 || limit > BLE_LIST_GAMES_PAGE) {
+      limit = BLE_LIST_GAMES_PAGE; /* cmd_ack notifikace má max ~2 KB */
+    }
+    json_writer_t w;
+    esp_err_t er = json_writer_init_heap(&w, 512);
+    if (er != ESP_OK) {
+      return er;
+    }
+    json_writer_begin_object(&w);
+    json_writer_kv_string(&w, "channel", "cmd_ack");
+    json_writer_kv_bool(&w, "ok", true);
+    json_writer_kv_string(&w, "code", "ok");
+    json_writer_kv_string(&w, "cmd", "list_games");
+    er = game_archive_write_list_fields(&w, (uint32_t)offset, (uint32_t)limit);
+    json_writer_end_object(&w);
+    char *ack = (er == ESP_OK) ? json_writer_take(&w, NULL) : NULL;
+    if (ack == NULL) {
+      json_writer_discard(&w);
+      return er != ESP_OK ? er : ESP_ERR_NO_MEM;
+    }
+    ble_task_notify_cmd_ack_json(ack);
+    free(ack);
+    s_ble_dispatch_custom_ack_sent = true;
+    return ESP_OK;
+  }
   if (strcmp(cmd, "factory_reset") == 0) {
     if (!ble_task_conn_is_encrypted()) {
       ESP_LOGW(TAG, "BLE factory_reset: encrypted link required");
@@ -2128,18 +2206,8 @@ esp_err_t web_server_ble_command_dispatch(const char *json, size_t json_len) {
     if (brightness_val < 0 || brightness_val > 100) {
       return ESP_ERR_INVALID_ARG;
     }
-    led_set_brightness_global((uint8_t)brightness_val);
-    system_config_t config;
-    config.brightness_level = 50;
-    if (config_load_from_nvs(&config) == ESP_OK) {
-      config.brightness_level = (uint8_t)brightness_val;
-      config_save_to_nvs(&config);
-    } else {
-      config.brightness_level = (uint8_t)brightness_val;
-      config_save_to_nvs(&config);
-    }
-    cached_brightness = (uint8_t)brightness_val;
-    cached_brightness_valid = true;
+    // LED task aplikuje pres listener config_registry, NVS na pozadi
+    config_set_brightness((uint8_t)brightness_val);
     ESP_LOGI(TAG, "BLE brightness %d%%", brightness_val);
     return ESP_OK;
   }
@@ -2304,15 +2372,19 @@ esp_err_t web_server_ble_command_dispatch(const char *json, size_t json_len) {
       if (cJSON_IsString(fj) && fj->valuestring != NULL &&
           fj->valuestring[0] != '\0') {
         new_cmd.type = GAME_CMD_NEW_GAME_FROM_FEN;
-        strncpy(new_cmd.timer_data.fen_new_game.fen, fj->valuestring,
-                sizeof(new_cmd.timer_data.fen_new_game.fen) - 1);
-        new_cmd.timer_data.fen_new_game.fen[sizeof(new_cmd.timer_data.fen_new_game.fen) - 1] = '\0';
+        new_cmd.timer_data.fen_new_game.fen =
+            game_payload_alloc_str(fj->valuestring);
+        if (new_cmd.timer_data.fen_new_game.fen == GAME_PAYLOAD_NONE) {
+          cJSON_Delete(root);
+          return ESP_ERR_NO_MEM;
+        }
       }
       cJSON_Delete(root);
     }
     if (xQueueSend(game_command_queue, &new_cmd, pdMS_TO_TICKS(100)) == pdTRUE) {
       ESP_LOGI(TAG, "[BLE] new_game: type=%d", (int)new_cmd.type);
     } else {
+      game_payload_release(new_cmd.timer_data.fen_new_game.fen);
       ESP_LOGE(TAG, "[BLE] new_game: failed to send to game queue");
       return ESP_FAIL;
     }
@@ -2412,7 +2484,7 @@ esp_err_t web_server_ble_command_dispatch(const char *json, size_t json_len) {
         int minutes;
         if (sscanf(minutes_str, "\"custom_minutes\":%d", &minutes) == 1) {
           if (minutes >= 1 && minutes <= 180) {
-            tcmd.timer_data.timer_config.custom_minutes = (uint32_t)minutes;
+            tcmd.timer_data.timer_config.custom_minutes = (uint16_t)minutes;
           } else {
             ESP_LOGW(TAG, "[BLE] timer_config: minutes out of range");
             return ESP_ERR_INVALID_ARG;
@@ -2425,7 +2497,7 @@ esp_err_t web_server_ble_command_dispatch(const char *json, size_t json_len) {
             1) {
           if (increment >= 0 && increment <= 60) {
             tcmd.timer_data.timer_config.custom_increment =
-                (uint32_t)increment;
+                (uint16_t)increment;
           } else {
             ESP_LOGW(TAG, "[BLE] timer_config: increment out of range");
             return ESP_ERR_INVALID_ARG;
@@ -2691,14 +2763,7 @@ esp_err_t web_server_ble_command_dispatch(const char *json, size_t json_len) {
       enabled = cJSON_IsTrue(en);
     }
     cJSON_Delete(root);
-    system_config_t syscfg;
-    if (config_load_from_nvs(&syscfg) != ESP_OK) {
-      return ESP_FAIL;
-    }
-    syscfg.guided_capture_hints_enabled = enabled;
-    syscfg.led_guidance_level = enabled ? (uint8_t)5 : (uint8_t)4;
-    config_save_to_nvs(&syscfg);
-    game_set_led_guidance_level(syscfg.led_guidance_level);
+    config_set_guided_capture_hints(enabled);
     ESP_LOGI(TAG, "[BLE] settings_guided_hints enabled=%d", (int)enabled);
     return ESP_OK;
   }
@@ -2720,14 +2785,7 @@ esp_err_t web_server_ble_command_dispatch(const char *json, size_t json_len) {
     if (level < 1 || level > 5) {
       return ESP_ERR_INVALID_ARG;
     }
-    system_config_t syscfg;
-    if (config_load_from_nvs(&syscfg) != ESP_OK) {
-      return ESP_FAIL;
-    }
-    syscfg.led_guidance_level = (uint8_t)level;
-    syscfg.guided_capture_hints_enabled = (level >= 5);
-    config_save_to_nvs(&syscfg);
-    game_set_led_guidance_level((uint8_t)level);
+    config_set_led_guidance_level((uint8_t)level);
     ESP_LOGI(TAG, "[BLE] settings_led_guidance level=%d", level);
     return ESP_OK;
   }
@@ -2873,16 +2931,49 @@ esp_err_t web_server_ble_command_dispatch(const char *json, size_t json_len) {
   return ESP_ERR_NOT_SUPPORTED;
 }
 
+/** Binární snapshot (A0B40006) — konec historie, při MTU 247 jediný notify. */
+static void czechmate_push_ble_snapshot_bin(void) {
+  if (!ble_task_should_push_snapshot_bin()) {
+    return;
+  }
+  uint8_t bin[SNAPSHOT_BIN_BLE_MAX_SIZE];
+  size_t len = 0;
+  esp_err_t e = game_get_snapshot_bin(bin, sizeof(bin),
+                                      SNAPSHOT_BIN_BLE_MAX_MOVES, &len);
+  if (e != ESP_OK) {
+    ESP_LOGW(TAG, "BLE snapshot_bin: %s", esp_err_to_name(e));
+    return;
+  }
+  ble_task_push_snapshot_bin(bin, len);
+}
+
 static void czechmate_push_ble_snapshot(void) {
   (void)web_server_task_wdt_reset_safe();
+  czechmate_push_ble_snapshot_bin();
   if (!ble_task_should_push_snapshot()) {
     return;
   }
-  size_t len = 0;
-  if (build_snapshot_json(&len) != ESP_OK) {
+  web_snapshot_t *snap = NULL;
+  if (web_snapshot_acquire(&snap) != ESP_OK) {
     return;
   }
-  ble_task_push_snapshot_json((const uint8_t *)snapshot_buffer, len);
+  /* Centrál s potvrzenou state_version dostane jen deltu (typicky 1–3 notify
+   * místo desítek CM chunků); mezera v revizích → plný snapshot. */
+  uint32_t session = ble_task_conn_session();
+  uint32_t base = 0;
+  char *delta = NULL;
+  size_t delta_len = 0;
+  if (web_delta_client_base(WEB_DELTA_CLIENT_BLE, session, &base) &&
+      web_snapshot_delta_build(snap, base, &delta, &delta_len) == ESP_OK) {
+    ble_task_push_snapshot_json((const uint8_t *)delta, delta_len);
+    free(delta);
+  } else {
+    ble_task_push_snapshot_json((const uint8_t *)web_snapshot_json(snap),
+                                web_snapshot_len(snap));
+  }
+  web_delta_client_sent(WEB_DELTA_CLIENT_BLE, session,
+                        web_snapshot_revision(snap));
+  web_snapshot_release(snap);
 }
 
 #if CONFIG_CHESS_ENABLE_WEB_SERVER
@@ -2999,7 +3090,80 @@ void czechmate_ensure_snapshot_notify_queue(void) {
   }
 }
 
+#if CONFIG_CHESS_ENABLE_WEB_SERVER && CONFIG_HTTPD_WS_SUPPORT
+/**
+ * Události bez změny revize (zvednutí/položení figurky, tik hodin) jdou na WS
+ * jako malý rámec místo plného snapshotu:
+ * {"type":"event","seq":N,"event":"piece_lifted","sq":12,"piece":"P"}
+ * {"type":"event","seq":N,"event":"clock","white_ms":…,"black_ms":…,"white_to_move":true}
+ */
+static void web_ws_push_game_event(const game_event_t *ev) {
+  char buf[128];
+  json_writer_t w;
+  json_writer_init_buffer(&w, buf, sizeof(buf));
+  json_writer_begin_object(&w);
+  json_writer_kv_string(&w, "type", "event");
+  json_writer_kv_uint(&w, "seq", ev->seq);
+  json_writer_kv_string(&w, "event", game_event_type_name(ev->type));
+  if (ev->type == GAME_EVENT_CLOCK_TICK) {
+    json_writer_kv_uint(&w, "white_ms", ev->u.clock.white_ms);
+    json_writer_kv_uint(&w, "black_ms", ev->u.clock.black_ms);
+    json_writer_kv_bool(&w, "white_to_move", ev->u.clock.white_to_move);
+  } else {
+    json_writer_kv_uint(&w, "sq", ev->u.piece.square);
+    if (ev->u.piece.piece != 0) {
+      json_writer_kv_char(&w, "piece", ev->u.piece.piece);
+    } else {
+      json_writer_key(&w, "piece");
+      json_writer_null(&w);
+    }
+  }
+  json_writer_end_object(&w);
+  if (json_writer_finish(&w) == ESP_OK) {
+    ws_broadcast_event(buf, json_writer_total(&w));
+  }
+}
+#endif
+
+/**
+ * Odběratel sběrnice game_event_bus (web_server_task): události se změnou
+ * revize → jeden snapshot push za průchod; ostatní → malé WS rámce.
+ * @return true = je potřeba snapshot (revize se změnila nebo přetečení)
+ */
+static bool web_server_drain_game_events(void) {
+  static game_event_cursor_t cursor;
+  static bool cursor_ready;
+  if (!cursor_ready) {
+    game_event_cursor_init(&cursor);
+    cursor_ready = true;
+    return false;
+  }
+  bool need_snapshot = false;
+  game_event_t ev;
+  for (;;) {
+    game_event_read_t r = game_event_next(&cursor, &ev);
+    if (r == GAME_EVENT_READ_EMPTY) {
+      break;
+    }
+    if (r == GAME_EVENT_READ_OVERRUN) {
+      ESP_LOGD(TAG, "game event bus overrun (lost=%" PRIu32 ") → full push",
+               cursor.lost);
+      need_snapshot = true;
+      continue;
+    }
+    if (game_event_type_bumps_revision(ev.type)) {
+      need_snapshot = true;
+      continue;
+    }
+#if CONFIG_CHESS_ENABLE_WEB_SERVER && CONFIG_HTTPD_WS_SUPPORT
+    web_ws_push_game_event(&ev);
+#endif
+  }
+  return need_snapshot;
+}
+
 void web_server_process_snapshot_notify_queue(void) {
+  bool need_snapshot = web_server_drain_game_events();
   if (snapshot_notify_queue == NULL) {
     return;
   }
@@ -3008,11 +3172,13 @@ void web_server_process_snapshot_notify_queue(void) {
   while (xQueueReceive(snapshot_notify_queue, &ping, 0) == pdTRUE) {
     n++;
   }
-  if (n == 0) {
+  /* Ping z fronty zůstává (watchdog, změny mimo game_task, např. web lock);
+   * změny revize z game_task by ho poslaly stejně — slijí se do jednoho. */
+  if (n == 0 && !need_snapshot) {
     return;
   }
-  /* Snapshot + WS odeslání může blokovat dlouho (httpd send timeout) — bez
-   * resetu TWDT hlásí web_server_task timeout. */
+  /* Složení snapshotu a BLE notifikace mohou trvat (WS odesílá httpd task
+   * asynchronně) — bez resetu TWDT hlásí web_server_task timeout. */
   (void)web_server_task_wdt_reset_safe();
   size_t fh = esp_get_free_heap_size();
   if (fh < 10240) {
@@ -3055,26 +3221,6 @@ void czechmate_on_game_state_changed(void) {
 // TIMER API HANDLERS
 // ============================================================================
 
-esp_err_t http_get_timer_handler(httpd_req_t *req) {
-  ESP_LOGD(TAG, "GET /api/timer");
-
-  // Lokalni buffer jen pro timer JSON (~1 KiB); JSON_BUFFER_SIZE na stacku = overflow httpd (8192 B).
-  char local_json[TIMER_HTTP_JSON_MAX];
-  esp_err_t ret = game_get_timer_json(local_json, sizeof(local_json));
-  if (ret != ESP_OK) {
-    httpd_resp_set_status(req, "500 Internal Server Error");
-    httpd_resp_send(req, "Failed to get timer state", -1);
-    return ESP_FAIL;
-  }
-
-  // Zabranit cachovani timer odpovedi v prohlizeci
-  httpd_resp_set_hdr(req, "Cache-Control", "no-store");
-  httpd_resp_set_type(req, "application/json");
-  httpd_resp_send(req, local_json, strlen(local_json));
-
-  return ESP_OK;
-}
-
 esp_err_t http_post_timer_config_handler(httpd_req_t *req) {
   ESP_LOGI(TAG, "POST /api/timer/config");
 
@@ -3138,7 +3284,7 @@ esp_err_t http_post_timer_config_handler(httpd_req_t *req) {
       int minutes;
       if (sscanf(minutes_str, "\"custom_minutes\":%d", &minutes) == 1) {
         if (minutes >= 1 && minutes <= 180) {
-          cmd.timer_data.timer_config.custom_minutes = (uint32_t)minutes;
+          cmd.timer_data.timer_config.custom_minutes = (uint16_t)minutes;
         } else {
           httpd_resp_set_status(req, "400 Bad Request");
           httpd_resp_send(req, "Minutes must be 1-180", -1);
@@ -3151,7 +3297,7 @@ esp_err_t http_post_timer_config_handler(httpd_req_t *req) {
       int increment;
       if (sscanf(increment_str, "\"custom_increment\":%d", &increment) == 1) {
         if (increment >= 0 && increment <= 60) {
-          cmd.timer_data.timer_config.custom_increment = (uint32_t)increment;
+          cmd.timer_data.timer_config.custom_increment = (uint16_t)increment;
         } else {
           httpd_resp_set_status(req, "400 Bad Request");
           httpd_resp_send(req, "Increment must be 0-60", -1);
@@ -3429,16 +3575,6 @@ void web_server_task_start(void *pvParameters) {
   ESP_LOGI(TAG, "HTTP server started");
   czechmate_mdns_ensure_started();
 
-  /* Jednorazove nacteni jasu do cache – GET /api/status pak nepristupuje k NVS
-   */
-  {
-    system_config_t config;
-    if (config_load_from_nvs(&config) == ESP_OK) {
-      cached_brightness = config.brightness_level;
-      cached_brightness_valid = true;
-    }
-  }
-
   task_running = true;
   ESP_LOGI(TAG, "Web server task started successfully");
   if (wifi_ap_active) {
@@ -3471,6 +3607,10 @@ void web_server_task_start(void *pvParameters) {
 
     /* Snapshot WS/BLE mimo game_task (fronta z czechmate_on_game_state_changed). */
     web_server_process_snapshot_notify_queue();
+#if CONFIG_CHESS_ENABLE_WEB_SERVER && CONFIG_HTTPD_WS_SUPPORT
+    /* Odložené WS pushe (rate limit / klient měl rámec ve frontě). */
+    ws_push_service();
+#endif
 
     // Update web server state
     web_server_update_state();
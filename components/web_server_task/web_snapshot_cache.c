@@ -0,0 +1,154 @@
+/**
+ * @file web_snapshot_cache.c
+ * @brief Sdílená cache snapshot JSON (HTTP, WebSocket, BLE, UART CLI).
+ *
+ * Snapshot se skládá nejvýše jednou za `game_get_state_revision()`; všichni
+ * konzumenti dostanou stejný neměnný buffer s počítadlem referencí. Buffer
+ * se uvolní až poslední `web_snapshot_release()` — nový build tak nikdy
+ * nepřepíše data, která zrovna odchází přes httpd_ws_send_data / BLE notify.
+ *
+ * Klíč = state revision. Sekundární stáří (`WEB_SNAPSHOT_MAX_AGE_MS`) drží
+ * čerstvé pole `clock` a web/lampa fieldy, které revizi nebumpují.
+ */
+
+#include "web_server_task.h"
+#include "web_server_internal.h"
+#include "../game_task/include/game_task.h"
+
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char *TAG = "WEB_SNAP";
+
+/** Max stáří cache v rámci jedné revize (tikající hodiny, jas, lampa). */
+#define WEB_SNAPSHOT_MAX_AGE_MS 1000
+
+struct web_snapshot {
+  uint32_t refs;        ///< Počet držitelů (cache sama = 1)
+  uint32_t revision;    ///< game_get_state_revision() při buildu
+  int64_t built_us;     ///< esp_timer_get_time() při buildu
+  size_t len;           ///< Délka JSON bez NUL
+  char *json;           ///< JSON + NUL (heap z json_writer_take)
+};
+
+static portMUX_TYPE s_snap_mux = portMUX_INITIALIZER_UNLOCKED;
+static web_snapshot_t *s_current;  ///< Poslední build (drží 1 referenci)
+static uint32_t s_stat_builds;
+static uint32_t s_stat_hits;
+
+static void web_snapshot_unref(web_snapshot_t *snap) {
+  if (snap == NULL) {
+    return;
+  }
+  bool last;
+  taskENTER_CRITICAL(&s_snap_mux);
+  last = (--snap->refs == 0);
+  taskEXIT_CRITICAL(&s_snap_mux);
+  if (last) {
+    free(snap->json);
+    free(snap);
+  }
+}
+
+/** Vrátí referenci na aktuální snapshot, pokud je pro `rev` ještě čerstvý. */
+static web_snapshot_t *web_snapshot_try_hit(uint32_t rev, int64_t now_us) {
+  web_snapshot_t *hit = NULL;
+  taskENTER_CRITICAL(&s_snap_mux);
+  if (s_current != NULL && s_current->revision == rev &&
+      now_us - s_current->built_us < (int64_t)WEB_SNAPSHOT_MAX_AGE_MS * 1000) {
+    s_current->refs++;
+    hit = s_current;
+  }
+  taskEXIT_CRITICAL(&s_snap_mux);
+  return hit;
+}
+
+esp_err_t web_snapshot_acquire(web_snapshot_t **out) {
+  if (out == NULL) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  *out = NULL;
+
+  uint32_t rev = game_get_state_revision();
+  web_snapshot_t *snap = web_snapshot_try_hit(rev, esp_timer_get_time());
+  if (snap != NULL) {
+    s_stat_hits++;
+    *out = snap;
+    return ESP_OK;
+  }
+
+  /* Build pod snapshot_build_mutex — souběžný HTTP/BLE/WS čekající na mutex po
+   * jeho uvolnění trefí cache (druhá kontrola níže) místo dalšího buildu. */
+  snapshot_build_mutex_take();
+  rev = game_get_state_revision();
+  snap = web_snapshot_try_hit(rev, esp_timer_get_time());
+  if (snap != NULL) {
+    snapshot_build_mutex_give();
+    s_stat_hits++;
+    *out = snap;
+    return ESP_OK;
+  }
+
+  char *json = NULL;
+  size_t len = 0;
+  esp_err_t ret = build_snapshot_json_locked(&json, &len);
+  if (ret != ESP_OK) {
+    snapshot_build_mutex_give();
+    return ret;
+  }
+  snap = (web_snapshot_t *)malloc(sizeof(*snap));
+  if (snap == NULL) {
+    snapshot_build_mutex_give();
+    free(json);
+    ESP_LOGE(TAG, "snapshot cache: malloc failed (%u B JSON)", (unsigned)len);
+    return ESP_ERR_NO_MEM;
+  }
+  snap->refs = 2; /* cache + volající */
+  snap->revision = rev;
+  snap->built_us = esp_timer_get_time();
+  snap->len = len;
+  snap->json = json;
+  web_snapshot_delta_note_build(rev, snap->json, len);
+
+  taskENTER_CRITICAL(&s_snap_mux);
+  web_snapshot_t *old = s_current;
+  s_current = snap;
+  taskEXIT_CRITICAL(&s_snap_mux);
+  snapshot_build_mutex_give();
+
+  web_snapshot_unref(old);
+  s_stat_builds++;
+  ESP_LOGD(TAG, "snapshot rev=%" PRIu32 " built (%u B, builds=%" PRIu32
+           " hits=%" PRIu32 ")",
+           rev, (unsigned)len, s_stat_builds, s_stat_hits);
+  *out = snap;
+  return ESP_OK;
+}
+
+void web_snapshot_release(web_snapshot_t *snap) { web_snapshot_unref(snap); }
+
+const char *web_snapshot_json(const web_snapshot_t *snap) {
+  return snap ? snap->json : NULL;
+}
+
+size_t web_snapshot_len(const web_snapshot_t *snap) {
+  return snap ? snap->len : 0;
+}
+
+uint32_t web_snapshot_revision(const web_snapshot_t *snap) {
+  return snap ? snap->revision : 0;
+}
+
+void web_snapshot_cache_invalidate(void) {
+  taskENTER_CRITICAL(&s_snap_mux);
+  web_snapshot_t *old = s_current;
+  s_current = NULL;
+  taskEXIT_CRITICAL(&s_snap_mux);
+  web_snapshot_unref(old);
+}
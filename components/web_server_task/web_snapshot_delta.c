@@ -0,0 +1,804 @@
+/**
+ * @file web_snapshot_delta.c
+ * @brief Delta (patch) snapshot protokol pro WebSocket a BLE klienty.
+ *
+ * Každý build snapshotu (web_snapshot_cache.c) se zde rozloží na "digest"
+ * (64 polí desky, délka historie, hash hodnot klíčů status/clock/captured)
+ * a porovná s předchozím buildem. Rozdíl se uloží do kruhu posledních
+ * `WEB_DELTA_RING_LEN` revizí — jen bitmaska polí, odkud poslat historii
+ * a hashe změněných klíčů; samotné hodnoty se berou až při skládání delty
+ * z aktuálního snapshotu.
+ *
+ * Klient potvrdí `state_version` (WS text `{"type":"ack","state_version":N}`,
+ * BLE `{"cmd":"snapshot_ack","state_version":N}`) a pak dostává:
+ *
+ *   {"type":"delta","base":N,"state_version":M,"timestamp":T,
+ *    "board":[[idx,"P"],...],                 idx = row*8+col jako v "board"
+ *    "history":{"from":K,"moves":[...]},      zkrátit na K a připojit
+ *    "status":{...},"clock":{...},"captured":{...},   merge klíčů
+ *    "replace":["status"]}                    sekce poslaná celá (nahradit)
+ *
+ * Delta je vždy nadmnožina (posílají se aktuální hodnoty všech klíčů
+ * změněných od první buildu revize `base`), takže opakované použití je
+ * bezpečné. Když `base` v kruhu chybí (mezera, reboot, nový klient),
+ * pošle se plný snapshot — ten nemá pole "type".
+ */
+
+#include "web_server_task.h"
+#include "web_server_internal.h"
+
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char *TAG = "WEB_DELTA";
+
+/** Počet revizí, ke kterým umíme složit deltu. */
+#define WEB_DELTA_RING_LEN 16
+/** Max změněných klíčů v jedné položce kruhu (pak se sekce pošle celá). */
+#define WEB_DELTA_ENTRY_KEYS 24
+/** Max klíčů v digestu (root + status + clock + captured). */
+#define WEB_DELTA_MAX_KEYS 96
+/** Max sledovaných klientů (WS fd + 1x BLE). */
+#define WEB_DELTA_MAX_CLIENTS 8
+/** Tahy s vlastním hashem v digestu (GAME_TASK_MAX_MOVES_HISTORY = 200). */
+#define WEB_DELTA_MAX_PLIES 256
+/** Rezerva nad délku plného snapshotu pro hlavičku delty. */
+#define WEB_DELTA_HEADER_RESERVE 192
+
+/** Sekce snapshotu; bit v `replace_mask`. */
+typedef enum {
+  WEB_DELTA_SEC_ROOT = 0, ///< Ostatní top-level klíče (game_id, …)
+  WEB_DELTA_SEC_STATUS,
+  WEB_DELTA_SEC_CLOCK,
+  WEB_DELTA_SEC_CAPTURED,
+  WEB_DELTA_SEC_COUNT
+} web_delta_section_t;
+
+/** Položka `replace_mask`: delta nelze složit, poslat plný snapshot. */
+#define WEB_DELTA_FULL 0x80u
+#define WEB_DELTA_HISTORY_NONE 0xFFFFu
+
+static const char *const s_section_names[WEB_DELTA_SEC_COUNT] = {
+    "", "status", "clock", "captured"};
+
+typedef struct {
+  uint32_t revision;     ///< Revize buildu, do kterého změna vede
+  uint64_t squares;      ///< Změněná pole (bit = row*8+col)
+  uint16_t history_from; ///< Od kterého tahu poslat historii
+  uint8_t replace_mask;  ///< Sekce k poslání celé (bit = web_delta_section_t)
+  uint8_t key_count;
+  uint32_t keys[WEB_DELTA_ENTRY_KEYS]; ///< Hashe změněných klíčů
+} web_delta_entry_t;
+
+typedef struct {
+  uint32_t key;   ///< Hash (sekce + jméno klíče)
+  uint32_t value; ///< Hash JSON hodnoty
+  uint8_t section;
+} web_delta_key_t;
+
+typedef struct {
+  bool valid;
+  char squares[64];
+  uint16_t history_len;
+  uint32_t history[WEB_DELTA_MAX_PLIES]; ///< Hash každého tahu
+  uint16_t key_count;
+  bool key_overflow;
+  web_delta_key_t keys[WEB_DELTA_MAX_KEYS];
+} web_delta_digest_t;
+
+typedef struct {
+  bool used;
+  int fd;            ///< WS fd nebo WEB_DELTA_CLIENT_BLE
+  uint32_t session;  ///< BLE session (ble_task_conn_session)
+  bool enabled;      ///< Klient poslal ack → chce delty
+  bool have_base;    ///< false = příští push plný
+  uint32_t base;     ///< Poslední potvrzená / odeslaná revize
+} web_delta_client_t;
+
+/* Kruh + digest: jen pod snapshot_build_mutex (note i compose). */
+static web_delta_entry_t s_ring[WEB_DELTA_RING_LEN];
+static uint8_t s_ring_head;  ///< Index další volné položky
+static uint8_t s_ring_count;
+static web_delta_digest_t s_digest;
+static web_delta_digest_t s_digest_next;
+
+/* Klienti: zápis z httpd tasku (ack), čtení z web_server_task. */
+static portMUX_TYPE s_client_mux = portMUX_INITIALIZER_UNLOCKED;
+static web_delta_client_t s_clients[WEB_DELTA_MAX_CLIENTS];
+
+static uint32_t s_stat_deltas;
+static uint32_t s_stat_fulls;
+
+// ============================================================================
+// MINI JSON SKENER (jen nad výstupem build_snapshot_json_locked)
+// ============================================================================
+
+static uint32_t delta_fnv1a(uint32_t h, const char *p, size_t n) {
+  for (size_t i = 0; i < n; i++) {
+    h ^= (uint8_t)p[i];
+    h *= 16777619u;
+  }
+  return h;
+}
+
+static uint32_t delta_key_hash(uint8_t section, const char *k, size_t n) {
+  uint32_t h = delta_fnv1a(2166136261u, (const char *)&section, 1);
+  return delta_fnv1a(h, k, n);
+}
+
+static const char *delta_skip_ws(const char *p, const char *end) {
+  while (p < end && (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t')) {
+    p++;
+  }
+  return p;
+}
+
+/** Konec JSON hodnoty začínající na `p` (NULL při chybě). */
+static const char *delta_value_end(const char *p, const char *end) {
+  int depth = 0;
+  bool in_str = false;
+  for (; p < end; p++) {
+    char c = *p;
+    if (in_str) {
+      if (c == '\\') {
+        p++;
+      } else if (c == '"') {
+        in_str = false;
+        if (depth == 0) {
+          return p + 1;
+        }
+      }
+      continue;
+    }
+    if (c == '"') {
+      in_str = true;
+    } else if (c == '{' || c == '[') {
+      depth++;
+    } else if (c == '}' || c == ']') {
+      if (depth == 0) {
+        return p; /* skalár ukončený rodičem */
+      }
+      if (--depth == 0) {
+        return p + 1;
+      }
+    } else if (c == ',' && depth == 0) {
+      return p;
+    }
+  }
+  return (depth == 0 && !in_str) ? p : NULL;
+}
+
+/**
+ * Další člen objektu. `*pp` ukazuje za '{' nebo za předchozí hodnotu.
+ * @return false na konci objektu nebo při chybě
+ */
+static bool delta_next_member(const char **pp, const char *end,
+                              const char **key, size_t *key_len,
+                              const char **val, size_t *val_len) {
+  const char *p = delta_skip_ws(*pp, end);
+  if (p < end && *p == ',') {
+    p = delta_skip_ws(p + 1, end);
+  }
+  if (p >= end || *p != '"') {
+    return false;
+  }
+  const char *k = p + 1;
+  const char *ke = memchr(k, '"', (size_t)(end - k));
+  if (ke == NULL) {
+    return false;
+  }
+  p = delta_skip_ws(ke + 1, end);
+  if (p >= end || *p != ':') {
+    return false;
+  }
+  p = delta_skip_ws(p + 1, end);
+  const char *ve = delta_value_end(p, end);
+  if (ve == NULL || ve == p) {
+    return false;
+  }
+  *key = k;
+  *key_len = (size_t)(ke - k);
+  *val = p;
+  *val_len = (size_t)(ve - p);
+  *pp = ve;
+  return true;
+}
+
+/** Další prvek pole. `*pp` ukazuje za '[' nebo za předchozí prvek. */
+static bool delta_next_element(const char **pp, const char *end,
+                               const char **val, size_t *val_len) {
+  const char *p = delta_skip_ws(*pp, end);
+  if (p < end && *p == ',') {
+    p = delta_skip_ws(p + 1, end);
+  }
+  if (p >= end || *p == ']') {
+    return false;
+  }
+  const char *ve = delta_value_end(p, end);
+  if (ve == NULL || ve == p) {
+    return false;
+  }
+  *val = p;
+  *val_len = (size_t)(ve - p);
+  *pp = ve;
+  return true;
+}
+
+static bool delta_key_is(const char *k, size_t n, const char *lit) {
+  return strlen(lit) == n && memcmp(k, lit, n) == 0;
+}
+
+static int delta_section_of(const char *k, size_t n) {
+  for (int s = 1; s < WEB_DELTA_SEC_COUNT; s++) {
+    if (delta_key_is(k, n, s_section_names[s])) {
+      return s;
+    }
+  }
+  return -1;
+}
+
+/** Iteruje `"history":{"moves":[...]}`; vrací začátek pole tahů. */
+static const char *delta_history_moves(const char *val, size_t len) {
+  const char *end = val + len;
+  if (len < 2 || *val != '{') {
+    return NULL;
+  }
+  const char *p = val + 1;
+  const char *k, *v;
+  size_t kn, vn;
+  while (delta_next_member(&p, end, &k, &kn, &v, &vn)) {
+    if (delta_key_is(k, kn, "moves") && *v == '[') {
+      return v;
+    }
+  }
+  return NULL;
+}
+
+// ============================================================================
+// DIGEST + KRUH
+// ============================================================================
+
+static void delta_digest_add_key(web_delta_digest_t *d, uint8_t section,
+                                 const char *k, size_t kn, const char *v,
+                                 size_t vn) {
+  if (d->key_count >= WEB_DELTA_MAX_KEYS) {
+    d->key_overflow = true;
+    return;
+  }
+  web_delta_key_t *e = &d->keys[d->key_count++];
+  e->key = delta_key_hash(section, k, kn);
+  e->value = delta_fnv1a(2166136261u, v, vn);
+  e->section = section;
+}
+
+/** Rozloží snapshot JSON do digestu. */
+static bool delta_digest_parse(web_delta_digest_t *d, const char *json,
+                               size_t len) {
+  memset(d, 0, sizeof(*d));
+  const char *end = json + len;
+  const char *p = delta_skip_ws(json, end);
+  if (p >= end || *p != '{') {
+    return false;
+  }
+  p++;
+  bool have_board = false;
+  const char *k, *v;
+  size_t kn, vn;
+  while (delta_next_member(&p, end, &k, &kn, &v, &vn)) {
+    if (delta_key_is(k, kn, "state_version") ||
+        delta_key_is(k, kn, "timestamp")) {
+      continue;
+    }
+    if (delta_key_is(k, kn, "board")) {
+      const char *rp = v + 1, *row, *cell;
+      size_t rn, cn;
+      int r = 0;
+      while (r < 8 && delta_next_element(&rp, v + vn, &row, &rn)) {
+        const char *cp = row + 1;
+        int c = 0;
+        while (c < 8 && delta_next_element(&cp, row + rn, &cell, &cn)) {
+          d->squares[r * 8 + c] = (cn >= 3) ? cell[1] : ' ';
+          c++;
+        }
+        if (c != 8) {
+          return false;
+        }
+        r++;
+      }
+      if (r != 8) {
+        return false;
+      }
+      have_board = true;
+      continue;
+    }
+    if (delta_key_is(k, kn, "history")) {
+      const char *mv = delta_history_moves(v, vn);
+      if (mv == NULL) {
+        return false;
+      }
+      const char *hp = mv + 1, *m;
+      size_t mn;
+      uint16_t count = 0;
+      while (delta_next_element(&hp, v + vn, &m, &mn)) {
+        if (count < WEB_DELTA_MAX_PLIES) {
+          d->history[count] = delta_fnv1a(2166136261u, m, mn);
+        }
+        count++;
+      }
+      d->history_len = count;
+      continue;
+    }
+    int sec = delta_section_of(k, kn);
+    if (sec > 0 && *v == '{') {
+      const char *sp = v + 1, *sk, *sv;
+      size_t skn, svn;
+      while (delta_next_member(&sp, v + vn, &sk, &skn, &sv, &svn)) {
+        delta_digest_add_key(d, (uint8_t)sec, sk, skn, sv, svn);
+      }
+      continue;
+    }
+    delta_digest_add_key(d, WEB_DELTA_SEC_ROOT, k, kn, v, vn);
+  }
+  d->valid = have_board;
+  return have_board;
+}
+
+static void delta_entry_add_key(web_delta_entry_t *e, uint32_t key,
+                                uint8_t section) {
+  for (uint8_t i = 0; i < e->key_count; i++) {
+    if (e->keys[i] == key) {
+      return;
+    }
+  }
+  if (e->key_count >= WEB_DELTA_ENTRY_KEYS) {
+    e->replace_mask |= (uint8_t)(1u << section);
+    return;
+  }
+  e->keys[e->key_count++] = key;
+}
+
+static const web_delta_key_t *delta_digest_find(const web_delta_digest_t *d,
+                                                uint32_t key) {
+  for (uint16_t i = 0; i < d->key_count; i++) {
+    if (d->keys[i].key == key) {
+      return &d->keys[i];
+    }
+  }
+  return NULL;
+}
+
+/** Změna prev → next do položky kruhu (merge, pokud jde o stejnou revizi). */
+static void delta_diff_into(web_delta_entry_t *e, const web_delta_digest_t *prev,
+                            const web_delta_digest_t *next) {
+  if (next->key_overflow || prev->key_overflow) {
+    e->replace_mask |= WEB_DELTA_FULL;
+  }
+  for (int i = 0; i < 64; i++) {
+    if (prev->squares[i] != next->squares[i]) {
+      e->squares |= (uint64_t)1 << i;
+    }
+  }
+
+  /* První rozdílný tah; kratší historie = undo / nová hra (zkrátit). */
+  uint16_t common = prev->history_len < next->history_len ? prev->history_len
+                                                          : next->history_len;
+  uint16_t from = WEB_DELTA_HISTORY_NONE;
+  for (uint16_t i = 0; i < common; i++) {
+    if (i >= WEB_DELTA_MAX_PLIES || prev->history[i] != next->history[i]) {
+      from = i;
+      break;
+    }
+  }
+  if (from == WEB_DELTA_HISTORY_NONE && prev->history_len != next->history_len) {
+    from = common;
+  }
+  if (from < e->history_from) {
+    e->history_from = from;
+  }
+
+  for (uint16_t i = 0; i < next->key_count; i++) {
+    const web_delta_key_t *nk = &next->keys[i];
+    const web_delta_key_t *pk = delta_digest_find(prev, nk->key);
+    if (pk == NULL || pk->value != nk->value) {
+      delta_entry_add_key(e, nk->key, nk->section);
+    }
+  }
+  for (uint16_t i = 0; i < prev->key_count; i++) {
+    if (delta_digest_find(next, prev->keys[i].key) == NULL) {
+      /* Odebraný klíč — merge to neumí vyjádřit, sekce celá. */
+      e->replace_mask |= (uint8_t)(1u << prev->keys[i].section);
+    }
+  }
+}
+
+void web_snapshot_delta_note_build(uint32_t revision, const char *json,
+                                   size_t len) {
+  if (json == NULL || len == 0) {
+    return;
+  }
+  if (!delta_digest_parse(&s_digest_next, json, len)) {
+    ESP_LOGW(TAG, "snapshot rev=%" PRIu32 ": digest parse failed", revision);
+    s_digest.valid = false;
+    s_ring_count = 0; /* bez digestu nelze navázat — klienti dostanou full */
+    return;
+  }
+  web_delta_entry_t *e = NULL;
+  if (s_digest.valid && s_ring_count > 0) {
+    web_delta_entry_t *last =
+        &s_ring[(s_ring_head + WEB_DELTA_RING_LEN - 1) % WEB_DELTA_RING_LEN];
+    if (last->revision == revision) {
+      e = last; /* rebuild stejné revize (hodiny, lampa) → sloučit */
+    }
+  }
+  if (e == NULL) {
+    /* První digest dostane prázdnou položku — klient s touto revizí pak
+     * najde bázi v kruhu. */
+    e = &s_ring[s_ring_head];
+    memset(e, 0, sizeof(*e));
+    e->revision = revision;
+    e->history_from = WEB_DELTA_HISTORY_NONE;
+    s_ring_head = (uint8_t)((s_ring_head + 1) % WEB_DELTA_RING_LEN);
+    if (s_ring_count < WEB_DELTA_RING_LEN) {
+      s_ring_count++;
+    }
+  }
+  if (s_digest.valid) {
+    delta_diff_into(e, &s_digest, &s_digest_next);
+  }
+  memcpy(&s_digest, &s_digest_next, sizeof(s_digest));
+}
+
+// ============================================================================
+// SKLÁDÁNÍ DELTY
+// ============================================================================
+
+typedef struct {
+  char *buf;
+  size_t cap;
+  size_t len;
+  bool overflow;
+} delta_writer_t;
+
+static void dw_put(delta_writer_t *w, const char *s, size_t n) {
+  if (w->overflow || w->len + n >= w->cap) {
+    w->overflow = true;
+    return;
+  }
+  memcpy(w->buf + w->len, s, n);
+  w->len += n;
+  w->buf[w->len] = '\0';
+}
+
+static void dw_str(delta_writer_t *w, const char *s) { dw_put(w, s, strlen(s)); }
+
+static void dw_u32(delta_writer_t *w, uint32_t v) {
+  char tmp[12];
+  int n = snprintf(tmp, sizeof(tmp), "%" PRIu32, v);
+  dw_put(w, tmp, (size_t)n);
+}
+
+/** Sjednocení položek kruhu od revize `base` po nejnovější. */
+typedef struct {
+  uint64_t squares;
+  uint16_t history_from;
+  uint8_t replace_mask;
+  uint16_t key_count;
+  uint32_t keys[WEB_DELTA_RING_LEN * WEB_DELTA_ENTRY_KEYS];
+} delta_union_t;
+
+static delta_union_t s_union; /* pod snapshot_build_mutex */
+
+static bool delta_union_from(uint32_t base, delta_union_t *u) {
+  memset(u, 0, sizeof(*u));
+  u->history_from = WEB_DELTA_HISTORY_NONE;
+  int start = -1;
+  for (int i = 0; i < s_ring_count; i++) {
+    int idx = (s_ring_head + WEB_DELTA_RING_LEN - s_ring_count + i) %
+              WEB_DELTA_RING_LEN;
+    if (s_ring[idx].revision == base) {
+      start = i;
+      break;
+    }
+  }
+  if (start < 0) {
+    return false;
+  }
+  for (int i = start; i < s_ring_count; i++) {
+    const web_delta_entry_t *e =
+        &s_ring[(s_ring_head + WEB_DELTA_RING_LEN - s_ring_count + i) %
+                WEB_DELTA_RING_LEN];
+    u->squares |= e->squares;
+    u->replace_mask |= e->replace_mask;
+    if (e->history_from < u->history_from) {
+      u->history_from = e->history_from;
+    }
+    for (uint8_t k = 0; k < e->key_count; k++) {
+      u->keys[u->key_count++] = e->keys[k];
+    }
+  }
+  return (u->replace_mask & WEB_DELTA_FULL) == 0;
+}
+
+static bool delta_union_has(const delta_union_t *u, uint32_t key) {
+  for (uint16_t i = 0; i < u->key_count; i++) {
+    if (u->keys[i] == key) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/** Změněné klíče jedné sekce jako `"name":{...}` (nebo celá sekce). */
+static void delta_emit_section(delta_writer_t *w, const delta_union_t *u,
+                               uint8_t sec, const char *v, size_t vn) {
+  bool replace = (u->replace_mask & (1u << sec)) != 0;
+  if (replace) {
+    dw_str(w, ",\"");
+    dw_str(w, s_section_names[sec]);
+    dw_str(w, "\":");
+    dw_put(w, v, vn);
+    return;
+  }
+  const char *sp = v + 1, *sk, *sv;
+  size_t skn, svn;
+  bool first = true;
+  while (delta_next_member(&sp, v + vn, &sk, &skn, &sv, &svn)) {
+    if (!delta_union_has(u, delta_key_hash(sec, sk, skn))) {
+      continue;
+    }
+    if (first) {
+      dw_str(w, ",\"");
+      dw_str(w, s_section_names[sec]);
+      dw_str(w, "\":{");
+      first = false;
+    } else {
+      dw_str(w, ",");
+    }
+    dw_put(w, sk - 1, skn + 2);
+    dw_str(w, ":");
+    dw_put(w, sv, svn);
+  }
+  if (!first) {
+    dw_str(w, "}");
+  }
+}
+
+static void delta_emit_board(delta_writer_t *w, uint64_t mask, const char *v,
+                             size_t vn) {
+  if (mask == 0) {
+    return;
+  }
+  dw_str(w, ",\"board\":[");
+  bool first = true;
+  const char *rp = v + 1, *row, *cell;
+  size_t rn, cn;
+  for (int r = 0; r < 8 && delta_next_element(&rp, v + vn, &row, &rn); r++) {
+    const char *cp = row + 1;
+    for (int c = 0; c < 8 && delta_next_element(&cp, row + rn, &cell, &cn);
+         c++) {
+      int idx = r * 8 + c;
+      if ((mask & ((uint64_t)1 << idx)) == 0) {
+        continue;
+      }
+      dw_str(w, first ? "[" : ",[");
+      dw_u32(w, (uint32_t)idx);
+      dw_str(w, ",");
+      dw_put(w, cell, cn);
+      dw_str(w, "]");
+      first = false;
+    }
+  }
+  dw_str(w, "]");
+}
+
+static void delta_emit_history(delta_writer_t *w, uint16_t from, const char *v,
+                               size_t vn) {
+  if (from == WEB_DELTA_HISTORY_NONE) {
+    return;
+  }
+  const char *mv = delta_history_moves(v, vn);
+  if (mv == NULL) {
+    w->overflow = true;
+    return;
+  }
+  dw_str(w, ",\"history\":{\"from\":");
+  dw_u32(w, from);
+  dw_str(w, ",\"moves\":[");
+  const char *hp = mv + 1, *m;
+  size_t mn;
+  uint16_t i = 0;
+  bool first = true;
+  while (delta_next_element(&hp, v + vn, &m, &mn)) {
+    if (i++ < from) {
+      continue;
+    }
+    if (!first) {
+      dw_str(w, ",");
+    }
+    dw_put(w, m, mn);
+    first = false;
+  }
+  dw_str(w, "]}");
+}
+
+/** Složí deltu `base → snap`; volající drží snapshot_build_mutex. */
+static esp_err_t delta_build_locked(const web_snapshot_t *snap, uint32_t base,
+                                    char **out, size_t *out_len) {
+  const char *json = web_snapshot_json(snap);
+  size_t len = web_snapshot_len(snap);
+  if (!s_digest.valid || base > web_snapshot_revision(snap) ||
+      !delta_union_from(base, &s_union)) {
+    return ESP_ERR_NOT_FOUND;
+  }
+
+  delta_writer_t w = {.cap = len + WEB_DELTA_HEADER_RESERVE};
+  w.buf = (char *)malloc(w.cap);
+  if (w.buf == NULL) {
+    return ESP_ERR_NO_MEM;
+  }
+  dw_str(&w, "{\"type\":\"delta\",\"base\":");
+  dw_u32(&w, base);
+  dw_str(&w, ",\"state_version\":");
+  dw_u32(&w, web_snapshot_revision(snap));
+
+  const char *end = json + len;
+  const char *p = delta_skip_ws(json, end);
+  p = (p < end && *p == '{') ? p + 1 : end;
+  const char *k, *v;
+  size_t kn, vn;
+  uint8_t replaced = 0;
+  while (!w.overflow && delta_next_member(&p, end, &k, &kn, &v, &vn)) {
+    if (delta_key_is(k, kn, "state_version")) {
+      continue;
+    }
+    if (delta_key_is(k, kn, "timestamp")) {
+      dw_str(&w, ",\"timestamp\":");
+      dw_put(&w, v, vn);
+      continue;
+    }
+    if (delta_key_is(k, kn, "board")) {
+      delta_emit_board(&w, s_union.squares, v, vn);
+      continue;
+    }
+    if (delta_key_is(k, kn, "history")) {
+      delta_emit_history(&w, s_union.history_from, v, vn);
+      continue;
+    }
+    int sec = delta_section_of(k, kn);
+    if (sec > 0 && *v == '{') {
+      delta_emit_section(&w, &s_union, (uint8_t)sec, v, vn);
+      replaced |= (uint8_t)(s_union.replace_mask & (1u << sec));
+      continue;
+    }
+    if ((s_union.replace_mask & (1u << WEB_DELTA_SEC_ROOT)) ||
+        delta_union_has(&s_union, delta_key_hash(WEB_DELTA_SEC_ROOT, k, kn))) {
+      dw_str(&w, ",");
+      dw_put(&w, k - 1, kn + 2);
+      dw_str(&w, ":");
+      dw_put(&w, v, vn);
+    }
+  }
+  if (replaced != 0) {
+    dw_str(&w, ",\"replace\":[");
+    bool first = true;
+    for (int s = 1; s < WEB_DELTA_SEC_COUNT; s++) {
+      if (replaced & (1u << s)) {
+        dw_str(&w, first ? "\"" : ",\"");
+        dw_str(&w, s_section_names[s]);
+        dw_str(&w, "\"");
+        first = false;
+      }
+    }
+    dw_str(&w, "]");
+  }
+  dw_str(&w, "}");
+
+  /* Delta větší než plný snapshot nemá smysl (např. nová hra). */
+  if (w.overflow || w.len >= len) {
+    free(w.buf);
+    return ESP_ERR_INVALID_SIZE;
+  }
+  *out = w.buf;
+  *out_len = w.len;
+  return ESP_OK;
+}
+
+esp_err_t web_snapshot_delta_build(const web_snapshot_t *snap, uint32_t base,
+                                   char **out, size_t *out_len) {
+  if (snap == NULL || out == NULL || out_len == NULL) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  *out = NULL;
+  *out_len = 0;
+  snapshot_build_mutex_take();
+  esp_err_t ret = delta_build_locked(snap, base, out, out_len);
+  snapshot_build_mutex_give();
+  if (ret == ESP_OK) {
+    s_stat_deltas++;
+    ESP_LOGD(TAG, "delta %" PRIu32 "→%" PRIu32 ": %u B (full %u B)", base,
+             web_snapshot_revision(snap), (unsigned)*out_len,
+             (unsigned)web_snapshot_len(snap));
+  } else {
+    s_stat_fulls++;
+  }
+  return ret;
+}
+
+// ============================================================================
+// STAV KLIENTŮ
+// ============================================================================
+
+/** Volat pod s_client_mux. */
+static web_delta_client_t *delta_client_slot(int client, bool create) {
+  web_delta_client_t *free_slot = NULL;
+  for (int i = 0; i < WEB_DELTA_MAX_CLIENTS; i++) {
+    if (s_clients[i].used && s_clients[i].fd == client) {
+      return &s_clients[i];
+    }
+    if (free_slot == NULL && !s_clients[i].used) {
+      free_slot = &s_clients[i];
+    }
+  }
+  if (create && free_slot != NULL) {
+    memset(free_slot, 0, sizeof(*free_slot));
+    free_slot->used = true;
+    free_slot->fd = client;
+  }
+  return create ? free_slot : NULL;
+}
+
+void web_delta_client_reset(int client) {
+  taskENTER_CRITICAL(&s_client_mux);
+  web_delta_client_t *c = delta_client_slot(client, false);
+  if (c != NULL) {
+    c->used = false;
+  }
+  taskEXIT_CRITICAL(&s_client_mux);
+}
+
+void web_delta_client_ack(int client, uint32_t session, bool resync,
+                          uint32_t state_version) {
+  bool ok;
+  taskENTER_CRITICAL(&s_client_mux);
+  web_delta_client_t *c = delta_client_slot(client, true);
+  ok = (c != NULL);
+  if (ok) {
+    c->session = session;
+    c->enabled = true;
+    c->have_base = !resync;
+    c->base = state_version;
+  }
+  taskEXIT_CRITICAL(&s_client_mux);
+  if (!ok) {
+    ESP_LOGW(TAG, "delta client table full (client %d) → full snapshots",
+             client);
+  }
+}
+
+bool web_delta_client_base(int client, uint32_t session, uint32_t *base) {
+  bool delta = false;
+  taskENTER_CRITICAL(&s_client_mux);
+  web_delta_client_t *c = delta_client_slot(client, false);
+  if (c != NULL && c->enabled && c->session == session) {
+    *base = c->base;
+    delta = c->have_base;
+  }
+  taskEXIT_CRITICAL(&s_client_mux);
+  return delta;
+}
+
+void web_delta_client_sent(int client, uint32_t session, uint32_t revision) {
+  taskENTER_CRITICAL(&s_client_mux);
+  web_delta_client_t *c = delta_client_slot(client, false);
+  if (c != NULL && c->enabled && c->session == session) {
+    c->base = revision;
+    c->have_base = true;
+  }
+  taskEXIT_CRITICAL(&s_client_mux);
+}
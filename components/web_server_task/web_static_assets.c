@@ -0,0 +1,314 @@
+/**
+ * @file web_static_assets.c
+ * @brief GET /static/… — předkomprimované assety z flash, ETag a cache hlavičky.
+ *
+ * Jeden wildcard handler místo handleru na soubor (max_uri_handlers).
+ * Data se posílají po chunkách přímo z flash, bez kopie do RAM — buď z
+ * oddílu `assets` (CONFIG_CHESS_ASSETS_PARTITION, asset_store mmap), nebo z
+ * tabulky zkompilované do aplikace (rodata).
+ */
+
+#include "web_static_assets.h"
+
+#include "esp_http_server.h"
+#include "esp_log.h"
+#include "sdkconfig.h"
+
+#include <string.h>
+
+#if CONFIG_CHESS_ASSETS_PARTITION
+#include "asset_store.h"
+#include "board_api_auth.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#endif
+
+static const char *TAG = "WEB_STATIC";
+
+/** Velikost jednoho httpd_resp_send_chunk (~3 TCP segmenty). */
+#define WEB_STATIC_CHUNK 4096
+
+#if CONFIG_CHESS_ASSETS_PARTITION
+
+/** Buffer pro příjem obrazu POST /api/assets (heap, jen během uploadu). */
+#define WEB_ASSETS_RX_CHUNK 2048
+
+bool web_static_asset_find(const char *uri, web_static_asset_t *out,
+                           bool *is_hashed) {
+  asset_store_entry_t e;
+  if (!asset_store_find(uri, &e, is_hashed)) {
+    return false;
+  }
+  out->uri = e.name;
+  out->hashed_uri = e.hashed_name;
+  out->mime = e.mime;
+  out->encoding = e.encoding;
+  out->etag = e.etag;
+  out->data = e.data;
+  out->len = e.len;
+  return true;
+}
+
+static size_t web_static_flash_bytes(size_t *count) {
+  size_t flash = 0;
+  asset_store_entry_t e;
+  *count = asset_store_count();
+  for (size_t i = 0; i < *count; i++) {
+    if (asset_store_get(i, &e)) {
+      flash += e.len;
+    }
+  }
+  return flash;
+}
+
+#else
+
+bool web_static_asset_find(const char *uri, web_static_asset_t *out,
+                           bool *is_hashed) {
+  size_t n = strcspn(uri, "?#");
+  for (size_t i = 0; i < web_static_asset_count; i++) {
+    const web_static_asset_t *a = &web_static_assets[i];
+    if (strlen(a->uri) == n && strncmp(a->uri, uri, n) == 0) {
+      if (is_hashed != NULL) {
+        *is_hashed = false;
+      }
+      *out = *a;
+      return true;
+    }
+    if (a->hashed_uri != NULL && strlen(a->hashed_uri) == n &&
+        strncmp(a->hashed_uri, uri, n) == 0) {
+      if (is_hashed != NULL) {
+        *is_hashed = true;
+      }
+      *out = *a;
+      return true;
+    }
+  }
+  return false;
+}
+
+static size_t web_static_flash_bytes(size_t *count) {
+  size_t flash = 0;
+  *count = web_static_asset_count;
+  for (size_t i = 0; i < web_static_asset_count; i++) {
+    flash += web_static_assets[i].len;
+  }
+  return flash;
+}
+
+#endif
+
+/** True, pokud Accept-Encoding obsahuje `enc` (q=0 se neřeší — žádný klient to neposílá). */
+static bool web_static_accepts(httpd_req_t *req, const char *enc) {
+  if (enc[0] == '\0') {
+    return true;
+  }
+  char ae[96];
+  if (httpd_req_get_hdr_value_str(req, "Accept-Encoding", ae, sizeof(ae)) !=
+      ESP_OK) {
+    return false;
+  }
+  return strstr(ae, enc) != NULL;
+}
+
+static bool web_static_etag_matches(httpd_req_t *req,
+                                    const web_static_asset_t *a) {
+  char inm[64];
+  if (httpd_req_get_hdr_value_str(req, "If-None-Match", inm, sizeof(inm)) !=
+      ESP_OK) {
+    return false;
+  }
+  return strstr(inm, a->etag) != NULL || strcmp(inm, "*") == 0;
+}
+
+static esp_err_t http_get_static_handler(httpd_req_t *req) {
+  bool hashed = false;
+  web_static_asset_t asset;
+  const web_static_asset_t *a = &asset;
+  if (!web_static_asset_find(req->uri, &asset, &hashed)) {
+    httpd_resp_set_status(req, "404 Not Found");
+    return httpd_resp_send(req, "Not found", HTTPD_RESP_USE_STRLEN);
+  }
+
+  httpd_resp_set_hdr(req, "ETag", a->etag);
+  /* Hashovaná URI se nikdy nezmění; stabilní URI po dni revaliduje (304). */
+  httpd_resp_set_hdr(req, "Cache-Control",
+                     hashed ? "public, max-age=31536000, immutable"
+                            : "public, max-age=86400, must-revalidate");
+  if (a->encoding[0] != '\0') {
+    httpd_resp_set_hdr(req, "Vary", "Accept-Encoding");
+  }
+
+  if (web_static_etag_matches(req, a)) {
+    httpd_resp_set_status(req, "304 Not Modified");
+    return httpd_resp_send(req, NULL, 0);
+  }
+
+  /* Ve flash je jen komprimovaná varianta — rozbalovat na ESP nemá smysl,
+   * všechny prohlížeče i Dart HttpClient gzip posílají. */
+  if (!web_static_accepts(req, a->encoding)) {
+    ESP_LOGW(TAG, "%s: client does not accept %s", a->uri, a->encoding);
+    httpd_resp_set_status(req, "406 Not Acceptable");
+    return httpd_resp_send(req, "Requires Accept-Encoding", HTTPD_RESP_USE_STRLEN);
+  }
+
+  httpd_resp_set_type(req, a->mime);
+  if (a->encoding[0] != '\0') {
+    httpd_resp_set_hdr(req, "Content-Encoding", a->encoding);
+  }
+  if (a->len <= WEB_STATIC_CHUNK) {
+    return httpd_resp_send(req, (const char *)a->data, (ssize_t)a->len);
+  }
+  for (size_t off = 0; off < a->len; off += WEB_STATIC_CHUNK) {
+    size_t n = a->len - off;
+    if (n > WEB_STATIC_CHUNK) {
+      n = WEB_STATIC_CHUNK;
+    }
+    esp_err_t e =
+        httpd_resp_send_chunk(req, (const char *)a->data + off, (ssize_t)n);
+    if (e != ESP_OK) {
+      ESP_LOGW(TAG, "%s: send failed at %u B: %s", a->uri, (unsigned)off,
+               esp_err_to_name(e));
+      return e;
+    }
+  }
+  return httpd_resp_send_chunk(req, NULL, 0);
+}
+
+#if CONFIG_CHESS_ASSETS_PARTITION
+
+/** GET /api/assets — verze obrazu v oddílu assets. */
+static esp_err_t http_get_assets_handler(httpd_req_t *req) {
+  uint32_t image_id = 0, image_size = 0, part_size = 0;
+  asset_store_info(&image_id, &image_size, &part_size);
+  char buf[160];
+  snprintf(buf, sizeof(buf),
+           "{\"available\":%s,\"image_id\":\"%08lx\",\"count\":%u,"
+           "\"size\":%lu,\"partition_size\":%lu}",
+           asset_store_available() ? "true" : "false", (unsigned long)image_id,
+           (unsigned)asset_store_count(), (unsigned long)image_size,
+           (unsigned long)part_size);
+  httpd_resp_set_type(req, "application/json");
+  httpd_resp_set_hdr(req, "Cache-Control", "no-store");
+  return httpd_resp_send(req, buf, HTTPD_RESP_USE_STRLEN);
+}
+
+static esp_err_t web_assets_reply(httpd_req_t *req, const char *status,
+                                  const char *json) {
+  httpd_resp_set_status(req, status);
+  httpd_resp_set_type(req, "application/json");
+  return httpd_resp_send(req, json, HTTPD_RESP_USE_STRLEN);
+}
+
+/**
+ * POST /api/assets — tělo = build/assets.bin (admin token).
+ *
+ * Obraz se zapisuje rovnou do oddílu po částech; hlavička až po kontrole
+ * CRC, takže přerušený upload nechá oddíl prázdný, ne poškozený.
+ */
+static esp_err_t http_post_assets_handler(httpd_req_t *req) {
+  if (board_api_auth_admin_http_denied(req)) {
+    return ESP_OK;
+  }
+  if (req->content_len == 0) {
+    return web_assets_reply(req, "400 Bad Request",
+                            "{\"ok\":false,\"error\":\"empty_body\"}");
+  }
+  esp_err_t e = asset_store_update_begin(req->content_len);
+  if (e == ESP_ERR_INVALID_SIZE) {
+    return web_assets_reply(req, "413 Payload Too Large",
+                            "{\"ok\":false,\"error\":\"image_too_large\"}");
+  }
+  if (e == ESP_ERR_INVALID_STATE) {
+    return web_assets_reply(req, "409 Conflict",
+                            "{\"ok\":false,\"error\":\"busy\"}");
+  }
+  if (e != ESP_OK) {
+    return web_assets_reply(req, "503 Service Unavailable",
+                            "{\"ok\":false,\"error\":\"no_assets_partition\"}");
+  }
+
+  char *buf = malloc(WEB_ASSETS_RX_CHUNK);
+  if (buf == NULL) {
+    asset_store_update_abort();
+    return web_assets_reply(req, "500 Internal Server Error",
+                            "{\"ok\":false,\"error\":\"no_mem\"}");
+  }
+  size_t left = req->content_len;
+  while (left > 0) {
+    int rlen = httpd_req_recv(
+        req, buf, left < WEB_ASSETS_RX_CHUNK ? left : WEB_ASSETS_RX_CHUNK);
+    if (rlen == HTTPD_SOCK_ERR_TIMEOUT) {
+      continue;
+    }
+    if (rlen <= 0) {
+      e = ESP_FAIL;
+      break;
+    }
+    e = asset_store_update_write(buf, (size_t)rlen);
+    if (e != ESP_OK) {
+      break;
+    }
+    left -= (size_t)rlen;
+  }
+  free(buf);
+  if (left > 0 || e != ESP_OK) {
+    asset_store_update_abort();
+    ESP_LOGW(TAG, "assets upload failed: %s", esp_err_to_name(e));
+    return web_assets_reply(req, "500 Internal Server Error",
+                            "{\"ok\":false,\"error\":\"write_failed\"}");
+  }
+
+  e = asset_store_update_end();
+  if (e != ESP_OK) {
+    return web_assets_reply(req, "422 Unprocessable Entity",
+                            "{\"ok\":false,\"error\":\"invalid_image\"}");
+  }
+  return http_get_assets_handler(req);
+}
+
+static esp_err_t web_assets_register_api(httpd_handle_t hd) {
+  httpd_uri_t get_u = {.uri = "/api/assets",
+                       .method = HTTP_GET,
+                       .handler = http_get_assets_handler,
+                       .user_ctx = NULL};
+  httpd_uri_t post_u = {.uri = "/api/assets",
+                        .method = HTTP_POST,
+                        .handler = http_post_assets_handler,
+                        .user_ctx = NULL};
+  esp_err_t e = httpd_register_uri_handler(hd, &get_u);
+  if (e == ESP_OK) {
+    e = httpd_register_uri_handler(hd, &post_u);
+  }
+  return e;
+}
+
+#endif
+
+esp_err_t web_static_register_http_uris(httpd_handle_t hd) {
+  if (hd == NULL) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  httpd_uri_t u = {.uri = "/static/*",
+                   .method = HTTP_GET,
+                   .handler = http_get_static_handler,
+                   .user_ctx = NULL};
+  esp_err_t e = httpd_register_uri_handler(hd, &u);
+  if (e != ESP_OK) {
+    ESP_LOGE(TAG, "register /static/* failed: %s", esp_err_to_name(e));
+    return e;
+  }
+#if CONFIG_CHESS_ASSETS_PARTITION
+  e = web_assets_register_api(hd);
+  if (e != ESP_OK) {
+    ESP_LOGE(TAG, "register /api/assets failed: %s", esp_err_to_name(e));
+    return e;
+  }
+#endif
+  size_t count = 0;
+  size_t flash = web_static_flash_bytes(&count);
+  ESP_LOGI(TAG, "registered /static/* (%u assets, %u B flash)",
+           (unsigned)count, (unsigned)flash);
+  return ESP_OK;
+}
@@ -1,11 +1,12 @@
 /**
  * @file web_ws.c
- * @brief WebSocket handler and snapshot broadcast (/ws).
+ * @brief WebSocket handler and snapshot push scheduler (/ws).
  */
 
 #include "web_server_task.h"
 #include "web_server_internal.h"
 
+#include "cJSON.h"
 #include "esp_http_server.h"
 #include "esp_log.h"
 #include "esp_system.h"
@@ -13,6 +14,7 @@
 #include "freertos/FreeRTOS.h"
 #include "freertos/queue.h"
 
+#include <inttypes.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -24,9 +26,43 @@ static esp_timer_handle_t ws_broadcast_timer = NULL;
 
 #if CONFIG_HTTPD_WS_SUPPORT
 #define WS_MAX_CLIENT_FDS 32
+/** Max různých bází delty složených v jednom broadcastu. */
+#define WS_DELTA_BASES_MAX 4
+
+static void ws_push_client_join(int fd);
+static void ws_push_client_mark(int fd);
+
+/**
+ * Zpráva od klienta: {"type":"ack","state_version":N} zapne delty od N,
+ * {"type":"resync"} vyžádá plný snapshot, {"type":"full"} delty vypne.
+ */
+static void ws_handle_client_text(int fd, const uint8_t *payload, size_t len) {
+  cJSON *root = cJSON_ParseWithLength((const char *)payload, len);
+  if (root == NULL) {
+    ESP_LOGD(TAG, "WS fd %d: text frame není JSON, ignoruji", fd);
+    return;
+  }
+  const cJSON *type = cJSON_GetObjectItemCaseSensitive(root, "type");
+  const cJSON *ver = cJSON_GetObjectItemCaseSensitive(root, "state_version");
+  if (cJSON_IsString(type) && strcmp(type->valuestring, "ack") == 0 &&
+      cJSON_IsNumber(ver) && ver->valuedouble >= 0) {
+    web_delta_client_ack(fd, 0, false, (uint32_t)ver->valuedouble);
+    ESP_LOGD(TAG, "WS fd %d: ack state_version=%u", fd,
+             (unsigned)ver->valuedouble);
+  } else if (cJSON_IsString(type) && strcmp(type->valuestring, "resync") == 0) {
+    web_delta_client_ack(fd, 0, true, 0);
+    ws_push_client_mark(fd); /* plný snapshot jen tomuto klientovi */
+  } else if (cJSON_IsString(type) && strcmp(type->valuestring, "full") == 0) {
+    web_delta_client_reset(fd);
+  }
+  cJSON_Delete(root);
+}
 
 esp_err_t http_ws_handler(httpd_req_t *req) {
   if (req->method == HTTP_GET) {
+    /* fd mohl patřit dřívějšímu klientovi — nový začíná plnými snapshoty. */
+    web_delta_client_reset(httpd_req_to_sockfd(req));
+    ws_push_client_join(httpd_req_to_sockfd(req));
     ESP_LOGD(TAG, "WebSocket handshake OK (/ws)");
     return ESP_OK;
   }
@@ -46,77 +82,437 @@ esp_err_t http_ws_handler(httpd_req_t *req) {
     }
     ws_pkt.payload = buf;
     ret = httpd_ws_recv_frame(req, &ws_pkt, ws_pkt.len);
-    free(buf);
     if (ret != ESP_OK) {
+      free(buf);
       ESP_LOGD(TAG, "ws recv payload: %s", esp_err_to_name(ret));
       return ret;
     }
+    if (ws_pkt.type == HTTPD_WS_TYPE_TEXT) {
+      ws_handle_client_text(httpd_req_to_sockfd(req), buf, ws_pkt.len);
+    }
+    free(buf);
   }
   return ESP_OK;
 }
 
-static bool ws_has_clients(void) {
-  if (web_server_get_httpd_handle() == NULL) {
-    return false;
+// ============================================================================
+// PUSH SCHEDULER
+// ============================================================================
+
+/*
+ * Broadcast jen označí klienty jako „pending“; ws_push_service() pak každému
+ * pošle nejnovější snapshot/deltu asynchronně (httpd_ws_send_data_async —
+ * posílá httpd task, web_server_task nečeká na síť). Na klienta nejvýš
+ * WS_PUSH_MAX_INFLIGHT rámců a jeden push za WS_PUSH_MIN_INTERVAL_MS; dávka
+ * změn během čekání se slije do jednoho pushe (skip-to-latest). Klient, který
+ * opakovaně selže, se odpojí.
+ */
+
+/** Min. rozestup pushů na klienta (max ~10 aktualizací/s). */
+#define WS_PUSH_MIN_INTERVAL_MS 100
+/** Rozeslané, ale nepotvrzené rámce na klienta. */
+#define WS_PUSH_MAX_INFLIGHT 1
+/** Po tolika chybách odeslání za sebou se session zavře. */
+#define WS_PUSH_MAX_FAILS 3
+
+typedef struct {
+  bool used;
+  int fd;
+  bool pending;         ///< Čeká novější stav než poslední push
+  uint8_t inflight;     ///< Async rámce ve frontě httpd
+  uint8_t fails;        ///< Chyby odeslání za sebou
+  int64_t last_push_us; ///< esp_timer_get_time() posledního pushe
+} ws_push_client_t;
+
+/** Payload sdílený klienty (plný snapshot nebo delta od jedné báze). */
+typedef struct {
+  uint32_t refs;
+  uint32_t revision;
+  web_snapshot_t *snap; ///< Plný snapshot (drží referenci), jinak NULL
+  char *delta;          ///< Delta JSON (malloc), jinak NULL
+  size_t delta_len;
+} ws_payload_t;
+
+/** Delty složené během jednoho průchodu (klienti se stejnou bází sdílí). */
+typedef struct {
+  uint32_t base;
+  ws_payload_t *payload; ///< NULL = delta se nevyplatí → plný snapshot
+} ws_delta_slot_t;
+
+static portMUX_TYPE s_push_mux = portMUX_INITIALIZER_UNLOCKED;
+static ws_push_client_t s_push_clients[WS_MAX_CLIENT_FDS];
+static uint32_t s_push_sent;
+static uint32_t s_push_coalesced;
+static uint32_t s_push_dropped;
+
+/** Volat pod s_push_mux. */
+static ws_push_client_t *ws_push_slot(int fd, bool create) {
+  ws_push_client_t *free_slot = NULL;
+  for (int i = 0; i < WS_MAX_CLIENT_FDS; i++) {
+    if (s_push_clients[i].used && s_push_clients[i].fd == fd) {
+      return &s_push_clients[i];
+    }
+    if (free_slot == NULL && !s_push_clients[i].used) {
+      free_slot = &s_push_clients[i];
+    }
+  }
+  if (create && free_slot != NULL) {
+    memset(free_slot, 0, sizeof(*free_slot));
+    free_slot->used = true;
+    free_slot->fd = fd;
+  }
+  return create ? free_slot : NULL;
+}
+
+static ws_payload_t *ws_payload_new(web_snapshot_t *snap, char *delta,
+                                    size_t delta_len) {
+  ws_payload_t *p = calloc(1, sizeof(*p));
+  if (p == NULL) {
+    free(delta);
+    return NULL;
+  }
+  p->refs = 1;
+  p->revision = web_snapshot_revision(snap);
+  p->delta = delta;
+  p->delta_len = delta_len;
+  /* Plný snapshot: vlastní reference z cache (stejný buffer, žádná kopie). */
+  if (delta == NULL) {
+    if (web_snapshot_acquire(&p->snap) != ESP_OK) {
+      free(p);
+      return NULL;
+    }
+    p->revision = web_snapshot_revision(p->snap);
+  }
+  return p;
+}
+
+static void ws_payload_ref(ws_payload_t *p) {
+  taskENTER_CRITICAL(&s_push_mux);
+  p->refs++;
+  taskEXIT_CRITICAL(&s_push_mux);
+}
+
+static void ws_payload_unref(ws_payload_t *p) {
+  if (p == NULL) {
+    return;
+  }
+  bool last;
+  taskENTER_CRITICAL(&s_push_mux);
+  last = (--p->refs == 0);
+  taskEXIT_CRITICAL(&s_push_mux);
+  if (last) {
+    web_snapshot_release(p->snap);
+    free(p->delta);
+    free(p);
+  }
+}
+
+static ws_payload_t *ws_delta_for_base(ws_delta_slot_t *slots, size_t *n_slots,
+                                       web_snapshot_t *snap, uint32_t base) {
+  for (size_t i = 0; i < *n_slots; i++) {
+    if (slots[i].base == base) {
+      return slots[i].payload;
+    }
+  }
+  if (*n_slots >= WS_DELTA_BASES_MAX) {
+    return NULL;
+  }
+  ws_delta_slot_t *s = &slots[(*n_slots)++];
+  s->base = base;
+  s->payload = NULL;
+  char *json = NULL;
+  size_t len = 0;
+  if (web_snapshot_delta_build(snap, base, &json, &len) == ESP_OK) {
+    s->payload = ws_payload_new(snap, json, len);
+  }
+  return s->payload;
+}
+
+/** Dokončení async rámce (běží v httpd tasku). */
+static void ws_push_done_cb(esp_err_t err, int fd, void *arg) {
+  ws_payload_t *p = (ws_payload_t *)arg;
+  if (err == ESP_OK) {
+    web_delta_client_sent(fd, 0, p->revision);
+  }
+  bool drop = false;
+  taskENTER_CRITICAL(&s_push_mux);
+  ws_push_client_t *c = ws_push_slot(fd, false);
+  if (c != NULL) {
+    if (c->inflight > 0) {
+      c->inflight--;
+    }
+    if (err == ESP_OK) {
+      c->fails = 0;
+    } else {
+      c->pending = true; /* příště nejnovější stav */
+      drop = (++c->fails >= WS_PUSH_MAX_FAILS);
+    }
+  }
+  taskEXIT_CRITICAL(&s_push_mux);
+  ws_payload_unref(p);
+  if (drop) {
+    s_push_dropped++;
+    ESP_LOGW(TAG, "WS fd %d: %d failed pushes → closing", fd,
+             WS_PUSH_MAX_FAILS);
+    httpd_sess_trigger_close(web_server_get_httpd_handle(), fd);
+  }
+}
+
+/**
+ * Aktuální WS fd do `fds`; zároveň uvolní sloty zavřených klientů.
+ * @return počet WS klientů
+ */
+static size_t ws_push_collect_clients(int *fds, size_t cap) {
+  httpd_handle_t hd = web_server_get_httpd_handle();
+  size_t n = cap;
+  if (httpd_get_client_list(hd, &n, fds) != ESP_OK) {
+    return 0;
+  }
+  size_t ws_n = 0;
+  for (size_t i = 0; i < n; i++) {
+    if (httpd_ws_get_fd_info(hd, fds[i]) == HTTPD_WS_CLIENT_WEBSOCKET) {
+      fds[ws_n++] = fds[i];
+    }
+  }
+  taskENTER_CRITICAL(&s_push_mux);
+  for (int i = 0; i < WS_MAX_CLIENT_FDS; i++) {
+    ws_push_client_t *c = &s_push_clients[i];
+    if (!c->used || c->inflight > 0) {
+      continue;
+    }
+    bool alive = false;
+    for (size_t j = 0; j < ws_n && !alive; j++) {
+      alive = (fds[j] == c->fd);
+    }
+    if (!alive) {
+      c->used = false;
+    }
+  }
+  taskEXIT_CRITICAL(&s_push_mux);
+  return ws_n;
+}
+
+static void ws_push_client_join(int fd) {
+  taskENTER_CRITICAL(&s_push_mux);
+  ws_push_client_t *c = ws_push_slot(fd, true);
+  if (c != NULL) {
+    c->inflight = 0;
+    c->fails = 0;
+    c->pending = true; /* nový klient dostane snapshot hned */
+    c->last_push_us = 0;
+  }
+  taskEXIT_CRITICAL(&s_push_mux);
+}
+
+static void ws_push_client_mark(int fd) {
+  taskENTER_CRITICAL(&s_push_mux);
+  ws_push_client_t *c = ws_push_slot(fd, true);
+  if (c != NULL) {
+    c->pending = true;
+  }
+  taskEXIT_CRITICAL(&s_push_mux);
+}
+
+void ws_push_service(void) {
+  httpd_handle_t hd = web_server_get_httpd_handle();
+  if (hd == NULL || !web_server_is_active()) {
+    return;
   }
-  size_t n = WS_MAX_CLIENT_FDS;
   int fds[WS_MAX_CLIENT_FDS];
-  if (httpd_get_client_list(web_server_get_httpd_handle(), &n, fds) != ESP_OK) {
-    return false;
+  size_t n = ws_push_collect_clients(fds, WS_MAX_CLIENT_FDS);
+  if (n == 0) {
+    return;
   }
+
+  /* Kdo může dostat push teď (pending, volné inflight, uplynul interval). */
+  int64_t now = esp_timer_get_time();
+  int ready[WS_MAX_CLIENT_FDS];
+  size_t n_ready = 0;
+  taskENTER_CRITICAL(&s_push_mux);
   for (size_t i = 0; i < n; i++) {
-    if (httpd_ws_get_fd_info(web_server_get_httpd_handle(), fds[i]) ==
-        HTTPD_WS_CLIENT_WEBSOCKET) {
-      return true;
+    ws_push_client_t *c = ws_push_slot(fds[i], false);
+    if (c == NULL || !c->pending) {
+      continue;
+    }
+    if (c->inflight >= WS_PUSH_MAX_INFLIGHT ||
+        now - c->last_push_us < (int64_t)WS_PUSH_MIN_INTERVAL_MS * 1000) {
+      continue;
+    }
+    c->pending = false;
+    c->inflight++;
+    c->last_push_us = now;
+    ready[n_ready++] = fds[i];
+  }
+  taskEXIT_CRITICAL(&s_push_mux);
+  if (n_ready == 0) {
+    return;
+  }
+
+  web_snapshot_t *snap = NULL;
+  if (web_snapshot_acquire(&snap) != ESP_OK) {
+    ESP_LOGD(TAG, "WS push: snapshot acquire failed");
+    taskENTER_CRITICAL(&s_push_mux);
+    for (size_t i = 0; i < n_ready; i++) {
+      ws_push_client_t *c = ws_push_slot(ready[i], false);
+      if (c != NULL) {
+        c->pending = true;
+        c->inflight--;
+      }
     }
+    taskEXIT_CRITICAL(&s_push_mux);
+    return;
   }
-  return false;
+
+  ws_payload_t *full = NULL;
+  ws_delta_slot_t slots[WS_DELTA_BASES_MAX];
+  size_t n_slots = 0;
+  size_t delta_count = 0;
+  for (size_t i = 0; i < n_ready; i++) {
+    int fd = ready[i];
+    ws_payload_t *p = NULL;
+    uint32_t base = 0;
+    if (web_delta_client_base(fd, 0, &base)) {
+      p = ws_delta_for_base(slots, &n_slots, snap, base);
+    }
+    if (p == NULL) {
+      if (full == NULL) {
+        full = ws_payload_new(snap, NULL, 0);
+      }
+      p = full;
+    } else {
+      delta_count++;
+    }
+
+    esp_err_t err = ESP_ERR_NO_MEM;
+    if (p != NULL) {
+      /* httpd si kopíruje jen rámec — payload drží reference do callbacku. */
+      httpd_ws_frame_t pkt = {
+          .type = HTTPD_WS_TYPE_TEXT,
+          .payload = (uint8_t *)(p->delta != NULL ? p->delta
+                                                  : web_snapshot_json(p->snap)),
+          .len = p->delta != NULL ? p->delta_len : web_snapshot_len(p->snap),
+          .final = true};
+      ws_payload_ref(p);
+      err = httpd_ws_send_data_async(hd, fd, &pkt, ws_push_done_cb, p);
+      if (err != ESP_OK) {
+        ws_payload_unref(p);
+      }
+    }
+    if (err != ESP_OK) {
+      ESP_LOGD(TAG, "WS push fd %d: %s", fd, esp_err_to_name(err));
+      taskENTER_CRITICAL(&s_push_mux);
+      ws_push_client_t *c = ws_push_slot(fd, false);
+      if (c != NULL) {
+        c->pending = true;
+        c->inflight--;
+      }
+      taskEXIT_CRITICAL(&s_push_mux);
+      continue;
+    }
+    s_push_sent++;
+  }
+
+  for (size_t i = 0; i < n_slots; i++) {
+    ws_payload_unref(slots[i].payload);
+  }
+  ws_payload_unref(full);
+  ESP_LOGD(TAG,
+           "[STAGING] WS push rev=%" PRIu32 " → %u/%u client(s) (%u delta), "
+           "sent=%" PRIu32 " coalesced=%" PRIu32 " dropped=%" PRIu32,
+           web_snapshot_revision(snap), (unsigned)n_ready, (unsigned)n,
+           (unsigned)delta_count, s_push_sent, s_push_coalesced,
+           s_push_dropped);
+  web_snapshot_release(snap);
 }
 
 void ws_broadcast_snapshot(void) {
   if (web_server_get_httpd_handle() == NULL || !web_server_is_active()) {
     return;
   }
-  if (!ws_has_clients()) {
+  int fds[WS_MAX_CLIENT_FDS];
+  size_t n = ws_push_collect_clients(fds, WS_MAX_CLIENT_FDS);
+  if (n == 0) {
     return;
   }
-  (void)web_server_task_wdt_reset_safe();
-  size_t len = 0;
-  if (build_snapshot_json(&len) != ESP_OK) {
-    ESP_LOGD(TAG, "WS broadcast: build_snapshot_json failed");
-    return;
+  taskENTER_CRITICAL(&s_push_mux);
+  for (size_t i = 0; i < n; i++) {
+    ws_push_client_t *c = ws_push_slot(fds[i], true);
+    if (c == NULL) {
+      continue;
+    }
+    if (c->pending) {
+      s_push_coalesced++; /* předchozí změna ještě neodešla — sloučí se */
+    }
+    c->pending = true;
+  }
+  taskEXIT_CRITICAL(&s_push_mux);
+  ws_push_service();
+}
+
+/** Malý event rámec sdílený klienty (JSON vlastní struktura, malloc). */
+typedef struct {
+  uint32_t refs;
+  size_t len;
+  char json[];
+} ws_event_frame_t;
+
+static void ws_event_frame_unref(ws_event_frame_t *f) {
+  bool last;
+  taskENTER_CRITICAL(&s_push_mux);
+  last = (--f->refs == 0);
+  taskEXIT_CRITICAL(&s_push_mux);
+  if (last) {
+    free(f);
   }
-  uint8_t *payload = (uint8_t *)malloc(len);
-  if (payload == NULL) {
-    ESP_LOGE(TAG, "WS broadcast: malloc %u B failed", (unsigned)len);
+}
+
+static void ws_event_done_cb(esp_err_t err, int fd, void *arg) {
+  (void)err;
+  (void)fd;
+  ws_event_frame_unref((ws_event_frame_t *)arg);
+}
+
+void ws_broadcast_event(const char *json, size_t len) {
+  httpd_handle_t hd = web_server_get_httpd_handle();
+  if (hd == NULL || !web_server_is_active() || json == NULL || len == 0) {
     return;
   }
-  memcpy(payload, snapshot_buffer, len);
-  httpd_ws_frame_t ws_pkt = {.type = HTTPD_WS_TYPE_TEXT,
-                             .payload = payload,
-                             .len = len};
-  size_t n = WS_MAX_CLIENT_FDS;
   int fds[WS_MAX_CLIENT_FDS];
-  if (httpd_get_client_list(web_server_get_httpd_handle(), &n, fds) != ESP_OK) {
-    free(payload);
+  size_t n = ws_push_collect_clients(fds, WS_MAX_CLIENT_FDS);
+  if (n == 0) {
     return;
   }
-  size_t ws_count = 0;
+  ws_event_frame_t *f = malloc(sizeof(*f) + len);
+  if (f == NULL) {
+    return;
+  }
+  f->refs = 1;
+  f->len = len;
+  memcpy(f->json, json, len);
   for (size_t i = 0; i < n; i++) {
-    if (httpd_ws_get_fd_info(web_server_get_httpd_handle(), fds[i]) !=
-        HTTPD_WS_CLIENT_WEBSOCKET) {
+    /* Klient, který ještě nestihl snapshot, event nepotřebuje — snapshot ho
+     * stejně předběhne; fronta httpd tak neroste kvůli tiku hodin. */
+    bool busy;
+    taskENTER_CRITICAL(&s_push_mux);
+    ws_push_client_t *c = ws_push_slot(fds[i], false);
+    busy = (c != NULL && c->inflight >= WS_PUSH_MAX_INFLIGHT);
+    taskEXIT_CRITICAL(&s_push_mux);
+    if (busy) {
       continue;
     }
-    ws_count++;
-    (void)web_server_task_wdt_reset_safe();
-    esp_err_t err = httpd_ws_send_data(web_server_get_httpd_handle(), fds[i], &ws_pkt);
-    if (err != ESP_OK) {
-      ESP_LOGD(TAG, "WS send fd %d: %s", fds[i], esp_err_to_name(err));
+    httpd_ws_frame_t pkt = {.type = HTTPD_WS_TYPE_TEXT,
+                            .payload = (uint8_t *)f->json,
+                            .len = f->len,
+                            .final = true};
+    taskENTER_CRITICAL(&s_push_mux);
+    f->refs++;
+    taskEXIT_CRITICAL(&s_push_mux);
+    if (httpd_ws_send_data_async(hd, fds[i], &pkt, ws_event_done_cb, f) !=
+        ESP_OK) {
+      ws_event_frame_unref(f);
     }
   }
-  ESP_LOGD(TAG, "[STAGING] WS broadcast → %u WS client(s), %u B payload",
-           (unsigned)ws_count, (unsigned)len);
-  free(payload);
+  ws_event_frame_unref(f);
 }
 
 static void ws_broadcast_timer_cb(void *arg) {
@@ -183,5 +579,9 @@ void web_ws_shutdown(void) {
     esp_timer_delete(ws_broadcast_timer);
     ws_broadcast_timer = NULL;
   }
+  /* Rozeslané payloady uvolní jejich completion callbacky. */
+  taskENTER_CRITICAL(&s_push_mux);
+  memset(s_push_clients, 0, sizeof(s_push_clients));
+  taskEXIT_CRITICAL(&s_push_mux);
 #endif
 }
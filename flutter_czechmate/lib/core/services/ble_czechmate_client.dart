@@ -9,6 +9,7 @@ import '../constants/app_environment.dart';
 import '../debug/connection_debug_log.dart';
 import '../models/game_snapshot.dart';
 import '../utils/game_snapshot_codec.dart';
+import '../utils/game_snapshot_delta.dart';
 
 /// GATT UUID z `CZECHMATEBLEUUIDs.swift` / `ble_task.c`.
 final Guid czechmateServiceGuid = Guid('A0B40001-9267-4AB6-BDCC-E8336F8A8D9E');
@@ -96,6 +97,8 @@ class BleCzechmateClient {
   /// Zachycení `disconnected` až po dokončení GATT setupu — jinak iOS/SMP často sejme UI dřív než `discoverServices`.
   void Function(Object)? _onDisconnectError;
   final _assembler = _BleChunkAssembler();
+  /// Delty snapshotu (`snapshot_ack` po plném snapshotu) — viz [SnapshotDeltaTracker].
+  final _delta = SnapshotDeltaTracker();
 
   /// Jedna fronta GATT zápisů — méně „prepare queue full“ a méně zahlcení při rychlých hintech.
   Future<void> _cmdWriteTail = Future<void>.value();
@@ -126,6 +129,7 @@ class BleCzechmateClient {
     }
     _device = null;
     _assembler.reset();
+    _delta.reset();
     _cmdWriteTail = Future<void>.value();
   }
 
@@ -266,8 +270,23 @@ class BleCzechmateClient {
           try {
             final complete = _assembler.push(Uint8List.fromList(raw));
             if (complete == null) return;
-            onSnapshot(GameSnapshotCodec.decodeBytes(complete));
+            final r = _delta.accept(
+              GameSnapshotCodec.decodeRawMap(utf8.decode(complete)),
+            );
+            if (r.resync) {
+              unawaited(_writeCmd({'cmd': 'snapshot_ack', 'resync': true})
+                  .catchError((Object _) {}));
+              return;
+            }
+            final ack = r.ackVersion;
+            if (ack != null) {
+              unawaited(_writeCmd({'cmd': 'snapshot_ack', 'state_version': ack})
+                  .catchError((Object _) {}));
+            }
+            final snap = r.snapshot;
+            if (snap != null) onSnapshot(snap);
           } catch (e) {
+            _delta.reset();
             onError(e);
           }
         },
@@ -1,15 +1,21 @@
 import 'dart:async';
+import 'dart:convert';
 import 'dart:typed_data';
 
 import 'package:web_socket_channel/web_socket_channel.dart';
 
 import '../models/game_snapshot.dart';
 import '../utils/game_snapshot_codec.dart';
+import '../utils/game_snapshot_delta.dart';
 
 /// `ws://host` / `wss://host` — `ChessboardWebSocketClient.swift` (JSON = snapshot).
+///
+/// Po plném snapshotu pošle `{"type":"ack","state_version":N}`; deska pak
+/// posílá jen delty (viz [SnapshotDeltaTracker]). Starší firmware ack ignoruje.
 class SnapshotWebSocketClient {
   WebSocketChannel? _channel;
   StreamSubscription<dynamic>? _sub;
+  final _delta = SnapshotDeltaTracker();
 
   static Uri websocketUriFromBase(String baseHttpUrl) {
     final u = Uri.parse(baseHttpUrl.trim());
@@ -39,14 +45,28 @@ class SnapshotWebSocketClient {
       (dynamic data) {
         onMessageReceived?.call();
         try {
+          final String text;
           if (data is String) {
-            onSnapshot(GameSnapshotCodec.decodeRepairingAndNormalizing(data));
+            text = data;
           } else if (data is List<int>) {
-            onSnapshot(GameSnapshotCodec.decodeBytes(data));
+            text = utf8.decode(data);
           } else if (data is Uint8List) {
-            onSnapshot(GameSnapshotCodec.decodeBytes(data));
+            text = utf8.decode(data);
+          } else {
+            return;
           }
+          final r = _delta.accept(GameSnapshotCodec.decodeRawMap(text));
+          if (r.resync) {
+            ch.sink.add(jsonEncode({'type': 'resync'}));
+            return;
+          }
+          if (r.ackVersion != null) {
+            ch.sink.add(jsonEncode({'type': 'ack', 'state_version': r.ackVersion}));
+          }
+          final snap = r.snapshot;
+          if (snap != null) onSnapshot(snap);
         } catch (e) {
+          _delta.reset();
           onError(e);
         }
       },
@@ -77,6 +97,7 @@ class SnapshotWebSocketClient {
   }
 
   void disconnect() {
+    _delta.reset();
     _sub?.cancel();
     _sub = null;
     _channel?.sink.close();
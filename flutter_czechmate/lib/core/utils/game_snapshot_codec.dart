@@ -6,15 +6,23 @@ import 'game_json_repair.dart';
 /// Dekód + normalizace řádků desky — `GameSnapshot+BoardNormalization.swift`.
 class GameSnapshotCodec {
   static GameSnapshot decodeRepairingAndNormalizing(String raw) {
-    final repaired = GameJsonRepair.repairStatusString(raw);
-    final map = jsonDecode(repaired) as Map<String, dynamic>;
-    final snap = GameSnapshot.fromJson(map);
-    return snap.normalizingBoardRowsFromFirmwareExportIfNeeded();
+    return fromMapNormalizing(decodeRawMap(raw));
   }
 
   static GameSnapshot decodeBytes(List<int> bytes) {
     return decodeRepairingAndNormalizing(utf8.decode(bytes));
   }
+
+  /// Surová mapa (snapshot nebo delta) po opravě starého firmware JSON.
+  static Map<String, dynamic> decodeRawMap(String raw) {
+    final repaired = GameJsonRepair.repairStatusString(raw);
+    return jsonDecode(repaired) as Map<String, dynamic>;
+  }
+
+  static GameSnapshot fromMapNormalizing(Map<String, dynamic> map) {
+    return GameSnapshot.fromJson(map)
+        .normalizingBoardRowsFromFirmwareExportIfNeeded();
+  }
 }
 
 extension GameSnapshotBoardNormalization on GameSnapshot {
@@ -0,0 +1,111 @@
+import '../models/game_snapshot.dart';
+import 'game_snapshot_codec.dart';
+
+/// Výsledek [SnapshotDeltaTracker.accept].
+class SnapshotDeltaResult {
+  const SnapshotDeltaResult({this.snapshot, this.ackVersion, this.resync = false});
+
+  /// Nový stav (plný snapshot nebo delta aplikovaná na poslední stav).
+  final GameSnapshot? snapshot;
+
+  /// Po plném snapshotu — poslat desce ack, aby dál posílala jen delty.
+  final int? ackVersion;
+
+  /// Delta nenavazuje na držený stav — vyžádat plný snapshot.
+  final bool resync;
+}
+
+/// Skládá delta zprávy z firmware (`web_snapshot_delta.c`) na poslední plný
+/// snapshot. Drží surovou mapu ve firmware orientaci; normalizace řádků až
+/// při převodu na [GameSnapshot].
+///
+/// Delta: `{"type":"delta","base":N,"state_version":M,"board":[[idx,"P"]],
+/// "history":{"from":K,"moves":[…]},"status":{…},"clock":{…},"captured":{…},
+/// "replace":["status"]}` — klíče sekcí se mergují, sekce v `replace` nahrazují.
+class SnapshotDeltaTracker {
+  Map<String, dynamic>? _raw;
+
+  static const _sections = ['status', 'clock', 'captured'];
+  static const _deltaMeta = {'type', 'base', 'state_version', 'board', 'history', 'replace'};
+
+  int? get stateVersion => (_raw?['state_version'] as num?)?.toInt();
+
+  void reset() => _raw = null;
+
+  SnapshotDeltaResult accept(Map<String, dynamic> msg) {
+    if (msg['type'] != 'delta') {
+      _raw = msg;
+      return SnapshotDeltaResult(
+        snapshot: GameSnapshotCodec.fromMapNormalizing(msg),
+        ackVersion: (msg['state_version'] as num?)?.toInt(),
+      );
+    }
+    final raw = _raw;
+    final base = (msg['base'] as num?)?.toInt();
+    if (raw == null || base == null || base != stateVersion) {
+      return const SnapshotDeltaResult(resync: true);
+    }
+    final next = _apply(raw, msg);
+    if (next == null) {
+      _raw = null;
+      return const SnapshotDeltaResult(resync: true);
+    }
+    _raw = next;
+    return SnapshotDeltaResult(snapshot: GameSnapshotCodec.fromMapNormalizing(next));
+  }
+
+  static Map<String, dynamic>? _apply(
+    Map<String, dynamic> raw,
+    Map<String, dynamic> delta,
+  ) {
+    final out = Map<String, dynamic>.from(raw);
+    out['state_version'] = delta['state_version'];
+
+    final squares = delta['board'];
+    if (squares is List) {
+      final rows = (raw['board'] as List<dynamic>? ?? const [])
+          .map((r) => List<dynamic>.from(r as List))
+          .toList();
+      for (final sq in squares) {
+        if (sq is! List || sq.length != 2) return null;
+        final idx = (sq[0] as num).toInt();
+        if (idx < 0 || idx >= 64 || rows.length != 8 || rows[idx ~/ 8].length != 8) {
+          return null;
+        }
+        rows[idx ~/ 8][idx % 8] = sq[1];
+      }
+      out['board'] = rows;
+    }
+
+    final history = delta['history'];
+    if (history is Map) {
+      final from = (history['from'] as num?)?.toInt() ?? 0;
+      final prev = ((raw['history'] as Map?)?['moves'] as List<dynamic>?) ?? const [];
+      if (from > prev.length) return null;
+      out['history'] = {
+        ...Map<String, dynamic>.from(raw['history'] as Map? ?? const {}),
+        'moves': [...prev.take(from), ...(history['moves'] as List<dynamic>? ?? const [])],
+      };
+    }
+
+    final replace = (delta['replace'] as List<dynamic>? ?? const []).toSet();
+    for (final sec in _sections) {
+      final patch = delta[sec];
+      if (patch is! Map) continue;
+      if (replace.contains(sec)) {
+        out[sec] = Map<String, dynamic>.from(patch);
+      } else {
+        out[sec] = {
+          ...Map<String, dynamic>.from(raw[sec] as Map? ?? const {}),
+          ...Map<String, dynamic>.from(patch),
+        };
+      }
+    }
+
+    for (final e in delta.entries) {
+      if (_deltaMeta.contains(e.key) || _sections.contains(e.key)) continue;
+      out[e.key] = e.value;
+    }
+    return out;
+  }
+}
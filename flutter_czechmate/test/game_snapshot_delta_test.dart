@@ -0,0 +1,74 @@
+import 'package:czechmate/core/utils/game_snapshot_delta.dart';
+import 'package:flutter_test/flutter_test.dart';
+
+Map<String, dynamic> _full() => {
+      'state_version': 4,
+      'board': List.generate(8, (r) => List.generate(8, (c) => ' ')),
+      'timestamp': 100,
+      'status': {'game_state': 'active', 'current_player': 'White', 'move_count': 1},
+      'history': {
+        'moves': [
+          {'from': 'e2', 'to': 'e4', 'piece': 'P', 'timestamp': 1},
+        ],
+      },
+      'captured': {'white_captured': <String>[], 'black_captured': <String>[]},
+      'clock': {'white_time_ms': 60000, 'black_time_ms': 60000},
+    };
+
+void main() {
+  test('full snapshot is acked, delta merges squares, plies and keys', () {
+    final t = SnapshotDeltaTracker();
+    final first = t.accept(_full());
+    expect(first.ackVersion, 4);
+    expect(first.snapshot, isNotNull);
+
+    final r = t.accept({
+      'type': 'delta',
+      'base': 4,
+      'state_version': 5,
+      'timestamp': 120,
+      'board': [
+        [52, ' '],
+        [36, 'p'],
+      ],
+      'history': {
+        'from': 1,
+        'moves': [
+          {'from': 'e7', 'to': 'e5', 'piece': 'p', 'timestamp': 2},
+        ],
+      },
+      'status': {'current_player': 'Black', 'move_count': 2},
+      'clock': {'black_time_ms': 59000},
+    });
+    expect(r.resync, isFalse);
+    expect(r.ackVersion, isNull);
+    final snap = r.snapshot!;
+    expect(snap.stateVersion, 5);
+    expect(snap.history.moves.length, 2);
+    expect(snap.history.moves.last.to, 'e5');
+    expect(snap.status.currentPlayer, 'Black');
+    expect(t.stateVersion, 5);
+  });
+
+  test('delta with unknown base asks for resync', () {
+    final t = SnapshotDeltaTracker();
+    expect(t.accept({'type': 'delta', 'base': 3, 'state_version': 4}).resync, isTrue);
+    t.accept(_full());
+    expect(t.accept({'type': 'delta', 'base': 2, 'state_version': 5}).resync, isTrue);
+  });
+
+  test('replace swaps a whole section and history truncates', () {
+    final t = SnapshotDeltaTracker()..accept(_full());
+    final r = t.accept({
+      'type': 'delta',
+      'base': 4,
+      'state_version': 6,
+      'history': {'from': 0, 'moves': <dynamic>[]},
+      'status': {'game_state': 'idle'},
+      'replace': ['status'],
+    });
+    final snap = r.snapshot!;
+    expect(snap.history.moves, isEmpty);
+    expect(snap.status.gameState, 'idle');
+  });
+}
@@ -9,18 +9,19 @@
  *
  * @details
  * Tento soubor spousti app_main(), vytvori FreeRTOS fronty a mutexy, nastavi
- * WDT a spusti systemove tasky (LED, matrix, button, game, UART, web, test).
+ * WDT a spusti systemove tasky (LED, matrix, game, UART, web). Tlacitka, lampa
+ * (HA light) a testy bezi jako joby jednoho service tasku (svc_loop.h).
  * Animation task je vypnuty (LED animace v led_task). Po kratsim cekani probiha
  * centralizovana boot animace; nasleduje initialize_chess_game(), ktere
  * respektuje obnovu ulozene hry z NVS v game_task.
  *
  * @subsection ss_queues Fronty
  * - game_command_queue: prikazy pro game_task (UART, matrix, web).
- * - button_event_queue: udalosti z tlacitek (ISR -> button_task).
+ * - button_event_queue: udalosti z tlacitek (ISR -> button job).
  *
  * @subsection ss_priorities Priority (orientacne)
- * led_task (7) > matrix_task (6) > button_task (5) > game_task (4) >
- * uart / web (3) > test_task (1) > IDLE (0).
+ * led_task (7) > matrix_task (6) > game_task (4) >
+ * uart / web / svc_task (3) > persist (2) > IDLE (0).
  *
  * @subsection ss_boot_nvs Boot a NVS
  * game_task_start() drive nez skonci boot animace: inicializuje desku, pripadne
@@ -53,13 +54,18 @@
 #include "freertos/task.h"
 #include "freertos/timers.h"
 #include "freertos_chess.h"
+#include "game_payload.h"
 #include "game_task.h"
 #include "led_task.h"
 #include "matrix_task.h"
+#include "asset_store.h"
 #include "board_api_auth.h"
+#include "config_persist.h"
+#include "config_registry.h"
 #include "esp_ota_ops.h"
 #include "nvs_flash.h"
 #include "stm32_i2c_bl.h"
+#include "svc_loop.h"
 #if CONFIG_CHESS_ENABLE_TEST_TASK
 #include "test_task.h"
 #endif
@@ -302,21 +308,15 @@ SemaphoreHandle_t uart_mutex = NULL;
 TaskHandle_t led_task_handle = NULL;
 /** @brief Handle pro Matrix task */
 TaskHandle_t matrix_task_handle = NULL;
-/** @brief Handle pro Button task */
-TaskHandle_t button_task_handle = NULL;
 /** @brief Handle pro UART task */
 TaskHandle_t uart_task_handle = NULL;
 /** @brief Handle pro Game task */
 TaskHandle_t game_task_handle = NULL;
 /** @brief Handle pro Animation task (NULL pokud je task vypnuty v create_system_tasks) */
 TaskHandle_t animation_task_handle = NULL;
-/** @brief Handle pro Test task */
-TaskHandle_t test_task_handle = NULL;
 // TaskHandle_t matter_task_handle = NULL;  // DISABLED - Matter not needed
 /** @brief Handle pro Web Server task */
 TaskHandle_t web_server_task_handle = NULL;
-/** @brief Handle pro HA Light task */
-TaskHandle_t ha_light_task_handle = NULL;
 /** @brief Handle pro Reset Button task */
 TaskHandle_t reset_button_task_handle = NULL;
 /** @brief Handle pro Promotion Button task */
@@ -696,6 +696,9 @@ void execute_demo_move(void) {
            DEMO_GAME_NAMES[current_demo_game], demo_move_index + 1,
            demo_moves_count, move);
 
+  // Demo odpovedi nikdo necte; at nedrzi payload sloty (texty odpovedi)
+  game_response_drain(uart_response_queue);
+
   // Use PICKUP/DROP commands for realistic demo (like up/dn)
   if (strlen(move) == 4 && game_command_queue != NULL) {
     chess_move_command_t cmd = {0};
@@ -763,6 +766,7 @@ void execute_demo_move(void) {
     }
 
     if (is_castling) {
+      game_response_drain(uart_response_queue);
       ESP_LOGI(TAG, "  ♜ Castling detected! Moving rook %s -> %s", rook_from,
                rook_to);
       vTaskDelay(pdMS_TO_TICKS(500)); // Pause before moving rook
@@ -822,6 +826,7 @@ void execute_demo_move(void) {
       // Set response queue so game_task sends confirmation (like UART
       // commands).
       cmd.response_queue = uart_response_queue;
+      game_response_drain(uart_response_queue);
 
       xQueueSend(game_command_queue, &cmd, pdMS_TO_TICKS(100));
 
@@ -889,12 +894,14 @@ static void init_console(void) {
  *
  * @details
  * Funkce vytvori hlavni tasky:
+ * - Oddil assets: mmap read-only assetu (asset_store.h), pred web/game taskem
+ * - Konfigurace v RAM: jednou z NVS, tasky ctou bez flash (config_registry.h)
+ * - Persist task: zapisy do NVS / flash na pozadi (config_persist.h)
  * - LED task: ovladani LED pasku
  * - Matrix task: skenovani 8x8 matice
- * - Button task: ovladani tlacitek
+ * - Service task (svc_loop.h): joby tlacitek, lampy a testu
  * - UART task: komunikace pres UART
  * - Game task: logika sachove hry
- * - Test task: testovani systemu (volitelne menuconfig)
  * - Web server task: web rozhrani
  * (Animation task vypnut — viz DISABLED blok v create_system_tasks.)
  *
@@ -904,6 +911,22 @@ static void init_console(void) {
 esp_err_t create_system_tasks(void) {
   ESP_LOGI(TAG, "Creating system tasks...");
 
+#if CONFIG_CHESS_ASSETS_PARTITION
+  // Assety (PNG, katalog) z oddilu assets; bez platneho obrazu jen varovani.
+  if (asset_store_init() != ESP_OK) {
+    ESP_LOGW(TAG, "Asset partition not available - /static/* returns 404");
+  }
+#endif
+
+  // Konfigurace jednou z NVS do RAM — LED, game i web task pak ctou z ni.
+  config_registry_init();
+
+  // Persist task pred vsemi, kdo uklada (game_task, web, UART, lampa).
+  // Pri selhani se zapisuje synchronne jako drive.
+  if (config_persist_start() != ESP_OK) {
+    ESP_LOGW(TAG, "Persist task not started - NVS writes stay synchronous");
+  }
+
   // Create LED task
   BaseType_t result = xTaskCreate((TaskFunction_t)led_task_start, "led_task",
                                   LED_TASK_STACK_SIZE, NULL, LED_TASK_PRIORITY,
@@ -953,21 +976,21 @@ esp_err_t create_system_tasks(void) {
            "animace");
 #endif
 
-  // Create Button task
-  result = xTaskCreate((TaskFunction_t)button_task_start, "button_task",
-                       BUTTON_TASK_STACK_SIZE, NULL, BUTTON_TASK_PRIORITY,
-                       &button_task_handle);
-
-  if (result != pdPASS) {
-    ESP_LOGE(TAG, "Failed to create Button task");
+  // Button job — prvni job vytvori service task (svc_loop.h), ten se sam
+  // registruje u TWDT. Tlacitka, lampa a testy sdili jeho stack.
+  if (button_task_register_job() != ESP_OK) {
+    ESP_LOGE(TAG, "Failed to register Button job");
     return ESP_FAIL;
   }
 
-  // Task will register itself with TWDT internally
-  ESP_LOGI(TAG,
-           "✓ Button task created successfully (%dKB stack) - will "
-           "self-register with TWDT",
-           BUTTON_TASK_STACK_SIZE / 1024);
+  ESP_LOGI(TAG, "✓ Button job registered (service task, %dKB shared stack)",
+           SVC_TASK_STACK_SIZE / 1024);
+
+  // Config retry job — zapis konfigurace odmitnuty plnou persist frontou
+  if (config_registry_register_job() != ESP_OK) {
+    ESP_LOGW(TAG, "Failed to register config retry job (dirty config is "
+                  "saved on the next change only)");
+  }
 
   // Create UART task (but suspend it until after boot animation)
   result = xTaskCreate((TaskFunction_t)uart_task_start, "uart_task",
@@ -1025,19 +1048,12 @@ esp_err_t create_system_tasks(void) {
            "unified_animation_manager)");
 
 #if CONFIG_CHESS_ENABLE_TEST_TASK
-  result = xTaskCreate((TaskFunction_t)test_task_start, "test_task",
-                       TEST_TASK_STACK_SIZE, NULL, TEST_TASK_PRIORITY,
-                       &test_task_handle);
-
-  if (result != pdPASS) {
-    ESP_LOGE(TAG, "Failed to create Test task");
+  if (test_task_register_job() != ESP_OK) {
+    ESP_LOGE(TAG, "Failed to register Test job");
     return ESP_FAIL;
   }
 
-  ESP_LOGI(TAG,
-           "✓ Test task created successfully (%dKB stack) - will self-register "
-           "with TWDT",
-           TEST_TASK_STACK_SIZE / 1024);
+  ESP_LOGI(TAG, "✓ Test job registered (service task)");
 #else
   ESP_LOGI(
       TAG,
@@ -1087,21 +1103,13 @@ esp_err_t create_system_tasks(void) {
            "self-register with TWDT",
            WEB_SERVER_TASK_STACK_SIZE / 1024);
 
-  // Create HA Light task (starts after WiFi STA is connected)
-  result = xTaskCreate((TaskFunction_t)ha_light_task_start, "ha_light_task",
-                       HA_LIGHT_TASK_STACK_SIZE, NULL, HA_LIGHT_TASK_PRIORITY,
-                       &ha_light_task_handle);
-
-  if (result != pdPASS) {
-    ESP_LOGE(TAG, "Failed to create HA Light task");
+  // HA Light job (MQTT az po pripojeni WiFi STA)
+  if (ha_light_start() != ESP_OK) {
+    ESP_LOGE(TAG, "Failed to register HA Light job");
     return ESP_FAIL;
   }
 
-  // Task will register itself with TWDT internally
-  ESP_LOGI(TAG,
-           "✓ HA Light task created successfully (%dKB stack) - will "
-           "self-register with TWDT",
-           HA_LIGHT_TASK_STACK_SIZE / 1024);
+  ESP_LOGI(TAG, "✓ HA Light job registered (service task)");
 
   ESP_LOGI(TAG, "All system tasks created successfully");
 
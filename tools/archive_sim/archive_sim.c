@@ -0,0 +1,201 @@
+/**
+ * @file archive_sim.c
+ * @brief Host test pocitadla cekajicich jobu archivu (game_archive.c)
+ *
+ * game_archive.c bezi beze zmeny proti falesne persist fronte: submit job
+ * bud zaradi, nebo (plna fronta) odmitne s ESP_ERR_NO_MEM; pred startem
+ * tasku ho provede hned. Cekajici SAVE/DELETE jsou videt podle toho, zda
+ * game_archive_load() vola config_persist_flush (read-your-writes) —
+ * odmitnuty job nesmi zustat "cekajici" navzdy.
+ *
+ * Pouziti:
+ * @code
+ * archive_sim --selftest
+ * @endcode
+ */
+
+#include "config_persist.h"
+#include "esp_littlefs.h"
+#include "esp_log.h"
+#include "esp_rom_crc.h"
+#include "freertos/semphr.h"
+#include "game_archive.h"
+#include "game_task_internal.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ============================================================================
+// STAV GAME TASKU (jinak game_task.c)
+// ============================================================================
+
+piece_t board[8][8];
+game_state_t current_game_state = GAME_STATE_ACTIVE;
+player_t current_player = PLAYER_WHITE;
+uint32_t move_count;
+bool game_active = true;
+bool white_king_moved, white_rook_a_moved, white_rook_h_moved;
+bool black_king_moved, black_rook_a_moved, black_rook_h_moved;
+bool en_passant_available;
+uint8_t en_passant_target_row, en_passant_target_col;
+uint8_t en_passant_victim_row, en_passant_victim_col;
+game_task_promotion_state_t promotion_state;
+chess_move_t move_history[GAME_TASK_MAX_MOVES_HISTORY];
+move_type_t move_history_kind[GAME_TASK_MAX_MOVES_HISTORY];
+uint32_t history_index;
+uint32_t white_time_total, black_time_total;
+uint32_t white_moves_count, black_moves_count;
+game_state_t game_result;
+game_result_type_t current_result_type;
+piece_t white_captured_pieces[GAME_TASK_MAX_CAPTURED_PIECES];
+piece_t black_captured_pieces[GAME_TASK_MAX_CAPTURED_PIECES];
+uint32_t white_captured_count, black_captured_count;
+uint32_t white_captured_index, black_captured_index;
+uint32_t white_captures, black_captures;
+uint32_t moves_without_capture;
+uint32_t position_history_count;
+bool has_last_move;
+uint8_t last_move_from_row, last_move_from_col;
+uint8_t last_move_to_row, last_move_to_col;
+bool piece_lifted;
+piece_t lifted_piece;
+bool game_saved;
+char saved_game_name[32];
+
+// ============================================================================
+// SHIM: LITTLEFS, CRC
+// ============================================================================
+
+/* Mount uspeje, soubory pod /storage na hostu neexistuji — zapis jobu
+ * selze, coz pocitadlu nevadi (archive_job ho snizi v kazdem pripade). */
+esp_err_t esp_vfs_littlefs_register(const esp_vfs_littlefs_conf_t *conf) {
+  return ESP_OK;
+}
+
+esp_err_t esp_littlefs_info(const char *label, size_t *total, size_t *used) {
+  *total = 0;
+  *used = 0;
+  return ESP_OK;
+}
+
+uint32_t esp_rom_crc32_le(uint32_t crc, const uint8_t *buf, uint32_t len) {
+  crc = ~crc;
+  for (uint32_t i = 0; i < len; i++) {
+    crc ^= buf[i];
+    for (int b = 0; b < 8; b++) {
+      crc = (crc >> 1) ^ (0xEDB88320U & (0U - (crc & 1U)));
+    }
+  }
+  return ~crc;
+}
+
+// ============================================================================
+// FALESNA PERSIST FRONTA
+// ============================================================================
+
+#define SIM_QUEUE_MAX 4
+
+typedef struct {
+  config_persist_write_fn fn;
+  char key[CONFIG_PERSIST_KEY_MAX];
+  void *data;
+  size_t len;
+} sim_job_t;
+
+static bool s_running;    ///< Persist task bezi (jinak synchronni zapis)
+static bool s_full;       ///< Submit vrati ESP_ERR_NO_MEM jako plna fronta
+static uint32_t s_flushes; ///< Volani config_persist_flush
+static sim_job_t s_queue[SIM_QUEUE_MAX];
+static uint32_t s_queued;
+
+bool config_persist_is_running(void) { return s_running; }
+
+esp_err_t config_persist_submit(const char *key, config_persist_write_fn fn,
+                                const void *data, size_t len,
+                                config_persist_prio_t prio,
+                                config_persist_future_t *future) {
+  if (!s_running) {
+    return fn(key, data, len);
+  }
+  if (s_full || s_queued == SIM_QUEUE_MAX) {
+    return ESP_ERR_NO_MEM;
+  }
+  sim_job_t *j = &s_queue[s_queued++];
+  j->fn = fn;
+  snprintf(j->key, sizeof(j->key), "%s", key);
+  j->data = malloc(len);
+  memcpy(j->data, data, len);
+  j->len = len;
+  return ESP_OK;
+}
+
+/** Provede zarazene joby jako persist task. */
+esp_err_t config_persist_flush(uint32_t timeout_ms) {
+  s_flushes++;
+  for (uint32_t i = 0; i < s_queued; i++) {
+    (void)s_queue[i].fn(s_queue[i].key, s_queue[i].data, s_queue[i].len);
+    free(s_queue[i].data);
+  }
+  s_queued = 0;
+  return ESP_OK;
+}
+
+// ============================================================================
+// TEST
+// ============================================================================
+
+/** LOAD vola flush prave kdyz archiv eviduje cekajici job. */
+static bool sim_archive_pending(void) {
+  uint32_t before = s_flushes;
+  (void)game_archive_load("probe");
+  return s_flushes != before;
+}
+
+static int sim_expect(bool ok, const char *what) {
+  if (!ok) {
+    printf("FAIL: %s\n", what);
+    return 1;
+  }
+  return 0;
+}
+
+static int sim_selftest(void) {
+  int f = 0;
+  game_archive_init();
+
+  /* 1) Plna fronta: SAVE odmitnut, nic necekajiciho nezbyde */
+  s_running = true;
+  s_full = true;
+  f += sim_expect(game_archive_save_current("full", NULL) == ESP_ERR_NO_MEM,
+                  "full queue: save returns ESP_ERR_NO_MEM");
+  f += sim_expect(!sim_archive_pending(), "full queue: nothing pending");
+
+  /* 2) Zarazeny SAVE + odmitnuty SAVE: zarazeny dal ceka, po flush nic */
+  s_full = false;
+  f += sim_expect(game_archive_save_current("queued", NULL) == ESP_OK,
+                  "queued save accepted");
+  s_full = true;
+  f += sim_expect(game_archive_save_current("dropped", NULL) == ESP_ERR_NO_MEM,
+                  "second save rejected");
+  f += sim_expect(sim_archive_pending(), "queued save still pending");
+  f += sim_expect(!sim_archive_pending(), "nothing pending after flush");
+
+  /* 3) Pred startem tasku: synchronni zapis pocitadlo vrati sam */
+  s_running = false;
+  s_full = false;
+  (void)game_archive_save_current("sync", NULL);
+  f += sim_expect(!sim_archive_pending(), "sync write: nothing pending");
+
+  printf("selftest: %d failures\n", f);
+  return f;
+}
+
+int main(int argc, char **argv) {
+  if (argc >= 2 && strcmp(argv[1], "--selftest") == 0) {
+    host_log_level = 1; /* jen chyby */
+    return sim_selftest() == 0 ? 0 : 1;
+  }
+  fprintf(stderr, "usage: archive_sim --selftest\n");
+  return 2;
+}
@@ -0,0 +1,23 @@
+/**
+ * @file esp_littlefs.h
+ * @brief Host shim LittleFS pro tools/archive_sim (mount vzdy uspeje)
+ */
+
+#ifndef ARCHIVE_SIM_SHIM_ESP_LITTLEFS_H
+#define ARCHIVE_SIM_SHIM_ESP_LITTLEFS_H
+
+#include "esp_err.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef struct {
+  const char *base_path;
+  const char *partition_label;
+  bool format_if_mount_failed;
+  bool dont_mount;
+} esp_vfs_littlefs_conf_t;
+
+esp_err_t esp_vfs_littlefs_register(const esp_vfs_littlefs_conf_t *conf);
+esp_err_t esp_littlefs_info(const char *label, size_t *total, size_t *used);
+
+#endif // ARCHIVE_SIM_SHIM_ESP_LITTLEFS_H
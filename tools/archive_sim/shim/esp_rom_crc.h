@@ -0,0 +1,13 @@
+/**
+ * @file esp_rom_crc.h
+ * @brief Host shim ROM CRC32 pro tools/archive_sim (Linux build)
+ */
+
+#ifndef ARCHIVE_SIM_SHIM_ESP_ROM_CRC_H
+#define ARCHIVE_SIM_SHIM_ESP_ROM_CRC_H
+
+#include <stdint.h>
+
+uint32_t esp_rom_crc32_le(uint32_t crc, const uint8_t *buf, uint32_t len);
+
+#endif // ARCHIVE_SIM_SHIM_ESP_ROM_CRC_H
@@ -0,0 +1,223 @@
+/**
+ * @file journal_sim.c
+ * @brief Host test journalu tahu (components/game_task/game_journal.c)
+ *
+ * Oddil `journal` je pole v RAM (shim esp_partition.h). Test volá stejné
+ * API jako game_snapshot.c — checkpoint = close_epoch + begin_epoch, mezi
+ * nimi delty — a hlídá, že ring rotuje: hlavička nové epochy jde za poslední
+ * záznam, sektor se maže až když se do něj přejde a opotřebení je rovnoměrné.
+ *
+ * Pouziti:
+ * @code
+ * journal_sim --selftest [N]   # N checkpointu s deltami + N bez delt
+ * @endcode
+ */
+
+#include "esp_partition.h"
+#include "esp_rom_crc.h"
+#include "game_journal.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SIM_SECTOR_SIZE 4096U
+#define SIM_SECTORS 4U
+#define SIM_DELTAS_PER_EPOCH 8U
+#define SIM_DELTA_LEN 100U
+
+// ============================================================================
+// SHIM: ODDIL V RAM
+// ============================================================================
+
+static uint8_t s_flash[SIM_SECTORS * SIM_SECTOR_SIZE];
+static uint32_t s_erases[SIM_SECTORS];
+static uint32_t s_header_writes;
+static uint32_t s_last_header_off;
+static const esp_partition_t s_part = {.size = sizeof(s_flash),
+                                       .erase_size = SIM_SECTOR_SIZE,
+                                       .label = GAME_JOURNAL_PARTITION_LABEL};
+
+const char *esp_err_to_name(esp_err_t code) {
+  return code == ESP_OK ? "ESP_OK" : "ESP_ERR";
+}
+
+uint32_t esp_rom_crc32_le(uint32_t crc, const uint8_t *buf, uint32_t len) {
+  crc = ~crc;
+  for (uint32_t i = 0; i < len; i++) {
+    crc ^= buf[i];
+    for (int b = 0; b < 8; b++) {
+      crc = (crc >> 1) ^ (0xEDB88320U & (0U - (crc & 1U)));
+    }
+  }
+  return ~crc;
+}
+
+const esp_partition_t *esp_partition_find_first(esp_partition_type_t type,
+                                                esp_partition_subtype_t subtype,
+                                                const char *label) {
+  (void)type;
+  (void)subtype;
+  return strcmp(label, s_part.label) == 0 ? &s_part : NULL;
+}
+
+esp_err_t esp_partition_read(const esp_partition_t *part, size_t off,
+                             void *dst, size_t len) {
+  if (off + len > part->size) {
+    return ESP_ERR_INVALID_SIZE;
+  }
+  memcpy(dst, s_flash + off, len);
+  return ESP_OK;
+}
+
+esp_err_t esp_partition_write(const esp_partition_t *part, size_t off,
+                              const void *src, size_t len) {
+  if (off + len > part->size) {
+    return ESP_ERR_INVALID_SIZE;
+  }
+  const uint8_t *p = src;
+  for (size_t i = 0; i < len; i++) {
+    if ((s_flash[off + i] & p[i]) != p[i]) {
+      fprintf(stderr, "FAIL: write @0x%zx to non-erased byte\n", off + i);
+      exit(1);
+    }
+    s_flash[off + i] &= p[i];
+  }
+  /* Hlavicka epochy: magic 0x4A, type 1 (viz game_journal.c) */
+  if (len >= 2 && p[0] == 0x4A && p[1] == 1) {
+    s_header_writes++;
+    s_last_header_off = (uint32_t)off;
+  }
+  return ESP_OK;
+}
+
+esp_err_t esp_partition_erase_range(const esp_partition_t *part, size_t off,
+                                    size_t len) {
+  if (off % part->erase_size != 0 || len % part->erase_size != 0 ||
+      off + len > part->size) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  memset(s_flash + off, 0xFF, len);
+  for (size_t s = off / part->erase_size; s < (off + len) / part->erase_size;
+       s++) {
+    s_erases[s]++;
+  }
+  return ESP_OK;
+}
+
+// ============================================================================
+// TEST
+// ============================================================================
+
+static uint32_t sim_total_erases(void) {
+  uint32_t n = 0;
+  for (uint32_t s = 0; s < SIM_SECTORS; s++) {
+    n += s_erases[s];
+  }
+  return n;
+}
+
+/** Jeden checkpoint jako game_snapshot_checkpoint(); vrati sektor hlavicky. */
+static int sim_checkpoint(uint32_t crc, uint32_t *sector_out) {
+  uint32_t before = s_header_writes;
+  game_journal_close_epoch();
+  if (game_journal_begin_epoch(crc) != ESP_OK ||
+      s_header_writes != before + 1) {
+    printf("FAIL: begin_epoch #%" PRIu32 "\n", crc);
+    return 1;
+  }
+  *sector_out = s_last_header_off / SIM_SECTOR_SIZE;
+  return 0;
+}
+
+static int sim_selftest(uint32_t checkpoints) {
+  memset(s_flash, 0xFF, sizeof(s_flash));
+  if (!game_journal_available()) {
+    printf("FAIL: journal not available\n");
+    return 1;
+  }
+
+  int failures = 0;
+  uint8_t delta[SIM_DELTA_LEN];
+  uint32_t prev_sector = 0;
+  uint32_t advances = 0;
+
+  /* 1) Checkpoint s deltami (jako kazdych N tahu): hlavicka vzdy ve stejnem
+   *    nebo nasledujicim sektoru, ring projde cely oddil mnohokrat. */
+  for (uint32_t i = 1; i <= checkpoints; i++) {
+    uint32_t sector;
+    if (sim_checkpoint(i, &sector) != 0) {
+      return 1;
+    }
+    if (i > 1 && sector != prev_sector) {
+      if (sector != (prev_sector + 1) % SIM_SECTORS) {
+        printf("FAIL: header jumped sector %" PRIu32 " -> %" PRIu32 "\n",
+               prev_sector, sector);
+        failures++;
+      }
+      advances++;
+    }
+    prev_sector = sector;
+    for (uint32_t d = 0; d < SIM_DELTAS_PER_EPOCH; d++) {
+      memset(delta, (int)(i + d), sizeof(delta));
+      if (game_journal_append(delta, sizeof(delta)) != ESP_OK) {
+        printf("FAIL: append epoch %" PRIu32 " delta %" PRIu32 "\n", i, d);
+        failures++;
+      }
+    }
+  }
+  /* Epocha = hlavicka 16 B + 8 × 112 B → cca 4 epochy na sektor */
+  uint32_t min_advances = checkpoints / 5;
+  if (advances < min_advances) {
+    printf("FAIL: header sector advanced %" PRIu32 "× (expected >= %" PRIu32
+           ")\n",
+           advances, min_advances);
+    failures++;
+  }
+  uint32_t min_e = UINT32_MAX, max_e = 0;
+  for (uint32_t s = 0; s < SIM_SECTORS; s++) {
+    min_e = s_erases[s] < min_e ? s_erases[s] : min_e;
+    max_e = s_erases[s] > max_e ? s_erases[s] : max_e;
+  }
+  if (max_e - min_e > 1) {
+    printf("FAIL: uneven wear, erases per sector %" PRIu32 "..%" PRIu32 "\n",
+           min_e, max_e);
+    failures++;
+  }
+  printf("with deltas: %" PRIu32 " checkpoints, %" PRIu32
+         " sector advances, erases/sector %" PRIu32 "..%" PRIu32 "\n",
+         checkpoints, advances, min_e, max_e);
+
+  /* 2) Checkpointy bez delt (nova hra, undo): 16 B hlavicky se skladaji za
+   *    sebe, sektor se nemaze pri kazdem checkpointu. */
+  uint32_t erases_before = sim_total_erases();
+  for (uint32_t i = 1; i <= checkpoints; i++) {
+    uint32_t sector;
+    if (sim_checkpoint(checkpoints + i, &sector) != 0) {
+      return 1;
+    }
+  }
+  uint32_t erases = sim_total_erases() - erases_before;
+  uint32_t max_erases = checkpoints * 16U / SIM_SECTOR_SIZE + 1U;
+  if (erases > max_erases) {
+    printf("FAIL: %" PRIu32 " bare checkpoints erased %" PRIu32
+           " sectors (expected <= %" PRIu32 ")\n",
+           checkpoints, erases, max_erases);
+    failures++;
+  }
+  printf("bare: %" PRIu32 " checkpoints, %" PRIu32 " erases\n", checkpoints,
+         erases);
+
+  printf("selftest: %d failures\n", failures);
+  return failures == 0 ? 0 : 1;
+}
+
+int main(int argc, char **argv) {
+  if (argc >= 2 && strcmp(argv[1], "--selftest") == 0) {
+    int n = argc > 2 ? atoi(argv[2]) : 200;
+    return sim_selftest(n > 1 ? (uint32_t)n : 200U);
+  }
+  fprintf(stderr, "usage: journal_sim --selftest [N]\n");
+  return 2;
+}
@@ -0,0 +1,22 @@
+/**
+ * @file esp_err.h
+ * @brief Host shim ESP-IDF chybovych kodu pro tools/journal_sim (Linux build)
+ */
+
+#ifndef JOURNAL_SIM_SHIM_ESP_ERR_H
+#define JOURNAL_SIM_SHIM_ESP_ERR_H
+
+typedef int esp_err_t;
+
+#define ESP_OK 0
+#define ESP_FAIL -1
+#define ESP_ERR_NO_MEM 0x101
+#define ESP_ERR_INVALID_ARG 0x102
+#define ESP_ERR_INVALID_STATE 0x103
+#define ESP_ERR_INVALID_SIZE 0x104
+#define ESP_ERR_NOT_FOUND 0x105
+#define ESP_ERR_NOT_SUPPORTED 0x106
+
+const char *esp_err_to_name(esp_err_t code);
+
+#endif // JOURNAL_SIM_SHIM_ESP_ERR_H
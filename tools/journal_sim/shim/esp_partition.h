@@ -0,0 +1,36 @@
+/**
+ * @file esp_partition.h
+ * @brief Host shim esp_partition pro tools/journal_sim — oddil v RAM
+ *
+ * Zapis se chova jako NOR flash (bity jen 1 -> 0), erase po celych
+ * sektorech. Shim pocita erase na sektor a zapisy hlavicek epoch.
+ */
+
+#ifndef JOURNAL_SIM_SHIM_ESP_PARTITION_H
+#define JOURNAL_SIM_SHIM_ESP_PARTITION_H
+
+#include "esp_err.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef enum { ESP_PARTITION_TYPE_DATA = 0x01 } esp_partition_type_t;
+typedef enum { ESP_PARTITION_SUBTYPE_ANY = 0xff } esp_partition_subtype_t;
+
+typedef struct {
+  uint32_t size;
+  uint32_t erase_size;
+  const char *label;
+} esp_partition_t;
+
+const esp_partition_t *esp_partition_find_first(esp_partition_type_t type,
+                                                esp_partition_subtype_t subtype,
+                                                const char *label);
+esp_err_t esp_partition_read(const esp_partition_t *part, size_t off,
+                             void *dst, size_t len);
+esp_err_t esp_partition_write(const esp_partition_t *part, size_t off,
+                              const void *src, size_t len);
+esp_err_t esp_partition_erase_range(const esp_partition_t *part, size_t off,
+                                    size_t len);
+
+#endif // JOURNAL_SIM_SHIM_ESP_PARTITION_H
@@ -0,0 +1,405 @@
+/**
+ * @file led_sim.c
+ * @brief Host LED simulator - vykresleni animaci bez hardwaru
+ *
+ * Preklada components/led_task/led_frames.c na Linuxu a prehrava
+ * scenare (sach, rosada, promoce, endgame vlna, navadeni) do pametoveho
+ * framebufferu 8x8 + 9 tlacitek.
+ *
+ * Pouziti:
+ * @code
+ * led_sim --ansi [scenar]          # snimky do terminalu (truecolor)
+ * led_sim --png DIR [scenar]       # DIR/<scenar>_<snimek>.png
+ * led_sim --record FILE            # zapis referencnich hashu snimku
+ * led_sim --check FILE             # porovnani s referenci (exit 1 = rozdil)
+ * led_sim --bench [N]              # N iteraci vsech scenaru, us/snimek
+ * @endcode
+ *
+ * @author Alfred Krutina
+ * @version 1.8.0
+ * @date 2026-10-18
+ */
+
+#include "led_frames.h"
+#include "led_mapping.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// ============================================================================
+// SCENARE
+// ============================================================================
+
+#define SIM_MAX_FRAMES 64
+
+typedef struct {
+  const char *name;
+  int (*render)(led_frame_t *out, int max_frames);
+} sim_scenario_t;
+
+/** Mat: bily kral g1, cerny kral h8, bila dama g7 (piece_t kody) */
+static void sim_board_mate(uint8_t board[64]) {
+  memset(board, 0, 64);
+  board[0 * 8 + 6] = 6;  // bily kral g1
+  board[6 * 8 + 6] = 5;  // bila dama g7
+  board[5 * 8 + 5] = 1;  // bily pesec f6
+  board[7 * 8 + 7] = 12; // cerny kral h8
+  board[6 * 8 + 0] = 7;  // cerny pesec a7
+}
+
+static int sim_render_check(led_frame_t *out, int max_frames) {
+  led_frame_clear(&out[0]);
+  led_frame_render_check(&out[0], chess_notation_to_led_index("e8"));
+  return 1;
+}
+
+static int sim_render_castle(led_frame_t *out, int max_frames) {
+  uint8_t king_from = chess_notation_to_led_index("e1");
+  int n = 0;
+  // Kingside e1->g1 (king_to = king_from + 2 jako v led_anim_castle)
+  for (int i = 0; i < LED_FRAME_CASTLE_TOTAL_FRAMES && n < max_frames; i++) {
+    led_frame_clear(&out[n]);
+    led_frame_render_castle(&out[n++], king_from, king_from + 2, i);
+  }
+  // Queenside e8->c8
+  uint8_t king_from_b = chess_notation_to_led_index("e8");
+  for (int i = 0; i < LED_FRAME_CASTLE_TOTAL_FRAMES && n < max_frames; i++) {
+    led_frame_clear(&out[n]);
+    led_frame_render_castle(&out[n++], king_from_b, king_from_b - 2, i);
+  }
+  return n;
+}
+
+static int sim_render_promotion(led_frame_t *out, int max_frames) {
+  // Update frekvence manageru ~30 Hz, vzorek kazdych 250 ms
+  uint8_t led = chess_notation_to_led_index("d8");
+  int n = 0;
+  for (uint32_t ms = 0; ms <= LED_FRAME_PROMOTION_DURATION_MS && n < max_frames;
+       ms += 250) {
+    led_frame_clear(&out[n]);
+    led_frame_render_promotion(&out[n++], led, ms, ms / 33);
+  }
+  return n;
+}
+
+static int sim_render_endgame(led_frame_t *out, int max_frames) {
+  uint8_t board[64];
+  sim_board_mate(board);
+  uint8_t king_led = chess_notation_to_led_index("g1");
+  int n = 0;
+  for (uint8_t r = 1; r <= LED_FRAME_ENDGAME_MAX_RADIUS && n < max_frames;
+       r++) {
+    led_frame_clear(&out[n]);
+    led_frame_render_endgame_wave(&out[n++], board, king_led, r);
+  }
+  return n;
+}
+
+static int sim_render_guidance(led_frame_t *out, int max_frames) {
+  const uint8_t leds[] = {chess_notation_to_led_index("e2"),
+                          chess_notation_to_led_index("e3"),
+                          chess_notation_to_led_index("e4")};
+  int n = 0;
+  for (int step = 0; step <= 8 && n < max_frames; step++) {
+    led_frame_clear(&out[n]);
+    led_frame_render_guidance(&out[n++], leds, 3, step / 8.0f);
+  }
+  return n;
+}
+
+static const sim_scenario_t scenarios[] = {
+    {"check", sim_render_check},         {"castle", sim_render_castle},
+    {"promotion", sim_render_promotion}, {"endgame", sim_render_endgame},
+    {"guidance", sim_render_guidance},
+};
+#define SIM_SCENARIO_COUNT (sizeof(scenarios) / sizeof(scenarios[0]))
+
+// ============================================================================
+// VYSTUPY
+// ============================================================================
+
+/** FNV-1a 64 pres vsechny LED snimku (stabilni reference) */
+static uint64_t sim_frame_hash(const led_frame_t *f) {
+  uint64_t h = 1469598103934665603ULL;
+  for (int i = 0; i < LED_FRAME_LED_COUNT; i++) {
+    for (int s = 16; s >= 0; s -= 8) {
+      h ^= (f->px[i] >> s) & 0xFF;
+      h *= 1099511628211ULL;
+    }
+  }
+  return h;
+}
+
+static void sim_print_ansi(const char *name, int idx, const led_frame_t *f) {
+  printf("%s #%d\n", name, idx);
+  for (int row = 7; row >= 0; row--) {
+    printf("%d ", row + 1);
+    for (int col = 0; col < 8; col++) {
+      uint32_t c = f->px[chess_pos_to_led_index(row, col)];
+      printf("\x1b[48;2;%u;%u;%um  \x1b[0m", (unsigned)((c >> 16) & 0xFF),
+             (unsigned)((c >> 8) & 0xFF), (unsigned)(c & 0xFF));
+    }
+    printf("\n");
+  }
+  printf("  a b c d e f g h\n  ");
+  for (int b = 0; b < LED_FRAME_BUTTON_COUNT; b++) {
+    uint32_t c = f->px[LED_FRAME_BOARD_COUNT + b];
+    printf("\x1b[48;2;%u;%u;%um  \x1b[0m", (unsigned)((c >> 16) & 0xFF),
+           (unsigned)((c >> 8) & 0xFF), (unsigned)(c & 0xFF));
+  }
+  printf("\n\n");
+}
+
+// --- Minimalni PNG zapis (deflate "stored" bloky, bez zlib) ---
+
+static uint32_t sim_crc_table[256];
+
+static void sim_crc_init(void) {
+  for (uint32_t n = 0; n < 256; n++) {
+    uint32_t c = n;
+    for (int k = 0; k < 8; k++)
+      c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+    sim_crc_table[n] = c;
+  }
+}
+
+static uint32_t sim_crc(uint32_t crc, const uint8_t *p, size_t n) {
+  crc ^= 0xFFFFFFFFu;
+  while (n--)
+    crc = sim_crc_table[(crc ^ *p++) & 0xFF] ^ (crc >> 8);
+  return crc ^ 0xFFFFFFFFu;
+}
+
+static void sim_put_be32(uint8_t *p, uint32_t v) {
+  p[0] = v >> 24; p[1] = v >> 16; p[2] = v >> 8; p[3] = v;
+}
+
+static void sim_png_chunk(FILE *fp, const char *type, const uint8_t *data,
+                          uint32_t len) {
+  uint8_t hdr[8];
+  sim_put_be32(hdr, len);
+  memcpy(hdr + 4, type, 4);
+  fwrite(hdr, 1, 8, fp);
+  if (len)
+    fwrite(data, 1, len, fp);
+  uint32_t crc = sim_crc(0, hdr + 4, 4);
+  crc = sim_crc(crc, data, len); // sim_crc umi navazat na finalni CRC
+  uint8_t c[4];
+  sim_put_be32(c, crc);
+  fwrite(c, 1, 4, fp);
+}
+
+#define SIM_CELL 16
+#define SIM_W (LED_FRAME_BUTTON_COUNT * SIM_CELL)
+#define SIM_H (10 * SIM_CELL) // 8 radku desky + mezera + tlacitka
+
+static int sim_write_png(const char *path, const led_frame_t *f) {
+  static uint8_t raw[SIM_H * (1 + SIM_W * 3)];
+  size_t stride = 1 + SIM_W * 3;
+  memset(raw, 0x20, sizeof(raw));
+  for (int y = 0; y < SIM_H; y++) {
+    raw[y * stride] = 0; // filtr "none"
+    for (int x = 0; x < SIM_W; x++) {
+      int cy = y / SIM_CELL, cx = x / SIM_CELL;
+      int led = -1;
+      if (cy < 8 && cx < 8)
+        led = chess_pos_to_led_index(7 - cy, cx);
+      else if (cy == 9)
+        led = LED_FRAME_BOARD_COUNT + cx;
+      // 1px mrizka mezi bunkami
+      if (led < 0 || x % SIM_CELL == 0 || y % SIM_CELL == 0)
+        continue;
+      uint32_t c = f->px[led];
+      uint8_t *p = &raw[y * stride + 1 + x * 3];
+      p[0] = c >> 16; p[1] = c >> 8; p[2] = c;
+    }
+  }
+
+  // zlib stream: hlavicka + stored bloky + adler32
+  size_t raw_len = sizeof(raw);
+  size_t blocks = (raw_len + 65534) / 65535;
+  size_t z_len = 2 + raw_len + blocks * 5 + 4;
+  uint8_t *z = malloc(z_len);
+  if (!z)
+    return -1;
+  size_t o = 0;
+  z[o++] = 0x78; z[o++] = 0x01;
+  uint32_t a = 1, b = 0;
+  for (size_t pos = 0; pos < raw_len;) {
+    size_t n = raw_len - pos > 65535 ? 65535 : raw_len - pos;
+    z[o++] = (pos + n == raw_len) ? 1 : 0;
+    z[o++] = n & 0xFF; z[o++] = n >> 8;
+    z[o++] = ~n & 0xFF; z[o++] = (~n >> 8) & 0xFF;
+    memcpy(z + o, raw + pos, n);
+    for (size_t i = 0; i < n; i++) {
+      a = (a + raw[pos + i]) % 65521;
+      b = (b + a) % 65521;
+    }
+    o += n;
+    pos += n;
+  }
+  sim_put_be32(z + o, (b << 16) | a);
+  o += 4;
+
+  FILE *fp = fopen(path, "wb");
+  if (!fp) {
+    free(z);
+    return -1;
+  }
+  static const uint8_t sig[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+  fwrite(sig, 1, 8, fp);
+  uint8_t ihdr[13] = {0};
+  sim_put_be32(ihdr, SIM_W);
+  sim_put_be32(ihdr + 4, SIM_H);
+  ihdr[8] = 8; // bit depth
+  ihdr[9] = 2; // RGB
+  sim_png_chunk(fp, "IHDR", ihdr, sizeof(ihdr));
+  sim_png_chunk(fp, "IDAT", z, (uint32_t)o);
+  sim_png_chunk(fp, "IEND", NULL, 0);
+  fclose(fp);
+  free(z);
+  return 0;
+}
+
+// ============================================================================
+// REZIMY
+// ============================================================================
+
+static const sim_scenario_t *sim_find(const char *name) {
+  for (size_t i = 0; i < SIM_SCENARIO_COUNT; i++)
+    if (!name || strcmp(scenarios[i].name, name) == 0)
+      return &scenarios[i];
+  return NULL;
+}
+
+static int sim_dump(const char *only, const char *png_dir) {
+  static led_frame_t frames[SIM_MAX_FRAMES];
+  for (size_t s = 0; s < SIM_SCENARIO_COUNT; s++) {
+    if (only && strcmp(scenarios[s].name, only) != 0)
+      continue;
+    int n = scenarios[s].render(frames, SIM_MAX_FRAMES);
+    for (int i = 0; i < n; i++) {
+      if (png_dir) {
+        char path[512];
+        snprintf(path, sizeof(path), "%s/%s_%02d.png", png_dir,
+                 scenarios[s].name, i);
+        if (sim_write_png(path, &frames[i]) != 0) {
+          fprintf(stderr, "cannot write %s\n", path);
+          return 1;
+        }
+      } else {
+        sim_print_ansi(scenarios[s].name, i, &frames[i]);
+      }
+    }
+  }
+  return 0;
+}
+
+static int sim_record(const char *path) {
+  static led_frame_t frames[SIM_MAX_FRAMES];
+  FILE *fp = fopen(path, "w");
+  if (!fp) {
+    fprintf(stderr, "cannot open %s\n", path);
+    return 1;
+  }
+  fprintf(fp, "# led_sim golden frames: <scenario> <frame> <fnv1a64>\n");
+  for (size_t s = 0; s < SIM_SCENARIO_COUNT; s++) {
+    int n = scenarios[s].render(frames, SIM_MAX_FRAMES);
+    for (int i = 0; i < n; i++)
+      fprintf(fp, "%s %d %016" PRIx64 "\n", scenarios[s].name, i,
+              sim_frame_hash(&frames[i]));
+  }
+  fclose(fp);
+  return 0;
+}
+
+static int sim_check(const char *path) {
+  static led_frame_t frames[SIM_MAX_FRAMES];
+  FILE *fp = fopen(path, "r");
+  if (!fp) {
+    fprintf(stderr, "cannot open %s\n", path);
+    return 1;
+  }
+  char line[160];
+  int checked = 0, failed = 0;
+  const sim_scenario_t *cached = NULL;
+  int cached_n = 0;
+  while (fgets(line, sizeof(line), fp)) {
+    char name[32];
+    int idx;
+    uint64_t expected;
+    if (line[0] == '#' ||
+        sscanf(line, "%31s %d %" SCNx64, name, &idx, &expected) != 3)
+      continue;
+    const sim_scenario_t *sc = sim_find(name);
+    if (!sc) {
+      printf("FAIL %s: unknown scenario\n", name);
+      failed++;
+      continue;
+    }
+    if (sc != cached) {
+      cached_n = sc->render(frames, SIM_MAX_FRAMES);
+      cached = sc;
+    }
+    checked++;
+    if (idx >= cached_n) {
+      printf("FAIL %s #%d: frame missing (have %d)\n", name, idx, cached_n);
+      failed++;
+    } else if (sim_frame_hash(&frames[idx]) != expected) {
+      printf("FAIL %s #%d: %016" PRIx64 " != %016" PRIx64 "\n", name, idx,
+             sim_frame_hash(&frames[idx]), expected);
+      failed++;
+    }
+  }
+  fclose(fp);
+  printf("%d frames checked, %d failed\n", checked, failed);
+  return (failed || checked == 0) ? 1 : 0;
+}
+
+static int sim_bench(int iterations) {
+  static led_frame_t frames[SIM_MAX_FRAMES];
+  for (size_t s = 0; s < SIM_SCENARIO_COUNT; s++) {
+    struct timespec t0, t1;
+    long total_frames = 0;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (int it = 0; it < iterations; it++)
+      total_frames += scenarios[s].render(frames, SIM_MAX_FRAMES);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    double us = (t1.tv_sec - t0.tv_sec) * 1e6 + (t1.tv_nsec - t0.tv_nsec) / 1e3;
+    printf("%-10s %8ld frames  %8.3f us/frame\n", scenarios[s].name,
+           total_frames, total_frames ? us / total_frames : 0.0);
+  }
+  return 0;
+}
+
+static void sim_usage(void) {
+  fprintf(stderr, "usage: led_sim --ansi [scenario] | --png DIR [scenario] |"
+                  " --record FILE | --check FILE | --bench [N]\n");
+  fprintf(stderr, "scenarios:");
+  for (size_t i = 0; i < SIM_SCENARIO_COUNT; i++)
+    fprintf(stderr, " %s", scenarios[i].name);
+  fprintf(stderr, "\n");
+}
+
+int main(int argc, char **argv) {
+  sim_crc_init();
+  if (argc < 2) {
+    sim_usage();
+    return 2;
+  }
+  if (strcmp(argv[1], "--ansi") == 0)
+    return sim_dump(argc > 2 ? argv[2] : NULL, NULL);
+  if (strcmp(argv[1], "--png") == 0 && argc > 2)
+    return sim_dump(argc > 3 ? argv[3] : NULL, argv[2]);
+  if (strcmp(argv[1], "--record") == 0 && argc > 2)
+    return sim_record(argv[2]);
+  if (strcmp(argv[1], "--check") == 0 && argc > 2)
+    return sim_check(argv[2]);
+  if (strcmp(argv[1], "--bench") == 0)
+    return sim_bench(argc > 2 ? atoi(argv[2]) : 10000);
+  sim_usage();
+  return 2;
+}
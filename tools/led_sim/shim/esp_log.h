@@ -0,0 +1,16 @@
+/**
+ * @file esp_log.h
+ * @brief Host shim ESP-IDF logovani pro tools/led_sim (Linux build)
+ */
+
+#ifndef LED_SIM_SHIM_ESP_LOG_H
+#define LED_SIM_SHIM_ESP_LOG_H
+
+#include <stdio.h>
+
+#define ESP_LOGE(tag, fmt, ...) fprintf(stderr, "E %s: " fmt "\n", tag, ##__VA_ARGS__)
+#define ESP_LOGW(tag, fmt, ...) fprintf(stderr, "W %s: " fmt "\n", tag, ##__VA_ARGS__)
+#define ESP_LOGI(tag, fmt, ...) ((void)(tag))
+#define ESP_LOGD(tag, fmt, ...) ((void)(tag))
+
+#endif // LED_SIM_SHIM_ESP_LOG_H
@@ -0,0 +1,263 @@
+/**
+ * @file move_batch_sim.c
+ * @brief Host test davky tahu (game_execute_move_batch) nad skutecnymi hodinami
+ *
+ * game_move_exec.c a timer_system.c bezi beze zmeny; zbytek game tasku
+ * (validace, LED, snapshot, udalosti) nahrazuji stuby nize. Test hlida, ze
+ * rosada uvnitr davky neprepina hodiny: neuspesna davka je necha presne
+ * jak byly, uspesna je prepne jednou (jeden increment) az pri commitu.
+ *
+ * Pouziti:
+ * @code
+ * move_batch_sim --selftest
+ * @endcode
+ */
+
+#include "config_persist.h"
+#include "game_move_exec.h"
+#include "game_task.h"
+#include "game_task_internal.h"
+#include "timer_system.h"
+
+#include "esp_log.h"
+#include "freertos/semphr.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ============================================================================
+// STAV GAME TASKU (jinak game_task.c)
+// ============================================================================
+
+piece_t board[8][8];
+bool piece_moved[8][8];
+game_state_t current_game_state = GAME_STATE_ACTIVE;
+player_t current_player = PLAYER_WHITE;
+uint32_t move_count;
+bool game_active = true;
+bool white_king_moved, white_rook_a_moved, white_rook_h_moved;
+bool black_king_moved, black_rook_a_moved, black_rook_h_moved;
+bool en_passant_available;
+uint8_t en_passant_target_row, en_passant_target_col;
+uint8_t en_passant_victim_row, en_passant_victim_col;
+game_task_promotion_state_t promotion_state;
+chess_move_t move_history[GAME_TASK_MAX_MOVES_HISTORY];
+move_type_t move_history_kind[GAME_TASK_MAX_MOVES_HISTORY];
+uint32_t history_index;
+uint32_t last_move_time;
+uint32_t white_moves_count, black_moves_count;
+uint32_t white_castles, black_castles;
+game_state_t game_result;
+game_result_type_t current_result_type;
+endgame_reason_t current_endgame_reason;
+uint32_t white_checks, black_checks;
+uint32_t white_captured_count, black_captured_count;
+uint32_t white_captured_index, black_captured_index;
+uint32_t white_captures, black_captures;
+bool endgame_report_requested;
+uint32_t advantage_history_count;
+uint32_t moves_without_capture, max_moves_without_capture;
+uint32_t total_games, white_wins, black_wins, draws;
+uint32_t position_history_count;
+last_move_type_t last_move_type;
+game_task_error_recovery_t error_recovery_state;
+SemaphoreHandle_t promotion_mutex;
+bool s_uart_move_immediate_promotion;
+promotion_choice_t s_uart_move_immediate_promotion_piece;
+castling_state_t castling_state;
+bool has_last_move;
+uint8_t last_move_from_row, last_move_from_col;
+uint8_t last_move_to_row, last_move_to_col;
+
+// ============================================================================
+// STUBY
+// ============================================================================
+
+static bool sim_is_white(piece_t p) {
+  return p >= PIECE_WHITE_PAWN && p <= PIECE_WHITE_KING;
+}
+
+/** Jen barva a obsazeni — pravidla tahu tu netestujeme. */
+move_error_t game_is_valid_move(const chess_move_t *move) {
+  piece_t p = board[move->from_row][move->from_col];
+  if (p == PIECE_EMPTY) {
+    return MOVE_ERROR_NO_PIECE;
+  }
+  if (sim_is_white(p) != (current_player == PLAYER_WHITE)) {
+    return MOVE_ERROR_WRONG_COLOR;
+  }
+  return MOVE_ERROR_NONE;
+}
+
+piece_t game_get_piece(int row, int col) { return board[row][col]; }
+bool game_is_white_piece(piece_t piece) { return sim_is_white(piece); }
+bool game_is_king_in_check(player_t player) { return false; }
+uint32_t game_generate_legal_moves(player_t player) { return 20; }
+bool game_is_en_passant_possible(const chess_move_t *move) { return false; }
+game_state_t game_check_end_game_conditions(void) { return GAME_STATE_ACTIVE; }
+bool game_is_matrix_guard_active(void) { return false; }
+const char *game_get_piece_name(piece_t piece) { return "piece"; }
+char piece_to_char(piece_t piece) { return '?'; }
+void game_add_captured_piece(piece_t piece) {}
+void game_record_material_advantage(void) {}
+void game_update_endgame_statistics(game_result_type_t result) {}
+void game_print_endgame_report_uart(game_result_type_t result) {}
+void game_check_promotion_needed(void) {}
+void game_trigger_victory_animation(player_t winner) {}
+void game_snapshot_persist_after_valid_move(void) {}
+void game_emit_event(game_event_t *ev) {}
+void game_emit_simple_event(game_event_type_t type) {}
+void game_refresh_leds(void) {}
+esp_err_t game_task_wdt_reset_safe(void) { return ESP_OK; }
+bool game_led_guidance_show_check_anim(void) { return false; }
+void chess_policy_highlight_movable_if_enabled(void) {}
+uint8_t chess_pos_to_led_index(uint8_t row, uint8_t col) {
+  return (uint8_t)(row * 8 + col);
+}
+void led_clear_board_only(void) {}
+void led_set_pixel_safe(uint8_t led_index, uint8_t r, uint8_t g, uint8_t b) {}
+void led_execute_command_new(const led_command_t *cmd) {}
+
+/** Host nema persist task — nastaveni hodin se neuklada. */
+esp_err_t config_persist_submit(const char *key, config_persist_write_fn fn,
+                                const void *data, size_t len,
+                                config_persist_prio_t prio,
+                                config_persist_future_t *future) {
+  return ESP_OK;
+}
+
+// ============================================================================
+// TEST
+// ============================================================================
+
+#define SQ(file, rank) ((uint8_t)(((rank) - 1) * 8 + ((file) - 'a')))
+#define MV(f1, r1, f2, r2) GAME_MOVE_BATCH_PACK(SQ(f1, r1), SQ(f2, r2), 0)
+
+/** Bily: Ke1, Rh1, Pa2; cerny: Ke8, Pa7; bily na tahu, hodiny bezi bilemu. */
+static void sim_setup(void) {
+  memset(board, 0, sizeof(board));
+  memset(piece_moved, 0, sizeof(piece_moved));
+  board[0][4] = PIECE_WHITE_KING;
+  board[0][7] = PIECE_WHITE_ROOK;
+  board[1][0] = PIECE_WHITE_PAWN;
+  board[7][4] = PIECE_BLACK_KING;
+  board[6][0] = PIECE_BLACK_PAWN;
+  current_player = PLAYER_WHITE;
+  current_game_state = GAME_STATE_ACTIVE;
+  game_active = true;
+  castling_state.in_progress = false;
+  white_king_moved = white_rook_h_moved = false;
+  move_count = history_index = 0;
+
+  time_control_config_t tc;
+  timer_get_config_by_type(TIME_CONTROL_BLITZ_3_2, &tc);
+  timer_set_time_control(&tc);
+  game_start_timer_move(true);
+}
+
+/** Zbyvajici casy jako na displeji (strane na tahu ubiha bezici tah). */
+typedef struct {
+  uint32_t white_ms, black_ms, total_moves;
+  bool white_turn, running;
+} sim_clock_t;
+
+static sim_clock_t sim_clock(void) {
+  chess_timer_t t;
+  timer_get_state(&t);
+  sim_clock_t c = {.white_ms = timer_get_remaining_time(true),
+                   .black_ms = timer_get_remaining_time(false),
+                   .total_moves = t.total_moves,
+                   .white_turn = t.is_white_turn,
+                   .running = t.timer_running};
+  return c;
+}
+
+static int sim_expect(bool ok, const char *what) {
+  if (!ok) {
+    printf("FAIL: %s\n", what);
+    return 1;
+  }
+  return 0;
+}
+
+/** Davka s rosadou, ktera selze: hodiny i deska beze zmeny. */
+static int sim_failed_batch(void) {
+  sim_setup();
+  sim_clock_t before = sim_clock();
+  const uint16_t moves[] = {MV('e', 1, 'g', 1), MV('e', 3, 'e', 4)};
+  game_move_batch_result_t res;
+  move_error_t err = game_execute_move_batch(moves, 2, &res);
+  sim_clock_t after = sim_clock();
+
+  int f = 0;
+  f += sim_expect(err == MOVE_ERROR_NO_PIECE, "failed batch: error code");
+  f += sim_expect(res.failed_index == 1, "failed batch: failed_index");
+  f += sim_expect(board[0][4] == PIECE_WHITE_KING &&
+                      board[0][7] == PIECE_WHITE_ROOK &&
+                      current_player == PLAYER_WHITE,
+                  "failed batch: board and side restored");
+  f += sim_expect(after.white_turn && after.running,
+                  "failed batch: clock still runs for white");
+  f += sim_expect(after.total_moves == before.total_moves,
+                  "failed batch: no move ended on the clock");
+  f += sim_expect(after.black_ms == before.black_ms,
+                  "failed batch: black time unchanged");
+  /* Bily tah bezi dal: cas jen ubyva o prave ubehlou dobu, zadny increment */
+  f += sim_expect(after.white_ms <= before.white_ms &&
+                      before.white_ms - after.white_ms < 1000,
+                  "failed batch: white time unchanged");
+  printf("failed batch: white %" PRIu32 " -> %" PRIu32 " ms, black %" PRIu32
+         " -> %" PRIu32 " ms, side %s\n",
+         before.white_ms, after.white_ms, before.black_ms, after.black_ms,
+         after.white_turn ? "white" : "black");
+  return f;
+}
+
+/** Uspesna davka s rosadou: jeden konec tahu, jeden increment bilemu. */
+static int sim_castling_batch(void) {
+  sim_setup();
+  sim_clock_t before = sim_clock();
+  const uint16_t moves[] = {MV('e', 1, 'g', 1)};
+  game_move_batch_result_t res;
+  move_error_t err = game_execute_move_batch(moves, 1, &res);
+  sim_clock_t after = sim_clock();
+
+  int f = 0;
+  f += sim_expect(err == MOVE_ERROR_NONE && res.applied == 1,
+                  "castling batch: applied");
+  f += sim_expect(board[0][6] == PIECE_WHITE_KING &&
+                      board[0][5] == PIECE_WHITE_ROOK &&
+                      current_player == PLAYER_BLACK,
+                  "castling batch: castled, black to move");
+  f += sim_expect(!after.white_turn && after.running,
+                  "castling batch: clock runs for black");
+  f += sim_expect(after.total_moves == before.total_moves + 1,
+                  "castling batch: exactly one move ended on the clock");
+  f += sim_expect(after.white_ms <= before.white_ms + 2000 &&
+                      after.white_ms + 1000 > before.white_ms + 2000,
+                  "castling batch: white got one increment");
+  /* Cerny tah prave zacal: jen ubehla doba, zadny increment */
+  f += sim_expect(after.black_ms <= before.black_ms &&
+                      before.black_ms - after.black_ms < 1000,
+                  "castling batch: black time unchanged");
+  printf("castling batch: white %" PRIu32 " -> %" PRIu32 " ms, black %" PRIu32
+         " -> %" PRIu32 " ms, side %s\n",
+         before.white_ms, after.white_ms, before.black_ms, after.black_ms,
+         after.white_turn ? "white" : "black");
+  return f;
+}
+
+int main(int argc, char **argv) {
+  if (argc >= 2 && strcmp(argv[1], "--selftest") == 0) {
+    host_log_level = 1; /* jen chyby */
+    promotion_mutex = xSemaphoreCreateRecursiveMutex();
+    timer_system_init();
+    int failures = sim_failed_batch() + sim_castling_batch();
+    printf("selftest: %d failures\n", failures);
+    return failures == 0 ? 0 : 1;
+  }
+  fprintf(stderr, "usage: move_batch_sim --selftest\n");
+  return 2;
+}
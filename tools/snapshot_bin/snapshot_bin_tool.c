@@ -0,0 +1,295 @@
+/**
+ * @file snapshot_bin_tool.c
+ * @brief Host round-trip test a dekoder binarniho snapshotu
+ *
+ * Preklada components/game_task/snapshot_bin.c na Linuxu.
+ *
+ * Pouziti:
+ * @code
+ * snapshot_bin --selftest [N]      # N nahodnych stavu encode/decode + poskozena data
+ * snapshot_bin --sizes             # velikost startovni pozice, BLE konce, plne historie
+ * snapshot_bin --dump FILE         # dekoduje binarni snapshot (napr. curl -H Accept:...)
+ * @endcode
+ *
+ * @author Alfred Krutina
+ * @version 1.8.0
+ * @date 2026-10-18
+ */
+
+#include "snapshot_bin.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char k_piece_chars[] = " PNBRQKpnbrqk???";
+
+// ============================================================================
+// GENERATOR STAVU
+// ============================================================================
+
+static uint32_t s_rng = 0x12345678U;
+
+static uint32_t sim_rand(void) {
+  s_rng ^= s_rng << 13;
+  s_rng ^= s_rng >> 17;
+  s_rng ^= s_rng << 5;
+  return s_rng;
+}
+
+static void sim_start_position(snapshot_bin_state_t *st) {
+  static const uint8_t back_w[8] = {4, 2, 3, 5, 6, 3, 2, 4};
+  memset(st, 0, sizeof(*st));
+  for (int c = 0; c < 8; c++) {
+    st->board[c] = back_w[c];
+    st->board[8 + c] = 1;
+    st->board[48 + c] = 7;
+    st->board[56 + c] = (uint8_t)(back_w[c] + 6);
+  }
+  st->state_version = 1;
+  st->timestamp_ms = 12345;
+  st->status_bits = 2; /* GAME_STATE_ACTIVE */
+  st->has_clock = true;
+  st->clock_flags = SNAPSHOT_BIN_CLK_WHITE_TURN;
+  st->clock_type = 6;
+  st->white_time_ms = st->black_time_ms = st->initial_time_ms = 300000;
+}
+
+/** Nahodny (ne nutne legalni) stav vcetne okrajovych hodnot. */
+static void sim_random_state(snapshot_bin_state_t *st) {
+  memset(st, 0, sizeof(*st));
+  st->state_version = sim_rand();
+  st->timestamp_ms = ((uint64_t)sim_rand() << 20) ^ sim_rand();
+  for (int i = 0; i < 64; i++) {
+    st->board[i] = (uint8_t)(sim_rand() % 13);
+  }
+  st->move_total = sim_rand() % (SNAPSHOT_BIN_MAX_MOVES + 1);
+  st->move_n = (uint16_t)(sim_rand() % (st->move_total + 1));
+  st->move_first = st->move_total - st->move_n;
+  uint32_t ts = sim_rand() % 1000000U;
+  for (uint16_t i = 0; i < st->move_n; i++) {
+    snapshot_bin_move_t *m = &st->moves[i];
+    m->from = (uint8_t)(sim_rand() % 64);
+    m->to = (uint8_t)(sim_rand() % 64);
+    m->piece = (uint8_t)(sim_rand() % 13);
+    m->captured = (uint8_t)(sim_rand() % 13);
+    m->kind = (uint8_t)(sim_rand() % 6);
+    /* Obcas zpetny skok (restore z NVS) — zigzag musi projit. */
+    if (sim_rand() % 16 == 0) {
+      ts = sim_rand();
+    } else {
+      ts += sim_rand() % 120000U;
+    }
+    m->timestamp = ts;
+  }
+  st->status_bits = sim_rand() & (SNAPSHOT_BIN_ST_STATE_MASK | 0x7F0U |
+                                  SNAPSHOT_BIN_ST_RESULT_MASK |
+                                  SNAPSHOT_BIN_ST_REASON_MASK);
+  st->move_count = sim_rand() % 500;
+  if (st->status_bits & SNAPSHOT_BIN_ST_PIECE_LIFTED) {
+    st->lifted_sq = (uint8_t)(sim_rand() % 64);
+    st->lifted_piece = (uint8_t)(sim_rand() % 13);
+  }
+  if (st->status_bits & SNAPSHOT_BIN_ST_CASTLING) {
+    st->castling_from = (uint8_t)(sim_rand() % 64);
+    st->castling_to = (uint8_t)(sim_rand() % 64);
+  }
+  st->has_clock = (sim_rand() & 1U) != 0;
+  if (st->has_clock) {
+    st->clock_flags = (uint8_t)(sim_rand() & 0x0FU);
+    st->clock_type = (uint8_t)(sim_rand() % 16);
+    st->white_time_ms = sim_rand();
+    st->black_time_ms = sim_rand() % 600000U;
+    st->initial_time_ms = sim_rand() % 5400000U;
+    st->increment_ms = sim_rand() % 30000U;
+  }
+  st->white_captured_n = (uint8_t)(sim_rand() % (SNAPSHOT_BIN_MAX_CAPTURED + 1));
+  st->black_captured_n = (uint8_t)(sim_rand() % (SNAPSHOT_BIN_MAX_CAPTURED + 1));
+  for (int i = 0; i < st->white_captured_n; i++) {
+    st->white_captured[i] = (uint8_t)(7 + sim_rand() % 6);
+  }
+  for (int i = 0; i < st->black_captured_n; i++) {
+    st->black_captured[i] = (uint8_t)(1 + sim_rand() % 6);
+  }
+}
+
+// ============================================================================
+// PRIKAZY
+// ============================================================================
+
+static int sim_selftest(int iterations) {
+  static snapshot_bin_state_t in, out;
+  static uint8_t buf[SNAPSHOT_BIN_MAX_SIZE];
+  size_t max_len = 0;
+  int bad = 0;
+
+  for (int it = 0; it < iterations; it++) {
+    sim_random_state(&in);
+    size_t len = 0;
+    if (!snapshot_bin_encode(&in, buf, sizeof(buf), &len)) {
+      printf("FAIL #%d: encode\n", it);
+      bad++;
+      continue;
+    }
+    if (len > max_len) {
+      max_len = len;
+    }
+    if (!snapshot_bin_decode(buf, len, &out) ||
+        memcmp(&in, &out, sizeof(in)) != 0) {
+      printf("FAIL #%d: round-trip (%u B)\n", it, (unsigned)len);
+      bad++;
+      continue;
+    }
+    uint32_t ver = 0;
+    if (!snapshot_bin_peek_version(buf, len, &ver) || ver != in.state_version) {
+      printf("FAIL #%d: peek_version\n", it);
+      bad++;
+    }
+    /* Maly buffer musi selhat cistě, ne prepsat pamet. */
+    size_t short_cap = (size_t)(sim_rand() % len);
+    if (snapshot_bin_encode(&in, buf, short_cap, &len) || len != 0) {
+      printf("FAIL #%d: encode into %u B succeeded\n", it, (unsigned)short_cap);
+      bad++;
+    }
+    (void)snapshot_bin_encode(&in, buf, sizeof(buf), &len);
+    /* Oriznuta / poskozena data: dekoder nesmi cist mimo buffer (ASan). */
+    (void)snapshot_bin_decode(buf, (size_t)(sim_rand() % len), &out);
+    buf[sim_rand() % len] ^= (uint8_t)(1U << (sim_rand() % 8));
+    (void)snapshot_bin_decode(buf, len, &out);
+  }
+
+  /* Neznama sekce za daty (novejsi firmware) se preskoci. */
+  size_t len = 0;
+  sim_start_position(&in);
+  (void)snapshot_bin_encode(&in, buf, sizeof(buf), &len);
+  buf[len++] = 0x7E;
+  buf[len++] = 3;
+  buf[len++] = 1;
+  buf[len++] = 2;
+  buf[len++] = 3;
+  if (!snapshot_bin_decode(buf, len, &out) || memcmp(&in, &out, sizeof(in)) != 0) {
+    printf("FAIL: unknown TLV not skipped\n");
+    bad++;
+  }
+
+  printf("selftest: %d iterations, max %u B, %d failures\n", iterations,
+         (unsigned)max_len, bad);
+  return bad ? 1 : 0;
+}
+
+static size_t sim_encoded_size(const snapshot_bin_state_t *st) {
+  static uint8_t buf[SNAPSHOT_BIN_MAX_SIZE];
+  size_t len = 0;
+  return snapshot_bin_encode(st, buf, sizeof(buf), &len) ? len : 0;
+}
+
+static int sim_sizes(void) {
+  static snapshot_bin_state_t st;
+  sim_start_position(&st);
+  printf("start position:        %4u B\n", (unsigned)sim_encoded_size(&st));
+
+  /* Typicka rozehrana partie: tah ~10 s, 4 sebrane figurky na stranu. */
+  st.move_total = SNAPSHOT_BIN_MAX_MOVES;
+  st.move_count = SNAPSHOT_BIN_MAX_MOVES;
+  st.white_captured_n = st.black_captured_n = 4;
+  for (int i = 0; i < 4; i++) {
+    st.white_captured[i] = (uint8_t)(7 + i);
+    st.black_captured[i] = (uint8_t)(1 + i);
+  }
+  for (int i = 0; i < SNAPSHOT_BIN_MAX_MOVES; i++) {
+    snapshot_bin_move_t *m = &st.moves[i];
+    m->from = (uint8_t)(i % 64);
+    m->to = (uint8_t)((i * 7) % 64);
+    m->piece = (uint8_t)(1 + i % 12);
+    m->timestamp = 60000U + (uint32_t)i * 10000U;
+  }
+  st.move_first = SNAPSHOT_BIN_MAX_MOVES - SNAPSHOT_BIN_BLE_MAX_MOVES;
+  st.move_n = SNAPSHOT_BIN_BLE_MAX_MOVES;
+  memmove(st.moves, st.moves + st.move_first,
+          SNAPSHOT_BIN_BLE_MAX_MOVES * sizeof(st.moves[0]));
+  size_t ble = sim_encoded_size(&st);
+  printf("BLE tail (%d moves):   %4u B (limit %d, MTU 247 notify payload 240)\n",
+         SNAPSHOT_BIN_BLE_MAX_MOVES, (unsigned)ble, SNAPSHOT_BIN_BLE_MAX_SIZE);
+
+  for (int i = 0; i < SNAPSHOT_BIN_MAX_MOVES; i++) {
+    st.moves[i].timestamp = 60000U + (uint32_t)i * 10000U;
+  }
+  st.move_first = 0;
+  st.move_n = SNAPSHOT_BIN_MAX_MOVES;
+  printf("full history (%d):    %4u B (limit %d)\n", SNAPSHOT_BIN_MAX_MOVES,
+         (unsigned)sim_encoded_size(&st), SNAPSHOT_BIN_MAX_SIZE);
+  return ble <= 240 ? 0 : 1;
+}
+
+static void sim_square(uint8_t sq, char out[3]) {
+  out[0] = (char)('a' + sq % 8);
+  out[1] = (char)('1' + sq / 8);
+  out[2] = '\0';
+}
+
+static int sim_dump(const char *path) {
+  FILE *f = fopen(path, "rb");
+  if (f == NULL) {
+    perror(path);
+    return 2;
+  }
+  static uint8_t buf[SNAPSHOT_BIN_MAX_SIZE * 2];
+  size_t len = fread(buf, 1, sizeof(buf), f);
+  fclose(f);
+  static snapshot_bin_state_t st;
+  if (!snapshot_bin_decode(buf, len, &st)) {
+    fprintf(stderr, "%s: not a valid snapshot (%u B)\n", path, (unsigned)len);
+    return 1;
+  }
+  printf("state_version %" PRIu32 "  timestamp %" PRIu64 "  (%u B)\n",
+         st.state_version, st.timestamp_ms, (unsigned)len);
+  for (int row = 7; row >= 0; row--) {
+    printf("%d ", row + 1);
+    for (int col = 0; col < 8; col++) {
+      char c = k_piece_chars[st.board[row * 8 + col] & 0x0F];
+      printf(" %c", c == ' ' ? '.' : c);
+    }
+    printf("\n");
+  }
+  printf("   a b c d e f g h\n");
+  printf("status 0x%08" PRIx32 " state=%u %s to move, move_count %" PRIu32 "\n",
+         st.status_bits, (unsigned)(st.status_bits & SNAPSHOT_BIN_ST_STATE_MASK),
+         (st.status_bits & SNAPSHOT_BIN_ST_BLACK_TO_MOVE) ? "black" : "white",
+         st.move_count);
+  if (st.has_clock) {
+    printf("clock type=%u flags=0x%x white %" PRIu32 " ms black %" PRIu32
+           " ms (%" PRIu32 "+%" PRIu32 ")\n",
+           st.clock_type, st.clock_flags, st.white_time_ms, st.black_time_ms,
+           st.initial_time_ms, st.increment_ms);
+  }
+  printf("moves %u..%u of %" PRIu32 ":", (unsigned)st.move_first,
+         (unsigned)(st.move_first + st.move_n), st.move_total);
+  for (uint16_t i = 0; i < st.move_n; i++) {
+    char from[3], to[3];
+    sim_square(st.moves[i].from, from);
+    sim_square(st.moves[i].to, to);
+    printf(" %c%s-%s", k_piece_chars[st.moves[i].piece & 0x0F], from, to);
+  }
+  printf("\n");
+  return 0;
+}
+
+static void sim_usage(void) {
+  fprintf(stderr, "usage: snapshot_bin --selftest [N] | --sizes | --dump FILE\n");
+}
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    sim_usage();
+    return 2;
+  }
+  if (strcmp(argv[1], "--selftest") == 0)
+    return sim_selftest(argc > 2 ? atoi(argv[2]) : 10000);
+  if (strcmp(argv[1], "--sizes") == 0)
+    return sim_sizes();
+  if (strcmp(argv[1], "--dump") == 0 && argc > 2)
+    return sim_dump(argv[2]);
+  sim_usage();
+  return 2;
+}
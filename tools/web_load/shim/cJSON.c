@@ -0,0 +1,359 @@
+/**
+ * @file cJSON.c
+ * @brief Host shim cJSON pro tools/web_load — rekurzivni parser do stromu uzlu
+ */
+
+#include "cJSON.h"
+
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#define CJSON_SHIM_MAX_DEPTH 64
+
+typedef struct {
+  const char *p;
+  const char *end;
+  int depth;
+} parser_t;
+
+static void skip_ws(parser_t *ps) {
+  while (ps->p < ps->end && isspace((unsigned char)*ps->p)) {
+    ps->p++;
+  }
+}
+
+static cJSON *new_item(int type) {
+  cJSON *it = calloc(1, sizeof(*it));
+  if (it != NULL) {
+    it->type = type;
+  }
+  return it;
+}
+
+static void put_utf8(char **o, unsigned cp) {
+  char *d = *o;
+  if (cp < 0x80) {
+    *d++ = (char)cp;
+  } else if (cp < 0x800) {
+    *d++ = (char)(0xC0 | (cp >> 6));
+    *d++ = (char)(0x80 | (cp & 0x3F));
+  } else if (cp < 0x10000) {
+    *d++ = (char)(0xE0 | (cp >> 12));
+    *d++ = (char)(0x80 | ((cp >> 6) & 0x3F));
+    *d++ = (char)(0x80 | (cp & 0x3F));
+  } else {
+    *d++ = (char)(0xF0 | (cp >> 18));
+    *d++ = (char)(0x80 | ((cp >> 12) & 0x3F));
+    *d++ = (char)(0x80 | ((cp >> 6) & 0x3F));
+    *d++ = (char)(0x80 | (cp & 0x3F));
+  }
+  *o = d;
+}
+
+static bool parse_hex4(const char *s, unsigned *out) {
+  unsigned v = 0;
+  for (int i = 0; i < 4; i++) {
+    char c = s[i];
+    v <<= 4;
+    if (c >= '0' && c <= '9') {
+      v |= (unsigned)(c - '0');
+    } else if (c >= 'a' && c <= 'f') {
+      v |= (unsigned)(c - 'a' + 10);
+    } else if (c >= 'A' && c <= 'F') {
+      v |= (unsigned)(c - 'A' + 10);
+    } else {
+      return false;
+    }
+  }
+  *out = v;
+  return true;
+}
+
+/** Retezec od uvozovky; vysledek malloc (UTF-8, escapy rozbalene). */
+static char *parse_string_raw(parser_t *ps) {
+  if (ps->p >= ps->end || *ps->p != '"') {
+    return NULL;
+  }
+  const char *s = ++ps->p;
+  while (ps->p < ps->end && *ps->p != '"') {
+    ps->p += (*ps->p == '\\') ? 2 : 1;
+  }
+  if (ps->p >= ps->end) {
+    return NULL;
+  }
+  size_t n = (size_t)(ps->p - s);
+  ps->p++; /* koncova uvozovka */
+  char *out = malloc(n + 1);
+  if (out == NULL) {
+    return NULL;
+  }
+  char *o = out;
+  for (const char *c = s; c < s + n; c++) {
+    if (*c != '\\') {
+      *o++ = *c;
+      continue;
+    }
+    c++;
+    switch (*c) {
+    case 'b':
+      *o++ = '\b';
+      break;
+    case 'f':
+      *o++ = '\f';
+      break;
+    case 'n':
+      *o++ = '\n';
+      break;
+    case 'r':
+      *o++ = '\r';
+      break;
+    case 't':
+      *o++ = '\t';
+      break;
+    case 'u': {
+      unsigned cp;
+      if (c + 4 >= s + n || !parse_hex4(c + 1, &cp)) {
+        free(out);
+        return NULL;
+      }
+      c += 4;
+      if (cp >= 0xD800 && cp < 0xDC00 && c + 6 < s + n && c[1] == '\\' &&
+          c[2] == 'u') {
+        unsigned lo;
+        if (parse_hex4(c + 3, &lo) && lo >= 0xDC00 && lo < 0xE000) {
+          cp = 0x10000 + ((cp - 0xD800) << 10) + (lo - 0xDC00);
+          c += 6;
+        }
+      }
+      put_utf8(&o, cp);
+      break;
+    }
+    default:
+      *o++ = *c;
+      break;
+    }
+  }
+  *o = '\0';
+  return out;
+}
+
+static cJSON *parse_value(parser_t *ps);
+
+static cJSON *parse_container(parser_t *ps, bool object) {
+  cJSON *item = new_item(object ? cJSON_Object : cJSON_Array);
+  if (item == NULL || ++ps->depth > CJSON_SHIM_MAX_DEPTH) {
+    cJSON_Delete(item);
+    return NULL;
+  }
+  ps->p++; /* { nebo [ */
+  skip_ws(ps);
+  char close = object ? '}' : ']';
+  if (ps->p < ps->end && *ps->p == close) {
+    ps->p++;
+    ps->depth--;
+    return item;
+  }
+  cJSON *last = NULL;
+  for (;;) {
+    char *key = NULL;
+    if (object) {
+      skip_ws(ps);
+      key = parse_string_raw(ps);
+      skip_ws(ps);
+      if (key == NULL || ps->p >= ps->end || *ps->p != ':') {
+        free(key);
+        goto fail;
+      }
+      ps->p++;
+    }
+    cJSON *child = parse_value(ps);
+    if (child == NULL) {
+      free(key);
+      goto fail;
+    }
+    child->string = key;
+    if (last == NULL) {
+      item->child = child;
+    } else {
+      last->next = child;
+      child->prev = last;
+    }
+    last = child;
+    skip_ws(ps);
+    if (ps->p < ps->end && *ps->p == ',') {
+      ps->p++;
+      continue;
+    }
+    if (ps->p < ps->end && *ps->p == close) {
+      ps->p++;
+      ps->depth--;
+      return item;
+    }
+    goto fail;
+  }
+fail:
+  cJSON_Delete(item);
+  return NULL;
+}
+
+static cJSON *parse_value(parser_t *ps) {
+  skip_ws(ps);
+  if (ps->p >= ps->end) {
+    return NULL;
+  }
+  size_t left = (size_t)(ps->end - ps->p);
+  char c = *ps->p;
+  if (c == '{' || c == '[') {
+    return parse_container(ps, c == '{');
+  }
+  if (c == '"') {
+    char *s = parse_string_raw(ps);
+    cJSON *it = s ? new_item(cJSON_String) : NULL;
+    if (it == NULL) {
+      free(s);
+      return NULL;
+    }
+    it->valuestring = s;
+    return it;
+  }
+  if (left >= 4 && strncmp(ps->p, "true", 4) == 0) {
+    ps->p += 4;
+    cJSON *it = new_item(cJSON_True);
+    if (it != NULL) {
+      it->valueint = 1;
+    }
+    return it;
+  }
+  if (left >= 5 && strncmp(ps->p, "false", 5) == 0) {
+    ps->p += 5;
+    return new_item(cJSON_False);
+  }
+  if (left >= 4 && strncmp(ps->p, "null", 4) == 0) {
+    ps->p += 4;
+    return new_item(cJSON_NULL);
+  }
+  if (c == '-' || (c >= '0' && c <= '9')) {
+    char num[64];
+    size_t n = 0;
+    while (n < left && n < sizeof(num) - 1 &&
+           strchr("+-0123456789.eE", ps->p[n]) != NULL) {
+      num[n] = ps->p[n];
+      n++;
+    }
+    num[n] = '\0';
+    char *endp = NULL;
+    double d = strtod(num, &endp);
+    if (endp == num) {
+      return NULL;
+    }
+    ps->p += endp - num;
+    cJSON *it = new_item(cJSON_Number);
+    if (it != NULL) {
+      it->valuedouble = d;
+      it->valueint = d >= 2147483647.0    ? 2147483647
+                     : d <= -2147483648.0 ? (-2147483647 - 1)
+                                          : (int)d;
+    }
+    return it;
+  }
+  return NULL;
+}
+
+cJSON *cJSON_ParseWithLength(const char *value, size_t buffer_length) {
+  if (value == NULL) {
+    return NULL;
+  }
+  parser_t ps = {value, value + buffer_length, 0};
+  cJSON *root = parse_value(&ps);
+  if (root == NULL) {
+    return NULL;
+  }
+  skip_ws(&ps);
+  if (ps.p < ps.end && *ps.p != '\0') {
+    cJSON_Delete(root);
+    return NULL;
+  }
+  return root;
+}
+
+cJSON *cJSON_Parse(const char *value) {
+  return value ? cJSON_ParseWithLength(value, strlen(value)) : NULL;
+}
+
+void cJSON_Delete(cJSON *item) {
+  while (item != NULL) {
+    cJSON *next = item->next;
+    cJSON_Delete(item->child);
+    free(item->valuestring);
+    free(item->string);
+    free(item);
+    item = next;
+  }
+}
+
+int cJSON_GetArraySize(const cJSON *array) {
+  int n = 0;
+  for (const cJSON *c = array ? array->child : NULL; c != NULL; c = c->next) {
+    n++;
+  }
+  return n;
+}
+
+cJSON *cJSON_GetArrayItem(const cJSON *array, int index) {
+  cJSON *c = array ? array->child : NULL;
+  while (c != NULL && index-- > 0) {
+    c = c->next;
+  }
+  return c;
+}
+
+static cJSON *get_object_item(const cJSON *object, const char *name,
+                              bool case_sensitive) {
+  if (object == NULL || name == NULL) {
+    return NULL;
+  }
+  for (cJSON *c = object->child; c != NULL; c = c->next) {
+    if (c->string != NULL &&
+        (case_sensitive ? strcmp(c->string, name) == 0
+                        : strcasecmp(c->string, name) == 0)) {
+      return c;
+    }
+  }
+  return NULL;
+}
+
+cJSON *cJSON_GetObjectItem(const cJSON *object, const char *string) {
+  return get_object_item(object, string, false);
+}
+
+cJSON *cJSON_GetObjectItemCaseSensitive(const cJSON *object,
+                                        const char *string) {
+  return get_object_item(object, string, true);
+}
+
+cJSON_bool cJSON_IsBool(const cJSON *item) {
+  return item != NULL && (item->type & (cJSON_True | cJSON_False)) != 0;
+}
+cJSON_bool cJSON_IsTrue(const cJSON *item) {
+  return item != NULL && item->type == cJSON_True;
+}
+cJSON_bool cJSON_IsFalse(const cJSON *item) {
+  return item != NULL && item->type == cJSON_False;
+}
+cJSON_bool cJSON_IsNull(const cJSON *item) {
+  return item != NULL && item->type == cJSON_NULL;
+}
+cJSON_bool cJSON_IsNumber(const cJSON *item) {
+  return item != NULL && item->type == cJSON_Number;
+}
+cJSON_bool cJSON_IsString(const cJSON *item) {
+  return item != NULL && item->type == cJSON_String;
+}
+cJSON_bool cJSON_IsArray(const cJSON *item) {
+  return item != NULL && item->type == cJSON_Array;
+}
+cJSON_bool cJSON_IsObject(const cJSON *item) {
+  return item != NULL && item->type == cJSON_Object;
+}
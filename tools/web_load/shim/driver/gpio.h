@@ -0,0 +1,37 @@
+/**
+ * @file gpio.h
+ * @brief Host shim driver/gpio.h pro tools/web_load (jen typy pro freertos_chess.h)
+ */
+
+#ifndef WEB_LOAD_SHIM_DRIVER_GPIO_H
+#define WEB_LOAD_SHIM_DRIVER_GPIO_H
+
+typedef int gpio_num_t;
+
+#define GPIO_NUM_NC (-1)
+#define GPIO_NUM_0 0
+#define GPIO_NUM_1 1
+#define GPIO_NUM_2 2
+#define GPIO_NUM_3 3
+#define GPIO_NUM_4 4
+#define GPIO_NUM_5 5
+#define GPIO_NUM_6 6
+#define GPIO_NUM_7 7
+#define GPIO_NUM_8 8
+#define GPIO_NUM_9 9
+#define GPIO_NUM_10 10
+#define GPIO_NUM_11 11
+#define GPIO_NUM_12 12
+#define GPIO_NUM_13 13
+#define GPIO_NUM_14 14
+#define GPIO_NUM_15 15
+#define GPIO_NUM_16 16
+#define GPIO_NUM_17 17
+#define GPIO_NUM_18 18
+#define GPIO_NUM_19 19
+#define GPIO_NUM_20 20
+#define GPIO_NUM_21 21
+#define GPIO_NUM_22 22
+#define GPIO_NUM_23 23
+
+#endif // WEB_LOAD_SHIM_DRIVER_GPIO_H
@@ -0,0 +1,199 @@
+/**
+ * @file esp_http_server.h
+ * @brief Host shim esp_http_server pro tools/web_load (POSIX sockety)
+ *
+ * Podmnozina API, kterou pouziva components/web_server_task, se stejnou
+ * semantikou jako ESP-IDF httpd: jedno vlakno serveru (handlery bezi
+ * seriove), max_open_sockets (pri plne tabulce se listen socket nepolluje),
+ * blokujici cteni hlavicky s recv_wait_timeout, WebSocket ramce a
+ * httpd_queue_work pres ridici rouru.
+ */
+
+#ifndef WEB_LOAD_SHIM_ESP_HTTP_SERVER_H
+#define WEB_LOAD_SHIM_ESP_HTTP_SERVER_H
+
+#include "esp_err.h"
+#include "sdkconfig.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef void *httpd_handle_t;
+
+/** Cisla metod jako http_parser (ESP-IDF je prebira). */
+typedef enum {
+  HTTP_DELETE = 0,
+  HTTP_GET = 1,
+  HTTP_HEAD = 2,
+  HTTP_POST = 3,
+  HTTP_PUT = 4,
+  HTTP_OPTIONS = 6,
+} httpd_method_t;
+
+#define HTTPD_MAX_URI_LEN CONFIG_HTTPD_MAX_URI_LEN
+#define HTTPD_MAX_REQ_HDR_LEN CONFIG_HTTPD_MAX_REQ_HDR_LEN
+#define HTTPD_RESP_USE_STRLEN -1
+
+#define HTTPD_200 "200 OK"
+#define HTTPD_204 "204 No Content"
+#define HTTPD_400 "400 Bad Request"
+#define HTTPD_404 "404 Not Found"
+#define HTTPD_408 "408 Request Timeout"
+#define HTTPD_500 "500 Internal Server Error"
+
+#define HTTPD_TYPE_JSON "application/json"
+#define HTTPD_TYPE_TEXT "text/html"
+#define HTTPD_TYPE_OCTET "application/octet-stream"
+
+#define HTTPD_SOCK_ERR_FAIL -1
+#define HTTPD_SOCK_ERR_INVALID -2
+#define HTTPD_SOCK_ERR_TIMEOUT -3
+
+typedef enum {
+  HTTPD_400_BAD_REQUEST = 400,
+  HTTPD_404_NOT_FOUND = 404,
+  HTTPD_405_METHOD_NOT_ALLOWED = 405,
+  HTTPD_408_REQ_TIMEOUT = 408,
+  HTTPD_411_LENGTH_REQUIRED = 411,
+  HTTPD_414_URI_TOO_LONG = 414,
+  HTTPD_431_REQ_HDR_FIELDS_TOO_LARGE = 431,
+  HTTPD_500_INTERNAL_SERVER_ERROR = 500,
+  HTTPD_501_METHOD_NOT_IMPLEMENTED = 501,
+} httpd_err_code_t;
+
+typedef bool (*httpd_uri_match_func_t)(const char *uri_template,
+                                       const char *uri_to_match,
+                                       size_t match_upto);
+typedef void (*httpd_work_fn_t)(void *arg);
+typedef void (*httpd_free_ctx_fn_t)(void *ctx);
+typedef void (*transfer_complete_cb)(esp_err_t err, int socket, void *arg);
+
+typedef struct {
+  unsigned task_priority;
+  size_t stack_size;
+  int core_id;
+  uint16_t server_port;
+  uint16_t ctrl_port;
+  uint16_t max_open_sockets;
+  uint16_t max_uri_handlers;
+  uint16_t max_resp_headers;
+  uint16_t backlog_conn;
+  bool lru_purge_enable;
+  uint16_t recv_wait_timeout; ///< s
+  uint16_t send_wait_timeout; ///< s
+  void *global_user_ctx;
+  httpd_uri_match_func_t uri_match_fn;
+} httpd_config_t;
+
+#define HTTPD_DEFAULT_CONFIG()                                                 \
+  {                                                                            \
+    .task_priority = 5, .stack_size = 4096, .core_id = 0x7fffffff,             \
+    .server_port = 80, .ctrl_port = 32768, .max_open_sockets = 7,              \
+    .max_uri_handlers = 8, .max_resp_headers = 8, .backlog_conn = 5,           \
+    .lru_purge_enable = false, .recv_wait_timeout = 5,                         \
+    .send_wait_timeout = 5, .global_user_ctx = NULL, .uri_match_fn = NULL,     \
+  }
+
+typedef struct httpd_req {
+  httpd_handle_t handle;
+  int method;
+  const char uri[HTTPD_MAX_URI_LEN + 1];
+  size_t content_len;
+  void *aux;
+  void *user_ctx;
+  void *sess_ctx;
+  httpd_free_ctx_fn_t free_ctx;
+  bool ignore_sess_ctx_changes;
+} httpd_req_t;
+
+typedef struct httpd_uri {
+  const char *uri;
+  httpd_method_t method;
+  esp_err_t (*handler)(httpd_req_t *r);
+  void *user_ctx;
+  bool is_websocket;
+  bool handle_ws_control_frames;
+  const char *supported_subprotocol;
+} httpd_uri_t;
+
+typedef enum {
+  HTTPD_WS_TYPE_CONTINUE = 0x0,
+  HTTPD_WS_TYPE_TEXT = 0x1,
+  HTTPD_WS_TYPE_BINARY = 0x2,
+  HTTPD_WS_TYPE_CLOSE = 0x8,
+  HTTPD_WS_TYPE_PING = 0x9,
+  HTTPD_WS_TYPE_PONG = 0xA,
+} httpd_ws_type_t;
+
+typedef struct httpd_ws_frame {
+  bool final;
+  bool fragmented;
+  httpd_ws_type_t type;
+  uint8_t *payload;
+  size_t len;
+} httpd_ws_frame_t;
+
+typedef enum {
+  HTTPD_WS_CLIENT_INVALID = 0x0,
+  HTTPD_WS_CLIENT_HTTP = 0x1,
+  HTTPD_WS_CLIENT_WEBSOCKET = 0x2,
+} httpd_ws_client_info_t;
+
+// Server
+esp_err_t httpd_start(httpd_handle_t *handle, const httpd_config_t *config);
+esp_err_t httpd_stop(httpd_handle_t handle);
+esp_err_t httpd_register_uri_handler(httpd_handle_t handle,
+                                     const httpd_uri_t *uri_handler);
+esp_err_t httpd_queue_work(httpd_handle_t handle, httpd_work_fn_t work,
+                           void *arg);
+esp_err_t httpd_get_client_list(httpd_handle_t handle, size_t *fds,
+                                int *client_fds);
+esp_err_t httpd_sess_trigger_close(httpd_handle_t handle, int sockfd);
+bool httpd_uri_match_wildcard(const char *uri_template,
+                              const char *uri_to_match, size_t match_upto);
+
+// Request
+int httpd_req_to_sockfd(httpd_req_t *r);
+int httpd_req_recv(httpd_req_t *r, char *buf, size_t buf_len);
+size_t httpd_req_get_hdr_value_len(httpd_req_t *r, const char *field);
+esp_err_t httpd_req_get_hdr_value_str(httpd_req_t *r, const char *field,
+                                      char *val, size_t val_size);
+size_t httpd_req_get_url_query_len(httpd_req_t *r);
+esp_err_t httpd_req_get_url_query_str(httpd_req_t *r, char *buf,
+                                      size_t buf_len);
+esp_err_t httpd_query_key_value(const char *qry, const char *key, char *val,
+                                size_t val_size);
+
+// Response
+esp_err_t httpd_resp_set_status(httpd_req_t *r, const char *status);
+esp_err_t httpd_resp_set_type(httpd_req_t *r, const char *type);
+esp_err_t httpd_resp_set_hdr(httpd_req_t *r, const char *field,
+                             const char *value);
+esp_err_t httpd_resp_send(httpd_req_t *r, const char *buf, ssize_t buf_len);
+esp_err_t httpd_resp_send_chunk(httpd_req_t *r, const char *buf,
+                                ssize_t buf_len);
+esp_err_t httpd_resp_sendstr(httpd_req_t *r, const char *str);
+esp_err_t httpd_resp_send_err(httpd_req_t *r, httpd_err_code_t error,
+                              const char *msg);
+
+// WebSocket
+esp_err_t httpd_ws_recv_frame(httpd_req_t *req, httpd_ws_frame_t *pkt,
+                              size_t max_len);
+esp_err_t httpd_ws_send_frame(httpd_req_t *req, httpd_ws_frame_t *pkt);
+esp_err_t httpd_ws_send_data(httpd_handle_t handle, int socket,
+                             httpd_ws_frame_t *frame);
+esp_err_t httpd_ws_send_data_async(httpd_handle_t handle, int socket,
+                                   httpd_ws_frame_t *frame,
+                                   transfer_complete_cb callback, void *arg);
+httpd_ws_client_info_t httpd_ws_get_fd_info(httpd_handle_t hd, int fd);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // WEB_LOAD_SHIM_ESP_HTTP_SERVER_H
@@ -0,0 +1,30 @@
+/**
+ * @file esp_log.h
+ * @brief Host shim ESP-IDF logovani pro tools/web_load (Linux build)
+ *
+ * Uroven se nastavuje za behu (web_host -v); default jen W/E, aby logy
+ * handleru pri zatezi neskreslovaly latenci.
+ */
+
+#ifndef WEB_LOAD_SHIM_ESP_LOG_H
+#define WEB_LOAD_SHIM_ESP_LOG_H
+
+#include <inttypes.h>
+#include <stdio.h>
+
+extern int host_log_level; ///< 1=E 2=W 3=I 4=D
+
+#define HOST_LOG(lvl, letter, tag, fmt, ...)                                   \
+  do {                                                                         \
+    if (host_log_level >= (lvl)) {                                             \
+      fprintf(stderr, letter " %s: " fmt "\n", tag, ##__VA_ARGS__);            \
+    }                                                                          \
+  } while (0)
+
+#define ESP_LOGE(tag, fmt, ...) HOST_LOG(1, "E", tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGW(tag, fmt, ...) HOST_LOG(2, "W", tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGI(tag, fmt, ...) HOST_LOG(3, "I", tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGD(tag, fmt, ...) HOST_LOG(4, "D", tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGV(tag, fmt, ...) HOST_LOG(5, "V", tag, fmt, ##__VA_ARGS__)
+
+#endif // WEB_LOAD_SHIM_ESP_LOG_H
@@ -0,0 +1,16 @@
+/**
+ * @file esp_system.h
+ * @brief Host shim esp_system pro tools/web_load (Linux build)
+ */
+
+#ifndef WEB_LOAD_SHIM_ESP_SYSTEM_H
+#define WEB_LOAD_SHIM_ESP_SYSTEM_H
+
+#include "esp_err.h"
+#include <stdint.h>
+
+/** Host nema pevny heap — vraci konstantu nad varovnymi prahy firmware. */
+uint32_t esp_get_free_heap_size(void);
+uint32_t esp_get_minimum_free_heap_size(void);
+
+#endif // WEB_LOAD_SHIM_ESP_SYSTEM_H
@@ -0,0 +1,31 @@
+/**
+ * @file esp_timer.h
+ * @brief Host shim esp_timer pro tools/web_load (CLOCK_MONOTONIC, vlakno na timer)
+ */
+
+#ifndef WEB_LOAD_SHIM_ESP_TIMER_H
+#define WEB_LOAD_SHIM_ESP_TIMER_H
+
+#include "esp_err.h"
+#include <stdint.h>
+
+typedef struct esp_timer *esp_timer_handle_t;
+typedef void (*esp_timer_cb_t)(void *arg);
+
+typedef struct {
+  esp_timer_cb_t callback;
+  void *arg;
+  int dispatch_method;
+  const char *name;
+  bool skip_unhandled_events;
+} esp_timer_create_args_t;
+
+int64_t esp_timer_get_time(void);
+esp_err_t esp_timer_create(const esp_timer_create_args_t *args,
+                           esp_timer_handle_t *out);
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t t, uint64_t period_us);
+esp_err_t esp_timer_start_once(esp_timer_handle_t t, uint64_t timeout_us);
+esp_err_t esp_timer_stop(esp_timer_handle_t t);
+esp_err_t esp_timer_delete(esp_timer_handle_t t);
+
+#endif // WEB_LOAD_SHIM_ESP_TIMER_H
@@ -0,0 +1,44 @@
+/**
+ * @file FreeRTOS.h
+ * @brief Host shim FreeRTOS pro tools/web_load (pthread, tick = 1 ms)
+ *
+ * portMUX je rekurzivni pthread mutex — kriticke sekce firmware se na hostu
+ * chovaji jako zamek, ne jako zakaz preruseni.
+ */
+
+#ifndef WEB_LOAD_SHIM_FREERTOS_H
+#define WEB_LOAD_SHIM_FREERTOS_H
+
+#include "sdkconfig.h"
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef uint32_t TickType_t;
+typedef long BaseType_t;
+typedef unsigned long UBaseType_t;
+typedef uint32_t StackType_t;
+
+#define pdTRUE 1
+#define pdFALSE 0
+#define pdPASS 1
+#define pdFAIL 0
+#define portMAX_DELAY 0xffffffffu
+#define configTICK_RATE_HZ CONFIG_FREERTOS_HZ
+#define portTICK_PERIOD_MS (1000 / configTICK_RATE_HZ)
+#define pdMS_TO_TICKS(ms)                                                      \
+  ((TickType_t)(((uint64_t)(ms) * configTICK_RATE_HZ) / 1000))
+#define pdTICKS_TO_MS(t) ((uint32_t)(((uint64_t)(t) * 1000) / configTICK_RATE_HZ))
+#define tskNO_AFFINITY 0x7fffffff
+#define IRAM_ATTR
+#define configASSERT(x) (void)(x)
+
+typedef pthread_mutex_t portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP
+#define taskENTER_CRITICAL(m) pthread_mutex_lock(m)
+#define taskEXIT_CRITICAL(m) pthread_mutex_unlock(m)
+#define portENTER_CRITICAL(m) pthread_mutex_lock(m)
+#define portEXIT_CRITICAL(m) pthread_mutex_unlock(m)
+
+#endif // WEB_LOAD_SHIM_FREERTOS_H
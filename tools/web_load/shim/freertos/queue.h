@@ -0,0 +1,22 @@
+/**
+ * @file queue.h
+ * @brief Host shim FreeRTOS front pro tools/web_load (kopie polozek, pthread cond)
+ */
+
+#ifndef WEB_LOAD_SHIM_QUEUE_H
+#define WEB_LOAD_SHIM_QUEUE_H
+
+#include "FreeRTOS.h"
+
+typedef struct host_queue *QueueHandle_t;
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size);
+BaseType_t xQueueSend(QueueHandle_t q, const void *item, TickType_t ticks);
+BaseType_t xQueueSendToBack(QueueHandle_t q, const void *item,
+                            TickType_t ticks);
+BaseType_t xQueueReceive(QueueHandle_t q, void *item, TickType_t ticks);
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t q);
+BaseType_t xQueueReset(QueueHandle_t q);
+void vQueueDelete(QueueHandle_t q);
+
+#endif // WEB_LOAD_SHIM_QUEUE_H
@@ -0,0 +1,27 @@
+/**
+ * @file semphr.h
+ * @brief Host shim FreeRTOS mutexu pro tools/web_load
+ */
+
+#ifndef WEB_LOAD_SHIM_SEMPHR_H
+#define WEB_LOAD_SHIM_SEMPHR_H
+
+#include "FreeRTOS.h"
+#include "queue.h"
+
+typedef struct host_sem *SemaphoreHandle_t;
+/** Jen pro config_persist_future_t (host zapisuje synchronne). */
+typedef struct {
+  void *pad[4];
+} StaticSemaphore_t;
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void);
+SemaphoreHandle_t xSemaphoreCreateMutexStatic(StaticSemaphore_t *buf);
+SemaphoreHandle_t xSemaphoreCreateRecursiveMutex(void);
+BaseType_t xSemaphoreTake(SemaphoreHandle_t s, TickType_t ticks);
+BaseType_t xSemaphoreGive(SemaphoreHandle_t s);
+BaseType_t xSemaphoreTakeRecursive(SemaphoreHandle_t s, TickType_t ticks);
+BaseType_t xSemaphoreGiveRecursive(SemaphoreHandle_t s);
+void vSemaphoreDelete(SemaphoreHandle_t s);
+
+#endif // WEB_LOAD_SHIM_SEMPHR_H
@@ -0,0 +1,17 @@
+/**
+ * @file task.h
+ * @brief Host shim FreeRTOS tasku pro tools/web_load (jen cas a zpozdeni)
+ */
+
+#ifndef WEB_LOAD_SHIM_TASK_H
+#define WEB_LOAD_SHIM_TASK_H
+
+#include "FreeRTOS.h"
+
+typedef void *TaskHandle_t;
+typedef void (*TaskFunction_t)(void *);
+
+TickType_t xTaskGetTickCount(void);
+void vTaskDelay(TickType_t ticks);
+
+#endif // WEB_LOAD_SHIM_TASK_H
@@ -0,0 +1,14 @@
+/**
+ * @file timers.h
+ * @brief Host shim FreeRTOS software timeru pro tools/web_load (jen typy)
+ */
+
+#ifndef WEB_LOAD_SHIM_TIMERS_H
+#define WEB_LOAD_SHIM_TIMERS_H
+
+#include "FreeRTOS.h"
+
+typedef void *TimerHandle_t;
+typedef void (*TimerCallbackFunction_t)(TimerHandle_t);
+
+#endif // WEB_LOAD_SHIM_TIMERS_H
@@ -0,0 +1,1372 @@
+/**
+ * @file host_httpd.c
+ * @brief Host shim esp_http_server pro tools/web_load (POSIX sockety, 1 vlakno)
+ *
+ * Chovani drzi ESP-IDF httpd tam, kde ovlivnuje zatez:
+ * - vsechny handlery a httpd_queue_work bezi v jednom vlakne serveru
+ * - pri max_open_sockets otevrenych session se listen socket nepolluje
+ *   (lru_purge_enable=false) — dalsi klienti cekaji v backlogu jadra
+ * - hlavicka se cte blokujici recv s recv_wait_timeout (pomaly klient
+ *   zdrzi vsechny ostatni, stejne jako na desce)
+ * - handler vrati chybu / 404 / 405 → session se zavre
+ * - WebSocket: handshake, PING/PONG/CLOSE obslouzi server, datove ramce
+ *   jdou handleru s method = 0; async odeslani pres frontu prace
+ */
+
+#include "esp_http_server.h"
+#include "host_httpd.h"
+
+#include "esp_log.h"
+#include "esp_timer.h"
+
+#include <arpa/inet.h>
+#include <ctype.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+static const char *TAG = "HOST_HTTPD";
+
+/** Request line + hlavicky (jako CONFIG_HTTPD_MAX_URI_LEN + MAX_REQ_HDR_LEN). */
+#define HOST_HTTPD_RX_BUF (HTTPD_MAX_URI_LEN + HTTPD_MAX_REQ_HDR_LEN + 64)
+#define HOST_HTTPD_RESP_HDR_CAP 32
+#define HOST_HTTPD_WS_GUID "258EAFA5-E914-47DA-95CA-C5AB0DC85B11"
+
+typedef struct {
+  int fd;                    ///< -1 = volny slot
+  bool ws;                   ///< Po handshake
+  const httpd_uri_t *ws_uri; ///< Handler WebSocketu
+  char rx[HOST_HTTPD_RX_BUF];
+  size_t rx_len;             ///< Nactene, nezpracovane bajty
+} host_sess_t;
+
+struct host_httpd {
+  httpd_config_t cfg;
+  int listen_fd;
+  int ctrl_rd;
+  int ctrl_wr;
+  pthread_t thread;
+  volatile bool running;
+  httpd_uri_t *uris;
+  size_t n_uris;
+  pthread_mutex_t lock; ///< Tabulka session + statistiky
+  host_sess_t *sess;
+  host_httpd_stats_t stats;
+  int64_t full_since_us;
+};
+
+typedef struct {
+  const char *name;
+  const char *value;
+} host_resp_hdr_t;
+
+/** req->aux: stav jednoho pozadavku nebo WS ramce. */
+typedef struct {
+  struct host_httpd *hd;
+  host_sess_t *sess;
+  char hdr[HOST_HTTPD_RX_BUF + 1]; ///< Request line + hlavicky (NUL)
+  size_t body_left;
+  const char *status;
+  const char *type;
+  host_resp_hdr_t resp_hdrs[HOST_HTTPD_RESP_HDR_CAP];
+  size_t n_resp_hdrs;
+  bool chunked;
+  int status_code;
+  /* WebSocket ramec */
+  httpd_ws_type_t ws_type;
+  bool ws_final;
+  bool ws_masked;
+  uint8_t ws_mask[4];
+  size_t ws_len;
+  size_t ws_read;
+} host_req_aux_t;
+
+typedef struct {
+  httpd_work_fn_t fn;
+  void *arg;
+} host_work_t;
+
+static inline struct host_httpd *hd_of(httpd_handle_t h) {
+  return (struct host_httpd *)h;
+}
+
+static inline host_req_aux_t *aux_of(httpd_req_t *r) {
+  return (host_req_aux_t *)r->aux;
+}
+
+// ============================================================================
+// SOCKET I/O
+// ============================================================================
+
+static esp_err_t send_all(int fd, const void *buf, size_t len, int flags) {
+  const uint8_t *p = buf;
+  while (len > 0) {
+    ssize_t n = send(fd, p, len, MSG_NOSIGNAL | flags);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      return ESP_ERR_HTTPD_RESP_SEND;
+    }
+    p += n;
+    len -= (size_t)n;
+  }
+  return ESP_OK;
+}
+
+/** Presne `n` bajtu: nejdriv z rx bufferu session, pak ze socketu. */
+static bool sess_read_exact(host_sess_t *s, void *buf, size_t n) {
+  uint8_t *o = buf;
+  size_t take = s->rx_len < n ? s->rx_len : n;
+  if (take > 0) {
+    memcpy(o, s->rx, take);
+    memmove(s->rx, s->rx + take, s->rx_len - take);
+    s->rx_len -= take;
+    o += take;
+    n -= take;
+  }
+  while (n > 0) {
+    ssize_t r = recv(s->fd, o, n, 0);
+    if (r < 0 && errno == EINTR) {
+      continue;
+    }
+    if (r <= 0) {
+      return false;
+    }
+    o += r;
+    n -= (size_t)r;
+  }
+  return true;
+}
+
+static void sess_discard(host_sess_t *s, size_t n) {
+  uint8_t tmp[512];
+  while (n > 0) {
+    size_t chunk = n < sizeof(tmp) ? n : sizeof(tmp);
+    if (!sess_read_exact(s, tmp, chunk)) {
+      return;
+    }
+    n -= chunk;
+  }
+}
+
+// ============================================================================
+// SESSION
+// ============================================================================
+
+static void stats_add(struct host_httpd *hd, uint64_t *field, uint64_t v) {
+  pthread_mutex_lock(&hd->lock);
+  *field += v;
+  pthread_mutex_unlock(&hd->lock);
+}
+
+static host_sess_t *sess_find_locked(struct host_httpd *hd, int fd) {
+  for (int i = 0; i < hd->cfg.max_open_sockets; i++) {
+    if (hd->sess[i].fd == fd && fd >= 0) {
+      return &hd->sess[i];
+    }
+  }
+  return NULL;
+}
+
+static void sess_close(struct host_httpd *hd, host_sess_t *s) {
+  if (s->fd < 0) {
+    return;
+  }
+  ESP_LOGD(TAG, "close fd %d", s->fd);
+  pthread_mutex_lock(&hd->lock);
+  close(s->fd);
+  s->fd = -1;
+  s->ws = false;
+  s->ws_uri = NULL;
+  s->rx_len = 0;
+  hd->stats.closed++;
+  hd->stats.active--;
+  pthread_mutex_unlock(&hd->lock);
+}
+
+static void sess_accept(struct host_httpd *hd) {
+  int fd = accept(hd->listen_fd, NULL, NULL);
+  if (fd < 0) {
+    return;
+  }
+  struct timeval rcv = {.tv_sec = hd->cfg.recv_wait_timeout};
+  struct timeval snd = {.tv_sec = hd->cfg.send_wait_timeout};
+  setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &rcv, sizeof(rcv));
+  setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &snd, sizeof(snd));
+  /* Linux loopback + Nagle/delayed ACK by pridal ~40 ms na odpovedi psane
+   * po castech (hlavicky, chunky); lwIP na desce tohle nedela. */
+  int one = 1;
+  setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+  pthread_mutex_lock(&hd->lock);
+  host_sess_t *slot = NULL;
+  for (int i = 0; i < hd->cfg.max_open_sockets && slot == NULL; i++) {
+    if (hd->sess[i].fd < 0) {
+      slot = &hd->sess[i];
+    }
+  }
+  if (slot == NULL) {
+    pthread_mutex_unlock(&hd->lock);
+    close(fd);
+    return;
+  }
+  slot->fd = fd;
+  slot->ws = false;
+  slot->ws_uri = NULL;
+  slot->rx_len = 0;
+  hd->stats.accepted++;
+  hd->stats.active++;
+  if (hd->stats.active > hd->stats.max_active) {
+    hd->stats.max_active = hd->stats.active;
+  }
+  pthread_mutex_unlock(&hd->lock);
+  ESP_LOGD(TAG, "accept fd %d", fd);
+}
+
+// ============================================================================
+// ODPOVED
+// ============================================================================
+
+static int status_code_of(const char *status) {
+  return status ? atoi(status) : 200;
+}
+
+static esp_err_t resp_send_headers(httpd_req_t *r, ssize_t content_len) {
+  host_req_aux_t *a = aux_of(r);
+  char head[2048];
+  size_t n = (size_t)snprintf(head, sizeof(head),
+                              "HTTP/1.1 %s\r\nContent-Type: %s\r\n",
+                              a->status, a->type);
+  if (content_len < 0) {
+    n += (size_t)snprintf(head + n, sizeof(head) - n,
+                          "Transfer-Encoding: chunked\r\n");
+  } else {
+    n += (size_t)snprintf(head + n, sizeof(head) - n,
+                          "Content-Length: %zd\r\n", content_len);
+  }
+  for (size_t i = 0; i < a->n_resp_hdrs && n < sizeof(head); i++) {
+    n += (size_t)snprintf(head + n, sizeof(head) - n, "%s: %s\r\n",
+                          a->resp_hdrs[i].name, a->resp_hdrs[i].value);
+  }
+  if (n + 2 >= sizeof(head)) {
+    return ESP_ERR_HTTPD_RESP_HDR;
+  }
+  memcpy(head + n, "\r\n", 2);
+  n += 2;
+  a->status_code = status_code_of(a->status);
+  return send_all(a->sess->fd, head, n, content_len != 0 ? MSG_MORE : 0);
+}
+
+esp_err_t httpd_resp_set_status(httpd_req_t *r, const char *status) {
+  if (r == NULL || status == NULL) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  aux_of(r)->status = status;
+  return ESP_OK;
+}
+
+esp_err_t httpd_resp_set_type(httpd_req_t *r, const char *type) {
+  if (r == NULL || type == NULL) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  aux_of(r)->type = type;
+  return ESP_OK;
+}
+
+esp_err_t httpd_resp_set_hdr(httpd_req_t *r, const char *field,
+                             const char *value) {
+  if (r == NULL || field == NULL || value == NULL) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  host_req_aux_t *a = aux_of(r);
+  if (a->n_resp_hdrs >= a->hd->cfg.max_resp_headers ||
+      a->n_resp_hdrs >= HOST_HTTPD_RESP_HDR_CAP) {
+    return ESP_ERR_HTTPD_RESP_HDR;
+  }
+  a->resp_hdrs[a->n_resp_hdrs].name = field;
+  a->resp_hdrs[a->n_resp_hdrs].value = value;
+  a->n_resp_hdrs++;
+  return ESP_OK;
+}
+
+esp_err_t httpd_resp_send(httpd_req_t *r, const char *buf, ssize_t buf_len) {
+  if (r == NULL) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  if (buf_len == HTTPD_RESP_USE_STRLEN) {
+    buf_len = buf ? (ssize_t)strlen(buf) : 0;
+  }
+  if (buf == NULL) {
+    buf_len = 0;
+  }
+  esp_err_t ret = resp_send_headers(r, buf_len);
+  if (ret == ESP_OK && buf_len > 0) {
+    ret = send_all(aux_of(r)->sess->fd, buf, (size_t)buf_len, 0);
+  }
+  return ret;
+}
+
+esp_err_t httpd_resp_send_chunk(httpd_req_t *r, const char *buf,
+                                ssize_t buf_len) {
+  if (r == NULL) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  host_req_aux_t *a = aux_of(r);
+  if (buf_len == HTTPD_RESP_USE_STRLEN) {
+    buf_len = buf ? (ssize_t)strlen(buf) : 0;
+  }
+  if (!a->chunked) {
+    esp_err_t ret = resp_send_headers(r, -1);
+    if (ret != ESP_OK) {
+      return ret;
+    }
+    a->chunked = true;
+  }
+  int fd = a->sess->fd;
+  if (buf == NULL || buf_len == 0) {
+    return send_all(fd, "0\r\n\r\n", 5, 0);
+  }
+  char size_line[16];
+  int n = snprintf(size_line, sizeof(size_line), "%zx\r\n", (size_t)buf_len);
+  esp_err_t ret = send_all(fd, size_line, (size_t)n, MSG_MORE);
+  if (ret == ESP_OK) {
+    ret = send_all(fd, buf, (size_t)buf_len, MSG_MORE);
+  }
+  if (ret == ESP_OK) {
+    ret = send_all(fd, "\r\n", 2, 0);
+  }
+  return ret;
+}
+
+esp_err_t httpd_resp_sendstr(httpd_req_t *r, const char *str) {
+  return httpd_resp_send(r, str, str ? (ssize_t)strlen(str) : 0);
+}
+
+esp_err_t httpd_resp_send_err(httpd_req_t *r, httpd_err_code_t error,
+                              const char *msg) {
+  const char *status;
+  switch (error) {
+  case HTTPD_400_BAD_REQUEST:
+    status = "400 Bad Request";
+    break;
+  case HTTPD_404_NOT_FOUND:
+    status = "404 Not Found";
+    break;
+  case HTTPD_405_METHOD_NOT_ALLOWED:
+    status = "405 Method Not Allowed";
+    break;
+  case HTTPD_408_REQ_TIMEOUT:
+    status = "408 Request Timeout";
+    break;
+  case HTTPD_411_LENGTH_REQUIRED:
+    status = "411 Length Required";
+    break;
+  case HTTPD_414_URI_TOO_LONG:
+    status = "414 URI Too Long";
+    break;
+  case HTTPD_431_REQ_HDR_FIELDS_TOO_LARGE:
+    status = "431 Request Header Fields Too Large";
+    break;
+  case HTTPD_501_METHOD_NOT_IMPLEMENTED:
+    status = "501 Method Not Implemented";
+    break;
+  default:
+    status = "500 Internal Server Error";
+    break;
+  }
+  httpd_resp_set_status(r, status);
+  httpd_resp_set_type(r, "text/html");
+  return httpd_resp_sendstr(r, msg ? msg : status);
+}
+
+// ============================================================================
+// POZADAVEK
+// ============================================================================
+
+int httpd_req_to_sockfd(httpd_req_t *r) {
+  return (r && r->aux) ? aux_of(r)->sess->fd : -1;
+}
+
+int httpd_req_recv(httpd_req_t *r, char *buf, size_t buf_len) {
+  if (r == NULL || buf == NULL) {
+    return HTTPD_SOCK_ERR_INVALID;
+  }
+  host_req_aux_t *a = aux_of(r);
+  host_sess_t *s = a->sess;
+  if (a->body_left == 0) {
+    return 0;
+  }
+  size_t want = buf_len < a->body_left ? buf_len : a->body_left;
+  if (s->rx_len > 0) {
+    size_t take = s->rx_len < want ? s->rx_len : want;
+    memcpy(buf, s->rx, take);
+    memmove(s->rx, s->rx + take, s->rx_len - take);
+    s->rx_len -= take;
+    a->body_left -= take;
+    return (int)take;
+  }
+  ssize_t n;
+  do {
+    n = recv(s->fd, buf, want, 0);
+  } while (n < 0 && errno == EINTR);
+  if (n < 0) {
+    return (errno == EAGAIN || errno == EWOULDBLOCK) ? HTTPD_SOCK_ERR_TIMEOUT
+                                                     : HTTPD_SOCK_ERR_FAIL;
+  }
+  if (n == 0) {
+    return HTTPD_SOCK_ERR_FAIL;
+  }
+  a->body_left -= (size_t)n;
+  return (int)n;
+}
+
+/** Hodnota hlavicky `field` (bez mezer na zacatku), delka do CRLF. */
+static const char *hdr_find(httpd_req_t *r, const char *field, size_t *len) {
+  const char *line = strstr(aux_of(r)->hdr, "\r\n");
+  size_t flen = strlen(field);
+  while (line != NULL && line[2] != '\r' && line[2] != '\0') {
+    line += 2;
+    const char *eol = strstr(line, "\r\n");
+    if (eol == NULL) {
+      break;
+    }
+    if ((size_t)(eol - line) > flen && line[flen] == ':' &&
+        strncasecmp(line, field, flen) == 0) {
+      const char *v = line + flen + 1;
+      while (v < eol && (*v == ' ' || *v == '\t')) {
+        v++;
+      }
+      *len = (size_t)(eol - v);
+      return v;
+    }
+    line = eol;
+  }
+  return NULL;
+}
+
+size_t httpd_req_get_hdr_value_len(httpd_req_t *r, const char *field) {
+  size_t len = 0;
+  return (r && field && hdr_find(r, field, &len)) ? len : 0;
+}
+
+esp_err_t httpd_req_get_hdr_value_str(httpd_req_t *r, const char *field,
+                                      char *val, size_t val_size) {
+  if (r == NULL || field == NULL || val == NULL || val_size == 0) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  size_t len = 0;
+  const char *v = hdr_find(r, field, &len);
+  if (v == NULL) {
+    return ESP_ERR_NOT_FOUND;
+  }
+  size_t n = len < val_size - 1 ? len : val_size - 1;
+  memcpy(val, v, n);
+  val[n] = '\0';
+  return n < len ? ESP_ERR_HTTPD_RESULT_TRUNC : ESP_OK;
+}
+
+size_t httpd_req_get_url_query_len(httpd_req_t *r) {
+  const char *q = r ? strchr(r->uri, '?') : NULL;
+  return q ? strlen(q + 1) : 0;
+}
+
+esp_err_t httpd_req_get_url_query_str(httpd_req_t *r, char *buf,
+                                      size_t buf_len) {
+  if (r == NULL || buf == NULL || buf_len == 0) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  const char *q = strchr(r->uri, '?');
+  if (q == NULL) {
+    return ESP_ERR_NOT_FOUND;
+  }
+  size_t len = strlen(q + 1);
+  size_t n = len < buf_len - 1 ? len : buf_len - 1;
+  memcpy(buf, q + 1, n);
+  buf[n] = '\0';
+  return n < len ? ESP_ERR_HTTPD_RESULT_TRUNC : ESP_OK;
+}
+
+esp_err_t httpd_query_key_value(const char *qry, const char *key, char *val,
+                                size_t val_size) {
+  if (qry == NULL || key == NULL || val == NULL || val_size == 0) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  size_t klen = strlen(key);
+  const char *p = qry;
+  while (*p != '\0') {
+    const char *end = strchr(p, '&');
+    size_t plen = end ? (size_t)(end - p) : strlen(p);
+    if (plen > klen && p[klen] == '=' && strncmp(p, key, klen) == 0) {
+      size_t vlen = plen - klen - 1;
+      size_t n = vlen < val_size - 1 ? vlen : val_size - 1;
+      memcpy(val, p + klen + 1, n);
+      val[n] = '\0';
+      return n < vlen ? ESP_ERR_HTTPD_RESULT_TRUNC : ESP_OK;
+    }
+    if (end == NULL) {
+      break;
+    }
+    p = end + 1;
+  }
+  return ESP_ERR_NOT_FOUND;
+}
+
+// ============================================================================
+// WEBSOCKET
+// ============================================================================
+
+/** SHA-1 jen pro Sec-WebSocket-Accept (RFC 3174). */
+static void sha1(const uint8_t *data, size_t len, uint8_t out[20]) {
+  uint32_t h[5] = {0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476,
+                   0xC3D2E1F0};
+  size_t total = ((len + 8) / 64 + 1) * 64;
+  uint8_t *msg = calloc(1, total);
+  if (msg == NULL) {
+    memset(out, 0, 20);
+    return;
+  }
+  memcpy(msg, data, len);
+  msg[len] = 0x80;
+  uint64_t bits = (uint64_t)len * 8;
+  for (int i = 0; i < 8; i++) {
+    msg[total - 1 - i] = (uint8_t)(bits >> (8 * i));
+  }
+  for (size_t off = 0; off < total; off += 64) {
+    uint32_t w[80];
+    for (int i = 0; i < 16; i++) {
+      const uint8_t *p = msg + off + 4 * i;
+      w[i] = (uint32_t)p[0] << 24 | (uint32_t)p[1] << 16 |
+             (uint32_t)p[2] << 8 | p[3];
+    }
+    for (int i = 16; i < 80; i++) {
+      uint32_t x = w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16];
+      w[i] = (x << 1) | (x >> 31);
+    }
+    uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+    for (int i = 0; i < 80; i++) {
+      uint32_t f, k;
+      if (i < 20) {
+        f = (b & c) | (~b & d);
+        k = 0x5A827999;
+      } else if (i < 40) {
+        f = b ^ c ^ d;
+        k = 0x6ED9EBA1;
+      } else if (i < 60) {
+        f = (b & c) | (b & d) | (c & d);
+        k = 0x8F1BBCDC;
+      } else {
+        f = b ^ c ^ d;
+        k = 0xCA62C1D6;
+      }
+      uint32_t t = ((a << 5) | (a >> 27)) + f + e + k + w[i];
+      e = d;
+      d = c;
+      c = (b << 30) | (b >> 2);
+      b = a;
+      a = t;
+    }
+    h[0] += a;
+    h[1] += b;
+    h[2] += c;
+    h[3] += d;
+    h[4] += e;
+  }
+  free(msg);
+  for (int i = 0; i < 5; i++) {
+    out[4 * i] = (uint8_t)(h[i] >> 24);
+    out[4 * i + 1] = (uint8_t)(h[i] >> 16);
+    out[4 * i + 2] = (uint8_t)(h[i] >> 8);
+    out[4 * i + 3] = (uint8_t)h[i];
+  }
+}
+
+static void base64(const uint8_t *in, size_t len, char *out) {
+  static const char tbl[] =
+      "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  size_t o = 0;
+  for (size_t i = 0; i < len; i += 3) {
+    uint32_t v = (uint32_t)in[i] << 16;
+    if (i + 1 < len) {
+      v |= (uint32_t)in[i + 1] << 8;
+    }
+    if (i + 2 < len) {
+      v |= in[i + 2];
+    }
+    out[o++] = tbl[(v >> 18) & 63];
+    out[o++] = tbl[(v >> 12) & 63];
+    out[o++] = (i + 1 < len) ? tbl[(v >> 6) & 63] : '=';
+    out[o++] = (i + 2 < len) ? tbl[v & 63] : '=';
+  }
+  out[o] = '\0';
+}
+
+static esp_err_t ws_handshake(httpd_req_t *r, const httpd_uri_t *u) {
+  char key[64];
+  if (httpd_req_get_hdr_value_str(r, "Sec-WebSocket-Key", key, sizeof(key)) !=
+      ESP_OK) {
+    return ESP_ERR_HTTPD_INVALID_REQ;
+  }
+  char cat[128];
+  int n = snprintf(cat, sizeof(cat), "%s%s", key, HOST_HTTPD_WS_GUID);
+  uint8_t digest[20];
+  sha1((const uint8_t *)cat, (size_t)n, digest);
+  char accept[32];
+  base64(digest, sizeof(digest), accept);
+  char resp[256];
+  n = snprintf(resp, sizeof(resp),
+               "HTTP/1.1 101 Switching Protocols\r\n"
+               "Upgrade: websocket\r\n"
+               "Connection: Upgrade\r\n"
+               "Sec-WebSocket-Accept: %s\r\n\r\n",
+               accept);
+  host_req_aux_t *a = aux_of(r);
+  esp_err_t ret = send_all(a->sess->fd, resp, (size_t)n, 0);
+  if (ret == ESP_OK) {
+    pthread_mutex_lock(&a->hd->lock);
+    a->sess->ws = true;
+    a->sess->ws_uri = u;
+    a->hd->stats.ws_handshakes++;
+    pthread_mutex_unlock(&a->hd->lock);
+    a->status_code = 101;
+  }
+  return ret;
+}
+
+static esp_err_t ws_send_on_fd(struct host_httpd *hd, int fd,
+                               const httpd_ws_frame_t *f) {
+  uint8_t head[10];
+  size_t n = 0;
+  head[n++] = (uint8_t)((f->final || !f->fragmented ? 0x80 : 0) |
+                        (f->type & 0x0F));
+  if (f->len < 126) {
+    head[n++] = (uint8_t)f->len;
+  } else if (f->len <= 0xFFFF) {
+    head[n++] = 126;
+    head[n++] = (uint8_t)(f->len >> 8);
+    head[n++] = (uint8_t)f->len;
+  } else {
+    head[n++] = 127;
+    for (int i = 7; i >= 0; i--) {
+      head[n++] = (uint8_t)((uint64_t)f->len >> (8 * i));
+    }
+  }
+  esp_err_t ret = send_all(fd, head, n, f->len > 0 ? MSG_MORE : 0);
+  if (ret == ESP_OK && f->len > 0) {
+    ret = send_all(fd, f->payload, f->len, 0);
+  }
+  pthread_mutex_lock(&hd->lock);
+  if (ret == ESP_OK) {
+    hd->stats.ws_frames_tx++;
+    hd->stats.ws_tx_bytes += f->len;
+  } else {
+    hd->stats.ws_tx_errors++;
+  }
+  pthread_mutex_unlock(&hd->lock);
+  return ret;
+}
+
+esp_err_t httpd_ws_recv_frame(httpd_req_t *req, httpd_ws_frame_t *pkt,
+                              size_t max_len) {
+  if (req == NULL || pkt == NULL) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  host_req_aux_t *a = aux_of(req);
+  pkt->type = a->ws_type;
+  pkt->final = a->ws_final;
+  pkt->fragmented = !a->ws_final;
+  if (max_len == 0) {
+    pkt->len = a->ws_len;
+    return ESP_OK;
+  }
+  if (pkt->payload == NULL) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  size_t left = a->ws_len - a->ws_read;
+  size_t n = left < max_len ? left : max_len;
+  if (!sess_read_exact(a->sess, pkt->payload, n)) {
+    return ESP_FAIL;
+  }
+  if (a->ws_masked) {
+    for (size_t i = 0; i < n; i++) {
+      pkt->payload[i] ^= a->ws_mask[(a->ws_read + i) & 3];
+    }
+  }
+  a->ws_read += n;
+  pkt->len = n;
+  return ESP_OK;
+}
+
+esp_err_t httpd_ws_send_frame(httpd_req_t *req, httpd_ws_frame_t *pkt) {
+  if (req == NULL || pkt == NULL) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  host_req_aux_t *a = aux_of(req);
+  return ws_send_on_fd(a->hd, a->sess->fd, pkt);
+}
+
+httpd_ws_client_info_t httpd_ws_get_fd_info(httpd_handle_t handle, int fd) {
+  struct host_httpd *hd = hd_of(handle);
+  if (hd == NULL) {
+    return HTTPD_WS_CLIENT_INVALID;
+  }
+  pthread_mutex_lock(&hd->lock);
+  host_sess_t *s = sess_find_locked(hd, fd);
+  httpd_ws_client_info_t info =
+      s == NULL ? HTTPD_WS_CLIENT_INVALID
+                : (s->ws ? HTTPD_WS_CLIENT_WEBSOCKET : HTTPD_WS_CLIENT_HTTP);
+  pthread_mutex_unlock(&hd->lock);
+  return info;
+}
+
+esp_err_t httpd_ws_send_data(httpd_handle_t handle, int socket,
+                             httpd_ws_frame_t *frame) {
+  if (frame == NULL) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  if (httpd_ws_get_fd_info(handle, socket) != HTTPD_WS_CLIENT_WEBSOCKET) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  return ws_send_on_fd(hd_of(handle), socket, frame);
+}
+
+typedef struct {
+  httpd_handle_t handle;
+  int fd;
+  httpd_ws_frame_t frame;
+  transfer_complete_cb cb;
+  void *arg;
+} host_ws_async_t;
+
+static void ws_async_work(void *arg) {
+  host_ws_async_t *t = arg;
+  esp_err_t err = httpd_ws_send_data(t->handle, t->fd, &t->frame);
+  if (t->cb != NULL) {
+    t->cb(err, t->fd, t->arg);
+  }
+  free(t);
+}
+
+esp_err_t httpd_ws_send_data_async(httpd_handle_t handle, int socket,
+                                   httpd_ws_frame_t *frame,
+                                   transfer_complete_cb callback, void *arg) {
+  if (handle == NULL || frame == NULL) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  host_ws_async_t *t = malloc(sizeof(*t));
+  if (t == NULL) {
+    return ESP_ERR_NO_MEM;
+  }
+  /* Jako ESP-IDF: kopiruje se ramec, payload musi zit do callbacku. */
+  t->handle = handle;
+  t->fd = socket;
+  t->frame = *frame;
+  t->cb = callback;
+  t->arg = arg;
+  esp_err_t ret = httpd_queue_work(handle, ws_async_work, t);
+  if (ret != ESP_OK) {
+    free(t);
+  }
+  return ret;
+}
+
+/** Jeden ramec z WS session; false = zavrit session. */
+static bool ws_process(struct host_httpd *hd, host_sess_t *s) {
+  uint8_t b[2];
+  if (!sess_read_exact(s, b, 2)) {
+    return false;
+  }
+  host_req_aux_t *a = calloc(1, sizeof(*a));
+  if (a == NULL) {
+    return false;
+  }
+  a->hd = hd;
+  a->sess = s;
+  a->ws_final = (b[0] & 0x80) != 0;
+  a->ws_type = (httpd_ws_type_t)(b[0] & 0x0F);
+  a->ws_masked = (b[1] & 0x80) != 0;
+  uint64_t len = b[1] & 0x7F;
+  uint8_t ext[8];
+  bool ok = true;
+  if (len == 126) {
+    ok = sess_read_exact(s, ext, 2);
+    len = (uint64_t)ext[0] << 8 | ext[1];
+  } else if (len == 127) {
+    ok = sess_read_exact(s, ext, 8);
+    len = 0;
+    for (int i = 0; i < 8; i++) {
+      len = len << 8 | ext[i];
+    }
+  }
+  if (ok && a->ws_masked) {
+    ok = sess_read_exact(s, a->ws_mask, 4);
+  }
+  a->ws_len = (size_t)len;
+  if (!ok) {
+    free(a);
+    return false;
+  }
+
+  bool keep = true;
+  bool control = a->ws_type >= HTTPD_WS_TYPE_CLOSE;
+  if (control && !s->ws_uri->handle_ws_control_frames) {
+    uint8_t payload[125];
+    httpd_ws_frame_t f = {.payload = payload};
+    httpd_req_t req = {.handle = hd, .aux = a};
+    if (a->ws_len > sizeof(payload) ||
+        httpd_ws_recv_frame(&req, &f, sizeof(payload)) != ESP_OK) {
+      keep = false;
+    } else if (a->ws_type == HTTPD_WS_TYPE_PING) {
+      f.type = HTTPD_WS_TYPE_PONG;
+      f.final = true;
+      keep = ws_send_on_fd(hd, s->fd, &f) == ESP_OK;
+    } else if (a->ws_type == HTTPD_WS_TYPE_CLOSE) {
+      f.type = HTTPD_WS_TYPE_CLOSE;
+      f.final = true;
+      f.len = f.len >= 2 ? 2 : 0;
+      (void)ws_send_on_fd(hd, s->fd, &f);
+      keep = false;
+    }
+  } else {
+    stats_add(hd, &hd->stats.ws_frames_rx, 1);
+    httpd_req_t *req = calloc(1, sizeof(*req));
+    if (req == NULL) {
+      free(a);
+      return false;
+    }
+    req->handle = hd;
+    req->method = 0; /* ESP-IDF: datovy ramec, ne handshake */
+    snprintf((char *)req->uri, sizeof(req->uri), "%s", s->ws_uri->uri);
+    req->aux = a;
+    req->user_ctx = s->ws_uri->user_ctx;
+    keep = s->ws_uri->handler(req) == ESP_OK;
+    free(req);
+    if (keep && a->ws_read < a->ws_len) {
+      sess_discard(s, a->ws_len - a->ws_read);
+    }
+  }
+  free(a);
+  return keep;
+}
+
+// ============================================================================
+// HTTP POZADAVKY
+// ============================================================================
+
+static int method_of(const char *m, size_t len) {
+  static const struct {
+    const char *name;
+    int method;
+  } tbl[] = {{"GET", HTTP_GET},   {"POST", HTTP_POST},
+             {"PUT", HTTP_PUT},   {"DELETE", HTTP_DELETE},
+             {"HEAD", HTTP_HEAD}, {"OPTIONS", HTTP_OPTIONS}};
+  for (size_t i = 0; i < sizeof(tbl) / sizeof(tbl[0]); i++) {
+    if (strlen(tbl[i].name) == len && strncmp(m, tbl[i].name, len) == 0) {
+      return tbl[i].method;
+    }
+  }
+  return -1;
+}
+
+static void record_handler_time(struct host_httpd *hd, int64_t us,
+                                int status_code) {
+  int bucket = 0;
+  while (bucket < HOST_HTTPD_HIST_BUCKETS - 1 && (1LL << (bucket + 1)) <= us) {
+    bucket++;
+  }
+  int cls = status_code / 100;
+  pthread_mutex_lock(&hd->lock);
+  hd->stats.requests++;
+  hd->stats.handler_hist[bucket]++;
+  hd->stats.handler_total_us += (uint64_t)us;
+  if (cls >= 1 && cls <= 5) {
+    hd->stats.status[cls]++;
+  }
+  pthread_mutex_unlock(&hd->lock);
+}
+
+/** Jeden HTTP pozadavek; false = zavrit session. */
+static bool http_process(struct host_httpd *hd, host_sess_t *s) {
+  /* Hlavicka celá — blokujici cteni s recv_wait_timeout jako ESP-IDF. */
+  char *end = NULL;
+  for (;;) {
+    s->rx[s->rx_len < sizeof(s->rx) ? s->rx_len : sizeof(s->rx) - 1] = '\0';
+    end = s->rx_len >= 4 ? memmem(s->rx, s->rx_len, "\r\n\r\n", 4) : NULL;
+    if (end != NULL) {
+      break;
+    }
+    if (s->rx_len >= sizeof(s->rx) - 1) {
+      httpd_req_t req = {.handle = hd};
+      host_req_aux_t *a = calloc(1, sizeof(*a));
+      if (a != NULL) {
+        a->hd = hd;
+        a->sess = s;
+        a->type = "text/html";
+        req.aux = a;
+        httpd_resp_send_err(&req, HTTPD_431_REQ_HDR_FIELDS_TOO_LARGE, NULL);
+        record_handler_time(hd, 0, 431);
+        free(a);
+      }
+      return false;
+    }
+    ssize_t n = recv(s->fd, s->rx + s->rx_len, sizeof(s->rx) - 1 - s->rx_len,
+                     0);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      return false; /* klient zavrel / recv_wait_timeout */
+    }
+    s->rx_len += (size_t)n;
+  }
+
+  int64_t t0 = esp_timer_get_time();
+  size_t hdr_len = (size_t)(end - s->rx) + 4;
+  host_req_aux_t *a = calloc(1, sizeof(*a));
+  httpd_req_t *req = calloc(1, sizeof(*req));
+  if (a == NULL || req == NULL) {
+    free(a);
+    free(req);
+    return false;
+  }
+  a->hd = hd;
+  a->sess = s;
+  a->status = "200 OK";
+  a->type = "text/html";
+  memcpy(a->hdr, s->rx, hdr_len);
+  a->hdr[hdr_len] = '\0';
+  memmove(s->rx, s->rx + hdr_len, s->rx_len - hdr_len);
+  s->rx_len -= hdr_len;
+  req->handle = hd;
+  req->aux = a;
+
+  bool keep = true;
+  const char *sp1 = strchr(a->hdr, ' ');
+  const char *sp2 = sp1 ? strchr(sp1 + 1, ' ') : NULL;
+  int method = sp1 ? method_of(a->hdr, (size_t)(sp1 - a->hdr)) : -1;
+  size_t uri_len = (sp1 && sp2) ? (size_t)(sp2 - sp1 - 1) : 0;
+  if (method < 0 || uri_len == 0) {
+    httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, NULL);
+    keep = false;
+    goto done;
+  }
+  if (uri_len > HTTPD_MAX_URI_LEN) {
+    httpd_resp_send_err(req, HTTPD_414_URI_TOO_LONG, NULL);
+    keep = false;
+    goto done;
+  }
+  memcpy((char *)req->uri, sp1 + 1, uri_len);
+  ((char *)req->uri)[uri_len] = '\0';
+  req->method = method;
+
+  char clen[24];
+  if (httpd_req_get_hdr_value_str(req, "Content-Length", clen, sizeof(clen)) ==
+      ESP_OK) {
+    req->content_len = (size_t)strtoull(clen, NULL, 10);
+    a->body_left = req->content_len;
+  }
+
+  size_t path_len = strcspn(req->uri, "?");
+  const httpd_uri_t *match = NULL;
+  bool uri_known = false;
+  for (size_t i = 0; i < hd->n_uris && match == NULL; i++) {
+    const httpd_uri_t *u = &hd->uris[i];
+    bool hit = hd->cfg.uri_match_fn
+                   ? hd->cfg.uri_match_fn(u->uri, req->uri, path_len)
+                   : (strlen(u->uri) == path_len &&
+                      strncmp(u->uri, req->uri, path_len) == 0);
+    if (hit) {
+      uri_known = true;
+      if ((int)u->method == method) {
+        match = u;
+      }
+    }
+  }
+  if (match == NULL) {
+    httpd_resp_send_err(req,
+                        uri_known ? HTTPD_405_METHOD_NOT_ALLOWED
+                                  : HTTPD_404_NOT_FOUND,
+                        uri_known ? "Request method for this URI is not "
+                                    "handled by server"
+                                  : "Nothing matches the given URI");
+    keep = false;
+    goto done;
+  }
+  req->user_ctx = match->user_ctx;
+  if (match->is_websocket) {
+    if (ws_handshake(req, match) != ESP_OK) {
+      httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, NULL);
+      keep = false;
+      goto done;
+    }
+  }
+  keep = match->handler(req) == ESP_OK;
+  if (keep && a->body_left > 0) {
+    sess_discard(s, a->body_left);
+  }
+
+done:
+  record_handler_time(hd, esp_timer_get_time() - t0,
+                      a->status_code ? a->status_code : 500);
+  free(req);
+  free(a);
+  return keep;
+}
+
+/** Obslouzi readable session (vcetne pipelinovanych pozadavku v bufferu). */
+static void sess_process(struct host_httpd *hd, host_sess_t *s) {
+  do {
+    bool keep = s->ws ? ws_process(hd, s) : http_process(hd, s);
+    if (!keep) {
+      sess_close(hd, s);
+      return;
+    }
+  } while (s->fd >= 0 && s->rx_len > 0 &&
+           (s->ws || memmem(s->rx, s->rx_len, "\r\n\r\n", 4) != NULL));
+}
+
+// ============================================================================
+// SMYCKA SERVERU
+// ============================================================================
+
+static void drain_ctrl(struct host_httpd *hd) {
+  host_work_t w;
+  while (read(hd->ctrl_rd, &w, sizeof(w)) == (ssize_t)sizeof(w)) {
+    if (w.fn != NULL) {
+      w.fn(w.arg);
+    }
+  }
+}
+
+static void *httpd_thread(void *arg) {
+  struct host_httpd *hd = arg;
+  int max = hd->cfg.max_open_sockets;
+  int *polled = calloc((size_t)max, sizeof(int));
+  if (polled == NULL) {
+    return NULL;
+  }
+  while (hd->running) {
+    fd_set rfds;
+    FD_ZERO(&rfds);
+    FD_SET(hd->ctrl_rd, &rfds);
+    int maxfd = hd->ctrl_rd;
+
+    pthread_mutex_lock(&hd->lock);
+    bool full = hd->stats.active >= (uint32_t)max;
+    int64_t now = esp_timer_get_time();
+    if (full && hd->full_since_us == 0) {
+      hd->full_since_us = now;
+    } else if (!full && hd->full_since_us != 0) {
+      hd->stats.full_total_us += now - hd->full_since_us;
+      hd->full_since_us = 0;
+    }
+    pthread_mutex_unlock(&hd->lock);
+    if (!full) {
+      FD_SET(hd->listen_fd, &rfds);
+      maxfd = hd->listen_fd > maxfd ? hd->listen_fd : maxfd;
+    }
+    for (int i = 0; i < max; i++) {
+      polled[i] = hd->sess[i].fd;
+      if (polled[i] >= 0) {
+        FD_SET(polled[i], &rfds);
+        maxfd = polled[i] > maxfd ? polled[i] : maxfd;
+      }
+    }
+
+    int n = select(maxfd + 1, &rfds, NULL, NULL, NULL);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      ESP_LOGE(TAG, "select: %s", strerror(errno));
+      break;
+    }
+    if (FD_ISSET(hd->ctrl_rd, &rfds)) {
+      drain_ctrl(hd);
+    }
+    /* Session pred accept — fd zavreny v drain_ctrl nesmi trefit novy. */
+    for (int i = 0; i < max && hd->running; i++) {
+      host_sess_t *s = &hd->sess[i];
+      if (polled[i] >= 0 && s->fd == polled[i] && FD_ISSET(polled[i], &rfds)) {
+        sess_process(hd, s);
+      }
+    }
+    if (!full && FD_ISSET(hd->listen_fd, &rfds)) {
+      sess_accept(hd);
+    }
+  }
+  free(polled);
+  return NULL;
+}
+
+// ============================================================================
+// API SERVERU
+// ============================================================================
+
+esp_err_t httpd_start(httpd_handle_t *handle, const httpd_config_t *config) {
+  if (handle == NULL || config == NULL || config->max_open_sockets == 0) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  struct host_httpd *hd = calloc(1, sizeof(*hd));
+  if (hd == NULL) {
+    return ESP_ERR_HTTPD_ALLOC_MEM;
+  }
+  hd->cfg = *config;
+  hd->uris = calloc(config->max_uri_handlers, sizeof(httpd_uri_t));
+  hd->sess = calloc(config->max_open_sockets, sizeof(host_sess_t));
+  if (hd->uris == NULL || hd->sess == NULL) {
+    free(hd->uris);
+    free(hd->sess);
+    free(hd);
+    return ESP_ERR_HTTPD_ALLOC_MEM;
+  }
+  for (int i = 0; i < config->max_open_sockets; i++) {
+    hd->sess[i].fd = -1;
+  }
+  pthread_mutex_init(&hd->lock, NULL);
+
+  int ctrl[2];
+  if (pipe2(ctrl, O_NONBLOCK | O_CLOEXEC) != 0) {
+    goto fail;
+  }
+  hd->ctrl_rd = ctrl[0];
+  hd->ctrl_wr = ctrl[1];
+
+  hd->listen_fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (hd->listen_fd < 0) {
+    goto fail_ctrl;
+  }
+  int one = 1;
+  setsockopt(hd->listen_fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+  struct sockaddr_in addr = {.sin_family = AF_INET,
+                             .sin_port = htons(config->server_port),
+                             .sin_addr.s_addr = htonl(INADDR_ANY)};
+  if (bind(hd->listen_fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 ||
+      listen(hd->listen_fd, config->backlog_conn) != 0) {
+    ESP_LOGE(TAG, "bind/listen :%u: %s", config->server_port,
+             strerror(errno));
+    goto fail_listen;
+  }
+
+  /* config->stack_size se na hostu nepouziva — zasobnik x86_64/glibc neni
+   * srovnatelny s RISC-V; vlakno ma default pthread stack. */
+  hd->running = true;
+  if (pthread_create(&hd->thread, NULL, httpd_thread, hd) != 0) {
+    hd->running = false;
+    goto fail_listen;
+  }
+  *handle = hd;
+  return ESP_OK;
+
+fail_listen:
+  close(hd->listen_fd);
+fail_ctrl:
+  close(hd->ctrl_rd);
+  close(hd->ctrl_wr);
+fail:
+  free(hd->uris);
+  free(hd->sess);
+  free(hd);
+  return ESP_ERR_HTTPD_TASK;
+}
+
+esp_err_t httpd_stop(httpd_handle_t handle) {
+  struct host_httpd *hd = hd_of(handle);
+  if (hd == NULL) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  hd->running = false;
+  host_work_t wake = {NULL, NULL};
+  (void)!write(hd->ctrl_wr, &wake, sizeof(wake));
+  pthread_join(hd->thread, NULL);
+  for (int i = 0; i < hd->cfg.max_open_sockets; i++) {
+    sess_close(hd, &hd->sess[i]);
+  }
+  close(hd->listen_fd);
+  close(hd->ctrl_rd);
+  close(hd->ctrl_wr);
+  pthread_mutex_destroy(&hd->lock);
+  free(hd->uris);
+  free(hd->sess);
+  free(hd);
+  return ESP_OK;
+}
+
+esp_err_t httpd_register_uri_handler(httpd_handle_t handle,
+                                     const httpd_uri_t *uri_handler) {
+  struct host_httpd *hd = hd_of(handle);
+  if (hd == NULL || uri_handler == NULL || uri_handler->uri == NULL) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  for (size_t i = 0; i < hd->n_uris; i++) {
+    if (hd->uris[i].method == uri_handler->method &&
+        strcmp(hd->uris[i].uri, uri_handler->uri) == 0) {
+      ESP_LOGW(TAG, "handler %s already registered", uri_handler->uri);
+      return ESP_ERR_HTTPD_HANDLER_EXISTS;
+    }
+  }
+  if (hd->n_uris >= hd->cfg.max_uri_handlers) {
+    ESP_LOGW(TAG, "no slots left for %s (max_uri_handlers=%u)",
+             uri_handler->uri, hd->cfg.max_uri_handlers);
+    return ESP_ERR_HTTPD_HANDLERS_FULL;
+  }
+  hd->uris[hd->n_uris++] = *uri_handler;
+  return ESP_OK;
+}
+
+esp_err_t httpd_queue_work(httpd_handle_t handle, httpd_work_fn_t work,
+                           void *arg) {
+  struct host_httpd *hd = hd_of(handle);
+  if (hd == NULL || work == NULL) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  host_work_t w = {work, arg};
+  /* Zapis do roury <= PIPE_BUF je atomicky; plna roura = ESP_FAIL jako
+   * selhany send na ridici socket v ESP-IDF. */
+  return write(hd->ctrl_wr, &w, sizeof(w)) == (ssize_t)sizeof(w) ? ESP_OK
+                                                                 : ESP_FAIL;
+}
+
+esp_err_t httpd_get_client_list(httpd_handle_t handle, size_t *fds,
+                                int *client_fds) {
+  struct host_httpd *hd = hd_of(handle);
+  if (hd == NULL || fds == NULL || client_fds == NULL ||
+      *fds < hd->cfg.max_open_sockets) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  size_t n = 0;
+  pthread_mutex_lock(&hd->lock);
+  for (int i = 0; i < hd->cfg.max_open_sockets; i++) {
+    if (hd->sess[i].fd >= 0) {
+      client_fds[n++] = hd->sess[i].fd;
+    }
+  }
+  pthread_mutex_unlock(&hd->lock);
+  *fds = n;
+  return ESP_OK;
+}
+
+typedef struct {
+  struct host_httpd *hd;
+  int fd;
+} host_close_t;
+
+static void close_sess_work(void *arg) {
+  host_close_t *c = arg;
+  pthread_mutex_lock(&c->hd->lock);
+  host_sess_t *s = sess_find_locked(c->hd, c->fd);
+  pthread_mutex_unlock(&c->hd->lock);
+  if (s != NULL) {
+    sess_close(c->hd, s);
+  }
+  free(c);
+}
+
+esp_err_t httpd_sess_trigger_close(httpd_handle_t handle, int sockfd) {
+  struct host_httpd *hd = hd_of(handle);
+  if (hd == NULL) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  if (httpd_ws_get_fd_info(handle, sockfd) == HTTPD_WS_CLIENT_INVALID) {
+    return ESP_ERR_NOT_FOUND;
+  }
+  host_close_t *c = malloc(sizeof(*c));
+  if (c == NULL) {
+    return ESP_ERR_NO_MEM;
+  }
+  c->hd = hd;
+  c->fd = sockfd;
+  esp_err_t ret = httpd_queue_work(handle, close_sess_work, c);
+  if (ret != ESP_OK) {
+    free(c);
+  }
+  return ret;
+}
+
+bool httpd_uri_match_wildcard(const char *uri_template,
+                              const char *uri_to_match, size_t match_upto) {
+  size_t tpl_len = strlen(uri_template);
+  if (tpl_len > 0 && uri_template[tpl_len - 1] == '*') {
+    size_t prefix = tpl_len - 1;
+    if (prefix > 0 && uri_template[prefix - 1] == '?') {
+      prefix--; /* "/path?*": lomitko je volitelne */
+      if (match_upto == prefix - 1 &&
+          strncmp(uri_template, uri_to_match, match_upto) == 0) {
+        return true;
+      }
+    }
+    return match_upto >= prefix &&
+           strncmp(uri_template, uri_to_match, prefix) == 0;
+  }
+  return tpl_len == match_upto &&
+         strncmp(uri_template, uri_to_match, match_upto) == 0;
+}
+
+// ============================================================================
+// STATISTIKY
+// ============================================================================
+
+void host_httpd_get_stats(httpd_handle_t handle, host_httpd_stats_t *out) {
+  struct host_httpd *hd = hd_of(handle);
+  if (hd == NULL || out == NULL) {
+    return;
+  }
+  pthread_mutex_lock(&hd->lock);
+  *out = hd->stats;
+  if (hd->full_since_us != 0) {
+    out->full_total_us += esp_timer_get_time() - hd->full_since_us;
+  }
+  pthread_mutex_unlock(&hd->lock);
+}
+
+/** Percentil z log2 histogramu — horni mez bucketu v us. */
+static uint64_t hist_percentile(const uint64_t *hist, uint64_t total,
+                                double p) {
+  uint64_t want = (uint64_t)(total * p + 0.5);
+  uint64_t acc = 0;
+  for (int i = 0; i < HOST_HTTPD_HIST_BUCKETS; i++) {
+    acc += hist[i];
+    if (acc >= want && hist[i] > 0) {
+      return 1ULL << (i + 1);
+    }
+  }
+  return 0;
+}
+
+void host_httpd_print_stats(httpd_handle_t handle, FILE *out) {
+  host_httpd_stats_t st;
+  host_httpd_get_stats(handle, &st);
+  struct host_httpd *hd = hd_of(handle);
+  fprintf(out,
+          "httpd: sockets accepted=%" PRIu64 " closed=%" PRIu64
+          " max_open=%u/%u full_for=%.1f s\n",
+          st.accepted, st.closed, st.max_active, hd->cfg.max_open_sockets,
+          st.full_total_us / 1e6);
+  fprintf(out,
+          "httpd: requests=%" PRIu64 " 1xx=%" PRIu64 " 2xx=%" PRIu64
+          " 3xx=%" PRIu64 " 4xx=%" PRIu64 " 5xx=%" PRIu64 "\n",
+          st.requests, st.status[1], st.status[2], st.status[3], st.status[4],
+          st.status[5]);
+  if (st.requests > 0) {
+    fprintf(out,
+            "httpd: handler mean=%.0f us p50<=%" PRIu64 " us p99<=%" PRIu64
+            " us\n",
+            (double)st.handler_total_us / (double)st.requests,
+            hist_percentile(st.handler_hist, st.requests, 0.50),
+            hist_percentile(st.handler_hist, st.requests, 0.99));
+  }
+  fprintf(out,
+          "httpd: ws handshakes=%" PRIu64 " rx=%" PRIu64 " tx=%" PRIu64
+          " (%.1f KiB) tx_errors=%" PRIu64 "\n",
+          st.ws_handshakes, st.ws_frames_rx, st.ws_frames_tx,
+          st.ws_tx_bytes / 1024.0, st.ws_tx_errors);
+}
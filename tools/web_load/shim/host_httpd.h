@@ -0,0 +1,42 @@
+/**
+ * @file host_httpd.h
+ * @brief Statistiky host shimu esp_http_server (tools/web_load)
+ *
+ * Serverova strana mereni: kolik socketu bylo otevreno, jak dlouho byla
+ * tabulka session plna (nove klienty cekaji v backlogu) a cas handleru.
+ */
+
+#ifndef WEB_LOAD_SHIM_HOST_HTTPD_H
+#define WEB_LOAD_SHIM_HOST_HTTPD_H
+
+#include "esp_http_server.h"
+#include <stdint.h>
+#include <stdio.h>
+
+/** Log2 histogram casu handleru: bucket i = [2^i, 2^(i+1)) us. */
+#define HOST_HTTPD_HIST_BUCKETS 32
+
+typedef struct {
+  uint64_t accepted;        ///< Prijata spojeni
+  uint64_t closed;          ///< Zavrena spojeni (klient, chyba, trigger_close)
+  uint64_t requests;        ///< HTTP pozadavky (bez WS ramcu)
+  uint64_t status[6];       ///< Odpovedi podle tridy (index = kod / 100)
+  uint64_t ws_handshakes;   ///< Upgrade na WebSocket
+  uint64_t ws_frames_rx;    ///< Datove ramce od klientu
+  uint64_t ws_frames_tx;    ///< Odeslane ramce (vcetne async)
+  uint64_t ws_tx_errors;    ///< Selhana odeslani
+  uint64_t ws_tx_bytes;     ///< Odeslane bajty payloadu
+  uint32_t active;          ///< Aktualne otevrene session
+  uint32_t max_active;      ///< Maximum soucasne otevrenych
+  int64_t full_total_us;    ///< Cas s plnou tabulkou (listen se nepolluje)
+  uint64_t handler_hist[HOST_HTTPD_HIST_BUCKETS];
+  uint64_t handler_total_us;
+} host_httpd_stats_t;
+
+/** Kopie statistik (thread-safe). */
+void host_httpd_get_stats(httpd_handle_t handle, host_httpd_stats_t *out);
+
+/** Souhrn statistik v citelnem tvaru (web_host pri ukonceni). */
+void host_httpd_print_stats(httpd_handle_t handle, FILE *out);
+
+#endif // WEB_LOAD_SHIM_HOST_HTTPD_H
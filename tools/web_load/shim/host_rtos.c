@@ -0,0 +1,462 @@
+/**
+ * @file host_rtos.c
+ * @brief Host shim FreeRTOS/esp_timer/NVS pro tools/web_load (pthread)
+ */
+
+#include "esp_err.h"
+#include "esp_log.h"
+#include "esp_system.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "nvs.h"
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+int host_log_level = 2;
+
+// ============================================================================
+// CAS
+// ============================================================================
+
+int64_t esp_timer_get_time(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+TickType_t xTaskGetTickCount(void) {
+  return (TickType_t)(esp_timer_get_time() * configTICK_RATE_HZ / 1000000);
+}
+
+void vTaskDelay(TickType_t ticks) {
+  usleep((useconds_t)pdTICKS_TO_MS(ticks) * 1000);
+}
+
+/** Absolutni deadline pro pthread_*_timed* (CLOCK_REALTIME). */
+static struct timespec deadline_after(TickType_t ticks) {
+  struct timespec ts;
+  clock_gettime(CLOCK_REALTIME, &ts);
+  uint64_t ms = pdTICKS_TO_MS(ticks);
+  ts.tv_sec += (time_t)(ms / 1000);
+  ts.tv_nsec += (long)(ms % 1000) * 1000000L;
+  if (ts.tv_nsec >= 1000000000L) {
+    ts.tv_sec++;
+    ts.tv_nsec -= 1000000000L;
+  }
+  return ts;
+}
+
+// ============================================================================
+// MUTEXY
+// ============================================================================
+
+struct host_sem {
+  pthread_mutex_t m;
+};
+
+static SemaphoreHandle_t sem_create(int type) {
+  SemaphoreHandle_t s = calloc(1, sizeof(*s));
+  if (s == NULL) {
+    return NULL;
+  }
+  pthread_mutexattr_t a;
+  pthread_mutexattr_init(&a);
+  pthread_mutexattr_settype(&a, type);
+  pthread_mutex_init(&s->m, &a);
+  pthread_mutexattr_destroy(&a);
+  return s;
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void) {
+  return sem_create(PTHREAD_MUTEX_NORMAL);
+}
+
+/** Buffer se nepouziva — mutex se alokuje jako u xSemaphoreCreateMutex. */
+SemaphoreHandle_t xSemaphoreCreateMutexStatic(StaticSemaphore_t *buf) {
+  (void)buf;
+  return sem_create(PTHREAD_MUTEX_NORMAL);
+}
+
+SemaphoreHandle_t xSemaphoreCreateRecursiveMutex(void) {
+  return sem_create(PTHREAD_MUTEX_RECURSIVE);
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t s, TickType_t ticks) {
+  if (s == NULL) {
+    return pdFALSE;
+  }
+  if (ticks == portMAX_DELAY) {
+    return pthread_mutex_lock(&s->m) == 0 ? pdTRUE : pdFALSE;
+  }
+  if (ticks == 0) {
+    return pthread_mutex_trylock(&s->m) == 0 ? pdTRUE : pdFALSE;
+  }
+  struct timespec ts = deadline_after(ticks);
+  return pthread_mutex_timedlock(&s->m, &ts) == 0 ? pdTRUE : pdFALSE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t s) {
+  return (s != NULL && pthread_mutex_unlock(&s->m) == 0) ? pdTRUE : pdFALSE;
+}
+
+BaseType_t xSemaphoreTakeRecursive(SemaphoreHandle_t s, TickType_t ticks) {
+  return xSemaphoreTake(s, ticks);
+}
+
+BaseType_t xSemaphoreGiveRecursive(SemaphoreHandle_t s) {
+  return xSemaphoreGive(s);
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t s) {
+  if (s != NULL) {
+    pthread_mutex_destroy(&s->m);
+    free(s);
+  }
+}
+
+// ============================================================================
+// FRONTY
+// ============================================================================
+
+struct host_queue {
+  pthread_mutex_t m;
+  pthread_cond_t not_empty;
+  pthread_cond_t not_full;
+  size_t item_size;
+  size_t length;
+  size_t head;
+  size_t count;
+  uint8_t *items;
+};
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size) {
+  QueueHandle_t q = calloc(1, sizeof(*q));
+  if (q == NULL) {
+    return NULL;
+  }
+  q->items = calloc(length ? length : 1, item_size ? item_size : 1);
+  if (q->items == NULL) {
+    free(q);
+    return NULL;
+  }
+  q->length = length;
+  q->item_size = item_size;
+  pthread_mutex_init(&q->m, NULL);
+  pthread_cond_init(&q->not_empty, NULL);
+  pthread_cond_init(&q->not_full, NULL);
+  return q;
+}
+
+/** Ceka na podminku az do `ticks`; false = timeout. */
+static bool queue_wait(QueueHandle_t q, pthread_cond_t *cond, bool full,
+                       TickType_t ticks) {
+  struct timespec ts = deadline_after(ticks);
+  while (full ? q->count == q->length : q->count == 0) {
+    if (ticks == 0) {
+      return false;
+    }
+    int rc = (ticks == portMAX_DELAY) ? pthread_cond_wait(cond, &q->m)
+                                      : pthread_cond_timedwait(cond, &q->m,
+                                                               &ts);
+    if (rc == ETIMEDOUT) {
+      return false;
+    }
+  }
+  return true;
+}
+
+BaseType_t xQueueSend(QueueHandle_t q, const void *item, TickType_t ticks) {
+  if (q == NULL) {
+    return pdFALSE;
+  }
+  pthread_mutex_lock(&q->m);
+  if (!queue_wait(q, &q->not_full, true, ticks)) {
+    pthread_mutex_unlock(&q->m);
+    return pdFALSE;
+  }
+  size_t tail = (q->head + q->count) % q->length;
+  memcpy(q->items + tail * q->item_size, item, q->item_size);
+  q->count++;
+  pthread_cond_signal(&q->not_empty);
+  pthread_mutex_unlock(&q->m);
+  return pdTRUE;
+}
+
+BaseType_t xQueueSendToBack(QueueHandle_t q, const void *item,
+                            TickType_t ticks) {
+  return xQueueSend(q, item, ticks);
+}
+
+BaseType_t xQueueReceive(QueueHandle_t q, void *item, TickType_t ticks) {
+  if (q == NULL) {
+    return pdFALSE;
+  }
+  pthread_mutex_lock(&q->m);
+  if (!queue_wait(q, &q->not_empty, false, ticks)) {
+    pthread_mutex_unlock(&q->m);
+    return pdFALSE;
+  }
+  memcpy(item, q->items + q->head * q->item_size, q->item_size);
+  q->head = (q->head + 1) % q->length;
+  q->count--;
+  pthread_cond_signal(&q->not_full);
+  pthread_mutex_unlock(&q->m);
+  return pdTRUE;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t q) {
+  if (q == NULL) {
+    return 0;
+  }
+  pthread_mutex_lock(&q->m);
+  UBaseType_t n = q->count;
+  pthread_mutex_unlock(&q->m);
+  return n;
+}
+
+BaseType_t xQueueReset(QueueHandle_t q) {
+  if (q != NULL) {
+    pthread_mutex_lock(&q->m);
+    q->head = 0;
+    q->count = 0;
+    pthread_cond_broadcast(&q->not_full);
+    pthread_mutex_unlock(&q->m);
+  }
+  return pdPASS;
+}
+
+void vQueueDelete(QueueHandle_t q) {
+  if (q != NULL) {
+    pthread_mutex_destroy(&q->m);
+    pthread_cond_destroy(&q->not_empty);
+    pthread_cond_destroy(&q->not_full);
+    free(q->items);
+    free(q);
+  }
+}
+
+// ============================================================================
+// ESP_TIMER (vlakno na timer)
+// ============================================================================
+
+struct esp_timer {
+  esp_timer_create_args_t args;
+  pthread_t thread;
+  pthread_mutex_t m;
+  pthread_cond_t cond;
+  bool running;
+  bool periodic;
+  bool has_thread;
+  uint64_t period_us;
+};
+
+static void *esp_timer_thread(void *arg) {
+  esp_timer_handle_t t = arg;
+  pthread_mutex_lock(&t->m);
+  while (t->running) {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    ts.tv_sec += (time_t)(t->period_us / 1000000);
+    ts.tv_nsec += (long)(t->period_us % 1000000) * 1000L;
+    if (ts.tv_nsec >= 1000000000L) {
+      ts.tv_sec++;
+      ts.tv_nsec -= 1000000000L;
+    }
+    int rc = 0;
+    while (t->running && rc != ETIMEDOUT) {
+      rc = pthread_cond_timedwait(&t->cond, &t->m, &ts);
+    }
+    if (!t->running) {
+      break;
+    }
+    pthread_mutex_unlock(&t->m);
+    t->args.callback(t->args.arg);
+    pthread_mutex_lock(&t->m);
+    if (!t->periodic) {
+      t->running = false;
+    }
+  }
+  pthread_mutex_unlock(&t->m);
+  return NULL;
+}
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t *args,
+                           esp_timer_handle_t *out) {
+  if (args == NULL || args->callback == NULL || out == NULL) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  esp_timer_handle_t t = calloc(1, sizeof(*t));
+  if (t == NULL) {
+    return ESP_ERR_NO_MEM;
+  }
+  t->args = *args;
+  pthread_mutex_init(&t->m, NULL);
+  pthread_cond_init(&t->cond, NULL);
+  *out = t;
+  return ESP_OK;
+}
+
+static esp_err_t esp_timer_start(esp_timer_handle_t t, uint64_t us,
+                                 bool periodic) {
+  if (t == NULL) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  if (t->running) {
+    return ESP_ERR_INVALID_STATE;
+  }
+  if (t->has_thread) {
+    pthread_join(t->thread, NULL); /* dobehnuty one-shot */
+    t->has_thread = false;
+  }
+  t->running = true;
+  t->periodic = periodic;
+  t->period_us = us;
+  if (pthread_create(&t->thread, NULL, esp_timer_thread, t) != 0) {
+    t->running = false;
+    return ESP_ERR_NO_MEM;
+  }
+  t->has_thread = true;
+  return ESP_OK;
+}
+
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t t, uint64_t period_us) {
+  return esp_timer_start(t, period_us, true);
+}
+
+esp_err_t esp_timer_start_once(esp_timer_handle_t t, uint64_t timeout_us) {
+  return esp_timer_start(t, timeout_us, false);
+}
+
+esp_err_t esp_timer_stop(esp_timer_handle_t t) {
+  if (t == NULL) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  pthread_mutex_lock(&t->m);
+  bool was_running = t->running;
+  t->running = false;
+  pthread_cond_broadcast(&t->cond);
+  pthread_mutex_unlock(&t->m);
+  if (t->has_thread) {
+    pthread_join(t->thread, NULL);
+    t->has_thread = false;
+  }
+  return was_running ? ESP_OK : ESP_ERR_INVALID_STATE;
+}
+
+esp_err_t esp_timer_delete(esp_timer_handle_t t) {
+  if (t == NULL) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  if (t->running) {
+    return ESP_ERR_INVALID_STATE;
+  }
+  if (t->has_thread) {
+    pthread_join(t->thread, NULL);
+  }
+  pthread_mutex_destroy(&t->m);
+  pthread_cond_destroy(&t->cond);
+  free(t);
+  return ESP_OK;
+}
+
+// ============================================================================
+// SYSTEM, CHYBY, NVS
+// ============================================================================
+
+uint32_t esp_get_free_heap_size(void) { return 256 * 1024; }
+
+uint32_t esp_get_minimum_free_heap_size(void) { return 256 * 1024; }
+
+const char *esp_err_to_name(esp_err_t code) {
+  switch (code) {
+  case ESP_OK:
+    return "ESP_OK";
+  case ESP_FAIL:
+    return "ESP_FAIL";
+  case ESP_ERR_NO_MEM:
+    return "ESP_ERR_NO_MEM";
+  case ESP_ERR_INVALID_ARG:
+    return "ESP_ERR_INVALID_ARG";
+  case ESP_ERR_INVALID_STATE:
+    return "ESP_ERR_INVALID_STATE";
+  case ESP_ERR_INVALID_SIZE:
+    return "ESP_ERR_INVALID_SIZE";
+  case ESP_ERR_NOT_FOUND:
+    return "ESP_ERR_NOT_FOUND";
+  case ESP_ERR_NOT_SUPPORTED:
+    return "ESP_ERR_NOT_SUPPORTED";
+  case ESP_ERR_TIMEOUT:
+    return "ESP_ERR_TIMEOUT";
+  case ESP_ERR_NVS_NOT_FOUND:
+    return "ESP_ERR_NVS_NOT_FOUND";
+  case ESP_ERR_HTTPD_HANDLERS_FULL:
+    return "ESP_ERR_HTTPD_HANDLERS_FULL";
+  case ESP_ERR_HTTPD_HANDLER_EXISTS:
+    return "ESP_ERR_HTTPD_HANDLER_EXISTS";
+  case ESP_ERR_HTTPD_RESULT_TRUNC:
+    return "ESP_ERR_HTTPD_RESULT_TRUNC";
+  case ESP_ERR_HTTPD_RESP_HDR:
+    return "ESP_ERR_HTTPD_RESP_HDR";
+  case ESP_ERR_HTTPD_RESP_SEND:
+    return "ESP_ERR_HTTPD_RESP_SEND";
+  case ESP_ERR_HTTPD_INVALID_REQ:
+    return "ESP_ERR_HTTPD_INVALID_REQ";
+  default:
+    return "UNKNOWN_ERROR";
+  }
+}
+
+esp_err_t nvs_open(const char *ns, nvs_open_mode_t mode, nvs_handle_t *out) {
+  (void)ns;
+  (void)mode;
+  (void)out;
+  return ESP_ERR_NVS_NOT_FOUND;
+}
+
+void nvs_close(nvs_handle_t h) { (void)h; }
+
+esp_err_t nvs_commit(nvs_handle_t h) {
+  (void)h;
+  return ESP_ERR_NVS_INVALID_HANDLE;
+}
+
+esp_err_t nvs_erase_key(nvs_handle_t h, const char *key) {
+  (void)h;
+  (void)key;
+  return ESP_ERR_NVS_INVALID_HANDLE;
+}
+
+esp_err_t nvs_get_u8(nvs_handle_t h, const char *key, uint8_t *out) {
+  (void)h;
+  (void)key;
+  (void)out;
+  return ESP_ERR_NVS_INVALID_HANDLE;
+}
+
+esp_err_t nvs_set_u8(nvs_handle_t h, const char *key, uint8_t v) {
+  (void)h;
+  (void)key;
+  (void)v;
+  return ESP_ERR_NVS_INVALID_HANDLE;
+}
+
+esp_err_t nvs_get_u32(nvs_handle_t h, const char *key, uint32_t *out) {
+  (void)h;
+  (void)key;
+  (void)out;
+  return ESP_ERR_NVS_INVALID_HANDLE;
+}
+
+esp_err_t nvs_set_u32(nvs_handle_t h, const char *key, uint32_t v) {
+  (void)h;
+  (void)key;
+  (void)v;
+  return ESP_ERR_NVS_INVALID_HANDLE;
+}
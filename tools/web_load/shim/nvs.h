@@ -0,0 +1,26 @@
+/**
+ * @file nvs.h
+ * @brief Host shim NVS pro tools/web_load — zadne ulozene nastaveni
+ *
+ * nvs_open vraci ESP_ERR_NVS_NOT_FOUND, takze moduly jedou na defaultech.
+ */
+
+#ifndef WEB_LOAD_SHIM_NVS_H
+#define WEB_LOAD_SHIM_NVS_H
+
+#include "esp_err.h"
+#include <stdint.h>
+
+typedef uint32_t nvs_handle_t;
+typedef enum { NVS_READONLY, NVS_READWRITE } nvs_open_mode_t;
+
+esp_err_t nvs_open(const char *ns, nvs_open_mode_t mode, nvs_handle_t *out);
+void nvs_close(nvs_handle_t h);
+esp_err_t nvs_commit(nvs_handle_t h);
+esp_err_t nvs_erase_key(nvs_handle_t h, const char *key);
+esp_err_t nvs_get_u8(nvs_handle_t h, const char *key, uint8_t *out);
+esp_err_t nvs_set_u8(nvs_handle_t h, const char *key, uint8_t v);
+esp_err_t nvs_get_u32(nvs_handle_t h, const char *key, uint32_t *out);
+esp_err_t nvs_set_u32(nvs_handle_t h, const char *key, uint32_t v);
+
+#endif // WEB_LOAD_SHIM_NVS_H
@@ -0,0 +1,16 @@
+/**
+ * @file sdkconfig.h
+ * @brief Host shim sdkconfig pro tools/web_load (hodnoty z /sdkconfig)
+ */
+
+#ifndef WEB_LOAD_SHIM_SDKCONFIG_H
+#define WEB_LOAD_SHIM_SDKCONFIG_H
+
+#define CONFIG_CHESS_ENABLE_WEB_SERVER 1
+#define CONFIG_HTTPD_WS_SUPPORT 1
+#define CONFIG_HTTPD_MAX_REQ_HDR_LEN 1024
+#define CONFIG_HTTPD_MAX_URI_LEN 512
+#define CONFIG_LWIP_MAX_SOCKETS 10
+#define CONFIG_FREERTOS_HZ 1000
+
+#endif // WEB_LOAD_SHIM_SDKCONFIG_H
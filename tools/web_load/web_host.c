@@ -0,0 +1,745 @@
+/**
+ * @file web_host.c
+ * @brief Host (Linux) build HTTP vrstvy web_server_task pro zatezove testy
+ *
+ * Preklada skutecne handlery (web_handlers_game.c, web_routes.c, web_ws.c),
+ * snapshot cache, delta stream, staticke assety a timer_system proti shimu
+ * esp_http_server (shim/host_httpd.c). Herni engine nahrazuje jednoduchy
+ * model: skriptovana partie, kazdych --move-ms jeden pultah, po konci znovu.
+ *
+ * Pouziti:
+ * @code
+ * web_host [--port N] [--move-ms MS] [--duration S] [--verbose]
+ * @endcode
+ *
+ * Smycka "web tasku" (100 ms) dela totez co web_server_task: vyprazdni
+ * snapshot_notify_queue → ws_broadcast_snapshot(), pak ws_push_service().
+ * Pri ukonceni (SIGINT / --duration) vypise statistiky serveru.
+ *
+ * @author Alfred Krutina
+ * @version 1.8.0
+ * @date 2026-10-18
+ */
+
+#include "host_httpd.h"
+
+#include "web_routes.h"
+#include "web_server_internal.h"
+#include "web_server_task.h"
+
+#include "../../components/config_manager/include/config_manager.h"
+#include "../../components/config_manager/include/config_persist.h"
+#include "../../components/config_manager/include/config_registry.h"
+#include "../../components/game_task/include/game_archive.h"
+#include "../../components/game_task/include/game_puzzle_db.h"
+#include "../../components/game_task/include/game_task.h"
+#include "../../components/ha_light_task/include/ha_light_task.h"
+#include "../../components/led_task/include/led_task.h"
+#include "../../components/matrix_task/include/matrix_task.h"
+#include "../../components/timer_system/include/timer_system.h"
+#include "json_writer.h"
+#include "led_mapping.h"
+#include "ota_update.h"
+#include "snapshot_bin.h"
+
+#include "esp_http_server.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+static const char *TAG = "WEB_HOST";
+
+// ============================================================================
+// HERNI MODEL
+// ============================================================================
+
+/** Opera Game (Morphy 1858) — 33 pultahu, konci matem; pak nova hra. */
+static const char *const s_script[] = {
+    "e2e4", "e7e5", "g1f3", "d7d6", "d2d4", "c8g4", "d4e5", "g4f3", "d1f3",
+    "d6e5", "f1c4", "g8f6", "f3b3", "d8e7", "b1c3", "c7c6", "c1g5", "b7b5",
+    "c3b5", "c6b5", "c4b5", "b8d7", "e1c1", "a8d8", "d1d7", "d8d7", "h1d1",
+    "e7e6", "b5d7", "f6d7", "b3b8", "d7b8", "d1d8",
+};
+#define SCRIPT_LEN (sizeof(s_script) / sizeof(s_script[0]))
+
+typedef struct {
+  uint8_t from;
+  uint8_t to;
+  uint8_t piece;
+  uint8_t captured;
+  uint32_t timestamp;
+} sim_move_t;
+
+static pthread_mutex_t s_game_lock = PTHREAD_MUTEX_INITIALIZER;
+static uint8_t s_board[64]; ///< piece_t, row*8+col (row 0 = rada 1)
+static sim_move_t s_history[SNAPSHOT_BIN_MAX_MOVES];
+static uint32_t s_history_n;
+static uint8_t s_captured[2][SNAPSHOT_BIN_MAX_CAPTURED]; ///< [0] = bily sebral
+static uint8_t s_captured_n[2];
+static int8_t s_advantage[SNAPSHOT_BIN_MAX_MOVES];
+static size_t s_script_pos;
+static uint32_t s_revision = 1;
+static int64_t s_game_start_us;
+
+static const char s_piece_chars[] = " PNBRQKpnbrqk";
+static const int8_t s_piece_value[] = {0, 1, 3, 3, 5, 9, 0,
+                                       -1, -3, -3, -5, -9, 0};
+
+static char sim_piece_char(uint8_t p) {
+  return p < sizeof(s_piece_chars) - 1 ? s_piece_chars[p] : '?';
+}
+
+static void sim_square_name(uint8_t sq, char out[3]) {
+  out[0] = (char)('a' + (sq & 7));
+  out[1] = (char)('1' + (sq >> 3));
+  out[2] = '\0';
+}
+
+static void sim_new_game_locked(void) {
+  static const uint8_t back[8] = {4, 2, 3, 5, 6, 3, 2, 4};
+  memset(s_board, 0, sizeof(s_board));
+  for (int c = 0; c < 8; c++) {
+    s_board[c] = back[c];
+    s_board[8 + c] = 1;
+    s_board[48 + c] = 7;
+    s_board[56 + c] = (uint8_t)(back[c] + 6);
+  }
+  s_history_n = 0;
+  memset(s_captured_n, 0, sizeof(s_captured_n));
+  s_script_pos = 0;
+  s_game_start_us = esp_timer_get_time();
+}
+
+static void sim_apply_locked(const char *uci) {
+  uint8_t from = (uint8_t)((uci[1] - '1') * 8 + (uci[0] - 'a'));
+  uint8_t to = (uint8_t)((uci[3] - '1') * 8 + (uci[2] - 'a'));
+  uint8_t piece = s_board[from];
+  uint8_t captured = s_board[to];
+  s_board[to] = piece;
+  s_board[from] = 0;
+  /* Rosada: kral o dve pole → vez na druhou stranu krale. */
+  if ((piece == 6 || piece == 12) && abs((to & 7) - (from & 7)) == 2) {
+    uint8_t rank = from & ~7;
+    bool queen_side = (to & 7) < (from & 7);
+    uint8_t rook_from = rank + (queen_side ? 0 : 7);
+    uint8_t rook_to = rank + (queen_side ? 3 : 5);
+    s_board[rook_to] = s_board[rook_from];
+    s_board[rook_from] = 0;
+  }
+  int side = piece <= 6 ? 0 : 1;
+  if (captured != 0 && s_captured_n[side] < SNAPSHOT_BIN_MAX_CAPTURED) {
+    s_captured[side][s_captured_n[side]++] = captured;
+  }
+  if (s_history_n < SNAPSHOT_BIN_MAX_MOVES) {
+    int adv = 0;
+    for (int i = 0; i < 64; i++) {
+      adv += s_piece_value[s_board[i]];
+    }
+    s_advantage[s_history_n] = (int8_t)adv;
+    s_history[s_history_n++] = (sim_move_t){
+        .from = from,
+        .to = to,
+        .piece = piece,
+        .captured = captured,
+        .timestamp = (uint32_t)(esp_timer_get_time() / 1000),
+    };
+  }
+}
+
+static bool sim_finished_locked(void) { return s_script_pos >= SCRIPT_LEN; }
+
+static void sim_bump_revision_and_notify(void) {
+  __atomic_add_fetch(&s_revision, 1, __ATOMIC_SEQ_CST);
+  /* Jako czechmate_on_game_state_changed: ping do fronty, web task posle. */
+  uint8_t ping = 1;
+  if (snapshot_notify_queue != NULL) {
+    (void)xQueueSend(snapshot_notify_queue, &ping, 0);
+  }
+}
+
+static volatile bool s_running = true;
+static uint32_t s_move_ms = 2000;
+
+static void *sim_game_thread(void *arg) {
+  (void)arg;
+  bool white = true;
+  timer_start_move(white);
+  while (s_running) {
+    usleep(s_move_ms * 1000);
+    pthread_mutex_lock(&s_game_lock);
+    if (sim_finished_locked()) {
+      sim_new_game_locked();
+      white = true;
+    } else {
+      sim_apply_locked(s_script[s_script_pos++]);
+      white = !white;
+    }
+    pthread_mutex_unlock(&s_game_lock);
+    timer_end_move();
+    timer_start_move(white);
+    sim_bump_revision_and_notify();
+  }
+  return NULL;
+}
+
+// ============================================================================
+// GAME API (podmnozina game_task.h, kterou pouziva HTTP vrstva)
+// ============================================================================
+
+uint32_t game_get_state_revision(void) {
+  return __atomic_load_n(&s_revision, __ATOMIC_SEQ_CST);
+}
+
+esp_err_t game_write_board_fields(json_writer_t *w) {
+  pthread_mutex_lock(&s_game_lock);
+  json_writer_key(w, "board");
+  json_writer_begin_array(w);
+  for (int row = 0; row < 8; row++) {
+    json_writer_begin_array(w);
+    for (int col = 0; col < 8; col++) {
+      json_writer_char(w, sim_piece_char(s_board[row * 8 + col]));
+    }
+    json_writer_end_array(w);
+  }
+  json_writer_end_array(w);
+  pthread_mutex_unlock(&s_game_lock);
+  json_writer_kv_uint(w, "timestamp", (uint64_t)(esp_timer_get_time() / 1000));
+  return json_writer_error(w);
+}
+
+esp_err_t game_write_status_fields(json_writer_t *w) {
+  pthread_mutex_lock(&s_game_lock);
+  bool finished = sim_finished_locked();
+  uint32_t moves = s_history_n;
+  pthread_mutex_unlock(&s_game_lock);
+
+  /* Stejne klice a poradi jako game_json_export.c (velikost payloadu). */
+  json_writer_kv_string(w, "game_state", finished ? "finished" : "active");
+  json_writer_kv_string(w, "current_player", (moves & 1) ? "Black" : "White");
+  json_writer_kv_uint(w, "move_count", moves);
+  json_writer_kv_uint(w, "white_time", 0);
+  json_writer_kv_uint(w, "black_time", 0);
+  json_writer_kv_bool(w, "in_check", finished);
+  json_writer_kv_bool(w, "checkmate", finished);
+  json_writer_kv_bool(w, "stalemate", false);
+  json_writer_key(w, "piece_lifted");
+  json_writer_begin_object(w);
+  json_writer_kv_bool(w, "lifted", false);
+  json_writer_kv_uint(w, "row", 0);
+  json_writer_kv_uint(w, "col", 0);
+  json_writer_kv_char(w, "piece", ' ');
+  json_writer_kv_string(w, "notation", "");
+  json_writer_end_object(w);
+  json_writer_kv_bool(w, "castling_in_progress", false);
+  json_writer_key(w, "game_end");
+  json_writer_begin_object(w);
+  json_writer_kv_bool(w, "ended", finished);
+  json_writer_kv_string(w, "reason", finished ? "Checkmate" : "");
+  json_writer_kv_string(w, "winner", finished ? "White" : "");
+  json_writer_kv_string(w, "loser", finished ? "Black" : "");
+  json_writer_end_object(w);
+  json_writer_key(w, "error_state");
+  json_writer_begin_object(w);
+  json_writer_kv_bool(w, "active", false);
+  json_writer_end_object(w);
+  json_writer_kv_string(w, "gameplay_profile", "standard");
+  json_writer_key(w, "restore_state");
+  json_writer_begin_object(w);
+  json_writer_kv_bool(w, "snapshot_loaded", false);
+  json_writer_kv_bool(w, "snapshot_fallback_used", false);
+  json_writer_kv_bool(w, "snapshot_restore_failed", false);
+  json_writer_kv_bool(w, "snapshot_save_failed", false);
+  json_writer_kv_bool(w, "resync_required", false);
+  json_writer_kv_bool(w, "boot_new_game_triggered", false);
+  json_writer_end_object(w);
+  json_writer_kv_bool(w, "board_setup_tutorial", false);
+  return json_writer_error(w);
+}
+
+esp_err_t game_write_history_json(json_writer_t *w) {
+  pthread_mutex_lock(&s_game_lock);
+  uint32_t n = s_history_n;
+  sim_move_t *copy = n ? malloc(n * sizeof(*copy)) : NULL;
+  if (n > 0 && copy == NULL) {
+    pthread_mutex_unlock(&s_game_lock);
+    return ESP_ERR_NO_MEM;
+  }
+  if (n > 0) {
+    memcpy(copy, s_history, n * sizeof(*copy));
+  }
+  pthread_mutex_unlock(&s_game_lock);
+
+  json_writer_begin_object(w);
+  json_writer_key(w, "moves");
+  json_writer_begin_array(w);
+  for (uint32_t i = 0; i < n; i++) {
+    char from[3];
+    char to[3];
+    sim_square_name(copy[i].from, from);
+    sim_square_name(copy[i].to, to);
+    json_writer_begin_object(w);
+    json_writer_kv_string(w, "from", from);
+    json_writer_kv_string(w, "to", to);
+    json_writer_kv_char(w, "piece", sim_piece_char(copy[i].piece));
+    json_writer_kv_uint(w, "timestamp", copy[i].timestamp);
+    json_writer_end_object(w);
+  }
+  json_writer_end_array(w);
+  json_writer_end_object(w);
+  free(copy);
+  return json_writer_error(w);
+}
+
+/** Archiv her na hostu neni (LittleFS) — prazdna stranka stejneho tvaru. */
+esp_err_t game_archive_write_list_fields(json_writer_t *w, uint32_t offset,
+                                         uint32_t limit) {
+  (void)limit;
+  json_writer_kv_bool(w, "available", false);
+  json_writer_kv_uint(w, "total", 0);
+  json_writer_kv_uint(w, "offset", offset);
+  json_writer_key(w, "games");
+  json_writer_begin_array(w);
+  json_writer_end_array(w);
+  json_writer_kv_uint(w, "count", 0);
+  json_writer_key(w, "next");
+  json_writer_null(w);
+  return json_writer_error(w);
+}
+
+/** Databaze uloh na hostu neni (oddil assets) — stejny tvar, prazdna. */
+esp_err_t game_puzzle_db_write_info_fields(json_writer_t *w) {
+  json_writer_kv_bool(w, "available", false);
+  json_writer_kv_uint(w, "count", 0);
+  json_writer_key(w, "bands");
+  json_writer_begin_array(w);
+  json_writer_end_array(w);
+  json_writer_key(w, "themes");
+  json_writer_begin_array(w);
+  json_writer_end_array(w);
+  return json_writer_error(w);
+}
+
+uint32_t game_puzzle_db_count(void) { return 0; }
+
+uint32_t game_puzzle_db_theme_mask(const char *name) {
+  (void)name;
+  return 0;
+}
+
+uint32_t game_get_history_length(void) {
+  pthread_mutex_lock(&s_game_lock);
+  uint32_t n = s_history_n;
+  pthread_mutex_unlock(&s_game_lock);
+  return n;
+}
+
+/** Jako firmware: davky po 16 pultazich pod zamkem, zapis mimo nej. */
+esp_err_t game_write_history_stream(json_writer_t *w,
+                                    game_history_format_t fmt, uint32_t start,
+                                    uint32_t end, uint32_t *next_out) {
+  sim_move_t batch[16];
+  uint32_t next = start;
+  bool first = true;
+  for (;;) {
+    pthread_mutex_lock(&s_game_lock);
+    uint32_t stop = end < s_history_n ? end : s_history_n;
+    uint32_t n = next < stop ? stop - next : 0;
+    if (n > 16) {
+      n = 16;
+    }
+    memcpy(batch, &s_history[next < stop ? next : 0], n * sizeof(*batch));
+    bool done = sim_finished_locked() && next + n >= s_history_n;
+    pthread_mutex_unlock(&s_game_lock);
+
+    if (first && fmt == GAME_HISTORY_FORMAT_PGN && start == 0) {
+      static const char tags[] = "[Event \"web_host\"]\n[Result \"*\"]\n\n";
+      json_writer_text(w, tags, sizeof(tags) - 1);
+    }
+    for (uint32_t i = 0; i < n; i++) {
+      char from[3];
+      char to[3];
+      sim_square_name(batch[i].from, from);
+      sim_square_name(batch[i].to, to);
+      uint32_t ply = next + i;
+      if (fmt == GAME_HISTORY_FORMAT_PGN) {
+        char text[24];
+        int len = (ply % 2) == 0
+                      ? snprintf(text, sizeof(text), "%s%u. %s%s",
+                                 first && i == 0 ? "" : " ", ply / 2 + 1, from,
+                                 to)
+                      : snprintf(text, sizeof(text), " %s%s", from, to);
+        json_writer_text(w, text, (size_t)len);
+        continue;
+      }
+      json_writer_begin_object(w);
+      json_writer_kv_uint(w, "ply", ply);
+      json_writer_kv_string(w, "from", from);
+      json_writer_kv_string(w, "to", to);
+      json_writer_kv_char(w, "piece", sim_piece_char(batch[i].piece));
+      if (batch[i].captured != 0) {
+        json_writer_kv_char(w, "captured", sim_piece_char(batch[i].captured));
+      }
+      json_writer_kv_uint(w, "timestamp", batch[i].timestamp);
+      json_writer_end_object(w);
+      json_writer_text(w, "\n", 1);
+    }
+    first = first && n == 0;
+    next += n;
+    if (n == 0 || next >= stop || json_writer_error(w) != ESP_OK) {
+      if (fmt == GAME_HISTORY_FORMAT_PGN && done) {
+        json_writer_text(w, " 1-0\n", 5);
+      }
+      break;
+    }
+  }
+  if (next_out != NULL) {
+    *next_out = next;
+  }
+  return json_writer_error(w);
+}
+
+esp_err_t game_write_captured_json(json_writer_t *w) {
+  static const char *const keys[2] = {"white_captured", "black_captured"};
+  pthread_mutex_lock(&s_game_lock);
+  json_writer_begin_object(w);
+  for (int side = 0; side < 2; side++) {
+    json_writer_key(w, keys[side]);
+    json_writer_begin_array(w);
+    for (int i = 0; i < s_captured_n[side]; i++) {
+      json_writer_char(w, sim_piece_char(s_captured[side][i]));
+    }
+    json_writer_end_array(w);
+  }
+  json_writer_end_object(w);
+  pthread_mutex_unlock(&s_game_lock);
+  return json_writer_error(w);
+}
+
+esp_err_t game_write_advantage_json(json_writer_t *w) {
+  pthread_mutex_lock(&s_game_lock);
+  uint32_t duration = (uint32_t)((esp_timer_get_time() - s_game_start_us) / 1000);
+  json_writer_begin_object(w);
+  json_writer_key(w, "history");
+  json_writer_begin_array(w);
+  for (uint32_t i = 0; i < s_history_n; i++) {
+    json_writer_int(w, s_advantage[i]);
+  }
+  json_writer_end_array(w);
+  json_writer_kv_uint(w, "count", s_history_n);
+  json_writer_kv_uint(w, "white_checks", 0);
+  json_writer_kv_uint(w, "black_checks", 0);
+  json_writer_kv_uint(w, "white_castles", 0);
+  json_writer_kv_uint(w, "black_castles", 0);
+  json_writer_kv_uint(w, "game_duration_ms", duration);
+  json_writer_kv_uint(w, "avg_time_per_move_ms",
+                      s_history_n ? duration / s_history_n : 0);
+  json_writer_end_object(w);
+  pthread_mutex_unlock(&s_game_lock);
+  return json_writer_error(w);
+}
+
+esp_err_t game_get_snapshot_bin(uint8_t *buffer, size_t size,
+                                uint16_t max_moves, size_t *out_len) {
+  if (buffer == NULL || size == 0 || out_len == NULL) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  *out_len = 0;
+  snapshot_bin_state_t *st = calloc(1, sizeof(*st));
+  if (st == NULL) {
+    return ESP_ERR_NO_MEM;
+  }
+  st->state_version = game_get_state_revision();
+  pthread_mutex_lock(&s_game_lock);
+  memcpy(st->board, s_board, sizeof(st->board));
+  uint32_t n = s_history_n;
+  if (max_moves != 0 && n > max_moves) {
+    n = max_moves;
+  }
+  st->move_total = s_history_n;
+  st->move_first = s_history_n - n;
+  st->move_n = (uint16_t)n;
+  for (uint32_t i = 0; i < n; i++) {
+    const sim_move_t *m = &s_history[st->move_first + i];
+    st->moves[i] = (snapshot_bin_move_t){.from = m->from,
+                                         .to = m->to,
+                                         .piece = m->piece,
+                                         .captured = m->captured,
+                                         .timestamp = m->timestamp};
+  }
+  st->status_bits = 1U | ((s_history_n & 1) ? SNAPSHOT_BIN_ST_BLACK_TO_MOVE : 0);
+  st->move_count = s_history_n;
+  st->white_captured_n = s_captured_n[0];
+  st->black_captured_n = s_captured_n[1];
+  memcpy(st->white_captured, s_captured[0], s_captured_n[0]);
+  memcpy(st->black_captured, s_captured[1], s_captured_n[1]);
+  pthread_mutex_unlock(&s_game_lock);
+
+  st->timestamp_ms = (uint64_t)(esp_timer_get_time() / 1000);
+  chess_timer_t t;
+  if (timer_get_state(&t) == ESP_OK) {
+    st->has_clock = true;
+    st->clock_flags =
+        (uint8_t)((t.timer_running ? SNAPSHOT_BIN_CLK_RUNNING : 0) |
+                  (t.is_white_turn ? SNAPSHOT_BIN_CLK_WHITE_TURN : 0));
+    st->clock_type = (uint8_t)t.config.type;
+    st->white_time_ms = t.white_time_ms;
+    st->black_time_ms = t.black_time_ms;
+    st->initial_time_ms = t.config.initial_time_ms;
+    st->increment_ms = t.config.increment_ms;
+  }
+  bool ok = snapshot_bin_encode(st, buffer, size, out_len);
+  free(st);
+  return ok ? ESP_OK : ESP_ERR_NO_MEM;
+}
+
+esp_err_t game_get_timer_json(char *buffer, size_t size) {
+  return timer_get_json(buffer, size);
+}
+
+bool game_finish_board_setup_tutorial_from_web(void) { return false; }
+void game_force_clear_matrix_guard(void) {}
+bool game_get_guided_capture_hints_enabled(void) { return true; }
+uint8_t game_get_led_guidance_level(void) { return 1; }
+uint8_t game_get_matrix_guard_conflict_count(void) { return 0; }
+uint32_t game_get_matrix_guard_dropped_mask_high(void) { return 0; }
+uint32_t game_get_matrix_guard_dropped_mask_low(void) { return 0; }
+uint32_t game_get_matrix_guard_lifted_mask_high(void) { return 0; }
+uint32_t game_get_matrix_guard_lifted_mask_low(void) { return 0; }
+bool game_is_board_setup_tutorial_active(void) { return false; }
+bool game_is_matrix_guard_active(void) { return false; }
+
+QueueHandle_t game_command_queue = NULL; ///< POST /api/game/* → 503
+
+// ============================================================================
+// OSTATNI MODULY (HA light, LED, matrix, config)
+// ============================================================================
+
+uint32_t ha_light_get_activity_timeout_sec(void) { return 300; }
+ha_mode_t ha_light_get_mode(void) { return HA_MODE_GAME; }
+void ha_light_get_state(uint8_t *r, uint8_t *g, uint8_t *b,
+                        uint8_t *brightness, bool *state) {
+  *r = *g = *b = 255;
+  *brightness = 128;
+  *state = false;
+}
+void led_execute_command_new(const led_command_t *cmd) { (void)cmd; }
+bool matrix_is_guard_mode_active(void) { return false; }
+uint8_t chess_notation_to_led_index(const char *notation) {
+  if (notation == NULL || notation[0] < 'a' || notation[0] > 'h' ||
+      notation[1] < '1' || notation[1] > '8') {
+    return 0xFF;
+  }
+  return (uint8_t)((notation[1] - '1') * 8 + (notation[0] - 'a'));
+}
+/* Konfigurace na hostu pevna (bez NVS); tvar /api/status jako na desce. */
+uint32_t config_registry_get(config_snapshot_t *out) {
+  memset(out, 0, sizeof(*out));
+  out->system.brightness_level = 50;
+  out->system.led_guidance_level = 5;
+  out->chess_hint_limit = 3;
+  out->version = 1;
+  return out->version;
+}
+/* Persist task na hostu nebezi — zapis hned (jako pred config_persist_start). */
+esp_err_t config_persist_submit(const char *key, config_persist_write_fn fn,
+                                const void *data, size_t len,
+                                config_persist_prio_t prio,
+                                config_persist_future_t *future) {
+  (void)prio;
+  esp_err_t ret = fn(key, data, len);
+  if (future != NULL) {
+    future->result = ret;
+  }
+  return ret;
+}
+
+// ============================================================================
+// WEB SERVER TASK (casti web_server_task.c mimo HTTP vrstvu)
+// ============================================================================
+
+QueueHandle_t snapshot_notify_queue;
+static httpd_handle_t s_httpd;
+
+bool web_is_locked(void) { return false; }
+bool wifi_is_sta_connected(void) { return true; }
+bool web_server_is_active(void) { return s_httpd != NULL; }
+httpd_handle_t web_server_get_httpd_handle(void) { return s_httpd; }
+esp_err_t web_server_task_wdt_reset_safe(void) { return ESP_OK; }
+esp_err_t web_server_opening_dispatch_json(struct cJSON *root) {
+  (void)root;
+  return ESP_ERR_NOT_SUPPORTED;
+}
+esp_err_t ota_update_register_http_handlers(httpd_handle_t hd) {
+  (void)hd;
+  return ESP_OK;
+}
+
+void czechmate_ensure_snapshot_notify_queue(void) {
+  if (snapshot_notify_queue == NULL) {
+    snapshot_notify_queue = xQueueCreate(2, sizeof(uint8_t));
+  }
+}
+
+/* Handlery z web_server_task.c / web_handlers_{system,wifi}.c — na hostu
+ * nemaji co ovladat (WiFi, NVS, demo, MQTT, HTML stranka). */
+#define WEB_HOST_NOT_IMPLEMENTED(name)                                        \
+  esp_err_t name(httpd_req_t *req) {                                          \
+    return httpd_resp_send_err(req, HTTPD_501_METHOD_NOT_IMPLEMENTED,         \
+                               "not available in web_host");                  \
+  }
+
+WEB_HOST_NOT_IMPLEMENTED(http_get_root_handler)
+WEB_HOST_NOT_IMPLEMENTED(http_get_chess_js_handler)
+WEB_HOST_NOT_IMPLEMENTED(http_get_favicon_handler)
+WEB_HOST_NOT_IMPLEMENTED(http_get_demo_status_handler)
+WEB_HOST_NOT_IMPLEMENTED(http_get_mqtt_status_handler)
+WEB_HOST_NOT_IMPLEMENTED(http_get_web_lock_status_handler)
+WEB_HOST_NOT_IMPLEMENTED(http_get_wifi_status_handler)
+WEB_HOST_NOT_IMPLEMENTED(http_get_settings_start_pos_check_handler)
+WEB_HOST_NOT_IMPLEMENTED(http_get_settings_ui_handler)
+WEB_HOST_NOT_IMPLEMENTED(http_post_demo_config_handler)
+WEB_HOST_NOT_IMPLEMENTED(http_post_demo_start_handler)
+WEB_HOST_NOT_IMPLEMENTED(http_post_factory_reset_handler)
+WEB_HOST_NOT_IMPLEMENTED(http_post_light_command_handler)
+WEB_HOST_NOT_IMPLEMENTED(http_post_light_game_mode_handler)
+WEB_HOST_NOT_IMPLEMENTED(http_post_mqtt_config_handler)
+WEB_HOST_NOT_IMPLEMENTED(http_post_settings_auto_lamp_timeout_handler)
+WEB_HOST_NOT_IMPLEMENTED(http_post_settings_brightness_handler)
+WEB_HOST_NOT_IMPLEMENTED(http_post_settings_guided_hints_handler)
+WEB_HOST_NOT_IMPLEMENTED(http_post_settings_led_guidance_handler)
+WEB_HOST_NOT_IMPLEMENTED(http_post_settings_start_pos_check_handler)
+WEB_HOST_NOT_IMPLEMENTED(http_post_settings_ui_handler)
+WEB_HOST_NOT_IMPLEMENTED(http_post_timer_config_handler)
+WEB_HOST_NOT_IMPLEMENTED(http_post_timer_pause_handler)
+WEB_HOST_NOT_IMPLEMENTED(http_post_timer_reset_handler)
+WEB_HOST_NOT_IMPLEMENTED(http_post_timer_resume_handler)
+WEB_HOST_NOT_IMPLEMENTED(http_post_wifi_clear_handler)
+WEB_HOST_NOT_IMPLEMENTED(http_post_wifi_config_handler)
+WEB_HOST_NOT_IMPLEMENTED(http_post_wifi_connect_handler)
+WEB_HOST_NOT_IMPLEMENTED(http_post_wifi_disconnect_handler)
+
+/** Smycka web_server_task (bez fronty prikazu a TWDT). */
+static void *web_task_thread(void *arg) {
+  (void)arg;
+  while (s_running) {
+    uint8_t ping;
+    int n = 0;
+    while (xQueueReceive(snapshot_notify_queue, &ping, 0) == pdTRUE) {
+      n++;
+    }
+    if (n > 0) {
+      ws_broadcast_snapshot();
+    }
+    ws_push_service();
+    vTaskDelay(pdMS_TO_TICKS(100));
+  }
+  return NULL;
+}
+
+// ============================================================================
+// MAIN
+// ============================================================================
+
+static void on_signal(int sig) {
+  (void)sig;
+  s_running = false;
+}
+
+static void usage(void) {
+  fprintf(stderr, "usage: web_host [--port N] [--move-ms MS] [--duration S] "
+                  "[--verbose]\n");
+}
+
+int main(int argc, char **argv) {
+  uint16_t port = 8080;
+  int duration_s = 0;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--port") == 0 && i + 1 < argc) {
+      port = (uint16_t)atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--move-ms") == 0 && i + 1 < argc) {
+      s_move_ms = (uint32_t)atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--duration") == 0 && i + 1 < argc) {
+      duration_s = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--verbose") == 0) {
+      host_log_level = 4;
+    } else {
+      usage();
+      return 2;
+    }
+  }
+  if (s_move_ms == 0) {
+    s_move_ms = 1;
+  }
+
+  signal(SIGINT, on_signal);
+  signal(SIGTERM, on_signal);
+
+  pthread_mutex_lock(&s_game_lock);
+  sim_new_game_locked();
+  pthread_mutex_unlock(&s_game_lock);
+  timer_system_init();
+  time_control_config_t tc;
+  if (timer_get_config_by_type(TIME_CONTROL_RAPID_10_0, &tc) == ESP_OK) {
+    timer_set_time_control(&tc);
+  }
+  czechmate_ensure_snapshot_notify_queue();
+
+  /* Stejna konfigurace jako start_http_server() ve web_server_task.c. */
+  httpd_config_t config = HTTPD_DEFAULT_CONFIG();
+  config.server_port = port;
+  config.max_uri_handlers = 64;
+  config.max_open_sockets = CONFIG_LWIP_MAX_SOCKETS - 3;
+  config.lru_purge_enable = false;
+  config.recv_wait_timeout = 20;
+  config.send_wait_timeout = 5000;
+  config.max_resp_headers = 8;
+  config.uri_match_fn = httpd_uri_match_wildcard;
+  config.backlog_conn = 6;
+  config.stack_size = 8192;
+
+  esp_err_t ret = httpd_start(&s_httpd, &config);
+  if (ret != ESP_OK) {
+    ESP_LOGE(TAG, "httpd_start failed: %s", esp_err_to_name(ret));
+    return 1;
+  }
+  ret = web_routes_register(s_httpd);
+  if (ret != ESP_OK) {
+    ESP_LOGE(TAG, "web_routes_register failed: %s", esp_err_to_name(ret));
+    httpd_stop(s_httpd);
+    return 1;
+  }
+  web_server_websocket_init();
+
+  pthread_t game_thread;
+  pthread_t web_thread;
+  pthread_create(&game_thread, NULL, sim_game_thread, NULL);
+  pthread_create(&web_thread, NULL, web_task_thread, NULL);
+  fprintf(stderr,
+          "web_host: http://127.0.0.1:%u/ (max_open_sockets=%u, move every "
+          "%u ms)\n",
+          port, config.max_open_sockets, s_move_ms);
+
+  int64_t deadline = duration_s > 0
+                         ? esp_timer_get_time() + (int64_t)duration_s * 1000000
+                         : 0;
+  while (s_running && (deadline == 0 || esp_timer_get_time() < deadline)) {
+    usleep(100 * 1000);
+  }
+  s_running = false;
+  pthread_join(game_thread, NULL);
+  pthread_join(web_thread, NULL);
+
+  host_httpd_print_stats(s_httpd, stdout);
+  web_ws_shutdown();
+  httpd_stop(s_httpd);
+  s_httpd = NULL;
+  return 0;
+}
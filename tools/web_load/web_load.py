@@ -0,0 +1,373 @@
+#!/usr/bin/env python3
+"""
+Zátěžový generátor pro HTTP/WS vrstvu web_server_task (web_host i deska).
+
+Přehrává mix virtuálních klientů, každý na vlastním keep-alive spojení:
+  snapshot  GET /api/game/snapshot s If-None-Match (polling webového UI)
+  timer     GET /api/timer
+  static    GET /static/piece/*.png s If-None-Match
+  history   GET /api/history.jsonl?from=<kurzor> (dočítá jen nové tahy)
+  ws        WebSocket /ws — přijímá pushe, potvrzuje state_version (delty)
+
+Výstup: req/s, p50/p90/p99/max latence, podíl 304, chyby a neúspěšná
+připojení na typ klienta; u WS rámce, KiB a nejdelší mezera mezi pushi.
+Jen stdlib (asyncio), bez závislostí.
+
+  python3 tools/web_load/web_load.py --url http://127.0.0.1:8080 \\
+      --mix snapshot=4,ws=2,timer=2 --duration 30
+"""
+
+from __future__ import annotations
+
+import argparse
+import asyncio
+import base64
+import json
+import os
+import re
+import sys
+import time
+from urllib.parse import urlparse
+
+STATIC_PIECES = [
+    f"/static/piece/Piece{color}{piece}.png"
+    for color in ("White", "Black")
+    for piece in ("King", "Queen", "Rook", "Bishop", "Knight", "Pawn")
+]
+
+KINDS = ("snapshot", "timer", "static", "history", "ws")
+
+
+class Stats:
+    def __init__(self) -> None:
+        self.latencies: list[float] = []
+        self.status: dict[int, int] = {}
+        self.errors = 0
+        self.connect_fail = 0
+        self.bytes = 0
+        # WS
+        self.frames = 0
+        self.max_gap = 0.0
+        self.handshake: list[float] = []
+
+    def percentile(self, p: float) -> float:
+        if not self.latencies:
+            return 0.0
+        s = sorted(self.latencies)
+        return s[min(len(s) - 1, int(p * len(s)))]
+
+
+class HttpConn:
+    """Jedno keep-alive HTTP/1.1 spojení (Content-Length i chunked)."""
+
+    def __init__(self, host: str, port: int, timeout: float) -> None:
+        self.host = host
+        self.port = port
+        self.timeout = timeout
+        self.reader: asyncio.StreamReader | None = None
+        self.writer: asyncio.StreamWriter | None = None
+
+    async def connect(self) -> None:
+        self.reader, self.writer = await asyncio.wait_for(
+            asyncio.open_connection(self.host, self.port), self.timeout
+        )
+
+    def close(self) -> None:
+        if self.writer is not None:
+            self.writer.close()
+        self.reader = self.writer = None
+
+    async def request(
+        self, path: str, headers: dict[str, str]
+    ) -> tuple[int, dict[str, str], bytes]:
+        lines = [f"GET {path} HTTP/1.1", f"Host: {self.host}"]
+        lines += [f"{k}: {v}" for k, v in headers.items()]
+        self.writer.write(("\r\n".join(lines) + "\r\n\r\n").encode())
+        await self.writer.drain()
+        head = await asyncio.wait_for(
+            self.reader.readuntil(b"\r\n\r\n"), self.timeout
+        )
+        status_line, *hdr_lines = head.decode("latin-1").split("\r\n")
+        status = int(status_line.split(" ", 2)[1])
+        hdrs = {}
+        for line in hdr_lines:
+            if ":" in line:
+                k, v = line.split(":", 1)
+                hdrs[k.strip().lower()] = v.strip()
+        if hdrs.get("transfer-encoding", "").lower() == "chunked":
+            body = bytearray()
+            while True:
+                size = int((await self.reader.readuntil(b"\r\n")).strip(), 16)
+                chunk = await self.reader.readexactly(size + 2)
+                if size == 0:
+                    break
+                body += chunk[:-2]
+            return status, hdrs, bytes(body)
+        n = int(hdrs.get("content-length", "0"))
+        body = await asyncio.wait_for(self.reader.readexactly(n), self.timeout)
+        return status, hdrs, body
+
+
+async def http_client(
+    kind: str, idx: int, args, stats: Stats, stop: asyncio.Event
+) -> None:
+    conn = HttpConn(args.host, args.port, args.timeout)
+    etag: dict[str, str] = {}
+    n = 0
+    cursor = 0
+    while not stop.is_set():
+        if conn.writer is None:
+            try:
+                await conn.connect()
+            except (OSError, asyncio.TimeoutError):
+                stats.connect_fail += 1
+                await asyncio.sleep(0.5)
+                continue
+        if kind == "snapshot":
+            path = "/api/game/snapshot"
+        elif kind == "timer":
+            path = "/api/timer"
+        elif kind == "history":
+            path = f"/api/history.jsonl?from={cursor}"
+        else:
+            path = STATIC_PIECES[(idx + n) % len(STATIC_PIECES)]
+        n += 1
+        headers = {"Accept-Encoding": "gzip"}
+        if path in etag and kind != "timer":
+            headers["If-None-Match"] = etag[path]
+        t0 = time.perf_counter()
+        try:
+            status, hdrs, body = await conn.request(path, headers)
+        except (OSError, asyncio.TimeoutError, asyncio.IncompleteReadError,
+                ValueError):
+            stats.errors += 1
+            conn.close()
+            continue
+        stats.latencies.append(time.perf_counter() - t0)
+        stats.status[status] = stats.status.get(status, 0) + 1
+        stats.bytes += len(body)
+        if "etag" in hdrs:
+            etag[path] = hdrs["etag"]
+        if kind == "history" and status == 200:
+            total = int(hdrs.get("x-history-total", "0"))
+            # Nová partie / undo: historie je kratší než kurzor → od začátku.
+            cursor = 0 if total < cursor else int(
+                hdrs.get("x-next-cursor", str(cursor)))
+        if hdrs.get("connection", "").lower() == "close" or status >= 400:
+            conn.close()  # ESP-IDF po chybě zavírá session
+        await asyncio.sleep(args.interval / 1000.0)
+    conn.close()
+
+
+def ws_frame(opcode: int, payload: bytes) -> bytes:
+    mask = os.urandom(4)
+    head = bytes([0x80 | opcode])
+    n = len(payload)
+    if n < 126:
+        head += bytes([0x80 | n])
+    elif n < 65536:
+        head += bytes([0x80 | 126]) + n.to_bytes(2, "big")
+    else:
+        head += bytes([0x80 | 127]) + n.to_bytes(8, "big")
+    return head + mask + bytes(b ^ mask[i & 3] for i, b in enumerate(payload))
+
+
+async def ws_read_frame(reader: asyncio.StreamReader) -> tuple[int, bytes]:
+    b0, b1 = await reader.readexactly(2)
+    n = b1 & 0x7F
+    if n == 126:
+        n = int.from_bytes(await reader.readexactly(2), "big")
+    elif n == 127:
+        n = int.from_bytes(await reader.readexactly(8), "big")
+    return b0 & 0x0F, await reader.readexactly(n)
+
+
+STATE_VERSION_RE = re.compile(rb'"state_version":(\d+)')
+
+
+async def ws_client(idx: int, args, stats: Stats, stop: asyncio.Event) -> None:
+    while not stop.is_set():
+        t0 = time.perf_counter()
+        try:
+            reader, writer = await asyncio.wait_for(
+                asyncio.open_connection(args.host, args.port), args.timeout
+            )
+            key = base64.b64encode(os.urandom(16)).decode()
+            writer.write(
+                (
+                    f"GET /ws HTTP/1.1\r\nHost: {args.host}\r\n"
+                    "Upgrade: websocket\r\nConnection: Upgrade\r\n"
+                    f"Sec-WebSocket-Key: {key}\r\n"
+                    "Sec-WebSocket-Version: 13\r\n\r\n"
+                ).encode()
+            )
+            await writer.drain()
+            head = await asyncio.wait_for(
+                reader.readuntil(b"\r\n\r\n"), args.timeout
+            )
+            if b" 101 " not in head.split(b"\r\n", 1)[0]:
+                raise ConnectionError("no upgrade")
+        except (OSError, asyncio.TimeoutError, asyncio.IncompleteReadError,
+                ConnectionError):
+            stats.connect_fail += 1
+            await asyncio.sleep(0.5)
+            continue
+        stats.handshake.append(time.perf_counter() - t0)
+        last = time.perf_counter()
+        try:
+            while not stop.is_set():
+                try:
+                    op, payload = await asyncio.wait_for(ws_read_frame(reader), 0.5)
+                except asyncio.TimeoutError:
+                    continue
+                now = time.perf_counter()
+                if op == 0x8:
+                    break
+                if op not in (0x1, 0x2):
+                    continue
+                stats.frames += 1
+                stats.bytes += len(payload)
+                stats.max_gap = max(stats.max_gap, now - last)
+                last = now
+                m = STATE_VERSION_RE.search(payload)
+                if m and args.ws_ack:
+                    ack = json.dumps(
+                        {"type": "ack", "state_version": int(m.group(1))}
+                    ).encode()
+                    writer.write(ws_frame(0x1, ack))
+                    await writer.drain()
+            if stop.is_set():
+                writer.write(ws_frame(0x8, b"\x03\xe8"))
+                await writer.drain()
+        except (OSError, asyncio.IncompleteReadError):
+            stats.errors += 1
+        writer.close()
+
+
+def parse_mix(s: str) -> dict[str, int]:
+    mix = {}
+    for part in s.split(","):
+        kind, _, n = part.partition("=")
+        if kind not in KINDS or not n.isdigit():
+            raise argparse.ArgumentTypeError(f"bad mix entry {part!r}")
+        mix[kind] = int(n)
+    return mix
+
+
+def report(mix: dict[str, int], stats: dict[str, Stats], elapsed: float) -> dict:
+    out = {}
+    print(
+        f"{'kind':<9} {'clients':>7} {'req':>7} {'req/s':>7} {'p50':>7} "
+        f"{'p90':>7} {'p99':>7} {'max':>7} {'304%':>5} {'err':>5} {'connfail':>8}"
+    )
+    for kind, n in mix.items():
+        st = stats[kind]
+        if kind == "ws":
+            continue
+        req = len(st.latencies)
+        not_mod = st.status.get(304, 0)
+        row = {
+            "clients": n,
+            "requests": req,
+            "rps": req / elapsed,
+            "p50_ms": st.percentile(0.50) * 1e3,
+            "p90_ms": st.percentile(0.90) * 1e3,
+            "p99_ms": st.percentile(0.99) * 1e3,
+            "max_ms": max(st.latencies, default=0.0) * 1e3,
+            "not_modified_ratio": not_mod / req if req else 0.0,
+            "status": st.status,
+            "errors": st.errors,
+            "connect_fail": st.connect_fail,
+        }
+        out[kind] = row
+        print(
+            f"{kind:<9} {n:>7} {req:>7} {row['rps']:>7.1f} {row['p50_ms']:>7.1f} "
+            f"{row['p90_ms']:>7.1f} {row['p99_ms']:>7.1f} {row['max_ms']:>7.1f} "
+            f"{100 * row['not_modified_ratio']:>5.0f} {st.errors:>5} "
+            f"{st.connect_fail:>8}"
+        )
+    if "ws" in mix:
+        st = stats["ws"]
+        hs = sorted(st.handshake)
+        row = {
+            "clients": mix["ws"],
+            "connected": len(hs),
+            "frames": st.frames,
+            "frames_per_s": st.frames / elapsed,
+            "kib": st.bytes / 1024,
+            "max_gap_s": st.max_gap,
+            "handshake_p50_ms": hs[len(hs) // 2] * 1e3 if hs else 0.0,
+            "errors": st.errors,
+            "connect_fail": st.connect_fail,
+        }
+        out["ws"] = row
+        print(
+            f"ws: {row['connected']}/{mix['ws']} connected, "
+            f"{st.frames} frames ({row['frames_per_s']:.1f}/s, "
+            f"{row['kib']:.1f} KiB), max gap {st.max_gap:.2f} s, "
+            f"handshake p50 {row['handshake_p50_ms']:.1f} ms, "
+            f"err {st.errors}, connfail {st.connect_fail}"
+        )
+    return out
+
+
+async def run(args) -> int:
+    stop = asyncio.Event()
+    stats = {kind: Stats() for kind in KINDS}
+    tasks = []
+    for kind, n in args.mix.items():
+        for i in range(n):
+            if kind == "ws":
+                tasks.append(asyncio.create_task(ws_client(i, args, stats[kind], stop)))
+            else:
+                tasks.append(
+                    asyncio.create_task(http_client(kind, i, args, stats[kind], stop))
+                )
+    t0 = time.perf_counter()
+    await asyncio.sleep(args.duration)
+    stop.set()
+    await asyncio.wait(tasks, timeout=args.timeout + 1)
+    for t in tasks:
+        t.cancel()
+    elapsed = time.perf_counter() - t0
+    out = report(args.mix, stats, elapsed)
+    if args.json:
+        with open(args.json, "w", encoding="utf-8") as f:
+            json.dump(out, f, indent=2)
+    total_err = sum(s.errors + s.connect_fail for s in stats.values())
+    return 1 if total_err and args.fail_on_error else 0
+
+
+def main() -> int:
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[1])
+    ap.add_argument("--url", default="http://127.0.0.1:8080")
+    ap.add_argument(
+        "--mix",
+        type=parse_mix,
+        default=parse_mix("snapshot=4,ws=2,timer=2"),
+        help="klienti podle typu, např. snapshot=4,ws=2,timer=2,static=1",
+    )
+    ap.add_argument("--duration", type=float, default=20.0, help="sekundy")
+    ap.add_argument(
+        "--interval", type=float, default=1000.0, help="ms mezi dotazy pollerů"
+    )
+    ap.add_argument("--timeout", type=float, default=5.0, help="s na operaci")
+    ap.add_argument(
+        "--no-ws-ack",
+        dest="ws_ack",
+        action="store_false",
+        help="WS klienti nepotvrzují state_version (jen plné snapshoty)",
+    )
+    ap.add_argument("--json", help="výsledky i do JSON souboru")
+    ap.add_argument(
+        "--fail-on-error", action="store_true", help="exit 1 při chybách"
+    )
+    args = ap.parse_args()
+    u = urlparse(args.url)
+    args.host = u.hostname or "127.0.0.1"
+    args.port = u.port or 80
+    return asyncio.run(run(args))
+
+
+if __name__ == "__main__":
+    sys.exit(main())